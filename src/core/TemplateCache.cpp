@@ -0,0 +1,247 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include "core/StringUtils.h"
+#include "core/TemplateCache.h"
+
+wxString TemplateCmdParams::all() const
+{
+    return from(0);
+}
+
+wxString TemplateCmdParams::from(size_t start) const
+{
+    wxString result;
+    if (start < Count())
+    {
+        result = Item(start);
+        for (size_t i = start + 1; i < Count(); i++)
+            result += ':' + Item(i);
+    }
+    return result;
+}
+
+CompiledTemplate::CompiledTemplate(const wxString& text)
+    : textM(text)
+{
+    const wxString& inputText = textM;
+    wxString::size_type pos = 0, oldpos = 0, endpos = 0;
+    while (true)
+    {
+        pos = inputText.find("{%", pos);
+        if (pos == wxString::npos)
+        {
+            if (oldpos < inputText.length())
+            {
+                Segment segment;
+                segment.textStart = oldpos;
+                segment.textLength = inputText.length() - oldpos;
+                segmentsM.push_back(segment);
+            }
+            break;
+        }
+
+        wxString::size_type check, startpos = pos;
+        int cnt = 1;
+        while (cnt > 0)
+        {
+            endpos = inputText.find("%}", startpos+1);
+            if (endpos == wxString::npos)
+                break;
+
+            check = inputText.find("{%", startpos+1);
+            if (check == wxString::npos)
+                startpos = endpos;
+            else
+            {
+                startpos = (check < endpos ? check : endpos);
+                if (startpos == check)
+                    cnt++;
+            }
+            if (startpos == endpos)
+                cnt--;
+            startpos++;
+        }
+
+        // no matching closing %}, the rest of the text is dropped
+        if (cnt > 0)
+            break;
+
+        Segment segment;
+        segment.textStart = oldpos;
+        segment.textLength = pos - oldpos;
+        // 2 = start_marker_len = end_marker_len
+        parseCommand(inputText.substr(pos + 2, endpos - pos - 2), segment);
+        segmentsM.push_back(segment);
+        oldpos = pos = endpos + 2;
+    }
+}
+
+// parses command name and params
+void CompiledTemplate::parseCommand(const wxString& cmd, Segment& segment)
+{
+    enum TemplateCmdState
+    {
+        inText,
+        inString1,
+        inString2
+    };
+    TemplateCmdState state = inText;
+    TemplateCmdParams& cmdParams = segment.cmdParams;
+    wxString::size_type start = 0;
+    unsigned int nestLevel = 0;
+    for (wxString::size_type i = 0; i < cmd.Length(); i++)
+    {
+        wxChar c = cmd[i];
+
+        if (c == ':' && nestLevel == 0 && state == inText)
+        {
+            cmdParams.Add(cmd.substr(start, i - start));
+            start = i + 1;
+            continue;
+        }
+
+        if ((c == '{') && (i < cmd.Length() - 1) && (cmd[i + 1] == '%'))
+            nestLevel++;
+        else if ((c == '}') && (i > 0) && (cmd[i - 1] == '%'))
+            nestLevel--;
+        else if (c == '\'')
+            state == inString1 ? state = inText : state = inString1;
+        else if (c == '"')
+            state == inString2 ? state = inText : state = inString2;
+    }
+    if (start < cmd.Length())
+        cmdParams.Add(cmd.substr(start));
+
+    if (cmdParams.Count() > 0)
+    {
+        segment.cmdName = cmdParams[0];
+        cmdParams.RemoveAt(0);
+    }
+}
+
+void CompiledTemplate::appendText(wxString& processedText,
+    const Segment& segment) const
+{
+    if (segment.textLength)
+        processedText.append(textM, segment.textStart, segment.textLength);
+}
+
+size_t TemplateCache::TextHash::operator()(const wxString& text) const
+{
+    // FNV-1a
+    size_t hash = size_t(14695981039346656037ULL);
+    for (wxString::const_iterator it = text.begin(); it != text.end(); ++it)
+    {
+        hash ^= size_t(wxUniChar(*it).GetValue());
+        hash *= size_t(1099511628211ULL);
+    }
+    return hash;
+}
+
+TemplateCache::TemplateCache(size_t generationSize)
+    : generationSizeM(generationSize)
+{
+}
+
+TemplateCache& TemplateCache::get()
+{
+    static TemplateCache cache;
+    return cache;
+}
+
+CompiledTemplatePtr TemplateCache::add(const wxString& text)
+{
+    if (currentM.size() >= generationSizeM)
+    {
+        oldM.swap(currentM);
+        currentM.clear();
+    }
+    CompiledTemplatePtr& compiled = currentM[text];
+    Texts::iterator it = oldM.find(text);
+    if (it != oldM.end())
+    {
+        compiled = it->second;
+        oldM.erase(it);
+    }
+    else
+        compiled.reset(new CompiledTemplate(text));
+    return compiled;
+}
+
+CompiledTemplatePtr TemplateCache::compile(const wxString& text)
+{
+    std::lock_guard<std::mutex> lock(mutexM);
+    Texts::iterator it = currentM.find(text);
+    if (it != currentM.end())
+        return it->second;
+    return add(text);
+}
+
+CompiledTemplatePtr TemplateCache::compileFile(const wxFileName& fileName)
+{
+    wxString path(fileName.GetFullPath());
+    wxDateTime modified;
+    if (fileName.FileExists())
+        modified = fileName.GetModificationTime();
+    {
+        std::lock_guard<std::mutex> lock(mutexM);
+        std::map<wxString, File>::iterator it = filesM.find(path);
+        if (it != filesM.end() && modified.IsValid()
+            && it->second.modified == modified)
+        {
+            return it->second.compiled;
+        }
+    }
+
+    // loadEntireFile() throws if the file doesn't exist
+    CompiledTemplatePtr compiled(new CompiledTemplate(loadEntireFile(fileName)));
+    std::lock_guard<std::mutex> lock(mutexM);
+    File& file = filesM[path];
+    file.modified = modified;
+    file.compiled = compiled;
+    return compiled;
+}
+
+void TemplateCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutexM);
+    currentM.clear();
+    oldM.clear();
+    filesM.clear();
+}
+
+size_t TemplateCache::getTextCount()
+{
+    std::lock_guard<std::mutex> lock(mutexM);
+    return currentM.size() + oldM.size();
+}
@@ -0,0 +1,125 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_TEMPLATECACHE_H
+#define FR_TEMPLATECACHE_H
+
+#include <wx/arrstr.h>
+#include <wx/datetime.h>
+#include <wx/filename.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class TemplateCmdParams: public wxArrayString
+{
+public:
+    // returns all params concatenated with the default separator.
+    wxString all() const;
+    // returns all params from start, concatenated with the default separator.
+    wxString from(size_t start) const;
+};
+
+// CompiledTemplate class
+// A template text split into its literal text and its commands
+// {%cmdName:cmdParams%}, with the name and the parameters of every command
+// separated, so expanding the text again only has to run the commands.
+// The parameters are kept as text, as command handlers decide themselves
+// whether (and for which object) they are expanded.
+class CompiledTemplate
+{
+public:
+    // literal text of the template, followed by a command unless cmdName
+    // is empty
+    struct Segment
+    {
+        size_t textStart;
+        size_t textLength;
+        wxString cmdName;
+        TemplateCmdParams cmdParams;
+    };
+private:
+    wxString textM;
+    std::vector<Segment> segmentsM;
+
+    void parseCommand(const wxString& cmd, Segment& segment);
+public:
+    explicit CompiledTemplate(const wxString& text);
+
+    const wxString& getText() const { return textM; }
+    const std::vector<Segment>& getSegments() const { return segmentsM; }
+    // appends the literal text of segment to processedText
+    void appendText(wxString& processedText, const Segment& segment) const;
+};
+
+typedef std::shared_ptr<const CompiledTemplate> CompiledTemplatePtr;
+
+// TemplateCache class
+// The compiled templates of the texts that were expanded last, shared by
+// all template processors. Texts are found by their contents, so the
+// parameters of commands that are expanded over and over (the text of a
+// {%foreach%} loop for every column, say) are compiled only once. Template
+// files are found by path and modification time, a changed file is read
+// again.
+// The texts are kept in two generations: once the current one is full it
+// replaces the old one, and old texts that are used again are moved back
+// into the current one.
+class TemplateCache
+{
+private:
+    struct TextHash
+    {
+        size_t operator()(const wxString& text) const;
+    };
+    typedef std::unordered_map<wxString, CompiledTemplatePtr, TextHash> Texts;
+
+    struct File
+    {
+        wxDateTime modified;
+        CompiledTemplatePtr compiled;
+    };
+
+    std::mutex mutexM;
+    size_t generationSizeM;
+    Texts currentM;
+    Texts oldM;
+    std::map<wxString, File> filesM;
+
+    CompiledTemplatePtr add(const wxString& text);
+public:
+    explicit TemplateCache(size_t generationSize = 1024);
+
+    // the cache of all template processors
+    static TemplateCache& get();
+
+    CompiledTemplatePtr compile(const wxString& text);
+    // reads the file unless it is cached and wasn't changed since
+    CompiledTemplatePtr compileFile(const wxFileName& fileName);
+    void clear();
+    size_t getTextCount();
+};
+
+#endif // FR_TEMPLATECACHE_H
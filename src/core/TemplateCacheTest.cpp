@@ -0,0 +1,217 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include "core/TemplateCache.h"
+
+namespace
+{
+
+bool check(bool condition, const char* testName)
+{
+    if (condition)
+    {
+        std::cout << "  PASSED: " << testName << "\n";
+        return true;
+    }
+    std::cout << "  FAILED: " << testName << "\n";
+    return false;
+}
+
+// the literal text and the commands as "[name|param|param]"
+wxString describe(const CompiledTemplate& compiled)
+{
+    wxString result;
+    const std::vector<CompiledTemplate::Segment>& segments =
+        compiled.getSegments();
+    for (size_t i = 0; i < segments.size(); ++i)
+    {
+        compiled.appendText(result, segments[i]);
+        if (segments[i].cmdName.IsEmpty())
+            continue;
+        result += "[" + segments[i].cmdName;
+        for (size_t p = 0; p < segments[i].cmdParams.Count(); ++p)
+            result += "|" + segments[i].cmdParams[p];
+        result += "]";
+    }
+    return result;
+}
+
+// expands {%foreach:n:<separator>:<text>%} the way the template processor
+// does, with {%i%} expanding to the number of the item
+void expand(TemplateCache& cache, wxString& processedText,
+    const wxString& text, int item, bool useCache)
+{
+    if (text.find("{%") == wxString::npos)
+    {
+        processedText += text;
+        return;
+    }
+    CompiledTemplatePtr compiled(useCache ? cache.compile(text)
+        : CompiledTemplatePtr(new CompiledTemplate(text)));
+    const std::vector<CompiledTemplate::Segment>& segments =
+        compiled->getSegments();
+    for (size_t i = 0; i < segments.size(); ++i)
+    {
+        compiled->appendText(processedText, segments[i]);
+        const CompiledTemplate::Segment& s = segments[i];
+        if (s.cmdName == "i")
+            processedText << item;
+        else if (s.cmdName == "foreach" && s.cmdParams.Count() >= 3)
+        {
+            long count = 0;
+            s.cmdParams[0].ToLong(&count);
+            for (long n = 0; n < count; ++n)
+            {
+                if (n > 0)
+                    expand(cache, processedText, s.cmdParams[1], int(n), useCache);
+                expand(cache, processedText, s.cmdParams.from(2), int(n), useCache);
+            }
+        }
+        else if (s.cmdName == "if" && s.cmdParams.Count() >= 2)
+            expand(cache, processedText, s.cmdParams.from(1), item, useCache);
+    }
+}
+
+const char* const tempFileName = "template_cache_test.template";
+
+void writeFile(const char* contents)
+{
+    std::ofstream file(tempFileName);
+    file << contents;
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = true;
+    std::cout << "Running TemplateCache Tests...\n";
+
+    // Test 1: literal text, commands and their parameters
+    {
+        CompiledTemplate t("a{%x%}b{%y:1:'p:q':\"r:s\"%}c");
+        ok = check(describe(t) == "a[x]b[y|1|'p:q'|\"r:s\"]c",
+            "Commands and quoted parameters") && ok;
+        ok = check(t.getSegments().size() == 3
+            && t.getSegments()[2].cmdName.IsEmpty(), "Trailing text") && ok;
+
+        CompiledTemplate n("{%foreach:column:, :{%if:{%x%}:a:b%}%}");
+        ok = check(describe(n) == "[foreach|column|, |{%if:{%x%}:a:b%}]",
+            "Nested commands are one parameter") && ok;
+        ok = check(n.getSegments()[0].cmdParams.from(1) == ", :{%if:{%x%}:a:b%}",
+            "Parameters joined again") && ok;
+
+        CompiledTemplate u("a{%x%}b{%y:c");
+        ok = check(describe(u) == "a[x]", "Unterminated command drops the rest") && ok;
+
+        CompiledTemplate e("a{%%}b{%:x%}c");
+        ok = check(describe(e) == "abc", "Empty commands are skipped") && ok;
+    }
+
+    // Test 2: texts are compiled once
+    {
+        TemplateCache cache(2);
+        CompiledTemplatePtr a(cache.compile("{%a%}"));
+        ok = check(cache.compile("{%a%}") == a, "Same text, same template") && ok;
+        CompiledTemplatePtr b(cache.compile("{%b%}"));
+        CompiledTemplatePtr c(cache.compile("{%c%}"));
+        ok = check(cache.getTextCount() == 3 && cache.compile("{%a%}") == a,
+            "Old generation is found") && ok;
+        cache.compile("{%d%}");
+        ok = check(cache.compile("{%a%}") == a && cache.compile("{%b%}") != b,
+            "Texts that are used are kept") && ok;
+        cache.clear();
+        ok = check(cache.getTextCount() == 0 && cache.compile("{%a%}") != a,
+            "Cleared") && ok;
+    }
+
+    // Test 3: files are read again when they change
+    {
+        TemplateCache cache;
+        writeFile("first {%x%}");
+        wxFileName fileName(tempFileName);
+        CompiledTemplatePtr first(cache.compileFile(fileName));
+        ok = check(first->getText() == "first {%x%}"
+            && cache.compileFile(fileName) == first, "File is read once") && ok;
+
+        writeFile("second {%x%}");
+        wxDateTime modified(wxDateTime::Now() + wxTimeSpan::Hour());
+        fileName.SetTimes(0, &modified, 0);
+        CompiledTemplatePtr second(cache.compileFile(fileName));
+        ok = check(second != first && second->getText() == "second {%x%}",
+            "Changed file is read again") && ok;
+        std::remove(tempFileName);
+    }
+
+    // Test 4: a loop over 500 columns
+    {
+        const wxString text("CREATE TABLE T ({%foreach:500:,\n:"
+            "{%if:true:C{%i%} INTEGER{%if:true: NOT NULL%}%}%});");
+        const int repeat = 20;
+        TemplateCache cache;
+        wxString cached, parsed;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repeat; ++i)
+        {
+            parsed.clear();
+            expand(cache, parsed, text, 0, false);
+        }
+        double parseMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repeat; ++i)
+        {
+            cached.clear();
+            expand(cache, cached, text, 0, true);
+        }
+        double cacheMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "  INFO: " << repeat << " expansions of 500 columns take "
+                  << parseMs << " ms parsed every time, " << cacheMs
+                  << " ms compiled once\n";
+        ok = check(cached == parsed && cached.find("C499 INTEGER NOT NULL);")
+            != wxString::npos, "Same output") && ok;
+        ok = check(cacheMs < parseMs, "Compiled once is faster") && ok;
+    }
+
+    std::cout << "TemplateCache Tests completed: "
+              << (ok ? "ALL PASSED" : "SOME FAILED") << "\n";
+    return ok ? 0 : 1;
+}
@@ -149,40 +149,32 @@ void TemplateProcessor::processCommand(const wxString& cmdName,
     // {%if:<term>:<true output>[:<false output>]%}
     // If <term> equals true expands to <true output>, otherwise
     // expands to <false output> (or an empty string).
+    // Only the output that is chosen is expanded.
     else if (cmdName == "if" && (cmdParams.Count() >= 2))
     {
         wxString val;
         internalProcessTemplateText(val, cmdParams[0], object);
 
-        wxString trueText;
-        internalProcessTemplateText(trueText, cmdParams[1], object);
-        wxString falseText;
-        if (cmdParams.Count() >= 3)
-            internalProcessTemplateText(falseText, cmdParams.from(2), object);
         if (getStringAsBoolean(val))
-            processedText += trueText;
-        else
-            processedText += falseText;
+            internalProcessTemplateText(processedText, cmdParams[1], object);
+        else if (cmdParams.Count() >= 3)
+            internalProcessTemplateText(processedText, cmdParams.from(2), object);
     }
 
     // {%ifeq:<left term>:<right term>:<true output>[:<false output>]%}
     // If <left term> equals <right term> expands to <true output>, otherwise
     // expands to <false output> (or an empty string).
+    // Only the output that is chosen is expanded.
     else if (cmdName == "ifeq" && (cmdParams.Count() >= 3))
     {
         wxString val1;
         internalProcessTemplateText(val1, cmdParams[0], object);
         wxString val2;
         internalProcessTemplateText(val2, cmdParams[1], object);
-        wxString trueText;
-        internalProcessTemplateText(trueText, cmdParams[2], object);
-        wxString falseText;
-        if (cmdParams.Count() >= 4)
-            internalProcessTemplateText(falseText, cmdParams.from(3), object);
         if (val1 == val2)
-            processedText += trueText;
-        else
-            processedText += falseText;
+            internalProcessTemplateText(processedText, cmdParams[2], object);
+        else if (cmdParams.Count() >= 4)
+            internalProcessTemplateText(processedText, cmdParams.from(3), object);
     }
 
     // {%!:<input>%} or {%not:<input>%}
@@ -206,6 +198,7 @@ void TemplateProcessor::processCommand(const wxString& cmdName,
     // If <list> contains <term> expands to <true output>, otherwise
     // expands to <false output> (or an empty string).
     // <list> is a list of comma-separated values.
+    // Only the output that is chosen is expanded.
     else if (cmdName == "ifcontains" && (cmdParams.Count() >= 3))
     {
         wxString listStr;
@@ -215,15 +208,10 @@ void TemplateProcessor::processCommand(const wxString& cmdName,
             list[i] = list[i].Trim(true).Trim(false);
         wxString val2;
         internalProcessTemplateText(val2, cmdParams[1], object);
-        wxString trueText;
-        internalProcessTemplateText(trueText, cmdParams[2], object);
-        wxString falseText;
-        if (cmdParams.Count() >= 4)
-            internalProcessTemplateText(falseText, cmdParams.from(3), object);
         if (list.Index(val2) != wxNOT_FOUND)
-            processedText += trueText;
-        else
-            processedText += falseText;
+            internalProcessTemplateText(processedText, cmdParams[2], object);
+        else if (cmdParams.Count() >= 4)
+            internalProcessTemplateText(processedText, cmdParams.from(3), object);
     }
 
     // {%forall:<list>:<separator>:<text>%}
@@ -395,97 +383,35 @@ void TemplateProcessor::processCommand(const wxString& cmdName,
 
 void TemplateProcessor::internalProcessTemplateText(wxString& processedText,
     const wxString& inputText, ProcessableObject* object)
+{
+    // text without commands is copied, everything else is compiled only
+    // the first time it is expanded
+    if (inputText.find("{%") == wxString::npos)
+    {
+        processedText += inputText;
+        return;
+    }
+    processCompiledTemplate(processedText,
+        *TemplateCache::get().compile(inputText), object);
+}
+
+void TemplateProcessor::processCompiledTemplate(wxString& processedText,
+    const CompiledTemplate& compiled, ProcessableObject* object)
 {
     if (object == 0)
         object = objectM;
 
-    // parse commands
-    wxString::size_type pos = 0, oldpos = 0, endpos = 0;
-    while (true)
+    processedText.reserve(processedText.length() + compiled.getText().length());
+    const std::vector<CompiledTemplate::Segment>& segments =
+        compiled.getSegments();
+    for (size_t i = 0; i < segments.size(); ++i)
     {
-        pos = inputText.find("{%", pos);
-        if (pos == wxString::npos)
-        {
-            processedText += inputText.substr(oldpos);
-            break;
-        }
-
-        wxString::size_type check, startpos = pos;
-        int cnt = 1;
-        while (cnt > 0)
-        {
-            endpos = inputText.find("%}", startpos+1);
-            if (endpos == wxString::npos)
-                break;
-
-            check = inputText.find("{%", startpos+1);
-            if (check == wxString::npos)
-                startpos = endpos;
-            else
-            {
-                startpos = (check < endpos ? check : endpos);
-                if (startpos == check)
-                    cnt++;
-            }
-            if (startpos == endpos)
-                cnt--;
-            startpos++;
-        }
-
-        if (cnt > 0)    // no matching closing %}
-            break;
-
-        processedText += inputText.substr(oldpos, pos - oldpos);
-        wxString cmd = inputText.substr(pos + 2, endpos - pos - 2); // 2 = start_marker_len = end_marker_len
-
-        // parse command name and params.
-        wxString cmdName;
-        TemplateCmdParams cmdParams;
-
-        enum TemplateCmdState
-        {
-            inText,
-            inString1,
-            inString2
-        };
-        TemplateCmdState state = inText;
-        wxString buffer;
-        unsigned int nestLevel = 0;
-        for (wxString::size_type i = 0; i < cmd.Length(); i++)
+        compiled.appendText(processedText, segments[i]);
+        if (!segments[i].cmdName.IsEmpty())
         {
-            wxChar c = cmd[i];
-
-            if (c == ':')
-            {
-                if ((nestLevel == 0) && (state == inText))
-                {
-                    cmdParams.Add(buffer);
-                    buffer.Clear();
-                    continue;
-                }
-            }
-            buffer += c;
-
-            if ((c == '{') && (i < cmd.Length() - 1) && (cmd[i + 1] == '%'))
-                nestLevel++;
-            else if ((c == '}') && (i > 0) && (cmd[i - 1] == '%'))
-                nestLevel--;
-            else if (c == '\'')
-                state == inString1 ? state = inText : state = inString1;
-            else if (c == '"')
-                state == inString2 ? state = inText : state = inString2;
+            processCommand(segments[i].cmdName, segments[i].cmdParams, object,
+                processedText);
         }
-        if (buffer.Length() > 0)
-            cmdParams.Add(buffer);
-
-        if (cmdParams.Count() > 0)
-        {
-            cmdName = cmdParams[0];
-            cmdParams.RemoveAt(0);
-            if (!cmdName.IsEmpty())
-                processCommand(cmdName, cmdParams, object, processedText);
-        }
-        oldpos = pos = endpos + 2;
     }
 }
 
@@ -506,8 +432,9 @@ void TemplateProcessor::processTemplateFile(wxString& processedText,
     confFileName.SetExt("conf");
     configM.setConfigFileName(confFileName);
     progressIndicatorM = progressIndicator;
-    internalProcessTemplateText(processedText, loadEntireFile(fileNameM),
-        object);
+    // keep the compiled template alive, even if the cache drops it
+    CompiledTemplatePtr compiled(TemplateCache::get().compileFile(fileNameM));
+    processCompiledTemplate(processedText, *compiled, object);
 }
 
 void TemplateProcessor::processTemplateText(wxString& processedText,
@@ -546,23 +473,6 @@ wxString TemplateProcessor::getTemplatePath()
     return fileNameM.GetPathWithSep();
 }
 
-wxString TemplateCmdParams::all() const
-{
-    return from(0);
-}
-
-wxString TemplateCmdParams::from(size_t start) const
-{
-    wxString result;
-    if (start < Count())
-    {
-        result = Item(start);
-        for (size_t i = start + 1; i < Count(); i++)
-            result += ':' + Item(i);
-    }
-    return result;
-}
-
 TemplateCmdHandlerRepository& getTemplateCmdHandlerRepository()
 {
     static TemplateCmdHandlerRepository repository;
@@ -34,17 +34,9 @@
 #include "config/Config.h"
 #include "core/ProcessableObject.h"
 #include "core/ProgressIndicator.h"
+#include "core/TemplateCache.h"
 
 
-class TemplateCmdParams: public wxArrayString
-{
-public:
-    // returns all params concatenated with the default separator.
-    wxString all() const;
-    // returns all params from start, concatenated with the default separator.
-    wxString from(size_t start) const;
-};
-
 typedef std::map<wxString, wxString> wxStringMap;
 
 class TemplateCmdHandler;
@@ -68,6 +60,9 @@ protected:
         wxString& processedText);
     // Returns the loaded file's path, including the trailing separator.
     wxString getTemplatePath();
+    // Appends the literal text and runs the commands of a compiled template.
+    void processCompiledTemplate(wxString& processedText,
+        const CompiledTemplate& compiled, ProcessableObject* object);
 public:
     wxWindow* getWindow() { return windowM; };
     // Returns a reference to the current progress indicator, so that
@@ -78,7 +73,8 @@ public:
     // cmdParams field may be empty, in which case the format is {%cmdName*}
     void processTemplateText(wxString& processedText, const wxString& inputText,
         ProcessableObject* object, ProgressIndicator* progressIndicator = 0);
-    // Loads the contents of the specified file and calls internalProcessTemplateText().
+    // Processes the contents of the specified file, which is only read
+    // again when it has been changed.
     void processTemplateFile(wxString& processedText,
         const wxFileName& inputFileName, ProcessableObject* object,
         ProgressIndicator* progressIndicator = 0);
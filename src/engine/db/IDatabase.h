@@ -39,6 +39,9 @@ public:
     virtual void connect() = 0;
     virtual void disconnect() = 0;
     virtual bool isConnected() = 0;
+    // cancels the statement that runs on the connection, may be called
+    // from another thread; does nothing if none is running
+    virtual void cancelOperation() = 0;
     virtual void create(int pagesize, int dialect, const std::string& owner = "",
         const std::string& initialUser = "") = 0;
     virtual void drop() = 0;
@@ -139,6 +139,21 @@ bool FbCppDatabase::isConnected()
     return attachmentM.has_value();
 }
 
+void FbCppDatabase::cancelOperation()
+{
+    if (!attachmentM)
+        return;
+
+    fbcpp::impl::StatusWrapper status(attachmentM->getClient());
+    try
+    {
+        attachmentM->getHandle()->cancelOperation(&status, fb_cancel_raise);
+    }
+    catch (...) // nothing to cancel
+    {
+    }
+}
+
 void FbCppDatabase::create(int pagesize, int dialect, const std::string& owner,
     const std::string& initialUser)
 {
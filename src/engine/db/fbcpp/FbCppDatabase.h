@@ -41,6 +41,7 @@ public:
     virtual void connect() override;
     virtual void disconnect() override;
     virtual bool isConnected() override;
+    virtual void cancelOperation() override;
     virtual void create(int pagesize, int dialect, const std::string& owner = "",
         const std::string& initialUser = "") override;
     virtual void drop() override;
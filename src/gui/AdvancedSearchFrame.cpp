@@ -32,6 +32,8 @@
 
 #include <set>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 #include "frutils.h"
 #include "gui/AdvancedSearchFrame.h"
@@ -45,6 +47,7 @@
 #include "metadata/metadataitem.h"
 #include "metadata/domain.h"
 #include "metadata/Index.h"
+#include "metadata/MetadataSearchIndex.h"
 #include "metadata/parameter.h"
 #include "metadata/procedure.h"
 #include "metadata/root.h"
@@ -96,6 +99,262 @@ BEGIN_EVENT_TABLE(AdjustableListCtrl, wxListCtrl)
     EVT_SIZE(AdjustableListCtrl::OnSize)
 END_EVENT_TABLE()
 
+// DatabaseSearchIndex class
+// The search index of a database and the objects its documents stand for.
+// The text of the objects is only loaded once, and only the kinds of text
+// that a search needs. The metadata collections are observed, so the index
+// is built again when objects are created or dropped, and so is every
+// object, so the text of a changed object is loaded again.
+// Observer callbacks only set flags, so that they can't interfere with a
+// search of the index running on another thread.
+class DatabaseSearchIndex: public Observer
+{
+private:
+    // Observer::update() doesn't tell the subject, so every object gets
+    // an observer that knows its document
+    class ItemObserver: public Observer
+    {
+    private:
+        DatabaseSearchIndex& ownerM;
+        size_t documentM;
+
+        virtual void update()
+        {
+            ownerM.indexM.setStale(documentM);
+        }
+        virtual void subjectRemoved(Subject* WXUNUSED(subject))
+        {
+            ownerM.validM = false;
+        }
+    public:
+        ItemObserver(DatabaseSearchIndex& owner, size_t document)
+            : ownerM(owner), documentM(document)
+        {
+        }
+    };
+
+    Database* databaseM;
+    bool validM;
+    std::vector<Subject*> collectionsM;
+    std::vector<MetadataItem*> itemsM;
+    std::vector<std::unique_ptr<ItemObserver> > itemObserversM;
+    MetadataSearchIndex indexM;
+
+    void rebuild();
+    void loadText(size_t document, MetadataSearchIndex::Kind kind);
+
+    virtual void update();
+    virtual void subjectRemoved(Subject* subject);
+public:
+    DatabaseSearchIndex(Database* database);
+
+    Database* getDatabase() const;
+    // false once objects of the database were created or dropped, the
+    // documents must not be mapped to objects then
+    bool isValid() const;
+    MetadataItem* getItem(size_t document) const;
+    MetadataSearchIndex& getIndex();
+
+    // loads the text that criteria needs, metadata can only be loaded
+    // on the main thread
+    void load(const MetadataSearchIndex::Criteria& criteria,
+        ProgressIndicator* progressIndicator);
+};
+
+DatabaseSearchIndex::DatabaseSearchIndex(Database* database)
+    : Observer(), databaseM(database), validM(false)
+{
+}
+
+Database* DatabaseSearchIndex::getDatabase() const
+{
+    return databaseM;
+}
+
+bool DatabaseSearchIndex::isValid() const
+{
+    return validM;
+}
+
+MetadataItem* DatabaseSearchIndex::getItem(size_t document) const
+{
+    return itemsM[document];
+}
+
+MetadataSearchIndex& DatabaseSearchIndex::getIndex()
+{
+    return indexM;
+}
+
+void DatabaseSearchIndex::update()
+{
+    validM = false;
+}
+
+void DatabaseSearchIndex::subjectRemoved(Subject* subject)
+{
+    collectionsM.erase(std::remove(collectionsM.begin(), collectionsM.end(),
+        subject), collectionsM.end());
+    validM = false;
+}
+
+void DatabaseSearchIndex::rebuild()
+{
+    for (size_t i = 0; i < collectionsM.size(); ++i)
+        collectionsM[i]->detachObserver(this);
+    collectionsM.clear();
+    itemObserversM.clear();
+    itemsM.clear();
+    indexM.clear();
+
+    // the children are loaded before observing, so that doesn't invalidate
+    // the index right away
+    std::vector<MetadataItem*> colls;
+    databaseM->getCollections(colls, false);   // false = not system objects
+    for (std::vector<MetadataItem*>::iterator col = colls.begin();
+        col != colls.end(); ++col)
+    {
+        std::vector<MetadataItem*> ch;
+        (*col)->getChildren(ch);
+        for (std::vector<MetadataItem*>::iterator it = ch.begin();
+            it != ch.end(); ++it)
+        {
+            size_t document = indexM.addDocument((*it)->getType());
+            indexM.setText(document, MetadataSearchIndex::kName,
+                (*it)->getName_());
+            itemsM.push_back(*it);
+        }
+    }
+    for (std::vector<MetadataItem*>::iterator col = colls.begin();
+        col != colls.end(); ++col)
+    {
+        (*col)->attachObserver(this, false);
+        collectionsM.push_back(*col);
+    }
+    for (size_t i = 0; i < itemsM.size(); ++i)
+    {
+        itemObserversM.push_back(std::unique_ptr<ItemObserver>(
+            new ItemObserver(*this, i)));
+        itemsM[i]->attachObserver(itemObserversM.back().get(), false);
+    }
+    validM = true;
+}
+
+void DatabaseSearchIndex::loadText(size_t document,
+    MetadataSearchIndex::Kind kind)
+{
+    MetadataItem* item = itemsM[document];
+    std::vector<wxString> values;
+    switch (kind)
+    {
+        case MetadataSearchIndex::kName:
+            values.push_back(item->getName_());
+            break;
+        case MetadataSearchIndex::kDescription:
+        {
+            wxString desc;
+            if (item->getDescription(desc))
+                values.push_back(desc);
+            break;
+        }
+        case MetadataSearchIndex::kDDL:
+        {
+            CreateDDLVisitor cdv;
+            item->acceptVisitor(&cdv);
+            values.push_back(cdv.getSql());
+            break;
+        }
+        case MetadataSearchIndex::kFields:
+        {
+            Relation* r = dynamic_cast<Relation*>(item);
+            Procedure* p = dynamic_cast<Procedure*>(item);
+            Index* idx = dynamic_cast<Index*>(item);
+            if (r || p)
+                item->ensureChildrenLoaded();
+            if (r)
+            {
+                for (ColumnPtrs::const_iterator it = r->begin(); it != r->end(); ++it)
+                    values.push_back((*it)->getName_());
+            }
+            if (p)
+            {
+                for (ParameterPtrs::const_iterator it = p->begin(); it != p->end(); ++it)
+                    values.push_back((*it)->getName_());
+            }
+            if (idx)
+            {
+                item->ensurePropertiesLoaded();
+                const std::vector<wxString>& segments = *idx->getSegments();
+                values.insert(values.end(), segments.begin(), segments.end());
+                if (!idx->getExpression().IsEmpty())
+                    values.push_back(idx->getExpression());
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    indexM.setText(document, kind, values);
+}
+
+void DatabaseSearchIndex::load(const MetadataSearchIndex::Criteria& criteria,
+    ProgressIndicator* progressIndicator)
+{
+    if (!validM)
+        rebuild();
+
+    std::vector<size_t> needed[MetadataSearchIndex::kindCount];
+    size_t count = 0, relations = 0, neededRelations = 0;
+    for (size_t i = 0; i < itemsM.size(); ++i)
+    {
+        bool relation = dynamic_cast<Relation*>(itemsM[i]) != 0;
+        if (relation)
+            ++relations;
+        bool relationNeeded = false;
+        for (int k = 0; k < MetadataSearchIndex::kindCount; ++k)
+        {
+            MetadataSearchIndex::Kind kind = MetadataSearchIndex::Kind(k);
+            if (criteria.uses(kind) && indexM.needsText(i, kind))
+            {
+                needed[k].push_back(i);
+                ++count;
+                if (kind == MetadataSearchIndex::kDDL
+                    || kind == MetadataSearchIndex::kFields)
+                {
+                    relationNeeded = relation;
+                }
+            }
+        }
+        if (relationNeeded)
+            ++neededRelations;
+    }
+    if (count == 0)
+        return;
+
+    // the columns, constraints and indices of many relations are loaded
+    // faster all at once than one relation after the other
+    if (neededRelations > 1 && neededRelations * 4 > relations)
+        databaseM->loadRelationDetails(progressIndicator);
+
+    if (progressIndicator)
+        progressIndicator->initProgress(wxEmptyString, count, 0, 2);
+    for (int k = 0; k < MetadataSearchIndex::kindCount; ++k)
+    {
+        for (size_t i = 0; i < needed[k].size(); ++i)
+        {
+            size_t document = needed[k][i];
+            if (progressIndicator)
+            {
+                checkProgressIndicatorCanceled(progressIndicator);
+                progressIndicator->setProgressMessage(_("Searching ")
+                    + itemsM[document]->getName_(), 2);
+                progressIndicator->stepProgress(1, 2);
+            }
+            loadText(document, MetadataSearchIndex::Kind(k));
+        }
+    }
+}
+
 AdvancedSearchFrame::AdvancedSearchFrame(MainFrame* parent, RootPtr root)
     : BaseFrame(parent, -1, _("Advanced Metadata Search"))
 {
@@ -315,19 +574,6 @@ void AdvancedSearchFrame::addResult(Database* db, MetadataItem* item)
     listctrl_results->GetEventHandler()->AddPendingEvent(ev);
 }
 
-// returns true if "text" matches all criteria of type "type"
-bool AdvancedSearchFrame::match(CriteriaItem::Type type, const wxString& text)
-{
-    for (CriteriaCollection::const_iterator ci =
-        searchCriteriaM.lower_bound(type); ci !=
-        searchCriteriaM.upper_bound(type); ++ci)
-    {
-        if (text.Upper().Matches((*ci).second.value))
-            return true;
-    }
-    return false;
-}
-
 // OBSERVER functions
 void AdvancedSearchFrame::update()
 {
@@ -352,6 +598,15 @@ void AdvancedSearchFrame::subjectRemoved(Subject* subject)
             break;
         }
     }
+    for (IndexCollection::iterator it = indicesM.begin();
+        it != indicesM.end(); ++it)
+    {
+        if (subject == (*it).first)
+        {
+            indicesM.erase(it);
+            break;
+        }
+    }
     // remove from listctrl_criteria + searchCriteriaM
     bool removed_db = false;
     while (true)    // in case iterators get invalidated on delete
@@ -523,15 +778,19 @@ void AdvancedSearchFrame::OnButtonStartClick(wxCommandEvent& WXUNUSED(event))
     results.clear();
     listctrl_results->DeleteAllItems();
 
-    // get all types we want to match, for faster lookup later
-    std::set<NodeType> types;
-    if (searchCriteriaM.count(CriteriaItem::ctType) != 0)
+    MetadataSearchIndex::Criteria criteria;
+    const CriteriaItem::Type textTypes[MetadataSearchIndex::kindCount] = {
+        CriteriaItem::ctName, CriteriaItem::ctDescription,
+        CriteriaItem::ctDDL, CriteriaItem::ctField };
+    for (CriteriaCollection::const_iterator ci = searchCriteriaM.begin();
+        ci != searchCriteriaM.end(); ++ci)
     {
-        for (CriteriaCollection::const_iterator
-            ct = searchCriteriaM.lower_bound(CriteriaItem::ctType);
-            ct != searchCriteriaM.upper_bound(CriteriaItem::ctType); ++ct)
+        if ((*ci).first == CriteriaItem::ctType)
+            criteria.types.insert(getTypeByName((*ci).second.value));
+        for (int k = 0; k < MetadataSearchIndex::kindCount; ++k)
         {
-            types.insert(getTypeByName((*ct).second.value));
+            if ((*ci).first == textTypes[k])
+                criteria.patterns[k].push_back((*ci).second.value);
         }
     }
 
@@ -543,106 +802,99 @@ void AdvancedSearchFrame::OnButtonStartClick(wxCommandEvent& WXUNUSED(event))
         database_count++;
     }
 
+    // Metadata can only be loaded on this thread, but every database is
+    // searched on a thread of its own as soon as its text is loaded, so
+    // that runs while the next database is loaded, and the results of a
+    // database are shown once its search is done.
+    struct Search
+    {
+        std::shared_ptr<DatabaseSearchIndex> index;
+        std::vector<size_t> matches;
+        std::atomic<bool> done;
+        std::thread thread;
+    };
+    std::vector<std::unique_ptr<Search> > searches;
+    std::atomic<bool> cancel(false);
+    size_t shown = 0;
+    auto showResults = [&]()
+    {
+        for (; shown < searches.size(); ++shown)
+        {
+            Search& search = *searches[shown];
+            if (!search.done)
+                break;
+            search.thread.join();
+            // the objects may have been dropped meanwhile
+            if (cancel || !search.index->isValid())
+                continue;
+            Database* db = search.index->getDatabase();
+            for (size_t i = 0; i < search.matches.size(); ++i)
+                addResult(db, search.index->getItem(search.matches[i]));
+        }
+    };
+
     // foreach database
     int current = 0;
     ProgressDialog pd(0, _("Searching..."), 2);
     pd.doShow();
-    for (CriteriaCollection::const_iterator
-        cid = searchCriteriaM.lower_bound(CriteriaItem::ctDB);
-        cid != searchCriteriaM.upper_bound(CriteriaItem::ctDB); ++cid)
+    try
     {
-        if (pd.isCanceled())
-            return;
-        pd.setProgressPosition(0, 2);
-        Database *db = (*cid).second.database;
-        if (!db->isConnected() && !connectDatabase(db, this, &pd))
-            continue;
-
-        pd.initProgress(_("Searching database: ")+db->getName_(),
-            database_count, current++, 1);
-
-        std::vector<MetadataItem *> colls;
-        db->getCollections(colls, false);   // false = not system objects
-        for (std::vector<MetadataItem *>::iterator col = colls.begin(); col !=
-            colls.end(); ++col)
+        for (CriteriaCollection::const_iterator
+            cid = searchCriteriaM.lower_bound(CriteriaItem::ctDB);
+            cid != searchCriteriaM.upper_bound(CriteriaItem::ctDB); ++cid)
         {
-            std::vector<MetadataItem *> ch;
-            (*col)->getChildren(ch);
-            pd.initProgress(wxEmptyString, ch.size(), 0, 2);
-            for (std::vector<MetadataItem *>::iterator it = ch.begin(); it !=
-                ch.end(); ++it)
+            if (pd.isCanceled())
+                break;
+            pd.setProgressPosition(0, 2);
+            Database *db = (*cid).second.database;
+            if (!db->isConnected() && !connectDatabase(db, this, &pd))
+                continue;
+
+            pd.initProgress(_("Searching database: ")+db->getName_(),
+                database_count, current++, 1);
+
+            std::shared_ptr<DatabaseSearchIndex> index = indicesM[db];
+            if (!index)
             {
-                if (!types.empty() &&
-                    types.find((*it)->getType()) == types.end())
-                    break;
-                pd.setProgressMessage(_("Searching ") + (*col)->getName_() +
-                    ": " + (*it)->getName_(), 2);
-                pd.stepProgress(1, 2);
-                if (pd.isCanceled())
-                    return;
-                if (searchCriteriaM.count(CriteriaItem::ctName) > 0)
-                {
-                    wxString name = (*it)->getName_();
-                    if (!match(CriteriaItem::ctName, name))
-                        continue;
-                }
-                if (searchCriteriaM.count(CriteriaItem::ctDescription) > 0)
-                {
-                    wxString desc;
-                    if (!(*it)->getDescription(desc))
-                        continue;
-                    if (!match(CriteriaItem::ctDescription, desc))
-                        continue;
-                }
-                if (searchCriteriaM.count(CriteriaItem::ctDDL) > 0)
-                {
-                    // TODO: add ProgressDialog, and link it up in here
-                    CreateDDLVisitor cdv;
-                    (*it)->acceptVisitor(&cdv);
-                    if (!match(CriteriaItem::ctDDL, cdv.getSql()))
-                        continue;
-                }
-                if (searchCriteriaM.count(CriteriaItem::ctField) > 0)
-                {
-                    Relation* r = dynamic_cast<Relation*>(*it);
-                    Procedure* p = dynamic_cast<Procedure*>(*it);
-                    Index* idx = dynamic_cast<Index*>(*it);
-                    if (r || p || idx)
-                    {
-                        (*it)->ensureChildrenLoaded();
-                        bool found = false;
-                        if (r)
-                        {
-                            found |= std::any_of(r->begin(), r->end(),
-                                                 [this](ColumnPtr i) { return match(CriteriaItem::ctField, i->getName_()); });
-                        }
-                        if (p)
-                        {
-                            found |= std::any_of(p->begin(), p->end(),
-                                                 [this](ParameterPtr i) { return match(CriteriaItem::ctField, i->getName_()); });
-                        }
-                        if (idx)
-                        {
-                            (*it)->ensurePropertiesLoaded();
-                            const std::vector<wxString>& segments = *idx->getSegments();
-                            found |= std::any_of(segments.begin(), segments.end(),
-                                [this](const wxString& segment)
-                                {
-                                    return match(CriteriaItem::ctField, segment);
-                                }
-                            );
-                            if (!found && !idx->getExpression().IsEmpty())
-                                found |= match(CriteriaItem::ctField, idx->getExpression());
-                        }
-                        if (!found)     // object doesn't contain that field
-                            continue;
-                    }
-                }
-                // everything criteria is matched -> add to results
-                addResult(db, *it);
+                index.reset(new DatabaseSearchIndex(db));
+                indicesM[db] = index;
             }
+            index->load(criteria, &pd);
+
+            searches.push_back(std::unique_ptr<Search>(new Search));
+            Search& search = *searches.back();
+            search.index = index;
+            search.done = false;
+            search.thread = std::thread([&search, &criteria, &cancel]()
+            {
+                search.index->getIndex().prepare(criteria);
+                search.index->getIndex().search(criteria, search.matches,
+                    cancel);
+                search.done = true;
+            });
+            showResults();
         }
     }
+    catch (CancelProgressException&)
+    {
+    }
+    catch (...)
+    {
+        cancel = true;
+        for (; shown < searches.size(); ++shown)
+            searches[shown]->thread.join();
+        throw;
+    }
+
+    pd.initProgressIndeterminate(_("Searching..."), 1);
+    while (shown < searches.size())
+    {
+        if (pd.isCanceled())
+            cancel = true;
+        showResults();
+        if (shown < searches.size())
+            wxMilliSleep(10);
+    }
 }
 
 void AdvancedSearchFrame::OnButtonAddTypeClick(wxCommandEvent& WXUNUSED(event))
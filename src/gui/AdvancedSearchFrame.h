@@ -28,6 +28,7 @@
 #include <wx/splitter.h>
 
 #include <map>
+#include <memory>
 
 #include "core/Observer.h"
 #include "gui/BaseFrame.h"
@@ -67,6 +68,7 @@ class MetadataItem;
 class Root;
 
 class AdjustableListCtrl;   // declaration in cpp file
+class DatabaseSearchIndex;  // declaration in cpp file
 class MainFrame;
 class wxStyledTextCtrl;
 
@@ -80,7 +82,11 @@ private:
     void rebuildList();
     std::vector<MetadataItem *> results;
     void addResult(Database* db, MetadataItem* item);
-    bool match(CriteriaItem::Type type, const wxString& text);
+    // search indices are kept for the next search, and shared with
+    // the threads searching them
+    typedef std::map<Database*, std::shared_ptr<DatabaseSearchIndex> >
+        IndexCollection;
+    IndexCollection indicesM;
 
     // observer stuff
     virtual void subjectRemoved(Subject* subject);
@@ -52,6 +52,7 @@ enum {
     Query_Rollback,
     Query_Format,
     Query_BatchImport,
+    Query_ExecuteScriptFile,
     // next 4: order is important, because EVT_MENU_RANGE is used
     Query_TransactionConcurrency,
     Query_TransactionReadDirty,
@@ -82,6 +83,7 @@ enum {
     DataGrid_Save_as_json,
     DataGrid_Save_as_excel,
     DataGrid_Save_as_markdown,
+    DataGrid_Export_all,
     DataGrid_Log_changes,
     DataGrid_AutofitColumns,
     DataGrid_AutofitRows,
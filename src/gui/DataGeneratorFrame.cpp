@@ -39,154 +39,35 @@
 #include <wx/txtstrm.h>
 #include <wx/xml/xml.h>
 
-// needed for random
-#include <stdlib.h>
-
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "config/Config.h"
 #include "core/ArtProvider.h"
 #include "core/FRError.h"
 #include "core/StringUtils.h"
 #include "gui/AdvancedMessageDialog.h"
 #include "gui/controls/DBHTreeControl.h"
 #include "gui/DataGeneratorFrame.h"
+#include "gui/DataRowGenerator.h"
 #include "gui/ProgressDialog.h"
 #include "engine/db/IDatabase.h"
 #include "engine/db/ITransaction.h"
 #include "engine/db/IStatement.h"
+#include "engine/db/fbcpp/FbCppDatabase.h"
+#include "engine/db/fbcpp/FbCppTransaction.h"
 #include "metadata/column.h"
 #include "metadata/database.h"
+#include "metadata/DependencyGraph.h"
 #include "metadata/domain.h"
 #include "metadata/table.h"
 
-namespace IBPP
-{
-    const int MinDate = -693958;
-    const int MaxDate = 2958463;
-    const int Dec31_1899 = 693959;
-
-    inline bool dtoi(int date, int* y, int* m, int* d)
-    {
-        if (date < MinDate || date > MaxDate)
-            return false;
-
-        int RataDie = date + Dec31_1899;
-        int Z = RataDie + 306;
-        int H = 100 * Z - 25;
-        int A = H / 3652425;
-        int B = A - A / 4;
-        int year = (100 * B + H) / 36525;
-        int C = B + Z - 365 * year - year / 4;
-        int month = (5 * C + 456) / 153;
-        int day = C - (153 * month - 457) / 5;
-        if (month > 12) { year += 1; month -= 12; }
-
-        if (y != nullptr) *y = year;
-        if (m != nullptr) *m = month;
-        if (d != nullptr) *d = day;
-
-        return true;
-    }
-
-    inline bool itod(int* pdate, int year, int month, int day)
-    {
-        if (month < 1 || month > 12 || day < 1 || day > 31)
-            return false;
-
-        int y = year;
-        int m = month;
-        if (m <= 2) { y -= 1; m += 12; }
-
-        int RataDie = day + (153 * m - 457) / 5 + 365 * y + y / 4 - y / 100 + y / 400 - 306;
-        int date = RataDie - Dec31_1899;
-
-        if (date < MinDate || date > MaxDate)
-            return false;
-
-        if (pdate != nullptr) *pdate = date;
-        return true;
-    }
-
-    inline void ttoi(int itime, int* h, int* m, int* s, int* t)
-    {
-        int hh = itime / 36000000;   itime = itime - hh * 36000000;
-        int mm = itime / 600000;     itime = itime - mm * 600000;
-        int ss = itime / 10000;
-        int tt = itime - ss * 10000;
-
-        if (h != nullptr) *h = hh;
-        if (m != nullptr) *m = mm;
-        if (s != nullptr) *s = ss;
-        if (t != nullptr) *t = tt;
-    }
-
-    inline void itot(int* ptime, int hour, int minute, int second, int tenthousandths)
-    {
-        if (ptime != nullptr)
-            *ptime = hour * 36000000 + minute * 600000 + second * 10000 + tenthousandths;
-    }
-}
-
-// returns a value between 0 and (maxval-1)
-// I wrote this as I don't know how much is rand from stdlib portable
-int frRandom(double maxval)
-{
-    return (int)(maxval*rand()/(RAND_MAX+1.0));
-}
-
-// dd.mm.yyyy
-void str2date(const wxString& str, int& date)
-{
-    long d,m,y;
-    if (!str.Mid(0,2).ToLong(&d) || !str.Mid(3,2).ToLong(&m) ||
-        !str.Mid(6,4).ToLong(&y) || !IBPP::itod(&date, y,m,d))
-    {
-        throw FRError(_("Invalid date: ") + str);
-    }
-}
-
-// HH:MM:SS
-void str2time(const wxString& str, int& mytime)
-{
-    long h = 0, m = 0, s = 0;
-    if (!str.Mid(0, 2).ToLong(&h) || !str.Mid(3, 2).ToLong(&m)
-        || !str.Mid(6, 2).ToLong(&s))
-    {
-        throw FRError(_("Invalid time: ") + str);
-    }
-    IBPP::itot(&mytime, h, m, s, 0);
-}
-
-// only used in function OnGenerateButtonClick
-class TableDep
-{
-public:
-    TableDep(Table *t, std::map<wxString, int>& needs)
-    {
-        table = t;
-        std::vector<ForeignKey> *fk = t->getForeignKeys();
-        for (std::vector<ForeignKey>::iterator fi = fk->begin();
-            fi != fk->end(); ++fi)
-        {
-            Identifier id((*fi).getReferencedTable());
-            if (id.getQuoted() == t->getQuotedName())   // self reference
-                continue;
-            std::map<wxString, int>::iterator it =
-                needs.find(id.getQuoted());
-            if (it != needs.end() && (*it).second > 0)
-                dependsOn.push_back(id.getQuoted());
-        }
-    }
-    void remove(const wxString& tab_name)
-    {
-        std::list<wxString>::iterator it = std::find(dependsOn.begin(),
-            dependsOn.end(), tab_name);
-        if (it != dependsOn.end())
-            dependsOn.erase(it);
-    }
-
-    Table *table;
-    std::list<wxString> dependsOn;
-};
-
 // helper for saving settings
 void dsAddChildNode(wxXmlNode* parentNode, const wxString nodeName,
     const wxString nodeContent)
@@ -236,40 +117,6 @@ void parseTable(wxXmlNode* xmln, std::map<wxString, int>& tr)
         tr.insert(std::pair<wxString, int>(tablename, records));
 }
 
-class GeneratorSettings
-{
-public:
-    typedef enum { vtSkip, vtRange, vtColumn, vtFile } ValueType;
-    ValueType valueType;
-    wxString range;
-    wxString sourceTable;
-    wxString sourceColumn;
-    wxString fileName;
-    bool randomValues;
-    int nullPercent;
-
-    GeneratorSettings();
-    GeneratorSettings(GeneratorSettings* other);
-    void toXML(wxXmlNode *parent);
-    wxString fromXML(wxXmlNode *parent);    // returns column name
-};
-
-GeneratorSettings::GeneratorSettings()
-    : valueType(vtRange), randomValues(true), nullPercent(0)
-{
-}
-
-GeneratorSettings::GeneratorSettings(GeneratorSettings* other)
-{
-    valueType = other->valueType;
-    range = other->range;
-    sourceTable = other->sourceTable;
-    sourceColumn = other->sourceColumn;
-    fileName = other->fileName;
-    randomValues = other->randomValues;
-    nullPercent = other->nullPercent;
-}
-
 void GeneratorSettings::toXML(wxXmlNode *parent)
 {
     dsAddChildNode(parent, "valueType",
@@ -1062,10 +909,10 @@ void DataGeneratorFrame::OnGenerateButtonClick(wxCommandEvent& WXUNUSED(event))
 {
     saveSetting(mainTree->GetSelection());  // save current item if changed
 
-    std::list<Table *> order;
-    if (sortTables(order))
+    std::vector<std::list<Table *> > levels;
+    if (sortTables(levels))
     {
-        if (order.empty())
+        if (levels.empty())
         {
             showInformationDialog(this, _("Nothing to generate"),
                 _("No tables configured with records to create (> 0)."),
@@ -1075,10 +922,16 @@ void DataGeneratorFrame::OnGenerateButtonClick(wxCommandEvent& WXUNUSED(event))
 
         try
         {
-            generateData(order);
-            showInformationDialog(this, _("Generator done"),
-                _("Data generation completed successfully."),
-                AdvancedMessageDialogButtonsOk());
+            size_t records = 0;
+            double seconds = 0;
+            if (generateData(levels, records, seconds))
+            {
+                showInformationDialog(this, _("Generator done"),
+                    wxString::Format(_("Data generation completed successfully.\n\n%lu records inserted in %.1f seconds (%.0f records/s)."),
+                        (unsigned long)records, seconds,
+                        seconds > 0 ? records / seconds : 0.0),
+                    AdvancedMessageDialogButtonsOk());
+            }
         }
         catch (const FRError& e)
         {
@@ -1099,14 +952,16 @@ void DataGeneratorFrame::OnGenerateButtonClick(wxCommandEvent& WXUNUSED(event))
     }
 }
 
-bool DataGeneratorFrame::sortTables(std::list<Table *>& order)
+bool DataGeneratorFrame::sortTables(std::vector<std::list<Table *> >& levels)
 {
     // collect list of tables
     // if some table is dropped from the database, it would be
     // removed from tree, but it will remain in tableRecordsM
     // That's why we just search for existing tables that are
     // also present in tableRecordsM
-    std::list<TableDep *> deps;
+    const DependencyGraph& graph = databaseM->getDependencyGraph();
+    std::vector<Table *> tables;
+    std::vector<size_t> objects;
     TablesPtr t = databaseM->getTables();
     for (Tables::iterator it = t->begin(); it != t->end(); ++it)
     {
@@ -1114,735 +969,504 @@ bool DataGeneratorFrame::sortTables(std::list<Table *>& order)
             tableRecordsM.find((*it)->getQuotedName());
         if (i2 != tableRecordsM.end() && (*i2).second > 0)
         {
-            TableDep *td = new TableDep((*it).get(), tableRecordsM);
-            deps.push_back(td);
+            tables.push_back((*it).get());
+            objects.push_back(graph.findObject(0, (*it)->getName_()));
         }
     }
 
-    // Topological sorting:
-    // take out independent tables one by one and remove them from
-    // dependency lists of those depending on them
-    while (!deps.empty())
+    // Topological sorting by foreign keys:
+    // the tables of a level don't depend on each other, only on tables
+    // of earlier levels
+    std::vector<std::vector<size_t> > positions;
+    if (!graph.getLevels(objects, DependencyGraph::kForeignKey, positions))
     {
-        bool removed = false;
-        for (std::list<TableDep *>::iterator it = deps.begin();
-            it != deps.end(); ++it)
-        {
-            if ((*it)->dependsOn.size() != 0)   // has dependencies
-                continue;
-            order.push_back((*it)->table);
-            wxString tablename = (*it)->table->getQuotedName();
-            for (std::list<TableDep *>::iterator i2 = deps.begin();
-                i2 != deps.end(); ++i2)
-            {
-                (*i2)->remove(tablename);
-            }
-
-            delete (*it);
-            deps.erase(it);
-            removed = true;
-            break;
-        }
-
-        if (!removed)
-        {
-            showWarningDialog(this, _("Circular dependency"),
-                _("A circular dependency was detected among your tables. We are unable to determine to correct order of tables for insert. Currently, the only cure is to first generate data for just one of the tables."),
-                AdvancedMessageDialogButtonsOk());
-
-            // release memory
-            for (std::list<TableDep *>::iterator it = deps.begin();
-                it != deps.end(); ++it)
-            {
-                delete (*it);
-            }
-            return false;
-        }
+        showWarningDialog(this, _("Circular dependency"),
+            _("A circular dependency was detected among your tables. We are unable to determine to correct order of tables for insert. Currently, the only cure is to first generate data for just one of the tables."),
+            AdvancedMessageDialogButtonsOk());
+        return false;
+    }
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        std::list<Table *> level;
+        for (size_t j = 0; j < positions[i].size(); ++j)
+            level.push_back(tables[positions[i][j]]);
+        levels.push_back(level);
     }
     return true;
 }
 
-// range = comma separated list of values or ranges
-wxString getCharFromRange(const wxString& range, bool rnd, int recNo,
-    int charNo, int chars)
+// one table of a level, its rows are inserted by one of the worker threads
+struct TableJob
 {
-    wxString valueset;
-    size_t start = 0;
-    while (start < range.Length())
-    {
-        // last
-        wxString one = range.Mid(start);
-        size_t p = range.find(",", start);
-        if (p != wxString::npos)
-        {
-            one = range.Mid(start, p-start);
-            start = p + 1;
-        }
-        else
-            start = range.Length(); // exit on next loop
-        if (one.Length() == 1)
-            valueset += one;
-        else if (one.Length() == 2)     // range
-        {
-            for (wxChar c = one[0]; c <= one[1]; c++)
-                valueset += c;
-        }
-        else
-            throw FRError(_("Bad range: section length not 1 or 2: ") + one);
-    }
-
-    if (rnd)
-        return valueset.Mid(frRandom(valueset.Length()), 1);
-
-    // sequential: we support stuff like 001,002,003 or AAA,AAB,AAC
-    //             by converting the record counter to number with n-th base
-    //             where n is a number of characters in valueset
-    int base = valueset.Length();
-    int record = recNo;
-    for (int i=0; i<chars-charNo-1; i++)    // get the charNo-th digit
-        record /= base;
-    return valueset.Mid(record % base, 1);
-}
+    std::string sql;
+    int records;
+    unsigned seed;
+    DataRowGenerator generator;
+};
 
-void setFromFile(fr::IStatementPtr st, int param,
-    GeneratorSettings *gs, int recNo)
+// reads the lines of a value file once, instead of for every record
+std::vector<DataRowGenerator::Value> loadFileValues(GeneratorSettings* gs,
+    fr::ColumnType type, bool scaled, wxMBConv* conv)
 {
-    // load strings from file to vector
     wxFileInputStream stream(gs->fileName);
     if (!stream.Ok())
         throw FRError(_("Cannot open file: ")+gs->fileName);
     wxTextInputStream text(stream);
 
-    std::vector<wxString> values;
+    std::vector<DataRowGenerator::Value> values;
     while (true)
     {
         wxString s = text.ReadLine();
         if (s.IsEmpty())
             break;
-        values.push_back(s);
+        values.push_back(DataRowGenerator::parseValue(s, type, scaled, conv));
     }
-    if (values.empty())
-        return;
-
-    // select (random/sequential) string from vector
-    wxString selected;
-    if (gs->randomValues)
-        selected = values[frRandom(values.size())];
-    else
-        selected = values[recNo % values.size()];
-
-    // convert string to datatype
-    int mydate, mytime;
-    fr::ColumnType dt = st->getParameterType(param);
-    if (st->getParameterScale(param))
-        dt = fr::ColumnType::Double;
-    switch (dt)
-    {
-        case fr::ColumnType::Boolean:
-            st->setBool(param, (selected.Upper() == "TRUE" || selected == "1")); break;
-        case fr::ColumnType::Varchar:
-            st->setString(param, wx2std(selected));   break;
-        case fr::ColumnType::Integer:
-        {
-            long l;
-            if (!selected.ToLong(&l))
-                throw FRError(_("Invalid long numeric value: ")+selected);
-            st->setInt32(param, (int32_t)l);
-            break;
-        }
-        case fr::ColumnType::BigInt:
-        {
-            wxLongLong_t ll;
-            if (!selected.ToLongLong(&ll))
-                throw FRError(_("Invalid long long numeric value: ")+selected);
-            st->setInt64(param, (int64_t)ll);
-            break;
-        }
-        case fr::ColumnType::Float:
-        case fr::ColumnType::Double:
-        {
-            double d;
-            if (!selected.ToDouble(&d))
-                throw FRError(_("Invalid double value: ")+selected);
-            st->setDouble(param, d);
-            break;
-        }
-        case fr::ColumnType::Time:
-        case fr::ColumnType::TimeTz:
-            str2time(selected, mytime);
-            {
-                int h, m, s, t;
-                IBPP::ttoi(mytime, &h, &m, &s, &t);
-                st->setTime(param, h, m, s, t);
-            }
-            break;
-        case fr::ColumnType::Date:
-            str2date(selected, mydate);
-            {
-                int y, m, d;
-                IBPP::dtoi(mydate, &y, &m, &d);
-                st->setDate(param, y, m, d);
-            }
-            break;
-        case fr::ColumnType::Timestamp:
-        case fr::ColumnType::TimestampTz:
-        {
-            str2date(selected, mydate);
-            str2time(selected.Mid(11), mytime);
-            int y, mo, d, h, mi, s, t;
-            IBPP::dtoi(mydate, &y, &mo, &d);
-            IBPP::ttoi(mytime, &h, &mi, &s, &t);
-            st->setTimestamp(param, y, mo, d, h, mi, s, t);
-            break;
-        }
-        case fr::ColumnType::Blob:
-            throw FRError(_("Blob datatype not supported"));
-        default:
-            st->setString(param, wx2std(selected));
-            break;
-    };
+    return values;
 }
 
-void setFromOther(fr::IStatementPtr st, int param,
-    GeneratorSettings *gs, size_t recNo, Database* db)
+// reads the values of the column to copy from once, in the transaction
+// that sees the rows of the tables generated before
+std::vector<DataRowGenerator::Value> loadColumnValues(GeneratorSettings* gs,
+    fr::ColumnType type, bool scaled, int records, fr::IDatabasePtr db,
+    fr::ITransactionPtr tr, wxMBConv* conv)
 {
-    fr::IStatementPtr st2 =
-        st->getDatabase()->createStatement(st->getTransaction());
-
+    fr::IStatementPtr st = db->createStatement(tr);
     wxString sql = "SELECT " + gs->sourceColumn + " FROM "
         + gs->sourceTable + " WHERE " + gs->sourceColumn
         + " IS NOT NULL";
     if (!gs->randomValues)
         sql += " ORDER BY 1";
-    st2->prepare(wx2std(sql, db->getCharsetConverter()));
-    st2->execute();
-
-    // Since we need to store values and select one, and they can be of any type,
-    // we use a vector of strings or just fetch up to recNo.
-    // However, the original code used a vector of T.
-    // For simplicity, we'll fetch up to recNo + 1 or a maximum.
-    
-    int count = 0;
-    bool found = false;
-    while (st2->fetch())
-    {
-        if (gs->randomValues)
-        {
-             // For random we'd need all values. Let's just collect them as strings for now
-             // if we want to be truly generic, or we can handle specific types.
-        }
-        else if (count == (int)recNo)
-        {
-            found = true;
-            break;
-        }
-        count++;
-    }
+    st->prepare(wx2std(sql, conv));
+    st->execute();
 
-    if (!found && !gs->randomValues)
+    if (scaled)
+        type = fr::ColumnType::Double;
+    std::vector<DataRowGenerator::Value> values;
+    // only the first records are used if values aren't random
+    while ((gs->randomValues || (int)values.size() < records) && st->fetch())
     {
-        if (gs->nullPercent > 0)
+        DataRowGenerator::Value v;
+        switch (type)
         {
-            st->setNull(param);
-            return;
-        }
-        else
-            throw FRError(_("No records found in table: ") + gs->sourceTable);
-    }
-
-    // Now copy from st2 column 0 to st parameter param
-    fr::ColumnType t = st->getParameterType(param);
-    if (st2->isNull(0))
-        st->setNull(param);
-    else
-    {
-        switch (t)
-        {
-            case fr::ColumnType::Boolean: st->setBool(param, st2->getBool(0)); break;
-            case fr::ColumnType::Char:
-            case fr::ColumnType::Varchar: st->setString(param, st2->getString(0)); break;
-            case fr::ColumnType::Integer: st->setInt32(param, st2->getInt32(0)); break;
-            case fr::ColumnType::BigInt: st->setInt64(param, st2->getInt64(0)); break;
+            case fr::ColumnType::Boolean:
+                v.kind = DataRowGenerator::vkBool;
+                v.integer = st->getBool(0) ? 1 : 0;
+                break;
+            case fr::ColumnType::Integer:
+                v.kind = DataRowGenerator::vkInt32;
+                v.integer = st->getInt32(0);
+                break;
+            case fr::ColumnType::BigInt:
+                v.kind = DataRowGenerator::vkInt64;
+                v.integer = st->getInt64(0);
+                break;
             case fr::ColumnType::Float:
-            case fr::ColumnType::Double: st->setDouble(param, st2->getDouble(0)); break;
+            case fr::ColumnType::Double:
+                v.kind = DataRowGenerator::vkDouble;
+                v.real = st->getDouble(0);
+                break;
             case fr::ColumnType::Date:
             {
                 int y, m, d;
-                st2->getDate(0, y, m, d);
-                st->setDate(param, y, m, d);
+                st->getDate(0, y, m, d);
+                v.kind = DataRowGenerator::vkDate;
+                DataRowGenerator::setDate(v, y, m, d);
                 break;
             }
             case fr::ColumnType::Time:
             case fr::ColumnType::TimeTz:
             {
                 int h, m, s, f;
-                st2->getTime(0, h, m, s, f);
-                st->setTime(param, h, m, s, f);
+                st->getTime(0, h, m, s, f);
+                v.kind = DataRowGenerator::vkTime;
+                DataRowGenerator::setTime(v, h, m, s, f);
                 break;
             }
             case fr::ColumnType::Timestamp:
             case fr::ColumnType::TimestampTz:
             {
                 int y, mo, d, h, mi, s, f;
-                st2->getTimestamp(0, y, mo, d, h, mi, s, f);
-                st->setTimestamp(param, y, mo, d, h, mi, s, f);
+                st->getTimestamp(0, y, mo, d, h, mi, s, f);
+                v.kind = DataRowGenerator::vkTimestamp;
+                DataRowGenerator::setDate(v, y, mo, d);
+                DataRowGenerator::setTime(v, h, mi, s, f);
                 break;
             }
-            default: st->setString(param, st2->getString(0)); break;
+            default:
+                v.kind = DataRowGenerator::vkString;
+                v.text = st->getString(0);
+                break;
         }
+        values.push_back(v);
     }
-}
 
-// format for values:
-// number[value or range(s)]
-// example: 25[az,AZ,09] means: 25 letters or numbers
-// example: 10[a,x,5]       means: 10 chars, each either of 'a', 'x' or '5'
-void DataGeneratorFrame::setString(fr::IStatementPtr st, int param,
-    GeneratorSettings* gs, int recNo)
-{
-    if (gs->range.IsEmpty())
+    if ((values.empty() || (!gs->randomValues && (int)values.size() < records))
+        && gs->nullPercent <= 0)
     {
-        st->setString(param, "");
-        return;
+        throw FRError(_("No records found in table: ") + gs->sourceTable);
     }
-
-    // If mask does not contain brackets [], treat it as a literal string
-    if (gs->range.find("[") == wxString::npos)
-    {
-        st->setString(param, wx2std(gs->range, databaseM->getCharsetConverter()));
-        return;
-    }
-
-    wxString value;
-    long chars = 1;
-    size_t start = 0;
-    while (start < gs->range.Length())
-    {
-        if (gs->range.Mid(start, 1) == "[")
-        {
-            size_t p = gs->range.find("]", start+1);
-            if (p == wxString::npos)    // invalid mask
-                throw FRError(_("Invalid mask: missing ]"));
-            for (int i = 0; i < chars; i++)
-            {
-                value += getCharFromRange(gs->range.Mid(start+1,
-                    p-start-1), gs->randomValues, recNo, i, (int)chars);
-            }
-            start = p+1;
-            chars = 1;
-        }
-        else
-        {
-            size_t p = gs->range.find("[", start+1);
-            if (p == wxString::npos)    // invalid mask
-                throw FRError(_("Invalid mask, missing ["));
-            wxString number = gs->range.Mid(start, p-start);
-            if (!number.ToLong(&chars))
-                throw FRError(_("Bad number: ")+number);
-            start = p;
-        }
-    }
-    st->setString(param, wx2std(value, databaseM->getCharsetConverter()));
+    return values;
 }
 
-// gs->range = x,x-y,...
-template<typename T>
-void setNumber(fr::IStatementPtr st, int param, GeneratorSettings* gs, int recNo)
+void setParam(fr::IStatementPtr st, int param,
+    const DataRowGenerator::Value& value)
 {
-    std::vector< std::pair<long,long> > ranges;
-    long rangesize = 0;
-    size_t start = 0;
-    while (start < gs->range.Length())
+    int y, mo, d, h, mi, s, f;
+    switch (value.kind)
     {
-        // last
-        wxString one = gs->range.Mid(start);
-        size_t p = gs->range.find(",", start);
-        if (p != wxString::npos)
-        {
-            one = gs->range.Mid(start, p-start);
-            start = p + 1;
-        }
-        else
-            start = gs->range.Length(); // exit on next loop
-
-        one.Trim(true).Trim(false);
-        if (one.IsEmpty())
-            continue;
-
-        p = one.find("-");
-        if (p == wxString::npos)
-        {
-            long l;
-            if (!one.ToLong(&l))
-                throw FRError(_("Invalid number: ") + one);
-            ranges.push_back(std::pair<long,long>(l, l));
-            rangesize++;
-        }
-        else
-        {
-            long l1, l2;
-            if (!one.Mid(0, p).ToLong(&l1) || !one.Mid(p+1).ToLong(&l2))
-                throw FRError(_("Invalid range: ") + one);
-            ranges.push_back(std::pair<long,long>(l1, l2));
-            rangesize += (l2-l1+1);
-        }
-    }
-
-    if (ranges.empty() || rangesize <= 0)
-    {
-        if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
-            st->setDouble(param, 0.0);
-        else if constexpr (std::is_same_v<T, int64_t>)
-            st->setInt64(param, 0);
-        else
-            st->setInt32(param, 0);
-        return;
+        case DataRowGenerator::vkNull:
+            st->setNull(param);
+            break;
+        case DataRowGenerator::vkBool:
+            st->setBool(param, value.integer != 0);
+            break;
+        case DataRowGenerator::vkInt32:
+            st->setInt32(param, (int32_t)value.integer);
+            break;
+        case DataRowGenerator::vkInt64:
+            st->setInt64(param, value.integer);
+            break;
+        case DataRowGenerator::vkDouble:
+            st->setDouble(param, value.real);
+            break;
+        case DataRowGenerator::vkString:
+            st->setString(param, value.text);
+            break;
+        case DataRowGenerator::vkDate:
+            DataRowGenerator::getDate(value, y, mo, d);
+            st->setDate(param, y, mo, d);
+            break;
+        case DataRowGenerator::vkTime:
+            DataRowGenerator::getTime(value, h, mi, s, f);
+            st->setTime(param, h, mi, s, f);
+            break;
+        case DataRowGenerator::vkTimestamp:
+            DataRowGenerator::getDate(value, y, mo, d);
+            DataRowGenerator::getTime(value, h, mi, s, f);
+            st->setTimestamp(param, y, mo, d, h, mi, s, f);
+            break;
     }
+}
 
-    long toget = (gs->randomValues ?
-        frRandom(rangesize) : (recNo % rangesize));
-
-    for (std::vector< std::pair<long,long> >::iterator it =
-        ranges.begin(); it != ranges.end(); ++it)
+void setParam(fbcpp::StatementExt& st, unsigned param,
+    const DataRowGenerator::Value& value)
+{
+    int y, mo, d, h, mi, s, f;
+    switch (value.kind)
     {
-        long sz = (*it).second - (*it).first + 1;
-        if (sz > toget)
-        {
-            T val = (T)((*it).first + toget);
-            if constexpr (std::is_same_v<T, int16_t>) st->setInt32(param, val);
-            else if constexpr (std::is_same_v<T, int32_t>) st->setInt32(param, val);
-            else if constexpr (std::is_same_v<T, int64_t>) st->setInt64(param, val);
-            else if constexpr (std::is_same_v<T, float>) st->setDouble(param, val);
-            else if constexpr (std::is_same_v<T, double>) st->setDouble(param, val);
-            return;
-        }
-        toget -= sz;
+        case DataRowGenerator::vkNull:
+            st.setNull(param);
+            break;
+        case DataRowGenerator::vkBool:
+            st.setBool(param, value.integer != 0);
+            break;
+        case DataRowGenerator::vkInt32:
+            st.setInt32(param, (int32_t)value.integer);
+            break;
+        case DataRowGenerator::vkInt64:
+            st.setInt64(param, value.integer);
+            break;
+        case DataRowGenerator::vkDouble:
+            st.setDouble(param, value.real);
+            break;
+        case DataRowGenerator::vkString:
+            st.set(param, std::string_view(value.text));
+            break;
+        case DataRowGenerator::vkDate:
+            DataRowGenerator::getDate(value, y, mo, d);
+            st.setDate(param, std::chrono::year(y) / mo / d);
+            break;
+        case DataRowGenerator::vkTime:
+            DataRowGenerator::getTime(value, h, mi, s, f);
+            st.setTime(param, fbcpp::Time(std::chrono::hours(h)
+                + std::chrono::minutes(mi) + std::chrono::seconds(s)
+                + std::chrono::microseconds(f * 100)));
+            break;
+        case DataRowGenerator::vkTimestamp:
+            DataRowGenerator::getDate(value, y, mo, d);
+            DataRowGenerator::getTime(value, h, mi, s, f);
+            st.setTimestamp(param, fbcpp::Timestamp{ std::chrono::year(y) / mo / d,
+                fbcpp::Time(std::chrono::hours(h) + std::chrono::minutes(mi)
+                    + std::chrono::seconds(s) + std::chrono::microseconds(f * 100)) });
+            break;
     }
 }
 
-void setDatetime(fr::IStatementPtr st, int param, GeneratorSettings* gs,
-    int recNo)
+// runs on a worker thread, with a connection and transaction no other
+// thread uses meanwhile
+void insertRows(const TableJob& job, fr::IDatabasePtr db,
+    fr::ITransactionPtr tr, int batchRows, std::atomic<size_t>& inserted,
+    const std::atomic<bool>& cancel)
 {
-    std::vector< std::pair<int,int> > dateRanges;
-    std::vector< std::pair<int,int> > timeRanges;
-    int dateRangesize = 0;
-    int timeRangesize = 0;
-
-    fr::ColumnType dt = st->getParameterType(param);
-    size_t start = 0;
-    while (start < gs->range.Length())
-    {
-        // last
-        wxString one = gs->range.Mid(start);
-        size_t p = gs->range.find(",", start);
-        if (p != wxString::npos)
-        {
-            one = gs->range.Mid(start, p-start);
-            start = p + 1;
-        }
-        else
-            start = gs->range.Length(); // exit on next loop
+    DataRowGenerator::RandomEngine random(job.seed);
+    std::vector<DataRowGenerator::Value> row(job.generator.getColumnCount());
 
-        one.Trim(true).Trim(false);
-        if (one.IsEmpty())
-            continue;
-
-        // convert first value
-        int date = 0, time = 0;
-        if ((dt == fr::ColumnType::Date || dt == fr::ColumnType::Timestamp || dt == fr::ColumnType::TimestampTz))
-            str2date(one.Mid(0,10), date);
-        if (dt == fr::ColumnType::Time || dt == fr::ColumnType::TimeTz)
-            str2time(one.Mid(0,8), time);
-        if (dt == fr::ColumnType::Timestamp || dt == fr::ColumnType::TimestampTz)
-            str2time(one.Mid(11,8), time);
-
-        p = one.find("-");
-        if (p == wxString::npos)
-        {
-            if (dt == fr::ColumnType::Date || dt == fr::ColumnType::Timestamp || dt == fr::ColumnType::TimestampTz)
-            {
-                dateRanges.push_back(std::pair<int,int>(date, date));
-                dateRangesize++;
-            }
-            if (dt == fr::ColumnType::Time || dt == fr::ColumnType::TimeTz || dt == fr::ColumnType::Timestamp || dt == fr::ColumnType::TimestampTz)
-            {
-                timeRanges.push_back(std::pair<int,int>(time, time));
-                timeRangesize++;
-            }
-        }
-        else    // range, convert second date/time
+    if (db->getBackendType() != fr::DatabaseBackend::FbCpp)
+    {
+        fr::IStatementPtr st = db->createStatement(tr);
+        st->prepare(job.sql);
+        for (int i = 0; i < job.records && !cancel; ++i)
         {
-            int date2 = 0, time2 = 0;
-            if (dt == fr::ColumnType::Date)
-                str2date(one.Mid(11,10), date2);
-            if (dt == fr::ColumnType::Timestamp || dt == fr::ColumnType::TimestampTz)
-                str2date(one.Mid(20,10), date2);
-            if (dt == fr::ColumnType::Time || dt == fr::ColumnType::TimeTz)
-                str2time(one.Mid( 9, 8), time2);
-            if (dt == fr::ColumnType::Timestamp || dt == fr::ColumnType::TimestampTz)
-                str2time(one.Mid(31, 8), time2);
-
-            if (dt == fr::ColumnType::Date || dt == fr::ColumnType::Timestamp || dt == fr::ColumnType::TimestampTz)
-            {
-                dateRanges.push_back(std::pair<int,int>(date, date2));
-                dateRangesize += (date2-date+1);
-            }
-            if (dt == fr::ColumnType::Time || dt == fr::ColumnType::TimeTz || dt == fr::ColumnType::Timestamp || dt == fr::ColumnType::TimestampTz)
-            {
-                timeRanges.push_back(std::pair<int,int>(time, time2));
-                timeRangesize += ((time2-time) / 10000 + 1);
-            }
+            job.generator.generateRow(i, random, &row[0]);
+            for (size_t p = 0; p < row.size(); ++p)
+                setParam(st, (int)p, row[p]);
+            st->execute();
+            ++inserted;
         }
-    }
-
-    if (dateRanges.empty() && timeRanges.empty())
-    {
-        st->setNull(param);
         return;
     }
 
-    int dateToGet, timeToGet;
-    if (gs->randomValues)
+    // the rows are sent to the server batchRows at a time
+    fbcpp::Attachment& attachment =
+        static_cast<fr::FbCppDatabase*>(db.get())->getAttachment();
+    fbcpp::Transaction& transaction =
+        static_cast<fr::FbCppTransaction*>(tr.get())->getFbCppTransaction();
+    fbcpp::StatementExt stmt(attachment, transaction, job.sql,
+        fbcpp::StatementOptions());
+    for (int i = 0; i < job.records && !cancel; )
     {
-        dateToGet = (dateRangesize ? frRandom(dateRangesize) : 0);
-        timeToGet = (timeRangesize ? frRandom(timeRangesize) : 0);
-    }
-    else
-    {
-        dateToGet = (dateRangesize ? recNo % dateRangesize : 0);
-        timeToGet = (timeRangesize ? recNo % timeRangesize : 0);
-    }
+        fbcpp::BatchOptions batchOptions;
+        batchOptions.setMultiError(true);
+        fbcpp::Batch batch(stmt, transaction, batchOptions);
 
-    int myDate = 0;
-    int myTime = 0;
-    for (std::vector< std::pair<int,int> >::iterator it =
-        dateRanges.begin(); it != dateRanges.end(); ++it)
-    {
-        int sz = (*it).second - (*it).first + 1;
-        if (sz > dateToGet)
+        int last = std::min(job.records, i + batchRows);
+        int count = last - i;
+        for (; i < last; ++i)
         {
-            myDate = ((*it).first + dateToGet);
-            break;
+            job.generator.generateRow(i, random, &row[0]);
+            for (size_t p = 0; p < row.size(); ++p)
+                setParam(stmt, (unsigned)p, row[p]);
+            batch.addMessage();
         }
-        dateToGet -= sz;
-    }
-    for (std::vector< std::pair<int,int> >::iterator it =
-        timeRanges.begin(); it != timeRanges.end(); ++it)
-    {
-        int sz = ((*it).second - (*it).first)/10000 + 1;
-        if (sz > timeToGet)
+
+        auto completionState = batch.execute();
+        std::optional<unsigned> errPos = completionState.findError(0);
+        if (errPos.has_value())
         {
-            myTime = ((*it).first + timeToGet*10000);
-            break;
+            auto statusVec = completionState.getStatus(errPos.value());
+            throw fbcpp::DatabaseException(fr::FbCppDatabase::getClient(), statusVec.data());
         }
-        timeToGet -= sz;
-    }
-
-    if (dt == fr::ColumnType::Date)
-    {
-        int y, m, d;
-        IBPP::dtoi(myDate, &y, &m, &d);
-        st->setDate(param, y, m, d);
-    }
-    if (dt == fr::ColumnType::Time || dt == fr::ColumnType::TimeTz)
-    {
-        int h, m, s, t;
-        IBPP::ttoi(myTime, &h, &m, &s, &t);
-        st->setTime(param, h, m, s, t);
-    }
-    if (dt == fr::ColumnType::Timestamp || dt == fr::ColumnType::TimestampTz)
-    {
-        int y, mo, d, h, mi, s, t;
-        IBPP::dtoi(myDate, &y, &mo, &d);
-        IBPP::ttoi(myTime, &h, &mi, &s, &t);
-        st->setTimestamp(param, y, mo, d, h, mi, s, t);
+        inserted += count;
     }
 }
 
-void DataGeneratorFrame::setParam(fr::IStatementPtr st, int param,
-    GeneratorSettings* gs, int recNo)
+bool DataGeneratorFrame::generateData(
+    const std::vector<std::list<Table *> >& levels, size_t& records,
+    double& seconds)
 {
-    if (gs->nullPercent > frRandom(100))
-    {
-        st->setNull(param);
-        return;
-    }
-
-    if (gs->valueType == GeneratorSettings::vtColumn)   // copy from column
-    {
-        switch (st->getParameterType(param))
-        {
-            case fr::ColumnType::Boolean:
-                setFromOther(st, param, gs, recNo, databaseM);
-                break;
-            case fr::ColumnType::Char:
-            case fr::ColumnType::Varchar:
-                setFromOther(st, param, gs, recNo, databaseM);
-                break;
-            case fr::ColumnType::Integer:
-            case fr::ColumnType::Numeric:
-                setFromOther(st, param, gs, recNo, databaseM);
-                break;
-            case fr::ColumnType::BigInt:
-            case fr::ColumnType::Int128:
-                setFromOther(st, param, gs, recNo, databaseM);
-                break;
-            case fr::ColumnType::Float:
-                setFromOther(st, param, gs, recNo, databaseM);
-                break;
-            case fr::ColumnType::Double:
-            case fr::ColumnType::Decfloat16:
-            case fr::ColumnType::Decfloat34:
-                setFromOther(st, param, gs, recNo, databaseM);
-                break;
-            case fr::ColumnType::Date:
-                setFromOther(st, param, gs, recNo, databaseM);
-                break;
-            case fr::ColumnType::Time:
-            case fr::ColumnType::TimeTz:
-                setFromOther(st, param, gs, recNo, databaseM);
-                break;
-            case fr::ColumnType::Timestamp:
-            case fr::ColumnType::TimestampTz:
-                setFromOther(st, param, gs, recNo, databaseM);
-                break;
-            case fr::ColumnType::Blob:
-                throw FRError(_("Blob datatype not supported"));
-            default:
-                throw FRError(_("Datatype not supported"));
-        };
-        return;
-    }
+    auto startTime = std::chrono::steady_clock::now();
+    int batchRows = std::max(1, config().get("DataGeneratorBatchRows", 1000));
+    size_t connectionCount = (size_t)std::min(16, std::max(1,
+        config().get("DataGeneratorConnections", 1)));
 
-    if (gs->valueType == GeneratorSettings::vtRange)
+    size_t tableCount = 0, maxLevelSize = 0;
+    for (size_t l = 0; l < levels.size(); ++l)
     {
-        switch (st->getParameterType(param))
-        {
-            case fr::ColumnType::Boolean:
-            {
-                bool b = false;
-                if (gs->range.CmpNoCase("true") == 0 || gs->range == "1")
-                    b = true;
-                else if (gs->range.CmpNoCase("false") == 0 || gs->range == "0")
-                    b = false;
-                else
-                    b = gs->randomValues ? (frRandom(2) == 1) : ((recNo % 2) == 1);
-                st->setBool(param, b);
-                break;
-            }
-            case fr::ColumnType::Char:
-            case fr::ColumnType::Varchar:
-                setString(st, param, gs, recNo);          break;
-            case fr::ColumnType::Integer:
-                setNumber<int32_t>(st, param, gs, recNo); break;
-            case fr::ColumnType::BigInt:
-            case fr::ColumnType::Numeric:
-            case fr::ColumnType::Int128:
-                setNumber<int64_t>(st, param, gs, recNo); break;
-            case fr::ColumnType::Float:
-                setNumber<float>  (st, param, gs, recNo); break;
-            case fr::ColumnType::Double:
-            case fr::ColumnType::Decfloat16:
-            case fr::ColumnType::Decfloat34:
-                setNumber<double> (st, param, gs, recNo); break;
-            case fr::ColumnType::Date:
-            case fr::ColumnType::Time:
-            case fr::ColumnType::TimeTz:
-            case fr::ColumnType::Timestamp:
-            case fr::ColumnType::TimestampTz:
-                setDatetime(st, param, gs, recNo);
-                break;
-            case fr::ColumnType::Blob:
-                throw FRError(_("Blob datatype not supported"));
-            default:
-                st->setNull(param);
-        };
+        tableCount += levels[l].size();
+        maxLevelSize = std::max(maxLevelSize, levels[l].size());
     }
+    connectionCount = std::min(connectionCount, maxLevelSize);
 
-    if (gs->valueType == GeneratorSettings::vtFile)
-        setFromFile(st, param, gs, recNo);
-}
-
-void DataGeneratorFrame::generateData(std::list<Table *>& order)
-{
     ProgressDialog pd(0, _("Generating data"), 2);
     pd.doShow();
-    pd.initProgress(_("Inserting into tables"), (int)order.size());
-
-    // one big transaction (perhaps this should be configurable)
-    fr::ITransactionPtr tr = databaseM->getDALDatabase()->createTransaction();
-    tr->start();
+    pd.initProgress(_("Inserting into tables"), tableCount);
+
+    // the tables of a level don't depend on each other, so they can be
+    // filled on several attachments at the same time; everything is done
+    // in one big transaction if there is only one
+    wxMBConv* conv = databaseM->getCharsetConverter();
+    std::vector<fr::IDatabasePtr> connections;
+    std::vector<fr::ITransactionPtr> transactions;
+    connections.push_back(databaseM->getDALDatabase());
+    auto release = [&](bool commit)
+    {
+        for (size_t c = 0; c < transactions.size(); ++c)
+        {
+            if (commit)
+                transactions[c]->commit();
+            else
+                try { transactions[c]->rollback(); } catch (...) {}
+        }
+        for (size_t c = 1; c < connections.size(); ++c)
+            try { connections[c]->disconnect(); } catch (...) {}
+    };
 
+    records = 0;
     try
     {
-        for (std::list<Table *>::iterator it = order.begin();
-            it != order.end(); ++it)
+        while (connections.size() < connectionCount)
+            connections.push_back(databaseM->createDALConnection());
+        for (size_t c = 0; c < connections.size(); ++c)
+        {
+            transactions.push_back(connections[c]->createTransaction());
+            transactions.back()->start();
+        }
+
+        std::random_device seeds;
+        size_t tablesDone = 0;
+        for (size_t l = 0; l < levels.size(); ++l)
         {
-            pd.setProgressMessage((*it)->getName_(), 1);
-            pd.stepProgress();
-
-            std::map<wxString, int>::iterator i2 =
-                tableRecordsM.find((*it)->getQuotedName());
-            if (i2 == tableRecordsM.end())
-                continue;
-            int records = (*i2).second;
-            if (records <= 0)
-                continue;
-
-            pd.initProgress(wxString::Format(_("Inserting %d records."), records),
-                records, 0, 2);
-
-            // collect columns + create insert statement
-            wxString ins = "INSERT INTO " + (*it)->getQuotedName()
-                + " (";
-            wxString params(") VALUES (");
-            (*it)->ensureChildrenLoaded();
-            bool first = true;
-            std::vector<GeneratorSettings *> colSet;
-            for (ColumnPtrs::iterator col = (*it)->begin();
-                col != (*it)->end(); ++col)
+            // prepare the generators of all tables of the level, this
+            // also loads the values that are copied from other tables
+            std::vector<std::unique_ptr<TableJob> > jobs;
+            int levelRecords = 0;
+            for (std::list<Table *>::const_iterator it = levels[l].begin();
+                it != levels[l].end(); ++it)
             {
-                GeneratorSettings *gs = getSettings((*col).get());   // load or create
-                if (gs->valueType == GeneratorSettings::vtSkip)
+                pd.setProgressMessage((*it)->getName_(), 1);
+                std::map<wxString, int>::iterator i2 =
+                    tableRecordsM.find((*it)->getQuotedName());
+                if (i2 == tableRecordsM.end() || (*i2).second <= 0)
+                    continue;
+
+                // collect columns + create insert statement
+                wxString ins = "INSERT INTO " + (*it)->getQuotedName()
+                    + " (";
+                wxString params(") VALUES (");
+                (*it)->ensureChildrenLoaded();
+                bool first = true;
+                std::vector<GeneratorSettings *> colSet;
+                for (ColumnPtrs::iterator col = (*it)->begin();
+                    col != (*it)->end(); ++col)
+                {
+                    GeneratorSettings *gs = getSettings((*col).get());   // load or create
+                    if (gs->valueType == GeneratorSettings::vtSkip)
+                        continue;
+
+                    if (first)
+                        first = false;
+                    else
+                    {
+                        ins += ", ";
+                        params += ",";
+                    }
+                    ins += (*col)->getQuotedName();
+                    params += "?";
+                    colSet.push_back(gs);
+                }
+                if (first)  // no columns
                     continue;
 
-                if (first)
-                    first = false;
-                else
+                std::unique_ptr<TableJob> job(new TableJob);
+                job->sql = wx2std(ins + params + ")", conv);
+                job->records = (*i2).second;
+                job->seed = seeds();
+                fr::IStatementPtr st = connections[0]->createStatement(
+                    transactions[0]);
+                st->prepare(job->sql);
+                for (int p = 0; p < (int)colSet.size()
+                    && p < st->getParameterCount(); ++p)
                 {
-                    ins += ", ";
-                    params += ",";
+                    GeneratorSettings* gs = colSet[p];
+                    fr::ColumnType type = st->getParameterType(p);
+                    bool scaled = st->getParameterScale(p) != 0;
+                    std::vector<DataRowGenerator::Value> values;
+                    if (gs->valueType == GeneratorSettings::vtFile)
+                        values = loadFileValues(gs, type, scaled, conv);
+                    else if (gs->valueType == GeneratorSettings::vtColumn)
+                    {
+                        values = loadColumnValues(gs, type, scaled,
+                            job->records, connections[0], transactions[0],
+                            conv);
+                    }
+                    job->generator.addColumn(*gs, type, values, conv);
                 }
-                ins += (*col)->getQuotedName();
-                params += "?";
-                colSet.push_back(gs);
+                levelRecords += job->records;
+                jobs.push_back(std::move(job));
             }
-            if (first)  // no columns
-                continue;
 
-            fr::IStatementPtr st = databaseM->getDALDatabase()->createStatement(tr);
-            st->prepare(wx2std(ins + params + ")", databaseM->getCharsetConverter()));
+            if (jobs.size() > 1)
+            {
+                pd.setProgressMessage(wxString::Format(
+                    _("Inserting into %d tables"), (int)jobs.size()), 1);
+            }
+            pd.initProgress(wxString::Format(_("Inserting %d records."),
+                levelRecords), levelRecords, 0, 2);
+
+            // every worker inserts the rows of one table after the other
+            // on its own connection
+            std::atomic<size_t> nextJob(0), jobsDone(0), inserted(0);
+            std::atomic<size_t> finished(0);
+            std::atomic<bool> cancel(false);
+            std::exception_ptr error;
+            std::mutex errorMutex;
+            size_t threadCount = std::min(connections.size(), jobs.size());
+            std::vector<std::thread> workers;
+            for (size_t t = 0; t < threadCount; ++t)
+            {
+                workers.emplace_back([&, t]()
+                {
+                    try
+                    {
+                        for (size_t j = nextJob++; j < jobs.size() && !cancel;
+                            j = nextJob++)
+                        {
+                            insertRows(*jobs[j], connections[t],
+                                transactions[t], batchRows, inserted, cancel);
+                            ++jobsDone;
+                        }
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(errorMutex);
+                        if (!error)
+                            error = std::current_exception();
+                        cancel = true;
+                    }
+                    ++finished;
+                });
+            }
 
-            for (int i = 0; i < records; i++)
+            bool canceled = false;
+            while (finished < threadCount)
             {
                 if (pd.isCanceled())
                 {
-                    tr->rollback();
-                    return;
+                    canceled = true;
+                    cancel = true;
+                }
+                double elapsed = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - startTime).count();
+                pd.setProgressPosition(tablesDone + jobsDone, 1);
+                pd.setProgressMessage(wxString::Format(
+                    _("%lu records inserted (%.0f records/s)"),
+                    (unsigned long)(records + inserted),
+                    elapsed > 0 ? (records + inserted) / elapsed : 0.0), 2);
+                pd.setProgressPosition(inserted, 2);
+                wxMilliSleep(50);
+            }
+            for (size_t t = 0; t < workers.size(); ++t)
+                workers[t].join();
+            if (error)
+                std::rethrow_exception(error);
+            if (canceled)
+            {
+                release(false);
+                return false;
+            }
+            records += inserted;
+            tablesDone += levels[l].size();
+
+            // the tables of the next level reference these rows, and the
+            // other attachments only see them once they are committed
+            if (transactions.size() > 1 && l + 1 < levels.size())
+            {
+                for (size_t c = 0; c < transactions.size(); ++c)
+                {
+                    transactions[c]->commit();
+                    transactions[c]->start();
                 }
-                pd.stepProgress(1, 2);
-                for (int p = 0; p < (int)colSet.size() && p < st->getParameterCount(); ++p)
-                    setParam(st, p, colSet[p], i);
-                st->execute();
             }
         }
 
-        tr->commit();
+        release(true);
     }
     catch (...)
     {
-        try { tr->rollback(); } catch (...) {}
+        release(false);
         throw;
     }
+    seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - startTime).count();
+    return true;
 }
-
@@ -27,7 +27,9 @@
 #include <wx/spinctrl.h>
 #include <wx/splitter.h>
 
+#include <list>
 #include <map>
+#include <vector>
 
 #include "core/Observer.h"
 #include "core/StringUtils.h"
@@ -54,13 +56,12 @@ protected:
     void saveSetting(wxTreeItemId item);
     void loadSetting(wxTreeItemId newitem);
     bool loadColumns(const wxString& tableName, wxChoice* c);
-    bool sortTables(std::list<Table *>& order);
-    void generateData(std::list<Table *>& order);
-
-    void setParam(fr::IStatementPtr st, int param, GeneratorSettings* gs,
-        int recNo);
-    void setString(fr::IStatementPtr st, int param, GeneratorSettings* gs,
-        int recNo);
+    // groups the tables into levels, the tables of a level only depend
+    // on the tables of the levels before it
+    bool sortTables(std::vector<std::list<Table *> >& levels);
+    // returns false if it was cancelled
+    bool generateData(const std::vector<std::list<Table *> >& levels,
+        size_t& records, double& seconds);
 
     enum
     {
@@ -0,0 +1,689 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include "core/FRError.h"
+#include "core/StringUtils.h"
+#include "gui/DataRowGenerator.h"
+
+namespace IBPP
+{
+    const int MinDate = -693958;
+    const int MaxDate = 2958463;
+    const int Dec31_1899 = 693959;
+
+    inline bool dtoi(int date, int* y, int* m, int* d)
+    {
+        if (date < MinDate || date > MaxDate)
+            return false;
+
+        int RataDie = date + Dec31_1899;
+        int Z = RataDie + 306;
+        int H = 100 * Z - 25;
+        int A = H / 3652425;
+        int B = A - A / 4;
+        int year = (100 * B + H) / 36525;
+        int C = B + Z - 365 * year - year / 4;
+        int month = (5 * C + 456) / 153;
+        int day = C - (153 * month - 457) / 5;
+        if (month > 12) { year += 1; month -= 12; }
+
+        if (y != nullptr) *y = year;
+        if (m != nullptr) *m = month;
+        if (d != nullptr) *d = day;
+
+        return true;
+    }
+
+    inline bool itod(int* pdate, int year, int month, int day)
+    {
+        if (month < 1 || month > 12 || day < 1 || day > 31)
+            return false;
+
+        int y = year;
+        int m = month;
+        if (m <= 2) { y -= 1; m += 12; }
+
+        int RataDie = day + (153 * m - 457) / 5 + 365 * y + y / 4 - y / 100 + y / 400 - 306;
+        int date = RataDie - Dec31_1899;
+
+        if (date < MinDate || date > MaxDate)
+            return false;
+
+        if (pdate != nullptr) *pdate = date;
+        return true;
+    }
+
+    inline void ttoi(int itime, int* h, int* m, int* s, int* t)
+    {
+        int hh = itime / 36000000;   itime = itime - hh * 36000000;
+        int mm = itime / 600000;     itime = itime - mm * 600000;
+        int ss = itime / 10000;
+        int tt = itime - ss * 10000;
+
+        if (h != nullptr) *h = hh;
+        if (m != nullptr) *m = mm;
+        if (s != nullptr) *s = ss;
+        if (t != nullptr) *t = tt;
+    }
+
+    inline void itot(int* ptime, int hour, int minute, int second, int tenthousandths)
+    {
+        if (ptime != nullptr)
+            *ptime = hour * 36000000 + minute * 600000 + second * 10000 + tenthousandths;
+    }
+}
+
+namespace
+{
+
+// dd.mm.yyyy
+void str2date(const wxString& str, int& date)
+{
+    long d,m,y;
+    if (!str.Mid(0,2).ToLong(&d) || !str.Mid(3,2).ToLong(&m) ||
+        !str.Mid(6,4).ToLong(&y) || !IBPP::itod(&date, y,m,d))
+    {
+        throw FRError(_("Invalid date: ") + str);
+    }
+}
+
+// HH:MM:SS
+void str2time(const wxString& str, int& mytime)
+{
+    long h = 0, m = 0, s = 0;
+    if (!str.Mid(0, 2).ToLong(&h) || !str.Mid(3, 2).ToLong(&m)
+        || !str.Mid(6, 2).ToLong(&s))
+    {
+        throw FRError(_("Invalid time: ") + str);
+    }
+    IBPP::itot(&mytime, h, m, s, 0);
+}
+
+// splits a comma separated list of values or ranges
+std::vector<wxString> splitRange(const wxString& range)
+{
+    std::vector<wxString> parts;
+    size_t start = 0;
+    while (start < range.Length())
+    {
+        // last
+        wxString one = range.Mid(start);
+        size_t p = range.find(",", start);
+        if (p != wxString::npos)
+        {
+            one = range.Mid(start, p-start);
+            start = p + 1;
+        }
+        else
+            start = range.Length(); // exit on next loop
+        parts.push_back(one);
+    }
+    return parts;
+}
+
+bool isDate(fr::ColumnType type)
+{
+    return type == fr::ColumnType::Date || type == fr::ColumnType::Timestamp
+        || type == fr::ColumnType::TimestampTz;
+}
+
+bool isTime(fr::ColumnType type)
+{
+    return type == fr::ColumnType::Time || type == fr::ColumnType::TimeTz
+        || type == fr::ColumnType::Timestamp
+        || type == fr::ColumnType::TimestampTz;
+}
+
+bool isTimestamp(fr::ColumnType type)
+{
+    return type == fr::ColumnType::Timestamp
+        || type == fr::ColumnType::TimestampTz;
+}
+
+} // namespace
+
+GeneratorSettings::GeneratorSettings()
+    : valueType(vtRange), randomValues(true), nullPercent(0)
+{
+}
+
+GeneratorSettings::GeneratorSettings(GeneratorSettings* other)
+{
+    valueType = other->valueType;
+    range = other->range;
+    sourceTable = other->sourceTable;
+    sourceColumn = other->sourceColumn;
+    fileName = other->fileName;
+    randomValues = other->randomValues;
+    nullPercent = other->nullPercent;
+}
+
+DataRowGenerator::Value::Value()
+    : kind(vkNull), integer(0), time(0), real(0)
+{
+}
+
+DataRowGenerator::DataRowGenerator()
+{
+}
+
+DataRowGenerator::ValueKind DataRowGenerator::getKind(fr::ColumnType type)
+{
+    switch (type)
+    {
+        case fr::ColumnType::Boolean:
+            return vkBool;
+        case fr::ColumnType::Char:
+        case fr::ColumnType::Varchar:
+            return vkString;
+        case fr::ColumnType::Integer:
+            return vkInt32;
+        case fr::ColumnType::BigInt:
+        case fr::ColumnType::Numeric:
+        case fr::ColumnType::Int128:
+            return vkInt64;
+        case fr::ColumnType::Float:
+        case fr::ColumnType::Double:
+        case fr::ColumnType::Decfloat16:
+        case fr::ColumnType::Decfloat34:
+            return vkDouble;
+        case fr::ColumnType::Date:
+            return vkDate;
+        case fr::ColumnType::Time:
+        case fr::ColumnType::TimeTz:
+            return vkTime;
+        case fr::ColumnType::Timestamp:
+        case fr::ColumnType::TimestampTz:
+            return vkTimestamp;
+        default:
+            return vkNull;
+    }
+}
+
+// range = x,x-y,...
+void DataRowGenerator::parseNumbers(Column& column, const wxString& range)
+{
+    column.rangeSize = 0;
+    std::vector<wxString> parts(splitRange(range));
+    for (size_t i = 0; i < parts.size(); ++i)
+    {
+        wxString one(parts[i]);
+        one.Trim(true).Trim(false);
+        if (one.IsEmpty())
+            continue;
+
+        size_t p = one.find("-");
+        if (p == wxString::npos)
+        {
+            wxLongLong_t l;
+            if (!one.ToLongLong(&l))
+                throw FRError(_("Invalid number: ") + one);
+            column.ranges.push_back(std::make_pair(int64_t(l), int64_t(l)));
+            column.rangeSize++;
+        }
+        else
+        {
+            wxLongLong_t l1, l2;
+            if (!one.Mid(0, p).ToLongLong(&l1) || !one.Mid(p+1).ToLongLong(&l2))
+                throw FRError(_("Invalid range: ") + one);
+            column.ranges.push_back(std::make_pair(int64_t(l1), int64_t(l2)));
+            column.rangeSize += (l2-l1+1);
+        }
+    }
+}
+
+// range = date or time, or two of them separated by "-", ...
+void DataRowGenerator::parseDatetimes(Column& column, const wxString& range,
+    fr::ColumnType type)
+{
+    column.dateRangeSize = 0;
+    column.timeRangeSize = 0;
+    std::vector<wxString> parts(splitRange(range));
+    for (size_t i = 0; i < parts.size(); ++i)
+    {
+        wxString one(parts[i]);
+        one.Trim(true).Trim(false);
+        if (one.IsEmpty())
+            continue;
+
+        // convert first value
+        int date = 0, time = 0;
+        if (isDate(type))
+            str2date(one.Mid(0,10), date);
+        if (type == fr::ColumnType::Time || type == fr::ColumnType::TimeTz)
+            str2time(one.Mid(0,8), time);
+        if (isTimestamp(type))
+            str2time(one.Mid(11,8), time);
+
+        size_t p = one.find("-");
+        if (p == wxString::npos)
+        {
+            if (isDate(type))
+            {
+                column.dateRanges.push_back(std::make_pair(date, date));
+                column.dateRangeSize++;
+            }
+            if (isTime(type))
+            {
+                column.timeRanges.push_back(std::make_pair(time, time));
+                column.timeRangeSize++;
+            }
+        }
+        else    // range, convert second date/time
+        {
+            int date2 = 0, time2 = 0;
+            if (type == fr::ColumnType::Date)
+                str2date(one.Mid(11,10), date2);
+            if (isTimestamp(type))
+                str2date(one.Mid(20,10), date2);
+            if (type == fr::ColumnType::Time || type == fr::ColumnType::TimeTz)
+                str2time(one.Mid( 9, 8), time2);
+            if (isTimestamp(type))
+                str2time(one.Mid(31, 8), time2);
+
+            if (isDate(type))
+            {
+                column.dateRanges.push_back(std::make_pair(date, date2));
+                column.dateRangeSize += (date2-date+1);
+            }
+            if (isTime(type))
+            {
+                column.timeRanges.push_back(std::make_pair(time, time2));
+                column.timeRangeSize += ((time2-time) / 10000 + 1);
+            }
+        }
+    }
+}
+
+// format for values:
+// number[value or range(s)]
+// example: 25[az,AZ,09] means: 25 letters or numbers
+// example: 10[a,x,5]       means: 10 chars, each either of 'a', 'x' or '5'
+void DataRowGenerator::parseMask(Column& column, const wxString& range,
+    wxMBConv* conv)
+{
+    long chars = 1;
+    size_t start = 0;
+    while (start < range.Length())
+    {
+        if (range.Mid(start, 1) == "[")
+        {
+            size_t p = range.find("]", start+1);
+            if (p == wxString::npos)    // invalid mask
+                throw FRError(_("Invalid mask: missing ]"));
+
+            // the characters of the comma separated values or ranges
+            MaskPart part;
+            part.count = (int)chars;
+            std::vector<wxString> sets(splitRange(range.Mid(start+1, p-start-1)));
+            for (size_t i = 0; i < sets.size(); ++i)
+            {
+                const wxString& one = sets[i];
+                if (one.Length() == 1)
+                    part.characters.push_back(wx2std(one, conv));
+                else if (one.Length() == 2)     // range
+                {
+                    for (wxChar c = one[0]; c <= one[1]; c++)
+                        part.characters.push_back(wx2std(wxString(c), conv));
+                }
+                else
+                    throw FRError(_("Bad range: section length not 1 or 2: ") + one);
+            }
+            if (!part.characters.empty())
+                column.mask.push_back(part);
+            start = p+1;
+            chars = 1;
+        }
+        else
+        {
+            size_t p = range.find("[", start+1);
+            if (p == wxString::npos)    // invalid mask
+                throw FRError(_("Invalid mask, missing ["));
+            wxString number = range.Mid(start, p-start);
+            if (!number.ToLong(&chars))
+                throw FRError(_("Bad number: ")+number);
+            start = p;
+        }
+    }
+}
+
+void DataRowGenerator::addColumn(const GeneratorSettings& settings,
+    fr::ColumnType type, const std::vector<Value>& values, wxMBConv* conv)
+{
+    if (type == fr::ColumnType::Blob)
+        throw FRError(_("Blob datatype not supported"));
+
+    Column c;
+    c.kind = getKind(type);
+    c.source = srcConstant;
+    c.randomValues = settings.randomValues;
+    c.nullPercent = settings.nullPercent;
+    c.rangeSize = 0;
+    c.dateRangeSize = 0;
+    c.timeRangeSize = 0;
+    c.repeatValues = settings.valueType == GeneratorSettings::vtFile;
+
+    if (settings.valueType == GeneratorSettings::vtColumn
+        || settings.valueType == GeneratorSettings::vtFile)
+    {
+        if (settings.valueType == GeneratorSettings::vtColumn && c.kind == vkNull)
+            throw FRError(_("Datatype not supported"));
+        c.source = srcValues;
+        c.values = values;
+    }
+    else if (settings.valueType == GeneratorSettings::vtRange)
+    {
+        c.constant.kind = c.kind;
+        const wxString& range = settings.range;
+        switch (c.kind)
+        {
+            case vkBool:
+                if (range.CmpNoCase("true") == 0 || range == "1")
+                    c.constant.integer = 1;
+                else if (range.CmpNoCase("false") != 0 && range != "0")
+                    c.source = srcBool;
+                break;
+            case vkString:
+                // without brackets [] the mask is a literal string
+                if (range.find("[") == wxString::npos)
+                    c.constant.text = wx2std(range, conv);
+                else
+                {
+                    c.source = srcMask;
+                    parseMask(c, range, conv);
+                }
+                break;
+            case vkInt32:
+            case vkInt64:
+            case vkDouble:
+                parseNumbers(c, range);
+                if (!c.ranges.empty() && c.rangeSize > 0)
+                    c.source = srcNumber;
+                break;
+            case vkDate:
+            case vkTime:
+            case vkTimestamp:
+                parseDatetimes(c, range, type);
+                if (c.dateRanges.empty() && c.timeRanges.empty())
+                    c.constant.kind = vkNull;
+                else
+                    c.source = srcDatetime;
+                break;
+            default:
+                break;
+        }
+    }
+    else
+        c.constant.kind = vkNull;
+    columnsM.push_back(c);
+}
+
+size_t DataRowGenerator::getColumnCount() const
+{
+    return columnsM.size();
+}
+
+int64_t DataRowGenerator::random(RandomEngine& random, int64_t maxval)
+{
+    if (maxval <= 1)
+        return 0;
+    std::uniform_int_distribution<int64_t> distribution(0, maxval - 1);
+    return distribution(random);
+}
+
+void DataRowGenerator::generateValue(const Column& column, int recNo,
+    RandomEngine& engine, Value& value) const
+{
+    if (column.nullPercent > 0 && column.nullPercent > random(engine, 100))
+    {
+        value.kind = vkNull;
+        return;
+    }
+
+    switch (column.source)
+    {
+        case srcConstant:
+            value.kind = column.constant.kind;
+            value.integer = column.constant.integer;
+            value.real = 0;
+            value.text = column.constant.text;
+            break;
+        case srcBool:
+            value.kind = vkBool;
+            value.integer = column.randomValues ? random(engine, 2)
+                : (recNo % 2);
+            break;
+        case srcNumber:
+        {
+            int64_t toget = column.randomValues
+                ? random(engine, column.rangeSize) : (recNo % column.rangeSize);
+            for (size_t i = 0; i < column.ranges.size(); ++i)
+            {
+                int64_t sz = column.ranges[i].second - column.ranges[i].first + 1;
+                if (sz > toget)
+                {
+                    value.kind = column.kind;
+                    value.integer = column.ranges[i].first + toget;
+                    if (column.kind == vkDouble)
+                        value.real = double(value.integer);
+                    else if (column.kind == vkInt32)
+                        value.integer = int32_t(value.integer);
+                    break;
+                }
+                toget -= sz;
+            }
+            break;
+        }
+        case srcDatetime:
+        {
+            int dateToGet, timeToGet;
+            if (column.randomValues)
+            {
+                dateToGet = int(random(engine, column.dateRangeSize));
+                timeToGet = int(random(engine, column.timeRangeSize));
+            }
+            else
+            {
+                dateToGet = (column.dateRangeSize ? recNo % column.dateRangeSize : 0);
+                timeToGet = (column.timeRangeSize ? recNo % column.timeRangeSize : 0);
+            }
+
+            int myDate = 0, myTime = 0;
+            for (size_t i = 0; i < column.dateRanges.size(); ++i)
+            {
+                int sz = column.dateRanges[i].second - column.dateRanges[i].first + 1;
+                if (sz > dateToGet)
+                {
+                    myDate = column.dateRanges[i].first + dateToGet;
+                    break;
+                }
+                dateToGet -= sz;
+            }
+            for (size_t i = 0; i < column.timeRanges.size(); ++i)
+            {
+                int sz = (column.timeRanges[i].second - column.timeRanges[i].first)/10000 + 1;
+                if (sz > timeToGet)
+                {
+                    myTime = column.timeRanges[i].first + timeToGet*10000;
+                    break;
+                }
+                timeToGet -= sz;
+            }
+            value.kind = column.kind;
+            value.integer = myDate;
+            value.time = myTime;
+            break;
+        }
+        case srcMask:
+        {
+            // sequential: we support stuff like 001,002,003 or AAA,AAB,AAC
+            //             by converting the record counter to number with n-th base
+            //             where n is a number of characters in valueset
+            value.kind = vkString;
+            value.text.clear();
+            for (size_t p = 0; p < column.mask.size(); ++p)
+            {
+                const MaskPart& part = column.mask[p];
+                int base = (int)part.characters.size();
+                for (int i = 0; i < part.count; ++i)
+                {
+                    int index;
+                    if (column.randomValues)
+                        index = int(random(engine, base));
+                    else
+                    {
+                        int record = recNo;
+                        for (int j = 0; j < part.count - i - 1; j++)    // get the i-th digit
+                            record /= base;
+                        index = record % base;
+                    }
+                    value.text += part.characters[index];
+                }
+            }
+            break;
+        }
+        case srcValues:
+        {
+            size_t count = column.values.size();
+            size_t index;
+            if (column.randomValues)
+                index = size_t(random(engine, int64_t(count)));
+            else if (column.repeatValues && count)
+                index = recNo % count;
+            else
+                index = recNo;
+            if (index >= count)
+                value.kind = vkNull;
+            else
+                value = column.values[index];
+            break;
+        }
+    }
+}
+
+void DataRowGenerator::generateRow(int recNo, RandomEngine& random,
+    Value* row) const
+{
+    for (size_t i = 0; i < columnsM.size(); ++i)
+        generateValue(columnsM[i], recNo, random, row[i]);
+}
+
+DataRowGenerator::Value DataRowGenerator::parseValue(const wxString& text,
+    fr::ColumnType type, bool scaled, wxMBConv* conv)
+{
+    Value v;
+    int mydate, mytime;
+    if (scaled)
+        type = fr::ColumnType::Double;
+    switch (type)
+    {
+        case fr::ColumnType::Boolean:
+            v.kind = vkBool;
+            v.integer = (text.Upper() == "TRUE" || text == "1") ? 1 : 0;
+            break;
+        case fr::ColumnType::Integer:
+        {
+            long l;
+            if (!text.ToLong(&l))
+                throw FRError(_("Invalid long numeric value: ")+text);
+            v.kind = vkInt32;
+            v.integer = (int32_t)l;
+            break;
+        }
+        case fr::ColumnType::BigInt:
+        {
+            wxLongLong_t ll;
+            if (!text.ToLongLong(&ll))
+                throw FRError(_("Invalid long long numeric value: ")+text);
+            v.kind = vkInt64;
+            v.integer = (int64_t)ll;
+            break;
+        }
+        case fr::ColumnType::Float:
+        case fr::ColumnType::Double:
+            if (!text.ToDouble(&v.real))
+                throw FRError(_("Invalid double value: ")+text);
+            v.kind = vkDouble;
+            break;
+        case fr::ColumnType::Time:
+        case fr::ColumnType::TimeTz:
+            str2time(text, mytime);
+            v.kind = vkTime;
+            v.time = mytime;
+            break;
+        case fr::ColumnType::Date:
+            str2date(text, mydate);
+            v.kind = vkDate;
+            v.integer = mydate;
+            break;
+        case fr::ColumnType::Timestamp:
+        case fr::ColumnType::TimestampTz:
+            str2date(text, mydate);
+            str2time(text.Mid(11), mytime);
+            v.kind = vkTimestamp;
+            v.integer = mydate;
+            v.time = mytime;
+            break;
+        case fr::ColumnType::Blob:
+            throw FRError(_("Blob datatype not supported"));
+        default:
+            v.kind = vkString;
+            v.text = wx2std(text, conv);
+            break;
+    }
+    return v;
+}
+
+void DataRowGenerator::getDate(const Value& value, int& year, int& month,
+    int& day)
+{
+    IBPP::dtoi(int(value.integer), &year, &month, &day);
+}
+
+void DataRowGenerator::getTime(const Value& value, int& hour, int& minute,
+    int& second, int& fraction)
+{
+    IBPP::ttoi(value.time, &hour, &minute, &second, &fraction);
+}
+
+void DataRowGenerator::setDate(Value& value, int year, int month, int day)
+{
+    int date = 0;
+    IBPP::itod(&date, year, month, day);
+    value.integer = date;
+}
+
+void DataRowGenerator::setTime(Value& value, int hour, int minute,
+    int second, int fraction)
+{
+    IBPP::itot(&value.time, hour, minute, second, fraction);
+}
@@ -0,0 +1,151 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_DATAROWGENERATOR_H
+#define FR_DATAROWGENERATOR_H
+
+#include <wx/string.h>
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "engine/db/DatabaseBackend.h"
+
+class wxMBConv;
+class wxXmlNode;
+
+// GeneratorSettings class
+// How the data generator creates the values of one column.
+class GeneratorSettings
+{
+public:
+    typedef enum { vtSkip, vtRange, vtColumn, vtFile } ValueType;
+    ValueType valueType;
+    wxString range;
+    wxString sourceTable;
+    wxString sourceColumn;
+    wxString fileName;
+    bool randomValues;
+    int nullPercent;
+
+    GeneratorSettings();
+    GeneratorSettings(GeneratorSettings* other);
+    void toXML(wxXmlNode *parent);
+    wxString fromXML(wxXmlNode *parent);    // returns column name
+};
+
+// DataRowGenerator class
+// Generates the rows the data generator inserts into one table. The
+// settings of the columns are parsed and their strings converted to the
+// connection character set when the columns are added, so generating a
+// row neither parses nor converts anything and doesn't use the database.
+// Several threads can generate rows of the same generator, as long as each
+// of them has its own random engine.
+class DataRowGenerator
+{
+public:
+    enum ValueKind { vkNull, vkBool, vkInt32, vkInt64, vkDouble, vkString,
+        vkDate, vkTime, vkTimestamp };
+
+    // dates are day numbers and times 1/10000 seconds since midnight, as
+    // IBPP used to store them
+    struct Value
+    {
+        ValueKind kind;
+        int64_t integer;    // booleans, integers and dates
+        int time;
+        double real;
+        std::string text;
+
+        Value();
+    };
+    typedef std::mt19937 RandomEngine;
+private:
+    // the characters of one [...] part of a string mask, and how many of
+    // them are generated
+    struct MaskPart
+    {
+        int count;
+        std::vector<std::string> characters;
+    };
+    enum Source { srcConstant, srcBool, srcNumber, srcDatetime, srcMask,
+        srcValues };
+    struct Column
+    {
+        ValueKind kind;
+        Source source;
+        bool randomValues;
+        int nullPercent;
+        Value constant;
+        std::vector<std::pair<int64_t, int64_t> > ranges;
+        int64_t rangeSize;
+        std::vector<std::pair<int, int> > dateRanges;
+        std::vector<std::pair<int, int> > timeRanges;
+        int dateRangeSize;
+        int timeRangeSize;
+        std::vector<MaskPart> mask;
+        std::vector<Value> values;
+        bool repeatValues;  // file lines are repeated, column values not
+    };
+    std::vector<Column> columnsM;
+
+    static ValueKind getKind(fr::ColumnType type);
+    void parseNumbers(Column& column, const wxString& range);
+    void parseDatetimes(Column& column, const wxString& range,
+        fr::ColumnType type);
+    void parseMask(Column& column, const wxString& range, wxMBConv* conv);
+    void generateValue(const Column& column, int recNo, RandomEngine& random,
+        Value& value) const;
+public:
+    DataRowGenerator();
+
+    // adds a column of type that gets values by settings; values are the
+    // lines of the file or the values of the other column if settings use
+    // one, the first ones are used if values aren't random
+    void addColumn(const GeneratorSettings& settings, fr::ColumnType type,
+        const std::vector<Value>& values, wxMBConv* conv);
+    size_t getColumnCount() const;
+
+    // puts the values of the row with number recNo into row, which has
+    // space for getColumnCount() values
+    void generateRow(int recNo, RandomEngine& random, Value* row) const;
+
+    // converts a line of a value file to a column of type; scaled numbers
+    // are read as doubles
+    static Value parseValue(const wxString& text, fr::ColumnType type,
+        bool scaled, wxMBConv* conv);
+    static void getDate(const Value& value, int& year, int& month, int& day);
+    static void getTime(const Value& value, int& hour, int& minute,
+        int& second, int& fraction);
+    // set the date or time part of value, not its kind
+    static void setDate(Value& value, int year, int month, int day);
+    static void setTime(Value& value, int hour, int minute, int second,
+        int fraction);
+    // returns a value between 0 and maxval - 1
+    static int64_t random(RandomEngine& random, int64_t maxval);
+};
+
+#endif // FR_DATAROWGENERATOR_H
@@ -0,0 +1,237 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <iostream>
+#include <set>
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include "core/FRError.h"
+#include "gui/DataRowGenerator.h"
+
+namespace
+{
+
+bool check(bool condition, const char* testName)
+{
+    if (condition)
+    {
+        std::cout << "  PASSED: " << testName << "\n";
+        return true;
+    }
+    std::cout << "  FAILED: " << testName << "\n";
+    return false;
+}
+
+typedef DataRowGenerator::Value Value;
+
+GeneratorSettings makeSettings(const wxString& range, bool random,
+    int nullPercent = 0)
+{
+    GeneratorSettings gs;
+    gs.range = range;
+    gs.randomValues = random;
+    gs.nullPercent = nullPercent;
+    return gs;
+}
+
+void addColumn(DataRowGenerator& generator, const GeneratorSettings& gs,
+    fr::ColumnType type)
+{
+    generator.addColumn(gs, type, std::vector<Value>(), wxConvCurrent);
+}
+
+bool throws(const GeneratorSettings& gs, fr::ColumnType type)
+{
+    try
+    {
+        DataRowGenerator generator;
+        addColumn(generator, gs, type);
+    }
+    catch (FRError&)
+    {
+        return true;
+    }
+    return false;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = true;
+    std::cout << "Running DataRowGenerator Tests...\n";
+    DataRowGenerator::RandomEngine random(42);
+
+    // Test 1: sequential values count through ranges and masks
+    {
+        DataRowGenerator g;
+        addColumn(g, makeSettings("1-3,10", false), fr::ColumnType::Integer);
+        addColumn(g, makeSettings("2[AB]1[09]", false), fr::ColumnType::Varchar);
+        addColumn(g, makeSettings("", false), fr::ColumnType::Boolean);
+        addColumn(g, makeSettings("fixed", false), fr::ColumnType::Char);
+        Value row[4];
+        std::vector<int64_t> numbers;
+        std::vector<std::string> texts;
+        for (int i = 0; i < 5; ++i)
+        {
+            g.generateRow(i, random, row);
+            numbers.push_back(row[0].integer);
+            texts.push_back(row[1].text);
+        }
+        ok = check(g.getColumnCount() == 4 && row[0].kind == DataRowGenerator::vkInt32
+            && numbers[0] == 1 && numbers[2] == 3 && numbers[3] == 10
+            && numbers[4] == 1, "Sequential numbers") && ok;
+        // every part of the mask counts the records in its own base
+        ok = check(texts[0] == "AA0" && texts[1] == "AB1" && texts[2] == "BA2"
+            && texts[4] == "AA4", "Sequential mask") && ok;
+        g.generateRow(13, random, row);
+        ok = check(row[1].text == "AB3", "Sequential mask wraps around") && ok;
+        ok = check(row[2].kind == DataRowGenerator::vkBool && row[2].integer == 1
+            && row[3].text == "fixed", "Alternating boolean and literal string") && ok;
+    }
+
+    // Test 2: random values stay in range, nulls by percentage
+    {
+        DataRowGenerator g;
+        addColumn(g, makeSettings("100-199", true), fr::ColumnType::BigInt);
+        addColumn(g, makeSettings("5[az]", true), fr::ColumnType::Varchar);
+        addColumn(g, makeSettings("1", true, 50), fr::ColumnType::Integer);
+        Value row[3];
+        bool inRange = true;
+        int nulls = 0;
+        std::set<int64_t> distinct;
+        for (int i = 0; i < 10000; ++i)
+        {
+            g.generateRow(i, random, row);
+            inRange = inRange && row[0].integer >= 100 && row[0].integer <= 199
+                && row[1].text.size() == 5 && row[1].text[0] >= 'a'
+                && row[1].text[0] <= 'z';
+            distinct.insert(row[0].integer);
+            if (row[2].kind == DataRowGenerator::vkNull)
+                ++nulls;
+        }
+        ok = check(inRange && distinct.size() == 100, "Random values in range") && ok;
+        ok = check(nulls > 4000 && nulls < 6000, "Null percentage") && ok;
+    }
+
+    // Test 3: dates, times and values of files or other columns
+    {
+        DataRowGenerator g;
+        addColumn(g, makeSettings("30.12.2024-02.01.2025", false),
+            fr::ColumnType::Date);
+        addColumn(g, makeSettings("01.02.2025 10:00:00-01.02.2025 10:00:02",
+            false), fr::ColumnType::Timestamp);
+        GeneratorSettings file(makeSettings("", false));
+        file.valueType = GeneratorSettings::vtFile;
+        std::vector<Value> values;
+        values.push_back(DataRowGenerator::parseValue("7", fr::ColumnType::Integer,
+            false, wxConvCurrent));
+        values.push_back(DataRowGenerator::parseValue("8", fr::ColumnType::Integer,
+            false, wxConvCurrent));
+        g.addColumn(file, fr::ColumnType::Integer, values, wxConvCurrent);
+        GeneratorSettings other(file);
+        other.valueType = GeneratorSettings::vtColumn;
+        g.addColumn(other, fr::ColumnType::Integer, values, wxConvCurrent);
+
+        Value row[4];
+        int y, m, d, h, mi, s, f;
+        g.generateRow(3, random, row);
+        DataRowGenerator::getDate(row[0], y, m, d);
+        ok = check(y == 2025 && m == 1 && d == 2, "Sequential date") && ok;
+        DataRowGenerator::getDate(row[1], y, m, d);
+        DataRowGenerator::getTime(row[1], h, mi, s, f);
+        ok = check(row[1].kind == DataRowGenerator::vkTimestamp && y == 2025
+            && h == 10 && mi == 0 && s == 0, "Sequential timestamp") && ok;
+        ok = check(row[2].integer == 8 && row[3].kind == DataRowGenerator::vkNull,
+            "File values repeat, column values don't") && ok;
+
+        Value copied;
+        DataRowGenerator::setDate(copied, 2024, 2, 29);
+        DataRowGenerator::setTime(copied, 23, 59, 58, 1234);
+        DataRowGenerator::getDate(copied, y, m, d);
+        DataRowGenerator::getTime(copied, h, mi, s, f);
+        ok = check(y == 2024 && m == 2 && d == 29 && h == 23 && mi == 59
+            && s == 58 && f == 1234, "Dates and times of copied values") && ok;
+    }
+
+    // Test 4: settings are checked when the column is added
+    {
+        ok = check(throws(makeSettings("x[az]", false), fr::ColumnType::Varchar)
+            && throws(makeSettings("5[az", false), fr::ColumnType::Varchar)
+            && throws(makeSettings("1-x", false), fr::ColumnType::Integer)
+            && throws(makeSettings("32.13.2025", false), fr::ColumnType::Date)
+            && throws(makeSettings("", false), fr::ColumnType::Blob)
+            && !throws(makeSettings("", false), fr::ColumnType::Date),
+            "Invalid settings") && ok;
+        Value v = DataRowGenerator::parseValue("12.5", fr::ColumnType::BigInt,
+            true, wxConvCurrent);
+        ok = check(v.kind == DataRowGenerator::vkDouble && v.real == 12.5,
+            "Scaled values are doubles") && ok;
+    }
+
+    // Test 5: throughput of a table with ten columns
+    {
+        DataRowGenerator g;
+        for (int i = 0; i < 3; ++i)
+        {
+            addColumn(g, makeSettings("1-1000000", true), fr::ColumnType::Integer);
+            addColumn(g, makeSettings("20[az,AZ,09]", true), fr::ColumnType::Varchar);
+            addColumn(g, makeSettings("01.01.2000-31.12.2030", true, 10),
+                fr::ColumnType::Date);
+        }
+        addColumn(g, makeSettings("", true), fr::ColumnType::Boolean);
+        const int rows = 200000;
+        std::vector<Value> row(g.getColumnCount());
+        size_t total = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < rows; ++i)
+        {
+            g.generateRow(i, random, &row[0]);
+            total += row[1].text.size();
+        }
+        double ms = elapsedMs(start);
+        std::cout << "  INFO: " << rows << " rows of " << g.getColumnCount()
+                  << " columns generated in " << ms << " ms ("
+                  << int(rows / (ms / 1000)) << " rows/s)\n";
+        ok = check(total == size_t(rows) * 20, "Rows generated") && ok;
+    }
+
+    std::cout << "DataRowGenerator Tests completed: "
+              << (ok ? "ALL PASSED" : "SOME FAILED") << "\n";
+    return ok ? 0 : 1;
+}
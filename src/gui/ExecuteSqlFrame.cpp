@@ -56,6 +56,7 @@
 #include "gui/CommandManager.h"
 #include "gui/controls/ControlUtils.h"
 #include "gui/controls/DataGrid.h"
+#include "gui/controls/DataGridStreamingExport.h"
 #include "gui/controls/DataGridTable.h"
 #include "gui/GUIURIHandlerHelper.h"
 #include "gui/MetadataItemPropertiesFrame.h"
@@ -81,6 +82,7 @@
 #include "metadata/CharacterSet.h"
 #include "metadata/CreateDDLVisitor.h"
 #include "metadata/database.h"
+#include "metadata/DDLScriptWriter.h"
 #include "metadata/exception.h"
 #include "metadata/function.h"
 #include "metadata/generator.h"
@@ -97,11 +99,12 @@
 #include "sql/SqlStatement.h"
 #include "sql/StatementBuilder.h"
 #include "sql/SqlFormatter.h"
+#include "sql/SqlImportPipeline.h"
+#include "sql/SqlScriptReader.h"
 #include "statementHistory.h"
 
 #include "gui/FRStyle.h"
 
-static int CaseUnsensitiveCompare(const wxString& one, const wxString& two);
 
 class SqlEditorDropTarget : public wxDropTarget
 {
@@ -917,6 +920,8 @@ void ExecuteSqlFrame::buildMainMenu(CommandManager& cm)
         cm.getMainMenuItemText(_("Exec&ute from cursor"), Cmds::Query_Execute_from_cursor));
     statementMenu->Append(Cmds::Query_BatchImport,
         cm.getMainMenuItemText(_("Batch SQL &Import..."), Cmds::Query_BatchImport));
+    statementMenu->Append(Cmds::Query_ExecuteScriptFile,
+        cm.getMainMenuItemText(_("Execute Script &File..."), Cmds::Query_ExecuteScriptFile));
     statementMenu->AppendSeparator();
 
     wxMenu* stmtPropMenu = new wxMenu();
@@ -970,6 +975,7 @@ void ExecuteSqlFrame::buildMainMenu(CommandManager& cm)
     gridMenu->Append(Cmds::DataGrid_Save_as_csv,     _("Save as cs&v"));
     gridMenu->Append(Cmds::DataGrid_Save_as_json,    _("Save as &json"));
     gridMenu->Append(Cmds::DataGrid_Save_as_excel,   _("Save as &excel"));
+    gridMenu->Append(Cmds::DataGrid_Export_all,      _("Export &all records..."));
     gridMenu->AppendSeparator();
     gridMenu->AppendCheckItem(Cmds::DataGrid_Log_changes, _("&Log data changes"));
     menuBarM->Append(gridMenu, _("&Grid"));
@@ -1174,6 +1180,7 @@ BEGIN_EVENT_TABLE(ExecuteSqlFrame, wxFrame)
     EVT_MENU(Cmds::Query_Execute_from_cursor, ExecuteSqlFrame::OnMenuExecuteFromCursor)
     EVT_MENU(Cmds::Query_Format,              ExecuteSqlFrame::OnMenuFormatSql)
     EVT_MENU(Cmds::Query_BatchImport,         ExecuteSqlFrame::OnMenuBatchImport)
+    EVT_MENU(Cmds::Query_ExecuteScriptFile,   ExecuteSqlFrame::OnMenuExecuteScriptFile)
 
     EVT_UPDATE_UI(Cmds::Query_Execute,             ExecuteSqlFrame::OnMenuUpdateWhenExecutePossible)
     EVT_UPDATE_UI(Cmds::Query_Execute_and_Fetch_All, ExecuteSqlFrame::OnMenuUpdateWhenExecutePossible)
@@ -1182,6 +1189,7 @@ BEGIN_EVENT_TABLE(ExecuteSqlFrame, wxFrame)
     EVT_UPDATE_UI(Cmds::Query_Execute_selection,   ExecuteSqlFrame::OnMenuUpdateWhenExecutePossible)
     EVT_UPDATE_UI(Cmds::Query_Execute_from_cursor, ExecuteSqlFrame::OnMenuUpdateWhenExecutePossible)
     EVT_UPDATE_UI(Cmds::Query_BatchImport,         ExecuteSqlFrame::OnMenuUpdateWhenExecutePossible)
+    EVT_UPDATE_UI(Cmds::Query_ExecuteScriptFile,   ExecuteSqlFrame::OnMenuUpdateWhenExecutePossible)
     EVT_MENU(Cmds::Query_Commit,              ExecuteSqlFrame::OnMenuCommit)
     EVT_MENU(Cmds::Query_Rollback,            ExecuteSqlFrame::OnMenuRollback)
     EVT_UPDATE_UI(Cmds::Query_Commit,         ExecuteSqlFrame::OnMenuUpdateWhenInTransaction)
@@ -1210,6 +1218,7 @@ BEGIN_EVENT_TABLE(ExecuteSqlFrame, wxFrame)
     EVT_MENU(Cmds::DataGrid_Save_as_json,    ExecuteSqlFrame::OnMenuGridSaveAsJson)
     EVT_MENU(Cmds::DataGrid_Save_as_excel,   ExecuteSqlFrame::OnMenuGridSaveAsExcel)
     EVT_MENU(Cmds::DataGrid_Save_as_markdown,ExecuteSqlFrame::OnMenuGridSaveAsMarkdown)
+    EVT_MENU(Cmds::DataGrid_Export_all,      ExecuteSqlFrame::OnMenuGridExportAll)
     EVT_MENU(Cmds::DataGrid_FetchAll,        ExecuteSqlFrame::OnMenuGridFetchAll)
     EVT_MENU(Cmds::DataGrid_CancelFetchAll,  ExecuteSqlFrame::OnMenuGridCancelFetchAll)
     EVT_MENU(Cmds::DataGrid_AutofitColumns,  ExecuteSqlFrame::OnMenuGridAutofitColumns)
@@ -1232,6 +1241,7 @@ BEGIN_EVENT_TABLE(ExecuteSqlFrame, wxFrame)
     EVT_UPDATE_UI(Cmds::DataGrid_Save_as_json,   ExecuteSqlFrame::OnMenuUpdateGridHasSelection)
     EVT_UPDATE_UI(Cmds::DataGrid_Save_as_excel,  ExecuteSqlFrame::OnMenuUpdateGridHasSelection)
     EVT_UPDATE_UI(Cmds::DataGrid_Save_as_markdown,ExecuteSqlFrame::OnMenuUpdateGridHasSelection)
+    EVT_UPDATE_UI(Cmds::DataGrid_Export_all,     ExecuteSqlFrame::OnMenuUpdateGridExportAll)
     EVT_UPDATE_UI(Cmds::DataGrid_FetchAll,       ExecuteSqlFrame::OnMenuUpdateGridFetchAll)
     EVT_UPDATE_UI(Cmds::DataGrid_CancelFetchAll, ExecuteSqlFrame::OnMenuUpdateGridCancelFetchAll)
 
@@ -1491,39 +1501,43 @@ void ExecuteSqlFrame::autoComplete(bool force)
 
     if (start != -1 && pos - start >= autoCompleteChars)
     {
-        IncompleteStatement is(databaseM, styled_text_ctrl_sql->GetText());
-        wxString queryCols = is.getObjectColumns("", pos, true);
-        wxArrayString as;
-        wxStringTokenizer tkz1(queryCols, " ");
-        while (tkz1.HasMoreTokens())
-            as.Add(tkz1.GetNextToken());
-        wxStringTokenizer tkz2(keywordsM, " ");
-        while (tkz2.HasMoreTokens())
-            as.Add(tkz2.GetNextToken());
-
-        as.Sort(CaseUnsensitiveCompare);
-
-        wxString combinedList;
-        wxString lastWordUpper;
-        for (size_t i = 0; i < as.GetCount(); ++i)
-        {
-            wxString currentUpper = as.Item(i).Upper();
-            if (currentUpper != lastWordUpper)
-            {
-                combinedList += as.Item(i) + " ";
-                lastWordUpper = currentUpper;
-            }
-        }
-        if (!combinedList.IsEmpty())
-            combinedList.RemoveLast();
+        std::vector<const AutoCompleteIndex*> indices;
+        indices.push_back(&getQueryColumns(start, pos));
+        indices.push_back(&keywordIndexM);
+        indices.push_back(&objectNamesM.getIndex());
+        wxString combinedList = AutoCompleteIndex::getCompletionList(
+            styled_text_ctrl_sql->GetTextRange(start, pos), indices);
 
         // GTK version crashes if nothing matches, so this check must be made for GTK
         // For MSW, it doesn't crash but it flashes on the screen (also not very nice)
-        if (HasWord(styled_text_ctrl_sql->GetTextRange(start, pos), combinedList))
+        if (!combinedList.IsEmpty())
             styled_text_ctrl_sql->AutoCompShow(pos-start, combinedList);
     }
 }
 
+//! returns the columns of the relations used in the statement at pos
+const AutoCompleteIndex& ExecuteSqlFrame::getQueryColumns(int start, int pos)
+{
+    // the columns don't depend on the word that is being typed, so they
+    // are only searched again when the rest of the text has changed
+    wxString key = wxString::Format("%d:", start)
+        + styled_text_ctrl_sql->GetTextRange(0, start)
+        + styled_text_ctrl_sql->GetTextRange(pos,
+            styled_text_ctrl_sql->GetLength());
+    if (key != queryColumnsKeyM)
+    {
+        IncompleteStatement is(databaseM, styled_text_ctrl_sql->GetText());
+        wxString queryCols = is.getObjectColumns("", pos, false);
+        wxArrayString columns;
+        wxStringTokenizer tkz(queryCols, " ");
+        while (tkz.HasMoreTokens())
+            columns.Add(tkz.GetNextToken());
+        queryColumnsM.setWords(columns);
+        queryColumnsKeyM = key;
+    }
+    return queryColumnsM;
+}
+
 void ExecuteSqlFrame::OnMenuFindSelectedObject(wxCommandEvent& WXUNUSED(event))
 {
     wxString sel = styled_text_ctrl_sql->GetSelectedText();
@@ -1948,121 +1962,14 @@ void ExecuteSqlFrame::OnMenuExplain(wxCommandEvent& WXUNUSED(event))
     execute("EXPLAIN (FORMAT TREE) " + sql, ";");
 }
 
-namespace {
-struct ParsedInsert
-{
-    bool isValid = false;
-    wxString tableName;
-    wxArrayString columns;
-    wxArrayString values;
-    std::vector<SqlTokenType> valueTypes;
-};
-
-ParsedInsert parseInsertStatement(const wxString& sql)
-{
-    ParsedInsert pi;
-    SqlTokenizer tokenizer(sql);
-    
-    if (tokenizer.getCurrentToken() != kwINSERT)
-        return pi;
-    if (!tokenizer.jumpToken(false)) return pi;
-    
-    if (tokenizer.getCurrentToken() != kwINTO)
-        return pi;
-    if (!tokenizer.jumpToken(false)) return pi;
-    
-    if (tokenizer.getCurrentToken() != tkIDENTIFIER && !tokenizer.isKeywordToken())
-        return pi;
-    pi.tableName = tokenizer.getCurrentTokenString();
-    if (!tokenizer.jumpToken(false)) return pi;
-    
-    if (tokenizer.getCurrentToken() == tkPARENOPEN)
-    {
-        if (!tokenizer.jumpToken(false)) return pi;
-        while (true)
-        {
-            if (tokenizer.getCurrentToken() != tkIDENTIFIER && !tokenizer.isKeywordToken())
-                return pi;
-            pi.columns.Add(tokenizer.getCurrentTokenString());
-            if (!tokenizer.jumpToken(false)) return pi;
-            
-            if (tokenizer.getCurrentToken() == tkPARENCLOSE)
-            {
-                if (!tokenizer.jumpToken(false)) return pi;
-                break;
-            }
-            if (tokenizer.getCurrentToken() == tkCOMMA)
-            {
-                if (!tokenizer.jumpToken(false)) return pi;
-                continue;
-            }
-            return pi;
-        }
-    }
-    
-    if (tokenizer.getCurrentToken() != kwVALUES)
-        return pi;
-    if (!tokenizer.jumpToken(false)) return pi;
-    
-    if (tokenizer.getCurrentToken() != tkPARENOPEN)
-        return pi;
-    if (!tokenizer.jumpToken(false)) return pi;
-    
-    while (true)
-    {
-        SqlTokenType tType = tokenizer.getCurrentToken();
-        wxString tStr = tokenizer.getCurrentTokenString();
-        
-        if (tStr == "-" || tStr == "+")
-        {
-            if (!tokenizer.jumpToken(false)) return pi;
-            tStr += tokenizer.getCurrentTokenString();
-            tType = tkIDENTIFIER;
-        }
-        
-        pi.values.Add(tStr);
-        pi.valueTypes.push_back(tType);
-        if (!tokenizer.jumpToken(false)) return pi;
-        
-        if (tokenizer.getCurrentToken() == tkPARENCLOSE)
-        {
-            break;
-        }
-        if (tokenizer.getCurrentToken() == tkCOMMA)
-        {
-            if (!tokenizer.jumpToken(false)) return pi;
-            continue;
-        }
-        return pi;
-    }
-    
-    pi.isValid = true;
-    return pi;
-}
-
-std::string unescapeSqlString(const std::string& s)
+void ExecuteSqlFrame::OnMenuExecuteScriptFile(wxCommandEvent& WXUNUSED(event))
 {
-    if (s.size() >= 2 && s.front() == '\'' && s.back() == '\'')
-    {
-        std::string res;
-        res.reserve(s.size() - 2);
-        for (size_t i = 1; i < s.size() - 1; ++i)
-        {
-            if (s[i] == '\'' && i + 1 < s.size() - 1 && s[i+1] == '\'')
-            {
-                res.push_back('\'');
-                ++i;
-            }
-            else
-            {
-                res.push_back(s[i]);
-            }
-        }
-        return res;
-    }
-    return s;
+    wxFileDialog fd(this, _("Select SQL Script to Execute"), wxEmptyString,
+        wxEmptyString, _("SQL files (*.sql)|*.sql|All files (*.*)|*.*"),
+        wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+    if (fd.ShowModal() == wxID_OK)
+        executeScriptFile(fd.GetPath());
 }
-} // namespace
 
 void ExecuteSqlFrame::OnMenuBatchImport(wxCommandEvent& WXUNUSED(event))
 {
@@ -2084,45 +1991,50 @@ void ExecuteSqlFrame::OnMenuBatchImport(wxCommandEvent& WXUNUSED(event))
 
     wxString filePath = fd.GetPath();
 
-    wxFile file;
-    if (!file.Open(filePath))
-    {
-        wxMessageBox(_("Failed to open the selected file."), _("Error"), wxOK | wxICON_ERROR, this);
-        return;
+    // an import that was aborted can be continued after its last commit
+    wxFileOffset startOffset = 0;
+    wxString terminator(";");
+    bool utf8 = true;
+    wxLongLong_t restartOffset = 0;
+    if (config().get("BatchImportRestartFile", wxString()) == filePath
+        && config().get("BatchImportRestartDatabase", wxString())
+            == databaseM->getConnectionString()
+        && config().get("BatchImportRestartOffset", wxString()).ToLongLong(&restartOffset)
+        && restartOffset > 0)
+    {
+        int answer = wxMessageBox(wxString::Format(
+            _("A previous import of this file was aborted. The statements up to byte %s have been committed.\n\nDo you want to continue the import from there?"),
+            wxString::Format("%lld", (long long)restartOffset)),
+            _("Batch SQL Import"), wxYES_NO | wxCANCEL | wxICON_QUESTION, this);
+        if (answer == wxCANCEL)
+            return;
+        if (answer == wxYES)
+        {
+            startOffset = restartOffset;
+            terminator = config().get("BatchImportRestartTerminator", terminator);
+            // the encoding is only detected at the start of the file
+            utf8 = config().get("BatchImportRestartUtf8", true);
+        }
     }
 
-    wxString fileContent;
-    if (!file.ReadAll(&fileContent))
+    size_t batchRows = std::max(1, config().get("BatchImportBatchRows", 5000));
+    size_t commitRows = std::max(0, config().get("BatchImportCommitRows", 50000));
+    wxFileOffset commitBytes = wxFileOffset(std::max(0,
+        config().get("BatchImportCommitMB", 64))) * 1024 * 1024;
+
+    // the script is read and parsed on a worker thread while this thread
+    // executes the statements
+    SqlImportPipeline pipeline(databaseM->getCharsetConverter(), batchRows);
+    if (!pipeline.open(filePath, startOffset, terminator, utf8))
     {
-        wxMessageBox(_("Failed to read the file content."), _("Error"), wxOK | wxICON_ERROR, this);
+        wxMessageBox(_("Failed to open the selected file."), _("Error"), wxOK | wxICON_ERROR, this);
         return;
     }
-    file.Close();
+    pipeline.start();
 
     ProgressDialog pd(this, _("Batch SQL Import"), 1);
     pd.doShow();
-    pd.initProgressIndeterminate(_("Parsing SQL file..."));
-    wxYield();
-
-    MultiStatement ms(fileContent);
-    std::vector<wxString> statements;
-    while (true)
-    {
-        SingleStatement ss = ms.getNextStatement();
-        if (!ss.isValid())
-            break;
-        if (!ss.isEmptyStatement())
-            statements.push_back(ss.getSql());
-    }
-
-    if (statements.empty())
-    {
-        wxMessageBox(_("The selected file contains no SQL statements."), _("Information"), wxOK | wxICON_INFORMATION, this);
-        return;
-    }
-
-    pd.initProgress(_("Importing statements..."), statements.size(), 0);
-    wxYield();
+    pd.initProgress(_("Importing statements..."), 1000, 0);
 
     fr::FbCppDatabase* dbExt = static_cast<fr::FbCppDatabase*>(databaseM->getDALDatabase().get());
     fbcpp::Attachment& attachment = dbExt->getAttachment();
@@ -2132,83 +2044,67 @@ void ExecuteSqlFrame::OnMenuBatchImport(wxCommandEvent& WXUNUSED(event))
     if (!transactionM->isActive())
         transactionM->start();
 
-    fr::FbCppTransaction* trExt = static_cast<fr::FbCppTransaction*>(transactionM.get());
-    fbcpp::Transaction& transaction = trExt->getFbCppTransaction();
-
-    size_t stmtIndex = 0;
     size_t totalInserted = 0;
     size_t totalIndividual = 0;
-    
-    struct BatchGroup {
-        wxString prepSql;
-        wxString tableName;
-        wxArrayString columns;
-        std::vector<std::vector<wxString>> rowsValues;
-        std::vector<std::vector<SqlTokenType>> rowsValueTypes;
-    } currentGroup;
+    size_t rowsSinceCommit = 0;
+    wxFileOffset bytesSinceCommit = 0;
+    wxFileOffset committedOffset = startOffset;
+    wxFileOffset length = pipeline.getLength();
+    wxString errorMsg;
 
-    auto executeCurrentGroup = [&]() -> bool {
-        if (currentGroup.rowsValues.empty())
-            return true;
+    auto executeBatch = [&](const SqlImportGroup& group) {
+        fr::FbCppTransaction* trExt = static_cast<fr::FbCppTransaction*>(transactionM.get());
+        fbcpp::Transaction& transaction = trExt->getFbCppTransaction();
 
-        try
-        {
-            fbcpp::StatementOptions options;
-            fbcpp::StatementExt stmt(attachment, transaction, wx2std(currentGroup.prepSql, databaseM->getCharsetConverter()), options);
+        fbcpp::StatementOptions options;
+        fbcpp::StatementExt stmt(attachment, transaction, wx2std(group.sql, databaseM->getCharsetConverter()), options);
 
-            fbcpp::BatchOptions batchOptions;
-            batchOptions.setMultiError(true);
-            fbcpp::Batch batch(stmt, transaction, batchOptions);
+        fbcpp::BatchOptions batchOptions;
+        batchOptions.setMultiError(true);
+        fbcpp::Batch batch(stmt, transaction, batchOptions);
 
-            for (size_t r = 0; r < currentGroup.rowsValues.size(); ++r)
-            {
-                const auto& vals = currentGroup.rowsValues[r];
-                const auto& types = currentGroup.rowsValueTypes[r];
-
-                for (size_t c = 0; c < vals.size(); ++c)
-                {
-                    if (types[c] == kwNULL)
-                    {
-                        stmt.setNull((unsigned)c);
-                    }
-                    else if (types[c] == tkSTRING)
-                    {
-                        std::string unescaped = unescapeSqlString(wx2std(vals[c], databaseM->getCharsetConverter()));
-                        stmt.set((unsigned)c, unescaped);
-                    }
-                    else
-                    {
-                        std::string rawVal = wx2std(vals[c], databaseM->getCharsetConverter());
-                        stmt.set((unsigned)c, rawVal);
-                    }
-                }
-                batch.addMessage();
-            }
-
-            auto completionState = batch.execute();
-            std::optional<unsigned> errPos = completionState.findError(0);
-            if (errPos.has_value())
+        size_t index = 0;
+        for (size_t r = 0; r < group.getRowCount(); ++r)
+        {
+            for (size_t c = 0; c < group.columnCount; ++c, ++index)
             {
-                auto statusVec = completionState.getStatus(errPos.value());
-                throw fbcpp::DatabaseException(fr::FbCppDatabase::getClient(), statusVec.data());
+                if (group.nulls[index])
+                    stmt.setNull((unsigned)c);
+                else
+                    stmt.set((unsigned)c, group.values[index]);
             }
-
-            totalInserted += currentGroup.rowsValues.size();
-            currentGroup.rowsValues.clear();
-            currentGroup.rowsValueTypes.clear();
-            return true;
+            batch.addMessage();
         }
-        catch (const std::exception& e)
+
+        auto completionState = batch.execute();
+        std::optional<unsigned> errPos = completionState.findError(0);
+        if (errPos.has_value())
         {
-            wxString errMsg = wxString::FromUTF8(e.what());
-            wxMessageBox(wxString::Format(_("Batch execution failed:\n%s"), errMsg),
-                _("Error"), wxOK | wxICON_ERROR, this);
-            return false;
+            auto statusVec = completionState.getStatus(errPos.value());
+            throw fbcpp::DatabaseException(fr::FbCppDatabase::getClient(), statusVec.data());
         }
+        totalInserted += group.getRowCount();
+    };
+
+    // commits the work done so far and remembers where to continue if the
+    // rest of the import fails
+    auto commitWork = [&](const SqlImportGroup& group) {
+        transactionM->commit();
+        transactionM->start();
+        committedOffset = group.endOffset;
+        rowsSinceCommit = 0;
+        bytesSinceCommit = 0;
+        config().setValue("BatchImportRestartFile", filePath);
+        config().setValue("BatchImportRestartDatabase", databaseM->getConnectionString());
+        config().setValue("BatchImportRestartOffset",
+            wxString::Format("%lld", (long long)committedOffset));
+        config().setValue("BatchImportRestartTerminator", group.endTerminator);
+        config().setValue("BatchImportRestartUtf8", group.utf8);
     };
 
     bool ok = true;
-    for (stmtIndex = 0; stmtIndex < statements.size(); ++stmtIndex)
+    SqlImportGroup group;
+    while (true)
     {
         if (pd.isCanceled())
         {
@@ -2216,112 +2112,80 @@ void ExecuteSqlFrame::OnMenuBatchImport(wxCommandEvent& WXUNUSED(event))
             break;
         }
 
-        wxString sql = statements[stmtIndex];
-        ParsedInsert pi = parseInsertStatement(sql);
-
-        if (pi.isValid)
+        SqlImportPipeline::Status status = pipeline.next(group, 100);
+        if (status == SqlImportPipeline::statusFinished)
         {
-            wxString prepSql = "INSERT INTO " + pi.tableName;
-            if (!pi.columns.IsEmpty())
-            {
-                prepSql += " (";
-                for (size_t i = 0; i < pi.columns.size(); ++i)
-                {
-                    if (i > 0) prepSql += ", ";
-                    prepSql += pi.columns[i];
-                }
-                prepSql += ")";
-            }
-            prepSql += " VALUES (";
-            for (size_t i = 0; i < pi.values.size(); ++i)
-            {
-                if (i > 0) prepSql += ", ";
-                prepSql += "?";
-            }
-            prepSql += ")";
-
-            if (currentGroup.tableName == pi.tableName && currentGroup.columns.size() == pi.columns.size())
-            {
-                bool columnsMatch = true;
-                for (size_t i = 0; i < pi.columns.size(); ++i)
-                {
-                    if (currentGroup.columns[i] != pi.columns[i])
-                    {
-                        columnsMatch = false;
-                        break;
-                    }
-                }
+            errorMsg = pipeline.getError();
+            ok = errorMsg.empty();
+            break;
+        }
+        if (status == SqlImportPipeline::statusWaiting)
+        {
+            pd.setProgressPosition(length ? size_t(committedOffset * 1000 / length) : 0);
+            continue;
+        }
 
-                if (columnsMatch && currentGroup.rowsValues.size() < 5000)
-                {
-                    currentGroup.rowsValues.push_back(std::vector<wxString>(pi.values.begin(), pi.values.end()));
-                    currentGroup.rowsValueTypes.push_back(pi.valueTypes);
-                }
-                else
-                {
-                    if (!executeCurrentGroup())
-                    {
-                        ok = false;
-                        break;
-                    }
-                    currentGroup.prepSql = prepSql;
-                    currentGroup.tableName = pi.tableName;
-                    currentGroup.columns = pi.columns;
-                    currentGroup.rowsValues.push_back(std::vector<wxString>(pi.values.begin(), pi.values.end()));
-                    currentGroup.rowsValueTypes.push_back(pi.valueTypes);
-                }
-            }
-            else
+        try
+        {
+            switch (group.kind)
             {
-                if (!executeCurrentGroup())
+                case SqlImportGroup::kindInsertBatch:
+                    executeBatch(group);
+                    break;
+                case SqlImportGroup::kindStatement:
                 {
-                    ok = false;
+                    fr::IStatementPtr st = databaseM->getDALDatabase()->createStatement(transactionM);
+                    st->prepare(wx2std(group.sql, databaseM->getCharsetConverter()));
+                    st->execute();
+                    totalIndividual++;
                     break;
                 }
-                currentGroup.prepSql = prepSql;
-                currentGroup.tableName = pi.tableName;
-                currentGroup.columns = pi.columns;
-                currentGroup.rowsValues.push_back(std::vector<wxString>(pi.values.begin(), pi.values.end()));
-                currentGroup.rowsValueTypes.push_back(pi.valueTypes);
+                case SqlImportGroup::kindCommit:
+                    commitWork(group);
+                    break;
+                case SqlImportGroup::kindRollback:
+                    transactionM->rollback();
+                    transactionM->start();
+                    rowsSinceCommit = 0;
+                    bytesSinceCommit = 0;
+                    break;
             }
         }
-        else
+        catch (const std::exception& e)
         {
-            if (!executeCurrentGroup())
-            {
-                ok = false;
-                break;
-            }
+            wxString err = wxString::FromUTF8(e.what());
+            if (group.kind == SqlImportGroup::kindStatement)
+                errorMsg = wxString::Format(_("Statement execution failed:\nStatement: %s\nError: %s"), group.sql, err);
+            else
+                errorMsg = wxString::Format(_("Batch execution failed:\n%s"), err);
+            ok = false;
+            break;
+        }
 
+        rowsSinceCommit += group.statementCount;
+        bytesSinceCommit += group.byteCount;
+        if ((commitRows && rowsSinceCommit >= commitRows)
+            || (commitBytes && bytesSinceCommit >= commitBytes))
+        {
             try
             {
-                fr::IStatementPtr st = databaseM->getDALDatabase()->createStatement(transactionM);
-                st->prepare(wx2std(sql, databaseM->getCharsetConverter()));
-                st->execute();
-                totalIndividual++;
+                commitWork(group);
             }
             catch (const std::exception& e)
             {
-                wxString errMsg = wxString::FromUTF8(e.what());
-                wxMessageBox(wxString::Format(_("Statement execution failed:\nStatement: %s\nError: %s"), sql, errMsg),
-                    _("Error"), wxOK | wxICON_ERROR, this);
+                errorMsg = wxString::Format(_("Commit failed:\n%s"),
+                    wxString::FromUTF8(e.what()));
                 ok = false;
                 break;
             }
         }
 
-        pd.setProgressPosition(stmtIndex + 1);
-        if (stmtIndex % 50 == 0)
-        {
-            wxYield();
-        }
-    }
-
-    if (ok)
-    {
-        ok = executeCurrentGroup();
+        pd.setProgressMessage(wxString::Format(_("%lu statements imported"),
+            (unsigned long)(totalInserted + totalIndividual)));
+        pd.setProgressPosition(length ? size_t(group.endOffset * 1000 / length) : 0);
     }
 
+    pipeline.cancel();
     pd.doHide();
 
     if (ok)
@@ -2331,6 +2195,7 @@ void ExecuteSqlFrame::OnMenuBatchImport(wxCommandEvent& WXUNUSED(event))
             transactionM->commit();
             transactionM = nullptr;
         }
+        config().setValue("BatchImportRestartFile", wxString());
 
         wxMessageBox(wxString::Format(_("Batch SQL Import completed successfully.\n\nTotal Batched Inserts: %lu\nTotal Individual Statements: %lu"),
             (unsigned long)totalInserted, (unsigned long)totalIndividual),
@@ -2344,8 +2209,19 @@ void ExecuteSqlFrame::OnMenuBatchImport(wxCommandEvent& WXUNUSED(event))
             transactionM = nullptr;
         }
 
-        wxMessageBox(_("Batch SQL Import was aborted. All changes have been rolled back."),
-            _("Aborted"), wxOK | wxICON_WARNING, this);
+        if (!errorMsg.empty())
+            wxMessageBox(errorMsg, _("Error"), wxOK | wxICON_ERROR, this);
+        if (committedOffset > startOffset)
+        {
+            wxMessageBox(wxString::Format(_("Batch SQL Import was aborted. The changes after byte %s of the file have been rolled back.\n\nImport the same file again to continue from there."),
+                wxString::Format("%lld", (long long)committedOffset)),
+                _("Aborted"), wxOK | wxICON_WARNING, this);
+        }
+        else
+        {
+            wxMessageBox(_("Batch SQL Import was aborted. All changes have been rolled back."),
+                _("Aborted"), wxOK | wxICON_WARNING, this);
+        }
     }
 }
 
@@ -2780,7 +2656,7 @@ void ExecuteSqlFrame::OnMenuGridSaveAsExcel(wxCommandEvent& WXUNUSED(event))
 {
     wxString fname = ::wxFileSelector(_("Save data in selected cells as Excel XML"),
         wxEmptyString, wxEmptyString, "*.xls",
-        _("Excel files (*.xls)|*.xls|XML Spreadsheet (*.xml)|*.xml|All files (*.*)|*.*"),
+        _("Excel files (*.xls)|*.xls|Excel workbooks (*.xlsx)|*.xlsx|XML Spreadsheet (*.xml)|*.xml|All files (*.*)|*.*"),
         wxFD_SAVE | wxFD_CHANGE_DIR | wxFD_OVERWRITE_PROMPT, this);
     if (!fname.empty())
     {
@@ -2812,6 +2688,91 @@ void ExecuteSqlFrame::OnMenuGridSaveAsMarkdown(wxCommandEvent& WXUNUSED(event))
     }
 }
 
+void ExecuteSqlFrame::OnMenuGridExportAll(wxCommandEvent& WXUNUSED(event))
+{
+    if (!statementM)
+        return;
+
+    wxFileDialog fd(this, _("Export all records of the result set"),
+        wxEmptyString, wxEmptyString,
+        _("CSV files (*.csv)|*.csv|Tab-Separated Values (*.tsv)|*.tsv|JSON files (*.json)|*.json|Excel XML files (*.xls)|*.xls|Markdown files (*.md)|*.md|Excel workbooks (*.xlsx)|*.xlsx"),
+        wxFD_SAVE | wxFD_CHANGE_DIR | wxFD_OVERWRITE_PROMPT);
+    if (fd.ShowModal() != wxID_OK)
+        return;
+
+    static const DataGridExportWriter::Format formats[] = {
+        DataGridExportWriter::formatCSV, DataGridExportWriter::formatCSV,
+        DataGridExportWriter::formatJSON, DataGridExportWriter::formatExcel,
+        DataGridExportWriter::formatMarkdown, DataGridExportWriter::formatXLSX };
+    int index = fd.GetFilterIndex();
+    if (index < 0 || index >= int(sizeof(formats) / sizeof(formats[0])))
+        index = 0;
+
+    wxChar fieldDelimiter = (index == 1) ? '\t' : ',';
+
+    // executing anything but a SELECT again would repeat its side effects,
+    // so for these only the rows the grid already has are exported
+    if (!DataGridStreamingExport::canExport(statementM))
+    {
+        grid_data->saveFetchedRows(fd.GetPath(), formats[index],
+            fieldDelimiter, '"');
+        statusbar_1->SetStatusText(wxString::Format(_("%d records exported"),
+            grid_data->GetNumberRows()), 2);
+        return;
+    }
+
+    // the rows are written by a worker thread, this one only shows the
+    // progress until the export is finished or canceled
+    DataGridStreamingExport exporter(databaseM, formats[index],
+        fieldDelimiter, '"');
+    try
+    {
+        exporter.start(statementM, fd.GetPath());
+    }
+    catch (const FRError& e)
+    {
+        showErrorDialog(this, _("Export failed"), e.what(),
+            AdvancedMessageDialogButtonsOk());
+        return;
+    }
+
+    ProgressDialog pd(this, _("Exporting records"));
+    pd.initProgressIndeterminate(_("Executing statement..."));
+    pd.doShow();
+    while (exporter.isRunning())
+    {
+        if (!exporter.isCanceled() && pd.isCanceled())
+            exporter.cancel();
+        uint64_t rows = exporter.getRowCount();
+        if (rows)
+        {
+            pd.setProgressMessage(wxString::Format(
+                _("%s records written (%s MB)"),
+                wxString::Format("%llu", (unsigned long long)rows),
+                wxString::Format("%llu",
+                    (unsigned long long)(exporter.getByteCount() >> 20))));
+        }
+        pd.stepProgress();
+        wxMilliSleep(100);
+    }
+    pd.doHide();
+    try
+    {
+        exporter.finish();
+    }
+    catch (const FRError& e)
+    {
+        showErrorDialog(this, _("Export failed"), e.what(),
+            AdvancedMessageDialogButtonsOk());
+        return;
+    }
+
+    statusbar_1->SetStatusText(wxString::Format(
+        exporter.isCanceled() ? _("Export canceled after %s records")
+            : _("%s records exported"),
+        wxString::Format("%llu", (unsigned long long)exporter.getRowCount())), 2);
+}
+
 void ExecuteSqlFrame::OnFilterTextChange(wxCommandEvent& WXUNUSED(event))
 {
     if (!grid_data)
@@ -2983,6 +2944,12 @@ void ExecuteSqlFrame::OnMenuUpdateGridFetchAll(wxUpdateUIEvent& event)
         && !table->getFetchAllRows());
 }
 
+void ExecuteSqlFrame::OnMenuUpdateGridExportAll(wxUpdateUIEvent& event)
+{
+    DataGridTable* table = grid_data->getDataGridTable();
+    event.Enable(statementM && table && table->GetNumberCols() > 0);
+}
+
 void ExecuteSqlFrame::OnMenuUpdateGridCancelFetchAll(wxUpdateUIEvent& event)
 {
     DataGridTable* table = grid_data->getDataGridTable();
@@ -3027,6 +2994,26 @@ bool ExecuteSqlFrame::loadSqlFile(const wxString& filename)
             return false;
     }
 
+    // scripts too big for the editor are executed from disk instead
+    wxULongLong maxSize(wxULongLong_t(std::max(0,
+        config().get("ScriptFileEditorLimitMB", 32))) * 1024 * 1024);
+    wxULongLong size = wxFileName::GetSize(filename);
+    if (maxSize > 0 && size != wxInvalidSize && size > maxSize)
+    {
+        Raise();
+        int res = showQuestionDialog(this, _("Do you want to execute the script without loading it?"),
+            wxString::Format(_("The file\n\n%s\n\nhas %s. Loading it into the editor takes a lot of memory, but it can be executed directly from disk instead."),
+            filename, wxFileName::GetHumanReadableSize(size)),
+            AdvancedMessageDialogButtonsYesNoCancel(_("&Execute"), _("&Load")));
+        if (res == wxYES)
+        {
+            executeScriptFile(filename);
+            return true;
+        }
+        if (res != wxNO)
+            return false;
+    }
+
     if (!styled_text_ctrl_sql->LoadFile(filename))
         return false;
     filenameM = filename;
@@ -3232,6 +3219,28 @@ void ExecuteSqlFrame::executeAllStatements(bool closeWhenDone)
         Close();
 }
 
+namespace {
+
+// Long scripts (hundreds-to-thousands of statements) blocked the UI
+// thread for so long that the OS marked the window as "Not
+// Responding". Pump the event loop periodically so the log pane
+// repaints and the window stays responsive. YieldFor with
+// wxEVT_CATEGORY_UI processes UI events only — repaints and other
+// visual updates flow but user-input events (keypresses, clicks)
+// are deferred. Combined with the re-entrancy guard of the callers, this
+// keeps the loop safe. They throttle it to every 100 statements so yield
+// cost doesn't dominate runtime. Use the active event loop rather
+// than wxApp because wxApp::YieldFor is not exposed on every wx
+// port. Returns false if the window was destroyed meanwhile.
+bool yieldDuringScript(const wxWeakRef<wxWindow>& window)
+{
+    if (wxEventLoopBase* loop = wxEventLoopBase::GetActive())
+        loop->YieldFor(wxEVT_CATEGORY_UI);
+    return window;
+}
+
+} // namespace
+
 //! Parses all sql statements in STC
 //! when autoexecute is TRUE, program just waits user to click Commit/Rollback and closes window
 //! when autocommit DDL is also set then frame is closed at once if commit was successful
@@ -3261,72 +3270,31 @@ bool ExecuteSqlFrame::parseStatements(const wxString& statements,
         if (!ss.isValid())
             break;
 
-        wxString newTerminator, autoDDLSetting;
-        if (ss.isCommitStatement())
-        {
-            if (!commitTransaction())
-                return false;
-        }
-        else if (ss.isRollbackStatement())
-            rollbackTransaction();
-        else if (ss.isSetTermStatement(newTerminator))
-        {
-            if (newTerminator.empty())
-            {
-                ::wxMessageBox(_("SET TERM command found without terminator.\nStopping further execution."),
-                    _("Warning"), wxOK | wxICON_WARNING);
-                return false;
-            }
-        }
-        else if (ss.isSetAutoDDLStatement(autoDDLSetting))
+        bool executeFailed = false;
+        if (!executeScriptStatement(ss, ms.getTerminator(), prepareOnly,
+            fetchAll, executeFailed))
         {
-            if (autoDDLSetting.CmpNoCase("ON") == 0)
-                autoCommitM = true;
-            else if (autoDDLSetting.CmpNoCase("OFF") == 0)
-                autoCommitM = false;
-            else if (autoDDLSetting.empty())
-                autoCommitM = !autoCommitM;
-            else
+            if (executeFailed)
             {
-                ::wxMessageBox(_("SET AUTODDL command found with invalid parameter (has to be \"ON\" or \"OFF\").\nStopping further execution."),
-                    _("Warning"), wxOK | wxICON_WARNING);
-                return false;
+                int stmtStart = selectionOffset + ms.getStart();
+                // STC uses UTF-8 internally in Unicode build
+                // account for possible differences in string length
+                // if system charset != UTF-8
+                std::string stmt(wx2std(ss.getSql(), &wxConvUTF8));
+                int stmtEnd = stmtStart + stmt.size();
+                styled_text_ctrl_sql->markText(stmtStart, stmtEnd);
+                styled_text_ctrl_sql->SetFocus();
             }
-        }
-        else if (!ss.isEmptyStatement()
-            && !execute(ss.getSql(), ms.getTerminator(), prepareOnly, fetchAll))
-        {
-            int stmtStart = selectionOffset + ms.getStart();
-            // STC uses UTF-8 internally in Unicode build
-            // account for possible differences in string length
-            // if system charset != UTF-8
-            std::string stmt(wx2std(ss.getSql(), &wxConvUTF8));
-            int stmtEnd = stmtStart + stmt.size();
-            styled_text_ctrl_sql->markText(stmtStart, stmtEnd);
-            styled_text_ctrl_sql->SetFocus();
             return false;
         }
 
-        // Long scripts (hundreds-to-thousands of statements) blocked the UI
-        // thread for so long that the OS marked the window as "Not
-        // Responding". Pump the event loop periodically so the log pane
-        // repaints and the window stays responsive. YieldFor with
-        // wxEVT_CATEGORY_UI processes UI events only — repaints and other
-        // visual updates flow but user-input events (keypresses, clicks)
-        // are deferred. Combined with the re-entrancy guard above, this
-        // keeps the loop safe. Throttle to every 100 statements so yield
-        // cost doesn't dominate runtime. Use the active event loop rather
-        // than wxApp because wxApp::YieldFor is not exposed on every wx
-        // port.
         if (++statementsSinceYield >= 100)
         {
-            if (wxEventLoopBase* loop = wxEventLoopBase::GetActive())
-                loop->YieldFor(wxEVT_CATEGORY_UI);
             statementsSinceYield = 0;
             // If the window was destroyed while we yielded (e.g. user
             // closed the parent frame from a non-input event), stop
             // before we touch any of our members.
-            if (!selfRef)
+            if (!yieldDuringScript(selfRef))
                 return false;
         }
     }
@@ -3342,6 +3310,141 @@ bool ExecuteSqlFrame::parseStatements(const wxString& statements,
     return true;
 }
 
+//! Handles the statements that FlameRobin executes itself and passes the
+//! others to execute(). Returns false if the script has to be stopped,
+//! executeFailed is set if that's because the statement failed.
+bool ExecuteSqlFrame::executeScriptStatement(const SingleStatement& ss,
+    const wxString& terminator, bool prepareOnly, bool fetchAll,
+    bool& executeFailed)
+{
+    executeFailed = false;
+    wxString newTerminator, autoDDLSetting;
+    if (ss.isCommitStatement())
+        return commitTransaction();
+    if (ss.isRollbackStatement())
+    {
+        rollbackTransaction();
+        return true;
+    }
+    if (ss.isSetTermStatement(newTerminator))
+    {
+        if (newTerminator.empty())
+        {
+            ::wxMessageBox(_("SET TERM command found without terminator.\nStopping further execution."),
+                _("Warning"), wxOK | wxICON_WARNING);
+            return false;
+        }
+        return true;
+    }
+    if (ss.isSetAutoDDLStatement(autoDDLSetting))
+    {
+        if (autoDDLSetting.CmpNoCase("ON") == 0)
+            autoCommitM = true;
+        else if (autoDDLSetting.CmpNoCase("OFF") == 0)
+            autoCommitM = false;
+        else if (autoDDLSetting.empty())
+            autoCommitM = !autoCommitM;
+        else
+        {
+            ::wxMessageBox(_("SET AUTODDL command found with invalid parameter (has to be \"ON\" or \"OFF\").\nStopping further execution."),
+                _("Warning"), wxOK | wxICON_WARNING);
+            return false;
+        }
+        return true;
+    }
+    if (!ss.isEmptyStatement()
+        && !execute(ss.getSql(), terminator, prepareOnly, fetchAll))
+    {
+        executeFailed = true;
+        return false;
+    }
+    return true;
+}
+
+//! Executes a script file without loading it into the editor. The file is
+//! split into statements while it is read, so only the statement being
+//! executed and the chunk of the file it's in are held in memory, and the
+//! log only keeps the output of the last statements.
+bool ExecuteSqlFrame::executeScriptFile(const wxString& filename)
+{
+    if (inParseStatementsM)
+        return false;
+    inParseStatementsM = true;
+    struct ResetGuard { bool& flag; ~ResetGuard() { flag = false; } } g{inParseStatementsM};
+    executingScriptFileM = true;
+    ResetGuard scriptFileGuard{executingScriptFileM};
+    wxWeakRef<wxWindow> selfRef(this);
+
+    SqlScriptReader reader;
+    if (!reader.open(filename))
+    {
+        wxMessageBox(_("Failed to open the selected file."), _("Error"),
+            wxOK | wxICON_ERROR, this);
+        return false;
+    }
+
+    clearLogBeforeExecution();
+    log(wxString::Format(_("Executing script file %s (%s bytes)."), filename,
+        wxString::Format("%lld", (long long)reader.getLength())));
+
+    wxBusyCursor cr;
+    int statementsSinceYield = 0;
+    SingleStatement ss;
+    while (true)
+    {
+        try
+        {
+            if (!reader.next(ss))
+                break;
+        }
+        catch (const FRError& e)
+        {
+            log(e.what(), ttError);
+            return false;
+        }
+
+        bool executeFailed = false;
+        if (!executeScriptStatement(ss, reader.getTerminator(), false, false,
+            executeFailed))
+        {
+            if (executeFailed)
+            {
+                ScrollAtEnd sae(styled_text_ctrl_stats);
+                log(wxString::Format(_("Script execution stopped at the statement starting at byte %s of the file."),
+                    wxString::Format("%lld", (long long)reader.getStatementOffset())),
+                    ttError);
+            }
+            return false;
+        }
+
+        if (++statementsSinceYield >= 100)
+        {
+            statementsSinceYield = 0;
+            trimLog(maxScriptLogLength);
+            statusbar_1->SetStatusText(wxString::Format(_("%s of %s bytes executed"),
+                wxString::Format("%lld", (long long)reader.getOffset()),
+                wxString::Format("%lld", (long long)reader.getLength())), 1);
+            if (!yieldDuringScript(selfRef))
+                return false;
+        }
+    }
+
+    ScrollAtEnd sae(styled_text_ctrl_stats);
+    log(_("Script execution finished."));
+    return true;
+}
+
+//! removes the oldest lines of the log so that it's at most maxLength long
+void ExecuteSqlFrame::trimLog(int maxLength)
+{
+    int length = styled_text_ctrl_stats->GetLength();
+    if (length <= maxLength)
+        return;
+    int line = styled_text_ctrl_stats->LineFromPosition(length - maxLength);
+    int end = styled_text_ctrl_stats->PositionFromLine(line + 1);
+    styled_text_ctrl_stats->DeleteRange(0, end);
+}
+
 void ExecuteSqlFrame::OnMenuUpdateWhenExecutePossible(wxUpdateUIEvent& event)
 {
     event.Enable(!closeWhenTransactionDoneM);
@@ -3815,7 +3918,9 @@ bool ExecuteSqlFrame::execute(wxString sql, const wxString& terminator,
             }
             if (stm.isDDL())
                 type = fr::StatementType::DDL;
-            executedStatementsM.push_back(stm);
+            // parseCommitedSql() only needs the DDL
+            if (type == fr::StatementType::DDL || !executingScriptFileM)
+                executedStatementsM.push_back(stm);
             setViewMode(vmEditor);
             if (type == fr::StatementType::DDL && autoCommitM)
             {
@@ -3835,7 +3940,8 @@ bool ExecuteSqlFrame::execute(wxString sql, const wxString& terminator,
                 log("" + s);
             }
             catch (...) {}
-            executedStatementsM.push_back(stm);
+            if (!executingScriptFileM)
+                executedStatementsM.push_back(stm);
         }
     }
     catch(const std::exception& e)
@@ -4338,59 +4444,92 @@ void ExecuteSqlFrame::subjectRemoved(Subject* subject)
         Close();
 }
 
-static int CaseUnsensitiveCompare(const wxString& one, const wxString& two)
+ObjectNameCompletion::ObjectNameCompletion()
+    : Observer(), databaseM(0), indexValidM(false)
 {
-    // this would be the right solution, but it doesn't work well as it
-    // sorts the underscore character differently
-    // return one.CmpNoCase(two);
+}
+
+ObjectNameCompletion::~ObjectNameCompletion()
+{
+    detachCollections();
+}
 
-    // we have to check for underscore first
-    int min = one.Length() > two.Length() ? two.Length() : one.Length();
-    for (int i = 0; i < min; ++i)
+void ObjectNameCompletion::detachCollections()
+{
+    for (size_t i = 0; i < collectionsM.size(); ++i)
+        collectionsM[i]->detachObserver(this);
+    collectionsM.clear();
+}
+
+void ObjectNameCompletion::setDatabase(Database* database)
+{
+    detachCollections();
+    databaseM = database;
+    indexValidM = false;
+    if (!databaseM || !databaseM->isConnected())
+        return;
+
+    std::vector<MetadataItem*> collections;
+    databaseM->getCollections(collections, false);
+    for (size_t i = 0; i < collections.size(); ++i)
     {
-        if (one[i] == '_' && two[i] != '_')
-            return 1;
-        if (one[i] != '_' && two[i] == '_')
-            return -1;
-        if (one[i] != two[i])
-            return one.CmpNoCase(two);
+        if (!collections[i])
+            continue;
+        collections[i]->attachObserver(this, false);
+        collectionsM.push_back(collections[i]);
     }
-    return one.CmpNoCase(two);
 }
-//! Creates a list for autocomplete feature
 
-//! The list consists of:
+const AutoCompleteIndex& ObjectNameCompletion::getIndex()
+{
+    if (!indexValidM && databaseM && databaseM->isConnected())
+    {
+        std::vector<Identifier> v;
+        databaseM->getIdentifiers(v);
+        wxArrayString names;
+        names.Alloc(v.size());
+        for (std::vector<Identifier>::const_iterator it = v.begin(); it != v.end(); ++it)
+            names.Add((*it).getQuoted());
+        indexM.setWords(names);
+        indexValidM = true;
+    }
+    return indexM;
+}
+
+void ObjectNameCompletion::update()
+{
+    // next call to getIndex() will reload the names
+    indexValidM = false;
+}
+
+void ObjectNameCompletion::subjectRemoved(Subject* subject)
+{
+    collectionsM.erase(std::remove(collectionsM.begin(), collectionsM.end(),
+        subject), collectionsM.end());
+    indexValidM = false;
+}
+
+//! Creates the indices for autocomplete feature
+
+//! They consist of:
 //! - sql keywords
-//! - names of database objects (tables, views, etc.)
+//! - names of database objects (tables, views, etc.), which are reloaded
+//!   when the metadata collections change
 //
 void ExecuteSqlFrame::setKeywords()
 {
-    // TODO:
-    // we can also make ExecuteSqlFrame observer of YTables/YViews/... objects
-    // so it can reload this list if something changes
-
     const DatabaseInfo& dbInfo(databaseM->getInfo());
     int odsMajor = dbInfo.getODS();
     int odsMinor = dbInfo.getODSMinor();
 
-    wxArrayString as(SqlTokenizer::getKeywords(SqlTokenizer::kwDefaultCase,
-        odsMajor, odsMinor));
+    keywordIndexM.setWords(SqlTokenizer::getKeywords(
+        SqlTokenizer::kwDefaultCase, odsMajor, odsMinor));
 
     // Update syntax highlighting keywords
     styled_text_ctrl_sql->setKeywords(odsMajor, odsMinor);
 
-    // get list od database objects' names
-    std::vector<Identifier> v;
-    databaseM->getIdentifiers(v);
-    for (std::vector<Identifier>::const_iterator it = v.begin(); it != v.end(); ++it)
-        as.Add((*it).getQuoted());
-    // The list has to be sorted for autocomplete to work properly
-    as.Sort(CaseUnsensitiveCompare);
-
-    keywordsM.clear();                          // create final wxString from array
-    keywordsM.Alloc(20480);     // preallocate 20kB
-    for (size_t i = 0; i < as.GetCount(); ++i)  // separate words with spaces
-        keywordsM += as.Item(i) + " ";
+    objectNamesM.setDatabase(databaseM);
+    queryColumnsKeyM.clear();
 }
 
 //! logs all activity to text control
@@ -4856,6 +4995,67 @@ bool EditDDLHandler::handleURI(URI& uri)
     return true;
 }
 
+//! write DDL to a file, the script of a database while it is extracted
+class SaveDDLHandler: public URIHandler,
+    private MetadataItemURIHandlerHelper, private GUIURIHandlerHelper
+{
+public:
+    SaveDDLHandler() {}
+    bool handleURI(URI& uri);
+private:
+    static const SaveDDLHandler handlerInstance;
+};
+
+const SaveDDLHandler SaveDDLHandler::handlerInstance;
+
+bool SaveDDLHandler::handleURI(URI& uri)
+{
+    if (uri.action != "save_ddl")
+        return false;
+
+    MetadataItem* m = extractMetadataItemFromURI<MetadataItem>(uri);
+    wxWindow* w = getParentWindow(uri);
+    if (!m || !w)
+        return true;
+
+    wxFileDialog fd(w, _("Save DDL As"), wxEmptyString,
+        m->getName_() + ".sql",
+        _("SQL script files (*.sql)|*.sql|All files (*.*)|*.*"),
+        wxFD_SAVE | wxFD_CHANGE_DIR | wxFD_OVERWRITE_PROMPT);
+    if (fd.ShowModal() != wxID_OK)
+        return true;
+    wxFile file;
+    if (!file.Create(fd.GetPath(), true))
+        return true;
+
+    // use a single read-only transaction for metadata loading
+    DatabasePtr db = m->getDatabase();
+    MetadataLoaderTransaction tr(db->getMetadataLoader());
+
+    ProgressDialog pd(0, _("Extracting DDL Definitions"), 2);
+    pd.doShow();
+    bool canceled, written;
+    {
+        DDLScriptWriter writer(&file);
+        CreateDDLVisitor cdv(&pd, &writer);
+        m->acceptVisitor(&cdv);
+        if (!dynamic_cast<Database*>(m))
+            writer.add(cdv.getSql());
+        canceled = pd.isCanceled();
+        written = canceled || writer.finish();
+    }
+    pd.doHide();
+    written = file.Close() && written;
+    if (canceled)
+        wxRemoveFile(fd.GetPath());
+    else if (!written)
+    {
+        showErrorDialog(w, _("The DDL could not be written."), fd.GetPath(),
+            AdvancedMessageDialogButtonsOk());
+    }
+    return true;
+}
+
 class EditProcedureHandler: public URIHandler,
     private MetadataItemURIHandlerHelper, private GUIURIHandlerHelper
 {
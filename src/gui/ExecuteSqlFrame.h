@@ -40,6 +40,7 @@
 #include "gui/BaseFrame.h"
 #include "gui/EditBlobDialog.h"
 #include "gui/FindDialog.h"
+#include "sql/AutoCompleteIndex.h"
 #include "sql/SqlStatement.h"
 #include "statementHistory.h"
 #include "map"
@@ -48,6 +49,30 @@ class CommandManager;
 class Database;
 class DataGrid;
 class ExecuteSqlFrame;
+class SingleStatement;
+class Subject;
+
+// ObjectNameCompletion class
+// Autocomplete index of the names of the database objects, observes the
+// metadata collections to rebuild it when objects are created, dropped or
+// renamed (rebuilds on-demand)
+class ObjectNameCompletion: public Observer
+{
+private:
+    Database* databaseM;
+    std::vector<Subject*> collectionsM;
+    AutoCompleteIndex indexM;
+    bool indexValidM;
+    void detachCollections();
+protected:
+    virtual void update();
+    virtual void subjectRemoved(Subject* subject);
+public:
+    ObjectNameCompletion();
+    ~ObjectNameCompletion();
+    void setDatabase(Database* database);
+    const AutoCompleteIndex& getIndex();
+};
 
 class SqlEditor: public SearchableEditor
 {
@@ -99,6 +124,10 @@ private:
         bool prepareOnly = false, int selectionOffset = 0, bool fetchAll = false);
     bool execute(wxString sql, const wxString& terminator,
         bool prepareOnly = false, bool fetchAll = false);
+    bool executeScriptStatement(const SingleStatement& ss,
+        const wxString& terminator, bool prepareOnly, bool fetchAll,
+        bool& executeFailed);
+    bool executeScriptFile(const wxString& filename);
 
     std::vector<SqlStatement> executedStatementsM;
     std::map<std::string, wxString> parameterSaveList;
@@ -113,6 +142,8 @@ private:
     typedef enum { ttNormal, ttSql, ttError } TextType;
     void log(wxString s, TextType type = ttNormal);     // write messages to textbox
     void clearLogBeforeExecution();
+    enum { maxScriptLogLength = 1024 * 1024 };
+    void trimLog(int maxLength);
     void prepareVolatileDatabase(wxString server = "", wxString port = "3050", wxString db = "", wxString user = "", wxString password = "", wxString role = "", wxString charset = "NONE");
 
     void splitScreen();
@@ -129,6 +160,9 @@ private:
     bool highlightWordTextMatchCase = false; //use sensitive search?
     bool inHighlightUpdateM = false; // reentrancy guard for OnSqlEditUpdateUI
     bool inParseStatementsM = false; // reentrancy guard for parseStatements yields
+    // set while a script file is executed: only DDL is kept in
+    // executedStatementsM then, as a dump can have millions of DML statements
+    bool executingScriptFileM = false;
     bool autoCommitM;
     bool inTransactionM;
     fr::ITransactionPtr transactionM;
@@ -151,7 +185,14 @@ private:
     void OnSqlEditCharAdded(wxStyledTextEvent& event);      // autocomplete stuff
     void OnSqlEditChanged(wxStyledTextEvent& event);        // update title
     void OnSqlEditStartDrag(wxStyledTextEvent& event);      // enable click&remove selection
-    wxString keywordsM;     // text used for autocomplete
+    // words used for autocomplete
+    AutoCompleteIndex keywordIndexM;
+    ObjectNameCompletion objectNamesM;
+    // columns of the statement being edited, kept while the same word is
+    // typed
+    wxString queryColumnsKeyM;
+    AutoCompleteIndex queryColumnsM;
+    const AutoCompleteIndex& getQueryColumns(int start, int pos);
     void setKeywords();
     void buildMainMenu(CommandManager& cm);
     void buildToolbar(CommandManager& cm);
@@ -235,6 +276,7 @@ private:
     void OnMenuShowPlan(wxCommandEvent& event);
     void OnMenuExplain(wxCommandEvent& event);
     void OnMenuBatchImport(wxCommandEvent& event);
+    void OnMenuExecuteScriptFile(wxCommandEvent& event);
     void OnMenuShowStatistics(wxCommandEvent& event);
     void OnMenuUpdateShowStatistics(wxUpdateUIEvent& event);
     void OnMenuShowProfiler(wxCommandEvent& event);
@@ -273,6 +315,7 @@ private:
     void OnMenuGridSaveAsJson(wxCommandEvent& event);
     void OnMenuGridSaveAsExcel(wxCommandEvent& event);
     void OnMenuGridSaveAsMarkdown(wxCommandEvent& event);
+    void OnMenuGridExportAll(wxCommandEvent& event);
     void OnMenuGridFetchAll(wxCommandEvent& event);
     void OnMenuGridCancelFetchAll(wxCommandEvent& event);
     void OnMenuGridAutofitColumns(wxCommandEvent& event);
@@ -280,6 +323,7 @@ private:
     void OnMenuUpdateGridHasSelection(wxUpdateUIEvent& event);
     void OnMenuUpdateGridHasData(wxUpdateUIEvent& event);
     void OnMenuUpdateGridFetchAll(wxUpdateUIEvent& event);
+    void OnMenuUpdateGridExportAll(wxUpdateUIEvent& event);
     void OnMenuUpdateGridCancelFetchAll(wxUpdateUIEvent& event);
     void OnMenuUpdateGridCanSetFieldToNULL(wxUpdateUIEvent& event);
 
@@ -65,7 +65,9 @@ void HtmlTemplateProcessor::processCommand(const wxString& cmdName,
         HtmlHeaderMetadataItemVisitor v(pages);
         metadataItem->acceptVisitor(&v);
 
-        wxString page = loadEntireFile(getTemplatePath() + "header.html");
+        // read once, every page has the header
+        wxString page(TemplateCache::get().compileFile(
+            wxFileName(getTemplatePath() + "header.html"))->getText());
         bool first = true;
         while (!page.Strip().IsEmpty())
         {
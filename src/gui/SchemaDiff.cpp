@@ -26,346 +26,516 @@
     #include "wx/wx.h"
 #endif
 
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+#include "core/StringUtils.h"
+#include "engine/db/IDatabase.h"
+#include "engine/db/IStatement.h"
+#include "engine/db/ITransaction.h"
+#include "firebird/constants.h"
 #include "gui/SchemaDiff.h"
 #include "metadata/CreateDDLVisitor.h"
 #include "metadata/column.h"
+#include "metadata/DependencyGraph.h"
 #include "metadata/domain.h"
 #include "metadata/exception.h"
 #include "metadata/generator.h"
 #include "metadata/Index.h"
 #include "metadata/procedure.h"
 #include "metadata/relation.h"
+#include "metadata/SchemaSnapshot.h"
 #include "metadata/table.h"
 #include "metadata/trigger.h"
 #include "metadata/view.h"
 
-std::vector<SchemaDiffItem> SchemaDiff::compareDatabases(
-    Database* sourceDb, Database* targetDb, const SchemaDiffOptions& options)
+namespace
 {
-    std::vector<SchemaDiffItem> diffs;
-    if (!sourceDb || !targetDb)
-        return diffs;
 
-    sourceDb->ensureChildrenLoaded();
-    targetDb->ensureChildrenLoaded();
-
-    // 1. Domains
+// reads the objects of one type into a snapshot: the first column is the
+// name, the second the parent or null, all others are the definition;
+// the rows of an object (parameters, segments) have to be adjacent and in
+// a fixed order
+struct SnapshotQuery
+{
+    SchemaSnapshot::ObjectType type;
+    std::string sql;
+};
+
+// the type of a column or parameter; implicit domains have generated
+// names that differ between databases, so only user domains are included
+const char* const fieldTypeColumns =
+    "case when f.rdb$field_name starting 'RDB$' then null "
+    "else f.rdb$field_name end, f.rdb$field_type, f.rdb$field_sub_type, "
+    "f.rdb$field_length, f.rdb$field_precision, f.rdb$field_scale, "
+    "f.rdb$character_length, f.rdb$character_set_id, f.rdb$computed_source";
+
+std::vector<SnapshotQuery> getSnapshotQueries(Database* db,
+    const SchemaDiffOptions& options)
+{
+    const std::string userObject =
+        "(rdb$system_flag = 0 or rdb$system_flag is null)";
+    std::string userTable =
+        "(r.rdb$system_flag = 0 or r.rdb$system_flag is null) "
+        "and r.rdb$view_source is null";
+    if (db->getInfo().getODSVersionIsHigherOrEqualTo(11, 1))
+        userTable += " and (r.rdb$relation_type in (0, 2) or r.rdb$relation_type is null)";
+
+    std::vector<SnapshotQuery> queries;
     if (options.compareDomains)
     {
-        DomainsPtr domains = sourceDb->getDomains();
-        if (domains)
-        {
-            for (auto it = domains->begin(); it != domains->end(); ++it)
-            {
-                Domain* d = dynamic_cast<Domain*>((*it).get());
-                if (!d || d->isSystem()) continue;
-
-                if (!targetDb->findByName(d->getName_()))
-                {
-                    SchemaDiffItem item;
-                    item.objectType = "Domain";
-                    item.objectName = d->getName_();
-                    item.diffType = SchemaDiffItem::diffMissingInTarget;
-                    item.description = wxString::Format(_("Domain '%s' missing in target database"), d->getName_().c_str());
-                    item.migrationSql = wxString::Format("CREATE DOMAIN %s AS %s;\n",
-                        d->getQuotedName().c_str(), d->getDatatypeAsString().c_str());
-                    diffs.push_back(item);
-                }
-            }
-        }
+        SnapshotQuery q = { SchemaSnapshot::otDomain,
+            "select rdb$field_name, null from rdb$fields "
+            "where rdb$system_flag = 0 and rdb$field_name not starting 'RDB$' "
+            "order by 1" };
+        queries.push_back(q);
     }
-
-    // 2. Generators / Sequences
     if (options.compareGenerators)
     {
-        GeneratorsPtr gens = sourceDb->getGenerators();
-        if (gens)
-        {
-            for (auto it = gens->begin(); it != gens->end(); ++it)
-            {
-                Generator* g = dynamic_cast<Generator*>((*it).get());
-                if (!g || g->isSystem()) continue;
-
-                if (!targetDb->findByName(g->getName_()))
-                {
-                    SchemaDiffItem item;
-                    item.objectType = "Generator";
-                    item.objectName = g->getName_();
-                    item.diffType = SchemaDiffItem::diffMissingInTarget;
-                    item.description = wxString::Format(_("Sequence/Generator '%s' missing in target database"), g->getName_().c_str());
-                    item.migrationSql = wxString::Format("CREATE SEQUENCE %s;\n", g->getQuotedName().c_str());
-                    diffs.push_back(item);
-                }
-            }
-        }
+        SnapshotQuery q = { SchemaSnapshot::otGenerator,
+            "select rdb$generator_name, null from rdb$generators where "
+            + userObject + " order by 1" };
+        queries.push_back(q);
     }
-
-    // 3. Exceptions
     if (options.compareExceptions)
     {
-        ExceptionsPtr exes = sourceDb->getExceptions();
-        if (exes)
+        SnapshotQuery q = { SchemaSnapshot::otException,
+            "select rdb$exception_name, null from rdb$exceptions where "
+            + userObject + " order by 1" };
+        queries.push_back(q);
+    }
+    // the tables are needed to know which columns and indices to compare
+    if (options.compareTables || options.compareIndices)
+    {
+        SnapshotQuery q = { SchemaSnapshot::otTable,
+            "select r.rdb$relation_name, null from rdb$relations r where "
+            + userTable + " order by 1" };
+        queries.push_back(q);
+    }
+    if (options.compareTables && options.compareColumns)
+    {
+        SnapshotQuery q = { SchemaSnapshot::otColumn,
+            "select rf.rdb$field_name, rf.rdb$relation_name, "
+            + std::string(fieldTypeColumns) + ", rf.rdb$collation_id "
+            "from rdb$relation_fields rf "
+            "join rdb$relations r on r.rdb$relation_name = rf.rdb$relation_name "
+            "join rdb$fields f on f.rdb$field_name = rf.rdb$field_source "
+            "where " + userTable + " order by 2, 1" };
+        queries.push_back(q);
+    }
+    if (options.compareIndices)
+    {
+        // the indices of constraints are system indices for the model
+        SnapshotQuery q = { SchemaSnapshot::otIndex,
+            "select i.rdb$index_name, i.rdb$relation_name, i.rdb$unique_flag, "
+            "i.rdb$index_type, i.rdb$expression_source, s.rdb$field_name "
+            "from rdb$indices i "
+            "join rdb$relations r on r.rdb$relation_name = i.rdb$relation_name "
+            "left join rdb$index_segments s on s.rdb$index_name = i.rdb$index_name "
+            "where " + userTable + " and not exists (select 1 from "
+            "rdb$relation_constraints rc where rc.rdb$index_name = i.rdb$index_name) "
+            "order by i.rdb$index_name, s.rdb$field_position" };
+        queries.push_back(q);
+    }
+    if (options.compareProcedures)
+    {
+        bool packages = db->getInfo().getODSVersionIsHigherOrEqualTo(12, 0);
+        SnapshotQuery q = { SchemaSnapshot::otProcedure,
+            "select p.rdb$procedure_name, null, p.rdb$procedure_source, "
+            "pp.rdb$parameter_type, pp.rdb$parameter_name, "
+            + std::string(fieldTypeColumns) + " from rdb$procedures p "
+            "left join rdb$procedure_parameters pp "
+            "on pp.rdb$procedure_name = p.rdb$procedure_name "
+            + (packages ? "and pp.rdb$package_name is null " : "") +
+            "left join rdb$fields f on f.rdb$field_name = pp.rdb$field_source "
+            "where (p.rdb$system_flag = 0 or p.rdb$system_flag is null) "
+            + (packages ? "and p.rdb$package_name is null " : "") +
+            "order by p.rdb$procedure_name, pp.rdb$parameter_type, "
+            "pp.rdb$parameter_number" };
+        queries.push_back(q);
+    }
+    if (options.compareViews)
+    {
+        SnapshotQuery q = { SchemaSnapshot::otView,
+            "select r.rdb$relation_name, null, r.rdb$view_source, "
+            "rf.rdb$field_name from rdb$relations r "
+            "left join rdb$relation_fields rf "
+            "on rf.rdb$relation_name = r.rdb$relation_name "
+            "where (r.rdb$system_flag = 0 or r.rdb$system_flag is null) "
+            "and r.rdb$view_source is not null "
+            "order by r.rdb$relation_name, rf.rdb$field_position" };
+        queries.push_back(q);
+    }
+    if (options.compareTriggers)
+    {
+        SnapshotQuery q = { SchemaSnapshot::otTrigger,
+            "select rdb$trigger_name, null, rdb$trigger_type, "
+            "rdb$trigger_sequence, rdb$trigger_inactive, rdb$trigger_source "
+            "from rdb$triggers where " + userObject + " and BIN_AND(rdb$trigger_type, "
+            + std::to_string(TRIGGER_TYPE_MASK) + ") = "
+            + std::to_string(TRIGGER_TYPE_DB) + " order by 1" };
+        queries.push_back(q);
+    }
+    return queries;
+}
+
+std::string trimName(const std::string& name)
+{
+    size_t last = name.find_last_not_of(' ');
+    return (last == std::string::npos) ? std::string() : name.substr(0, last + 1);
+}
+
+// runs on a worker thread, so it may only use the connection of the
+// database and not its metadata
+void readSnapshot(fr::IDatabasePtr db, const std::vector<SnapshotQuery>& queries,
+    SchemaSnapshot& snapshot)
+{
+    fr::ITransactionPtr tr = db->createTransaction();
+    tr->setAccessMode(fr::TransactionAccessMode::Read);
+    tr->start();
+    fr::IStatementPtr st = db->createStatement(tr);
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        st->prepare(queries[i].sql);
+        st->execute();
+        int columns = st->getColumnCount();
+        while (st->fetch())
         {
-            for (auto it = exes->begin(); it != exes->end(); ++it)
+            std::string parent;
+            if (!st->isNull(1))
+                parent = trimName(st->getString(1));
+            size_t object = snapshot.addObject(queries[i].type,
+                trimName(st->getString(0)), parent);
+            for (int c = 2; c < columns; ++c)
             {
-                Exception* e = dynamic_cast<Exception*>((*it).get());
-                if (!e || e->isSystem()) continue;
-
-                if (!targetDb->findByName(e->getName_()))
-                {
-                    SchemaDiffItem item;
-                    item.objectType = "Exception";
-                    item.objectName = e->getName_();
-                    item.diffType = SchemaDiffItem::diffMissingInTarget;
-                    item.description = wxString::Format(_("Exception '%s' missing in target database"), e->getName_().c_str());
-                    item.migrationSql = wxString::Format("CREATE EXCEPTION %s '%s';\n",
-                        e->getQuotedName().c_str(), e->getMessage().c_str());
-                    diffs.push_back(item);
-                }
+                if (st->isNull(c))
+                    snapshot.addNull(object);
+                else
+                    snapshot.addText(object, st->getString(c));
             }
         }
     }
+    tr->commit();
+}
 
-    // 4. Tables and Columns
-    if (options.compareTables)
+// the snapshots of both databases, read at the same time on their own
+// connections
+void readSnapshots(Database* sourceDb, Database* targetDb,
+    const SchemaDiffOptions& options, SchemaSnapshot& source,
+    SchemaSnapshot& target)
+{
+    std::vector<SnapshotQuery> sourceQueries(getSnapshotQueries(sourceDb, options));
+    std::vector<SnapshotQuery> targetQueries(getSnapshotQueries(targetDb, options));
+    fr::IDatabasePtr sourceDal = sourceDb->getDALDatabase();
+    fr::IDatabasePtr targetDal = targetDb->getDALDatabase();
+
+    std::exception_ptr targetError;
+    std::thread worker([&]()
     {
-        TablesPtr tables = sourceDb->getTables();
-        if (tables)
+        try
         {
-            for (auto it = tables->begin(); it != tables->end(); ++it)
-            {
-                Table* srcTbl = dynamic_cast<Table*>((*it).get());
-                if (!srcTbl || srcTbl->isSystem()) continue;
-
-                Table* tgtTbl = dynamic_cast<Table*>(targetDb->findRelation(srcTbl->getName_()));
-                if (!tgtTbl)
-                {
-                    SchemaDiffItem item;
-                    item.objectType = "Table";
-                    item.objectName = srcTbl->getName_();
-                    item.diffType = SchemaDiffItem::diffMissingInTarget;
-                    item.description = wxString::Format(_("Table '%s' missing in target database"), srcTbl->getName_().c_str());
-
-                    CreateDDLVisitor cdv(0);
-                    srcTbl->acceptVisitor(&cdv);
-                    item.migrationSql = cdv.getSql() + "\n";
-                    diffs.push_back(item);
-                }
-                else if (options.compareColumns)
-                {
-                    srcTbl->ensureChildrenLoaded();
-                    tgtTbl->ensureChildrenLoaded();
-
-                    for (auto cit = srcTbl->begin(); cit != srcTbl->end(); ++cit)
-                    {
-                        Column* srcCol = dynamic_cast<Column*>((*cit).get());
-                        if (!srcCol) continue;
-                        ColumnPtr tgtCol = tgtTbl->findColumn(srcCol->getName_());
-                        if (!tgtCol)
-                        {
-                            SchemaDiffItem item;
-                            item.objectType = "Column";
-                            item.objectName = srcTbl->getName_() + "." + srcCol->getName_();
-                            item.diffType = SchemaDiffItem::diffMissingInTarget;
-                            item.description = wxString::Format(_("Column '%s' in table '%s' missing in target database"),
-                                srcCol->getName_().c_str(), srcTbl->getName_().c_str());
-                            item.migrationSql = wxString::Format("ALTER TABLE %s ADD %s %s;\n",
-                                srcTbl->getQuotedName().c_str(),
-                                srcCol->getQuotedName().c_str(),
-                                srcCol->getDatatype().c_str());
-                            diffs.push_back(item);
-                        }
-                        else if (srcCol->getDatatype() != tgtCol->getDatatype())
-                        {
-                            SchemaDiffItem item;
-                            item.objectType = "Column";
-                            item.objectName = srcTbl->getName_() + "." + srcCol->getName_();
-                            item.diffType = SchemaDiffItem::diffModified;
-                            item.description = wxString::Format(_("Column '%s' in table '%s' type mismatch (%s vs %s)"),
-                                srcCol->getName_().c_str(), srcTbl->getName_().c_str(),
-                                srcCol->getDatatype().c_str(), tgtCol->getDatatype().c_str());
-                            item.migrationSql = wxString::Format("ALTER TABLE %s ALTER COLUMN %s TYPE %s;\n",
-                                srcTbl->getQuotedName().c_str(),
-                                srcCol->getQuotedName().c_str(),
-                                srcCol->getDatatype().c_str());
-                            diffs.push_back(item);
-                        }
-                    }
-
-                    if (options.generateDropStatements)
-                    {
-                        for (auto cit = tgtTbl->begin(); cit != tgtTbl->end(); ++cit)
-                        {
-                            Column* tgtCol = dynamic_cast<Column*>((*cit).get());
-                            if (!tgtCol) continue;
-                            if (!srcTbl->findColumn(tgtCol->getName_()))
-                            {
-                                SchemaDiffItem item;
-                                item.objectType = "Column";
-                                item.objectName = tgtTbl->getName_() + "." + tgtCol->getName_();
-                                item.diffType = SchemaDiffItem::diffExtraInTarget;
-                                item.description = wxString::Format(_("Column '%s' in target table '%s' does not exist in source"),
-                                    tgtCol->getName_().c_str(), tgtTbl->getName_().c_str());
-                                item.migrationSql = wxString::Format("ALTER TABLE %s DROP %s;\n",
-                                    tgtTbl->getQuotedName().c_str(),
-                                    tgtCol->getQuotedName().c_str());
-                                diffs.push_back(item);
-                            }
-                        }
-                    }
-                }
-            }
+            readSnapshot(targetDal, targetQueries, target);
         }
+        catch (...)
+        {
+            targetError = std::current_exception();
+        }
+    });
+    try
+    {
+        readSnapshot(sourceDal, sourceQueries, source);
     }
+    catch (...)
+    {
+        worker.join();
+        throw;
+    }
+    worker.join();
+    if (targetError)
+        std::rethrow_exception(targetError);
+}
 
-    // 5. Indices
-    if (options.compareIndices)
+// the RDB$DEPENDENCIES type of the objects that have to be created after
+// the objects of the same type they use, -1 for all others
+int getDependencyType(SchemaSnapshot::ObjectType type)
+{
+    switch (type)
+    {
+        case SchemaSnapshot::otTable:
+            return 0;
+        case SchemaSnapshot::otProcedure:
+            return 5;
+        case SchemaSnapshot::otView:
+            return 1;
+        default:
+            return -1;
+    }
+}
+
+// orders the differences of every type like the source database needs
+// them to be created: tables after the tables their foreign keys
+// reference, views and procedures after the ones they use
+void sortByDependencies(Database* sourceDb, const SchemaSnapshot& source,
+    std::vector<SchemaSnapshot::Difference>& differences)
+{
+    const DependencyGraph* graph = 0;
+    wxMBConv* conv = sourceDb->getCharsetConverter();
+    size_t first = 0;
+    while (first < differences.size())
     {
-        TablesPtr tables = sourceDb->getTables();
-        if (tables)
+        SchemaSnapshot::ObjectType type = differences[first].type;
+        size_t last = first;
+        while (last < differences.size() && differences[last].type == type)
+            ++last;
+        int dependencyType = getDependencyType(type);
+        if (dependencyType >= 0 && last - first > 1)
         {
-            for (auto it = tables->begin(); it != tables->end(); ++it)
+            if (!graph)
+                graph = &sourceDb->getDependencyGraph();
+            std::vector<size_t> objects;
+            for (size_t i = first; i < last; ++i)
             {
-                Table* srcTbl = dynamic_cast<Table*>((*it).get());
-                if (!srcTbl || srcTbl->isSystem()) continue;
-                srcTbl->ensureChildrenLoaded();
-
-                std::vector<Index>* srcIndices = srcTbl->getIndices();
-                if (!srcIndices) continue;
+                size_t object = differences[i].source;
+                objects.push_back(object == SchemaSnapshot::npos
+                    ? DependencyGraph::npos
+                    : graph->findObject(dependencyType, std2wxIdentifier(
+                        source.getObject(object).name, conv)));
+            }
+            std::vector<size_t> order;
+            graph->getCreationOrder(objects, dependencyType == 0
+                ? unsigned(DependencyGraph::kForeignKey)
+                : unsigned(DependencyGraph::kAllFlags), order);
+            std::vector<SchemaSnapshot::Difference> sorted;
+            for (size_t i = 0; i < order.size(); ++i)
+                sorted.push_back(differences[first + order[i]]);
+            std::copy(sorted.begin(), sorted.end(), differences.begin() + first);
+        }
+        first = last;
+    }
+}
 
-                Table* tgtTbl = dynamic_cast<Table*>(targetDb->findRelation(srcTbl->getName_()));
-                if (!tgtTbl) continue;
-                tgtTbl->ensureChildrenLoaded();
+wxString getCreateSql(MetadataItem* item, const wxString& create)
+{
+    CreateDDLVisitor cdv(0);
+    item->acceptVisitor(&cdv);
+    wxString sql = cdv.getSql();
+    if (!create.empty())
+        sql.Replace("CREATE " + create, "CREATE OR ALTER " + create);
+    return sql + "\n";
+}
 
-                std::vector<Index>* tgtIndices = tgtTbl->getIndices();
+} // namespace
 
-                for (auto& idx : *srcIndices)
-                {
-                    if (idx.isSystem()) continue;
-                    bool found = false;
-                    if (tgtIndices)
-                    {
-                        for (auto& ti : *tgtIndices)
-                        {
-                            if (ti.getName_() == idx.getName_())
-                            {
-                                found = true;
-                                break;
-                            }
-                        }
-                    }
-                    if (!found)
-                    {
-                        SchemaDiffItem item;
-                        item.objectType = "Index";
-                        item.objectName = idx.getName_();
-                        item.diffType = SchemaDiffItem::diffMissingInTarget;
-                        item.description = wxString::Format(_("Index '%s' on table '%s' missing in target database"),
-                            idx.getName_().c_str(), srcTbl->getName_().c_str());
+std::vector<SchemaDiffItem> SchemaDiff::compareDatabases(
+    Database* sourceDb, Database* targetDb, const SchemaDiffOptions& options)
+{
+    std::vector<SchemaDiffItem> diffs;
+    if (!sourceDb || !targetDb)
+        return diffs;
 
-                        CreateDDLVisitor cdv(0);
-                        idx.acceptVisitor(&cdv);
-                        item.migrationSql = cdv.getSql() + "\n";
-                        diffs.push_back(item);
-                    }
-                }
-            }
-        }
-    }
+    SchemaSnapshot source, target;
+    readSnapshots(sourceDb, targetDb, options, source, target);
+    std::vector<SchemaSnapshot::Difference> differences;
+    SchemaSnapshot::compare(source, target, differences);
+    sortByDependencies(sourceDb, source, differences);
 
-    // 6. Procedures
-    if (options.compareProcedures)
+    // only the objects that differ are loaded into the metadata model, the
+    // details of all relations at once if there are any of them
+    for (size_t i = 0; i < differences.size(); ++i)
     {
-        ProceduresPtr procs = sourceDb->getProcedures();
-        if (procs)
+        SchemaSnapshot::ObjectType type = differences[i].type;
+        if (type == SchemaSnapshot::otTable || type == SchemaSnapshot::otColumn
+            || type == SchemaSnapshot::otIndex || type == SchemaSnapshot::otView)
         {
-            for (auto it = procs->begin(); it != procs->end(); ++it)
-            {
-                Procedure* p = dynamic_cast<Procedure*>((*it).get());
-                if (!p || p->isSystem()) continue;
-
-                Procedure* tgtP = dynamic_cast<Procedure*>(targetDb->findByName(p->getName_()));
-                if (!tgtP)
-                {
-                    SchemaDiffItem item;
-                    item.objectType = "Procedure";
-                    item.objectName = p->getName_();
-                    item.diffType = SchemaDiffItem::diffMissingInTarget;
-                    item.description = wxString::Format(_("Procedure '%s' missing in target database"), p->getName_().c_str());
-
-                    CreateDDLVisitor cdv(0);
-                    p->acceptVisitor(&cdv);
-                    wxString sql = cdv.getSql();
-                    sql.Replace("CREATE PROCEDURE", "CREATE OR ALTER PROCEDURE");
-                    item.migrationSql = sql + "\n";
-                    diffs.push_back(item);
-                }
-            }
+            sourceDb->loadRelationDetails();
+            targetDb->loadRelationDetails();
+            break;
         }
     }
 
-    // 7. Views
-    if (options.compareViews)
+    wxMBConv* sourceConv = sourceDb->getCharsetConverter();
+    wxMBConv* targetConv = targetDb->getCharsetConverter();
+    for (size_t i = 0; i < differences.size(); ++i)
     {
-        ViewsPtr views = sourceDb->getViews();
-        if (views)
+        const SchemaSnapshot::Difference& diff = differences[i];
+        bool inSource = diff.source != SchemaSnapshot::npos;
+        bool inTarget = diff.target != SchemaSnapshot::npos;
+        const SchemaSnapshot::Object& o = inSource
+            ? source.getObject(diff.source) : target.getObject(diff.target);
+        wxString name(std2wxIdentifier(o.name, inSource ? sourceConv : targetConv));
+
+        SchemaDiffItem item;
+        item.objectName = name;
+        item.diffType = inTarget ? SchemaDiffItem::diffModified
+            : SchemaDiffItem::diffMissingInTarget;
+        switch (diff.type)
         {
-            for (auto it = views->begin(); it != views->end(); ++it)
+            case SchemaSnapshot::otDomain:
             {
-                View* v = dynamic_cast<View*>((*it).get());
-                if (!v || v->isSystem()) continue;
-
-                View* tgtV = dynamic_cast<View*>(targetDb->findRelation(v->getName_()));
-                if (!tgtV)
+                Domain* d = sourceDb->getDomains()->findByName(name).get();
+                if (inTarget || !d)
+                    continue;
+                item.objectType = "Domain";
+                item.description = wxString::Format(_("Domain '%s' missing in target database"), name.c_str());
+                item.migrationSql = wxString::Format("CREATE DOMAIN %s AS %s;\n",
+                    d->getQuotedName().c_str(), d->getDatatypeAsString().c_str());
+                break;
+            }
+            case SchemaSnapshot::otGenerator:
+            {
+                Generator* g = sourceDb->getGenerators()->findByName(name).get();
+                if (inTarget || !g)
+                    continue;
+                item.objectType = "Generator";
+                item.description = wxString::Format(_("Sequence/Generator '%s' missing in target database"), name.c_str());
+                item.migrationSql = wxString::Format("CREATE SEQUENCE %s;\n", g->getQuotedName().c_str());
+                break;
+            }
+            case SchemaSnapshot::otException:
+            {
+                Exception* e = sourceDb->getExceptions()->findByName(name).get();
+                if (inTarget || !e)
+                    continue;
+                item.objectType = "Exception";
+                item.description = wxString::Format(_("Exception '%s' missing in target database"), name.c_str());
+                item.migrationSql = wxString::Format("CREATE EXCEPTION %s '%s';\n",
+                    e->getQuotedName().c_str(), e->getMessage().c_str());
+                break;
+            }
+            case SchemaSnapshot::otTable:
+            {
+                // tables have no definition of their own, so they only
+                // differ if one of the databases doesn't have them
+                Table* t = dynamic_cast<Table*>(sourceDb->findRelation(name));
+                if (!options.compareTables || inTarget || !t)
+                    continue;
+                item.objectType = "Table";
+                item.description = wxString::Format(_("Table '%s' missing in target database"), name.c_str());
+                item.migrationSql = getCreateSql(t, wxEmptyString);
+                break;
+            }
+            case SchemaSnapshot::otColumn:
+            {
+                // only the columns of tables that both databases have
+                if (source.findObject(SchemaSnapshot::otTable, o.parent) == SchemaSnapshot::npos
+                    || target.findObject(SchemaSnapshot::otTable, o.parent) == SchemaSnapshot::npos)
                 {
-                    SchemaDiffItem item;
-                    item.objectType = "View";
-                    item.objectName = v->getName_();
-                    item.diffType = SchemaDiffItem::diffMissingInTarget;
-                    item.description = wxString::Format(_("View '%s' missing in target database"), v->getName_().c_str());
-
-                    CreateDDLVisitor cdv(0);
-                    v->acceptVisitor(&cdv);
-                    wxString sql = cdv.getSql();
-                    sql.Replace("CREATE VIEW", "CREATE OR ALTER VIEW");
-                    item.migrationSql = sql + "\n";
-                    diffs.push_back(item);
+                    continue;
+                }
+                item.objectType = "Column";
+                if (!inSource)
+                {
+                    Table* tgtTbl = dynamic_cast<Table*>(targetDb->findRelation(
+                        std2wxIdentifier(o.parent, targetConv)));
+                    ColumnPtr tgtCol = tgtTbl ? tgtTbl->findColumn(name) : ColumnPtr();
+                    if (!options.generateDropStatements || !tgtCol)
+                        continue;
+                    item.objectName = tgtTbl->getName_() + "." + name;
+                    item.diffType = SchemaDiffItem::diffExtraInTarget;
+                    item.description = wxString::Format(_("Column '%s' in target table '%s' does not exist in source"),
+                        name.c_str(), tgtTbl->getName_().c_str());
+                    item.migrationSql = wxString::Format("ALTER TABLE %s DROP %s;\n",
+                        tgtTbl->getQuotedName().c_str(),
+                        tgtCol->getQuotedName().c_str());
+                    break;
+                }
+                Table* srcTbl = dynamic_cast<Table*>(sourceDb->findRelation(
+                    std2wxIdentifier(o.parent, sourceConv)));
+                ColumnPtr srcCol = srcTbl ? srcTbl->findColumn(name) : ColumnPtr();
+                if (!srcCol)
+                    continue;
+                item.objectName = srcTbl->getName_() + "." + name;
+                if (!inTarget)
+                {
+                    item.description = wxString::Format(_("Column '%s' in table '%s' missing in target database"),
+                        name.c_str(), srcTbl->getName_().c_str());
+                    item.migrationSql = wxString::Format("ALTER TABLE %s ADD %s %s;\n",
+                        srcTbl->getQuotedName().c_str(),
+                        srcCol->getQuotedName().c_str(),
+                        srcCol->getDatatype().c_str());
+                    break;
                 }
+                // the hash includes attributes the datatype doesn't show
+                Table* tgtTbl = dynamic_cast<Table*>(targetDb->findRelation(srcTbl->getName_()));
+                ColumnPtr tgtCol = tgtTbl ? tgtTbl->findColumn(name) : ColumnPtr();
+                if (!tgtCol || srcCol->getDatatype() == tgtCol->getDatatype())
+                    continue;
+                item.description = wxString::Format(_("Column '%s' in table '%s' type mismatch (%s vs %s)"),
+                    name.c_str(), srcTbl->getName_().c_str(),
+                    srcCol->getDatatype().c_str(), tgtCol->getDatatype().c_str());
+                item.migrationSql = wxString::Format("ALTER TABLE %s ALTER COLUMN %s TYPE %s;\n",
+                    srcTbl->getQuotedName().c_str(),
+                    srcCol->getQuotedName().c_str(),
+                    srcCol->getDatatype().c_str());
+                break;
             }
-        }
-    }
-
-    // 8. Triggers
-    if (options.compareTriggers)
-    {
-        DBTriggersPtr triggers = sourceDb->getDBTriggers();
-        if (triggers)
-        {
-            for (auto it = triggers->begin(); it != triggers->end(); ++it)
+            case SchemaSnapshot::otIndex:
             {
-                Trigger* tr = dynamic_cast<Trigger*>((*it).get());
-                if (!tr || tr->isSystem()) continue;
-
-                Trigger* tgtTr = dynamic_cast<Trigger*>(targetDb->findByName(tr->getName_()));
-                if (!tgtTr)
+                // like before only indices missing on tables the target has
+                if (!inSource || inTarget || target.findObject(
+                    SchemaSnapshot::otTable, o.parent) == SchemaSnapshot::npos)
                 {
-                    SchemaDiffItem item;
-                    item.objectType = "Trigger";
-                    item.objectName = tr->getName_();
-                    item.diffType = SchemaDiffItem::diffMissingInTarget;
-                    item.description = wxString::Format(_("Trigger '%s' missing in target database"), tr->getName_().c_str());
-
-                    CreateDDLVisitor cdv(0);
-                    tr->acceptVisitor(&cdv);
-                    wxString sql = cdv.getSql();
-                    sql.Replace("CREATE TRIGGER", "CREATE OR ALTER TRIGGER");
-                    item.migrationSql = sql + "\n";
-                    diffs.push_back(item);
+                    continue;
                 }
+                Table* srcTbl = dynamic_cast<Table*>(sourceDb->findRelation(
+                    std2wxIdentifier(o.parent, sourceConv)));
+                std::vector<Index>* srcIndices = srcTbl ? srcTbl->getIndices() : 0;
+                Index* idx = 0;
+                for (size_t j = 0; srcIndices && j < srcIndices->size() && !idx; ++j)
+                {
+                    if ((*srcIndices)[j].getName_() == name)
+                        idx = &(*srcIndices)[j];
+                }
+                if (!idx)
+                    continue;
+                item.objectType = "Index";
+                item.description = wxString::Format(_("Index '%s' on table '%s' missing in target database"),
+                    name.c_str(), srcTbl->getName_().c_str());
+                item.migrationSql = getCreateSql(idx, wxEmptyString);
+                break;
+            }
+            case SchemaSnapshot::otProcedure:
+            {
+                Procedure* p = inSource ? sourceDb->getProcedures()->findByName(name).get() : 0;
+                if (!p)
+                    continue;
+                item.objectType = "Procedure";
+                item.description = wxString::Format(inTarget
+                    ? _("Procedure '%s' differs in target database")
+                    : _("Procedure '%s' missing in target database"), name.c_str());
+                item.migrationSql = getCreateSql(p, "PROCEDURE");
+                break;
+            }
+            case SchemaSnapshot::otView:
+            {
+                View* v = inSource ? dynamic_cast<View*>(sourceDb->findRelation(name)) : 0;
+                if (!v)
+                    continue;
+                item.objectType = "View";
+                item.description = wxString::Format(inTarget
+                    ? _("View '%s' differs in target database")
+                    : _("View '%s' missing in target database"), name.c_str());
+                item.migrationSql = getCreateSql(v, "VIEW");
+                break;
+            }
+            case SchemaSnapshot::otTrigger:
+            {
+                Trigger* tr = inSource ? sourceDb->getDBTriggers()->findByName(name).get() : 0;
+                if (!tr)
+                    continue;
+                item.objectType = "Trigger";
+                item.description = wxString::Format(inTarget
+                    ? _("Trigger '%s' differs in target database")
+                    : _("Trigger '%s' missing in target database"), name.c_str());
+                item.migrationSql = getCreateSql(tr, "TRIGGER");
+                break;
             }
+            default:
+                continue;
         }
+        diffs.push_back(item);
     }
-
     return diffs;
 }
 
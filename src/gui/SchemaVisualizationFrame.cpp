@@ -65,6 +65,7 @@ static wxString getDatabaseSchemaAsJson(Database* db)
 
     TablesPtr tables = db->getTables();
     tables->ensureChildrenLoaded();
+    db->loadRelationDetails();
 
     bool firstTable = true;
     for (Tables::iterator it = tables->begin(); it != tables->end(); ++it)
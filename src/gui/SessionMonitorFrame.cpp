@@ -33,9 +33,38 @@
 #include "engine/db/ITransaction.h"
 #include "engine/db/IStatement.h"
 
+namespace
+{
+
+// samples read every 5 seconds, the history covers the last 5 minutes
+const int refreshSeconds = 5;
+const size_t historySize = 60;
+
+wxString formatId(int64_t id)
+{
+    return wxString::Format("%lld", (long long)id);
+}
+
+wxString formatRate(const SessionRates& rates, double value)
+{
+    if (!rates.valid)
+        return wxEmptyString;
+    return wxString::Format("%.0f", value);
+}
+
+// records read, inserted, updated and deleted per second
+double getRecordRate(const double* values)
+{
+    double rate = 0;
+    for (int c = SessionCounters::kSeqReads; c <= SessionCounters::kDeletes; ++c)
+        rate += values[c];
+    return rate;
+}
+
+} // namespace
+
 enum {
-    ID_timer_refresh = 3001,
-    ID_button_refresh_now,
+    ID_button_refresh_now = 3001,
     ID_check_auto_refresh,
     ID_list_attachments,
     ID_list_statements,
@@ -45,7 +74,6 @@ enum {
 };
 
 BEGIN_EVENT_TABLE(SessionMonitorFrame, BaseFrame)
-    EVT_TIMER(ID_timer_refresh, SessionMonitorFrame::OnTimer)
     EVT_BUTTON(ID_button_refresh_now, SessionMonitorFrame::OnRefreshClick)
     EVT_CHECKBOX(ID_check_auto_refresh, SessionMonitorFrame::OnAutoRefreshToggle)
     EVT_LIST_ITEM_SELECTED(ID_list_statements, SessionMonitorFrame::OnStatementSelected)
@@ -54,7 +82,8 @@ BEGIN_EVENT_TABLE(SessionMonitorFrame, BaseFrame)
 END_EVENT_TABLE()
 
 SessionMonitorFrame::SessionMonitorFrame(wxWindow* parent, DatabasePtr db)
-    : BaseFrame(parent, -1, wxEmptyString), databasePtrM(db), databaseM(db.get())
+    : BaseFrame(parent, -1, wxEmptyString), databasePtrM(db), databaseM(db.get()),
+        samplerM(historySize)
 {
     if (databaseM)
     {
@@ -89,6 +118,11 @@ SessionMonitorFrame::SessionMonitorFrame(wxWindow* parent, DatabasePtr db)
     list_attachments->InsertColumn(5, _("State"), wxLIST_FORMAT_LEFT, 80);
     list_attachments->InsertColumn(6, _("Connected Since"), wxLIST_FORMAT_LEFT, 150);
     list_attachments->InsertColumn(7, _("Wire Crypt"), wxLIST_FORMAT_LEFT, 100);
+    list_attachments->InsertColumn(8, _("Reads/s"), wxLIST_FORMAT_RIGHT, 80);
+    list_attachments->InsertColumn(9, _("Writes/s"), wxLIST_FORMAT_RIGHT, 80);
+    list_attachments->InsertColumn(10, _("Fetches/s"), wxLIST_FORMAT_RIGHT, 80);
+    list_attachments->InsertColumn(11, _("Peak Fetches/s"), wxLIST_FORMAT_RIGHT, 100);
+    list_attachments->InsertColumn(12, _("Records/s"), wxLIST_FORMAT_RIGHT, 80);
 
     button_disconnect_attachment = new wxButton(panelAttachments, ID_button_disconnect_attachment, _("Disconnect Attachment"));
     sizerAtt->Add(list_attachments, 1, wxEXPAND | wxALL, 4);
@@ -104,7 +138,9 @@ SessionMonitorFrame::SessionMonitorFrame(wxWindow* parent, DatabasePtr db)
     list_statements->InsertColumn(1, _("Attachment ID"), wxLIST_FORMAT_LEFT, 110);
     list_statements->InsertColumn(2, _("State"), wxLIST_FORMAT_LEFT, 80);
     list_statements->InsertColumn(3, _("Started At"), wxLIST_FORMAT_LEFT, 150);
-    list_statements->InsertColumn(4, _("SQL Snippet"), wxLIST_FORMAT_LEFT, 300);
+    list_statements->InsertColumn(4, _("Fetches/s"), wxLIST_FORMAT_RIGHT, 80);
+    list_statements->InsertColumn(5, _("Records/s"), wxLIST_FORMAT_RIGHT, 80);
+    list_statements->InsertColumn(6, _("SQL Snippet"), wxLIST_FORMAT_LEFT, 300);
 
     editor_sql_preview = new SqlEditor(panelStatements, wxID_ANY);
     if (databaseM)
@@ -194,16 +230,12 @@ SessionMonitorFrame::SessionMonitorFrame(wxWindow* parent, DatabasePtr db)
 
     mainPanel->SetSizer(sizerMain);
 
-    timerRefreshM.SetOwner(this, ID_timer_refresh);
-    timerRefreshM.Start(5000); // 5s
-
-    loadMonitoringData();
+    startSampling();
 }
 
 SessionMonitorFrame::~SessionMonitorFrame()
 {
-    if (timerRefreshM.IsRunning())
-        timerRefreshM.Stop();
+    samplerM.stop();
 
     if (databaseM && !databaseM->getIsVolative())
         databaseM->detachObserver(this);
@@ -213,6 +245,7 @@ void SessionMonitorFrame::subjectRemoved(Subject* subject)
 {
     if (subject == databaseM)
     {
+        samplerM.stop();
         databaseM = nullptr;
         databasePtrM.reset();
         Close();
@@ -223,272 +256,234 @@ void SessionMonitorFrame::update()
 {
 }
 
-void SessionMonitorFrame::loadMonitoringData()
+void SessionMonitorFrame::startSampling()
 {
-    attachmentsM.clear();
-    statementsM.clear();
-    transactionsM.clear();
-
     if (!databaseM || !databaseM->isConnected())
         return;
 
     try
     {
-        auto dalDb = databaseM->getDALDatabase();
-        if (!dalDb || !dalDb->isConnected()) return;
-
-        auto tr = dalDb->createTransaction();
-        tr->start();
+        samplerM.setPaused(!check_auto_refresh->IsChecked());
+        samplerM.start(databaseM->createDALConnection(),
+            databaseM->getInfo().isFB40OrHigher(),
+            std::chrono::seconds(refreshSeconds),
+            [this]() { CallAfter(&SessionMonitorFrame::processSample); });
+    }
+    catch (const std::exception& e)
+    {
+        ::wxMessageBox(wxString::FromUTF8(e.what()), _("Monitoring Failed"), wxOK | wxICON_ERROR, this);
+    }
+}
 
-        // 1. Attachments
-        try
-        {
-            auto st = dalDb->createStatement(tr);
-            bool isFb4 = databaseM->getInfo().isFB40OrHigher();
-            if (isFb4)
-            {
-                st->prepare("SELECT MON$ATTACHMENT_ID, MON$STATE, MON$USER, MON$ROLE, MON$REMOTE_ADDRESS, MON$REMOTE_PROCESS, MON$TIMESTAMP, MON$WIRE_CRYPT "
-                            "FROM MON$ATTACHMENTS ORDER BY MON$ATTACHMENT_ID");
-            }
-            else
-            {
-                st->prepare("SELECT MON$ATTACHMENT_ID, MON$STATE, MON$USER, MON$ROLE, MON$REMOTE_ADDRESS, MON$REMOTE_PROCESS, MON$TIMESTAMP "
-                            "FROM MON$ATTACHMENTS ORDER BY MON$ATTACHMENT_ID");
-            }
-            st->execute();
-            while (st->fetch())
-            {
-                SessionAttachmentInfo att;
-                att.id = st->getInt64(0);
-                att.state = st->isNull(1) ? 0 : st->getInt32(1);
-                att.user = wxString::FromUTF8(st->getString(2).c_str());
-                att.role = wxString::FromUTF8(st->getString(3).c_str());
-                att.remoteAddress = wxString::FromUTF8(st->getString(4).c_str());
-                att.remoteProcess = wxString::FromUTF8(st->getString(5).c_str());
-                att.timestamp = wxString::FromUTF8(st->getTimestamp(6).c_str());
-                if (isFb4 && !st->isNull(7))
-                {
-                    att.wireCrypt = st->getBool(7) ? _("Enabled") : _("Disabled");
-                }
-                else
-                {
-                    att.wireCrypt = _("N/A");
-                }
-                attachmentsM.push_back(att);
-            }
-        } catch (...) {}
+void SessionMonitorFrame::processSample()
+{
+    std::shared_ptr<SessionSample> sample = samplerM.takeSample();
+    if (!sample)
+        return;
 
-        // 2. Statements
-        try
-        {
-            auto st = dalDb->createStatement(tr);
-            st->prepare("SELECT MON$STATEMENT_ID, MON$ATTACHMENT_ID, MON$STATE, MON$SQL_TEXT, MON$TIMESTAMP "
-                        "FROM MON$STATEMENTS WHERE MON$SQL_TEXT IS NOT NULL ORDER BY MON$STATEMENT_ID");
-            st->execute();
-            while (st->fetch())
-            {
-                SessionStatementInfo stmt;
-                stmt.id = st->getInt64(0);
-                stmt.attachmentId = st->getInt64(1);
-                stmt.state = st->isNull(2) ? 0 : st->getInt32(2);
-                stmt.sqlText = wxString::FromUTF8(st->getString(3).c_str());
-                stmt.timestamp = wxString::FromUTF8(st->getTimestamp(4).c_str());
-                statementsM.push_back(stmt);
-            }
-        } catch (...) {}
+    updateAttachmentsUI(*sample);
+    updateStatementsUI(*sample);
+    updateTransactionsUI(*sample);
+    updateCompiledStatementsUI(*sample);
+    updateMemoryDiagnosticsUI(*sample);
+    updateConnectionPoolUI(*sample);
+}
 
-        // 3. Transactions
-        try
-        {
-            auto st = dalDb->createStatement(tr);
-            st->prepare("SELECT MON$TRANSACTION_ID, MON$ATTACHMENT_ID, MON$STATE, MON$ISOLATION_MODE, MON$LOCK_TIMEOUT, MON$READ_ONLY, MON$TIMESTAMP "
-                        "FROM MON$TRANSACTIONS ORDER BY MON$TRANSACTION_ID");
-            st->execute();
-            while (st->fetch())
-            {
-                SessionTransactionInfo tx;
-                tx.id = st->getInt64(0);
-                tx.attachmentId = st->getInt64(1);
-                tx.state = st->isNull(2) ? 0 : st->getInt32(2);
-                int iso = st->isNull(3) ? 0 : st->getInt32(3);
-                switch (iso) {
-                    case 0: tx.isolationMode = "Consistency"; break;
-                    case 1: tx.isolationMode = "Concurrency"; break;
-                    case 2: tx.isolationMode = "Read Committed (RV)"; break;
-                    case 3: tx.isolationMode = "Read Committed (NRV)"; break;
-                    default: tx.isolationMode = "Unknown"; break;
-                }
-                tx.lockTimeout = st->isNull(4) ? 0 : st->getInt32(4);
-                tx.readOnly = st->isNull(5) ? false : (st->getInt32(5) != 0);
-                tx.timestamp = wxString::FromUTF8(st->getTimestamp(6).c_str());
-                transactionsM.push_back(tx);
-            }
-        } catch (...) {}
+// only touches the items and cells that changed, so neither the selection
+// nor the scroll position is lost
+void SessionMonitorFrame::updateList(wxListCtrl* list, SessionListRows& shown,
+    std::vector<SessionListRow>& rows)
+{
+    std::vector<SessionListChange> changes;
+    shown.update(rows, changes);
+    if (changes.empty())
+        return;
 
-        // 4. Compiled Statements Cache (MON$COMPILED_STATEMENTS)
-        compiledStatementsM.clear();
-        try
+    list->Freeze();
+    for (size_t i = 0; i < changes.size(); ++i)
+    {
+        const SessionListChange& change = changes[i];
+        if (change.kind == SessionListChange::kDelete)
         {
-            dalDb->getCompiledStatementInfo(compiledStatementsM);
-        } catch (...) {}
-
-        // 5. Memory Usage & Pools
-        memoryUsageM.clear();
-        memoryPoolsM.clear();
-        try
+            list->DeleteItem(change.item);
+            continue;
+        }
+        const SessionListRow& row = shown.getRow(change.row);
+        if (change.kind == SessionListChange::kInsert)
         {
-            dalDb->getMemoryUsageInfo(memoryUsageM);
-            dalDb->getMemoryPoolInfo(memoryPoolsM);
-        } catch (...) {}
-
-        // 6. Connection Pool
-        connPoolsM.clear();
-        try
+            list->InsertItem(change.item, row.cells[0]);
+            for (size_t c = 1; c < row.cells.size(); ++c)
+                list->SetItem(change.item, c, row.cells[c]);
+        }
+        else
         {
-            dalDb->getConnectionPoolInfo(connPoolsM);
-        } catch (...) {}
-
-        tr->commit();
+            for (size_t c = 0; c < change.columns.size(); ++c)
+            {
+                int column = change.columns[c];
+                list->SetItem(change.item, column, row.cells[column]);
+            }
+        }
     }
-    catch (...) {}
-
-    updateAttachmentsUI();
-    updateStatementsUI();
-    updateTransactionsUI();
-    updateCompiledStatementsUI();
-    updateMemoryDiagnosticsUI();
-    updateConnectionPoolUI();
+    list->Thaw();
 }
 
-void SessionMonitorFrame::updateMemoryDiagnosticsUI()
+void SessionMonitorFrame::updateMemoryDiagnosticsUI(const SessionSample& sample)
 {
-    list_memory_pools->DeleteAllItems();
-    for (size_t i = 0; i < memoryPoolsM.size(); ++i)
+    std::vector<SessionListRow> rows(sample.memoryPools.size());
+    for (size_t i = 0; i < sample.memoryPools.size(); ++i)
     {
-        const auto& pool = memoryPoolsM[i];
-        long idx = list_memory_pools->InsertItem(i, wxString::Format("%lld", (long long)pool.poolId));
-        list_memory_pools->SetItem(idx, 1, wxString::Format("%lld", (long long)pool.attachmentId));
-        list_memory_pools->SetItem(idx, 2, wxString::Format("%lld KB", (long long)(pool.memoryAllocated / 1024)));
-        list_memory_pools->SetItem(idx, 3, wxString::Format("%lld KB", (long long)(pool.memoryUsed / 1024)));
-        list_memory_pools->SetItem(idx, 4, wxString::FromUTF8(pool.name.c_str()));
+        const auto& pool = sample.memoryPools[i];
+        std::vector<wxString>& cells = rows[i].cells;
+        rows[i].id = pool.poolId;
+        cells.push_back(formatId(pool.poolId));
+        cells.push_back(formatId(pool.attachmentId));
+        cells.push_back(wxString::Format("%lld KB", (long long)(pool.memoryAllocated / 1024)));
+        cells.push_back(wxString::Format("%lld KB", (long long)(pool.memoryUsed / 1024)));
+        cells.push_back(wxString::FromUTF8(pool.name.c_str()));
     }
+    updateList(list_memory_pools, memoryPoolRowsM, rows);
 
-    list_memory_usage->DeleteAllItems();
-    for (size_t i = 0; i < memoryUsageM.size(); ++i)
+    rows.assign(sample.memoryUsage.size(), SessionListRow());
+    for (size_t i = 0; i < sample.memoryUsage.size(); ++i)
     {
-        const auto& mem = memoryUsageM[i];
-        long idx = list_memory_usage->InsertItem(i, wxString::Format("%lld", (long long)mem.memoryId));
-        list_memory_usage->SetItem(idx, 1, wxString::Format("%d", mem.statGroup));
-        list_memory_usage->SetItem(idx, 2, wxString::Format("%lld KB", (long long)(mem.memoryAllocated / 1024)));
-        list_memory_usage->SetItem(idx, 3, wxString::Format("%lld KB", (long long)(mem.memoryUsed / 1024)));
-        list_memory_usage->SetItem(idx, 4, wxString::Format("%lld KB", (long long)(mem.maxAllocated / 1024)));
-        list_memory_usage->SetItem(idx, 5, wxString::Format("%lld KB", (long long)(mem.maxUsed / 1024)));
+        const auto& mem = sample.memoryUsage[i];
+        std::vector<wxString>& cells = rows[i].cells;
+        rows[i].id = mem.memoryId;
+        cells.push_back(formatId(mem.memoryId));
+        cells.push_back(wxString::Format("%d", mem.statGroup));
+        cells.push_back(wxString::Format("%lld KB", (long long)(mem.memoryAllocated / 1024)));
+        cells.push_back(wxString::Format("%lld KB", (long long)(mem.memoryUsed / 1024)));
+        cells.push_back(wxString::Format("%lld KB", (long long)(mem.maxAllocated / 1024)));
+        cells.push_back(wxString::Format("%lld KB", (long long)(mem.maxUsed / 1024)));
     }
+    updateList(list_memory_usage, memoryUsageRowsM, rows);
 }
 
-void SessionMonitorFrame::updateConnectionPoolUI()
+void SessionMonitorFrame::updateConnectionPoolUI(const SessionSample& sample)
 {
-    list_connection_pools->DeleteAllItems();
-    for (size_t i = 0; i < connPoolsM.size(); ++i)
+    std::vector<SessionListRow> rows(sample.connPools.size());
+    for (size_t i = 0; i < sample.connPools.size(); ++i)
     {
-        const auto& pool = connPoolsM[i];
-        long idx = list_connection_pools->InsertItem(i, wxString::Format("%lld", (long long)pool.poolId));
-        list_connection_pools->SetItem(idx, 1, wxString::FromUTF8(pool.dbName.c_str()));
-        list_connection_pools->SetItem(idx, 2, wxString::Format("%d", pool.activeConnections));
-        list_connection_pools->SetItem(idx, 3, wxString::Format("%d", pool.idleConnections));
-        list_connection_pools->SetItem(idx, 4, wxString::Format("%d", pool.maxConnections));
-        list_connection_pools->SetItem(idx, 5, wxString::Format("%d", pool.minConnections));
-        list_connection_pools->SetItem(idx, 6, wxString::Format("%d", pool.waitingRequests));
+        const auto& pool = sample.connPools[i];
+        std::vector<wxString>& cells = rows[i].cells;
+        rows[i].id = pool.poolId;
+        cells.push_back(formatId(pool.poolId));
+        cells.push_back(wxString::FromUTF8(pool.dbName.c_str()));
+        cells.push_back(wxString::Format("%d", pool.activeConnections));
+        cells.push_back(wxString::Format("%d", pool.idleConnections));
+        cells.push_back(wxString::Format("%d", pool.maxConnections));
+        cells.push_back(wxString::Format("%d", pool.minConnections));
+        cells.push_back(wxString::Format("%d", pool.waitingRequests));
     }
+    updateList(list_connection_pools, connPoolRowsM, rows);
 }
 
-void SessionMonitorFrame::updateAttachmentsUI()
+void SessionMonitorFrame::updateAttachmentsUI(const SessionSample& sample)
 {
-    list_attachments->DeleteAllItems();
+    attachmentsM = sample.attachments;
+    std::vector<SessionListRow> rows(attachmentsM.size());
     for (size_t i = 0; i < attachmentsM.size(); ++i)
     {
         const auto& att = attachmentsM[i];
-        long idx = list_attachments->InsertItem(i, wxString::Format("%lld", (long long)att.id));
-        list_attachments->SetItem(idx, 1, att.user);
-        list_attachments->SetItem(idx, 2, att.role);
-        list_attachments->SetItem(idx, 3, att.remoteAddress);
-        list_attachments->SetItem(idx, 4, att.remoteProcess);
-        list_attachments->SetItem(idx, 5, att.state == 1 ? _("Active") : _("Idle"));
-        list_attachments->SetItem(idx, 6, att.timestamp);
-        list_attachments->SetItem(idx, 7, att.wireCrypt.IsEmpty() ? _("N/A") : att.wireCrypt);
+        const double* rates = att.rates.perSecond;
+        std::vector<wxString>& cells = rows[i].cells;
+        rows[i].id = att.id;
+        cells.push_back(formatId(att.id));
+        cells.push_back(att.user);
+        cells.push_back(att.role);
+        cells.push_back(att.remoteAddress);
+        cells.push_back(att.remoteProcess);
+        cells.push_back(att.state == 1 ? _("Active") : _("Idle"));
+        cells.push_back(att.timestamp);
+        if (att.wireCrypt < 0)
+            cells.push_back(_("N/A"));
+        else
+            cells.push_back(att.wireCrypt ? _("Enabled") : _("Disabled"));
+        cells.push_back(formatRate(att.rates, rates[SessionCounters::kPageReads]));
+        cells.push_back(formatRate(att.rates, rates[SessionCounters::kPageWrites]));
+        cells.push_back(formatRate(att.rates, rates[SessionCounters::kPageFetches]));
+        cells.push_back(formatRate(att.rates, att.rates.peak[SessionCounters::kPageFetches]));
+        cells.push_back(formatRate(att.rates, getRecordRate(rates)));
     }
+    updateList(list_attachments, attachmentRowsM, rows);
 }
 
-void SessionMonitorFrame::updateStatementsUI()
+void SessionMonitorFrame::updateStatementsUI(const SessionSample& sample)
 {
-    list_statements->DeleteAllItems();
+    statementsM = sample.statements;
+    std::vector<SessionListRow> rows(statementsM.size());
     for (size_t i = 0; i < statementsM.size(); ++i)
     {
         const auto& stmt = statementsM[i];
-        long idx = list_statements->InsertItem(i, wxString::Format("%lld", (long long)stmt.id));
-        list_statements->SetItem(idx, 1, wxString::Format("%lld", (long long)stmt.attachmentId));
-        list_statements->SetItem(idx, 2, stmt.state == 1 ? _("Active") : _("Idle"));
-        list_statements->SetItem(idx, 3, stmt.timestamp);
-        list_statements->SetItem(idx, 4, stmt.sqlText.Mid(0, 80));
+        const double* rates = stmt.rates.perSecond;
+        std::vector<wxString>& cells = rows[i].cells;
+        rows[i].id = stmt.id;
+        cells.push_back(formatId(stmt.id));
+        cells.push_back(formatId(stmt.attachmentId));
+        cells.push_back(stmt.state == 1 ? _("Active") : _("Idle"));
+        cells.push_back(stmt.timestamp);
+        cells.push_back(formatRate(stmt.rates, rates[SessionCounters::kPageFetches]));
+        cells.push_back(formatRate(stmt.rates, getRecordRate(rates)));
+        cells.push_back(stmt.sqlText.Mid(0, 80));
     }
+    updateList(list_statements, statementRowsM, rows);
 }
 
-void SessionMonitorFrame::updateTransactionsUI()
+void SessionMonitorFrame::updateTransactionsUI(const SessionSample& sample)
 {
-    list_transactions->DeleteAllItems();
-    for (size_t i = 0; i < transactionsM.size(); ++i)
+    std::vector<SessionListRow> rows(sample.transactions.size());
+    for (size_t i = 0; i < sample.transactions.size(); ++i)
     {
-        const auto& tx = transactionsM[i];
-        long idx = list_transactions->InsertItem(i, wxString::Format("%lld", (long long)tx.id));
-        list_transactions->SetItem(idx, 1, wxString::Format("%lld", (long long)tx.attachmentId));
-        list_transactions->SetItem(idx, 2, tx.state == 1 ? _("Active") : _("Idle"));
-        list_transactions->SetItem(idx, 3, tx.isolationMode);
-        list_transactions->SetItem(idx, 4, wxString::Format("%d", tx.lockTimeout));
-        list_transactions->SetItem(idx, 5, tx.readOnly ? _("Yes") : _("No"));
-        list_transactions->SetItem(idx, 6, tx.timestamp);
+        const auto& tx = sample.transactions[i];
+        wxString isolationMode;
+        switch (tx.isolationMode) {
+            case 0: isolationMode = "Consistency"; break;
+            case 1: isolationMode = "Concurrency"; break;
+            case 2: isolationMode = "Read Committed (RV)"; break;
+            case 3: isolationMode = "Read Committed (NRV)"; break;
+            default: isolationMode = "Unknown"; break;
+        }
+        std::vector<wxString>& cells = rows[i].cells;
+        rows[i].id = tx.id;
+        cells.push_back(formatId(tx.id));
+        cells.push_back(formatId(tx.attachmentId));
+        cells.push_back(tx.state == 1 ? _("Active") : _("Idle"));
+        cells.push_back(isolationMode);
+        cells.push_back(wxString::Format("%d", tx.lockTimeout));
+        cells.push_back(tx.readOnly ? _("Yes") : _("No"));
+        cells.push_back(tx.timestamp);
     }
+    updateList(list_transactions, transactionRowsM, rows);
 }
 
-void SessionMonitorFrame::updateCompiledStatementsUI()
+void SessionMonitorFrame::updateCompiledStatementsUI(const SessionSample& sample)
 {
-    list_compiled_statements->DeleteAllItems();
-    for (size_t i = 0; i < compiledStatementsM.size(); ++i)
+    std::vector<SessionListRow> rows(sample.compiledStatements.size());
+    for (size_t i = 0; i < sample.compiledStatements.size(); ++i)
     {
-        const auto& cs = compiledStatementsM[i];
-        long idx = list_compiled_statements->InsertItem(i, wxString::Format("%lld", (long long)cs.id));
-        list_compiled_statements->SetItem(idx, 1, wxString::Format("%d", cs.cacheHit));
-        list_compiled_statements->SetItem(idx, 2, wxString::Format("%d", cs.cacheMiss));
+        const auto& cs = sample.compiledStatements[i];
+        std::vector<wxString>& cells = rows[i].cells;
+        rows[i].id = cs.id;
+        cells.push_back(formatId(cs.id));
+        cells.push_back(wxString::Format("%d", cs.cacheHit));
+        cells.push_back(wxString::Format("%d", cs.cacheMiss));
 
         double total = cs.cacheHit + cs.cacheMiss;
         double ratio = (total > 0) ? ((double)cs.cacheHit / total * 100.0) : 0.0;
-        list_compiled_statements->SetItem(idx, 3, wxString::Format("%.1f%%", ratio));
-        list_compiled_statements->SetItem(idx, 4, wxString::FromUTF8(cs.sqlText.c_str()).Mid(0, 100));
+        cells.push_back(wxString::Format("%.1f%%", ratio));
+        cells.push_back(wxString::FromUTF8(cs.sqlText.c_str()).Mid(0, 100));
     }
-}
-
-void SessionMonitorFrame::OnTimer(wxTimerEvent& WXUNUSED(event))
-{
-    if (check_auto_refresh->IsChecked())
-        loadMonitoringData();
+    updateList(list_compiled_statements, compiledStatementRowsM, rows);
 }
 
 void SessionMonitorFrame::OnRefreshClick(wxCommandEvent& WXUNUSED(event))
 {
-    loadMonitoringData();
+    samplerM.requestSample();
 }
 
 void SessionMonitorFrame::OnAutoRefreshToggle(wxCommandEvent& WXUNUSED(event))
 {
-    if (check_auto_refresh->IsChecked())
-    {
-        if (!timerRefreshM.IsRunning())
-            timerRefreshM.Start(5000);
-    }
-    else
-    {
-        if (timerRefreshM.IsRunning())
-            timerRefreshM.Stop();
-    }
+    samplerM.setPaused(!check_auto_refresh->IsChecked());
 }
 
 void SessionMonitorFrame::OnStatementSelected(wxListEvent& event)
@@ -529,7 +524,7 @@ void SessionMonitorFrame::OnCancelStatementClick(wxCommandEvent& WXUNUSED(event)
         tr->commit();
 
         ::wxMessageBox(_("Statement cancel signal sent successfully."), _("Query Cancelled"), wxOK | wxICON_INFORMATION, this);
-        loadMonitoringData();
+        samplerM.requestSample();
     }
     catch (const std::exception& e)
     {
@@ -566,7 +561,7 @@ void SessionMonitorFrame::OnDisconnectAttachmentClick(wxCommandEvent& WXUNUSED(e
         tr->commit();
 
         ::wxMessageBox(_("Disconnect signal sent successfully."), _("Attachment Disconnected"), wxOK | wxICON_INFORMATION, this);
-        loadMonitoringData();
+        samplerM.requestSample();
     }
     catch (const std::exception& e)
     {
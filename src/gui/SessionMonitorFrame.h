@@ -27,53 +27,21 @@
 #include <wx/wx.h>
 #include <wx/listctrl.h>
 #include <wx/notebook.h>
-#include <wx/timer.h>
 #include <vector>
 
 #include "gui/BaseFrame.h"
+#include "gui/SessionMonitorSampler.h"
 #include "core/Observer.h"
 #include "metadata/database.h"
 
 class SqlEditor;
 
-struct SessionAttachmentInfo
-{
-    int64_t id;
-    int state;
-    wxString user;
-    wxString role;
-    wxString remoteAddress;
-    wxString remoteProcess;
-    wxString timestamp;
-    wxString wireCrypt;
-};
-
-struct SessionStatementInfo
-{
-    int64_t id;
-    int64_t attachmentId;
-    int state;
-    wxString sqlText;
-    wxString timestamp;
-};
-
-struct SessionTransactionInfo
-{
-    int64_t id;
-    int64_t attachmentId;
-    int state;
-    wxString isolationMode;
-    int lockTimeout;
-    bool readOnly;
-    wxString timestamp;
-};
-
 class SessionMonitorFrame: public BaseFrame, public Observer
 {
 private:
     DatabasePtr databasePtrM;
     Database* databaseM;
-    wxTimer timerRefreshM;
+    SessionMonitorSampler samplerM;
 
     wxNotebook* notebookM;
 
@@ -81,33 +49,35 @@ private:
     wxListCtrl* list_attachments;
     wxButton* button_disconnect_attachment;
     std::vector<SessionAttachmentInfo> attachmentsM;
+    SessionListRows attachmentRowsM;
 
     // Statements tab
     wxListCtrl* list_statements;
     SqlEditor* editor_sql_preview;
     wxButton* button_cancel_statement;
     std::vector<SessionStatementInfo> statementsM;
+    SessionListRows statementRowsM;
 
     // Transactions tab
     wxListCtrl* list_transactions;
-    std::vector<SessionTransactionInfo> transactionsM;
+    SessionListRows transactionRowsM;
 
     // Compiled Statements Cache tab
     wxPanel* panelCompiledStatements;
     wxListCtrl* list_compiled_statements;
-    std::vector<fr::CompiledStatementInfo> compiledStatementsM;
+    SessionListRows compiledStatementRowsM;
 
     // Memory Diagnostics tab (MON$MEMORY_USAGE & MON$POOLS)
     wxPanel* panelMemoryDiagnostics;
     wxListCtrl* list_memory_usage;
     wxListCtrl* list_memory_pools;
-    std::vector<fr::MemoryUsageInfo> memoryUsageM;
-    std::vector<fr::MemoryPoolInfo> memoryPoolsM;
+    SessionListRows memoryUsageRowsM;
+    SessionListRows memoryPoolRowsM;
 
     // Connection Pool tab
     wxPanel* panelConnectionPool;
     wxListCtrl* list_connection_pools;
-    std::vector<fr::ConnectionPoolInfo> connPoolsM;
+    SessionListRows connPoolRowsM;
 
     wxCheckBox* check_auto_refresh;
     wxButton* button_refresh_now;
@@ -116,15 +86,17 @@ private:
     virtual void subjectRemoved(Subject* subject) override;
     virtual void update() override;
 
-    void loadMonitoringData();
-    void updateAttachmentsUI();
-    void updateStatementsUI();
-    void updateTransactionsUI();
-    void updateCompiledStatementsUI();
-    void updateMemoryDiagnosticsUI();
-    void updateConnectionPoolUI();
+    void startSampling();
+    void processSample();
+    void updateList(wxListCtrl* list, SessionListRows& shown,
+        std::vector<SessionListRow>& rows);
+    void updateAttachmentsUI(const SessionSample& sample);
+    void updateStatementsUI(const SessionSample& sample);
+    void updateTransactionsUI(const SessionSample& sample);
+    void updateCompiledStatementsUI(const SessionSample& sample);
+    void updateMemoryDiagnosticsUI(const SessionSample& sample);
+    void updateConnectionPoolUI(const SessionSample& sample);
 
-    void OnTimer(wxTimerEvent& event);
     void OnRefreshClick(wxCommandEvent& event);
     void OnAutoRefreshToggle(wxCommandEvent& event);
     void OnStatementSelected(wxListEvent& event);
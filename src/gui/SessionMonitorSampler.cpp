@@ -0,0 +1,497 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+
+#include "engine/db/IDatabase.h"
+#include "engine/db/IStatement.h"
+#include "engine/db/ITransaction.h"
+#include "gui/SessionMonitorSampler.h"
+
+namespace
+{
+
+// the columns of MON$IO_STATS and MON$RECORD_STATS in the order of
+// SessionCounters::Counter, io and rec being the aliases of the tables
+const char* const countersSql =
+    "io.MON$PAGE_READS, io.MON$PAGE_WRITES, io.MON$PAGE_FETCHES, "
+    "io.MON$PAGE_MARKS, rec.MON$RECORD_SEQ_READS, rec.MON$RECORD_IDX_READS, "
+    "rec.MON$RECORD_INSERTS, rec.MON$RECORD_UPDATES, rec.MON$RECORD_DELETES";
+
+std::string statsJoinSql(const std::string& alias)
+{
+    return " LEFT JOIN MON$IO_STATS io ON io.MON$STAT_ID = " + alias
+        + ".MON$STAT_ID LEFT JOIN MON$RECORD_STATS rec ON rec.MON$STAT_ID = "
+        + alias + ".MON$STAT_ID";
+}
+
+void readCounters(fr::IStatement& st, int first, SessionCounters& counters)
+{
+    for (int i = 0; i < SessionCounters::counterCount; ++i)
+    {
+        counters.values[i] = st.isNull(first + i) ? 0
+            : st.getInt64(first + i);
+    }
+}
+
+wxString readString(fr::IStatement& st, int index)
+{
+    return wxString::FromUTF8(st.getString(index).c_str());
+}
+
+void clearRates(SessionRates& rates)
+{
+    rates.valid = false;
+    std::fill(rates.perSecond, rates.perSecond + SessionCounters::counterCount, 0.0);
+    std::fill(rates.peak, rates.peak + SessionCounters::counterCount, 0.0);
+}
+
+// counters only grow, unless an id has been reused
+double getRate(int64_t from, int64_t to, double seconds)
+{
+    return (to > from && seconds > 0) ? double(to - from) / seconds : 0.0;
+}
+
+template<typename T>
+void sortById(std::vector<T>& items, int64_t T::*id)
+{
+    std::sort(items.begin(), items.end(),
+        [id](const T& a, const T& b) { return a.*id < b.*id; });
+}
+
+} // namespace
+
+SessionMonitorHistory::SessionMonitorHistory(size_t capacity)
+    : pointsM(std::max<size_t>(capacity, 2)), firstM(0), countM(0)
+{
+}
+
+void SessionMonitorHistory::clear()
+{
+    firstM = 0;
+    countM = 0;
+}
+
+size_t SessionMonitorHistory::getCapacity() const
+{
+    return pointsM.size();
+}
+
+size_t SessionMonitorHistory::getCount() const
+{
+    return countM;
+}
+
+// the sample index, the oldest being 0
+const SessionMonitorHistory::Point& SessionMonitorHistory::getPoint(
+    size_t index) const
+{
+    return pointsM[(firstM + index) % pointsM.size()];
+}
+
+const SessionCounters* SessionMonitorHistory::find(const Entries& entries,
+    int64_t id)
+{
+    Entries::const_iterator it = std::lower_bound(entries.begin(),
+        entries.end(), id,
+        [](const Entries::value_type& e, int64_t value) { return e.first < value; });
+    if (it == entries.end() || it->first != id)
+        return nullptr;
+    return &it->second;
+}
+
+void SessionMonitorHistory::add(double time, Entries& attachments,
+    Entries& statements)
+{
+    size_t index;
+    if (countM < pointsM.size())
+        index = (firstM + countM++) % pointsM.size();
+    else
+    {
+        index = firstM;
+        firstM = (firstM + 1) % pointsM.size();
+    }
+    // swapping keeps the memory of the dropped sample for the next one
+    Point& p = pointsM[index];
+    p.time = time;
+    p.entries[kAttachments].swap(attachments);
+    p.entries[kStatements].swap(statements);
+    attachments.clear();
+    statements.clear();
+}
+
+bool SessionMonitorHistory::getRates(Kind kind, int64_t id,
+    SessionRates& rates) const
+{
+    clearRates(rates);
+    const SessionCounters* previous = nullptr;
+    double previousTime = 0;
+    for (size_t i = 0; i < countM; ++i)
+    {
+        const Point& p = getPoint(i);
+        const SessionCounters* current = find(p.entries[kind], id);
+        if (current && previous)
+        {
+            double seconds = p.time - previousTime;
+            for (int c = 0; c < SessionCounters::counterCount; ++c)
+            {
+                double rate = getRate(previous->values[c], current->values[c],
+                    seconds);
+                rates.peak[c] = std::max(rates.peak[c], rate);
+                if (i == countM - 1)
+                    rates.perSecond[c] = rate;
+            }
+            rates.valid = (i == countM - 1);
+        }
+        previous = current;
+        previousTime = p.time;
+    }
+    return rates.valid;
+}
+
+void SessionMonitorHistory::getSeries(Kind kind, int64_t id,
+    SessionCounters::Counter counter, std::vector<double>& rates) const
+{
+    rates.clear();
+    for (size_t i = 1; i < countM; ++i)
+    {
+        const Point& from = getPoint(i - 1);
+        const Point& to = getPoint(i);
+        const SessionCounters* c1 = find(from.entries[kind], id);
+        const SessionCounters* c2 = find(to.entries[kind], id);
+        rates.push_back(c1 && c2 ? getRate(c1->values[counter],
+            c2->values[counter], to.time - from.time) : 0.0);
+    }
+}
+
+size_t SessionListRows::getCount() const
+{
+    return rowsM.size();
+}
+
+const SessionListRow& SessionListRows::getRow(size_t index) const
+{
+    return rowsM[index];
+}
+
+void SessionListRows::update(std::vector<SessionListRow>& rows,
+    std::vector<SessionListChange>& changes)
+{
+    changes.clear();
+    // merge the old and the new rows by id, item is the index the next
+    // new row gets in the list
+    size_t oldRow = 0, newRow = 0;
+    long item = 0;
+    while (oldRow < rowsM.size() || newRow < rows.size())
+    {
+        SessionListChange change;
+        change.row = newRow;
+        if (newRow == rows.size()
+            || (oldRow < rowsM.size() && rowsM[oldRow].id < rows[newRow].id))
+        {
+            change.kind = SessionListChange::kDelete;
+            change.item = item;
+            ++oldRow;
+            changes.push_back(change);
+            continue;
+        }
+        if (oldRow == rowsM.size() || rows[newRow].id < rowsM[oldRow].id)
+        {
+            change.kind = SessionListChange::kInsert;
+            change.item = item++;
+            ++newRow;
+            changes.push_back(change);
+            continue;
+        }
+
+        const std::vector<wxString>& oldCells = rowsM[oldRow].cells;
+        const std::vector<wxString>& newCells = rows[newRow].cells;
+        change.kind = SessionListChange::kUpdate;
+        change.item = item++;
+        for (size_t c = 0; c < newCells.size(); ++c)
+        {
+            if (c >= oldCells.size() || oldCells[c] != newCells[c])
+                change.columns.push_back(int(c));
+        }
+        if (!change.columns.empty())
+            changes.push_back(change);
+        ++oldRow;
+        ++newRow;
+    }
+    rowsM.swap(rows);
+}
+
+SessionMonitorSampler::SessionMonitorSampler(size_t historySize)
+    : hasWireCryptM(false), intervalM(0), historyM(historySize),
+        stopM(false), pausedM(false), requestedM(false), samplingM(false)
+{
+}
+
+SessionMonitorSampler::~SessionMonitorSampler()
+{
+    stop();
+}
+
+void SessionMonitorSampler::start(fr::IDatabasePtr database,
+    bool hasWireCrypt, std::chrono::milliseconds interval,
+    std::function<void()> notify)
+{
+    stop();
+    databaseM = database;
+    hasWireCryptM = hasWireCrypt;
+    intervalM = interval;
+    notifyM = notify;
+    historyM.clear();
+    startM = std::chrono::steady_clock::now();
+    stopM = false;
+    requestedM = true;
+    threadM = std::thread(&SessionMonitorSampler::run, this);
+}
+
+void SessionMonitorSampler::stop()
+{
+    if (!threadM.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutexM);
+        stopM = true;
+        if (samplingM)
+        {
+            try
+            {
+                databaseM->cancelOperation();
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+    wakeM.notify_all();
+    threadM.join();
+
+    try
+    {
+        databaseM->disconnect();
+    }
+    catch (...)
+    {
+    }
+    databaseM.reset();
+}
+
+void SessionMonitorSampler::setPaused(bool paused)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutexM);
+        pausedM = paused;
+    }
+    wakeM.notify_all();
+}
+
+void SessionMonitorSampler::requestSample()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutexM);
+        requestedM = true;
+    }
+    wakeM.notify_all();
+}
+
+std::shared_ptr<SessionSample> SessionMonitorSampler::takeSample()
+{
+    std::lock_guard<std::mutex> lock(mutexM);
+    std::shared_ptr<SessionSample> sample;
+    sample.swap(sampleM);
+    return sample;
+}
+
+void SessionMonitorSampler::run()
+{
+    std::unique_lock<std::mutex> lock(mutexM);
+    while (!stopM)
+    {
+        if (requestedM || !pausedM)
+        {
+            requestedM = false;
+            samplingM = true;
+            lock.unlock();
+
+            std::shared_ptr<SessionSample> sample(new SessionSample);
+            sample->time = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - startM).count();
+            bool ok = true;
+            try
+            {
+                read(*sample);
+                addToHistory(*sample);
+            }
+            catch (...)
+            {
+                // the attachment is gone, or the sample was cancelled
+                ok = false;
+            }
+
+            lock.lock();
+            samplingM = false;
+            if (ok && !stopM)
+            {
+                sampleM = sample;
+                lock.unlock();
+                notifyM();
+                lock.lock();
+            }
+        }
+        auto wakeUp = [this]() { return stopM || requestedM; };
+        if (pausedM)
+            wakeM.wait(lock, wakeUp);
+        else
+            wakeM.wait_for(lock, intervalM, wakeUp);
+    }
+}
+
+void SessionMonitorSampler::read(SessionSample& sample)
+{
+    fr::ITransactionPtr tr = databaseM->createTransaction();
+    tr->setAccessMode(fr::TransactionAccessMode::Read);
+    tr->start();
+
+    // every table on its own, a server that lacks one of them still gets
+    // the others monitored
+    try
+    {
+        fr::IStatementPtr st = databaseM->createStatement(tr);
+        st->prepare(std::string("SELECT a.MON$ATTACHMENT_ID, a.MON$STATE, "
+            "a.MON$USER, a.MON$ROLE, a.MON$REMOTE_ADDRESS, "
+            "a.MON$REMOTE_PROCESS, a.MON$TIMESTAMP, ")
+            + (hasWireCryptM ? "a.MON$WIRE_CRYPT, " : "CAST(NULL AS INTEGER), ")
+            + countersSql
+            + " FROM MON$ATTACHMENTS a" + statsJoinSql("a")
+            + " ORDER BY a.MON$ATTACHMENT_ID");
+        st->execute();
+        while (st->fetch())
+        {
+            SessionAttachmentInfo att;
+            att.id = st->getInt64(0);
+            att.state = st->isNull(1) ? 0 : st->getInt32(1);
+            att.user = readString(*st, 2);
+            att.role = readString(*st, 3);
+            att.remoteAddress = readString(*st, 4);
+            att.remoteProcess = readString(*st, 5);
+            att.timestamp = wxString::FromUTF8(st->getTimestamp(6).c_str());
+            att.wireCrypt = st->isNull(7) ? -1 : (st->getBool(7) ? 1 : 0);
+            readCounters(*st, 8, att.counters);
+            sample.attachments.push_back(att);
+        }
+    } catch (...) {}
+
+    try
+    {
+        fr::IStatementPtr st = databaseM->createStatement(tr);
+        st->prepare(std::string("SELECT s.MON$STATEMENT_ID, "
+            "s.MON$ATTACHMENT_ID, s.MON$STATE, s.MON$SQL_TEXT, "
+            "s.MON$TIMESTAMP, ") + countersSql
+            + " FROM MON$STATEMENTS s" + statsJoinSql("s")
+            + " WHERE s.MON$SQL_TEXT IS NOT NULL ORDER BY s.MON$STATEMENT_ID");
+        st->execute();
+        while (st->fetch())
+        {
+            SessionStatementInfo stmt;
+            stmt.id = st->getInt64(0);
+            stmt.attachmentId = st->getInt64(1);
+            stmt.state = st->isNull(2) ? 0 : st->getInt32(2);
+            stmt.sqlText = readString(*st, 3);
+            stmt.timestamp = wxString::FromUTF8(st->getTimestamp(4).c_str());
+            readCounters(*st, 5, stmt.counters);
+            sample.statements.push_back(stmt);
+        }
+    } catch (...) {}
+
+    try
+    {
+        fr::IStatementPtr st = databaseM->createStatement(tr);
+        st->prepare("SELECT MON$TRANSACTION_ID, MON$ATTACHMENT_ID, MON$STATE, "
+            "MON$ISOLATION_MODE, MON$LOCK_TIMEOUT, MON$READ_ONLY, "
+            "MON$TIMESTAMP FROM MON$TRANSACTIONS ORDER BY MON$TRANSACTION_ID");
+        st->execute();
+        while (st->fetch())
+        {
+            SessionTransactionInfo tx;
+            tx.id = st->getInt64(0);
+            tx.attachmentId = st->getInt64(1);
+            tx.state = st->isNull(2) ? 0 : st->getInt32(2);
+            tx.isolationMode = st->isNull(3) ? -1 : st->getInt32(3);
+            tx.lockTimeout = st->isNull(4) ? 0 : st->getInt32(4);
+            tx.readOnly = st->isNull(5) ? false : (st->getInt32(5) != 0);
+            tx.timestamp = wxString::FromUTF8(st->getTimestamp(6).c_str());
+            sample.transactions.push_back(tx);
+        }
+    } catch (...) {}
+
+    try
+    {
+        databaseM->getCompiledStatementInfo(sample.compiledStatements);
+        sortById(sample.compiledStatements, &fr::CompiledStatementInfo::id);
+    } catch (...) {}
+
+    try
+    {
+        databaseM->getMemoryUsageInfo(sample.memoryUsage);
+        sortById(sample.memoryUsage, &fr::MemoryUsageInfo::memoryId);
+        databaseM->getMemoryPoolInfo(sample.memoryPools);
+        sortById(sample.memoryPools, &fr::MemoryPoolInfo::poolId);
+    } catch (...) {}
+
+    try
+    {
+        databaseM->getConnectionPoolInfo(sample.connPools);
+        sortById(sample.connPools, &fr::ConnectionPoolInfo::poolId);
+    } catch (...) {}
+
+    tr->commit();
+}
+
+void SessionMonitorSampler::addToHistory(SessionSample& sample)
+{
+    SessionMonitorHistory::Entries attachments, statements;
+    attachments.reserve(sample.attachments.size());
+    for (const SessionAttachmentInfo& att : sample.attachments)
+        attachments.push_back(std::make_pair(att.id, att.counters));
+    statements.reserve(sample.statements.size());
+    for (const SessionStatementInfo& stmt : sample.statements)
+        statements.push_back(std::make_pair(stmt.id, stmt.counters));
+    historyM.add(sample.time, attachments, statements);
+
+    for (SessionAttachmentInfo& att : sample.attachments)
+        historyM.getRates(SessionMonitorHistory::kAttachments, att.id, att.rates);
+    for (SessionStatementInfo& stmt : sample.statements)
+        historyM.getRates(SessionMonitorHistory::kStatements, stmt.id, stmt.rates);
+}
@@ -0,0 +1,237 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_SESSIONMONITORSAMPLER_H
+#define FR_SESSIONMONITORSAMPLER_H
+
+#include <wx/string.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "engine/db/DatabaseBackend.h"
+
+namespace fr
+{
+    class IDatabase;
+    typedef std::shared_ptr<IDatabase> IDatabasePtr;
+}
+
+// the counters of MON$IO_STATS and MON$RECORD_STATS of an attachment or a
+// statement
+struct SessionCounters
+{
+    enum Counter { kPageReads, kPageWrites, kPageFetches, kPageMarks,
+        kSeqReads, kIdxReads, kInserts, kUpdates, kDeletes, counterCount };
+    int64_t values[counterCount];
+};
+
+// how fast the counters grew between the last two samples and the most
+// they grew between two samples of the history, per second
+struct SessionRates
+{
+    bool valid;
+    double perSecond[SessionCounters::counterCount];
+    double peak[SessionCounters::counterCount];
+};
+
+struct SessionAttachmentInfo
+{
+    int64_t id;
+    int state;
+    wxString user;
+    wxString role;
+    wxString remoteAddress;
+    wxString remoteProcess;
+    wxString timestamp;
+    int wireCrypt;      // -1 if the server doesn't report it
+    SessionCounters counters;
+    SessionRates rates;
+};
+
+struct SessionStatementInfo
+{
+    int64_t id;
+    int64_t attachmentId;
+    int state;
+    wxString sqlText;
+    wxString timestamp;
+    SessionCounters counters;
+    SessionRates rates;
+};
+
+struct SessionTransactionInfo
+{
+    int64_t id;
+    int64_t attachmentId;
+    int state;
+    int isolationMode;
+    int lockTimeout;
+    bool readOnly;
+    wxString timestamp;
+};
+
+// one snapshot of the monitoring tables, every list sorted by id
+struct SessionSample
+{
+    double time;        // seconds since sampling started
+    std::vector<SessionAttachmentInfo> attachments;
+    std::vector<SessionStatementInfo> statements;
+    std::vector<SessionTransactionInfo> transactions;
+    std::vector<fr::CompiledStatementInfo> compiledStatements;
+    std::vector<fr::MemoryUsageInfo> memoryUsage;
+    std::vector<fr::MemoryPoolInfo> memoryPools;
+    std::vector<fr::ConnectionPoolInfo> connPools;
+};
+
+// SessionMonitorHistory class
+// The counters of the attachments and statements of the last samples, in
+// a ring buffer of fixed size, so the rates of the counters can be
+// computed without keeping whole samples. The counters of every sample are
+// sorted by id, so finding those of one attachment is a binary search.
+class SessionMonitorHistory
+{
+public:
+    enum Kind { kAttachments, kStatements, kindCount };
+    typedef std::vector<std::pair<int64_t, SessionCounters> > Entries;
+private:
+    struct Point
+    {
+        double time;
+        Entries entries[kindCount];
+    };
+    std::vector<Point> pointsM;
+    size_t firstM;
+    size_t countM;
+
+    const Point& getPoint(size_t index) const;
+    static const SessionCounters* find(const Entries& entries, int64_t id);
+public:
+    explicit SessionMonitorHistory(size_t capacity);
+
+    void clear();
+    size_t getCapacity() const;
+    size_t getCount() const;
+    // adds the counters of a sample, sorted by id; once the history is
+    // full the oldest sample is dropped
+    void add(double time, Entries& attachments, Entries& statements);
+    // computes the rates of the counters of id, returns false if it isn't
+    // in both of the last two samples
+    bool getRates(Kind kind, int64_t id, SessionRates& rates) const;
+    // the rates of one counter of id between every two samples, oldest
+    // first, 0 where id is missing from one of them
+    void getSeries(Kind kind, int64_t id, SessionCounters::Counter counter,
+        std::vector<double>& rates) const;
+};
+
+// the text a list control shows for one item
+struct SessionListRow
+{
+    int64_t id;
+    std::vector<wxString> cells;
+};
+
+// one change of a list control, to be applied in order: item is the
+// index of the item at the time the change is applied, row the index of
+// the new row of insertions and updates, columns the changed cells of
+// updates
+struct SessionListChange
+{
+    enum Kind { kInsert, kUpdate, kDelete };
+    Kind kind;
+    long item;
+    size_t row;
+    std::vector<int> columns;
+};
+
+// SessionListRows class
+// The rows a list control shows. Updating them with new rows yields the
+// items to insert and delete and the cells that changed, so the list
+// control is only touched where something changed and keeps its
+// selection and scroll position.
+class SessionListRows
+{
+private:
+    std::vector<SessionListRow> rowsM;
+public:
+    size_t getCount() const;
+    const SessionListRow& getRow(size_t index) const;
+    // replaces the rows with rows, which have to be sorted by id
+    void update(std::vector<SessionListRow>& rows,
+        std::vector<SessionListChange>& changes);
+};
+
+// SessionMonitorSampler class
+// Reads the monitoring tables on a thread of its own, over an attachment
+// of its own, so a slow MON$ query doesn't block the frame. Every sample
+// is read in a new transaction, as the server makes one snapshot of the
+// monitoring tables per transaction, and gets the rates of its counters
+// from the history. The sampler calls notify on its thread whenever a new
+// sample can be taken.
+class SessionMonitorSampler
+{
+private:
+    fr::IDatabasePtr databaseM;
+    bool hasWireCryptM;
+    std::chrono::milliseconds intervalM;
+    std::function<void()> notifyM;
+    SessionMonitorHistory historyM;
+    std::chrono::steady_clock::time_point startM;
+
+    std::thread threadM;
+    std::mutex mutexM;
+    std::condition_variable wakeM;
+    bool stopM;
+    bool pausedM;
+    bool requestedM;
+    bool samplingM;
+    std::shared_ptr<SessionSample> sampleM;
+
+    void run();
+    void read(SessionSample& sample);
+    void addToHistory(SessionSample& sample);
+public:
+    explicit SessionMonitorSampler(size_t historySize);
+    ~SessionMonitorSampler();
+
+    // starts sampling database every interval, the first sample is read
+    // right away
+    void start(fr::IDatabasePtr database, bool hasWireCrypt,
+        std::chrono::milliseconds interval, std::function<void()> notify);
+    // cancels a sample that is being read and disconnects the attachment
+    void stop();
+    // while paused samples are only read when they are requested
+    void setPaused(bool paused);
+    void requestSample();
+    // the last sample, or nullptr if there is none since the last call
+    std::shared_ptr<SessionSample> takeSample();
+};
+
+#endif // FR_SESSIONMONITORSAMPLER_H
@@ -0,0 +1,235 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <iostream>
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include "gui/SessionMonitorSampler.h"
+
+namespace
+{
+
+bool check(bool condition, const char* testName)
+{
+    if (condition)
+    {
+        std::cout << "  PASSED: " << testName << "\n";
+        return true;
+    }
+    std::cout << "  FAILED: " << testName << "\n";
+    return false;
+}
+
+typedef SessionMonitorHistory History;
+
+// counters that all have the same value
+SessionCounters makeCounters(int64_t value)
+{
+    SessionCounters c;
+    for (int i = 0; i < SessionCounters::counterCount; ++i)
+        c.values[i] = value;
+    return c;
+}
+
+void addSample(History& history, double time,
+    const std::vector<std::pair<int64_t, int64_t> >& attachments)
+{
+    History::Entries entries, statements;
+    for (size_t i = 0; i < attachments.size(); ++i)
+    {
+        entries.push_back(std::make_pair(attachments[i].first,
+            makeCounters(attachments[i].second)));
+    }
+    history.add(time, entries, statements);
+}
+
+SessionListRow makeRow(int64_t id, const wxString& text)
+{
+    SessionListRow row;
+    row.id = id;
+    row.cells.push_back(wxString::Format("%d", int(id)));
+    row.cells.push_back(text);
+    return row;
+}
+
+// what a list control shows, changed the way the frame changes it
+void apply(std::vector<std::vector<wxString> >& list,
+    const SessionListRows& rows, const std::vector<SessionListChange>& changes)
+{
+    for (size_t i = 0; i < changes.size(); ++i)
+    {
+        const SessionListChange& change = changes[i];
+        if (change.kind == SessionListChange::kDelete)
+            list.erase(list.begin() + change.item);
+        else if (change.kind == SessionListChange::kInsert)
+            list.insert(list.begin() + change.item, rows.getRow(change.row).cells);
+        else
+        {
+            for (size_t c = 0; c < change.columns.size(); ++c)
+            {
+                int column = change.columns[c];
+                list[change.item][column] = rows.getRow(change.row).cells[column];
+            }
+        }
+    }
+}
+
+bool shows(const std::vector<std::vector<wxString> >& list,
+    const SessionListRows& rows)
+{
+    if (list.size() != rows.getCount())
+        return false;
+    for (size_t i = 0; i < list.size(); ++i)
+    {
+        if (list[i] != rows.getRow(i).cells)
+            return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = true;
+    std::cout << "Running SessionMonitorSampler Tests...\n";
+
+    // Test 1: the ring buffer keeps the last samples
+    {
+        History history(3);
+        std::vector<std::pair<int64_t, int64_t> > att;
+        att.push_back(std::make_pair(int64_t(7), int64_t(0)));
+        for (int i = 0; i < 5; ++i)
+        {
+            att[0].second = i * 100;
+            addSample(history, i * 2.0, att);
+        }
+        ok = check(history.getCount() == 3 && history.getCapacity() == 3,
+            "Oldest samples dropped") && ok;
+
+        std::vector<double> series;
+        history.getSeries(History::kAttachments, 7,
+            SessionCounters::kPageFetches, series);
+        ok = check(series.size() == 2 && series[0] == 50 && series[1] == 50,
+            "Series of the remaining samples") && ok;
+
+        history.clear();
+        ok = check(history.getCount() == 0, "Cleared") && ok;
+    }
+
+    // Test 2: rates, peaks and attachments that come and go
+    {
+        History history(10);
+        std::vector<std::pair<int64_t, int64_t> > att;
+        att.push_back(std::make_pair(int64_t(1), int64_t(0)));
+        att.push_back(std::make_pair(int64_t(2), int64_t(0)));
+        addSample(history, 0, att);
+        att[0].second = 500;
+        att[1].second = 10;
+        addSample(history, 5, att);
+        att[0].second = 600;
+        att.pop_back();
+        att.push_back(std::make_pair(int64_t(3), int64_t(40)));
+        addSample(history, 10, att);
+
+        SessionRates rates;
+        bool valid = history.getRates(History::kAttachments, 1, rates);
+        ok = check(valid && rates.perSecond[SessionCounters::kPageReads] == 20
+            && rates.peak[SessionCounters::kPageReads] == 100,
+            "Rate and peak rate") && ok;
+        ok = check(!history.getRates(History::kAttachments, 2, rates)
+            && !rates.valid, "No rates once gone") && ok;
+        ok = check(!history.getRates(History::kAttachments, 3, rates),
+            "No rates for a new attachment") && ok;
+        ok = check(!history.getRates(History::kStatements, 1, rates),
+            "Statements kept apart") && ok;
+
+        // a reused id starts from 0 again
+        att.clear();
+        att.push_back(std::make_pair(int64_t(1), int64_t(5)));
+        addSample(history, 15, att);
+        history.getRates(History::kAttachments, 1, rates);
+        ok = check(rates.valid && rates.perSecond[SessionCounters::kInserts] == 0,
+            "Counters that went back") && ok;
+    }
+
+    // Test 3: only the changed items and cells are touched
+    {
+        SessionListRows rows;
+        std::vector<std::vector<wxString> > list;
+        std::vector<SessionListChange> changes;
+
+        std::vector<SessionListRow> newRows;
+        for (int i = 1; i <= 5; ++i)
+            newRows.push_back(makeRow(i * 10, "idle"));
+        rows.update(newRows, changes);
+        apply(list, rows, changes);
+        ok = check(changes.size() == 5 && shows(list, rows), "First rows inserted") && ok;
+
+        newRows.clear();
+        for (int i = 1; i <= 5; ++i)
+            newRows.push_back(makeRow(i * 10, "idle"));
+        rows.update(newRows, changes);
+        ok = check(changes.empty(), "Nothing changed") && ok;
+
+        // 10 gone, 25 and 60 new, 40 changed
+        newRows.clear();
+        newRows.push_back(makeRow(20, "idle"));
+        newRows.push_back(makeRow(25, "active"));
+        newRows.push_back(makeRow(30, "idle"));
+        newRows.push_back(makeRow(40, "active"));
+        newRows.push_back(makeRow(50, "idle"));
+        newRows.push_back(makeRow(60, "active"));
+        rows.update(newRows, changes);
+        apply(list, rows, changes);
+        int inserts = 0, updates = 0, deletes = 0;
+        for (size_t i = 0; i < changes.size(); ++i)
+        {
+            if (changes[i].kind == SessionListChange::kInsert)
+                ++inserts;
+            else if (changes[i].kind == SessionListChange::kDelete)
+                ++deletes;
+            else if (changes[i].columns.size() == 1 && changes[i].columns[0] == 1)
+                ++updates;
+        }
+        ok = check(inserts == 2 && updates == 1 && deletes == 1
+            && shows(list, rows), "Inserted, updated and deleted") && ok;
+
+        newRows.clear();
+        rows.update(newRows, changes);
+        apply(list, rows, changes);
+        ok = check(changes.size() == 6 && list.empty(), "All rows deleted") && ok;
+    }
+
+    std::cout << "SessionMonitorSampler Tests completed: "
+              << (ok ? "ALL PASSED" : "SOME FAILED") << "\n";
+    return ok ? 0 : 1;
+}
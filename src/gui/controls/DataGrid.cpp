@@ -71,6 +71,7 @@ DataGrid::DataGrid(wxWindow* parent, wxWindowID id)
 
     Connect(wxID_ANY, wxEVT_FRDG_BATCH_READY, wxCommandEventHandler(DataGrid::OnBatchReady));
     Connect(wxID_ANY, wxEVT_FRDG_FETCH_DONE, wxCommandEventHandler(DataGrid::OnFetchDone));
+    Connect(wxID_ANY, wxEVT_FRDG_FILTER_DONE, wxCommandEventHandler(DataGrid::OnFilterDone));
 }
 
 DataGrid::~DataGrid()
@@ -236,6 +237,7 @@ void DataGrid::showPopupMenu(wxPoint cursorPos)
     m.Append(Cmds::DataGrid_Save_as_json, _("Save as JSON file..."));
     m.Append(Cmds::DataGrid_Save_as_excel, _("Save as Excel XML file..."));
     m.Append(Cmds::DataGrid_Save_as_markdown, _("Save as Markdown table..."));
+    m.Append(Cmds::DataGrid_Export_all, _("Export all records..."));
     m.AppendSeparator();
 
     m.Append(Cmds::DataGrid_EditBlob, _("Edit BLOB..."));
@@ -696,8 +698,9 @@ void DataGrid::copyToClipboardAsUpdateInsert()
         notifyIfUnfetchedData();
 }
 
-void DataGrid::saveAsCSV(const wxString& fileName,
-    const wxChar& fieldDelimiter, const wxChar& textDelimiter)
+void DataGrid::saveSelectedCells(const wxString& fileName,
+    DataGridExportWriter::Format format, wxChar fieldDelimiter,
+    wxChar textDelimiter)
 {
     DataGridTable* table = getDataGridTable();
     if (!table)
@@ -709,234 +712,50 @@ void DataGrid::saveAsCSV(const wxString& fileName,
     bool all = true;
     {
         wxBusyCursor cr;
-        // find all columns that have at least one cell selected
+        // export only the rows and columns that have a cell selected
         std::vector<bool> selCols(getColumnsWithSelectedCells());
-        if (std::find(selCols.begin(), selCols.end(), false) != selCols.end())
-            all = false;
-
-        // write CSV file
-        wxFileOutputStream fos(fileName);
-        if (!fos.Ok()) // TODO: report error
-            return;
-        wxTextOutputStream outStr(fos);
-
-        // wxTextOutputStream (which is used to write the CSV file) will
-        // convert '\n' to the proper EOL sequence while writing the stream
-        const wxString sEOL("\n");
-        const wxString sFieldDelim(fieldDelimiter);
-        const wxString sTextDelim =
-            (textDelimiter != '\0') ? wxString(textDelimiter) : wxString("");
-
-        wxString sHeader;
+        std::vector<int> cols;
         for (size_t col = 0; col < selCols.size(); col++)
         {
-            if (!sHeader.empty())
-                sHeader += sFieldDelim;
-            sHeader += sTextDelim + GetColLabelValue(col) + sTextDelim;
+            if (selCols[col])
+                cols.push_back(col);
+            else
+                all = false;
         }
-        if (!sHeader.empty())
-            outStr.WriteString(sHeader + sEOL);
-
-        // find all rows that have at least one cell selected
         std::vector<bool> selRows(getRowsWithSelectedCells());
-        if (std::find(selRows.begin(), selRows.end(), false) != selRows.end())
-            all = false;
+        std::vector<int> rows;
         for (size_t row = 0; row < selRows.size(); row++)
         {
-            // export only selected rows
-            if (!selRows[row])
-                continue;
-            wxString sRow;
-            for (size_t col = 0; col < selCols.size(); col++)
-            {
-                if (selCols[col])
-                {
-                    if (!sRow.empty())
-                        sRow += sFieldDelim;
-                    sRow += table->getCellValueForCSV(row, col, textDelimiter);
-                }
-            }
-            if (!sRow.empty())
-                outStr.WriteString(sRow + sEOL);
+            if (selRows[row])
+                rows.push_back(row);
+            else
+                all = false;
         }
+        table->saveCells(fileName, format, rows, cols, fieldDelimiter,
+            textDelimiter);
     }
     if (all)
         notifyIfUnfetchedData();
 }
 
-void DataGrid::saveAsJSON(const wxString& fileName)
+void DataGrid::saveAsCSV(const wxString& fileName,
+    const wxChar& fieldDelimiter, const wxChar& textDelimiter)
 {
-    DataGridTable* table = getDataGridTable();
-    if (!table)
-        return;
-
-    if (fileName.empty())
-        return;
-
-    bool all = true;
-    {
-        wxBusyCursor cr;
-        std::vector<bool> selCols(getColumnsWithSelectedCells());
-        if (std::find(selCols.begin(), selCols.end(), false) != selCols.end())
-            all = false;
-
-        wxFileOutputStream fos(fileName);
-        if (!fos.Ok())
-            return;
-        wxTextOutputStream outStr(fos);
-
-        // Escape JSON helper
-        auto escapeJson = [](const wxString& str) -> wxString {
-            wxString res = str;
-            res.Replace("\\", "\\\\");
-            res.Replace("\"", "\\\"");
-            res.Replace("\n", "\\n");
-            res.Replace("\r", "\\r");
-            res.Replace("\t", "\\t");
-            return res;
-        };
-
-        outStr.WriteString("[\n");
-
-        std::vector<bool> selRows(getRowsWithSelectedCells());
-        if (std::find(selRows.begin(), selRows.end(), false) != selRows.end())
-            all = false;
-
-        bool firstRow = true;
-        for (size_t row = 0; row < selRows.size(); row++)
-        {
-            if (!selRows[row])
-                continue;
-
-            if (!firstRow)
-                outStr.WriteString(",\n");
-            firstRow = false;
+    saveSelectedCells(fileName, DataGridExportWriter::formatCSV,
+        fieldDelimiter, textDelimiter);
+}
 
-            outStr.WriteString("  {\n");
-            bool firstCol = true;
-            for (size_t col = 0; col < selCols.size(); col++)
-            {
-                if (selCols[col])
-                {
-                    if (!firstCol)
-                        outStr.WriteString(",\n");
-                    firstCol = false;
-
-                    wxString colName = GetColLabelValue(col);
-                    wxString cellValue = table->GetValue(row, col);
-
-                    outStr.WriteString(wxString::Format(
-                        "    \"%s\": \"%s\"",
-                        escapeJson(colName).c_str(),
-                        escapeJson(cellValue).c_str()
-                    ));
-                }
-            }
-            outStr.WriteString("\n  }");
-        }
-        outStr.WriteString("\n]\n");
-    }
-    if (all)
-        notifyIfUnfetchedData();
+void DataGrid::saveAsJSON(const wxString& fileName)
+{
+    saveSelectedCells(fileName, DataGridExportWriter::formatJSON);
 }
 
 void DataGrid::saveAsExcel(const wxString& fileName)
 {
-    DataGridTable* table = getDataGridTable();
-    if (!table)
-        return;
-
-    if (fileName.empty())
-        return;
-
-    bool all = true;
-    {
-        wxBusyCursor cr;
-        std::vector<bool> selCols(getColumnsWithSelectedCells());
-        if (std::find(selCols.begin(), selCols.end(), false) != selCols.end())
-            all = false;
-
-        wxFileOutputStream fos(fileName);
-        if (!fos.Ok())
-            return;
-        wxTextOutputStream outStr(fos);
-
-        // Escape XML helper
-        auto escapeXml = [](const wxString& str) -> wxString {
-            wxString res = str;
-            res.Replace("&", "&amp;");
-            res.Replace("<", "&lt;");
-            res.Replace(">", "&gt;");
-            res.Replace("\"", "&quot;");
-            res.Replace("'", "&apos;");
-            return res;
-        };
-
-        outStr.WriteString(
-            "<?xml version=\"1.0\"?>\n"
-            "<?mso-application progid=\"Excel.Sheet\"?>\n"
-            "<Workbook xmlns=\"urn:schemas-microsoft-com:office:spreadsheet\"\n"
-            " xmlns:o=\"urn:schemas-microsoft-com:office:office\"\n"
-            " xmlns:x=\"urn:schemas-microsoft-com:office:excel\"\n"
-            " xmlns:ss=\"urn:schemas-microsoft-com:office:spreadsheet\"\n"
-            " xmlns:html=\"http://www.w3.org/TR/REC-html40\">\n"
-            " <Worksheet ss:Name=\"Query Results\">\n"
-            "  <Table>\n"
-        );
-
-        // Header row
-        outStr.WriteString("   <Row>\n");
-        for (size_t col = 0; col < selCols.size(); col++)
-        {
-            if (selCols[col])
-            {
-                outStr.WriteString(wxString::Format(
-                    "    <Cell><Data ss:Type=\"String\">%s</Data></Cell>\n",
-                    escapeXml(GetColLabelValue(col)).c_str()
-                ));
-            }
-        }
-        outStr.WriteString("   </Row>\n");
-
-        std::vector<bool> selRows(getRowsWithSelectedCells());
-        if (std::find(selRows.begin(), selRows.end(), false) != selRows.end())
-            all = false;
-
-        for (size_t row = 0; row < selRows.size(); row++)
-        {
-            if (!selRows[row])
-                continue;
-
-            outStr.WriteString("   <Row>\n");
-            for (size_t col = 0; col < selCols.size(); col++)
-            {
-                if (selCols[col])
-                {
-                    wxString cellValue = table->GetValue(row, col);
-                    // Determine if numeric for Excel
-                    bool isNumeric = false;
-                    double dummy;
-                    if (cellValue.ToDouble(&dummy))
-                        isNumeric = true;
-
-                    outStr.WriteString(wxString::Format(
-                        "    <Cell><Data ss:Type=\"%s\">%s</Data></Cell>\n",
-                        isNumeric ? "Number" : "String",
-                        escapeXml(cellValue).c_str()
-                    ));
-                }
-            }
-            outStr.WriteString("   </Row>\n");
-        }
-
-        outStr.WriteString(
-            "  </Table>\n"
-            " </Worksheet>\n"
-            "</Workbook>\n"
-        );
-    }
-    if (all)
-        notifyIfUnfetchedData();
+    // Excel workbooks are zip archives, everything else gets Excel XML
+    bool workbook = fileName.Lower().EndsWith(".xlsx");
+    saveSelectedCells(fileName, workbook ? DataGridExportWriter::formatXLSX
+        : DataGridExportWriter::formatExcel);
 }
 
 void DataGrid::saveAsTSV(const wxString& fileName)
@@ -945,67 +764,26 @@ void DataGrid::saveAsTSV(const wxString& fileName)
 }
 
 void DataGrid::saveAsMarkdown(const wxString& fileName)
+{
+    saveSelectedCells(fileName, DataGridExportWriter::formatMarkdown);
+}
+
+void DataGrid::saveFetchedRows(const wxString& fileName,
+    DataGridExportWriter::Format format, wxChar fieldDelimiter,
+    wxChar textDelimiter)
 {
     DataGridTable* table = getDataGridTable();
     if (!table || fileName.empty())
         return;
 
-    bool all = true;
-    {
-        wxBusyCursor cr;
-        std::vector<bool> selCols(getColumnsWithSelectedCells());
-        if (std::find(selCols.begin(), selCols.end(), false) != selCols.end())
-            all = false;
-
-        wxFileOutputStream fos(fileName);
-        if (!fos.Ok())
-            return;
-        wxTextOutputStream outStr(fos);
-
-        auto escapeMd = [](const wxString& str) -> wxString {
-            wxString res = str;
-            res.Replace("|", "\\|");
-            res.Replace("\r\n", "<br>");
-            res.Replace("\n", "<br>");
-            return res;
-        };
-
-        // Header line
-        wxString sHeader = "| ";
-        wxString sSep = "| ";
-        for (size_t col = 0; col < selCols.size(); col++)
-        {
-            if (selCols[col])
-            {
-                sHeader += escapeMd(GetColLabelValue(col)) + " | ";
-                sSep += "--- | ";
-            }
-        }
-        outStr.WriteString(sHeader + "\n");
-        outStr.WriteString(sSep + "\n");
-
-        std::vector<bool> selRows(getRowsWithSelectedCells());
-        if (std::find(selRows.begin(), selRows.end(), false) != selRows.end())
-            all = false;
-
-        for (size_t row = 0; row < selRows.size(); row++)
-        {
-            if (!selRows[row])
-                continue;
-
-            wxString sRow = "| ";
-            for (size_t col = 0; col < selCols.size(); col++)
-            {
-                if (selCols[col])
-                {
-                    sRow += escapeMd(table->GetValue(row, col)) + " | ";
-                }
-            }
-            outStr.WriteString(sRow + "\n");
-        }
-    }
-    if (all)
-        notifyIfUnfetchedData();
+    wxBusyCursor cr;
+    std::vector<int> rows, cols;
+    for (int row = 0; row < GetNumberRows(); row++)
+        rows.push_back(row);
+    for (int col = 0; col < GetNumberCols(); col++)
+        cols.push_back(col);
+    table->saveCells(fileName, format, rows, cols, fieldDelimiter,
+        textDelimiter);
 }
 
 void DataGrid::saveAsHTML()
@@ -1492,6 +1270,16 @@ void DataGrid::OnFetchDone(wxCommandEvent& WXUNUSED(event))
     }
 }
 
+void DataGrid::OnFilterDone(wxCommandEvent& WXUNUSED(event))
+{
+    DataGridTable* table = getDataGridTable();
+    if (table)
+    {
+        table->processFilterResult();
+        AdjustScrollbars();
+    }
+}
+
 void DataGrid::OnIdle(wxIdleEvent& event)
 {
     DataGridTable* table = getDataGridTable();
@@ -1520,6 +1308,11 @@ void DataGrid::OnIdle(wxIdleEvent& event)
         return;
     }
 
+    // rows are not added while the quick filter runs, idle events are
+    // sent again after OnFilterDone()
+    if (table->isBackgroundFiltering())
+        return;
+
     if (table->needsMoreRowsFetched())
     {
         table->fetch();
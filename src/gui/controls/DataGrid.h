@@ -30,6 +30,8 @@
 
 #include <vector>
 
+#include "gui/controls/DataGridExport.h"
+
 class DataGridTable;
 
 BEGIN_DECLARE_EVENT_TYPES()
@@ -47,6 +49,9 @@ private:
     void copyToClipboard(const wxString cbText);
     void extendSelection(int direction);
     void notifyIfUnfetchedData();
+    void saveSelectedCells(const wxString& fileName,
+        DataGridExportWriter::Format format, wxChar fieldDelimiter = ',',
+        wxChar textDelimiter = '"');
     void showPopupMenu(wxPoint cursorPos);
     void updateRowHeights();
 public:
@@ -72,6 +77,7 @@ private:
     void OnTimer(wxTimerEvent& event);
     void OnBatchReady(wxCommandEvent& event);
     void OnFetchDone(wxCommandEvent& event);
+    void OnFilterDone(wxCommandEvent& event);
     DECLARE_EVENT_TABLE()
 public:
     void copyToClipboard(bool headers);
@@ -86,6 +92,10 @@ public:
     void saveAsJSON(const wxString& fileName);
     void saveAsExcel(const wxString& fileName);
     void saveAsMarkdown(const wxString& fileName);
+    // all rows that have been fetched so far, whatever is selected
+    void saveFetchedRows(const wxString& fileName,
+        DataGridExportWriter::Format format, wxChar fieldDelimiter = ',',
+        wxChar textDelimiter = '"');
 
     void autofitRows();
     void refreshAndInvalidateAttributes();
@@ -0,0 +1,711 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <wx/wfstream.h>
+#include <wx/zipstrm.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "gui/controls/DataGridExport.h"
+
+namespace
+{
+
+// the grid exports write through wxTextOutputStream, which turns every
+// '\n' into the native line end
+#ifdef __WXMSW__
+const char* const eol = "\r\n";
+#else
+const char* const eol = "\n";
+#endif
+
+// appends text to buffer as UTF-8 without converting it to a temporary
+// buffer first: every character is passed to escape, which returns true if
+// it has appended the character in the form the format needs
+template<typename Escape>
+void appendUTF8(std::string& buffer, const wxString& text, Escape escape)
+{
+    for (wxString::const_iterator it = text.begin(); it != text.end(); ++it)
+    {
+        uint32_t c = wxUniChar(*it).GetValue();
+        // a surrogate pair where wchar_t is 16 bits wide
+        if (c >= 0xD800 && c < 0xDC00 && it + 1 != text.end())
+        {
+            uint32_t low = wxUniChar(*(it + 1)).GetValue();
+            if (low >= 0xDC00 && low < 0xE000)
+            {
+                c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+                ++it;
+            }
+        }
+        if (escape(c))
+            continue;
+        if (c < 0x80)
+            buffer += char(c);
+        else if (c < 0x800)
+        {
+            buffer += char(0xC0 | (c >> 6));
+            buffer += char(0x80 | (c & 0x3F));
+        }
+        else if (c < 0x10000)
+        {
+            buffer += char(0xE0 | (c >> 12));
+            buffer += char(0x80 | ((c >> 6) & 0x3F));
+            buffer += char(0x80 | (c & 0x3F));
+        }
+        else
+        {
+            buffer += char(0xF0 | (c >> 18));
+            buffer += char(0x80 | ((c >> 12) & 0x3F));
+            buffer += char(0x80 | ((c >> 6) & 0x3F));
+            buffer += char(0x80 | (c & 0x3F));
+        }
+    }
+}
+
+std::string toUTF8(wxChar c)
+{
+    std::string result;
+    if (c != '\0')
+        appendUTF8(result, wxString(c), [](uint32_t) { return false; });
+    return result;
+}
+
+// the fixed parts of an Excel workbook with a single sheet
+const char* const xlsxParts[][2] = {
+    { "[Content_Types].xml",
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<Types xmlns=\"http://schemas.openxmlformats.org/package/2006/content-types\">"
+        "<Default Extension=\"rels\" ContentType=\"application/vnd.openxmlformats-package.relationships+xml\"/>"
+        "<Default Extension=\"xml\" ContentType=\"application/xml\"/>"
+        "<Override PartName=\"/xl/workbook.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.sheet.main+xml\"/>"
+        "<Override PartName=\"/xl/worksheets/sheet1.xml\" ContentType=\"application/vnd.openxmlformats-officedocument.spreadsheetml.worksheet+xml\"/>"
+        "</Types>\n" },
+    { "_rels/.rels",
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+        "<Relationship Id=\"rId1\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/officeDocument\" Target=\"xl/workbook.xml\"/>"
+        "</Relationships>\n" },
+    { "xl/workbook.xml",
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<workbook xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\""
+        " xmlns:r=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships\">"
+        "<sheets><sheet name=\"Query Results\" sheetId=\"1\" r:id=\"rId1\"/></sheets>"
+        "</workbook>\n" },
+    { "xl/_rels/workbook.xml.rels",
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+        "<Relationships xmlns=\"http://schemas.openxmlformats.org/package/2006/relationships\">"
+        "<Relationship Id=\"rId1\" Type=\"http://schemas.openxmlformats.org/officeDocument/2006/relationships/worksheet\" Target=\"worksheets/sheet1.xml\"/>"
+        "</Relationships>\n" }
+};
+
+const char* const xlsxSheet = "xl/worksheets/sheet1.xml";
+
+} // namespace
+
+DataGridExportWriter::DataGridExportWriter(Format format,
+        wxChar fieldDelimiter, wxChar textDelimiter)
+    : formatM(format), fieldDelimiterM(toUTF8(fieldDelimiter)),
+        textDelimiterM(toUTF8(textDelimiter)), rowCountM(0)
+{
+}
+
+void DataGridExportWriter::append(const char* text)
+{
+    for (; *text; ++text)
+    {
+        if (*text == '\n')
+            bufferM += eol;
+        else
+            bufferM += *text;
+    }
+}
+
+void DataGridExportWriter::append(const wxString& text)
+{
+    appendUTF8(bufferM, text, [this](uint32_t c)
+    {
+        if (c != '\n')
+            return false;
+        bufferM += eol;
+        return true;
+    });
+}
+
+// the delimiters and all escaped characters are ASCII, so the appendXXX()
+// methods escape the text while it is converted to UTF-8
+
+void DataGridExportWriter::appendCSV(const wxString& value, bool isNull,
+    bool isNumeric)
+{
+    // NULL is the quoted word, numbers are never quoted
+    const std::string& delim = textDelimiterM;
+    if (isNull)
+    {
+        bufferM += delim;
+        bufferM += "NULL";
+        bufferM += delim;
+        return;
+    }
+    if (isNumeric)
+    {
+        append(value);
+        return;
+    }
+    // "\r\n" is written as a single line end, the delimiter is doubled
+    uint32_t quote = delim.size() == 1 ? uint32_t(delim[0]) : 0;
+    bool cr = false;
+    bufferM += delim;
+    appendUTF8(bufferM, value, [this, quote, &cr](uint32_t c)
+    {
+        if (cr)
+        {
+            cr = false;
+            if (c == '\n')
+            {
+                bufferM += eol;
+                return true;
+            }
+            bufferM += '\r';
+        }
+        if (c == '\r')
+            cr = true;
+        else if (c == '\n')
+            bufferM += eol;
+        else if (quote && c == quote)
+        {
+            bufferM += char(c);
+            bufferM += char(c);
+        }
+        else
+            return false;
+        return true;
+    });
+    if (cr)
+        bufferM += '\r';
+    bufferM += delim;
+}
+
+void DataGridExportWriter::appendJSON(const wxString& text)
+{
+    bufferM += '"';
+    appendUTF8(bufferM, text, [this](uint32_t c)
+    {
+        switch (c)
+        {
+            case '\\': bufferM += "\\\\"; return true;
+            case '"': bufferM += "\\\""; return true;
+            case '\n': bufferM += "\\n"; return true;
+            case '\r': bufferM += "\\r"; return true;
+            case '\t': bufferM += "\\t"; return true;
+            default: return false;
+        }
+    });
+    bufferM += '"';
+}
+
+void DataGridExportWriter::appendXML(const wxString& text)
+{
+    appendUTF8(bufferM, text, [this](uint32_t c)
+    {
+        switch (c)
+        {
+            case '&': bufferM += "&amp;"; return true;
+            case '<': bufferM += "&lt;"; return true;
+            case '>': bufferM += "&gt;"; return true;
+            case '"': bufferM += "&quot;"; return true;
+            case '\'': bufferM += "&apos;"; return true;
+            case '\n': bufferM += eol; return true;
+            case '\t': case '\r': return false;
+            // other control characters are not allowed in XML 1.0
+            default: return c < 0x20;
+        }
+    });
+}
+
+void DataGridExportWriter::appendMarkdown(const wxString& text)
+{
+    bool cr = false;
+    appendUTF8(bufferM, text, [this, &cr](uint32_t c)
+    {
+        if (cr)
+        {
+            cr = false;
+            if (c == '\n')
+            {
+                bufferM += "<br>";
+                return true;
+            }
+            bufferM += '\r';
+        }
+        if (c == '|')
+            bufferM += "\\|";
+        else if (c == '\r')
+            cr = true;
+        else if (c == '\n')
+            bufferM += "<br>";
+        else
+            return false;
+        return true;
+    });
+    if (cr)
+        bufferM += '\r';
+}
+
+void DataGridExportWriter::appendXLSX(const wxString& value, bool isNumeric)
+{
+    if (isNumeric)
+    {
+        // numbers are stored with a decimal point, whatever the locale;
+        // anything that still isn't a number is written as text
+        size_t start = bufferM.size();
+        bufferM += "<c><v>";
+        bool hasDigit = false, valid = !value.empty();
+        for (wxString::const_iterator it = value.begin(); it != value.end()
+            && valid; ++it)
+        {
+            wxChar c = *it;
+            if (c >= '0' && c <= '9')
+                hasDigit = true;
+            else if (c == ',')
+                c = '.';
+            else if (c != '.' && c != '-' && c != '+' && c != 'e' && c != 'E')
+                valid = false;
+            bufferM += char(c);
+        }
+        if (valid && hasDigit)
+        {
+            bufferM += "</v></c>";
+            return;
+        }
+        bufferM.resize(start);
+    }
+    bufferM += "<c t=\"inlineStr\"><is><t xml:space=\"preserve\">";
+    appendXML(value);
+    bufferM += "</t></is></c>";
+}
+
+void DataGridExportWriter::setColumns(
+    const std::vector<wxString>& columnNames, const std::vector<bool>& numeric,
+    uint64_t firstRow)
+{
+    columnNamesM = columnNames;
+    numericM = numeric;
+    numericM.resize(columnNamesM.size(), false);
+    rowCountM = firstRow;
+
+    // the JSON keys are the same in every row, they are only escaped once
+    columnKeysM.clear();
+    if (formatM == formatJSON)
+    {
+        std::string buffer;
+        bufferM.swap(buffer);
+        for (const wxString& name : columnNamesM)
+        {
+            bufferM = "    ";
+            appendJSON(name);
+            bufferM += ": ";
+            columnKeysM.push_back(bufferM);
+        }
+        bufferM.swap(buffer);
+    }
+}
+
+void DataGridExportWriter::writeHeader(
+    const std::vector<wxString>& columnNames, const std::vector<bool>& numeric)
+{
+    setColumns(columnNames, numeric, 0);
+
+    switch (formatM)
+    {
+        case formatCSV:
+            for (size_t col = 0; col < columnNamesM.size(); ++col)
+            {
+                if (col)
+                    bufferM += fieldDelimiterM;
+                bufferM += textDelimiterM;
+                append(columnNamesM[col]);
+                bufferM += textDelimiterM;
+            }
+            if (!columnNamesM.empty())
+                append("\n");
+            break;
+        case formatJSON:
+            append("[\n");
+            break;
+        case formatExcel:
+            append(
+                "<?xml version=\"1.0\"?>\n"
+                "<?mso-application progid=\"Excel.Sheet\"?>\n"
+                "<Workbook xmlns=\"urn:schemas-microsoft-com:office:spreadsheet\"\n"
+                " xmlns:o=\"urn:schemas-microsoft-com:office:office\"\n"
+                " xmlns:x=\"urn:schemas-microsoft-com:office:excel\"\n"
+                " xmlns:ss=\"urn:schemas-microsoft-com:office:spreadsheet\"\n"
+                " xmlns:html=\"http://www.w3.org/TR/REC-html40\">\n"
+                " <Worksheet ss:Name=\"Query Results\">\n"
+                "  <Table>\n"
+                "   <Row>\n");
+            for (const wxString& name : columnNamesM)
+            {
+                append("    <Cell><Data ss:Type=\"String\">");
+                appendXML(name);
+                append("</Data></Cell>\n");
+            }
+            append("   </Row>\n");
+            break;
+        case formatMarkdown:
+            append("| ");
+            for (const wxString& name : columnNamesM)
+            {
+                appendMarkdown(name);
+                append(" | ");
+            }
+            append("\n| ");
+            for (size_t col = 0; col < columnNamesM.size(); ++col)
+                append("--- | ");
+            append("\n");
+            break;
+        case formatXLSX:
+            append(
+                "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+                "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\">\n"
+                "<sheetData>\n"
+                "<row>");
+            for (const wxString& name : columnNamesM)
+                appendXLSX(name, false);
+            append("</row>\n");
+            break;
+    }
+}
+
+void DataGridExportWriter::writeRow(const std::vector<wxString>& values,
+    const std::vector<bool>& nulls)
+{
+    wxASSERT(values.size() == columnNamesM.size());
+    wxASSERT(nulls.size() == columnNamesM.size());
+
+    switch (formatM)
+    {
+        case formatCSV:
+            for (size_t col = 0; col < values.size(); ++col)
+            {
+                if (col)
+                    bufferM += fieldDelimiterM;
+                appendCSV(values[col], nulls[col], numericM[col]);
+            }
+            if (!values.empty())
+                append("\n");
+            break;
+        case formatJSON:
+            append(rowCountM ? ",\n  {\n" : "  {\n");
+            for (size_t col = 0; col < values.size(); ++col)
+            {
+                if (col)
+                    append(",\n");
+                bufferM += columnKeysM[col];
+                if (nulls[col])
+                    bufferM += "null";
+                else
+                    appendJSON(values[col]);
+            }
+            append("\n  }");
+            break;
+        case formatExcel:
+            append("   <Row>\n");
+            for (size_t col = 0; col < values.size(); ++col)
+            {
+                bool isNumber = numericM[col] && !nulls[col];
+                append(isNumber ? "    <Cell><Data ss:Type=\"Number\">"
+                    : "    <Cell><Data ss:Type=\"String\">");
+                if (nulls[col])
+                    bufferM += "[null]";
+                else
+                    appendXML(values[col]);
+                append("</Data></Cell>\n");
+            }
+            append("   </Row>\n");
+            break;
+        case formatMarkdown:
+            append("| ");
+            for (size_t col = 0; col < values.size(); ++col)
+            {
+                if (nulls[col])
+                    bufferM += "[null]";
+                else
+                    appendMarkdown(values[col]);
+                append(" | ");
+            }
+            append("\n");
+            break;
+        case formatXLSX:
+            // cells have no references, so NULL needs an empty cell
+            bufferM += "<row>";
+            for (size_t col = 0; col < values.size(); ++col)
+            {
+                if (nulls[col])
+                    bufferM += "<c/>";
+                else
+                    appendXLSX(values[col], numericM[col]);
+            }
+            append("</row>\n");
+            break;
+    }
+    ++rowCountM;
+}
+
+void DataGridExportWriter::writeFooter()
+{
+    switch (formatM)
+    {
+        case formatJSON:
+            append("\n]\n");
+            break;
+        case formatExcel:
+            append(
+                "  </Table>\n"
+                " </Worksheet>\n"
+                "</Workbook>\n");
+            break;
+        case formatXLSX:
+            append(
+                "</sheetData>\n"
+                "</worksheet>\n");
+            break;
+        default:
+            break;
+    }
+}
+
+uint64_t DataGridExportWriter::getRowCount() const
+{
+    return rowCountM;
+}
+
+std::string& DataGridExportWriter::getBuffer()
+{
+    return bufferM;
+}
+
+DataGridExportFile::DataGridExportFile()
+{
+}
+
+DataGridExportFile::~DataGridExportFile()
+{
+    close();
+}
+
+bool DataGridExportFile::create(const wxString& fileName,
+    DataGridExportWriter::Format format)
+{
+    if (!fileM.Create(fileName, true))
+        return false;
+    if (format != DataGridExportWriter::formatXLSX)
+        return true;
+
+    // the fastest compression level, the sheet is compressed while the
+    // rows are formatted and written
+    fileStreamM.reset(new wxFileOutputStream(fileM));
+    zipM.reset(new wxZipOutputStream(*fileStreamM, 1));
+    for (const auto& part : xlsxParts)
+    {
+        if (!zipM->PutNextEntry(part[0]))
+            return false;
+        zipM->Write(part[1], std::strlen(part[1]));
+    }
+    return zipM->PutNextEntry(xlsxSheet) && zipM->IsOk();
+}
+
+bool DataGridExportFile::write(const std::string& text)
+{
+    if (text.empty())
+        return true;
+    if (zipM)
+        return zipM->Write(text.data(), text.size()).LastWrite() == text.size();
+    return fileM.Write(text.data(), text.size()) == text.size();
+}
+
+bool DataGridExportFile::close()
+{
+    bool ok = true;
+    if (zipM)
+    {
+        ok = zipM->Close();
+        zipM.reset();
+        fileStreamM.reset();
+    }
+    if (fileM.IsOpened())
+        ok = fileM.Close() && ok;
+    return ok;
+}
+
+DataGridParallelExport::DataGridParallelExport(
+        DataGridExportWriter::Format format, wxChar fieldDelimiter,
+        wxChar textDelimiter)
+    : formatM(format), fieldDelimiterM(fieldDelimiter),
+        textDelimiterM(textDelimiter)
+{
+}
+
+void DataGridParallelExport::formatBlock(size_t block, size_t rowCount,
+    const std::vector<wxString>& columnNames, const std::vector<bool>& numeric,
+    unsigned thread, const ReadRow& readRow, std::string& text)
+{
+    DataGridExportWriter writer(formatM, fieldDelimiterM, textDelimiterM);
+    size_t first = block * rowsPerBlock;
+    size_t last = std::min<size_t>(first + rowsPerBlock, rowCount);
+    writer.setColumns(columnNames, numeric, first);
+
+    std::vector<wxString> values(columnNames.size());
+    std::vector<bool> nulls(columnNames.size());
+    for (size_t row = first; row < last; ++row)
+    {
+        readRow(thread, row, values, nulls);
+        writer.writeRow(values, nulls);
+    }
+    text.swap(writer.getBuffer());
+}
+
+bool DataGridParallelExport::write(DataGridExportFile& file,
+    const std::vector<wxString>& columnNames, const std::vector<bool>& numeric,
+    size_t rowCount, unsigned threadCount, const ReadRow& readRow)
+{
+    DataGridExportWriter writer(formatM, fieldDelimiterM, textDelimiterM);
+    writer.writeHeader(columnNames, numeric);
+    if (!file.write(writer.getBuffer()))
+        return false;
+    writer.getBuffer().clear();
+
+    size_t blockCount = (rowCount + rowsPerBlock - 1) / rowsPerBlock;
+    threadCount = unsigned(std::min<size_t>(threadCount, blockCount));
+    bool ok = true;
+    if (threadCount <= 1)
+    {
+        std::string text;
+        for (size_t block = 0; block < blockCount && ok; ++block)
+        {
+            formatBlock(block, rowCount, columnNames, numeric, 0, readRow,
+                text);
+            ok = file.write(text);
+        }
+    }
+    else
+    {
+        // the workers format the blocks in ascending order, but only up to
+        // window blocks ahead of the one that is written next
+        const size_t window = size_t(threadCount) * blocksPerThread;
+        std::vector<std::string> texts(blockCount);
+        std::vector<bool> done(blockCount, false);
+        size_t nextBlock = 0, written = 0;
+        bool stop = false;
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable changed;
+
+        auto formatBlocks = [&](unsigned thread)
+        {
+            std::string text;
+            for (;;)
+            {
+                size_t block;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [&]() {
+                        return stop || nextBlock >= blockCount
+                            || nextBlock < written + window;
+                    });
+                    if (stop || nextBlock >= blockCount)
+                        return;
+                    block = nextBlock++;
+                }
+                try
+                {
+                    formatBlock(block, rowCount, columnNames, numeric, thread,
+                        readRow, text);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error)
+                        error = std::current_exception();
+                    stop = true;
+                    changed.notify_all();
+                    return;
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                texts[block].swap(text);
+                done[block] = true;
+                changed.notify_all();
+            }
+        };
+        std::vector<std::thread> workers;
+        for (unsigned i = 0; i < threadCount; ++i)
+            workers.emplace_back(formatBlocks, i);
+
+        std::string text;
+        for (size_t block = 0; block < blockCount && ok; ++block)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]() { return stop || done[block]; });
+                if (!done[block])
+                    break;
+                text.swap(texts[block]);
+                std::string().swap(texts[block]);
+            }
+            ok = file.write(text);
+            std::lock_guard<std::mutex> lock(mutex);
+            written = block + 1;
+            stop = stop || !ok;
+            changed.notify_all();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+            changed.notify_all();
+        }
+        for (std::thread& t : workers)
+            t.join();
+        if (error)
+            std::rethrow_exception(error);
+    }
+    if (!ok)
+        return false;
+
+    writer.writeFooter();
+    return file.write(writer.getBuffer());
+}
@@ -0,0 +1,140 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_DATAGRIDEXPORT_H
+#define FR_DATAGRIDEXPORT_H
+
+#include <wx/file.h>
+#include <wx/string.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class wxFileOutputStream;
+class wxZipOutputStream;
+
+// DataGridExportWriter class
+// Formats result set rows as CSV, JSON, Excel XML, an Excel workbook sheet
+// or a Markdown table into a UTF-8 buffer, the way the DataGrid::saveAs...()
+// methods write them. The buffer only grows until the caller writes it out
+// and clears it, so any number of rows can be written with constant memory.
+class DataGridExportWriter
+{
+public:
+    enum Format { formatCSV, formatJSON, formatExcel, formatMarkdown,
+        formatXLSX };
+private:
+    Format formatM;
+    // UTF-8, the text delimiter is empty if text is not quoted
+    std::string fieldDelimiterM;
+    std::string textDelimiterM;
+    std::vector<wxString> columnNamesM;
+    std::vector<std::string> columnKeysM;
+    std::vector<bool> numericM;
+    std::string bufferM;
+    uint64_t rowCountM;
+
+    void append(const char* text);
+    void append(const wxString& text);
+    void appendCSV(const wxString& value, bool isNull, bool isNumeric);
+    void appendJSON(const wxString& text);
+    void appendXML(const wxString& text);
+    void appendMarkdown(const wxString& text);
+    void appendXLSX(const wxString& value, bool isNumeric);
+public:
+    DataGridExportWriter(Format format, wxChar fieldDelimiter = ',',
+        wxChar textDelimiter = '"');
+
+    // numeric holds for every column whether its values are numbers
+    void writeHeader(const std::vector<wxString>& columnNames,
+        const std::vector<bool>& numeric);
+    // sets the columns without writing the header, so that the rows
+    // starting at firstRow can be formatted separately from those before
+    void setColumns(const std::vector<wxString>& columnNames,
+        const std::vector<bool>& numeric, uint64_t firstRow);
+    void writeRow(const std::vector<wxString>& values,
+        const std::vector<bool>& nulls);
+    void writeFooter();
+
+    uint64_t getRowCount() const;
+    std::string& getBuffer();
+};
+
+// DataGridExportFile class
+// The file an export is written to. An Excel workbook is a zip archive, its
+// fixed parts are written when the file is created and the text written
+// afterwards is compressed into its only sheet while it is written.
+class DataGridExportFile
+{
+private:
+    wxFile fileM;
+    std::unique_ptr<wxFileOutputStream> fileStreamM;
+    std::unique_ptr<wxZipOutputStream> zipM;
+public:
+    DataGridExportFile();
+    ~DataGridExportFile();
+
+    bool create(const wxString& fileName, DataGridExportWriter::Format format);
+    bool write(const std::string& text);
+    bool close();
+};
+
+// DataGridParallelExport class
+// Formats the rows of an export on several threads: the rows are split into
+// blocks, every thread formats a block into a UTF-8 buffer of its own, and
+// the calling thread writes the finished blocks to the file in order. At
+// most a few blocks per thread are held in memory at any time.
+class DataGridParallelExport
+{
+public:
+    enum { rowsPerBlock = 4096, blocksPerThread = 2 };
+    // reads row into values and nulls; thread is the number of the
+    // calling thread, so that it can use a scratch buffer of its own
+    typedef std::function<void(unsigned thread, size_t row,
+        std::vector<wxString>& values, std::vector<bool>& nulls)> ReadRow;
+private:
+    DataGridExportWriter::Format formatM;
+    wxChar fieldDelimiterM;
+    wxChar textDelimiterM;
+
+    void formatBlock(size_t block, size_t rowCount,
+        const std::vector<wxString>& columnNames,
+        const std::vector<bool>& numeric, unsigned thread,
+        const ReadRow& readRow, std::string& text);
+public:
+    DataGridParallelExport(DataGridExportWriter::Format format,
+        wxChar fieldDelimiter = ',', wxChar textDelimiter = '"');
+
+    // writes the header, rowCount rows read by threadCount threads and the
+    // footer; returns false if the file could not be written, exceptions
+    // of readRow are rethrown on the calling thread
+    bool write(DataGridExportFile& file,
+        const std::vector<wxString>& columnNames,
+        const std::vector<bool>& numeric, size_t rowCount,
+        unsigned threadCount, const ReadRow& readRow);
+};
+
+#endif
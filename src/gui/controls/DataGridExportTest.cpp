@@ -0,0 +1,375 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// Tests for the row formatting of the streaming result set export
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <chrono>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <wx/wxprec.h>
+#ifndef WX_PRECOMP
+    #include <wx/wx.h>
+#endif
+
+#include "gui/controls/DataGridExport.h"
+
+namespace
+{
+
+static bool check(bool condition, const char* testName)
+{
+    if (condition)
+    {
+        std::cout << "  PASSED: " << testName << "\n";
+        return true;
+    }
+    else
+    {
+        std::cout << "  FAILED: " << testName << "\n";
+        return false;
+    }
+}
+
+#ifdef __WXMSW__
+const std::string nl("\r\n");
+#else
+const std::string nl("\n");
+#endif
+
+std::string writeTwoRows(DataGridExportWriter& writer)
+{
+    std::vector<wxString> names = { "ID", "NAME" };
+    std::vector<bool> numeric = { true, false };
+    writer.writeHeader(names, numeric);
+    writer.writeRow({ "1", "say \"hi\"" }, { false, false });
+    writer.writeRow({ wxString(), wxString() }, { true, true });
+    writer.writeFooter();
+    return writer.getBuffer();
+}
+
+const char* const fileName = "data_grid_export_test.tmp";
+
+std::string readFile()
+{
+    std::ifstream in(fileName, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in),
+        std::istreambuf_iterator<char>());
+}
+
+// a grid of rowCount rows with one numeric and columnCount - 1 text columns
+struct TestGrid
+{
+    std::vector<wxString> names;
+    std::vector<bool> numeric;
+    std::vector<wxString> texts;
+    std::vector<wxString> numbers;
+
+    TestGrid(size_t columnCount)
+    {
+        for (size_t col = 0; col < columnCount; ++col)
+        {
+            names.push_back(wxString::Format("COLUMN_%d", int(col)));
+            numeric.push_back(col % 3 == 0);
+        }
+        // the values are prepared, so that reading a row costs about as
+        // much as formatting it from the grid's row buffers
+        for (int i = 0; i < 997; ++i)
+        {
+            texts.push_back(wxString::Format("Text \"%d\"\nline", i));
+            numbers.push_back(wxString::Format("%d.%02d", i * 1013, i % 100));
+        }
+    }
+
+    void readRow(size_t row, std::vector<wxString>& values,
+        std::vector<bool>& nulls)
+    {
+        for (size_t col = 0; col < values.size(); ++col)
+        {
+            nulls[col] = (row + col) % 101 == 0;
+            if (numeric[col])
+                values[col] = numbers[(row * 31 + col) % numbers.size()];
+            else
+                values[col] = texts[(row + col) % texts.size()];
+        }
+    }
+};
+
+// exports the grid to the test file, returns the time taken in ms
+double exportGrid(TestGrid& grid, DataGridExportWriter::Format format,
+    size_t rowCount, unsigned threadCount, bool& ok)
+{
+    auto start = std::chrono::steady_clock::now();
+    DataGridExportFile file;
+    DataGridParallelExport exporter(format);
+    ok = file.create(fileName, format)
+        && exporter.write(file, grid.names, grid.numeric, rowCount, threadCount,
+            [&grid](unsigned, size_t row, std::vector<wxString>& values,
+                std::vector<bool>& nulls)
+            {
+                grid.readRow(row, values, nulls);
+            })
+        && file.close();
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// the same rows written by a single writer
+std::string writeGrid(TestGrid& grid, DataGridExportWriter::Format format,
+    size_t rowCount)
+{
+    DataGridExportWriter writer(format);
+    writer.writeHeader(grid.names, grid.numeric);
+    std::vector<wxString> values(grid.names.size());
+    std::vector<bool> nulls(grid.names.size());
+    for (size_t row = 0; row < rowCount; ++row)
+    {
+        grid.readRow(row, values, nulls);
+        writer.writeRow(values, nulls);
+    }
+    writer.writeFooter();
+    return writer.getBuffer();
+}
+
+} // namespace
+
+int main()
+{
+    wxInitializer initializer;
+    if (!initializer.IsOk())
+    {
+        std::cerr << "Failed to initialize wxWidgets.\n";
+        return 1;
+    }
+
+    bool ok = true;
+    std::cout << "Running DataGrid Export Tests...\n";
+
+    // Test 1: CSV is written like DataGrid::saveAsCSV() does
+    {
+        DataGridExportWriter writer(DataGridExportWriter::formatCSV, ';', '"');
+        std::string csv = writeTwoRows(writer);
+        ok = check(csv == "\"ID\";\"NAME\"" + nl + "1;\"say \"\"hi\"\"\"" + nl
+            + "\"NULL\";\"NULL\"" + nl, "CSV quoting and NULLs") && ok;
+        ok = check(writer.getRowCount() == 2, "Two rows counted") && ok;
+    }
+
+    // Test 2: JSON escapes values and writes NULL as null
+    {
+        DataGridExportWriter writer(DataGridExportWriter::formatJSON);
+        std::string json = writeTwoRows(writer);
+        ok = check(json == "[" + nl + "  {" + nl + "    \"ID\": \"1\"," + nl
+            + "    \"NAME\": \"say \\\"hi\\\"\"" + nl + "  }," + nl + "  {" + nl
+            + "    \"ID\": null," + nl + "    \"NAME\": null" + nl + "  }" + nl
+            + "]" + nl, "JSON escaping and nulls") && ok;
+    }
+
+    // Test 3: Excel XML marks numeric columns and escapes text
+    {
+        DataGridExportWriter writer(DataGridExportWriter::formatExcel);
+        std::string xml = writeTwoRows(writer);
+        ok = check(xml.find("<Data ss:Type=\"Number\">1</Data>") != std::string::npos,
+            "Excel number cell") && ok;
+        ok = check(xml.find("say &quot;hi&quot;") != std::string::npos,
+            "Excel text is escaped") && ok;
+        ok = check(xml.find("</Workbook>") != std::string::npos, "Excel footer") && ok;
+    }
+
+    // Test 4: Markdown escapes pipes and line breaks
+    {
+        DataGridExportWriter writer(DataGridExportWriter::formatMarkdown);
+        writer.writeHeader({ "A" }, { false });
+        writer.writeRow({ "x|y\nz" }, { false });
+        ok = check(writer.getBuffer() == "| A | " + nl + "| --- | " + nl
+            + "| x\\|y<br>z | " + nl, "Markdown escaping") && ok;
+    }
+
+    // Test 5: line ends and characters outside of ASCII
+    {
+        wxString text(wxString::FromUTF8("a\r\nb\rc \xC3\xA4\xE2\x82\xAC\xF0\x9F\x98\x80"));
+        DataGridExportWriter csv(DataGridExportWriter::formatCSV, ',', '"');
+        csv.writeHeader({ "A" }, { false });
+        csv.getBuffer().clear();
+        csv.writeRow({ text }, { false });
+        ok = check(csv.getBuffer() == "\"a" + nl + "b\rc \xC3\xA4\xE2\x82\xAC\xF0\x9F\x98\x80\""
+            + nl, "CSV line ends and UTF-8") && ok;
+
+        DataGridExportWriter json(DataGridExportWriter::formatJSON);
+        json.writeHeader({ "A" }, { false });
+        json.getBuffer().clear();
+        json.writeRow({ text }, { false });
+        ok = check(json.getBuffer().find("\"a\\r\\nb\\rc \xC3\xA4\xE2\x82\xAC\xF0\x9F\x98\x80\"")
+            != std::string::npos, "JSON line ends and UTF-8") && ok;
+    }
+
+    // Test 6: Writing 1M rows with the buffer written out in pieces keeps
+    // the memory constant
+    {
+        const size_t NUM_ROWS = 1000000;
+        const size_t writeSize = 1024 * 1024;
+        DataGridExportWriter writer(DataGridExportWriter::formatCSV, ',', '"');
+        writer.writeHeader({ "ID", "NAME", "AMOUNT" }, { true, false, true });
+        std::vector<wxString> values(3);
+        std::vector<bool> nulls(3, false);
+        size_t written = 0;
+        size_t maxCapacity = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t row = 0; row < NUM_ROWS; ++row)
+        {
+            values[0] = wxString::Format("%zu", row);
+            values[1] = wxString::Format("Name_%zu", row % 1000);
+            values[2] = wxString::Format("%zu.50", row % 100000);
+            writer.writeRow(values, nulls);
+            std::string& buffer = writer.getBuffer();
+            if (buffer.size() >= writeSize)
+            {
+                written += buffer.size();
+                maxCapacity = std::max(maxCapacity, buffer.capacity());
+                buffer.clear();
+            }
+        }
+        written += writer.getBuffer().size();
+        auto end = std::chrono::high_resolution_clock::now();
+        auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        std::cout << "  INFO: 1M CSV rows (" << written / (1024 * 1024) << " MB) formatted in "
+                  << elapsedMs << " ms\n";
+        ok = check(writer.getRowCount() == NUM_ROWS, "1M rows written") && ok;
+        ok = check(maxCapacity < 2 * writeSize, "Buffer stays below 2 MB") && ok;
+    }
+
+    // Test 7: Excel workbook sheets keep NULL cells and store numbers with
+    // a decimal point
+    {
+        DataGridExportWriter writer(DataGridExportWriter::formatXLSX);
+        writer.writeHeader({ "ID", "NAME", "AMOUNT" }, { true, false, true });
+        writer.writeRow({ "1", "a<b", "2,50" }, { false, false, false });
+        writer.writeRow({ wxString(), "x", "n/a" }, { true, false, false });
+        writer.writeFooter();
+        const std::string& xml = writer.getBuffer();
+        ok = check(xml.find("<row><c><v>1</v></c><c t=\"inlineStr\"><is>"
+            "<t xml:space=\"preserve\">a&lt;b</t></is></c><c><v>2.50</v></c></row>")
+            != std::string::npos, "Workbook number and text cells") && ok;
+        ok = check(xml.find("<row><c/><c t=\"inlineStr\">") != std::string::npos
+            && xml.find(">n/a</t>") != std::string::npos,
+            "Workbook NULL cell and text in numeric column") && ok;
+        ok = check(xml.find("</sheetData>") != std::string::npos,
+            "Workbook footer") && ok;
+    }
+
+    // Test 8: rows exported on several threads are the same as those of a
+    // single writer, whatever the number of threads
+    {
+        TestGrid grid(7);
+        const size_t rowCount = 3 * DataGridParallelExport::rowsPerBlock + 17;
+        const DataGridExportWriter::Format formats[] = {
+            DataGridExportWriter::formatCSV, DataGridExportWriter::formatJSON,
+            DataGridExportWriter::formatExcel };
+        bool same = true;
+        for (DataGridExportWriter::Format format : formats)
+        {
+            std::string expected = writeGrid(grid, format, rowCount);
+            for (unsigned threads : { 1u, 2u, 5u })
+            {
+                bool written;
+                exportGrid(grid, format, rowCount, threads, written);
+                same = written && readFile() == expected && same;
+            }
+        }
+        ok = check(same, "Parallel export equals sequential export") && ok;
+
+        bool written;
+        exportGrid(grid, DataGridExportWriter::formatJSON, 0, 4, written);
+        ok = check(written && readFile() == writeGrid(grid,
+            DataGridExportWriter::formatJSON, 0), "Export without rows") && ok;
+
+        exportGrid(grid, DataGridExportWriter::formatXLSX, rowCount, 4, written);
+        ok = check(written && readFile().compare(0, 4, "PK\x03\x04") == 0,
+            "Workbook is a zip archive") && ok;
+    }
+
+    // Test 9: an exception while reading a row stops all threads and is
+    // rethrown
+    {
+        TestGrid grid(3);
+        DataGridExportFile file;
+        DataGridParallelExport exporter(DataGridExportWriter::formatCSV);
+        bool thrown = false;
+        try
+        {
+            file.create(fileName, DataGridExportWriter::formatCSV);
+            exporter.write(file, grid.names, grid.numeric, 100000, 4,
+                [&grid](unsigned, size_t row, std::vector<wxString>& values,
+                    std::vector<bool>& nulls)
+                {
+                    if (row == 50000)
+                        throw std::runtime_error("read error");
+                    grid.readRow(row, values, nulls);
+                });
+        }
+        catch (const std::runtime_error&)
+        {
+            thrown = true;
+        }
+        file.close();
+        ok = check(thrown, "Read error is rethrown") && ok;
+    }
+
+    // Test 10: exporting 1M rows of 30 columns on all cores compared to one
+    // thread, and to just writing the same amount of data
+    {
+        TestGrid grid(30);
+        const size_t rowCount = 1000000;
+        unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+        bool written1, writtenN;
+        double singleMs = exportGrid(grid, DataGridExportWriter::formatCSV,
+            rowCount, 1, written1);
+        double parallelMs = exportGrid(grid, DataGridExportWriter::formatCSV,
+            rowCount, threads, writtenN);
+        std::string csv = readFile();
+
+        auto start = std::chrono::steady_clock::now();
+        {
+            std::ofstream out(fileName, std::ios::binary);
+            out.write(csv.data(), csv.size());
+        }
+        double writeMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "  INFO: 1M x 30 CSV (" << csv.size() / (1024 * 1024)
+                  << " MB) exported in " << singleMs << " ms on one thread, "
+                  << parallelMs << " ms on " << threads
+                  << " threads, writing it takes " << writeMs << " ms\n";
+        ok = check(written1 && writtenN && csv.size() > 100 * 1024 * 1024,
+            "1M x 30 export written") && ok;
+    }
+    std::remove(fileName);
+
+    std::cout << "DataGrid Export Tests completed: "
+              << (ok ? "ALL PASSED" : "SOME FAILED") << "\n";
+    return ok ? 0 : 1;
+}
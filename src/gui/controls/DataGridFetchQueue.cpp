@@ -0,0 +1,132 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+#include <thread>
+
+#include "gui/controls/DataGridFetchQueue.h"
+
+using namespace std::chrono;
+
+const milliseconds DataGridFetchQueue::batchInterval(20);
+
+DataGridFetchQueue::DataGridFetchQueue()
+    : headM(0), tailM(0), notifyPendingM(false), batchRowsM(minBatchRows),
+        drainMicrosM(0)
+{
+}
+
+void DataGridFetchQueue::reset()
+{
+    for (DataGridRowStore& slot : slotsM)
+        slot.clear();
+    headM = 0;
+    tailM = 0;
+    notifyPendingM = false;
+    batchRowsM = minBatchRows;
+    drainMicrosM = 0;
+}
+
+bool DataGridFetchQueue::isEmpty() const
+{
+    return headM.load(std::memory_order_acquire)
+        == tailM.load(std::memory_order_acquire);
+}
+
+bool DataGridFetchQueue::waitForSpace(const std::atomic<bool>& cancel) const
+{
+    size_t tail = tailM.load(std::memory_order_relaxed);
+    while (tail - headM.load(std::memory_order_acquire) >= capacity)
+    {
+        if (cancel)
+            return false;
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    return true;
+}
+
+unsigned DataGridFetchQueue::getBatchRows() const
+{
+    return batchRowsM.load(std::memory_order_relaxed);
+}
+
+bool DataGridFetchQueue::push(DataGridRowStore& batch,
+    steady_clock::duration elapsed)
+{
+    size_t tail = tailM.load(std::memory_order_relaxed);
+    wxASSERT(tail - headM.load(std::memory_order_acquire) < capacity);
+
+    size_t rows = batch.getRowCount();
+    DataGridRowStore& slot = slotsM[tail % capacity];
+    slot = std::move(batch);
+    batch.setLayout(slot.getLayout());
+    tailM.store(tail + 1, std::memory_order_release);
+
+    // rows that can be fetched in the target time, smoothed over batches
+    long long micros = duration_cast<microseconds>(elapsed).count();
+    long long target = std::max<long long>(
+        duration_cast<microseconds>(batchInterval).count(),
+        2 * drainMicrosM.load(std::memory_order_relaxed));
+    if (rows > 0 && micros > 0)
+    {
+        long long wanted = (long long)rows * target / micros;
+        long long next = (getBatchRows() + wanted) / 2;
+        batchRowsM.store((unsigned)std::min<long long>(maxBatchRows,
+            std::max<long long>(minBatchRows, next)),
+            std::memory_order_relaxed);
+    }
+
+    return !notifyPendingM.exchange(true);
+}
+
+void DataGridFetchQueue::beginDrain()
+{
+    notifyPendingM.store(false);
+}
+
+bool DataGridFetchQueue::pop(DataGridRowStore& batch)
+{
+    size_t head = headM.load(std::memory_order_relaxed);
+    if (head == tailM.load(std::memory_order_acquire))
+        return false;
+    DataGridRowStore& slot = slotsM[head % capacity];
+    batch = std::move(slot);
+    slot = DataGridRowStore();
+    headM.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+void DataGridFetchQueue::endDrain(steady_clock::duration elapsed)
+{
+    drainMicrosM.store(duration_cast<microseconds>(elapsed).count(),
+        std::memory_order_relaxed);
+}
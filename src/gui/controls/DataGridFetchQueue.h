@@ -0,0 +1,82 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_DATAGRIDFETCHQUEUE_H
+#define FR_DATAGRIDFETCHQUEUE_H
+
+#include <atomic>
+#include <chrono>
+
+#include "gui/controls/DataGridRowStore.h"
+
+// DataGridFetchQueue class
+// Bounded single-producer/single-consumer ring of row batches between the
+// background fetch thread (producer) and the UI thread (consumer), without
+// any lock.
+// The producer waits for a free slot before it fetches a batch, so a batch
+// can always be queued, even when the fetch is cancelled.
+// The number of rows per batch adapts to the fetch rate and to the time
+// the UI thread needs to take the rows over: a batch should take about as
+// long to fetch as twice the last drain, but at least batchInterval.
+// Only the first batch after a drain asks for a notification, so at most
+// one notification is pending at any time.
+class DataGridFetchQueue
+{
+public:
+    enum { capacity = 8 };
+    enum { minBatchRows = 256, maxBatchRows = 65536 };
+    static const std::chrono::milliseconds batchInterval;
+private:
+    DataGridRowStore slotsM[capacity];
+    // both only ever increase, the slot index is the value modulo capacity
+    std::atomic<size_t> headM;
+    std::atomic<size_t> tailM;
+    std::atomic<bool> notifyPendingM;
+    std::atomic<unsigned> batchRowsM;
+    std::atomic<long long> drainMicrosM;
+public:
+    DataGridFetchQueue();
+
+    // empties the queue, only while there is no producer
+    void reset();
+    bool isEmpty() const;
+
+    // producer side
+    // waits until a batch can be pushed, returns false if cancelled first
+    bool waitForSpace(const std::atomic<bool>& cancel) const;
+    unsigned getBatchRows() const;
+    // moves batch into the queue, batch is left empty with the same layout;
+    // elapsed is the time it took to fetch the batch
+    // returns true if the consumer needs to be notified
+    bool push(DataGridRowStore& batch,
+        std::chrono::steady_clock::duration elapsed);
+
+    // consumer side
+    // to be called before the batches are taken, so no notification for
+    // batches pushed while draining gets lost
+    void beginDrain();
+    bool pop(DataGridRowStore& batch);
+    void endDrain(std::chrono::steady_clock::duration elapsed);
+};
+
+#endif
@@ -0,0 +1,262 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+#include <string_view>
+#include <thread>
+
+#include "gui/controls/DataGridFilterIndex.h"
+
+namespace
+{
+
+// splits [0, count) into one range per thread, ranges smaller than
+// minPerThread are not worth a thread of their own
+template<typename Work>
+void runParallel(size_t count, size_t minPerThread, Work work)
+{
+    size_t threads = std::min<size_t>(std::thread::hardware_concurrency(),
+        count / minPerThread);
+    if (threads < 2)
+    {
+        work(0, count);
+        return;
+    }
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < threads; ++i)
+    {
+        workers.emplace_back(work, count * i / threads,
+            count * (i + 1) / threads);
+    }
+    for (std::thread& t : workers)
+        t.join();
+}
+
+} // namespace
+
+DataGridFilterIndex::DataGridFilterIndex()
+    : lastRowCountM(0)
+{
+}
+
+void DataGridFilterIndex::reset(unsigned columnCount)
+{
+    columnsM.clear();
+    columnsM.resize(columnCount);
+    for (Column& c : columnsM)
+        c.rowCount = 0;
+    lastQueryM.clear();
+    lastMatchesM.clear();
+    lastRowCountM = 0;
+}
+
+void DataGridFilterIndex::clear()
+{
+    reset(getColumnCount());
+}
+
+unsigned DataGridFilterIndex::getColumnCount() const
+{
+    return (unsigned)columnsM.size();
+}
+
+size_t DataGridFilterIndex::getRowCount(unsigned col) const
+{
+    return col < columnsM.size() ? columnsM[col].rowCount : 0;
+}
+
+size_t DataGridFilterIndex::getRowCount() const
+{
+    if (columnsM.empty())
+        return 0;
+    size_t count = columnsM[0].rowCount;
+    for (const Column& c : columnsM)
+        count = std::min(count, c.rowCount);
+    return count;
+}
+
+size_t DataGridFilterIndex::getMemoryUsage() const
+{
+    size_t total = 0;
+    for (const Column& c : columnsM)
+    {
+        for (const Block& b : c.blocks)
+        {
+            total += sizeof(Block) + b.text.capacity()
+                + b.ends.capacity() * sizeof(uint32_t);
+        }
+    }
+    return total + lastMatchesM.capacity() * sizeof(size_t);
+}
+
+void DataGridFilterIndex::appendText(unsigned col, const wxString& text)
+{
+    wxASSERT(col < columnsM.size());
+    Column& column = columnsM[col];
+    if (column.rowCount % rowsPerBlock == 0)
+    {
+        column.blocks.emplace_back();
+        column.blocks.back().ends.reserve(rowsPerBlock);
+    }
+    Block& block = column.blocks.back();
+    block.text.append(text.Lower().utf8_str());
+    block.ends.push_back(uint32_t(block.text.size()));
+    ++column.rowCount;
+}
+
+bool DataGridFilterIndex::cellContains(const Column& column, size_t row,
+    const std::string& query) const
+{
+    const Block& block = column.blocks[row / rowsPerBlock];
+    size_t cell = row % rowsPerBlock;
+    size_t start = cell ? block.ends[cell - 1] : 0;
+    std::string_view text(block.text.data() + start,
+        block.ends[cell] - start);
+    return text.find(query) != std::string_view::npos;
+}
+
+bool DataGridFilterIndex::scanRows(size_t from, size_t to,
+    const std::string& query, std::vector<size_t>& matches,
+    const std::atomic<bool>& cancel) const
+{
+    if (from >= to)
+        return true;
+
+    // every thread searches the text of whole blocks, so no two threads
+    // write the same element of hits
+    std::vector<uint8_t> hits(to - from, 0);
+    size_t firstBlock = from / rowsPerBlock;
+    size_t blockCount = (to - 1) / rowsPerBlock + 1 - firstBlock;
+    runParallel(blockCount, 4, [&](size_t begin, size_t end)
+    {
+        for (size_t b = firstBlock + begin; b < firstBlock + end; ++b)
+        {
+            if (cancel)
+                return;
+            size_t blockStart = b * rowsPerBlock;
+            size_t c0 = std::max(from, blockStart) - blockStart;
+            size_t c1 = std::min(to, blockStart + rowsPerBlock) - blockStart;
+            for (const Column& column : columnsM)
+            {
+                const Block& block = column.blocks[b];
+                std::string_view text(block.text.data(), block.ends[c1 - 1]);
+                size_t pos = c0 ? block.ends[c0 - 1] : 0;
+                while ((pos = text.find(query, pos)) != std::string_view::npos)
+                {
+                    // cell that contains pos, matches must not span cells
+                    size_t cell = std::upper_bound(block.ends.begin() + c0,
+                        block.ends.begin() + c1, uint32_t(pos))
+                        - block.ends.begin();
+                    if (pos + query.size() <= block.ends[cell])
+                        hits[blockStart + cell - from] = 1;
+                    pos = block.ends[cell];
+                }
+            }
+        }
+    });
+    if (cancel)
+        return false;
+
+    for (size_t i = 0; i < hits.size(); ++i)
+    {
+        if (hits[i])
+            matches.push_back(from + i);
+    }
+    return true;
+}
+
+bool DataGridFilterIndex::checkRows(const std::vector<size_t>& rows,
+    const std::string& query, std::vector<size_t>& matches,
+    const std::atomic<bool>& cancel) const
+{
+    std::vector<uint8_t> keep(rows.size(), 0);
+    runParallel(rows.size(), 16384, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (i % 1024 == 0 && cancel)
+                return;
+            for (const Column& column : columnsM)
+            {
+                if (cellContains(column, rows[i], query))
+                {
+                    keep[i] = 1;
+                    break;
+                }
+            }
+        }
+    });
+    if (cancel)
+        return false;
+
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+        if (keep[i])
+            matches.push_back(rows[i]);
+    }
+    return true;
+}
+
+bool DataGridFilterIndex::filter(const wxString& query,
+    std::vector<size_t>& matches, const std::atomic<bool>& cancel)
+{
+    std::string lowered(query.Lower().utf8_str());
+    size_t rowCount = getRowCount();
+    std::vector<size_t> result;
+    result.reserve(lastQueryM.empty() ? rowCount : lastMatchesM.size());
+
+    if (lowered.empty())
+    {
+        for (size_t row = 0; row < rowCount; ++row)
+            result.push_back(row);
+    }
+    else if (!lastQueryM.empty() && lastRowCountM <= rowCount
+        && lowered.find(lastQueryM) != std::string::npos)
+    {
+        // every row that contains the new query also contains the last
+        // one, only the previous matches and the new rows need checking
+        if (lowered == lastQueryM)
+            result = lastMatchesM;
+        else if (!checkRows(lastMatchesM, lowered, result, cancel))
+            return false;
+        if (!scanRows(lastRowCountM, rowCount, lowered, result, cancel))
+            return false;
+    }
+    else if (!scanRows(0, rowCount, lowered, result, cancel))
+        return false;
+
+    lastQueryM = lowered;
+    lastMatchesM = result;
+    lastRowCountM = rowCount;
+    matches.swap(result);
+    return true;
+}
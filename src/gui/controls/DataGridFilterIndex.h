@@ -0,0 +1,89 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_DATAGRIDFILTERINDEX_H
+#define FR_DATAGRIDFILTERINDEX_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <wx/string.h>
+
+// DataGridFilterIndex class
+// Keeps the formatted cell text of all grid rows, lower-cased and UTF-8
+// encoded, in one contiguous block of text per column and 4096 rows.
+// Rows are appended column by column as they are formatted, so building
+// the index can be spread over several filter runs.
+// The last query and its matches are remembered: when the next query
+// contains the last one only the previous matches and the rows that were
+// added since are checked again.
+class DataGridFilterIndex
+{
+public:
+    enum { rowsPerBlock = 4096 };
+private:
+    struct Block
+    {
+        std::string text;
+        // end of every cell in text, a cell starts where the previous ends
+        std::vector<uint32_t> ends;
+    };
+    struct Column
+    {
+        std::vector<Block> blocks;
+        size_t rowCount;
+    };
+
+    std::vector<Column> columnsM;
+    std::string lastQueryM;
+    std::vector<size_t> lastMatchesM;
+    size_t lastRowCountM;
+
+    bool cellContains(const Column& column, size_t row,
+        const std::string& query) const;
+    bool scanRows(size_t from, size_t to, const std::string& query,
+        std::vector<size_t>& matches, const std::atomic<bool>& cancel) const;
+    bool checkRows(const std::vector<size_t>& rows, const std::string& query,
+        std::vector<size_t>& matches, const std::atomic<bool>& cancel) const;
+public:
+    DataGridFilterIndex();
+
+    // drops all text, the index is then set up for columnCount columns
+    void reset(unsigned columnCount);
+    void clear();
+    unsigned getColumnCount() const;
+    // number of rows with text for column col, respectively for all columns
+    size_t getRowCount(unsigned col) const;
+    size_t getRowCount() const;
+    size_t getMemoryUsage() const;
+
+    void appendText(unsigned col, const wxString& text);
+    // puts all indexed rows that contain query (case-insensitive) in any
+    // column into matches, in ascending order; returns false if cancelled
+    bool filter(const wxString& query, std::vector<size_t>& matches,
+        const std::atomic<bool>& cancel);
+};
+
+#endif
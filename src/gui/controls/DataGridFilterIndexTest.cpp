@@ -0,0 +1,191 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// Tests for the text index of the result grid quick filter
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <wx/wxprec.h>
+#ifndef WX_PRECOMP
+    #include <wx/wx.h>
+#endif
+
+#include "gui/controls/DataGridFilterIndex.h"
+
+namespace
+{
+
+static bool check(bool condition, const char* testName)
+{
+    if (condition)
+    {
+        std::cout << "  PASSED: " << testName << "\n";
+        return true;
+    }
+    else
+    {
+        std::cout << "  FAILED: " << testName << "\n";
+        return false;
+    }
+}
+
+wxString cellText(size_t row, unsigned col)
+{
+    switch (col)
+    {
+        case 0:
+            return wxString::Format("%zu", row);
+        case 1:
+            return wxString::Format("Name_%zu", row % 1000);
+        default:
+            return (row % 3) ? wxString("Active") : wxString("Closed");
+    }
+}
+
+// the way the grid filtered before the index existed
+std::vector<size_t> filterBruteForce(size_t rows, const wxString& query)
+{
+    std::vector<size_t> result;
+    wxString lowered = query.Lower();
+    for (size_t r = 0; r < rows; ++r)
+    {
+        for (unsigned c = 0; c < 3; ++c)
+        {
+            if (cellText(r, c).Lower().Contains(lowered))
+            {
+                result.push_back(r);
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+void appendRows(DataGridFilterIndex& index, size_t from, size_t to)
+{
+    for (unsigned c = 0; c < 3; ++c)
+    {
+        for (size_t r = from; r < to; ++r)
+            index.appendText(c, cellText(r, c));
+    }
+}
+
+} // namespace
+
+int main()
+{
+    wxInitializer initializer;
+    if (!initializer.IsOk())
+    {
+        std::cerr << "Failed to initialize wxWidgets.\n";
+        return 1;
+    }
+
+    bool ok = true;
+    std::atomic<bool> noCancel{false};
+    std::cout << "Running DataGrid Filter Index Tests...\n";
+
+    // Test 1: Matches are case-insensitive and never span two cells
+    {
+        DataGridFilterIndex index;
+        index.reset(2);
+        index.appendText(0, "Hello");
+        index.appendText(1, "World");
+        index.appendText(0, "lowo");
+        index.appendText(1, "");
+        std::vector<size_t> matches;
+        ok = check(index.filter("HELLO", matches, noCancel)
+            && matches == std::vector<size_t>({ 0 }), "Case-insensitive match") && ok;
+        ok = check(index.filter("lowo", matches, noCancel)
+            && matches == std::vector<size_t>({ 1 }), "Match does not span cells") && ok;
+        ok = check(index.filter("", matches, noCancel) && matches.size() == 2,
+            "Empty query matches all rows") && ok;
+    }
+
+    // Test 2: Extended queries and new rows give the same result as a scan
+    {
+        const size_t NUM_ROWS = 200000;
+        DataGridFilterIndex index;
+        index.reset(3);
+        appendRows(index, 0, NUM_ROWS);
+        ok = check(index.getRowCount() == NUM_ROWS, "200k rows indexed") && ok;
+
+        std::vector<size_t> matches;
+        index.filter("na", matches, noCancel);
+        ok = check(matches == filterBruteForce(NUM_ROWS, "na"), "Query 'na' matches scan") && ok;
+        index.filter("name_12", matches, noCancel);
+        ok = check(matches == filterBruteForce(NUM_ROWS, "name_12"), "Extended query matches scan") && ok;
+
+        appendRows(index, NUM_ROWS, NUM_ROWS + 5000);
+        index.filter("name_123", matches, noCancel);
+        ok = check(matches == filterBruteForce(NUM_ROWS + 5000, "name_123"),
+            "Extended query after new rows matches scan") && ok;
+        index.filter("clo", matches, noCancel);
+        ok = check(matches == filterBruteForce(NUM_ROWS + 5000, "clo"),
+            "Unrelated query rescans all rows") && ok;
+    }
+
+    // Test 3: A cancelled filter returns false and keeps the last result
+    {
+        DataGridFilterIndex index;
+        index.reset(3);
+        appendRows(index, 0, 10000);
+        std::vector<size_t> matches;
+        std::atomic<bool> cancel{true};
+        ok = check(!index.filter("active", matches, cancel) && matches.empty(),
+            "Cancelled filter returns false") && ok;
+        index.filter("act", matches, noCancel);
+        ok = check(matches == filterBruteForce(10000, "act"), "Filter after cancel is complete") && ok;
+    }
+
+    // Test 4: Filtering 2M indexed rows per keystroke
+    {
+        const size_t NUM_ROWS = 2000000;
+        DataGridFilterIndex index;
+        index.reset(3);
+        appendRows(index, 0, NUM_ROWS);
+        std::cout << "  INFO: Index of 2M rows uses "
+                  << index.getMemoryUsage() / (1024 * 1024) << " MB\n";
+
+        const char* keystrokes[] = { "n", "na", "nam", "name", "name_", "name_9", "name_99" };
+        std::vector<size_t> matches;
+        long long slowestMs = 0;
+        for (const char* query : keystrokes)
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            index.filter(query, matches, noCancel);
+            auto end = std::chrono::high_resolution_clock::now();
+            long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+            std::cout << "  INFO: '" << query << "': " << matches.size() << " rows in " << ms << " ms\n";
+            slowestMs = std::max(slowestMs, ms);
+        }
+        ok = check(matches.size() == 22000, "Final query matches 22000 rows") && ok;
+        ok = check(slowestMs < 2000, "Every keystroke filters 2M rows in < 2000 ms") && ok;
+    }
+
+    std::cout << "DataGrid Filter Index Tests completed: "
+              << (ok ? "ALL PASSED" : "SOME FAILED") << "\n";
+    return ok ? 0 : 1;
+}
@@ -159,6 +159,27 @@ bool DataGridRowBuffer::getValue32(unsigned offset, int& timeZone, bool& isGmtFa
     return true;
 }
 
+void DataGridRowBuffer::getData(unsigned offset, uint8_t* data,
+    unsigned size)
+{
+    unsigned available = 0;
+    if (offset < dataM.size())
+        available = std::min(size, unsigned(dataM.size() - offset));
+    if (available)
+        memcpy(data, &dataM[offset], available);
+    if (available < size)
+        memset(data + available, 0, size - available);
+}
+
+void DataGridRowBuffer::setData(unsigned offset, const uint8_t* data,
+    unsigned size)
+{
+    if (offset + size > dataM.size())
+        dataM.resize(offset + size, 0);
+    memcpy(&dataM[offset], data, size);
+    invalidateIsDeletable();
+}
+
 bool DataGridRowBuffer::isFieldNA(unsigned /*num*/)
 {
     return false;
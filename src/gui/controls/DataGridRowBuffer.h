@@ -73,6 +73,9 @@ public:
     bool getValue(unsigned offset, int128_t& value);
     bool getValue(unsigned offset, fr::DBKey& value, unsigned size);
     bool getValue32(unsigned offset, int& timeZone, bool& isGmtFallback);
+    // raw access to the value buffer, missing bytes are read as 0
+    void getData(unsigned offset, uint8_t* data, unsigned size);
+    void setData(unsigned offset, const uint8_t* data, unsigned size);
     bool isFieldNull(unsigned num);
     void setFieldNull(unsigned num, bool isNull);
     virtual bool isFieldNA(unsigned num);
@@ -0,0 +1,336 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <cstring>
+
+#include "gui/controls/DataGridRowBuffer.h"
+#include "gui/controls/DataGridRowStore.h"
+
+namespace
+{
+
+inline bool getNullBit(const std::vector<uint64_t>& bits, unsigned index)
+{
+    return (bits[index / 64] >> (index % 64)) & 1u;
+}
+
+inline void setNullBit(std::vector<uint64_t>& bits, unsigned index,
+    bool isNull)
+{
+    uint64_t mask = uint64_t(1) << (index % 64);
+    if (isNull)
+        bits[index / 64] |= mask;
+    else
+        bits[index / 64] &= ~mask;
+}
+
+} // namespace
+
+DataGridRowStore::DataGridRowStore()
+    : rowCountM(0)
+{
+}
+
+void DataGridRowStore::setLayout(const std::vector<DataGridColumnLayout>& layout)
+{
+    clear();
+    layoutM = layout;
+}
+
+const std::vector<DataGridColumnLayout>& DataGridRowStore::getLayout() const
+{
+    return layoutM;
+}
+
+void DataGridRowStore::clear()
+{
+    chunksM.clear();
+    rowCountM = 0;
+}
+
+size_t DataGridRowStore::getRowCount() const
+{
+    return rowCountM;
+}
+
+unsigned DataGridRowStore::getColumnCount() const
+{
+    return (unsigned)layoutM.size();
+}
+
+size_t DataGridRowStore::getMemoryUsage() const
+{
+    size_t total = 0;
+    for (const auto& chunk : chunksM)
+    {
+        total += sizeof(Chunk);
+        for (const ChunkColumn& c : chunk->columns)
+        {
+            total += sizeof(ChunkColumn)
+                + c.nullBits.capacity() * sizeof(uint64_t)
+                + c.data.capacity()
+                + c.textStart.capacity() * sizeof(size_t)
+                + c.textLength.capacity() * sizeof(uint32_t)
+                + c.arena.capacity() * sizeof(wxChar)
+                + c.blobs.capacity() * sizeof(fr::IBlobPtr);
+        }
+    }
+    return total;
+}
+
+DataGridRowStore::Chunk* DataGridRowStore::addChunk()
+{
+    std::unique_ptr<Chunk> chunk(new Chunk());
+    chunk->rowCount = 0;
+    chunk->columns.resize(layoutM.size());
+    chunksM.push_back(std::move(chunk));
+    return chunksM.back().get();
+}
+
+DataGridRowStore::Chunk& DataGridRowStore::getChunk(size_t row,
+    unsigned& index) const
+{
+    wxASSERT(row < rowCountM);
+    index = unsigned(row % rowsPerChunk);
+    return *chunksM[row / rowsPerChunk];
+}
+
+void DataGridRowStore::storeText(ChunkColumn& column, unsigned index,
+    const wxString& value)
+{
+#if wxUSE_UNICODE_WCHAR
+    const wxChar* text = value.wc_str();
+    size_t length = value.length();
+#else
+    wxScopedWCharBuffer buffer(value.wc_str());
+    const wxChar* text = buffer.data();
+    size_t length = buffer.length();
+#endif
+    column.textStart[index] = column.arena.size();
+    column.textLength[index] = uint32_t(length);
+    column.arena.insert(column.arena.end(), text, text + length);
+}
+
+void DataGridRowStore::appendRow(DataGridRowBuffer& buffer)
+{
+    Chunk* chunk = (rowCountM % rowsPerChunk == 0) ? addChunk()
+        : chunksM.back().get();
+    unsigned index = chunk->rowCount;
+    for (unsigned col = 0; col < layoutM.size(); ++col)
+    {
+        const DataGridColumnLayout& layout = layoutM[col];
+        ChunkColumn& column = chunk->columns[col];
+        bool isNull = buffer.isFieldNull(col);
+
+        if (index % 64 == 0)
+            column.nullBits.push_back(0);
+        setNullBit(column.nullBits, index, isNull);
+
+        if (layout.size)
+        {
+            size_t pos = column.data.size();
+            column.data.resize(pos + layout.size);
+            buffer.getData(layout.offset, &column.data[pos], layout.size);
+        }
+        if (layout.stringIndex >= 0)
+        {
+            column.textStart.push_back(0);
+            column.textLength.push_back(notLoaded);
+            if (!isNull && buffer.isStringLoaded(layout.stringIndex))
+            {
+                storeText(column, index,
+                    buffer.getString(layout.stringIndex));
+            }
+        }
+        if (layout.blobIndex >= 0)
+        {
+            column.blobs.push_back(isNull ? fr::IBlobPtr()
+                : buffer.getBlob(layout.blobIndex));
+        }
+    }
+    ++chunk->rowCount;
+    ++rowCountM;
+}
+
+void DataGridRowStore::appendEmptyRow()
+{
+    Chunk* chunk = (rowCountM % rowsPerChunk == 0) ? addChunk()
+        : chunksM.back().get();
+    unsigned index = chunk->rowCount;
+    for (unsigned col = 0; col < layoutM.size(); ++col)
+    {
+        const DataGridColumnLayout& layout = layoutM[col];
+        ChunkColumn& column = chunk->columns[col];
+
+        if (index % 64 == 0)
+            column.nullBits.push_back(0);
+        setNullBit(column.nullBits, index, true);
+        if (layout.size)
+            column.data.resize(column.data.size() + layout.size, 0);
+        if (layout.stringIndex >= 0)
+        {
+            column.textStart.push_back(0);
+            column.textLength.push_back(notLoaded);
+        }
+        if (layout.blobIndex >= 0)
+            column.blobs.push_back(fr::IBlobPtr());
+    }
+    ++chunk->rowCount;
+    ++rowCountM;
+}
+
+void DataGridRowStore::appendRows(DataGridRowStore& other)
+{
+    wxASSERT(layoutM.size() == other.layoutM.size());
+    if (other.rowCountM == 0)
+        return;
+
+    // when our last chunk is full the chunks can simply change owners,
+    // only the last chunk of other may be partially filled
+    if (rowCountM % rowsPerChunk == 0)
+    {
+        for (auto& chunk : other.chunksM)
+            chunksM.push_back(std::move(chunk));
+        rowCountM += other.rowCountM;
+        other.clear();
+        return;
+    }
+
+    for (const auto& source : other.chunksM)
+    {
+        for (unsigned srcIndex = 0; srcIndex < source->rowCount; ++srcIndex)
+        {
+            Chunk* chunk = (rowCountM % rowsPerChunk == 0) ? addChunk()
+                : chunksM.back().get();
+            unsigned index = chunk->rowCount;
+            for (unsigned col = 0; col < layoutM.size(); ++col)
+            {
+                const DataGridColumnLayout& layout = layoutM[col];
+                const ChunkColumn& from = source->columns[col];
+                ChunkColumn& column = chunk->columns[col];
+
+                if (index % 64 == 0)
+                    column.nullBits.push_back(0);
+                setNullBit(column.nullBits, index,
+                    getNullBit(from.nullBits, srcIndex));
+                if (layout.size)
+                {
+                    const uint8_t* data = &from.data[srcIndex * layout.size];
+                    column.data.insert(column.data.end(), data,
+                        data + layout.size);
+                }
+                if (layout.stringIndex >= 0)
+                {
+                    uint32_t length = from.textLength[srcIndex];
+                    column.textStart.push_back(column.arena.size());
+                    column.textLength.push_back(length);
+                    if (length != notLoaded)
+                    {
+                        const wxChar* text = &from.arena[from.textStart[srcIndex]];
+                        column.arena.insert(column.arena.end(), text,
+                            text + length);
+                    }
+                }
+                if (layout.blobIndex >= 0)
+                    column.blobs.push_back(from.blobs[srcIndex]);
+            }
+            ++chunk->rowCount;
+            ++rowCountM;
+        }
+    }
+    other.clear();
+}
+
+bool DataGridRowStore::isFieldNull(size_t row, unsigned col) const
+{
+    if (row >= rowCountM || col >= layoutM.size())
+        return false;
+    unsigned index;
+    const Chunk& chunk = getChunk(row, index);
+    return getNullBit(chunk.columns[col].nullBits, index);
+}
+
+void DataGridRowStore::loadField(size_t row, unsigned col,
+    DataGridRowBuffer& buffer) const
+{
+    if (row >= rowCountM || col >= layoutM.size())
+        return;
+    unsigned index;
+    const Chunk& chunk = getChunk(row, index);
+    const DataGridColumnLayout& layout = layoutM[col];
+    const ChunkColumn& column = chunk.columns[col];
+
+    buffer.setFieldNull(col, getNullBit(column.nullBits, index));
+    if (layout.size)
+    {
+        buffer.setData(layout.offset, &column.data[index * layout.size],
+            layout.size);
+    }
+    if (layout.stringIndex >= 0)
+    {
+        uint32_t length = column.textLength[index];
+        if (length == notLoaded)
+        {
+            buffer.setString(layout.stringIndex, wxEmptyString);
+            buffer.setStringLoaded(layout.stringIndex, false);
+        }
+        else
+        {
+            buffer.setString(layout.stringIndex,
+                wxString(&column.arena[column.textStart[index]], length));
+        }
+    }
+    if (layout.blobIndex >= 0)
+        buffer.setBlob(layout.blobIndex, column.blobs[index]);
+}
+
+void DataGridRowStore::loadRow(size_t row, DataGridRowBuffer& buffer) const
+{
+    // same order as DataGridRows::readRow(): highest offsets and indices
+    // first so that all memory of buffer is allocated at once
+    unsigned col = (unsigned)layoutM.size();
+    while (col > 0)
+        loadField(row, --col, buffer);
+}
+
+void DataGridRowStore::setFieldText(size_t row, unsigned col,
+    const wxString& value)
+{
+    if (row >= rowCountM || col >= layoutM.size()
+        || layoutM[col].stringIndex < 0)
+    {
+        return;
+    }
+    unsigned index;
+    Chunk& chunk = getChunk(row, index);
+    storeText(chunk.columns[col], index, value);
+}
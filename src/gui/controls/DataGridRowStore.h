@@ -0,0 +1,116 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_DATAGRIDROWSTORE_H
+#define FR_DATAGRIDROWSTORE_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <wx/string.h>
+
+#include "engine/db/IBlob.h"
+
+class DataGridRowBuffer;
+
+// Describes where a column keeps its data inside a DataGridRowBuffer:
+// fixed size values live at an offset in the uint8 buffer, strings and
+// blobs use an index into the string and blob arrays (-1 if unused)
+struct DataGridColumnLayout
+{
+    unsigned offset;
+    unsigned size;
+    int stringIndex;
+    int blobIndex;
+};
+
+// DataGridRowStore class
+// Columnar storage for fetched result set rows. Rows are kept in chunks of
+// a fixed number of rows, every chunk holds one contiguous block per column
+// for fixed size values, a null bitmap, and a character arena for the text
+// values of the column. This avoids the several heap allocations per row
+// that a DataGridRowBuffer needs.
+// As columns share no memory, one column may be read on a worker thread
+// while text is loaded into another one (see setFieldText()).
+// Values go in and out through a DataGridRowBuffer, so the existing
+// ResultsetColumnDef::setValue() and getAsString() code keeps working.
+class DataGridRowStore
+{
+public:
+    enum { rowsPerChunk = 4096 };
+private:
+    struct ChunkColumn
+    {
+        std::vector<uint64_t> nullBits;
+        std::vector<uint8_t> data;
+        // for text values: start in the column arena and length,
+        // length is notLoaded if no text is stored
+        std::vector<size_t> textStart;
+        std::vector<uint32_t> textLength;
+        std::vector<wxChar> arena;
+        std::vector<fr::IBlobPtr> blobs;
+    };
+    struct Chunk
+    {
+        unsigned rowCount;
+        std::vector<ChunkColumn> columns;
+    };
+    enum : uint32_t { notLoaded = 0xFFFFFFFFu };
+
+    std::vector<DataGridColumnLayout> layoutM;
+    std::vector<std::unique_ptr<Chunk>> chunksM;
+    size_t rowCountM;
+
+    Chunk* addChunk();
+    Chunk& getChunk(size_t row, unsigned& index) const;
+    void storeText(ChunkColumn& column, unsigned index,
+        const wxString& value);
+public:
+    DataGridRowStore();
+
+    void setLayout(const std::vector<DataGridColumnLayout>& layout);
+    const std::vector<DataGridColumnLayout>& getLayout() const;
+    void clear();
+
+    size_t getRowCount() const;
+    unsigned getColumnCount() const;
+    // approximate number of bytes held by the store
+    size_t getMemoryUsage() const;
+
+    // copies all fields of buffer into a new row
+    void appendRow(DataGridRowBuffer& buffer);
+    // appends a row with all fields NULL
+    void appendEmptyRow();
+    // moves all rows of other to the end of this store, other is cleared
+    void appendRows(DataGridRowStore& other);
+
+    bool isFieldNull(size_t row, unsigned col) const;
+    // transfers a single field or the complete row into buffer
+    void loadField(size_t row, unsigned col, DataGridRowBuffer& buffer) const;
+    void loadRow(size_t row, DataGridRowBuffer& buffer) const;
+    // stores text for columns that load it lazily (BLOB content)
+    void setFieldText(size_t row, unsigned col, const wxString& value);
+};
+
+#endif
@@ -37,7 +37,10 @@
 
 #include <algorithm>
 #include <bitset>
+#include <charconv>
 #include <string>
+#include <thread>
+#include <type_traits>
 
 #include "core/FRError.h"
 #include "core/FRInt128.h"
@@ -47,6 +50,7 @@
 #include "core/StringUtils.h"
 #include "gui/controls/DataGridRowBuffer.h"
 #include "gui/controls/DataGridRows.h"
+#include "gui/controls/DataGridTranscoder.h"
 #include "engine/db/IDatabase.h"
 #include "engine/db/ITransaction.h"
 #include "engine/db/IStatement.h"
@@ -58,6 +62,55 @@
 
 using namespace fr;
 
+namespace
+{
+
+// appends value with at least digits characters, like "%0*d" does, but
+// without parsing a format string for every cell
+template<typename T>
+void appendNumber(wxString& s, T value, int digits = 1)
+{
+    char buffer[32];
+    char* end = buffer + sizeof(buffer);
+    char* p = end;
+    typedef typename std::make_unsigned<T>::type U;
+    U u = value < 0 ? U(0) - U(value) : U(value);
+    do
+    {
+        *--p = char('0' + u % 10);
+        u /= 10;
+    }
+    while (u);
+    if (value < 0)
+        --digits;
+    while (end - p < digits)
+        *--p = '0';
+    if (value < 0)
+        *--p = '-';
+    s.append(p, end - p);
+}
+
+// the text of an integer with scale decimal digits
+template<typename T>
+wxString formatScaled(T value, short scale)
+{
+    wxString result;
+    appendNumber(result, value);
+    if (scale > 0)
+    {
+        int numStart = (result.GetChar(0) == '-') ? 1 : 0;
+
+        while (result.length() < scale + numStart + 1)
+            result.insert(numStart, "0");
+
+        result.insert(result.length() - scale,
+                      wxNumberFormatter::GetDecimalSeparator());
+    }
+    return result;
+}
+
+} // namespace
+
 
 GridCellFormats::GridCellFormats()
     : ConfigCache(config())
@@ -70,6 +123,11 @@ GridCellFormats& GridCellFormats::get()
     return gcf;
 }
 
+void GridCellFormats::load()
+{
+    ensureCacheValid();
+}
+
 void GridCellFormats::loadFromConfig()
 {
     floatingPointPrecisionM = config().get("NumberPrecision", 2);
@@ -85,6 +143,8 @@ void GridCellFormats::loadFromConfig()
     maxBlobKBytesM = config().get("DataGridFetchBlobAmount", 1);
     showBinaryBlobContentM = config().get("GridShowBinaryBlobs", false);
     showBlobContentM = config().get("DataGridFetchBlobs", true);
+    // read here as the locale can't be queried safely on worker threads
+    decimalSeparatorM = wxNumberFormatter::GetDecimalSeparator();
 }
 
 template<typename T>
@@ -93,8 +153,24 @@ wxString GridCellFormats::format(T value)
     ensureCacheValid();
 
     if (floatingPointPrecisionM >= 0 && floatingPointPrecisionM <= 18)
-        return wxString::Format("%.*f", floatingPointPrecisionM, value);
-    return wxString::Format("%f", value);
+        return formatFixed(value, floatingPointPrecisionM);
+    return formatFixed(value, 6);
+}
+
+wxString GridCellFormats::formatFixed(double value, int precision)
+{
+    ensureCacheValid();
+
+    // same as "%.*f", the largest double has 309 digits before the point
+    char buffer[512];
+    std::to_chars_result r = std::to_chars(buffer, buffer + sizeof(buffer),
+        value, std::chars_format::fixed, precision);
+    if (r.ec != std::errc())
+        return wxString::Format("%.*f", precision, value);
+    wxString result(buffer, r.ptr - buffer);
+    if (decimalSeparatorM != '.')
+        result.Replace(".", wxString(decimalSeparatorM), false);
+    return result;
 }
 
 wxString GridCellFormats::formatDate(int year, int month, int day)
@@ -108,22 +184,22 @@ wxString GridCellFormats::formatDate(int year, int month, int day)
         switch (wxChar(*c))
         {
             case 'd':
-                result += wxString::Format("%d", day);
+                appendNumber(result, day);
                 break;
             case 'D':
-                result += wxString::Format("%02d", day);
+                appendNumber(result, day, 2);
                 break;
             case 'm':
-                result += wxString::Format("%d", month);
+                appendNumber(result, month);
                 break;
             case 'M':
-                result += wxString::Format("%02d", month);
+                appendNumber(result, month, 2);
                 break;
             case 'y':
-                result += wxString::Format("%02d", year % 100);
+                appendNumber(result, year % 100, 2);
                 break;
             case 'Y':
-                result += wxString::Format("%04d", year);
+                appendNumber(result, year, 4);
                 break;
             default:
                 result += *c;
@@ -227,25 +303,25 @@ wxString GridCellFormats::formatTime(IBPP::Time &t, bool hasTz, Database* db)
         switch ((wxChar)*c)
         {
             case 'h':
-                result += wxString::Format("%d", hour);
+                appendNumber(result, hour);
                 break;
             case 'H':
-                result += wxString::Format("%02d", hour);
+                appendNumber(result, hour, 2);
                 break;
             case 'm':
-                result += wxString::Format("%d", minute);
+                appendNumber(result, minute);
                 break;
             case 'M':
-                result += wxString::Format("%02d", minute);
+                appendNumber(result, minute, 2);
                 break;
             case 's':
-                result += wxString::Format("%d", second);
+                appendNumber(result, second);
                 break;
             case 'S':
-                result += wxString::Format("%02d", second);
+                appendNumber(result, second, 2);
                 break;
             case 'T':
-                result += wxString::Format("%03d", tenththousands / 10);
+                appendNumber(result, tenththousands / 10, 3);
                 break;
             default:
                 result += *c;
@@ -317,43 +393,43 @@ wxString GridCellFormats::formatTimestamp(IBPP::Timestamp &ts, bool hasTz,
         switch ((wxChar)*c)
         {
             case 'd':
-                result += wxString::Format("%d", day);
+                appendNumber(result, day);
                 break;
             case 'D':
-                result += wxString::Format("%02d", day);
+                appendNumber(result, day, 2);
                 break;
             case 'n':
-                result += wxString::Format("%d", month);
+                appendNumber(result, month);
                 break;
             case 'N':
-                result += wxString::Format("%02d", month);
+                appendNumber(result, month, 2);
                 break;
             case 'y':
-                result += wxString::Format("%02d", year % 100);
+                appendNumber(result, year % 100, 2);
                 break;
             case 'Y':
-                result += wxString::Format("%04d", year);
+                appendNumber(result, year, 4);
                 break;
             case 'h':
-                result += wxString::Format("%d", hour);
+                appendNumber(result, hour);
                 break;
             case 'H':
-                result += wxString::Format("%02d", hour);
+                appendNumber(result, hour, 2);
                 break;
             case 'm':
-                result += wxString::Format("%d", minute);
+                appendNumber(result, minute);
                 break;
             case 'M':
-                result += wxString::Format("%02d", minute);
+                appendNumber(result, minute, 2);
                 break;
             case 's':
-                result += wxString::Format("%d", second);
+                appendNumber(result, second);
                 break;
             case 'S':
-                result += wxString::Format("%02d", second);
+                appendNumber(result, second, 2);
                 break;
             case 'T':
-                result += wxString::Format("%03d", tenththousands / 10);
+                appendNumber(result, tenththousands / 10, 3);
                 break;
             default:
                 result += *c;
@@ -516,6 +592,22 @@ bool ResultsetColumnDef::isNumeric()
     return false;
 }
 
+DataGridSortKeyType ResultsetColumnDef::getSortKeyType()
+{
+    return sktText;
+}
+
+void ResultsetColumnDef::getSortKey(DataGridRowBuffer* buffer, Database* db,
+    DataGridSortKeys& keys, size_t index)
+{
+    keys.setText(index, getAsString(buffer, db));
+}
+
+bool ResultsetColumnDef::canFormatConcurrently()
+{
+    return true;
+}
+
 bool ResultsetColumnDef::isReadOnly()
 {
     return readOnlyM;
@@ -582,6 +674,9 @@ public:
         bool nullable, short scale);
     virtual wxString getAsString(DataGridRowBuffer* buffer, Database* db);
     virtual unsigned getBufferSize();
+    virtual DataGridSortKeyType getSortKeyType();
+    virtual void getSortKey(DataGridRowBuffer* buffer, Database* db,
+        DataGridSortKeys& keys, size_t index);
     virtual bool isNumeric();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
         const IBPP::Statement& statement, wxMBConv* converter, Database* db);
@@ -602,23 +697,9 @@ wxString IntegerColumnDef::getAsString(DataGridRowBuffer* buffer, Database*)
 {
     wxASSERT(buffer);
     int value;
-    wxString result;
-    int numStart;
-
     if (!buffer->getValue(offsetM, value))
         return wxEmptyString;
-    result = wxString::Format("%d", value);
-    if (scaleM > 0)
-    {
-        numStart = (result.GetChar(0) == '-') ? 1 : 0;
-
-        while (result.length() < scaleM + numStart + 1)
-            result.insert(numStart, "0");
-
-        result.insert(result.length() - scaleM,
-                      wxNumberFormatter::GetDecimalSeparator());
-    }
-    return result;
+    return formatScaled(value, scaleM);
 }
 
 void IntegerColumnDef::setFromString(DataGridRowBuffer* buffer,
@@ -664,6 +745,20 @@ unsigned IntegerColumnDef::getBufferSize()
     return sizeof(int);
 }
 
+DataGridSortKeyType IntegerColumnDef::getSortKeyType()
+{
+    return sktInteger;
+}
+
+void IntegerColumnDef::getSortKey(DataGridRowBuffer* buffer, Database*,
+    DataGridSortKeys& keys, size_t index)
+{
+    wxASSERT(buffer);
+    int value = 0;
+    buffer->getValue(offsetM, value);
+    keys.integers[index] = value;
+}
+
 bool IntegerColumnDef::isNumeric()
 {
     return true;
@@ -696,6 +791,9 @@ public:
         bool nullable, short scale);
     virtual wxString getAsString(DataGridRowBuffer* buffer, Database* db);
     virtual unsigned getBufferSize();
+    virtual DataGridSortKeyType getSortKeyType();
+    virtual void getSortKey(DataGridRowBuffer* buffer, Database* db,
+        DataGridSortKeys& keys, size_t index);
     virtual bool isNumeric();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
         const IBPP::Statement& statement, wxMBConv* converter, Database* db);
@@ -716,23 +814,9 @@ wxString Int64ColumnDef::getAsString(DataGridRowBuffer* buffer, Database*)
 {
     wxASSERT(buffer);
     int64_t value;
-    wxString result;
-    int numStart;
-
     if (!buffer->getValue(offsetM, value))
         return wxEmptyString;
-    result = wxLongLong(value).ToString();
-    if (scaleM > 0)
-    {
-        numStart = (result.GetChar(0) == '-') ? 1 : 0;
-
-        while (result.length() < scaleM + numStart + 1)
-            result.insert(numStart, "0");
-
-        result.insert(result.length() - scaleM,
-                      wxNumberFormatter::GetDecimalSeparator());
-    }
-    return result;
+    return formatScaled(value, scaleM);
 }
 
 void Int64ColumnDef::setFromString(DataGridRowBuffer* buffer,
@@ -786,6 +870,20 @@ unsigned Int64ColumnDef::getBufferSize()
     return sizeof(int64_t);
 }
 
+DataGridSortKeyType Int64ColumnDef::getSortKeyType()
+{
+    return sktInteger;
+}
+
+void Int64ColumnDef::getSortKey(DataGridRowBuffer* buffer, Database*,
+    DataGridSortKeys& keys, size_t index)
+{
+    wxASSERT(buffer);
+    int64_t value = 0;
+    buffer->getValue(offsetM, value);
+    keys.integers[index] = value;
+}
+
 bool Int64ColumnDef::isNumeric()
 {
     return true;
@@ -818,6 +916,9 @@ public:
         bool nullable, short scale);
     virtual wxString getAsString(DataGridRowBuffer* buffer, Database* db);
     virtual unsigned getBufferSize();
+    virtual DataGridSortKeyType getSortKeyType();
+    virtual void getSortKey(DataGridRowBuffer* buffer, Database* db,
+        DataGridSortKeys& keys, size_t index);
     virtual bool isNumeric();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
         const IBPP::Statement& statement, wxMBConv* converter, Database* db);
@@ -901,6 +1002,20 @@ unsigned Int128ColumnDef::getBufferSize()
     return sizeof(int128_t);
 }
 
+DataGridSortKeyType Int128ColumnDef::getSortKeyType()
+{
+    return sktInt128;
+}
+
+void Int128ColumnDef::getSortKey(DataGridRowBuffer* buffer, Database*,
+    DataGridSortKeys& keys, size_t index)
+{
+    wxASSERT(buffer);
+    int128_t value = 0;
+    buffer->getValue(offsetM, value);
+    keys.int128s[index] = value;
+}
+
 bool Int128ColumnDef::isNumeric()
 {
     return true;
@@ -1022,6 +1137,9 @@ public:
     virtual wxString getAsFirebirdString(DataGridRowBuffer* buffer);
     virtual wxString getAsString(DataGridRowBuffer* buffer, Database* db);
     virtual unsigned getBufferSize();
+    virtual DataGridSortKeyType getSortKeyType();
+    virtual void getSortKey(DataGridRowBuffer* buffer, Database* db,
+        DataGridSortKeys& keys, size_t index);
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
         const IBPP::Statement& statement, wxMBConv* converter, Database* db);
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
@@ -1098,6 +1216,20 @@ unsigned DateColumnDef::getBufferSize()
     return sizeof(int);
 }
 
+DataGridSortKeyType DateColumnDef::getSortKeyType()
+{
+    return sktInteger;
+}
+
+void DateColumnDef::getSortKey(DataGridRowBuffer* buffer, Database*,
+    DataGridSortKeys& keys, size_t index)
+{
+    wxASSERT(buffer);
+    int value = 0;
+    buffer->getValue(offsetM, value);
+    keys.integers[index] = value;
+}
+
 void DateColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
     const IBPP::Statement& statement, wxMBConv*, Database*)
 {
@@ -1131,6 +1263,10 @@ public:
     virtual wxString getAsFirebirdString(DataGridRowBuffer* buffer);
     virtual wxString getAsString(DataGridRowBuffer* buffer, Database* db);
     virtual unsigned getBufferSize();
+    virtual DataGridSortKeyType getSortKeyType();
+    virtual void getSortKey(DataGridRowBuffer* buffer, Database* db,
+        DataGridSortKeys& keys, size_t index);
+    virtual bool canFormatConcurrently();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
         const IBPP::Statement& statement, wxMBConv* converter, Database* db);
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
@@ -1237,6 +1373,27 @@ unsigned TimeColumnDef::getBufferSize()
     return result;
 }
 
+DataGridSortKeyType TimeColumnDef::getSortKeyType()
+{
+    return sktInteger;
+}
+
+void TimeColumnDef::getSortKey(DataGridRowBuffer* buffer, Database*,
+    DataGridSortKeys& keys, size_t index)
+{
+    wxASSERT(buffer);
+    // time zone is ignored, values are compared as stored
+    int value = 0;
+    buffer->getValue(offsetM, value);
+    keys.integers[index] = value;
+}
+
+bool TimeColumnDef::canFormatConcurrently()
+{
+    // time zone names are looked up in the database
+    return !withTimezoneM;
+}
+
 void TimeColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
     const IBPP::Statement& statement, wxMBConv*, Database*)
 {
@@ -1287,6 +1444,10 @@ public:
     virtual wxString getAsFirebirdString(DataGridRowBuffer* buffer);
     virtual wxString getAsString(DataGridRowBuffer* buffer, Database* db);
     virtual unsigned getBufferSize();
+    virtual DataGridSortKeyType getSortKeyType();
+    virtual void getSortKey(DataGridRowBuffer* buffer, Database* db,
+        DataGridSortKeys& keys, size_t index);
+    virtual bool canFormatConcurrently();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
         const IBPP::Statement& statement, wxMBConv* converter, Database* db);
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
@@ -1419,6 +1580,28 @@ unsigned TimestampColumnDef::getBufferSize()
     return result;
 }
 
+DataGridSortKeyType TimestampColumnDef::getSortKeyType()
+{
+    return sktInteger;
+}
+
+void TimestampColumnDef::getSortKey(DataGridRowBuffer* buffer, Database*,
+    DataGridSortKeys& keys, size_t index)
+{
+    wxASSERT(buffer);
+    // encoded time is always below 10^9
+    int vDate = 0, vTime = 0;
+    buffer->getValue(offsetM, vDate);
+    buffer->getValue(offsetM + sizeof(int), vTime);
+    keys.integers[index] = int64_t(vDate) * 1000000000LL + vTime;
+}
+
+bool TimestampColumnDef::canFormatConcurrently()
+{
+    // time zone names are looked up in the database
+    return !withTimezoneM;
+}
+
 void TimestampColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
     const IBPP::Statement& statement, wxMBConv*, Database*)
 {
@@ -1467,6 +1650,9 @@ public:
         bool nullable);
     virtual wxString getAsString(DataGridRowBuffer* buffer, Database* db);
     virtual unsigned getBufferSize();
+    virtual DataGridSortKeyType getSortKeyType();
+    virtual void getSortKey(DataGridRowBuffer* buffer, Database* db,
+        DataGridSortKeys& keys, size_t index);
     virtual bool isNumeric();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
         const IBPP::Statement& statement, wxMBConv* converter, Database* db);
@@ -1507,6 +1693,20 @@ unsigned FloatColumnDef::getBufferSize()
     return sizeof(float);
 }
 
+DataGridSortKeyType FloatColumnDef::getSortKeyType()
+{
+    return sktFloat;
+}
+
+void FloatColumnDef::getSortKey(DataGridRowBuffer* buffer, Database*,
+    DataGridSortKeys& keys, size_t index)
+{
+    wxASSERT(buffer);
+    float value = 0;
+    buffer->getValue(offsetM, value);
+    keys.floats[index] = value;
+}
+
 bool FloatColumnDef::isNumeric()
 {
     return true;
@@ -1539,6 +1739,9 @@ public:
         bool nullable, short scale);
     virtual wxString getAsString(DataGridRowBuffer* buffer, Database* db);
     virtual unsigned getBufferSize();
+    virtual DataGridSortKeyType getSortKeyType();
+    virtual void getSortKey(DataGridRowBuffer* buffer, Database* db,
+        DataGridSortKeys& keys, size_t index);
     virtual bool isNumeric();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
         const IBPP::Statement& statement, wxMBConv* converter, Database* db);
@@ -1563,7 +1766,7 @@ wxString DoubleColumnDef::getAsString(DataGridRowBuffer* buffer, Database*)
         return wxEmptyString;
 
     if (scaleM)
-        return wxString::Format("%.*f", scaleM, value);
+        return GridCellFormats::get().formatFixed(value, scaleM);
     return GridCellFormats::get().format<double>(value);
 }
 
@@ -1582,6 +1785,20 @@ unsigned DoubleColumnDef::getBufferSize()
     return sizeof(double);
 }
 
+DataGridSortKeyType DoubleColumnDef::getSortKeyType()
+{
+    return sktFloat;
+}
+
+void DoubleColumnDef::getSortKey(DataGridRowBuffer* buffer, Database*,
+    DataGridSortKeys& keys, size_t index)
+{
+    wxASSERT(buffer);
+    double value = 0;
+    buffer->getValue(offsetM, value);
+    keys.floats[index] = value;
+}
+
 bool DoubleColumnDef::isNumeric()
 {
     return true;
@@ -1613,6 +1830,9 @@ public:
         bool nullable);
     virtual wxString getAsString(DataGridRowBuffer* buffer, Database* db);
     virtual unsigned getBufferSize();
+    virtual DataGridSortKeyType getSortKeyType();
+    virtual void getSortKey(DataGridRowBuffer* buffer, Database* db,
+        DataGridSortKeys& keys, size_t index);
     virtual bool isNumeric();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
         const IBPP::Statement& statement, wxMBConv* converter, Database* db);
@@ -1653,6 +1873,23 @@ unsigned Dec16ColumnDef::getBufferSize()
     return sizeof(dec16_t);
 }
 
+DataGridSortKeyType Dec16ColumnDef::getSortKeyType()
+{
+    return sktFloat;
+}
+
+void Dec16ColumnDef::getSortKey(DataGridRowBuffer* buffer, Database*,
+    DataGridSortKeys& keys, size_t index)
+{
+    wxASSERT(buffer);
+    // sorted with double precision
+    dec16_t value;
+    double d = 0;
+    if (buffer->getValue(offsetM, value))
+        Dec16DPDToString(value).ToCDouble(&d);
+    keys.floats[index] = d;
+}
+
 bool Dec16ColumnDef::isNumeric()
 {
     return true;
@@ -1687,6 +1924,9 @@ public:
         bool nullable);
     virtual wxString getAsString(DataGridRowBuffer* buffer, Database* db);
     virtual unsigned getBufferSize();
+    virtual DataGridSortKeyType getSortKeyType();
+    virtual void getSortKey(DataGridRowBuffer* buffer, Database* db,
+        DataGridSortKeys& keys, size_t index);
     virtual bool isNumeric();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
         const IBPP::Statement& statement, wxMBConv* converter, Database* db);
@@ -1727,6 +1967,23 @@ unsigned Dec34ColumnDef::getBufferSize()
     return sizeof(dec34_t);
 }
 
+DataGridSortKeyType Dec34ColumnDef::getSortKeyType()
+{
+    return sktFloat;
+}
+
+void Dec34ColumnDef::getSortKey(DataGridRowBuffer* buffer, Database*,
+    DataGridSortKeys& keys, size_t index)
+{
+    wxASSERT(buffer);
+    // sorted with double precision
+    dec34_t value;
+    double d = 0;
+    if (buffer->getValue(offsetM, value))
+        Dec34DPDToString(value).ToCDouble(&d);
+    keys.floats[index] = d;
+}
+
 bool Dec34ColumnDef::isNumeric()
 {
     return true;
@@ -1765,6 +2022,7 @@ public:
     virtual unsigned getIndex();
     virtual wxString getAsString(DataGridRowBuffer* buffer, Database* db);
     virtual unsigned getBufferSize();
+    virtual bool canFormatConcurrently();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
         const IBPP::Statement& statement, wxMBConv* converter, Database* db);
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
@@ -1792,6 +2050,12 @@ unsigned BlobColumnDef::getIndex()
     return indexM;
 }
 
+bool BlobColumnDef::canFormatConcurrently()
+{
+    // BLOB content is read from the database on first access
+    return false;
+}
+
 wxString BlobColumnDef::getAsString(DataGridRowBuffer* grid_buffer, Database*)
 {
     wxASSERT(grid_buffer);
@@ -1890,9 +2154,10 @@ class StringColumnDef : public ResultsetColumnDef
 protected:
     unsigned indexM;
     int charSizeM;
+    const DataGridTranscoder* transcoderM;
 public:
     StringColumnDef(const wxString& name, unsigned stringIndex, bool readOnly,
-        bool nullable, int charSize);
+        bool nullable, int charSize, const DataGridTranscoder* transcoder);
     virtual unsigned getIndex();
     virtual wxString getAsFirebirdString(DataGridRowBuffer* buffer);
     virtual wxString getAsString(DataGridRowBuffer* buffer, Database* db);
@@ -1906,9 +2171,10 @@ public:
 };
 
 StringColumnDef::StringColumnDef(const wxString& name, unsigned stringIndex,
-    bool readOnly, bool nullable, int charSize)
+    bool readOnly, bool nullable, int charSize,
+    const DataGridTranscoder* transcoder)
     : ResultsetColumnDef(name, readOnly, nullable), indexM(stringIndex),
-      charSizeM(charSize)
+      charSizeM(charSize), transcoderM(transcoder)
 {
 }
 
@@ -1946,7 +2212,7 @@ unsigned StringColumnDef::getBufferSize()
 }
 
 void StringColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
-    const IBPP::Statement& statement, wxMBConv* converter, Database* /*db*/)
+    const IBPP::Statement& statement, wxMBConv* /*converter*/, Database* /*db*/)
 {
     wxASSERT(buffer);
     if (statement->ColumnType(col) == IBPP::sdBoolean) // Firebird v3
@@ -1960,45 +2226,29 @@ void StringColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
     {
         std::string value;
         statement->Get(col, value);
-        wxString val;
-        for (std::string::size_type p = 0; p < value.length(); p++)
-            val += wxString::Format("%02x", uint8_t(value[p]));
-        buffer->setString(indexM, val);
+        buffer->setString(indexM, DataGridTranscoder::toHex(value));
     }
     else
     {
         std::string value;
-        //wxMBConv* converter = db->getCharsetConverter();
         statement->Get(col, value);
-        wxString val = wxString(value.c_str(), *converter);
-        size_t trimLen = val.Strip().Length();
-        if (val.Length() > size_t(charSizeM))
-            val.Truncate(trimLen > size_t(charSizeM) ? trimLen : charSizeM);
-        buffer->setString(indexM, val);
+        buffer->setString(indexM, transcoderM->decode(value, charSizeM));
     }
 }
 
 void StringColumnDef::setValue(DataGridRowBuffer* buffer, unsigned col,
-    fr::IStatementPtr statement, wxMBConv* converter, Database* /*db*/)
+    fr::IStatementPtr statement, wxMBConv* /*converter*/, Database* /*db*/)
 {
     wxASSERT(buffer);
     if (statement->getColumnSubtype(col - 1) == 1) // charset OCTETS
     {
-        std::string value = statement->getString(col - 1);
-        wxString val;
-        for (std::string::size_type p = 0; p < value.length(); p++)
-            val += wxString::Format("%02x", uint8_t(value[p]));
-        buffer->setString(indexM, val);
+        buffer->setString(indexM,
+            DataGridTranscoder::toHex(statement->getString(col - 1)));
     }
     else
     {
-        wxString val = wxString(statement->getString(col - 1).c_str(), *converter);
-        if (val.Length() > size_t(charSizeM))
-        {
-            size_t trimLen = val.Strip().Length();
-            val.Truncate(trimLen > size_t(charSizeM) ? trimLen : charSizeM);
-        }
-        buffer->setString(indexM, val);
+        buffer->setString(indexM,
+            transcoderM->decode(statement->getString(col - 1), charSizeM));
     }
 }
 
@@ -2013,7 +2263,7 @@ public:
 };
 
 BooleanColumnDef::BooleanColumnDef(const wxString& name, unsigned stringIndex,
-    bool readOnly, bool nullable) : StringColumnDef(name, stringIndex, readOnly, nullable, 5)
+    bool readOnly, bool nullable) : StringColumnDef(name, stringIndex, readOnly, nullable, 5, 0)
 {
 }
 
@@ -2051,34 +2301,53 @@ ResultsetColumnDef* DataGridRows::getColumnDef(unsigned col)
     return columnDefsM[col];
 }
 
-void DataGridRows::addRow(DataGridRowBuffer* buffer)
+DataGridRowBuffer* DataGridRows::findRowBuffer(unsigned row)
 {
-    if (buffersM.size() == buffersM.capacity())
-    {
-        size_t newCap = buffersM.capacity() < 1024 ? 1024 : buffersM.capacity() * 2;
-        buffersM.reserve(newCap);
-    }
-    buffersM.push_back(buffer);
+    if (rowBuffersM.empty())
+        return 0;
+    std::unordered_map<unsigned, DataGridRowBuffer*>::iterator it =
+        rowBuffersM.find(row);
+    return (it != rowBuffersM.end()) ? (*it).second : 0;
 }
 
-void DataGridRows::addRows(const std::vector<DataGridRowBuffer*>& rowBuffers)
+// moves the row out of the columnar store so that it can be changed
+DataGridRowBuffer* DataGridRows::getRowBuffer(unsigned row)
 {
-    if (rowBuffers.empty())
-        return;
-    if (buffersM.size() + rowBuffers.size() > buffersM.capacity())
+    DataGridRowBuffer* buffer = findRowBuffer(row);
+    if (!buffer)
     {
-        size_t newCap = std::max(buffersM.capacity() * 2, buffersM.size() + rowBuffers.size());
-        if (newCap < 1024)
-            newCap = 1024;
-        buffersM.reserve(newCap);
+        buffer = createRowBuffer();
+        storeM.loadRow(row, *buffer);
+        rowBuffersM[row] = buffer;
     }
-    buffersM.insert(buffersM.end(), rowBuffers.begin(), rowBuffers.end());
+    return buffer;
+}
+
+void DataGridRows::addRow(DataGridRowBuffer* buffer)
+{
+    unsigned row = getRowCount();
+    storeM.appendEmptyRow();
+    rowBuffersM[row] = buffer;
+}
+
+void DataGridRows::addRows(DataGridRowStore& rows)
+{
+    storeM.appendRows(rows);
 }
 
-DataGridRowBuffer* DataGridRows::fetchRowBuffer(fr::IStatementPtr statement)
+DataGridRowBuffer* DataGridRows::createRowBuffer()
+{
+    return new DataGridRowBuffer(columnDefsM.size());
+}
+
+void DataGridRows::initializeStore(DataGridRowStore& store)
+{
+    store.setLayout(storeM.getLayout());
+}
+
+void DataGridRows::readRow(fr::IStatementPtr statement,
+    DataGridRowBuffer* buffer)
 {
-    DataGridRowBuffer* buffer = new DataGridRowBuffer(columnDefsM.size());
-    // if anything fails, make sure we release the memory
     try
     {
         // starts with last column -> with highest buffer offset and
@@ -2098,35 +2367,39 @@ DataGridRowBuffer* DataGridRows::fetchRowBuffer(fr::IStatementPtr statement)
     }
     catch (const std::exception& e)
     {
-        wxLogDebug("DataGridRows::fetchRowBuffer() error: %s", e.what());
-        delete buffer;
+        wxLogDebug("DataGridRows::readRow() error: %s", e.what());
         throw;
     }
     catch (...)
     {
-        wxLogDebug("DataGridRows::fetchRowBuffer() unknown error.");
-        delete buffer;
+        wxLogDebug("DataGridRows::readRow() unknown error.");
         throw;
     }
-    return buffer;
 }
 
-void DataGridRows::addRow(fr::IStatementPtr statement)
+void DataGridRows::fetchRow(fr::IStatementPtr statement,
+    DataGridRowBuffer* buffer, DataGridRowStore& store)
 {
-    addRow(fetchRowBuffer(statement));
+    readRow(statement, buffer);
+    store.appendRow(*buffer);
 }
 
-    void freeBuffer(DataGridRowBuffer* buffer) { delete buffer; }
+void DataGridRows::addRow(fr::IStatementPtr statement)
+{
+    fetchRow(statement, fetchBufferM.get(), storeM);
+}
 
     void freeColumnDef(ResultsetColumnDef* columnDef) { delete columnDef; }
 
 void DataGridRows::clear()
 {
-    if (buffersM.size())
+    for (std::unordered_map<unsigned, DataGridRowBuffer*>::iterator it =
+        rowBuffersM.begin(); it != rowBuffersM.end(); ++it)
     {
-        for_each(buffersM.begin(), buffersM.end(), freeBuffer);
-        buffersM.clear();
+        delete (*it).second;
     }
+    rowBuffersM.clear();
+    storeM.clear();
     if (columnDefsM.size())
     {
         for_each(columnDefsM.begin(), columnDefsM.end(), freeColumnDef);
@@ -2140,49 +2413,54 @@ void DataGridRows::clear()
 
 bool DataGridRows::canRemoveRow(size_t row)
 {
-    if (row >= buffersM.size())
+    if (row >= getRowCount())
         return false;
     
     if (statementDALM->getType() == fr::StatementType::Unknown)
         return false;
 
-    if (!buffersM[row]->isDeletableIsSet())
-    {
-        // find table with valid constraint
-        bool tableok = false;
-        for (std::map<wxString, UniqueConstraint *>::iterator it =
-            statementTablesM.begin(); !tableok && it != statementTablesM.end();
-            ++it)
+    // rows still in the store have no N/A fields and don't cache the result
+    DataGridRowBuffer* buffer = findRowBuffer(row);
+    if (buffer && buffer->isDeletableIsSet())
+        return buffer->isDeletable();
+
+    // find table with valid constraint
+    bool tableok = false;
+    for (std::map<wxString, UniqueConstraint *>::iterator it =
+        statementTablesM.begin(); !tableok && it != statementTablesM.end();
+        ++it)
+    {
+        if ((*it).second == 0)
+            continue;
+        // check if some of PK/UNQ columns contains N/A for that row
+        tableok = true;
+        if (!buffer)
+            continue;
+        for (ColumnConstraint::const_iterator ci = (*it).second->begin();
+            ci != (*it).second->end(); ++ci)
         {
-            if ((*it).second == 0)
-                continue;
-            // check if some of PK/UNQ columns contains N/A for that row
-            tableok = true;
-            for (ColumnConstraint::const_iterator ci = (*it).second->begin();
-                ci != (*it).second->end(); ++ci)
-            {
-                int colCount = statementDALM->getColumnCount();
+            int colCount = statementDALM->getColumnCount();
 
-                for (int c2 = 0; c2 < colCount; ++c2)
+            for (int c2 = 0; c2 < colCount; ++c2)
+            {
+                wxString cn = std2wxIdentifier(statementDALM->getColumnName(c2),
+                    databaseM->getCharsetConverter());
+                wxString tn = std2wxIdentifier(statementDALM->getColumnTable(c2),
+                    databaseM->getCharsetConverter());
+
+                if ((*ci) != cn)
+                    continue;
+                if (tn == (*it).first && buffer->isFieldNA(c2))
                 {
-                    wxString cn = std2wxIdentifier(statementDALM->getColumnName(c2),
-                        databaseM->getCharsetConverter());
-                    wxString tn = std2wxIdentifier(statementDALM->getColumnTable(c2),
-                        databaseM->getCharsetConverter());
-
-                    if ((*ci) != cn)
-                        continue;
-                    if (tn == (*it).first && buffersM[row]->isFieldNA(c2))
-                    {
-                        tableok = false;
-                        break;
-                    }
+                    tableok = false;
+                    break;
                 }
             }
         }
-        buffersM[row]->setIsDeletable(tableok);
     }
-    return buffersM[row]->isDeletable();
+    if (buffer)
+        buffer->setIsDeletable(tableok);
+    return tableok;
 }
 
 bool DataGridRows::removeRows(size_t from, size_t count, wxString& stm)
@@ -2222,31 +2500,27 @@ bool DataGridRows::removeRows(size_t from, size_t count, wxString& stm)
             + Identifier((*deleteFromM).first).getQuoted() + " WHERE ";
         
         fr::IStatementPtr st = addWhereDAL((*deleteFromM).second, s,
-            (*deleteFromM).first, buffersM[from+pos]);
+            (*deleteFromM).first, getRowBuffer(from + pos));
         st->execute();
         stm += s + ";";
     }
 
-    std::vector<DataGridRowBuffer*>::iterator i2, it = buffersM.begin();
-    from += count - 1;
-    while (from--)
-    {
-        if (++it == buffersM.end())     // should never happen
-            return false;
-    }
-    while (count--)
-    {
-        i2 = it;
-        if (it != buffersM.begin ())//Prevents it from going before the first one
-          it--;
-        (*i2)->setIsDeleted(true);
-    }
+    if (from + count > getRowCount())     // should never happen
+        return false;
+    for (size_t pos = 0; pos < count; ++pos)
+        getRowBuffer(from + pos)->setIsDeleted(true);
     return true;
 }
 
 unsigned DataGridRows::getRowCount()
 {
-    return buffersM.size();
+    return (unsigned)storeM.getRowCount();
+}
+
+size_t DataGridRows::getMemoryUsage()
+{
+    return storeM.getMemoryUsage()
+        + rowBuffersM.size() * (sizeof(DataGridRowBuffer) + bufferSizeM);
 }
 
 unsigned DataGridRows::getRowFieldCount()
@@ -2392,6 +2666,7 @@ bool DataGridRows::initialize(fr::IStatementPtr statement)
     statementDALM = statement;
 
     clear();
+    transcoderM.reset(new DataGridTranscoder(databaseM->getCharsetConverter()));
     // column definitions may have an index into the string array,
     // an offset into the buffer, or use no data at all
     unsigned colCount = statement->getColumnCount();
@@ -2399,6 +2674,8 @@ bool DataGridRows::initialize(fr::IStatementPtr statement)
     bufferSizeM = 0;
     unsigned stringIndex = 0;
     unsigned blobIndex = 0;
+    std::vector<DataGridColumnLayout> layout;
+    layout.reserve(colCount);
 
     // Create column definitions and compute the necessary buffer size
     // and string array length when all fields contain data
@@ -2418,6 +2695,7 @@ bool DataGridRows::initialize(fr::IStatementPtr statement)
         fr::ColumnType type = statement->getColumnType(col - 1);
         short scale = (short)statement->getColumnScale(col - 1);
 
+        DataGridColumnLayout columnLayout = { bufferSizeM, 0, -1, -1 };
         ResultsetColumnDef* columnDef = 0;
         if (statement->getColumnName(col - 1) == "DB_KEY")
             columnDef = new DBKeyColumnDef(colName, bufferSizeM, statement->getColumnSize(col - 1));
@@ -2427,6 +2705,7 @@ bool DataGridRows::initialize(fr::IStatementPtr statement)
             {
                 case fr::ColumnType::Boolean:
                     columnDef = new BooleanColumnDef(colName, stringIndex, readOnly, nullable);
+                    columnLayout.stringIndex = stringIndex;
                     ++stringIndex;
                     break;
                 case fr::ColumnType::Date:
@@ -2488,12 +2767,15 @@ bool DataGridRows::initialize(fr::IStatementPtr statement)
                     int size = statement->getColumnSize(col - 1);
                     if (bpc)
                         size /= bpc;
-                    columnDef = new StringColumnDef(colName, stringIndex, readOnly, nullable, size);
+                    columnDef = new StringColumnDef(colName, stringIndex, readOnly, nullable, size, transcoderM.get());
+                    columnLayout.stringIndex = stringIndex;
                     ++stringIndex;
                     break;
                 }
                 case fr::ColumnType::Blob:
                     columnDef = new BlobColumnDef(colName, readOnly, nullable, stringIndex, blobIndex, statement->getColumnSubtype(col - 1) == 1, this->databaseM->getCharsetConverter());
+                    columnLayout.stringIndex = stringIndex;
+                    columnLayout.blobIndex = blobIndex;
                     ++blobIndex;
                     ++stringIndex;
                     break;
@@ -2503,9 +2785,14 @@ bool DataGridRows::initialize(fr::IStatementPtr statement)
             }
         }
         wxASSERT(columnDef);
-        bufferSizeM += columnDef->getBufferSize();
+        columnLayout.size = columnDef->getBufferSize();
+        bufferSizeM += columnLayout.size;
         columnDefsM.push_back(columnDef);
+        layout.push_back(columnLayout);
     }
+    storeM.setLayout(layout);
+    fetchBufferM.reset(createRowBuffer());
+    readBufferM.reset(createRowBuffer());
     return true;
 }
 
@@ -2533,16 +2820,18 @@ bool DataGridRows::isColumnReadonly(unsigned col)
 bool DataGridRows::getFieldInfo(unsigned row, unsigned col,
     DataGridFieldInfo& info)
 {
-    if (col >= columnDefsM.size() || row >= buffersM.size())
+    if (col >= columnDefsM.size() || row >= getRowCount())
         return false;
-    info.rowInserted = buffersM[row]->isInserted();
-    info.rowDeleted = buffersM[row]->isDeleted();
+    DataGridRowBuffer* buffer = findRowBuffer(row);
+    info.rowInserted = buffer && buffer->isInserted();
+    info.rowDeleted = buffer && buffer->isDeleted();
     info.fieldReadOnly = readOnlyM || info.rowDeleted
         || isColumnReadonly(col) || isFieldReadonly(row, col);
-    info.fieldModified = !info.rowDeleted
-        && buffersM[row]->isFieldModified(col);
-    info.fieldNull = buffersM[row]->isFieldNull(col);
-    info.fieldNA = buffersM[row]->isFieldNA(col);
+    info.fieldModified = !info.rowDeleted && buffer
+        && buffer->isFieldModified(col);
+    info.fieldNull = buffer ? buffer->isFieldNull(col)
+        : storeM.isFieldNull(row, col);
+    info.fieldNA = buffer && buffer->isFieldNA(col);
     info.fieldNumeric = isColumnNumeric(col);
     info.fieldBlob = isBlobColumn(col);
     return true;
@@ -2550,14 +2839,15 @@ bool DataGridRows::getFieldInfo(unsigned row, unsigned col,
 
 bool DataGridRows::isFieldReadonly(unsigned row, unsigned col)
 {
-    if (col >= columnDefsM.size() || row >= buffersM.size())
+    if (col >= columnDefsM.size() || row >= getRowCount())
         return false;
     if (columnDefsM[col]->isReadOnly())
         return true;
 
     // if row is loaded from the database and not inserted by user, we don't
     // need to check anything else
-    if (!buffersM[row]->isInserted())
+    DataGridRowBuffer* buffer = findRowBuffer(row);
+    if (!buffer || !buffer->isInserted())
         return false;
 
     wxString table = std2wxIdentifier(statementDALM->getColumnTable(col),
@@ -2582,7 +2872,7 @@ bool DataGridRows::isFieldReadonly(unsigned row, unsigned col)
 
             if ((*ci) != cn)
                 continue;
-            if (tn == table && buffersM[row]->isFieldNA(c2))
+            if (tn == table && buffer->isFieldNA(c2))
                 return true;
         }
     }
@@ -2591,23 +2881,118 @@ bool DataGridRows::isFieldReadonly(unsigned row, unsigned col)
 
 wxString DataGridRows::getFieldValue(unsigned row, unsigned col)
 {
-    if (row >= buffersM.size() || col >= columnDefsM.size())
+    if (row >= getRowCount() || col >= columnDefsM.size())
+        return wxEmptyString;
+    if (DataGridRowBuffer* buffer = findRowBuffer(row))
+        return columnDefsM[col]->getAsString(buffer, databaseM);
+
+    storeM.loadField(row, col, *readBufferM);
+    // BLOB columns load their text on first access, keep it in the store
+    int stringIndex = storeM.getLayout()[col].stringIndex;
+    bool wasLoaded = stringIndex < 0
+        || readBufferM->isStringLoaded(stringIndex);
+    wxString value = columnDefsM[col]->getAsString(readBufferM.get(),
+        databaseM);
+    if (!wasLoaded && readBufferM->isStringLoaded(stringIndex))
+        storeM.setFieldText(row, col, value);
+    return value;
+}
+
+void DataGridRows::getSortKeys(unsigned col, DataGridSortKeys& keys)
+{
+    size_t count = getRowCount();
+    keys.reset(col < columnDefsM.size()
+        ? columnDefsM[col]->getSortKeyType() : sktText, count);
+    if (col >= columnDefsM.size())
+        return;
+
+    // BLOB text is loaded on first access, so it has to be done here
+    if (isBlobColumn(col))
+    {
+        for (size_t row = 0; row < count; ++row)
+        {
+            keys.nulls[row] = isFieldNull(row, col) ? 1 : 0;
+            if (!keys.nulls[row])
+                keys.setText(row, getFieldValue(row, col));
+        }
+        return;
+    }
+
+    ResultsetColumnDef* def = columnDefsM[col];
+    auto fillKeys = [this, def, col, &keys](size_t from, size_t to)
+    {
+        std::unique_ptr<DataGridRowBuffer> scratch(createRowBuffer());
+        for (size_t row = from; row < to; ++row)
+        {
+            DataGridRowBuffer* buffer = findRowBuffer(row);
+            if (!buffer)
+            {
+                storeM.loadField(row, col, *scratch);
+                buffer = scratch.get();
+            }
+            keys.nulls[row] = buffer->isFieldNull(col) ? 1 : 0;
+            if (!keys.nulls[row])
+                def->getSortKey(buffer, databaseM, keys, row);
+        }
+    };
+
+    // every thread fills its own range of rows, nothing else is written
+    const size_t minRowsPerThread = 16384;
+    size_t threads = std::min<size_t>(std::thread::hardware_concurrency(),
+        count / minRowsPerThread);
+    if (threads < 2)
+    {
+        fillKeys(0, count);
+        return;
+    }
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < threads; ++i)
+        workers.emplace_back(fillKeys, count * i / threads,
+            count * (i + 1) / threads);
+    for (std::thread& t : workers)
+        t.join();
+}
+
+bool DataGridRows::canFormatConcurrently(unsigned col)
+{
+    return col < columnDefsM.size() && columnDefsM[col]->canFormatConcurrently();
+}
+
+wxString DataGridRows::formatFieldValue(unsigned row, unsigned col,
+    DataGridRowBuffer* scratch)
+{
+    if (row >= getRowCount() || col >= columnDefsM.size())
+        return wxEmptyString;
+    DataGridRowBuffer* buffer = findRowBuffer(row);
+    if (!buffer)
+    {
+        storeM.loadField(row, col, *scratch);
+        buffer = scratch;
+    }
+    return columnDefsM[col]->getAsString(buffer, databaseM);
+}
+
+wxString DataGridRows::formatBufferValue(DataGridRowBuffer* buffer,
+    unsigned col)
+{
+    if (col >= columnDefsM.size())
         return wxEmptyString;
-    return columnDefsM[col]->getAsString(buffersM[row], databaseM);
+    return columnDefsM[col]->getAsString(buffer, databaseM);
 }
 
 bool DataGridRows::isFieldNull(unsigned row, unsigned col)
 {
-    if (row >= buffersM.size())
+    if (row >= getRowCount())
         return false;
-    return buffersM[row]->isFieldNull(col);
+    if (DataGridRowBuffer* buffer = findRowBuffer(row))
+        return buffer->isFieldNull(col);
+    return storeM.isFieldNull(row, col);
 }
 
 bool DataGridRows::isFieldNA(unsigned row, unsigned col)
 {
-    if (row >= buffersM.size())
-        return false;
-    return buffersM[row]->isFieldNA(col);
+    DataGridRowBuffer* buffer = findRowBuffer(row);
+    return buffer && buffer->isFieldNA(col);
 }
 
 
@@ -2694,11 +3079,17 @@ bool DataGridRows::isBlobColumn(unsigned col, bool* pIsTextual)
 
 fr::IBlobPtr DataGridRows::getBlob(unsigned row, unsigned col, bool validateBlob)
 {
-    if (row >= buffersM.size())
+    if (row >= getRowCount())
       throw FRError(_("Invalid row index."));
     if (col >= columnDefsM.size())
       throw FRError(_("Invalid col index."));
-    fr::IBlobPtr b0 = buffersM[row]->getBlob(columnDefsM[col]->getIndex());
+    DataGridRowBuffer* buffer = findRowBuffer(row);
+    if (!buffer)
+    {
+        storeM.loadField(row, col, *readBufferM);
+        buffer = readBufferM.get();
+    }
+    fr::IBlobPtr b0 = buffer->getBlob(columnDefsM[col]->getIndex());
     if ((validateBlob) && (!b0))
         throw FRError(_("BLOB data not valid"));
     return b0;
@@ -2727,7 +3118,7 @@ DataGridRowsBlob DataGridRows::setBlobPrepare(unsigned row, unsigned col)
     DataGridRowsBlob b;
     b.row = row;
     b.col = col;
-    b.stDAL = addWhereDAL((*it).second, stm, tn, buffersM[row]);
+    b.stDAL = addWhereDAL((*it).second, stm, tn, getRowBuffer(row));
     b.blob = b.stDAL->getDatabase()->createBlob(b.stDAL->getTransaction());
     return b;
 }
@@ -2740,14 +3131,15 @@ void DataGridRows::setBlob(DataGridRowsBlob &b)
         b.stDAL->execute();
     }
     
-    buffersM[b.row]->setBlob(columnDefsM[b.col]->getIndex(), b.blob);
+    DataGridRowBuffer* buffer = getRowBuffer(b.row);
+    buffer->setBlob(columnDefsM[b.col]->getIndex(), b.blob);
     
-    buffersM[b.row]->setFieldNull(b.col, (b.blob == nullptr));
-    buffersM[b.row]->setFieldNA(b.col, false);
+    buffer->setFieldNull(b.col, (b.blob == nullptr));
+    buffer->setFieldNA(b.col, false);
     BlobColumnDef *bcd = dynamic_cast<BlobColumnDef *>(columnDefsM[b.col]);
     if (!bcd)
         throw FRError(_("Not a BLOB column."));
-    bcd->reset(buffersM[b.row]);  // reset cached blob data
+    bcd->reset(buffer);  // reset cached blob data
 }
 
 void DataGridRows::exportBlobFile(const wxString& filename, unsigned row,
@@ -2830,7 +3222,7 @@ wxString DataGridRows::setFieldValue(unsigned row, unsigned col,
             localValue.Replace(",", ".", true);
     }
 
-    if (row >= buffersM.size() || col >= columnDefsM.size())
+    if (row >= getRowCount() || col >= columnDefsM.size())
         return wxEmptyString;
 
     if (columnDefsM[col]->isReadOnly())
@@ -2848,11 +3240,11 @@ wxString DataGridRows::setFieldValue(unsigned row, unsigned col,
         throw FRError(_("This column does not accept NULLs."));
 
     // If cell was already NULL and remains NULL, no update needed
-    if (buffersM[row]->isFieldNull(col) && newIsNull)
+    if (isFieldNull(row, col) && newIsNull)
         return wxEmptyString;
 
     // If cell was not NULL and value is unchanged, no update needed
-    if (!buffersM[row]->isFieldNull(col) && !newIsNull
+    if (!isFieldNull(row, col) && !newIsNull
         && getFieldValue(row, col) == localValue)
     {
         return wxEmptyString;
@@ -2861,23 +3253,24 @@ wxString DataGridRows::setFieldValue(unsigned row, unsigned col,
     // to ensure atomicity, we create a temporary buffer, try to store value
     // in it and also in database. if anything fails, we revert to the values
     // from temp buffer
+    DataGridRowBuffer *buffer = getRowBuffer(row);
     DataGridRowBuffer *oldRecord;
     // we create a copy of appropriate type
     InsertedGridRowBuffer* test =
-        dynamic_cast<InsertedGridRowBuffer *>(buffersM[row]);
+        dynamic_cast<InsertedGridRowBuffer *>(buffer);
     if (test)
         oldRecord = new InsertedGridRowBuffer(test);
     else
-        oldRecord = new DataGridRowBuffer(buffersM[row]);
+        oldRecord = new DataGridRowBuffer(buffer);
     try
     {
-        buffersM[row]->setFieldNA(col, false);
+        buffer->setFieldNA(col, false);
         if (newIsNull)
-            buffersM[row]->setFieldNull(col, true);
+            buffer->setFieldNull(col, true);
         else
         {
-            columnDefsM[col]->setFromString(buffersM[row], localValue);
-            buffersM[row]->setFieldNull(col, false);
+            columnDefsM[col]->setFromString(buffer, localValue);
+            buffer->setFieldNull(col, false);
         }
 
         // run the UPDATE statement
@@ -2902,7 +3295,7 @@ wxString DataGridRows::setFieldValue(unsigned row, unsigned col,
                 stm += " = x'";
             else
                 stm += " = '";
-            wxString lval = columnDefsM[col]->getAsFirebirdString(buffersM[row]);
+            wxString lval = columnDefsM[col]->getAsFirebirdString(buffer);
             if (isRational) //Fix locale problem for "," as decimal separator
                 lval.Replace(",", ".");
             stm += lval
@@ -2926,8 +3319,8 @@ wxString DataGridRows::setFieldValue(unsigned row, unsigned col,
     }
     catch(...)
     {
-        delete buffersM[row];       // delete the new record as it is invalid
-        buffersM[row] = oldRecord;
+        delete buffer;       // delete the new record as it is invalid
+        rowBuffersM[row] = oldRecord;
         throw;
     }
 }
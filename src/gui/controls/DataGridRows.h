@@ -27,6 +27,7 @@
 #include <vector>
 #include <map>
 #include <list>
+#include <unordered_map>
 
 #include "engine/db/IStatement.h"
 
@@ -297,9 +298,12 @@ namespace IBPP {
 
 #include "metadata/constraints.h"
 #include "config/Config.h"
+#include "gui/controls/DataGridRowStore.h"
+#include "gui/controls/DataGridSortIndex.h"
 
 class Database;
 class DataGridRowBuffer;
+class DataGridTranscoder;
 class ProgressIndicator;
 class wxMBConv;
 
@@ -327,6 +331,7 @@ private:
     wxString timeFormatM;
     wxString timestampFormatM;
     ShowTimezoneInfoType showTimezoneInfoM;
+    wxChar decimalSeparatorM;
     void formatAppendTz(wxString &s, IBPP::Time &t, bool hasTz,
         Database* db);
 protected:
@@ -335,9 +340,13 @@ public:
     GridCellFormats();
 
     static GridCellFormats& get();
+    // loads the settings now, so that worker threads only read them
+    void load();
 
     template<typename T>
     wxString format(T value);
+    // value with precision decimal digits, like "%.*f" formats it
+    wxString formatFixed(double value, int precision);
     wxString formatDate(int year, int month, int day);
     wxString formatTime(IBPP::Time &t, bool hasTz, Database* db);
     wxString formatTimestamp(IBPP::Timestamp &ts, bool hasTz, Database* db);
@@ -373,6 +382,12 @@ public:
     wxString getName();
     virtual unsigned getIndex(); // for strings and blobs
     virtual bool isNumeric();
+    // sort keys of the column, buffer holds a value that is not NULL
+    virtual DataGridSortKeyType getSortKeyType();
+    virtual void getSortKey(DataGridRowBuffer* buffer, Database* db,
+        DataGridSortKeys& keys, size_t index);
+    // false if getAsString() may need to access the database
+    virtual bool canFormatConcurrently();
     bool isReadOnly();
     bool isNullable();
     virtual void setValue(DataGridRowBuffer* buffer, unsigned col,
@@ -405,7 +420,15 @@ private:
     const bool readOnlyM;
     fr::IStatementPtr statementDALM;
     std::vector<ResultsetColumnDef*> columnDefsM;
-    std::vector<DataGridRowBuffer*> buffersM;
+    // fetched rows are kept in columnar form, rows that have been edited,
+    // deleted or inserted by the user get their own DataGridRowBuffer
+    DataGridRowStore storeM;
+    std::unordered_map<unsigned, DataGridRowBuffer*> rowBuffersM;
+    // scratch buffers to transfer values from/to the store
+    std::unique_ptr<DataGridRowBuffer> fetchBufferM;
+    std::unique_ptr<DataGridRowBuffer> readBufferM;
+    // decodes the text columns, for the character set of the connection
+    std::unique_ptr<DataGridTranscoder> transcoderM;
     std::map<wxString, UniqueConstraint *> statementTablesM;
     std::map<wxString, UniqueConstraint *>::iterator deleteFromM;
     std::list<UniqueConstraint> dbKeysM;
@@ -415,18 +438,28 @@ private:
         bool& nullable);
     fr::IStatementPtr addWhereDAL(UniqueConstraint* uq, wxString& stm,
         const wxString& tableName, DataGridRowBuffer* buffer);
+    DataGridRowBuffer* findRowBuffer(unsigned row);
+    DataGridRowBuffer* getRowBuffer(unsigned row);
 
 public:
     DataGridRows(Database* db);
     ~DataGridRows();
 
     void addRow(fr::IStatementPtr statement);
-    DataGridRowBuffer* fetchRowBuffer(fr::IStatementPtr statement);
-    void addRows(const std::vector<DataGridRowBuffer*>& rowBuffers);
+    // reads the current row of statement into buffer
+    void readRow(fr::IStatementPtr statement, DataGridRowBuffer* buffer);
+    // reads the current row of statement into store, using buffer for
+    // the conversion; safe to call from the background fetch thread
+    void fetchRow(fr::IStatementPtr statement, DataGridRowBuffer* buffer,
+        DataGridRowStore& store);
+    DataGridRowBuffer* createRowBuffer();
+    void initializeStore(DataGridRowStore& store);
+    void addRows(DataGridRowStore& rows);
     void clear();
     unsigned getRowCount();
     unsigned getRowFieldCount();
     wxString getRowFieldName(unsigned col);
+    size_t getMemoryUsage();
     bool initialize(fr::IStatementPtr statement);
 
     bool isColumnNullable(unsigned col);
@@ -439,6 +472,16 @@ public:
     bool isFieldNA(unsigned row, unsigned col);
 
     wxString getFieldValue(unsigned row, unsigned col);
+    // native sort keys of all rows for the given column
+    void getSortKeys(unsigned col, DataGridSortKeys& keys);
+    // formats a field without caching anything, so it can be called from a
+    // worker thread for columns that can be formatted concurrently as long
+    // as no rows are added or changed
+    bool canFormatConcurrently(unsigned col);
+    wxString formatFieldValue(unsigned row, unsigned col,
+        DataGridRowBuffer* scratch);
+    // formats a field of a buffer filled by readRow()
+    wxString formatBufferValue(DataGridRowBuffer* buffer, unsigned col);
     wxString setFieldValue(unsigned row, unsigned col,
         const wxString& value, bool setNull = false);
     void importBlobFile(const wxString& filename, unsigned row, unsigned col,
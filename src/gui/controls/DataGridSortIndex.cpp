@@ -0,0 +1,235 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <thread>
+
+#include "gui/controls/DataGridSortIndex.h"
+
+namespace
+{
+
+// below this row count sorting on a single thread is faster
+const size_t minRowsForParallelSort = 65536;
+
+template<typename Compare>
+void parallelStableSort(std::vector<unsigned>& items, Compare less)
+{
+    unsigned threads = std::min(std::thread::hardware_concurrency(), 8u);
+    if (threads < 2 || items.size() < minRowsForParallelSort)
+    {
+        std::stable_sort(items.begin(), items.end(), less);
+        return;
+    }
+
+    std::vector<size_t> bounds(threads + 1);
+    for (unsigned i = 0; i <= threads; ++i)
+        bounds[i] = items.size() * i / threads;
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threads; ++i)
+    {
+        workers.emplace_back([&items, &bounds, &less, i]() {
+            std::stable_sort(items.begin() + bounds[i],
+                items.begin() + bounds[i + 1], less);
+        });
+    }
+    for (std::thread& t : workers)
+        t.join();
+
+    // merge neighbouring parts, all merges of one level run in parallel
+    for (unsigned width = 1; width < threads; width *= 2)
+    {
+        workers.clear();
+        for (unsigned i = 0; i + width < threads; i += 2 * width)
+        {
+            size_t lo = bounds[i];
+            size_t mid = bounds[i + width];
+            size_t hi = bounds[std::min(i + 2 * width, threads)];
+            workers.emplace_back([&items, &less, lo, mid, hi]() {
+                std::inplace_merge(items.begin() + lo, items.begin() + mid,
+                    items.begin() + hi, less);
+            });
+        }
+        for (std::thread& t : workers)
+            t.join();
+    }
+}
+
+// NaN sorts after all numbers to keep the ordering strict weak
+inline bool floatLess(double a, double b)
+{
+    if (std::isnan(a) || std::isnan(b))
+        return !std::isnan(a) && std::isnan(b);
+    return a < b;
+}
+
+} // namespace
+
+// DataGridSortKeys class
+DataGridSortKeys::DataGridSortKeys()
+    : type(sktText)
+{
+}
+
+void DataGridSortKeys::reset(DataGridSortKeyType keyType, size_t count)
+{
+    type = keyType;
+    nulls.assign(count, 0);
+    integers.clear();
+    int128s.clear();
+    floats.clear();
+    texts.clear();
+    isNumber.clear();
+    switch (type)
+    {
+        case sktInteger:
+            integers.resize(count, 0);
+            break;
+        case sktInt128:
+            int128s.resize(count);
+            break;
+        case sktFloat:
+            floats.resize(count, 0.0);
+            break;
+        case sktText:
+            texts.resize(count);
+            floats.resize(count, 0.0);
+            isNumber.resize(count, 0);
+            break;
+    }
+}
+
+size_t DataGridSortKeys::size() const
+{
+    return nulls.size();
+}
+
+void DataGridSortKeys::setText(size_t index, const wxString& value)
+{
+    // text that is a number sorts numerically, as the grid always did
+    double number = 0;
+    isNumber[index] = value.ToDouble(&number) ? 1 : 0;
+    floats[index] = number;
+    texts[index] = value.Lower();
+}
+
+bool DataGridSortKeys::less(size_t a, size_t b) const
+{
+    if (nulls[a] || nulls[b])
+        return !nulls[a] && nulls[b];
+    switch (type)
+    {
+        case sktInteger:
+            return integers[a] < integers[b];
+        case sktInt128:
+            return int128s[a] < int128s[b];
+        case sktFloat:
+            return floatLess(floats[a], floats[b]);
+        case sktText:
+            break;
+    }
+    // numbers first, then text; keeps the ordering strict weak for
+    // columns with mixed content
+    if (isNumber[a] != isNumber[b])
+        return isNumber[a] != 0;
+    if (isNumber[a])
+        return floatLess(floats[a], floats[b]);
+    return texts[a].compare(texts[b]) < 0;
+}
+
+// DataGridSortIndex class
+DataGridSortIndex::DataGridSortIndex()
+    : columnM(-1), rowCountM(0), rankCountM(0)
+{
+}
+
+void DataGridSortIndex::build(int column, const DataGridSortKeys& keys)
+{
+    size_t count = keys.size();
+    std::vector<unsigned> order(count);
+    std::iota(order.begin(), order.end(), 0u);
+    parallelStableSort(order, [&keys](unsigned a, unsigned b) {
+        return keys.less(a, b);
+    });
+
+    ranksM.assign(count, 0);
+    unsigned rank = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (i > 0 && keys.less(order[i - 1], order[i]))
+            ++rank;
+        ranksM[order[i]] = rank;
+    }
+    rankCountM = count ? rank + 1 : 0;
+    columnM = column;
+    rowCountM = count;
+}
+
+void DataGridSortIndex::invalidate()
+{
+    columnM = -1;
+    rowCountM = 0;
+    rankCountM = 0;
+    ranksM.clear();
+}
+
+bool DataGridSortIndex::isValid(int column, size_t rowCount) const
+{
+    return columnM >= 0 && columnM == column && rowCountM == rowCount;
+}
+
+void DataGridSortIndex::sortRows(std::vector<size_t>& rows,
+    bool ascending) const
+{
+    if (rows.empty() || rankCountM == 0)
+        return;
+
+    std::vector<size_t> starts(rankCountM + 1, 0);
+    for (size_t row : rows)
+    {
+        unsigned rank = ranksM[row];
+        ++starts[(ascending ? rank : rankCountM - 1 - rank) + 1];
+    }
+    for (unsigned i = 1; i <= rankCountM; ++i)
+        starts[i] += starts[i - 1];
+
+    std::vector<size_t> sorted(rows.size());
+    for (size_t row : rows)
+    {
+        unsigned rank = ranksM[row];
+        sorted[starts[ascending ? rank : rankCountM - 1 - rank]++] = row;
+    }
+    rows.swap(sorted);
+}
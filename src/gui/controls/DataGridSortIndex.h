@@ -0,0 +1,88 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_DATAGRIDSORTINDEX_H
+#define FR_DATAGRIDSORTINDEX_H
+
+#include <cstdint>
+#include <vector>
+
+#include <wx/string.h>
+
+#include "core/FRInt128.h"
+
+enum DataGridSortKeyType
+{
+    sktText,
+    sktInteger,
+    sktInt128,
+    sktFloat
+};
+
+// DataGridSortKeys class
+// Native, pre-parsed sort keys for all rows of a single grid column. Only
+// the vector(s) for the key type of the column are used.
+class DataGridSortKeys
+{
+public:
+    DataGridSortKeyType type;
+    std::vector<uint8_t> nulls;
+    std::vector<int64_t> integers;
+    std::vector<int128_t> int128s;
+    // float keys, also the numeric value of text keys that are numbers
+    std::vector<double> floats;
+    // text keys are folded to lower case once
+    std::vector<wxString> texts;
+    std::vector<uint8_t> isNumber;
+
+    DataGridSortKeys();
+    void reset(DataGridSortKeyType keyType, size_t count);
+    size_t size() const;
+    void setText(size_t index, const wxString& value);
+    // strict weak ordering of two keys, NULLs sort after all values
+    bool less(size_t a, size_t b) const;
+};
+
+// DataGridSortIndex class
+// Ranks all rows of a column once, after that any subset of the rows can be
+// put in ascending or descending order with a stable counting sort.
+// Rows with equal keys share a rank, NULLs get the highest rank so they
+// sort last in ascending and first in descending order.
+class DataGridSortIndex
+{
+private:
+    int columnM;
+    size_t rowCountM;
+    unsigned rankCountM;
+    std::vector<unsigned> ranksM;
+public:
+    DataGridSortIndex();
+
+    void build(int column, const DataGridSortKeys& keys);
+    void invalidate();
+    bool isValid(int column, size_t rowCount) const;
+    // reorders rows (in ascending row order) by the rank of every row
+    void sortRows(std::vector<size_t>& rows, bool ascending) const;
+};
+
+#endif
@@ -0,0 +1,178 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// Tests for the typed sort keys and the cached sort permutation of the grid
+
+#include <iostream>
+#include <chrono>
+#include <numeric>
+#include <vector>
+#include <wx/wxprec.h>
+#ifndef WX_PRECOMP
+    #include <wx/wx.h>
+#endif
+
+#include "gui/controls/DataGridSortIndex.h"
+
+namespace
+{
+
+static bool check(bool condition, const char* testName)
+{
+    if (condition)
+    {
+        std::cout << "  PASSED: " << testName << "\n";
+        return true;
+    }
+    else
+    {
+        std::cout << "  FAILED: " << testName << "\n";
+        return false;
+    }
+}
+
+std::vector<size_t> allRows(size_t count)
+{
+    std::vector<size_t> rows(count);
+    std::iota(rows.begin(), rows.end(), 0);
+    return rows;
+}
+
+} // namespace
+
+int main()
+{
+    wxInitializer initializer;
+    if (!initializer.IsOk())
+    {
+        std::cerr << "Failed to initialize wxWidgets.\n";
+        return 1;
+    }
+
+    bool ok = true;
+    std::cout << "Running DataGrid Sort Index Tests...\n";
+
+    // Test 1: Integer keys, NULLs last ascending and first descending
+    {
+        DataGridSortKeys keys;
+        keys.reset(sktInteger, 6);
+        int64_t values[] = { 30, 10, 0, 20, 10, 0 };
+        for (size_t i = 0; i < 6; ++i)
+            keys.integers[i] = values[i];
+        keys.nulls[2] = 1;
+        keys.nulls[5] = 1;
+
+        DataGridSortIndex index;
+        index.build(0, keys);
+        ok = check(index.isValid(0, 6), "Index is valid for its column") && ok;
+        ok = check(!index.isValid(1, 6) && !index.isValid(0, 7),
+            "Index is invalid for other column or row count") && ok;
+
+        std::vector<size_t> rows = allRows(6);
+        index.sortRows(rows, true);
+        ok = check(rows == std::vector<size_t>({ 1, 4, 3, 0, 2, 5 }),
+            "Ascending order is stable with NULLs last") && ok;
+
+        rows = allRows(6);
+        index.sortRows(rows, false);
+        ok = check(rows == std::vector<size_t>({ 2, 5, 0, 3, 1, 4 }),
+            "Descending order is stable with NULLs first") && ok;
+
+        index.invalidate();
+        ok = check(!index.isValid(0, 6), "Invalidated index is not valid") && ok;
+    }
+
+    // Test 2: Text keys sort case-insensitively, numbers before text
+    {
+        DataGridSortKeys keys;
+        keys.reset(sktText, 5);
+        keys.setText(0, "banana");
+        keys.setText(1, "10");
+        keys.setText(2, "Apple");
+        keys.setText(3, "9");
+        keys.setText(4, "apple");
+
+        DataGridSortIndex index;
+        index.build(3, keys);
+        std::vector<size_t> rows = allRows(5);
+        index.sortRows(rows, true);
+        ok = check(rows == std::vector<size_t>({ 3, 1, 2, 4, 0 }),
+            "Mixed text column sorts numerically, then by folded text") && ok;
+    }
+
+    // Test 3: Filtered subset reuses the index of all rows
+    {
+        DataGridSortKeys keys;
+        keys.reset(sktFloat, 5);
+        double values[] = { 2.5, -1.0, 7.25, 0.0, 3.0 };
+        for (size_t i = 0; i < 5; ++i)
+            keys.floats[i] = values[i];
+
+        DataGridSortIndex index;
+        index.build(0, keys);
+        std::vector<size_t> rows({ 0, 2, 4 });
+        index.sortRows(rows, false);
+        ok = check(rows == std::vector<size_t>({ 2, 4, 0 }),
+            "Filtered rows are sorted by the cached ranks") && ok;
+    }
+
+    // Test 4: Sorting 1M integer keys, then re-sorting from the cache
+    {
+        const size_t NUM_ROWS = 1000000;
+        DataGridSortKeys keys;
+        keys.reset(sktInteger, NUM_ROWS);
+        uint32_t seed = 12345;
+        for (size_t i = 0; i < NUM_ROWS; ++i)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            keys.integers[i] = seed % 100000;
+            keys.nulls[i] = (i % 97 == 0) ? 1 : 0;
+        }
+
+        auto start = std::chrono::high_resolution_clock::now();
+        DataGridSortIndex index;
+        index.build(0, keys);
+        std::vector<size_t> rows = allRows(NUM_ROWS);
+        index.sortRows(rows, true);
+        auto mid = std::chrono::high_resolution_clock::now();
+        rows = allRows(NUM_ROWS);
+        index.sortRows(rows, false);
+        auto end = std::chrono::high_resolution_clock::now();
+
+        auto buildMs = std::chrono::duration_cast<std::chrono::milliseconds>(mid - start).count();
+        auto resortMs = std::chrono::duration_cast<std::chrono::milliseconds>(end - mid).count();
+        std::cout << "  INFO: Sorting 1M rows: " << buildMs << " ms, re-sort from cache: "
+                  << resortMs << " ms\n";
+
+        bool sorted = true;
+        for (size_t i = 1; i < NUM_ROWS && sorted; ++i)
+            sorted = !keys.less(rows[i - 1], rows[i]);
+        ok = check(sorted, "1M rows are in descending order") && ok;
+        ok = check(keys.nulls[rows[0]] != 0, "NULLs come first in descending order") && ok;
+        ok = check(buildMs < 5000, "Sorting 1M rows is fast (< 5000 ms)") && ok;
+    }
+
+    std::cout << "DataGrid Sort Index Tests completed: "
+              << (ok ? "ALL PASSED" : "SOME FAILED") << "\n";
+    return ok ? 0 : 1;
+}
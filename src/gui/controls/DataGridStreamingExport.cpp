@@ -0,0 +1,191 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <memory>
+
+#include "core/FRError.h"
+#include "engine/db/IDatabase.h"
+#include "engine/db/ITransaction.h"
+#include "gui/controls/DataGridRowBuffer.h"
+#include "gui/controls/DataGridStreamingExport.h"
+
+DataGridStreamingExport::DataGridStreamingExport(Database* db,
+        DataGridExportWriter::Format format, wxChar fieldDelimiter,
+        wxChar textDelimiter)
+    : rowsM(db), formatM(format),
+        writerM(format, fieldDelimiter, textDelimiter),
+        cancelM(false), runningM(false), rowCountM(0), byteCountM(0)
+{
+}
+
+DataGridStreamingExport::~DataGridStreamingExport()
+{
+    cancelM = true;
+    if (threadM.joinable())
+        threadM.join();
+}
+
+bool DataGridStreamingExport::canExport(fr::IStatementPtr gridStatement)
+{
+    return gridStatement && gridStatement->getColumnCount() > 0
+        && gridStatement->getParameterCount() == 0
+        && gridStatement->getType() == fr::StatementType::Select;
+}
+
+void DataGridStreamingExport::start(fr::IStatementPtr gridStatement,
+    const wxString& fileName)
+{
+    wxASSERT(!runningM);
+    if (!gridStatement || gridStatement->getColumnCount() == 0)
+        throw FRError(_("There is no result set to export."));
+    if (gridStatement->getType() != fr::StatementType::Select)
+    {
+        throw FRError(_("Only the result sets of SELECT statements can be exported directly from the database."));
+    }
+    if (gridStatement->getParameterCount() > 0)
+    {
+        throw FRError(_("Statements with parameters can not be exported directly from the database."));
+    }
+    fr::ITransactionPtr tr = gridStatement->getTransaction();
+    if (!tr || !tr->isActive())
+        throw FRError(_("The transaction of the result set is not active anymore."));
+
+    statementM = gridStatement->getDatabase()->createStatement(tr);
+    statementM->prepare(gridStatement->getSql());
+    rowsM.initialize(statementM);
+    // the formats are read on this thread, the worker only uses them
+    GridCellFormats::get().load();
+
+    if (!fileM.create(fileName, formatM))
+        throw FRError(wxString::Format(_("Could not create file \"%s\"."), fileName));
+
+    cancelM = false;
+    runningM = true;
+    threadM = std::thread([this]() {
+        run();
+    });
+}
+
+void DataGridStreamingExport::write(bool all)
+{
+    std::string& buffer = writerM.getBuffer();
+    if (buffer.empty() || (!all && buffer.size() < writeSize))
+        return;
+    if (!fileM.write(buffer))
+        throw FRError(_("Could not write to the export file."));
+    byteCountM += buffer.size();
+    buffer.clear();
+}
+
+void DataGridStreamingExport::run()
+{
+    try
+    {
+        unsigned colCount = rowsM.getRowFieldCount();
+        std::vector<wxString> names(colCount);
+        std::vector<bool> numeric(colCount);
+        for (unsigned col = 0; col < colCount; ++col)
+        {
+            names[col] = rowsM.getRowFieldName(col);
+            numeric[col] = rowsM.isColumnNumeric(col);
+        }
+        writerM.writeHeader(names, numeric);
+
+        statementM->execute();
+        std::unique_ptr<DataGridRowBuffer> buffer(rowsM.createRowBuffer());
+        std::vector<wxString> values(colCount);
+        std::vector<bool> nulls(colCount);
+        while (!cancelM && statementM->fetch())
+        {
+            rowsM.readRow(statementM, buffer.get());
+            for (unsigned col = 0; col < colCount; ++col)
+            {
+                nulls[col] = buffer->isFieldNull(col);
+                if (nulls[col])
+                    values[col].clear();
+                else
+                    values[col] = rowsM.formatBufferValue(buffer.get(), col);
+            }
+            writerM.writeRow(values, nulls);
+            ++rowCountM;
+            write(false);
+        }
+        writerM.writeFooter();
+        write(true);
+        statementM->close();
+        if (!fileM.close())
+            throw FRError(_("Could not write to the export file."));
+    }
+    catch (const std::exception& e)
+    {
+        errorM = wxString::FromUTF8(e.what());
+    }
+    catch (...)
+    {
+        errorM = _("Unknown error while exporting the result set.");
+    }
+    fileM.close();
+    runningM = false;
+}
+
+void DataGridStreamingExport::cancel()
+{
+    cancelM = true;
+}
+
+bool DataGridStreamingExport::isRunning() const
+{
+    return runningM;
+}
+
+bool DataGridStreamingExport::isCanceled() const
+{
+    return cancelM;
+}
+
+uint64_t DataGridStreamingExport::getRowCount() const
+{
+    return rowCountM;
+}
+
+uint64_t DataGridStreamingExport::getByteCount() const
+{
+    return byteCountM;
+}
+
+void DataGridStreamingExport::finish()
+{
+    if (threadM.joinable())
+        threadM.join();
+    if (!errorM.empty())
+        throw FRError(errorM);
+}
@@ -0,0 +1,84 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_DATAGRIDSTREAMINGEXPORT_H
+#define FR_DATAGRIDSTREAMINGEXPORT_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include "engine/db/IStatement.h"
+#include "gui/controls/DataGridExport.h"
+#include "gui/controls/DataGridRows.h"
+
+class Database;
+
+// DataGridStreamingExport class
+// Exports the complete result set of a grid statement without loading it
+// into the grid: the statement is executed again on a worker thread, and
+// every row is formatted like the grid does and written to the file as
+// soon as it is fetched. Only one row and the write buffer are held in
+// memory, no matter how many rows the result set has.
+class DataGridStreamingExport
+{
+public:
+    // the buffered text is written to the file in pieces of this size
+    enum { writeSize = 1024 * 1024 };
+private:
+    DataGridRows rowsM;
+    fr::IStatementPtr statementM;
+    DataGridExportWriter::Format formatM;
+    DataGridExportWriter writerM;
+    DataGridExportFile fileM;
+    std::thread threadM;
+    std::atomic<bool> cancelM;
+    std::atomic<bool> runningM;
+    std::atomic<uint64_t> rowCountM;
+    std::atomic<uint64_t> byteCountM;
+    // set by the worker thread before runningM is reset
+    wxString errorM;
+
+    void run();
+    void write(bool all);
+public:
+    DataGridStreamingExport(Database* db, DataGridExportWriter::Format format,
+        wxChar fieldDelimiter = ',', wxChar textDelimiter = '"');
+    ~DataGridStreamingExport();
+
+    // only a SELECT can be executed again without side effects, other
+    // statements with a result set (RETURNING, EXECUTE PROCEDURE) can't
+    static bool canExport(fr::IStatementPtr gridStatement);
+    // prepares the SQL of gridStatement in its transaction and creates
+    // fileName, then starts the worker thread; throws FRError on failure
+    void start(fr::IStatementPtr gridStatement, const wxString& fileName);
+    void cancel();
+    bool isRunning() const;
+    bool isCanceled() const;
+    uint64_t getRowCount() const;
+    uint64_t getByteCount() const;
+    // waits for the worker thread, throws FRError if the export failed
+    void finish();
+};
+
+#endif
@@ -33,11 +33,15 @@
 #include <wx/grid.h>
 
 #include <algorithm>
+#include <chrono>
+#include <memory>
+#include <numeric>
 #include <set>
 
 #include "config/Config.h"
 #include "core/FRError.h"
 #include "core/StringUtils.h"
+#include "gui/controls/DataGridRowBuffer.h"
 #include "gui/controls/DataGridRows.h"
 #include "gui/controls/DataGridTable.h"
 #include "engine/db/IDatabase.h"
@@ -66,6 +70,7 @@ DataGridTable::DataGridTable(fr::IStatementPtr s, Database* db)
 
 DataGridTable::~DataGridTable()
 {
+    stopBackgroundFilter();
     stopBackgroundFetch();
     Clear();
     cellAttriM->DecRef();
@@ -91,6 +96,7 @@ bool DataGridTable::canFetchMoreRows()
 
 void DataGridTable::Clear()
 {
+    stopBackgroundFilter();
     stopBackgroundFetch();
     nullFlagM = false;
 
@@ -108,6 +114,9 @@ void DataGridTable::Clear()
     unsigned oldCols = rowsM.getRowFieldCount();
     unsigned oldRows = (unsigned)GetNumberRows();
     rowMappingM.clear();
+    sortIndexM.invalidate();
+    filterIndexM.reset(0);
+    fetchQueueM.reset();
     rowsM.clear();
 
     if (GetView() && oldRows > 0)
@@ -150,26 +159,25 @@ void DataGridTable::stopBackgroundFetch()
 
 unsigned DataGridTable::processPendingBatches()
 {
-    std::vector<std::vector<DataGridRowBuffer*>> batches;
-    {
-        std::lock_guard<std::mutex> lock(pendingBatchesMutexM);
-        batches.swap(pendingBatchesM);
-    }
+    // batches are kept until the filter thread is done with the rows,
+    // processFilterResult() calls this again
+    if (filterThreadRunningM)
+        return 0;
 
+    auto start = std::chrono::steady_clock::now();
+    fetchQueueM.beginDrain();
     unsigned totalNew = 0;
-    for (auto& b : batches)
+    DataGridRowStore batch;
+    while (fetchQueueM.pop(batch))
     {
-        if (!b.empty())
-        {
-            totalNew += b.size();
-            rowsM.addRows(b);
-        }
+        totalNew += batch.getRowCount();
+        rowsM.addRows(batch);
     }
 
     if (totalNew > 0)
     {
         int oldViewRows = GetNumberRows();
-        if (filterOrSortActiveM)
+        if (filterOrSortActiveM || !currentFilterTextM.IsEmpty())
             updateRowMapping();
         notifyViewRowsChanged(oldViewRows);
 
@@ -179,6 +187,7 @@ unsigned DataGridTable::processPendingBatches()
             evt.SetExtraLong(rowsM.getRowCount());
             wxPostEvent(GetView(), evt);
         }
+        fetchQueueM.endDrain(std::chrono::steady_clock::now() - start);
     }
 
     return totalNew;
@@ -186,61 +195,57 @@ unsigned DataGridTable::processPendingBatches()
 
 void DataGridTable::backgroundFetchWorker()
 {
-    std::vector<DataGridRowBuffer*> batch;
-    batch.reserve(500);
+    // rows are converted through a single buffer and collected in a
+    // columnar batch, so there is no allocation per fetched row
+    std::unique_ptr<DataGridRowBuffer> buffer(rowsM.createRowBuffer());
+    DataGridRowStore batch;
+    rowsM.initializeStore(batch);
     bool eof = false;
 
-    while (!cancelFetchM && statementDALM)
+    while (!eof && !cancelFetchM && statementDALM)
     {
-        bool hasRow = false;
-        try
-        {
-            hasRow = statementDALM->fetch();
-        }
-        catch (...)
-        {
-            hasRow = false;
-        }
-
-        if (!hasRow)
-        {
-            eof = true;
+        // rows are only fetched when there is room to queue them
+        if (!fetchQueueM.waitForSpace(cancelFetchM))
             break;
-        }
 
-        try
-        {
-            DataGridRowBuffer* buf = rowsM.fetchRowBuffer(statementDALM);
-            batch.push_back(buf);
-        }
-        catch (...)
+        unsigned batchRows = fetchQueueM.getBatchRows();
+        auto start = std::chrono::steady_clock::now();
+        while (batch.getRowCount() < batchRows && !cancelFetchM)
         {
-            eof = true;
-            break;
-        }
+            bool hasRow = false;
+            try
+            {
+                hasRow = statementDALM->fetch();
+            }
+            catch (...)
+            {
+                hasRow = false;
+            }
 
-        if (batch.size() >= 500)
-        {
+            if (!hasRow)
             {
-                std::lock_guard<std::mutex> lock(pendingBatchesMutexM);
-                pendingBatchesM.push_back(std::move(batch));
+                eof = true;
+                break;
             }
-            batch.clear();
-            batch.reserve(500);
 
-            if (GetView())
+            try
             {
-                wxCommandEvent evt(wxEVT_FRDG_BATCH_READY, GetView()->GetId());
-                wxPostEvent(GetView(), evt);
+                rowsM.fetchRow(statementDALM, buffer.get(), batch);
+            }
+            catch (...)
+            {
+                eof = true;
+                break;
             }
         }
-    }
 
-    if (!batch.empty())
-    {
-        std::lock_guard<std::mutex> lock(pendingBatchesMutexM);
-        pendingBatchesM.push_back(std::move(batch));
-        batch.clear();
+        if (batch.getRowCount()
+            && fetchQueueM.push(batch, std::chrono::steady_clock::now() - start)
+            && GetView())
+        {
+            wxCommandEvent evt(wxEVT_FRDG_BATCH_READY, GetView()->GetId());
+            wxPostEvent(GetView(), evt);
+        }
     }
 
     if (eof)
@@ -259,13 +264,14 @@ void DataGridTable::fetchOne()
 {
     try
     {
+        stopBackgroundFilter();
         int oldViewRows = GetNumberRows();
         if (statementDALM->fetch() || (statementDALM->getColumnCount() > 0))
         {
             rowsM.addRow(statementDALM);
             allRowsFetchedM = true;
 
-            if (filterOrSortActiveM)
+            if (filterOrSortActiveM || !currentFilterTextM.IsEmpty())
                 updateRowMapping();
             notifyViewRowsChanged(oldViewRows);
 
@@ -290,7 +296,8 @@ void DataGridTable::fetchOne()
 
 void DataGridTable::fetch()
 {
-    if (!canFetchMoreRows())
+    // called again on idle, when the filter thread is done
+    if (!canFetchMoreRows() || filterThreadRunningM)
         return;
 
     int oldViewRows = GetNumberRows();
@@ -334,7 +341,7 @@ void DataGridTable::fetch()
     unsigned newRows = rowsM.getRowCount() - oldRows;
     if (newRows > 0)
     {
-        if (filterOrSortActiveM)
+        if (filterOrSortActiveM || !currentFilterTextM.IsEmpty())
             updateRowMapping();
         notifyViewRowsChanged(oldViewRows);
 
@@ -351,8 +358,9 @@ void DataGridTable::fetch()
 void DataGridTable::addRow(DataGridRowBuffer *buffer, const wxString& sql)
 {
     int oldViewRows = GetNumberRows();
+    stopBackgroundFilter();
     rowsM.addRow(buffer);
-    if (filterOrSortActiveM)
+    if (filterOrSortActiveM || !currentFilterTextM.IsEmpty())
         updateRowMapping();
     notifyViewRowsChanged(oldViewRows);
 
@@ -467,37 +475,66 @@ wxString DataGridTable::getCellValueForInsert(int row, int col)
     return "'" + s + "'";
 }
 
-wxString DataGridTable::getCellValueForCSV(int row, int col,
-    const wxChar& textDelimiter)
+void DataGridTable::saveCells(const wxString& fileName,
+    DataGridExportWriter::Format format, const std::vector<int>& rows,
+    const std::vector<int>& cols, wxChar fieldDelimiter, wxChar textDelimiter)
 {
-    if (!isValidCellPos(row, col))
-        return wxEmptyString;
-
-    int realRow = getRealRowIndex(row);
-    if (realRow < 0)
-        return wxEmptyString;
-    if (rowsM.isFieldNA(realRow, col))
-        return wxEmptyString;
-
-    const wxString sTextDelim =
-        (textDelimiter != '\0') ? wxString(textDelimiter) : wxString("");
-
-    if (rowsM.isFieldNull(realRow, col))
-        return sTextDelim + "NULL" + sTextDelim;
-    wxString s(rowsM.getFieldValue(realRow, col));
-    if (rowsM.isColumnNumeric(col))
-        return s;
+    std::vector<wxString> names;
+    std::vector<bool> numeric;
+    bool concurrent = true;
+    for (int col : cols)
+    {
+        names.push_back(rowsM.getRowFieldName(col));
+        numeric.push_back(rowsM.isColumnNumeric(col));
+        concurrent = concurrent && rowsM.canFormatConcurrently(col);
+    }
 
-    // wxTextOutputStream (which is used to write the CSV file) will convert
-    // '\n' to the proper EOL sequence while writing the stream
-    // so make sure '\r' isn't doubled on Windows
-    s.Replace("\r\n", "\n");
+    // like the quick filter the worker threads only read the rows, columns
+    // that may need the database are formatted on this thread alone
+    unsigned threadCount = 1;
+    if (concurrent)
+    {
+        GridCellFormats::get().load();
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::vector<std::unique_ptr<DataGridRowBuffer> > scratch;
+    for (unsigned i = 0; i < threadCount; ++i)
+        scratch.emplace_back(rowsM.createRowBuffer());
 
-    if (textDelimiter == '\0')
-        return s;
-    // return quoted text, but escape embedded quotes
-    s.Replace(sTextDelim, sTextDelim + sTextDelim);
-    return sTextDelim + s + sTextDelim;
+    auto readRow = [&](unsigned thread, size_t index,
+        std::vector<wxString>& values, std::vector<bool>& nulls)
+    {
+        int realRow = getRealRowIndex(rows[index]);
+        for (size_t i = 0; i < cols.size(); ++i)
+        {
+            unsigned col = cols[i];
+            nulls[i] = false;
+            if (realRow < 0 || rowsM.isFieldNA(realRow, col))
+                values[i].clear();
+            else if (rowsM.isFieldNull(realRow, col))
+            {
+                nulls[i] = true;
+                values[i].clear();
+            }
+            else if (concurrent)
+            {
+                values[i] = rowsM.formatFieldValue(realRow, col,
+                    scratch[thread].get());
+            }
+            else
+                values[i] = rowsM.getFieldValue(realRow, col);
+        }
+    };
+
+    DataGridExportFile file;
+    if (!file.create(fileName, format))
+        throw FRError(wxString::Format(_("Could not create file \"%s\"."), fileName));
+    DataGridParallelExport exporter(format, fieldDelimiter, textDelimiter);
+    if (!exporter.write(file, names, numeric, rows.size(), threadCount, readRow)
+        || !file.close())
+    {
+        throw FRError(_("Could not write to the export file."));
+    }
 }
 
 wxString DataGridTable::GetColLabelValue(int col)
@@ -802,7 +839,12 @@ DataGridRowsBlob DataGridTable::setBlobPrepare(unsigned row, unsigned col)
 
 void DataGridTable::setBlob(DataGridRowsBlob &b)
 {
+    bool refilter = stopBackgroundFilter();
+    sortIndexM.invalidate();
+    filterIndexM.clear();
     rowsM.setBlob(b);
+    if (refilter)
+        startBackgroundFilter();
 }
 
 void DataGridTable::importBlobFile(const wxString& filename, int row, int col,
@@ -810,7 +852,14 @@ void DataGridTable::importBlobFile(const wxString& filename, int row, int col,
 {
     int realRow = getRealRowIndex(row);
     if (realRow >= 0)
+    {
+        bool refilter = stopBackgroundFilter();
+        sortIndexM.invalidate();
+        filterIndexM.clear();
         rowsM.importBlobFile(filename, realRow, col, pi);
+        if (refilter)
+            startBackgroundFilter();
+    }
 }
 
 void DataGridTable::exportBlobFile(const wxString& filename, int row, int col,
@@ -840,9 +889,14 @@ void DataGridTable::SetValue(int row, int col, const wxString& value)
         if (realRow < 0 || realRow >= (int)rowsM.getRowCount() || col < 0 || col >= (int)rowsM.getRowFieldCount())
             return;
 
+        bool refilter = stopBackgroundFilter();
+        sortIndexM.invalidate();
+        filterIndexM.clear();
         wxString statement = rowsM.setFieldValue(realRow, col, value,
             nullFlagM);
         nullFlagM = false;  // reset
+        if (refilter)
+            startBackgroundFilter();
 
         if (statement.IsEmpty())
             return;
@@ -900,7 +954,7 @@ void DataGridTable::setValueToNull(int row, int col)
         b.col  = col;
         b.row  = realRow;
         b.stDAL = statementDALM;
-        rowsM.setBlob(b);
+        setBlob(b);
     }
 }
 
@@ -911,7 +965,13 @@ bool DataGridTable::DeleteRows(size_t pos, size_t numRows)
     {
         // remove rows from internal storage
         wxString statement;
-        if (!rowsM.removeRows(pos, numRows, statement))
+        bool refilter = stopBackgroundFilter();
+        sortIndexM.invalidate();
+        filterIndexM.clear();
+        bool removed = rowsM.removeRows(pos, numRows, statement);
+        if (refilter)
+            startBackgroundFilter();
+        if (!removed)
             return false;
 
         // used in frame to show executed statements
@@ -950,6 +1010,7 @@ DEFINE_EVENT_TYPE(wxEVT_FRDG_STATEMENT)
 DEFINE_EVENT_TYPE(wxEVT_FRDG_INVALIDATEATTR)
 DEFINE_EVENT_TYPE(wxEVT_FRDG_BATCH_READY)
 DEFINE_EVENT_TYPE(wxEVT_FRDG_FETCH_DONE)
+DEFINE_EVENT_TYPE(wxEVT_FRDG_FILTER_DONE)
 
 int DataGridTable::getRealRowIndex(int row) const
 {
@@ -982,68 +1043,152 @@ void DataGridTable::notifyViewRowsChanged(int oldViewRows)
 
 void DataGridTable::updateRowMapping()
 {
-    size_t count = rowsM.getRowCount();
-    rowMappingM.clear();
+    if (!currentFilterTextM.IsEmpty())
+    {
+        // rows are matched on a worker thread, processFilterResult()
+        // applies the result
+        startBackgroundFilter();
+        return;
+    }
+    stopBackgroundFilter();
+
+    std::vector<size_t> rows(rowsM.getRowCount());
+    std::iota(rows.begin(), rows.end(), 0);
+    applyRowMapping(rows);
+}
 
-    wxString query = currentFilterTextM.Lower();
-    for (size_t r = 0; r < count; ++r)
+void DataGridTable::applyRowMapping(std::vector<size_t>& rows)
+{
+    rowMappingM.swap(rows);
+    if (sortedColM >= 0 && sortedColM < GetNumberCols())
     {
-        if (query.IsEmpty())
+        // keys are parsed and ranked once per column, re-sorting or
+        // filtering a sorted grid only needs a counting sort of the ranks
+        if (!sortIndexM.isValid(sortedColM, rowsM.getRowCount()))
         {
-            rowMappingM.push_back(r);
-        }
-        else
-        {
-            bool match = false;
-            size_t cols = GetNumberCols();
-            for (size_t c = 0; c < cols; ++c)
-            {
-                wxString val = rowsM.getFieldValue(r, c);
-                if (val.Lower().Contains(query))
-                {
-                    match = true;
-                    break;
-                }
-            }
-            if (match)
-                rowMappingM.push_back(r);
+            DataGridSortKeys keys;
+            rowsM.getSortKeys(sortedColM, keys);
+            sortIndexM.build(sortedColM, keys);
         }
+        sortIndexM.sortRows(rowMappingM, sortAscendingM);
     }
 
-    if (sortedColM >= 0 && sortedColM < GetNumberCols())
+    filterOrSortActiveM = (!currentFilterTextM.IsEmpty() || sortedColM >= 0);
+}
+
+void DataGridTable::startBackgroundFilter()
+{
+    stopBackgroundFilter();
+
+    size_t rowCount = rowsM.getRowCount();
+    unsigned colCount = rowsM.getRowFieldCount();
+    if (filterIndexM.getColumnCount() != colCount)
+        filterIndexM.reset(colCount);
+
+    // columns that may need the database are formatted here, only once
+    for (unsigned col = 0; col < colCount; ++col)
     {
-        int col = sortedColM;
-        bool asc = sortAscendingM;
-        std::stable_sort(rowMappingM.begin(), rowMappingM.end(), [this, col, asc](size_t a, size_t b) {
-            bool nullA = rowsM.isFieldNull(a, col);
-            bool nullB = rowsM.isFieldNull(b, col);
-            if (nullA != nullB)
-            {
-                // In ascending sort, NULL values sort last
-                // In descending sort, NULL values sort first
-                return asc ? !nullA : nullA;
-            }
-            if (nullA && nullB)
-                return false;
+        if (rowsM.canFormatConcurrently(col))
+            continue;
+        for (size_t row = filterIndexM.getRowCount(col); row < rowCount; ++row)
+            filterIndexM.appendText(col, rowsM.getFieldValue(row, col));
+    }
+    GridCellFormats::get().load();
 
-            wxString valA = rowsM.getFieldValue(a, col);
-            wxString valB = rowsM.getFieldValue(b, col);
+    cancelFilterM = false;
+    filterThreadRunningM = true;
+    wxString query = currentFilterTextM;
+    backgroundFilterThreadM = std::thread([this, query, rowCount]() {
+        backgroundFilterWorker(query, rowCount);
+    });
+}
 
-            double numA = 0, numB = 0;
-            bool isNumA = valA.ToDouble(&numA);
-            bool isNumB = valB.ToDouble(&numB);
+// returns true if a running filter has been cancelled
+bool DataGridTable::stopBackgroundFilter()
+{
+    bool wasRunning = filterThreadRunningM;
+    cancelFilterM = true;
+    if (backgroundFilterThreadM.joinable())
+        backgroundFilterThreadM.join();
+    filterThreadRunningM = false;
+    filterResultReadyM = false;
+    return wasRunning;
+}
 
-            if (isNumA && isNumB)
+void DataGridTable::backgroundFilterWorker(const wxString& query,
+    size_t rowCount)
+{
+    // rows that are not in the index yet are formatted first, every
+    // column by a single thread
+    std::vector<unsigned> columns;
+    for (unsigned col = 0; col < filterIndexM.getColumnCount(); ++col)
+    {
+        if (filterIndexM.getRowCount(col) < rowCount)
+            columns.push_back(col);
+    }
+    std::atomic<size_t> nextColumn{0};
+    auto formatColumns = [this, &columns, &nextColumn, rowCount]()
+    {
+        std::unique_ptr<DataGridRowBuffer> scratch(rowsM.createRowBuffer());
+        for (size_t i = nextColumn++; i < columns.size(); i = nextColumn++)
+        {
+            unsigned col = columns[i];
+            for (size_t row = filterIndexM.getRowCount(col);
+                row < rowCount && !cancelFilterM; ++row)
             {
-                return asc ? (numA < numB) : (numA > numB);
+                filterIndexM.appendText(col,
+                    rowsM.formatFieldValue(row, col, scratch.get()));
             }
+        }
+    };
+    size_t threads = std::min<size_t>(std::thread::hardware_concurrency(),
+        columns.size());
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; ++i)
+        workers.emplace_back(formatColumns);
+    formatColumns();
+    for (std::thread& t : workers)
+        t.join();
+
+    std::vector<size_t> matches;
+    if (!cancelFilterM && filterIndexM.filter(query, matches, cancelFilterM))
+    {
+        filterMatchesM.swap(matches);
+        filterResultReadyM = true;
+    }
+    bool posted = filterResultReadyM;
+    filterThreadRunningM = false;
 
-            int cmp = valA.CmpNoCase(valB);
-            return asc ? (cmp < 0) : (cmp > 0);
-        });
+    if (posted && GetView())
+    {
+        wxCommandEvent evt(wxEVT_FRDG_FILTER_DONE, GetView()->GetId());
+        wxPostEvent(GetView(), evt);
     }
+}
 
-    filterOrSortActiveM = (!query.IsEmpty() || sortedColM >= 0);
+void DataGridTable::processFilterResult()
+{
+    // the event of a cancelled run may arrive while the next one runs
+    if (filterThreadRunningM || !backgroundFilterThreadM.joinable())
+        return;
+    backgroundFilterThreadM.join();
+    if (!filterResultReadyM)
+        return;
+    filterResultReadyM = false;
+
+    int oldViewRows = GetNumberRows();
+    applyRowMapping(filterMatchesM);
+    notifyViewRowsChanged(oldViewRows);
+    if (GetView())
+    {
+        // used in frame to update the filter label
+        wxCommandEvent evt(wxEVT_FRDG_ROWCOUNT_CHANGED, GetView()->GetId());
+        evt.SetExtraLong(rowsM.getRowCount());
+        wxPostEvent(GetView(), evt);
+    }
+
+    // rows that were fetched while the filter thread was running
+    processPendingBatches();
 }
 
 void DataGridTable::filterRows(const wxString& filterText)
@@ -1098,6 +1243,7 @@ void DataGridTable::toggleSortColumn(int col)
 
 void DataGridTable::clearFilterAndSort()
 {
+    stopBackgroundFilter();
     int oldViewRows = GetNumberRows();
     currentFilterTextM.Clear();
     sortedColM = -1;
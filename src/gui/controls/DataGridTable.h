@@ -28,10 +28,12 @@
 #include <wx/grid.h>
 
 #include <thread>
-#include <mutex>
 #include <atomic>
 #include <vector>
 
+#include "gui/controls/DataGridExport.h"
+#include "gui/controls/DataGridFetchQueue.h"
+#include "gui/controls/DataGridFilterIndex.h"
 #include "gui/controls/DataGridRows.h"
 #include "gui/FRStyleManager.h"
 
@@ -54,6 +56,8 @@ BEGIN_DECLARE_EVENT_TYPES()
     DECLARE_LOCAL_EVENT_TYPE(wxEVT_FRDG_BATCH_READY, 45)
     // sent when background fetch finishes
     DECLARE_LOCAL_EVENT_TYPE(wxEVT_FRDG_FETCH_DONE, 46)
+    // sent when the quick filter has matched all rows on its worker thread
+    DECLARE_LOCAL_EVENT_TYPE(wxEVT_FRDG_FILTER_DONE, 47)
 END_DECLARE_EVENT_TYPES()
 
 class DataGridTable: public wxGridTableBase
@@ -78,15 +82,29 @@ private:
     std::thread backgroundFetchThreadM;
     std::atomic<bool> fetchThreadRunningM{false};
     std::atomic<bool> cancelFetchM{false};
-    std::mutex pendingBatchesMutexM;
-    std::vector<std::vector<DataGridRowBuffer*>> pendingBatchesM;
+    DataGridFetchQueue fetchQueueM;
 
     void backgroundFetchWorker();
 
+    // the quick filter formats and matches rows on a worker thread, rows
+    // must not be added or changed while it runs
+    std::thread backgroundFilterThreadM;
+    std::atomic<bool> filterThreadRunningM{false};
+    std::atomic<bool> cancelFilterM{false};
+    bool filterResultReadyM = false;
+    std::vector<size_t> filterMatchesM;
+    DataGridFilterIndex filterIndexM;
+
+    void startBackgroundFilter();
+    bool stopBackgroundFilter();
+    void backgroundFilterWorker(const wxString& query, size_t rowCount);
+
     int getStatementColCount();
     bool isValidCellPos(int row, int col);
 
     std::vector<size_t> rowMappingM;
+    // ranks of all rows for the sorted column, rebuilt when data changes
+    DataGridSortIndex sortIndexM;
     bool filterOrSortActiveM = false;
     int sortedColM = -1;
     bool sortAscendingM = true;
@@ -94,6 +112,7 @@ private:
     std::vector<wxString> originalColLabelsM;
 
     void updateRowMapping();
+    void applyRowMapping(std::vector<size_t>& rows);
     int getRealRowIndex(int row) const;
     void notifyViewRowsChanged(int oldViewRows);
 public:
@@ -118,11 +137,19 @@ public:
     void stopBackgroundFetch();
     bool isBackgroundFetching() const { return fetchThreadRunningM.load(); }
     unsigned processPendingBatches();
+    bool isBackgroundFiltering() const { return filterThreadRunningM.load(); }
+    void processFilterResult();
 
     void addRow(DataGridRowBuffer *buffer, const wxString& sql);
     wxString getCellValue(int row, int col);
     wxString getCellValueForInsert(int row, int col);
-    wxString getCellValueForCSV(int row, int col, const wxChar& textDelimiter);
+    // writes the cells of the given rows and columns to fileName, formatted
+    // on several threads if all columns allow it; throws FRError if the
+    // file can't be written
+    void saveCells(const wxString& fileName,
+        DataGridExportWriter::Format format, const std::vector<int>& rows,
+        const std::vector<int>& cols, wxChar fieldDelimiter = ',',
+        wxChar textDelimiter = '"');
     bool getFetchAllRows();
 
     // TODO: these should be replaced with a better function that covers all
@@ -0,0 +1,224 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "gui/controls/DataGridTranscoder.h"
+
+namespace
+{
+
+inline bool isAsciiSpace(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+inline bool isContinuation(unsigned char c)
+{
+    return (c & 0xC0) == 0x80;
+}
+
+} // namespace
+
+DataGridTranscoder::DataGridTranscoder(wxMBConv* converter)
+    : converterM(converter), utf8M(false)
+{
+    // a converter that decodes two, three and four byte sequences the
+    // way UTF-8 does is a UTF-8 converter, whatever it is called
+    const char probe[] = "A\xC3\xA4\xE2\x82\xAC\xF0\x9F\x98\x80";
+    if (converterM)
+    {
+        wxString decoded;
+        utf8M = decodeUTF8(probe, sizeof(probe) - 1, decoded)
+            && wxString(probe, *converterM) == decoded;
+    }
+}
+
+bool DataGridTranscoder::isUTF8() const
+{
+    return utf8M;
+}
+
+wxString DataGridTranscoder::decode(const std::string& value,
+    size_t charSize) const
+{
+    const char* data = value.data();
+    size_t length = value.size();
+    if (const void* nul = memchr(data, 0, length))
+        length = static_cast<const char*>(nul) - data;
+
+    size_t trimmed = trimTrailingSpaces(data, length);
+    wxString text;
+    if (!utf8M || !decodeUTF8(data, trimmed, text))
+        text = wxString(data, *converterM, trimmed);
+
+    // the whitespace is ASCII, one character per byte
+    if (trimmed < length && text.length() < charSize
+        && (trimmed == 0 || !text.empty()))
+    {
+        size_t count = std::min(length - trimmed, charSize - text.length());
+        for (size_t i = 0; i < count; ++i)
+            text += wxUniChar(data[trimmed + i]);
+    }
+    return text;
+}
+
+wxString DataGridTranscoder::toHex(const std::string& value)
+{
+    static const char digits[] = "0123456789abcdef";
+    wxString hex;
+    if (value.empty())
+        return hex;
+    {
+        wxStringBufferLength buffer(hex, 2 * value.size());
+        wxChar* out = buffer;
+        for (std::string::size_type p = 0; p < value.size(); ++p)
+        {
+            uint8_t byte = uint8_t(value[p]);
+            *out++ = digits[byte >> 4];
+            *out++ = digits[byte & 0x0F];
+        }
+        buffer.SetLength(2 * value.size());
+    }
+    return hex;
+}
+
+size_t DataGridTranscoder::trimTrailingSpaces(const char* data, size_t length)
+{
+    while (length > 0 && isAsciiSpace(data[length - 1]))
+        --length;
+    return length;
+}
+
+bool DataGridTranscoder::decodeUTF8(const char* data, size_t length,
+    wxString& target)
+{
+#if wxUSE_UNICODE_UTF8
+    // the string is stored as UTF-8 already, it only has to be valid
+    target = wxString::FromUTF8(data, length);
+    return length == 0 || !target.empty();
+#else
+    target.clear();
+    if (length == 0)
+        return true;
+
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(data);
+    const unsigned char* end = in + length;
+    // a character never takes more wxChars than it takes bytes
+    wxStringBufferLength buffer(target, length);
+    wxChar* first = buffer;
+    wxChar* out = first;
+    bool valid = true;
+    while (in < end && valid)
+    {
+        // runs of ASCII are copied 8 bytes at a time
+        while (end - in >= 8)
+        {
+            uint64_t word;
+            memcpy(&word, in, sizeof(word));
+            if (word & UINT64_C(0x8080808080808080))
+                break;
+            for (int i = 0; i < 8; ++i)
+                *out++ = wxChar(in[i]);
+            in += 8;
+        }
+        if (in == end)
+            break;
+
+        unsigned char c = *in;
+        if (c < 0x80)
+        {
+            *out++ = wxChar(c);
+            ++in;
+            continue;
+        }
+
+        // lead byte: number of continuation bytes and the smallest code
+        // point of that length, anything below it is an overlong form
+        int extra;
+        uint32_t cp, minimum;
+        if (c >= 0xC2 && c <= 0xDF)
+        {
+            extra = 1;
+            cp = c & 0x1F;
+            minimum = 0x80;
+        }
+        else if ((c & 0xF0) == 0xE0)
+        {
+            extra = 2;
+            cp = c & 0x0F;
+            minimum = 0x800;
+        }
+        else if (c >= 0xF0 && c <= 0xF4)
+        {
+            extra = 3;
+            cp = c & 0x07;
+            minimum = 0x10000;
+        }
+        else
+        {
+            valid = false;
+            break;
+        }
+        if (end - in <= extra)
+        {
+            valid = false;
+            break;
+        }
+        for (int i = 1; i <= extra && valid; ++i)
+        {
+            valid = isContinuation(in[i]);
+            cp = (cp << 6) | (in[i] & 0x3F);
+        }
+        if (!valid || cp < minimum || cp > 0x10FFFF
+            || (cp >= 0xD800 && cp <= 0xDFFF))
+        {
+            valid = false;
+            break;
+        }
+        in += extra + 1;
+
+        if (sizeof(wxChar) == 2 && cp > 0xFFFF)
+        {
+            cp -= 0x10000;
+            *out++ = wxChar(0xD800 + (cp >> 10));
+            *out++ = wxChar(0xDC00 + (cp & 0x3FF));
+        }
+        else
+            *out++ = wxChar(cp);
+    }
+    buffer.SetLength(valid ? out - first : 0);
+    return valid;
+#endif
+}
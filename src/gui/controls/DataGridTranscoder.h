@@ -0,0 +1,64 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_DATAGRIDTRANSCODER_H
+#define FR_DATAGRIDTRANSCODER_H
+
+#include <wx/string.h>
+
+#include <string>
+
+class wxMBConv;
+
+// DataGridTranscoder class
+// Turns the bytes the database returns for CHAR, VARCHAR and OCTETS
+// columns into the text of the grid. If the connection character set is
+// decoded as UTF-8 anyway the text is decoded without the converter, and
+// the trailing spaces CHAR values are padded with are dropped from the
+// bytes before anything is decoded.
+// A transcoder doesn't change once created, so the background fetch
+// thread can use it while the UI thread reads other values.
+class DataGridTranscoder
+{
+private:
+    wxMBConv* converterM;
+    bool utf8M;
+public:
+    explicit DataGridTranscoder(wxMBConv* converter);
+
+    // true if the converter decodes UTF-8
+    bool isUTF8() const;
+    // the text of a CHAR or VARCHAR value of charSize characters, which
+    // ends at the first NUL; trailing whitespace is kept up to charSize
+    wxString decode(const std::string& value, size_t charSize) const;
+
+    // the lower case hex digits of an OCTETS value
+    static wxString toHex(const std::string& value);
+    // the length of data without trailing ASCII whitespace, which is a
+    // single byte in every character set Firebird connects with
+    static size_t trimTrailingSpaces(const char* data, size_t length);
+    // decodes length bytes of UTF-8, returns false if they aren't valid
+    static bool decodeUTF8(const char* data, size_t length, wxString& target);
+};
+
+#endif // FR_DATAGRIDTRANSCODER_H
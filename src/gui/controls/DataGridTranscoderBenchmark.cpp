@@ -0,0 +1,189 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// Benchmark of the conversion of CHAR, VARCHAR and OCTETS values on the
+// grid fetch path: DataGridTranscoder against the conversion the grid did
+// before (wxString::Format() per byte of OCTETS values, wxMBConv and
+// Strip() for text), which it has to match exactly
+
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <wx/wxprec.h>
+#ifndef WX_PRECOMP
+    #include <wx/wx.h>
+#endif
+
+#include "gui/controls/DataGridTranscoder.h"
+
+namespace
+{
+
+static bool check(bool condition, const char* testName)
+{
+    if (condition)
+    {
+        std::cout << "  PASSED: " << testName << "\n";
+        return true;
+    }
+    else
+    {
+        std::cout << "  FAILED: " << testName << "\n";
+        return false;
+    }
+}
+
+wxString oldHex(const std::string& value)
+{
+    wxString val;
+    for (std::string::size_type p = 0; p < value.length(); p++)
+        val += wxString::Format("%02x", uint8_t(value[p]));
+    return val;
+}
+
+wxString oldDecode(const std::string& value, wxMBConv& converter,
+    size_t charSize)
+{
+    wxString val = wxString(value.c_str(), converter);
+    if (val.Length() > charSize)
+    {
+        size_t trimLen = val.Strip().Length();
+        val.Truncate(trimLen > charSize ? trimLen : charSize);
+    }
+    return val;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// a CHAR(charSize) CHARACTER SET UTF8 value, padded with spaces to four
+// bytes per character the way Firebird returns it
+std::string padded(const std::string& text, size_t charSize)
+{
+    return text + std::string(4 * charSize - text.size(), ' ');
+}
+
+} // namespace
+
+int main()
+{
+    wxInitializer initializer;
+    if (!initializer.IsOk())
+    {
+        std::cerr << "Failed to initialize wxWidgets\n";
+        return 1;
+    }
+
+    bool allPassed = true;
+    std::cout << "Running DataGridTranscoder Benchmark...\n";
+
+    wxCSConv utf8(wxFONTENCODING_UTF8);
+    wxCSConv latin1(wxFONTENCODING_ISO8859_1);
+    DataGridTranscoder utf8Transcoder(&utf8);
+    DataGridTranscoder latin1Transcoder(&latin1);
+    allPassed &= check(utf8Transcoder.isUTF8() && !latin1Transcoder.isUTF8(),
+        "UTF-8 converter recognized");
+
+    // Test 1: same text as before, for both converters
+    {
+        std::vector<std::pair<std::string, size_t> > values;
+        values.push_back(std::make_pair(std::string(), size_t(10)));
+        values.push_back(std::make_pair(std::string("plain ascii"), size_t(20)));
+        values.push_back(std::make_pair(padded("abc", 10), size_t(10)));
+        values.push_back(std::make_pair(padded("caf\xC3\xA9", 4), size_t(4)));
+        values.push_back(std::make_pair(padded("\xE2\x82\xAC 5", 8), size_t(8)));
+        values.push_back(std::make_pair(padded("", 3), size_t(3)));
+        values.push_back(std::make_pair(std::string("abc   "), size_t(4)));
+        values.push_back(std::make_pair(std::string("tab\t\r\n  "), size_t(5)));
+        values.push_back(std::make_pair(std::string("emoji \xF0\x9F\x98\x80 end"), size_t(40)));
+        values.push_back(std::make_pair(std::string("nul\0after   ", 12), size_t(5)));
+        values.push_back(std::make_pair(std::string("bad \xC3 utf8    "), size_t(6)));
+        values.push_back(std::make_pair(std::string("overlong \xC0\xAF    "), size_t(6)));
+        values.push_back(std::make_pair(std::string("surrogate \xED\xA0\x80"), size_t(20)));
+        values.push_back(std::make_pair(std::string("long ascii run of text 0123456789"), size_t(64)));
+
+        bool same = true;
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            const std::string& v = values[i].first;
+            size_t size = values[i].second;
+            same = same && utf8Transcoder.decode(v, size) == oldDecode(v, utf8, size)
+                && latin1Transcoder.decode(v, size) == oldDecode(v, latin1, size);
+        }
+        allPassed &= check(same, "Decoded text unchanged");
+
+        std::string bytes;
+        for (int b = 0; b < 256; ++b)
+            bytes += char(b);
+        allPassed &= check(DataGridTranscoder::toHex(bytes) == oldHex(bytes)
+            && DataGridTranscoder::toHex(std::string()).empty(), "Hex unchanged");
+    }
+
+    // Test 2: 200000 UUIDs and CHAR(40) values
+    {
+        const size_t rowCount = 200000;
+        std::vector<std::string> uuids(rowCount), names(rowCount);
+        for (size_t i = 0; i < rowCount; ++i)
+        {
+            for (int b = 0; b < 16; ++b)
+                uuids[i] += char((i * 131 + b * 17) & 0xFF);
+            std::string name("Customer \xC3\x84rger #" + std::to_string(i));
+            names[i] = padded(name, 40);
+        }
+
+        size_t length = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < rowCount; ++i)
+            length += oldHex(uuids[i]).length();
+        double oldHexMs = elapsedMs(start);
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < rowCount; ++i)
+            length -= DataGridTranscoder::toHex(uuids[i]).length();
+        double hexMs = elapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < rowCount; ++i)
+            length += oldDecode(names[i], utf8, 40).length();
+        double oldTextMs = elapsedMs(start);
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < rowCount; ++i)
+            length -= utf8Transcoder.decode(names[i], 40).length();
+        double textMs = elapsedMs(start);
+
+        std::cout << "  INFO: " << rowCount << " OCTETS(16) values: "
+                  << oldHexMs << " ms before, " << hexMs << " ms now\n";
+        std::cout << "  INFO: " << rowCount << " CHAR(40) UTF8 values: "
+                  << oldTextMs << " ms before, " << textMs << " ms now\n";
+        allPassed &= check(length == 0, "Same lengths");
+        allPassed &= check(hexMs * 5 < oldHexMs, "Hex at least 5x faster");
+        allPassed &= check(textMs < oldTextMs, "Text faster");
+    }
+
+    std::cout << "DataGridTranscoder Benchmark completed: "
+              << (allPassed ? "ALL PASSED" : "SOME FAILED") << "\n";
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,401 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <charconv>
+#include <cmath>
+
+#include "mcp/ColumnarResultWriter.h"
+
+namespace fr
+{
+
+namespace
+{
+
+void appendDigits(std::string& out, int value, int width)
+{
+    char buffer[12];
+    int length = 0;
+    unsigned v = value < 0 ? 0 : unsigned(value);
+    do
+    {
+        buffer[length++] = char('0' + v % 10);
+        v /= 10;
+    }
+    while (v);
+    for (int i = length; i < width; ++i)
+        out += '0';
+    while (length)
+        out += buffer[--length];
+}
+
+void appendDate(std::string& out, int year, int month, int day)
+{
+    appendDigits(out, year, 4);
+    out += '-';
+    appendDigits(out, month, 2);
+    out += '-';
+    appendDigits(out, day, 2);
+}
+
+// fraction is in 1/10000 seconds, like Firebird stores it
+void appendTime(std::string& out, int hour, int minute, int second,
+    int fraction)
+{
+    appendDigits(out, hour, 2);
+    out += ':';
+    appendDigits(out, minute, 2);
+    out += ':';
+    appendDigits(out, second, 2);
+    out += '.';
+    appendDigits(out, fraction, 4);
+}
+
+void appendBase64(std::string& out, const std::vector<uint8_t>& data)
+{
+    static const char digits[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t i = 0;
+    for (; i + 2 < data.size(); i += 3)
+    {
+        uint32_t v = (uint32_t(data[i]) << 16) | (uint32_t(data[i + 1]) << 8)
+            | data[i + 2];
+        out += digits[v >> 18];
+        out += digits[(v >> 12) & 63];
+        out += digits[(v >> 6) & 63];
+        out += digits[v & 63];
+    }
+    if (i < data.size())
+    {
+        uint32_t v = uint32_t(data[i]) << 16;
+        if (i + 1 < data.size())
+            v |= uint32_t(data[i + 1]) << 8;
+        out += digits[v >> 18];
+        out += digits[(v >> 12) & 63];
+        out += i + 1 < data.size() ? digits[(v >> 6) & 63] : '=';
+        out += '=';
+    }
+}
+
+} // namespace
+
+ColumnarResultWriter::ColumnarResultWriter()
+    : rowCountM(0)
+{
+}
+
+ColumnarResultWriter::Kind ColumnarResultWriter::getKind(ColumnType type)
+{
+    switch (type)
+    {
+        case ColumnType::Integer:
+        case ColumnType::BigInt:
+            return kInteger;
+        case ColumnType::Numeric:
+        case ColumnType::Decimal:
+            return kNumeric;
+        case ColumnType::Float:
+        case ColumnType::Double:
+            return kDouble;
+        case ColumnType::Boolean:
+            return kBoolean;
+        case ColumnType::Date:
+            return kDate;
+        case ColumnType::Time:
+            return kTime;
+        case ColumnType::Timestamp:
+            return kTimestamp;
+        default:
+            return kString;
+    }
+}
+
+const char* ColumnarResultWriter::getKindName(Kind kind)
+{
+    switch (kind)
+    {
+        case kInteger: return "integer";
+        case kNumeric: return "numeric";
+        case kDouble: return "double";
+        case kBoolean: return "boolean";
+        case kDate: return "date";
+        case kTime: return "time";
+        case kTimestamp: return "timestamp";
+        default: return "string";
+    }
+}
+
+void ColumnarResultWriter::addColumn(const std::string& name, Kind kind,
+    int scale)
+{
+    Column column;
+    column.name = name;
+    column.kind = kind;
+    column.scale = kind == kNumeric ? scale : 0;
+    column.valueCount = 0;
+    columnsM.push_back(column);
+}
+
+void ColumnarResultWriter::addColumns(IStatement& statement)
+{
+    for (int i = 0; i < statement.getColumnCount(); ++i)
+    {
+        addColumn(statement.getColumnName(i),
+            getKind(statement.getColumnType(i)), statement.getColumnScale(i));
+    }
+}
+
+size_t ColumnarResultWriter::getColumnCount() const
+{
+    return columnsM.size();
+}
+
+size_t ColumnarResultWriter::getRowCount() const
+{
+    return rowCountM;
+}
+
+void ColumnarResultWriter::appendSeparator(Column& column)
+{
+    if (column.valueCount++)
+        column.values += ',';
+}
+
+void ColumnarResultWriter::setNull(size_t column)
+{
+    std::vector<uint8_t>& nulls = columnsM[column].nulls;
+    if (nulls.size() <= rowCountM / 8)
+        nulls.resize(rowCountM / 8 + 1);
+    nulls[rowCountM / 8] |= uint8_t(1 << (rowCountM % 8));
+}
+
+void ColumnarResultWriter::setInteger(size_t column, int64_t value)
+{
+    Column& c = columnsM[column];
+    appendSeparator(c);
+    char buffer[24];
+    char* end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+    c.values.append(buffer, end);
+}
+
+void ColumnarResultWriter::setDouble(size_t column, double value)
+{
+    // JSON has no infinity or NaN
+    if (!std::isfinite(value))
+    {
+        setNull(column);
+        return;
+    }
+    Column& c = columnsM[column];
+    appendSeparator(c);
+    char buffer[32];
+    char* end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+    c.values.append(buffer, end);
+}
+
+void ColumnarResultWriter::setBoolean(size_t column, bool value)
+{
+    Column& c = columnsM[column];
+    appendSeparator(c);
+    c.values += value ? "true" : "false";
+}
+
+void ColumnarResultWriter::setDate(size_t column, int year, int month,
+    int day)
+{
+    Column& c = columnsM[column];
+    appendSeparator(c);
+    c.values += '"';
+    appendDate(c.values, year, month, day);
+    c.values += '"';
+}
+
+void ColumnarResultWriter::setTime(size_t column, int hour, int minute,
+    int second, int fraction)
+{
+    Column& c = columnsM[column];
+    appendSeparator(c);
+    c.values += '"';
+    appendTime(c.values, hour, minute, second, fraction);
+    c.values += '"';
+}
+
+void ColumnarResultWriter::setTimestamp(size_t column, int year, int month,
+    int day, int hour, int minute, int second, int fraction)
+{
+    Column& c = columnsM[column];
+    appendSeparator(c);
+    c.values += '"';
+    appendDate(c.values, year, month, day);
+    c.values += 'T';
+    appendTime(c.values, hour, minute, second, fraction);
+    c.values += '"';
+}
+
+void ColumnarResultWriter::setString(size_t column, const std::string& value)
+{
+    Column& c = columnsM[column];
+    appendSeparator(c);
+    appendString(c.values, value);
+}
+
+void ColumnarResultWriter::nextRow()
+{
+    ++rowCountM;
+}
+
+void ColumnarResultWriter::addRow(IStatement& statement)
+{
+    for (size_t i = 0; i < columnsM.size(); ++i)
+    {
+        int index = int(i);
+        if (statement.isNull(index))
+        {
+            setNull(i);
+            continue;
+        }
+        int year, month, day, hour, minute, second, fraction;
+        switch (columnsM[i].kind)
+        {
+            case kInteger:
+            case kNumeric:
+                setInteger(i, statement.getInt64(index));
+                break;
+            case kDouble:
+                setDouble(i, statement.getDouble(index));
+                break;
+            case kBoolean:
+                setBoolean(i, statement.getBool(index));
+                break;
+            case kDate:
+                statement.getDate(index, year, month, day);
+                setDate(i, year, month, day);
+                break;
+            case kTime:
+                statement.getTime(index, hour, minute, second, fraction);
+                setTime(i, hour, minute, second, fraction);
+                break;
+            case kTimestamp:
+                statement.getTimestamp(index, year, month, day, hour, minute,
+                    second, fraction);
+                setTimestamp(i, year, month, day, hour, minute, second,
+                    fraction);
+                break;
+            default:
+                setString(i, statement.getString(index));
+                break;
+        }
+    }
+    nextRow();
+}
+
+void ColumnarResultWriter::writeMembers(std::string& out) const
+{
+    size_t size = 64;
+    for (size_t i = 0; i < columnsM.size(); ++i)
+        size += columnsM[i].values.size() + columnsM[i].nulls.size() * 4 / 3 + 64;
+    out.reserve(out.size() + size);
+
+    out += "\"columns\":[";
+    for (size_t i = 0; i < columnsM.size(); ++i)
+    {
+        const Column& c = columnsM[i];
+        if (i)
+            out += ',';
+        out += "{\"name\":";
+        appendString(out, c.name);
+        out += ",\"type\":\"";
+        out += getKindName(c.kind);
+        out += '"';
+        if (c.kind == kNumeric)
+        {
+            out += ",\"scale\":";
+            appendDigits(out, c.scale, 1);
+        }
+        out += '}';
+    }
+    out += "],\"row_count\":";
+    char buffer[24];
+    out.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer),
+        rowCountM).ptr);
+    out += ",\"data\":[";
+    for (size_t i = 0; i < columnsM.size(); ++i)
+    {
+        const Column& c = columnsM[i];
+        if (i)
+            out += ',';
+        out += "{\"values\":[";
+        out += c.values;
+        out += ']';
+        if (!c.nulls.empty())
+        {
+            std::vector<uint8_t> nulls(c.nulls);
+            nulls.resize((rowCountM + 7) / 8);
+            out += ",\"nulls\":\"";
+            appendBase64(out, nulls);
+            out += '"';
+        }
+        out += '}';
+    }
+    out += ']';
+}
+
+void ColumnarResultWriter::appendString(std::string& out,
+    const std::string& value)
+{
+    static const char hex[] = "0123456789abcdef";
+    out += '"';
+    size_t start = 0;
+    for (size_t i = 0; i < value.size(); ++i)
+    {
+        unsigned char c = value[i];
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+        out.append(value, start, i - start);
+        start = i + 1;
+        switch (c)
+        {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                out += "\\u00";
+                out += hex[c >> 4];
+                out += hex[c & 15];
+                break;
+        }
+    }
+    out.append(value, start, value.size() - start);
+    out += '"';
+}
+
+} // namespace fr
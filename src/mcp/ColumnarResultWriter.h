@@ -0,0 +1,103 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_MCP_COLUMNARRESULTWRITER_H
+#define FR_MCP_COLUMNARRESULTWRITER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "engine/db/IStatement.h"
+
+namespace fr
+{
+
+// ColumnarResultWriter class
+// Writes a result set as JSON text with the columns described once and the
+// values of every column in one array, instead of an object per row that
+// repeats the column names. The values are appended to the text of their
+// column as the rows are added, so no JSON document is built.
+// Only the values that aren't NULL are in the arrays; a column that has
+// NULLs also has "nulls", a base64 encoded bitmap with a bit per row (the
+// lowest bit of the first byte for the first row) that is set for NULL.
+// Integers and the unscaled values of NUMERIC and DECIMAL columns are
+// numbers, dates and times ISO 8601 strings and INT128, DECFLOAT, the time
+// zone types and all others strings.
+class ColumnarResultWriter
+{
+public:
+    enum Kind { kInteger, kNumeric, kDouble, kBoolean, kDate, kTime,
+        kTimestamp, kString };
+private:
+    struct Column
+    {
+        std::string name;
+        Kind kind;
+        int scale;
+        std::string values;
+        size_t valueCount;
+        std::vector<uint8_t> nulls;
+    };
+    std::vector<Column> columnsM;
+    size_t rowCountM;
+
+    void appendSeparator(Column& column);
+public:
+    ColumnarResultWriter();
+
+    static Kind getKind(ColumnType type);
+    static const char* getKindName(Kind kind);
+
+    void addColumn(const std::string& name, Kind kind, int scale = 0);
+    // adds the columns of a prepared statement
+    void addColumns(IStatement& statement);
+    size_t getColumnCount() const;
+    size_t getRowCount() const;
+
+    // the values of the current row, every column has to be set once
+    // before nextRow() is called
+    void setNull(size_t column);
+    void setInteger(size_t column, int64_t value);
+    void setDouble(size_t column, double value);
+    void setBoolean(size_t column, bool value);
+    void setDate(size_t column, int year, int month, int day);
+    void setTime(size_t column, int hour, int minute, int second,
+        int fraction);
+    void setTimestamp(size_t column, int year, int month, int day,
+        int hour, int minute, int second, int fraction);
+    void setString(size_t column, const std::string& value);
+    void nextRow();
+    // adds the current row of the statement
+    void addRow(IStatement& statement);
+
+    // appends "columns", "row_count" and "data" as members of an object,
+    // without the braces, so the caller can add more members
+    void writeMembers(std::string& out) const;
+
+    static void appendString(std::string& out, const std::string& value);
+};
+
+} // namespace fr
+
+#endif // FR_MCP_COLUMNARRESULTWRITER_H
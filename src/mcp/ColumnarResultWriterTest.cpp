@@ -0,0 +1,213 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <nlohmann/json.hpp>
+
+#include "mcp/ColumnarResultWriter.h"
+
+using json = nlohmann::json;
+
+namespace
+{
+
+bool check(bool condition, const char* testName)
+{
+    if (condition)
+    {
+        std::cout << "  PASSED: " << testName << "\n";
+        return true;
+    }
+    std::cout << "  FAILED: " << testName << "\n";
+    return false;
+}
+
+typedef fr::ColumnarResultWriter Writer;
+
+json parse(const Writer& writer)
+{
+    std::string text("{");
+    writer.writeMembers(text);
+    text += "}";
+    return json::parse(text);
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = true;
+    std::cout << "Running ColumnarResultWriter Tests...\n";
+
+    // Test 1: every kind of value
+    {
+        Writer writer;
+        writer.addColumn("ID", Writer::kInteger);
+        writer.addColumn("PRICE", Writer::kNumeric, 2);
+        writer.addColumn("RATIO", Writer::kDouble);
+        writer.addColumn("ACTIVE", Writer::kBoolean);
+        writer.addColumn("DAY", Writer::kDate);
+        writer.addColumn("AT", Writer::kTime);
+        writer.addColumn("CREATED", Writer::kTimestamp);
+        writer.addColumn("NAME", Writer::kString);
+        writer.setInteger(0, -9007199254740993LL);
+        writer.setInteger(1, 1999);
+        writer.setDouble(2, 0.1);
+        writer.setBoolean(3, true);
+        writer.setDate(4, 2026, 1, 5);
+        writer.setTime(5, 7, 8, 9, 1234);
+        writer.setTimestamp(6, 999, 12, 31, 23, 59, 59, 9999);
+        writer.setString(7, "say \"hi\"\\\n\x01 \xc3\xa4");
+        writer.nextRow();
+
+        json result = parse(writer);
+        const json& data = result["data"];
+        ok = check(result["row_count"] == 1 && result["columns"].size() == 8
+            && result["columns"][1]["type"] == "numeric"
+            && result["columns"][1]["scale"] == 2
+            && !result["columns"][0].contains("scale"), "Column metadata") && ok;
+        ok = check(data[0]["values"][0] == -9007199254740993LL
+            && data[1]["values"][0] == 1999 && data[2]["values"][0] == 0.1
+            && data[3]["values"][0] == true, "Numbers and booleans") && ok;
+        ok = check(data[4]["values"][0] == "2026-01-05"
+            && data[5]["values"][0] == "07:08:09.1234"
+            && data[6]["values"][0] == "0999-12-31T23:59:59.9999",
+            "Dates and times") && ok;
+        ok = check(data[7]["values"][0] == "say \"hi\"\\\n\x01 \xc3\xa4",
+            "Strings escaped") && ok;
+    }
+
+    // Test 2: NULLs are left out of the values and marked in the bitmap
+    {
+        Writer writer;
+        writer.addColumn("A", Writer::kInteger);
+        writer.addColumn("B", Writer::kString);
+        for (int row = 0; row < 10; ++row)
+        {
+            if (row == 0 || row == 9)
+                writer.setNull(0);
+            else
+                writer.setInteger(0, row);
+            writer.setString(1, "x");
+            writer.nextRow();
+        }
+        json result = parse(writer);
+        const json& data = result["data"];
+        ok = check(data[0]["values"].size() == 8 && data[0]["values"][0] == 1
+            && data[0]["nulls"] == "AQI=" && !data[1].contains("nulls")
+            && data[1]["values"].size() == 10, "Null bitmap") && ok;
+
+        Writer empty;
+        empty.addColumn("A", Writer::kDouble);
+        json emptyResult = parse(empty);
+        ok = check(emptyResult["row_count"] == 0
+            && emptyResult["data"][0]["values"].empty(), "Empty result") && ok;
+    }
+
+    // Test 3: 100k rows, compared with an object per row
+    {
+        const int rowCount = 100000;
+        auto start = std::chrono::steady_clock::now();
+        json rows = json::array();
+        for (int i = 0; i < rowCount; ++i)
+        {
+            json row;
+            row["CUSTOMER_ID"] = i;
+            row["ORDER_TOTAL"] = std::to_string(i / 100) + "."
+                + std::to_string(10 + i % 90);
+            row["DISCOUNT_RATE"] = i * 0.001;
+            row["ORDER_DATE"] = "2026-10-18";
+            row["CUSTOMER_NAME"] = "Customer " + std::to_string(i);
+            if (i % 3)
+                row["REMARKS"] = nullptr;
+            else
+                row["REMARKS"] = "Call before delivery";
+            rows.push_back(row);
+        }
+        json result;
+        result["rows"] = rows;
+        result["column_count"] = 6;
+        std::string rowsText = result.dump(2);
+        double rowsMs = elapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        Writer writer;
+        writer.addColumn("CUSTOMER_ID", Writer::kInteger);
+        writer.addColumn("ORDER_TOTAL", Writer::kNumeric, 2);
+        writer.addColumn("DISCOUNT_RATE", Writer::kDouble);
+        writer.addColumn("ORDER_DATE", Writer::kDate);
+        writer.addColumn("CUSTOMER_NAME", Writer::kString);
+        writer.addColumn("REMARKS", Writer::kString);
+        for (int i = 0; i < rowCount; ++i)
+        {
+            writer.setInteger(0, i);
+            writer.setInteger(1, (i / 100) * 100 + 10 + i % 90);
+            writer.setDouble(2, i * 0.001);
+            writer.setDate(3, 2026, 10, 18);
+            writer.setString(4, "Customer " + std::to_string(i));
+            if (i % 3)
+                writer.setNull(5);
+            else
+                writer.setString(5, "Call before delivery");
+            writer.nextRow();
+        }
+        std::string columnsText("{");
+        writer.writeMembers(columnsText);
+        columnsText += ",\"column_count\":6}";
+        double columnsMs = elapsedMs(start);
+
+        std::cout << "  INFO: " << rowCount << " rows as objects: "
+                  << rowsText.size() << " bytes in " << rowsMs << " ms, as columns: "
+                  << columnsText.size() << " bytes in " << columnsMs << " ms\n";
+        json parsed = json::parse(columnsText);
+        ok = check(parsed["row_count"] == rowCount
+            && parsed["data"][5]["values"].size() == size_t(rowCount + 2) / 3
+            && parsed["data"][4]["values"][rowCount - 1] == "Customer 99999",
+            "Columnar result complete") && ok;
+        ok = check(columnsText.size() * 3 < rowsText.size(),
+            "Columnar result is less than a third of the size") && ok;
+        ok = check(columnsMs * 5 < rowsMs, "Columnar result is at least 5x faster") && ok;
+    }
+
+    std::cout << "ColumnarResultWriter Tests completed: "
+              << (ok ? "ALL PASSED" : "SOME FAILED") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_MCP_LRUCACHE_H
+#define FR_MCP_LRUCACHE_H
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace fr
+{
+
+// LruCache class
+// Maps keys to values and keeps at most capacity of them. Adding a value
+// to a full cache drops the one that was used least recently; lookups and
+// insertions take constant time.
+template<typename Key, typename Value, typename Hash = std::hash<Key> >
+class LruCache
+{
+private:
+    typedef std::list<std::pair<Key, Value> > Entries;
+    Entries entriesM;   // the most recently used first
+    std::unordered_map<Key, typename Entries::iterator, Hash> indexM;
+    size_t capacityM;
+    size_t hitsM;
+    size_t missesM;
+
+    void shrink(size_t count)
+    {
+        while (entriesM.size() > count)
+        {
+            indexM.erase(entriesM.back().first);
+            entriesM.pop_back();
+        }
+    }
+public:
+    // the capacity is at least 1
+    explicit LruCache(size_t capacity)
+        : capacityM(capacity ? capacity : 1), hitsM(0), missesM(0)
+    {
+    }
+
+    // returns the value of key and marks it as used, or 0 if there is none
+    Value* find(const Key& key)
+    {
+        typename std::unordered_map<Key, typename Entries::iterator,
+            Hash>::iterator it = indexM.find(key);
+        if (it == indexM.end())
+        {
+            ++missesM;
+            return 0;
+        }
+        ++hitsM;
+        entriesM.splice(entriesM.begin(), entriesM, it->second);
+        return &it->second->second;
+    }
+
+    // adds or replaces the value of key, returns the cached value
+    Value& insert(const Key& key, const Value& value)
+    {
+        typename std::unordered_map<Key, typename Entries::iterator,
+            Hash>::iterator it = indexM.find(key);
+        if (it != indexM.end())
+        {
+            it->second->second = value;
+            entriesM.splice(entriesM.begin(), entriesM, it->second);
+            return it->second->second;
+        }
+        shrink(capacityM - 1);
+        entriesM.push_front(std::make_pair(key, value));
+        indexM[key] = entriesM.begin();
+        return entriesM.front().second;
+    }
+
+    bool erase(const Key& key)
+    {
+        typename std::unordered_map<Key, typename Entries::iterator,
+            Hash>::iterator it = indexM.find(key);
+        if (it == indexM.end())
+            return false;
+        entriesM.erase(it->second);
+        indexM.erase(it);
+        return true;
+    }
+
+    void clear()
+    {
+        entriesM.clear();
+        indexM.clear();
+    }
+
+    size_t size() const
+    {
+        return entriesM.size();
+    }
+
+    size_t getCapacity() const
+    {
+        return capacityM;
+    }
+
+    void setCapacity(size_t capacity)
+    {
+        capacityM = capacity ? capacity : 1;
+        shrink(capacityM);
+    }
+
+    size_t getHits() const
+    {
+        return hitsM;
+    }
+
+    size_t getMisses() const
+    {
+        return missesM;
+    }
+};
+
+} // namespace fr
+
+#endif // FR_MCP_LRUCACHE_H
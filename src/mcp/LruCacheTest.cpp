@@ -0,0 +1,138 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include "mcp/LruCache.h"
+
+namespace
+{
+
+bool check(bool condition, const char* testName)
+{
+    if (condition)
+    {
+        std::cout << "  PASSED: " << testName << "\n";
+        return true;
+    }
+    std::cout << "  FAILED: " << testName << "\n";
+    return false;
+}
+
+typedef fr::LruCache<std::string, int> Cache;
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = true;
+    std::cout << "Running LruCache Tests...\n";
+
+    // Test 1: the least recently used value is dropped
+    {
+        Cache cache(3);
+        cache.insert("a", 1);
+        cache.insert("b", 2);
+        cache.insert("c", 3);
+        ok = check(cache.find("a") && *cache.find("a") == 1, "Find value") && ok;
+        cache.insert("d", 4);
+        ok = check(cache.size() == 3 && !cache.find("b") && cache.find("a")
+            && cache.find("c") && cache.find("d"), "Least recently used dropped") && ok;
+        ok = check(cache.getHits() == 5 && cache.getMisses() == 1,
+            "Hits and misses counted") && ok;
+    }
+
+    // Test 2: replacing, erasing and shrinking
+    {
+        Cache cache(3);
+        cache.insert("a", 1);
+        cache.insert("b", 2);
+        cache.insert("a", 10);
+        ok = check(cache.size() == 2 && *cache.find("a") == 10, "Value replaced") && ok;
+        ok = check(cache.erase("a") && !cache.erase("a") && cache.size() == 1,
+            "Value erased") && ok;
+        cache.insert("c", 3);
+        cache.insert("d", 4);
+        cache.find("b");
+        cache.setCapacity(2);
+        ok = check(cache.size() == 2 && cache.find("b") && cache.find("d")
+            && !cache.find("c"), "Capacity reduced") && ok;
+        cache.setCapacity(0);
+        ok = check(cache.getCapacity() == 1 && cache.size() == 1, "Capacity at least 1") && ok;
+        cache.clear();
+        ok = check(cache.size() == 0 && !cache.find("b"), "Cache cleared") && ok;
+    }
+
+    // Test 3: a cache of 64 statements for a workload with repeated SQL text
+    {
+        const int lookups = 1000000;
+        std::vector<std::string> sql;
+        for (int i = 0; i < 80; ++i)
+            sql.push_back("SELECT * FROM TABLE_" + std::to_string(i) + " WHERE ID = ?");
+        Cache cache(64);
+        size_t prepared = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < lookups; ++i)
+        {
+            // most calls use a few statements, some use any of them
+            const std::string& text = sql[i % 10 ? i % 16 : (i / 10) % 80];
+            if (!cache.find(text))
+            {
+                cache.insert(text, i);
+                ++prepared;
+            }
+        }
+        double ms = elapsedMs(start);
+        std::cout << "  INFO: " << lookups << " lookups in " << ms << " ms, "
+                  << prepared << " statements prepared\n";
+        ok = check(cache.size() == 64 && prepared == cache.getMisses()
+            && cache.getHits() + cache.getMisses() == size_t(lookups)
+            && prepared < size_t(lookups) / 5, "Repeated statements are cached") && ok;
+        bool hot = true;
+        for (int i = 0; i < 16; ++i)
+            hot = cache.find(sql[i]) && hot;
+        ok = check(hot, "Frequently used statements stay cached") && ok;
+    }
+
+    std::cout << "LruCache Tests completed: "
+              << (ok ? "ALL PASSED" : "SOME FAILED") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,392 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <wx/filefn.h>
+
+#include <stdexcept>
+
+#include "config/Config.h"
+#include "core/StringUtils.h"
+#include "mcp/McpConnectionPool.h"
+#include "metadata/database.h"
+#include "metadata/root.h"
+#include "metadata/server.h"
+#include "metadata/table.h"
+#include "metadata/view.h"
+
+namespace fr
+{
+
+namespace
+{
+
+// throws if the connection is broken
+void ping(IDatabasePtr database)
+{
+    ITransactionPtr tr = database->createTransaction();
+    tr->setAccessMode(TransactionAccessMode::Read);
+    tr->start();
+    IStatementPtr st = database->createStatement(tr);
+    st->prepare("SELECT 1 FROM RDB$DATABASE");
+    st->execute();
+    st->fetch();
+    tr->commit();
+}
+
+// loads what get_schema and the object lookups need first
+void loadMetadata(DatabasePtr database)
+{
+    database->getTables()->ensureChildrenLoaded();
+    database->getViews()->ensureChildrenLoaded();
+}
+
+void disconnect(IDatabasePtr database)
+{
+    try
+    {
+        database->disconnect();
+    }
+    catch (...)
+    {
+    }
+}
+
+} // namespace
+
+McpConnectionPool::Attachment::Attachment(size_t cacheSize)
+    : statements(cacheSize)
+{
+}
+
+McpConnectionPool::Entry::Entry()
+    : leased(0)
+{
+}
+
+McpConnectionPool::McpConnectionPool(size_t maxIdle,
+        size_t statementCacheSize, std::chrono::seconds checkInterval)
+    : rootFileTimeM(0), maxIdleM(maxIdle),
+      statementCacheSizeM(statementCacheSize), checkIntervalM(checkInterval)
+{
+}
+
+McpConnectionPool::~McpConnectionPool()
+{
+    std::lock_guard<std::mutex> metadataLock(metadataMutexM);
+    std::lock_guard<std::mutex> lock(mutexM);
+    disconnectAll();
+}
+
+void McpConnectionPool::loadRoot()
+{
+    wxString fileName(config().getDBHFileName());
+    time_t modified = wxFileExists(fileName)
+        ? wxFileModificationTime(fileName) : 0;
+    if (rootM && modified == rootFileTimeM)
+        return;
+
+    disconnectAll();
+    rootM.reset(new Root());
+    rootM->load();
+    rootFileTimeM = modified;
+    for (const auto& server : rootM->getServers())
+    {
+        // the first database with a name is used, like the lookup did
+        // before the pool existed
+        for (const auto& db : server->getDatabases())
+            databasesM.insert(std::make_pair(wx2std(db->getName_()), db));
+    }
+}
+
+void McpConnectionPool::disconnectAll()
+{
+    for (auto& entry : entriesM)
+    {
+        for (auto& attachment : entry.second.idle)
+            disconnect(attachment->database);
+    }
+    entriesM.clear();
+    for (auto& db : databasesM)
+    {
+        try
+        {
+            if (db.second->isConnected())
+                db.second->disconnect();
+        }
+        catch (...)
+        {
+        }
+    }
+    databasesM.clear();
+}
+
+McpConnectionPool::Entry& McpConnectionPool::getEntry(const std::string& name,
+    const std::string& password)
+{
+    loadRoot();
+    std::map<std::string, DatabasePtr>::iterator it = databasesM.find(name);
+    if (it == databasesM.end())
+    {
+        throw std::runtime_error("Database '" + name
+            + "' not found in FlameRobin configuration.");
+    }
+
+    DatabasePtr db = it->second;
+    Entry& entry = entriesM[name];
+    std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+    wxString pwd(wxString::FromUTF8(password.c_str()));
+    if (!db->isConnected())
+    {
+        db->connect(pwd.empty() ? db->getDecryptedPassword() : pwd, nullptr);
+        loadMetadata(db);
+    }
+    else if (now - entry.lastUsed >= checkIntervalM)
+    {
+        try
+        {
+            ping(db->getDALDatabase());
+        }
+        catch (std::exception&)
+        {
+            db->reconnect(pwd);
+            loadMetadata(db);
+        }
+    }
+    entry.database = db;
+    entry.lastUsed = now;
+    return entry;
+}
+
+bool McpConnectionPool::isAlive(Attachment& attachment)
+{
+    if (!attachment.database->isConnected())
+        return false;
+    if (std::chrono::steady_clock::now() - attachment.lastUsed < checkIntervalM)
+        return true;
+    try
+    {
+        ping(attachment.database);
+        return true;
+    }
+    catch (std::exception&)
+    {
+        return false;
+    }
+}
+
+void McpConnectionPool::release(const std::string& name,
+    std::unique_ptr<Attachment> attachment)
+{
+    std::lock_guard<std::mutex> lock(mutexM);
+    attachment->lastUsed = std::chrono::steady_clock::now();
+    std::map<std::string, Entry>::iterator it = entriesM.find(name);
+    // the entry is gone if the configuration was loaded again meanwhile
+    if (it == entriesM.end())
+    {
+        disconnect(attachment->database);
+        return;
+    }
+    Entry& entry = it->second;
+    if (entry.leased)
+        --entry.leased;
+    if (entry.idle.size() < maxIdleM && attachment->database->isConnected())
+        entry.idle.push_back(std::move(attachment));
+    else
+        disconnect(attachment->database);
+}
+
+std::unique_lock<std::mutex> McpConnectionPool::lockMetadata()
+{
+    return std::unique_lock<std::mutex>(metadataMutexM);
+}
+
+RootPtr McpConnectionPool::getRoot()
+{
+    std::lock_guard<std::mutex> lock(mutexM);
+    loadRoot();
+    return rootM;
+}
+
+DatabasePtr McpConnectionPool::getDatabase(const std::string& name,
+    const std::string& password)
+{
+    std::lock_guard<std::mutex> lock(mutexM);
+    return getEntry(name, password).database;
+}
+
+McpConnectionPool::Lease McpConnectionPool::acquire(const std::string& name,
+    const std::string& password)
+{
+    IDatabasePtr dal;
+    {
+        // getEntry() may connect the database again or reload the
+        // configuration, and the settings for a new attachment are read
+        // from the Database object, so both need the metadata lock
+        std::lock_guard<std::mutex> metadataLock(metadataMutexM);
+        std::lock_guard<std::mutex> lock(mutexM);
+        Entry& entry = getEntry(name, password);
+        while (!entry.idle.empty())
+        {
+            std::unique_ptr<Attachment> attachment(
+                std::move(entry.idle.back()));
+            entry.idle.pop_back();
+            if (isAlive(*attachment))
+            {
+                ++entry.leased;
+                return Lease(this, name, std::move(attachment));
+            }
+            disconnect(attachment->database);
+        }
+        dal = entry.database->createDALConnection(false);
+        ++entry.leased;
+    }
+
+    // connecting takes a while, other calls can use the pool meanwhile
+    std::unique_ptr<Attachment> attachment(new Attachment(statementCacheSizeM));
+    try
+    {
+        dal->connect();
+        attachment->database = dal;
+        attachment->transaction = attachment->database->createTransaction();
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(mutexM);
+        std::map<std::string, Entry>::iterator it = entriesM.find(name);
+        if (it != entriesM.end() && it->second.leased)
+            --it->second.leased;
+        throw;
+    }
+    attachment->lastUsed = std::chrono::steady_clock::now();
+    return Lease(this, name, std::move(attachment));
+}
+
+McpConnectionPool::Stats McpConnectionPool::getStats(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(mutexM);
+    Stats stats = { 0, 0, 0, 0 };
+    std::map<std::string, Entry>::const_iterator it = entriesM.find(name);
+    if (it == entriesM.end())
+        return stats;
+    stats.idle = it->second.idle.size();
+    stats.leased = it->second.leased;
+    for (const auto& attachment : it->second.idle)
+    {
+        stats.statementHits += attachment->statements.getHits();
+        stats.statementMisses += attachment->statements.getMisses();
+    }
+    return stats;
+}
+
+McpConnectionPool::Lease::Lease(McpConnectionPool* pool,
+        const std::string& name, std::unique_ptr<Attachment> attachment)
+    : poolM(pool), nameM(name), attachmentM(std::move(attachment))
+{
+}
+
+McpConnectionPool::Lease::Lease(Lease&& other)
+    : poolM(other.poolM), nameM(std::move(other.nameM)),
+      attachmentM(std::move(other.attachmentM))
+{
+}
+
+McpConnectionPool::Lease::~Lease()
+{
+    if (!attachmentM)
+        return;
+    try
+    {
+        if (attachmentM->transaction->isActive())
+            attachmentM->transaction->rollback();
+    }
+    catch (...)
+    {
+    }
+    poolM->release(nameM, std::move(attachmentM));
+}
+
+IDatabasePtr McpConnectionPool::Lease::getDatabase() const
+{
+    return attachmentM->database;
+}
+
+ITransactionPtr McpConnectionPool::Lease::getTransaction()
+{
+    if (!attachmentM->transaction->isActive())
+        attachmentM->transaction->start();
+    return attachmentM->transaction;
+}
+
+IStatementPtr McpConnectionPool::Lease::prepare(const std::string& sql)
+{
+    if (IStatementPtr* cached = attachmentM->statements.find(sql))
+        return *cached;
+    IStatementPtr st = attachmentM->database->createStatement(getTransaction());
+    st->prepare(sql);
+    return attachmentM->statements.insert(sql, st);
+}
+
+IStatementPtr McpConnectionPool::Lease::execute(const std::string& sql)
+{
+    ITransactionPtr tr = getTransaction();
+    if (IStatementPtr* cached = attachmentM->statements.find(sql))
+    {
+        IStatementPtr st = *cached;
+        try
+        {
+            st->execute();
+            return st;
+        }
+        catch (std::exception&)
+        {
+            // a real error happens again below, with a fresh statement
+            attachmentM->statements.erase(sql);
+        }
+    }
+    IStatementPtr st = attachmentM->database->createStatement(tr);
+    st->prepare(sql);
+    st->execute();
+    return attachmentM->statements.insert(sql, st);
+}
+
+void McpConnectionPool::Lease::commit()
+{
+    if (attachmentM->transaction->isActive())
+        attachmentM->transaction->commit();
+}
+
+void McpConnectionPool::Lease::rollback()
+{
+    if (attachmentM->transaction->isActive())
+        attachmentM->transaction->rollback();
+}
+
+} // namespace fr
@@ -0,0 +1,155 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_MCP_CONNECTIONPOOL_H
+#define FR_MCP_CONNECTIONPOOL_H
+
+#include <chrono>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "engine/db/IDatabase.h"
+#include "engine/db/IStatement.h"
+#include "engine/db/ITransaction.h"
+#include "metadata/MetadataClasses.h"
+#include "mcp/LruCache.h"
+
+namespace fr
+{
+
+// McpConnectionPool class
+// What the MCP server keeps between tool calls: the registered databases,
+// loaded once and again only when fr_databases.conf changes, the Database
+// objects that stay connected so their metadata is only loaded once, and
+// for every database a pool of attachments that each have a transaction
+// and a cache of prepared statements.
+// Connections that were idle for a while are checked with a trivial query
+// before they are used again, broken ones are replaced.
+// Attachments can be leased on any thread. The metadata objects are shared
+// though, so they may only be used while lockMetadata() is held.
+class McpConnectionPool
+{
+private:
+    struct Attachment
+    {
+        IDatabasePtr database;
+        ITransactionPtr transaction;
+        LruCache<std::string, IStatementPtr> statements;
+        std::chrono::steady_clock::time_point lastUsed;
+
+        explicit Attachment(size_t cacheSize);
+    };
+
+    struct Entry
+    {
+        DatabasePtr database;
+        std::chrono::steady_clock::time_point lastUsed;
+        std::vector<std::unique_ptr<Attachment> > idle;
+        size_t leased;
+
+        Entry();
+    };
+
+    std::mutex metadataMutexM;  // locked before mutexM
+    std::mutex mutexM;
+    RootPtr rootM;
+    time_t rootFileTimeM;
+    std::map<std::string, DatabasePtr> databasesM;
+    std::map<std::string, Entry> entriesM;
+    size_t maxIdleM;
+    size_t statementCacheSizeM;
+    std::chrono::seconds checkIntervalM;
+
+    void loadRoot();
+    void disconnectAll();
+    Entry& getEntry(const std::string& name, const std::string& password);
+    bool isAlive(Attachment& attachment);
+    void release(const std::string& name,
+        std::unique_ptr<Attachment> attachment);
+public:
+    // an attachment taken from the pool, it goes back when the lease is
+    // destroyed; a transaction that wasn't committed is rolled back then
+    class Lease
+    {
+    private:
+        McpConnectionPool* poolM;
+        std::string nameM;
+        std::unique_ptr<Attachment> attachmentM;
+
+        friend class McpConnectionPool;
+        Lease(McpConnectionPool* pool, const std::string& name,
+            std::unique_ptr<Attachment> attachment);
+    public:
+        Lease(Lease&& other);
+        ~Lease();
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        IDatabasePtr getDatabase() const;
+        // the transaction of the attachment, started if it isn't active
+        ITransactionPtr getTransaction();
+        // a statement prepared for sql, from the cache if it was prepared
+        // on this attachment before
+        IStatementPtr prepare(const std::string& sql);
+        // prepares and executes sql; a cached statement that fails, e.g.
+        // because the objects it uses have been changed, is prepared again
+        IStatementPtr execute(const std::string& sql);
+        void commit();
+        void rollback();
+    };
+
+    // the statement cache counts are those of the idle attachments
+    struct Stats
+    {
+        size_t idle;
+        size_t leased;
+        size_t statementHits;
+        size_t statementMisses;
+    };
+
+    McpConnectionPool(size_t maxIdle = 4, size_t statementCacheSize = 64,
+        std::chrono::seconds checkInterval = std::chrono::seconds(30));
+    ~McpConnectionPool();
+
+    // has to be held while the root or the databases are used
+    std::unique_lock<std::mutex> lockMetadata();
+    // the root with the registered servers and databases; lockMetadata()
+    // has to be held, loading the configuration disconnects the databases
+    RootPtr getRoot();
+    // the registered database with that name, connected; lockMetadata()
+    // has to be held, the database may be connected again
+    DatabasePtr getDatabase(const std::string& name,
+        const std::string& password);
+    // an attachment to the registered database with that name; takes the
+    // metadata lock itself, so it must not be held by the caller
+    Lease acquire(const std::string& name, const std::string& password);
+    Stats getStats(const std::string& name);
+};
+
+} // namespace fr
+
+#endif // FR_MCP_CONNECTIONPOOL_H
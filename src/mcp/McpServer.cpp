@@ -29,8 +29,20 @@
 #endif
 
 #include "mcp/McpServer.h"
+#include "mcp/ColumnarResultWriter.h"
+#include "mcp/McpConnectionPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include <memory>
 #include <stdexcept>
@@ -149,10 +161,1172 @@ static MetadataItem* findMetadataObject(DatabasePtr db, const std::string& name)
     return nullptr;
 }
 
+
+namespace
+{
+
+// the number of tool calls that are executed at the same time
+const size_t workerCount = 4;
+// execute_query returns at most this many rows at once, if the client
+// doesn't ask for fewer
+const size_t defaultPageRows = 1000;
+const size_t maxPageRows = 10000;
+// unfinished results are closed when they weren't used for a while, or
+// when there are too many of them
+const std::chrono::minutes cursorTimeout(5);
+const size_t maxCursors = 32;
+
+// RequestContext class
+// The state of a tools/call request that notifications/cancelled can
+// cancel. Long running tools check it between rows, and the statement that
+// runs when the request is cancelled is cancelled on the server.
+class RequestContext
+{
+private:
+    std::atomic<bool> cancelledM;
+    std::mutex mutexM;
+    IDatabasePtr runningM;
+public:
+    RequestContext()
+        : cancelledM(false)
+    {
+    }
+
+    bool isCancelled() const
+    {
+        return cancelledM;
+    }
+
+    void checkCancelled() const
+    {
+        if (cancelledM)
+            throw std::runtime_error("The request was cancelled.");
+    }
+
+    void cancel()
+    {
+        std::lock_guard<std::mutex> lock(mutexM);
+        cancelledM = true;
+        if (runningM)
+            runningM->cancelOperation();
+    }
+
+    // the connection the statements of the request run on, 0 when they
+    // are done; throws if the request was cancelled already
+    void setRunning(IDatabasePtr database)
+    {
+        std::lock_guard<std::mutex> lock(mutexM);
+        if (database)
+            checkCancelled();
+        runningM = database;
+    }
+};
+
+// makes the connection of a lease the one a cancel request cancels, until
+// the guard is destroyed and the connection can go back to the pool
+class CancelGuard
+{
+private:
+    RequestContext& contextM;
+public:
+    CancelGuard(RequestContext& context, IDatabasePtr database)
+        : contextM(context)
+    {
+        contextM.setRunning(database);
+    }
+
+    ~CancelGuard()
+    {
+        contextM.setRunning(IDatabasePtr());
+    }
+
+    CancelGuard(const CancelGuard&) = delete;
+    CancelGuard& operator=(const CancelGuard&) = delete;
+};
+
+// the result of execute_query, kept with its attachment and transaction
+// while it has rows that weren't returned yet
+struct Cursor
+{
+    McpConnectionPool::Lease lease;
+    IStatementPtr statement;
+    std::vector<std::string> columns;
+    bool pending;   // the statement is on a row that wasn't returned yet
+    std::chrono::steady_clock::time_point lastUsed;
+
+    explicit Cursor(McpConnectionPool::Lease&& lease)
+        : lease(std::move(lease)), pending(false),
+          lastUsed(std::chrono::steady_clock::now())
+    {
+    }
+};
+
+// CursorStore class
+// The unfinished results by the id that was returned to the client. A
+// cursor is taken out while its rows are read, so every one is only used
+// by one request at a time.
+class CursorStore
+{
+private:
+    std::mutex mutexM;
+    std::map<std::string, std::unique_ptr<Cursor> > cursorsM;
+    size_t nextIdM;
+
+    void expire()
+    {
+        std::chrono::steady_clock::time_point now =
+            std::chrono::steady_clock::now();
+        for (auto it = cursorsM.begin(); it != cursorsM.end(); )
+        {
+            if (now - it->second->lastUsed > cursorTimeout)
+                it = cursorsM.erase(it);
+            else
+                ++it;
+        }
+        while (cursorsM.size() >= maxCursors)
+        {
+            auto oldest = cursorsM.begin();
+            for (auto it = cursorsM.begin(); it != cursorsM.end(); ++it)
+            {
+                if (it->second->lastUsed < oldest->second->lastUsed)
+                    oldest = it;
+            }
+            cursorsM.erase(oldest);
+        }
+    }
+public:
+    CursorStore()
+        : nextIdM(1)
+    {
+    }
+
+    // keeps the cursor under id, or under a new one if id is empty;
+    // returns the id
+    std::string add(std::unique_ptr<Cursor> cursor, const std::string& id)
+    {
+        std::lock_guard<std::mutex> lock(mutexM);
+        expire();
+        std::string key(id.empty() ? std::to_string(nextIdM++) : id);
+        cursor->lastUsed = std::chrono::steady_clock::now();
+        cursorsM[key] = std::move(cursor);
+        return key;
+    }
+
+    std::unique_ptr<Cursor> take(const std::string& id)
+    {
+        std::lock_guard<std::mutex> lock(mutexM);
+        expire();
+        auto it = cursorsM.find(id);
+        if (it == cursorsM.end())
+        {
+            throw std::runtime_error("Cursor '" + id
+                + "' not found, its result may have been closed.");
+        }
+        std::unique_ptr<Cursor> cursor(std::move(it->second));
+        cursorsM.erase(it);
+        return cursor;
+    }
+};
+
+json readRow(IStatementPtr st, const std::vector<std::string>& columns)
+{
+    json row;
+    for (int i = 0; i < int(columns.size()); ++i)
+    {
+        const std::string& colName = columns[i];
+        if (st->isNull(i))
+        {
+            row[colName] = nullptr;
+        }
+        else
+        {
+            fr::ColumnType colType = st->getColumnType(i);
+            switch (colType)
+            {
+                case fr::ColumnType::Integer:
+                    row[colName] = st->getInt32(i);
+                    break;
+                case fr::ColumnType::BigInt:
+                    row[colName] = st->getInt64(i);
+                    break;
+                case fr::ColumnType::Float:
+                case fr::ColumnType::Double:
+                    row[colName] = st->getDouble(i);
+                    break;
+                case fr::ColumnType::Boolean:
+                    row[colName] = st->getBool(i);
+                    break;
+                default:
+                    row[colName] = st->getString(i);
+                    break;
+            }
+        }
+    }
+    return row;
+}
+
+// calls addRow for up to maxRows rows of the cursor, returns true if it
+// has more
+bool fetchRows(Cursor& cursor, size_t maxRows, RequestContext& context,
+    const std::function<void()>& addRow)
+{
+    IStatementPtr st = cursor.statement;
+    for (size_t count = 0; count < maxRows; ++count)
+    {
+        if (!cursor.pending && !st->fetch())
+            return false;
+        cursor.pending = false;
+        context.checkCancelled();
+        addRow();
+    }
+    // only a row that exists makes the client ask for the next page
+    cursor.pending = st->fetch();
+    return cursor.pending;
+}
+
+json getToolList()
+{
+    json tools = json::array();
+
+    // list_databases tool
+    json listDbs;
+    listDbs["name"] = "list_databases";
+    listDbs["description"] = "List all Firebird databases registered in FlameRobin configuration.";
+    listDbs["inputSchema"] = {
+        {"type", "object"},
+        {"properties", json::object()}
+    };
+    tools.push_back(listDbs);
+
+    // get_schema tool
+    json getSchema;
+    getSchema["name"] = "get_schema";
+    getSchema["description"] = "Retrieve the schema layout (tables, views, columns) of a specific database.";
+    getSchema["inputSchema"] = {
+        {"type", "object"},
+        {"properties", {
+            {"database_name", {
+                {"type", "string"},
+                {"description", "The name of the database as registered in FlameRobin."}
+            }},
+            {"password", {
+                {"type", "string"},
+                {"description", "Optional connection password if not saved."}
+            }}
+        }},
+        {"required", json::array({"database_name"})}
+    };
+    tools.push_back(getSchema);
+
+    // execute_query tool
+    json execQuery;
+    execQuery["name"] = "execute_query";
+    execQuery["description"] = "Execute a SQL query (SELECT, INSERT, UPDATE, etc.) on a specific database and return rows/results. Large results are returned in pages: pass the returned next_cursor to get the next one.";
+    execQuery["inputSchema"] = {
+        {"type", "object"},
+        {"properties", {
+            {"database_name", {
+                {"type", "string"},
+                {"description", "The name of the database as registered in FlameRobin."}
+            }},
+            {"sql", {
+                {"type", "string"},
+                {"description", "The SQL statement to execute."}
+            }},
+            {"password", {
+                {"type", "string"},
+                {"description", "Optional connection password if not saved."}
+            }},
+            {"cursor", {
+                {"type", "string"},
+                {"description", "The next_cursor of a previous call, to get the next rows of its result instead of executing sql."}
+            }},
+            {"max_rows", {
+                {"type", "integer"},
+                {"description", "The maximum number of rows of a SELECT to return, 1000 if omitted, at most 10000. Other statements always return all their rows and are committed at once."}
+            }},
+            {"format", {
+                {"type", "string"},
+                {"enum", json::array({"rows", "columns"})},
+                {"description", "\"rows\" (default) returns an object per row. \"columns\" describes the columns once and returns the values of every column in one array; NULLs are left out and marked in a base64 bitmap with a bit per row, NUMERIC values are unscaled integers."}
+            }}
+        }},
+        {"required", json::array({"database_name"})}
+    };
+    tools.push_back(execQuery);
+
+    // get_metadata_ddl tool
+    json getDdl;
+    getDdl["name"] = "get_metadata_ddl";
+    getDdl["description"] = "Retrieve the SQL Data Definition Language (DDL) statement used to create or define a specific database object (table, view, procedure, trigger, generator, domain, role, exception, package).";
+    getDdl["inputSchema"] = {
+        {"type", "object"},
+        {"properties", {
+            {"database_name", {
+                {"type", "string"},
+                {"description", "The name of the database as registered in FlameRobin."}
+            }},
+            {"object_name", {
+                {"type", "string"},
+                {"description", "The name of the metadata object (case-insensitive)."}
+            }},
+            {"password", {
+                {"type", "string"},
+                {"description", "Optional connection password if not saved."}
+            }}
+        }},
+        {"required", json::array({"database_name", "object_name"})}
+    };
+    tools.push_back(getDdl);
+
+    // get_database_info tool
+    json getDbInfo;
+    getDbInfo["name"] = "get_database_info";
+    getDbInfo["description"] = "Retrieve detailed system information, file pages, sweep, configuration, transaction history, encryption state, and active transaction list of a database.";
+    getDbInfo["inputSchema"] = {
+        {"type", "object"},
+        {"properties", {
+            {"database_name", {
+                {"type", "string"},
+                {"description", "The name of the database as registered in FlameRobin."}
+            }},
+            {"password", {
+                {"type", "string"},
+                {"description", "Optional connection password if not saved."}
+            }}
+        }},
+        {"required", json::array({"database_name"})}
+    };
+    tools.push_back(getDbInfo);
+
+    // explain_query tool
+    json explainQuery;
+    explainQuery["name"] = "explain_query";
+    explainQuery["description"] = "Retrieve and analyze Firebird query execution plan (PLAN) and detailed tree explain (EXPLAIN).";
+    explainQuery["inputSchema"] = {
+        {"type", "object"},
+        {"properties", {
+            {"database_name", {
+                {"type", "string"},
+                {"description", "The name of the database as registered in FlameRobin."}
+            }},
+            {"sql", {
+                {"type", "string"},
+                {"description", "The SQL query to explain."}
+            }},
+            {"password", {
+                {"type", "string"},
+                {"description", "Optional connection password if not saved."}
+            }}
+        }},
+        {"required", json::array({"database_name", "sql"})}
+    };
+    tools.push_back(explainQuery);
+
+    // compare_schemas tool
+    json compareSchemasTool;
+    compareSchemasTool["name"] = "compare_schemas";
+    compareSchemasTool["description"] = "Compare two Firebird database schemas and generate executable migration DDL script.";
+    compareSchemasTool["inputSchema"] = {
+        {"type", "object"},
+        {"properties", {
+            {"source_database_name", {
+                {"type", "string"},
+                {"description", "The name of the source (reference) database."}
+            }},
+            {"target_database_name", {
+                {"type", "string"},
+                {"description", "The name of the target database to migrate."}
+            }},
+            {"source_password", {
+                {"type", "string"},
+                {"description", "Optional password for source database."}
+            }},
+            {"target_password", {
+                {"type", "string"},
+                {"description", "Optional password for target database."}
+            }},
+            {"generate_drop_statements", {
+                {"type", "boolean"},
+                {"description", "Set true to generate DROP statements for extra columns/objects in target."}
+            }}
+        }},
+        {"required", json::array({"source_database_name", "target_database_name"})}
+    };
+    tools.push_back(compareSchemasTool);
+
+    // get_performance_stats tool
+    json getPerfStats;
+    getPerfStats["name"] = "get_performance_stats";
+    getPerfStats["description"] = "Fetch active session metrics, statement counts, active transactions, and memory/page allocations from Firebird MON$ tables.";
+    getPerfStats["inputSchema"] = {
+        {"type", "object"},
+        {"properties", {
+            {"database_name", {
+                {"type", "string"},
+                {"description", "The name of the database as registered in FlameRobin."}
+            }},
+            {"password", {
+                {"type", "string"},
+                {"description", "Optional connection password if not saved."}
+            }}
+        }},
+        {"required", json::array({"database_name"})}
+    };
+    tools.push_back(getPerfStats);
+
+    // list_active_sessions tool
+    json listActiveSessionsTool;
+    listActiveSessionsTool["name"] = "list_active_sessions";
+    listActiveSessionsTool["description"] = "List active database connections, running queries, and remote attachment details via MON$ system tables.";
+    listActiveSessionsTool["inputSchema"] = {
+        {"type", "object"},
+        {"properties", {
+            {"database_name", {
+                {"type", "string"},
+                {"description", "The name of the database as registered in FlameRobin."}
+            }},
+            {"password", {
+                {"type", "string"},
+                {"description", "Optional connection password if not saved."}
+            }}
+        }},
+        {"required", json::array({"database_name"})}
+    };
+    tools.push_back(listActiveSessionsTool);
+
+    // cancel_statement tool
+    json cancelStatementTool;
+    cancelStatementTool["name"] = "cancel_statement";
+    cancelStatementTool["description"] = "Cancel an actively executing SQL statement by statement ID (MON$STATEMENT_ID).";
+    cancelStatementTool["inputSchema"] = {
+        {"type", "object"},
+        {"properties", {
+            {"database_name", {
+                {"type", "string"},
+                {"description", "The name of the database as registered in FlameRobin."}
+            }},
+            {"statement_id", {
+                {"type", "integer"},
+                {"description", "The MON$STATEMENT_ID of the SQL query to cancel."}
+            }},
+            {"password", {
+                {"type", "string"},
+                {"description", "Optional connection password if not saved."}
+            }}
+        }},
+        {"required", json::array({"database_name", "statement_id"})}
+    };
+    tools.push_back(cancelStatementTool);
+
+    // recalculate_index_stats tool
+    json recalculateIndexStatsTool;
+    recalculateIndexStatsTool["name"] = "recalculate_index_stats";
+    recalculateIndexStatsTool["description"] = "Recalculate index selectivities (SET STATISTICS INDEX) for all user indices or a specific index.";
+    recalculateIndexStatsTool["inputSchema"] = {
+        {"type", "object"},
+        {"properties", {
+            {"database_name", {
+                {"type", "string"},
+                {"description", "The name of the database as registered in FlameRobin."}
+            }},
+            {"index_name", {
+                {"type", "string"},
+                {"description", "Optional name of a specific index. If omitted, recalculates all user indices."}
+            }},
+            {"password", {
+                {"type", "string"},
+                {"description", "Optional connection password if not saved."}
+            }}
+        }},
+        {"required", json::array({"database_name"})}
+    };
+    tools.push_back(recalculateIndexStatsTool);
+
+    // get_memory_diagnostics tool
+    json getMemoryDiagTool;
+    getMemoryDiagTool["name"] = "get_memory_diagnostics";
+    getMemoryDiagTool["description"] = "Retrieve Firebird memory pool allocations (MON$POOLS), memory usage stats (MON$MEMORY_USAGE), and connection pool metrics.";
+    getMemoryDiagTool["inputSchema"] = {
+        {"type", "object"},
+        {"properties", {
+            {"database_name", {
+                {"type", "string"},
+                {"description", "The name of the database as registered in FlameRobin."}
+            }},
+            {"password", {
+                {"type", "string"},
+                {"description", "Optional connection password if not saved."}
+            }}
+        }},
+        {"required", json::array({"database_name"})}
+    };
+    tools.push_back(getMemoryDiagTool);
+
+    return tools;
+}
+
+// returns the text of the result
+std::string callTool(McpConnectionPool& pool, CursorStore& cursors,
+    const std::string& toolName, const json& args, RequestContext& context)
+{
+    json toolResult;
+
+    if (toolName == "list_databases")
+    {
+        std::unique_lock<std::mutex> metadataLock(pool.lockMetadata());
+        RootPtr root = pool.getRoot();
+        json dbs = json::array();
+        for (const auto& server : root->getServers())
+        {
+            for (const auto& db : server->getDatabases())
+            {
+                json item;
+                item["name"] = wx2std(db->getName_());
+                item["server"] = wx2std(server->getName_());
+                item["connection_string"] = wx2std(db->getConnectionString());
+                item["username"] = wx2std(db->getUsername());
+                item["role"] = wx2std(db->getRole());
+                item["charset"] = wx2std(db->getConnectionCharset());
+                item["dialect"] = db->getSqlDialect();
+                dbs.push_back(item);
+            }
+        }
+        toolResult["databases"] = dbs;
+    }
+    else if (toolName == "get_schema")
+    {
+        std::string dbName = args.value("database_name", "");
+        std::string password = args.value("password", "");
+
+        std::unique_lock<std::mutex> metadataLock(pool.lockMetadata());
+        DatabasePtr targetDb = pool.getDatabase(dbName, password);
+
+        json schema;
+        schema["database"] = dbName;
+
+        // Tables
+        auto tables = targetDb->getTables();
+        tables->ensureChildrenLoaded();
+        json tableList = json::array();
+        std::vector<MetadataItem*> tableItems;
+        tables->getChildren(tableItems);
+        for (auto* item : tableItems)
+        {
+            auto* table = dynamic_cast<Table*>(item);
+            if (!table) continue;
+
+            json tbl;
+            tbl["name"] = wx2std(table->getName_());
+            tbl["type"] = "table";
+
+            table->ensureChildrenLoaded();
+            std::vector<MetadataItem*> colItems;
+            table->getChildren(colItems);
+
+            json colList = json::array();
+            for (auto* colItem : colItems)
+            {
+                auto* col = dynamic_cast<Column*>(colItem);
+                if (!col) continue;
+
+                json c;
+                c["name"] = wx2std(col->getName_());
+                c["type"] = wx2std(col->getDatatype());
+                c["nullable"] = col->isNullable(CheckDomainNullability);
+                c["is_primary_key"] = col->isPrimaryKey();
+                c["is_foreign_key"] = col->isForeignKey();
+                colList.push_back(c);
+            }
+            tbl["columns"] = colList;
+            tableList.push_back(tbl);
+        }
+        schema["tables"] = tableList;
+
+        // Views
+        auto views = targetDb->getViews();
+        views->ensureChildrenLoaded();
+        json viewList = json::array();
+        std::vector<MetadataItem*> viewItems;
+        views->getChildren(viewItems);
+        for (auto* item : viewItems)
+        {
+            auto* view = dynamic_cast<View*>(item);
+            if (!view) continue;
+
+            json v;
+            v["name"] = wx2std(view->getName_());
+            v["type"] = "view";
+
+            view->ensureChildrenLoaded();
+            std::vector<MetadataItem*> colItems;
+            view->getChildren(colItems);
+
+            json colList = json::array();
+            for (auto* colItem : colItems)
+            {
+                auto* col = dynamic_cast<Column*>(colItem);
+                if (!col) continue;
+
+                json c;
+                c["name"] = wx2std(col->getName_());
+                c["type"] = wx2std(col->getDatatype());
+                c["nullable"] = col->isNullable(CheckDomainNullability);
+                colList.push_back(c);
+            }
+            v["columns"] = colList;
+            viewList.push_back(v);
+        }
+        schema["views"] = viewList;
+
+        toolResult = schema;
+    }
+    else if (toolName == "execute_query")
+    {
+        std::string dbName = args.value("database_name", "");
+        std::string sql = args.value("sql", "");
+        std::string password = args.value("password", "");
+        std::string cursorId = args.value("cursor", "");
+        bool columnar = args.value("format", "rows") == "columns";
+        size_t maxRows = std::min<size_t>(
+            args.value("max_rows", defaultPageRows), maxPageRows);
+
+        std::unique_ptr<Cursor> cursor;
+        if (cursorId.empty())
+        {
+            if (sql.empty())
+                throw std::runtime_error("Either sql or cursor is required.");
+            cursor.reset(new Cursor(pool.acquire(dbName, password)));
+        }
+        else
+            cursor = cursors.take(cursorId);
+
+        CancelGuard guard(context, cursor->lease.getDatabase());
+        if (cursorId.empty())
+        {
+            cursor->statement = cursor->lease.execute(sql);
+            for (int i = 0; i < cursor->statement->getColumnCount(); ++i)
+                cursor->columns.push_back(cursor->statement->getColumnName(i));
+        }
+
+        maxRows = std::max<size_t>(maxRows, 1);
+        IStatementPtr st = cursor->statement;
+        // only a SELECT is paged: the transaction of DML with RETURNING or
+        // EXECUTE PROCEDURE would stay open with its changes until the last
+        // page, or be rolled back when the cursor expires
+        if (st->getType() != StatementType::Select)
+            maxRows = std::numeric_limits<size_t>::max();
+        json rows = json::array();
+        ColumnarResultWriter writer;
+        bool more = false;
+        if (columnar)
+        {
+            writer.addColumns(*st);
+            more = !cursor->columns.empty() && fetchRows(*cursor, maxRows,
+                context, [&]() { writer.addRow(*st); });
+        }
+        else
+        {
+            more = !cursor->columns.empty() && fetchRows(*cursor, maxRows,
+                context, [&]() { rows.push_back(readRow(st, cursor->columns)); });
+            toolResult["rows"] = rows;
+        }
+
+        toolResult["column_count"] = cursor->columns.size();
+        if (more)
+        {
+            toolResult["next_cursor"] = cursors.add(std::move(cursor), cursorId);
+        }
+        else
+        {
+            cursor->lease.commit();
+            toolResult["affected_rows"] = st->getAffectedRows();
+        }
+
+        if (columnar)
+        {
+            std::string text("{");
+            writer.writeMembers(text);
+            for (const auto& item : toolResult.items())
+            {
+                text += ",";
+                ColumnarResultWriter::appendString(text, item.key());
+                text += ":" + item.value().dump();
+            }
+            text += "}";
+            return text;
+        }
+    }
+    else if (toolName == "get_metadata_ddl")
+    {
+        std::string dbName = args.value("database_name", "");
+        std::string objName = args.value("object_name", "");
+        std::string password = args.value("password", "");
+
+        std::unique_lock<std::mutex> metadataLock(pool.lockMetadata());
+        DatabasePtr targetDb = pool.getDatabase(dbName, password);
+
+        MetadataItem* obj = findMetadataObject(targetDb, objName);
+        if (!obj)
+        {
+            throw std::runtime_error("Metadata object '" + objName + "' not found in database '" + dbName + "'.");
+        }
+
+        CreateDDLVisitor cdv;
+        obj->acceptVisitor(&cdv);
+
+        toolResult["object_name"] = objName;
+        toolResult["ddl"] = wx2std(cdv.getSql());
+    }
+    else if (toolName == "get_database_info")
+    {
+        std::string dbName = args.value("database_name", "");
+        std::string password = args.value("password", "");
+
+        McpConnectionPool::Lease lease = pool.acquire(dbName, password);
+        fr::DatabaseInfoData info;
+        lease.getDatabase()->getInfo(&info);
+
+        json dbInfo;
+        dbInfo["ods_version"] = std::to_string(info.ods) + "." + std::to_string(info.odsMinor);
+        dbInfo["page_size"] = info.pageSize;
+        dbInfo["pages_allocated"] = info.pages;
+        dbInfo["buffers"] = info.buffers;
+        dbInfo["sweep_interval"] = info.sweep;
+        dbInfo["forced_writes"] = info.forcedWrites;
+        dbInfo["reserve_space"] = info.reserve;
+        dbInfo["read_only"] = info.readOnly;
+        dbInfo["oldest_transaction"] = info.oldestTransaction;
+        dbInfo["oldest_active_transaction"] = info.oldestActiveTransaction;
+        dbInfo["oldest_snapshot"] = info.oldestSnapshot;
+        dbInfo["next_transaction"] = info.nextTransaction;
+        dbInfo["crypt_state"] = wx2std(cryptStateToString(info.cryptState));
+
+        json activeTxs = json::array();
+        for (const auto& tx : info.activeTransactions)
+        {
+            json t;
+            t["id"] = tx.id;
+            t["isolation_level"] = wx2std(isolationLevelToString(tx.isolationLevel));
+            t["read_only"] = tx.readOnly;
+            t["wait"] = tx.wait;
+            activeTxs.push_back(t);
+        }
+        dbInfo["active_transactions"] = activeTxs;
+
+        toolResult = dbInfo;
+    }
+    else if (toolName == "explain_query")
+    {
+        std::string dbName = args.value("database_name", "");
+        std::string sqlStr = args.value("sql", "");
+        std::string password = args.value("password", "");
+
+        McpConnectionPool::Lease lease = pool.acquire(dbName, password);
+        std::string plan = lease.prepare(sqlStr)->getPlan();
+        lease.rollback();
+
+        toolResult["plan"] = plan;
+    }
+    else if (toolName == "compare_schemas")
+    {
+        std::string srcDbName = args.value("source_database_name", "");
+        std::string tgtDbName = args.value("target_database_name", "");
+        std::string srcPwdStr = args.value("source_password", "");
+        std::string tgtPwdStr = args.value("target_password", "");
+        bool genDrop = args.value("generate_drop_statements", false);
+
+        std::unique_lock<std::mutex> metadataLock(pool.lockMetadata());
+        DatabasePtr srcDb = pool.getDatabase(srcDbName, srcPwdStr);
+        DatabasePtr tgtDb = pool.getDatabase(tgtDbName, tgtPwdStr);
+
+        SchemaDiffOptions opts;
+        opts.generateDropStatements = genDrop;
+
+        auto diffs = SchemaDiff::compareDatabases(srcDb.get(), tgtDb.get(), opts);
+        std::string migrationScript = wx2std(SchemaDiff::generateMigrationScript(diffs, srcDb.get(), tgtDb.get()));
+
+        json diffList = json::array();
+        for (const auto& item : diffs)
+        {
+            json d;
+            d["object_type"] = wx2std(item.objectType);
+            d["object_name"] = wx2std(item.objectName);
+            d["description"] = wx2std(item.description);
+            d["migration_sql"] = wx2std(item.migrationSql);
+            diffList.push_back(d);
+        }
+
+        toolResult["differences_count"] = diffs.size();
+        toolResult["migration_sql"] = migrationScript;
+        toolResult["differences"] = diffList;
+    }
+    else if (toolName == "get_performance_stats")
+    {
+        std::string dbName = args.value("database_name", "");
+        std::string password = args.value("password", "");
+
+        McpConnectionPool::Lease lease = pool.acquire(dbName, password);
+        json perf;
+
+        try
+        {
+            std::string monSql = "SELECT (SELECT COUNT(*) FROM MON$ATTACHMENTS WHERE MON$ATTACHMENT_ID <> CURRENT_ATTACHMENT_ID) AS active_attachments, "
+                "(SELECT COUNT(*) FROM MON$STATEMENTS WHERE MON$STATE = 1) AS active_statements, "
+                "(SELECT COUNT(*) FROM MON$TRANSACTIONS WHERE MON$STATE = 1) AS active_transactions "
+                "FROM RDB$DATABASE;";
+            auto st = lease.execute(monSql);
+
+            if (st->fetch())
+            {
+                perf["active_attachments"] = st->getInt32(0);
+                perf["active_statements"] = st->getInt32(1);
+                perf["active_transactions"] = st->getInt32(2);
+            }
+            lease.commit();
+        }
+        catch (const std::exception&)
+        {
+            perf["active_attachments"] = 0;
+            perf["active_statements"] = 0;
+            perf["active_transactions"] = 0;
+        }
+
+        fr::DatabaseInfoData info;
+        lease.getDatabase()->getInfo(&info);
+        perf["page_size"] = info.pageSize;
+        perf["pages_allocated"] = info.pages;
+        perf["buffers"] = info.buffers;
+        perf["oldest_transaction"] = info.oldestTransaction;
+        perf["oldest_active_transaction"] = info.oldestActiveTransaction;
+        perf["next_transaction"] = info.nextTransaction;
+
+        toolResult = perf;
+    }
+    else if (toolName == "list_active_sessions")
+    {
+        std::string dbName = args.value("database_name", "");
+        std::string password = args.value("password", "");
+
+        McpConnectionPool::Lease lease = pool.acquire(dbName, password);
+
+        json attList = json::array();
+        try
+        {
+            auto st = lease.execute("SELECT MON$ATTACHMENT_ID, MON$STATE, MON$USER, MON$ROLE, MON$REMOTE_ADDRESS, MON$REMOTE_PROCESS, MON$TIMESTAMP FROM MON$ATTACHMENTS ORDER BY MON$ATTACHMENT_ID;");
+            while (st->fetch())
+            {
+                json att;
+                att["attachment_id"] = st->getInt64(0);
+                att["state"] = st->isNull(1) ? 0 : st->getInt32(1);
+                att["user"] = st->getString(2);
+                att["role"] = st->getString(3);
+                att["remote_address"] = st->getString(4);
+                att["remote_process"] = st->getString(5);
+                att["timestamp"] = st->getTimestamp(6);
+                attList.push_back(att);
+            }
+        } catch (...) {}
+
+        json stmtList = json::array();
+        try
+        {
+            auto st = lease.execute("SELECT MON$STATEMENT_ID, MON$ATTACHMENT_ID, MON$STATE, MON$SQL_TEXT, MON$TIMESTAMP FROM MON$STATEMENTS WHERE MON$SQL_TEXT IS NOT NULL ORDER BY MON$STATEMENT_ID;");
+            while (st->fetch())
+            {
+                json stmt;
+                stmt["statement_id"] = st->getInt64(0);
+                stmt["attachment_id"] = st->getInt64(1);
+                stmt["state"] = st->isNull(2) ? 0 : st->getInt32(2);
+                stmt["sql_text"] = st->getString(3);
+                stmt["timestamp"] = st->getTimestamp(4);
+                stmtList.push_back(stmt);
+            }
+        } catch (...) {}
+
+        lease.commit();
+
+        toolResult["active_attachments"] = attList;
+        toolResult["active_statements"] = stmtList;
+    }
+    else if (toolName == "cancel_statement")
+    {
+        std::string dbName = args.value("database_name", "");
+        int64_t stmtId = args.value("statement_id", (int64_t)0);
+        std::string password = args.value("password", "");
+
+        McpConnectionPool::Lease lease = pool.acquire(dbName, password);
+        std::string cancelSql = "DELETE FROM MON$STATEMENTS WHERE MON$STATEMENT_ID = " + std::to_string(stmtId) + ";";
+        lease.execute(cancelSql);
+        lease.commit();
+
+        toolResult["success"] = true;
+        toolResult["message"] = "Statement ID " + std::to_string(stmtId) + " cancel signal sent successfully.";
+    }
+    else if (toolName == "recalculate_index_stats")
+    {
+        std::string dbName = args.value("database_name", "");
+        std::string targetIdx = args.value("index_name", "");
+        std::string password = args.value("password", "");
+
+        McpConnectionPool::Lease lease = pool.acquire(dbName, password);
+        CancelGuard guard(context, lease.getDatabase());
+        std::vector<std::string> indexNames;
+
+        if (!targetIdx.empty())
+        {
+            indexNames.push_back(targetIdx);
+        }
+        else
+        {
+            auto st = lease.execute("SELECT RDB$INDEX_NAME FROM RDB$INDICES WHERE (RDB$SYSTEM_FLAG = 0 OR RDB$SYSTEM_FLAG IS NULL);");
+            while (st->fetch())
+            {
+                std::string idx = st->getString(0);
+                size_t end = idx.find_last_not_of(" \t\r\n");
+                if (end != std::string::npos) idx = idx.substr(0, end + 1);
+                indexNames.push_back(idx);
+            }
+            lease.commit();
+        }
+
+        int count = 0;
+        json idxList = json::array();
+        for (const auto& idx : indexNames)
+        {
+            context.checkCancelled();
+            try
+            {
+                std::string sql = "SET STATISTICS INDEX \"" + idx + "\";";
+                // executed once, it only takes up room in the cache
+                auto st = lease.getDatabase()->createStatement(lease.getTransaction());
+                st->prepare(sql);
+                st->execute();
+                lease.commit();
+                count++;
+                idxList.push_back(idx);
+            }
+            catch (...)
+            {
+                lease.rollback();
+            }
+        }
+
+        toolResult["recalculated_count"] = count;
+        toolResult["indices"] = idxList;
+    }
+    else if (toolName == "get_memory_diagnostics")
+    {
+        std::string dbName = args.value("database_name", "");
+        std::string password = args.value("password", "");
+
+        McpConnectionPool::Lease lease = pool.acquire(dbName, password);
+        auto dalDb = lease.getDatabase();
+
+        std::vector<fr::MemoryPoolInfo> pools;
+        dalDb->getMemoryPoolInfo(pools);
+
+        std::vector<fr::MemoryUsageInfo> memUsage;
+        dalDb->getMemoryUsageInfo(memUsage);
+
+        std::vector<fr::ConnectionPoolInfo> connPools;
+        dalDb->getConnectionPoolInfo(connPools);
+
+        json poolsJson = json::array();
+        for (const auto& p : pools)
+        {
+            poolsJson.push_back({
+                {"pool_id", p.poolId},
+                {"attachment_id", p.attachmentId},
+                {"memory_allocated_bytes", p.memoryAllocated},
+                {"memory_used_bytes", p.memoryUsed},
+                {"name", p.name}
+            });
+        }
+
+        json memJson = json::array();
+        for (const auto& m : memUsage)
+        {
+            memJson.push_back({
+                {"memory_id", m.memoryId},
+                {"stat_group", m.statGroup},
+                {"memory_allocated_bytes", m.memoryAllocated},
+                {"memory_used_bytes", m.memoryUsed},
+                {"max_allocated_bytes", m.maxAllocated},
+                {"max_used_bytes", m.maxUsed}
+            });
+        }
+
+        json connPoolsJson = json::array();
+        for (const auto& cp : connPools)
+        {
+            connPoolsJson.push_back({
+                {"pool_id", cp.poolId},
+                {"database_name", cp.dbName},
+                {"active_connections", cp.activeConnections},
+                {"idle_connections", cp.idleConnections},
+                {"max_connections", cp.maxConnections},
+                {"min_connections", cp.minConnections},
+                {"waiting_requests", cp.waitingRequests}
+            });
+        }
+
+        toolResult["memory_pools"] = poolsJson;
+        toolResult["memory_usage"] = memJson;
+        toolResult["connection_pools"] = connPoolsJson;
+
+        McpConnectionPool::Stats stats = pool.getStats(dbName);
+        toolResult["mcp_pool"] = {
+            {"idle_attachments", stats.idle},
+            {"leased_attachments", stats.leased},
+            {"statement_cache_hits", stats.statementHits},
+            {"statement_cache_misses", stats.statementMisses}
+        };
+    }
+    else
+    {
+        throw std::runtime_error("Unknown tool: " + toolName);
+    }
+
+    return toolResult.dump(2);
+}
+
+// McpDispatcher class
+// Executes the tools/call requests on a fixed number of worker threads, so
+// a slow query doesn't hold up the other requests, and cancels them on
+// request. Responses are written when the calls finish, out of order; the
+// client matches them to the requests by their id.
+class McpDispatcher
+{
+private:
+    // the cursors hold leases, so they have to be destroyed before the pool
+    McpConnectionPool poolM;
+    CursorStore cursorsM;
+    std::mutex outputMutexM;
+    std::mutex queueMutexM;
+    std::condition_variable queueConditionM;
+    typedef std::pair<json, std::shared_ptr<RequestContext> > Request;
+    std::deque<Request> queueM;
+    // the requests that are queued or running, by their id
+    std::map<std::string, std::shared_ptr<RequestContext> > requestsM;
+    bool stoppingM;
+    std::vector<std::thread> workersM;
+
+    void work()
+    {
+        for (;;)
+        {
+            Request request;
+            {
+                std::unique_lock<std::mutex> lock(queueMutexM);
+                queueConditionM.wait(lock,
+                    [this]() { return stoppingM || !queueM.empty(); });
+                if (queueM.empty())
+                    return;
+                request = std::move(queueM.front());
+                queueM.pop_front();
+            }
+            call(request.first, *request.second);
+
+            std::lock_guard<std::mutex> lock(queueMutexM);
+            auto it = requestsM.find(request.first.value("id", json(nullptr)).dump());
+            if (it != requestsM.end() && it->second == request.second)
+                requestsM.erase(it);
+        }
+    }
+
+    void call(const json& request, RequestContext& context)
+    {
+        json params = request.value("params", json::object());
+        std::string toolName = params.value("name", "");
+        json args = params.value("arguments", json::object());
+
+        json response;
+        response["jsonrpc"] = "2.0";
+        response["id"] = request.value("id", json(nullptr));
+
+        json contentItem;
+        contentItem["type"] = "text";
+        bool isError = false;
+        try
+        {
+            context.checkCancelled();
+            contentItem["text"] = callTool(poolM, cursorsM, toolName, args, context);
+        }
+        catch (const std::exception& e)
+        {
+            contentItem["text"] = std::string("Error during execution: ") + e.what();
+            isError = true;
+        }
+
+        // a cancelled request isn't answered
+        if (context.isCancelled())
+            return;
+        response["result"] = {
+            {"content", json::array({contentItem})},
+            {"isError", isError}
+        };
+        write(response);
+    }
+public:
+    explicit McpDispatcher(size_t workers)
+        : stoppingM(false)
+    {
+        for (size_t i = 0; i < workers; ++i)
+            workersM.emplace_back([this]() { work(); });
+    }
+
+    // the requests that were received are executed before it returns
+    ~McpDispatcher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(queueMutexM);
+            stoppingM = true;
+        }
+        queueConditionM.notify_all();
+        for (std::thread& t : workersM)
+            t.join();
+    }
+
+    void write(const json& message)
+    {
+        std::string text(message.dump());
+        std::lock_guard<std::mutex> lock(outputMutexM);
+        std::cout << text << std::endl;
+    }
+
+    void dispatch(const json& request)
+    {
+        std::shared_ptr<RequestContext> context(new RequestContext());
+        {
+            std::lock_guard<std::mutex> lock(queueMutexM);
+            requestsM[request.value("id", json(nullptr)).dump()] = context;
+            queueM.push_back(Request(request, context));
+        }
+        queueConditionM.notify_one();
+    }
+
+    void cancel(const json& requestId)
+    {
+        std::shared_ptr<RequestContext> context;
+        {
+            std::lock_guard<std::mutex> lock(queueMutexM);
+            auto it = requestsM.find(requestId.dump());
+            if (it == requestsM.end())
+                return;
+            context = it->second;
+        }
+        context->cancel();
+    }
+};
+
+} // namespace
+
 void McpServer::run()
 {
     std::cerr << "[McpServer] Starting FlameRobin MCP server..." << std::endl;
 
+    McpDispatcher dispatcher(workerCount);
     std::string line;
     while (std::getline(std::cin, line))
     {
@@ -172,7 +1346,7 @@ void McpServer::run()
                 {"code", -32700},
                 {"message", std::string("Parse error: ") + e.what()}
             };
-            std::cout << errResponse.dump() << std::endl;
+            dispatcher.write(errResponse);
             continue;
         }
 
@@ -194,1106 +1368,31 @@ void McpServer::run()
                     {"version", "1.0.0"}
                 }}
             };
-            std::cout << response.dump() << std::endl;
+            dispatcher.write(response);
         }
         else if (method == "notifications/initialized")
         {
             // No response required for notifications
             continue;
         }
+        else if (method == "notifications/cancelled")
+        {
+            json params = request.value("params", json::object());
+            dispatcher.cancel(params.value("requestId", json(nullptr)));
+        }
         else if (method == "tools/list")
         {
             json response;
             response["jsonrpc"] = "2.0";
             response["id"] = id;
-            
-            json tools = json::array();
-
-            // list_databases tool
-            json listDbs;
-            listDbs["name"] = "list_databases";
-            listDbs["description"] = "List all Firebird databases registered in FlameRobin configuration.";
-            listDbs["inputSchema"] = {
-                {"type", "object"},
-                {"properties", json::object()}
-            };
-            tools.push_back(listDbs);
-
-            // get_schema tool
-            json getSchema;
-            getSchema["name"] = "get_schema";
-            getSchema["description"] = "Retrieve the schema layout (tables, views, columns) of a specific database.";
-            getSchema["inputSchema"] = {
-                {"type", "object"},
-                {"properties", {
-                    {"database_name", {
-                        {"type", "string"},
-                        {"description", "The name of the database as registered in FlameRobin."}
-                    }},
-                    {"password", {
-                        {"type", "string"},
-                        {"description", "Optional connection password if not saved."}
-                    }}
-                }},
-                {"required", json::array({"database_name"})}
-            };
-            tools.push_back(getSchema);
-
-            // execute_query tool
-            json execQuery;
-            execQuery["name"] = "execute_query";
-            execQuery["description"] = "Execute a SQL query (SELECT, INSERT, UPDATE, etc.) on a specific database and return rows/results.";
-            execQuery["inputSchema"] = {
-                {"type", "object"},
-                {"properties", {
-                    {"database_name", {
-                        {"type", "string"},
-                        {"description", "The name of the database as registered in FlameRobin."}
-                    }},
-                    {"sql", {
-                        {"type", "string"},
-                        {"description", "The SQL statement to execute."}
-                    }},
-                    {"password", {
-                        {"type", "string"},
-                        {"description", "Optional connection password if not saved."}
-                    }}
-                }},
-                {"required", json::array({"database_name", "sql"})}
-            };
-            tools.push_back(execQuery);
-
-            // get_metadata_ddl tool
-            json getDdl;
-            getDdl["name"] = "get_metadata_ddl";
-            getDdl["description"] = "Retrieve the SQL Data Definition Language (DDL) statement used to create or define a specific database object (table, view, procedure, trigger, generator, domain, role, exception, package).";
-            getDdl["inputSchema"] = {
-                {"type", "object"},
-                {"properties", {
-                    {"database_name", {
-                        {"type", "string"},
-                        {"description", "The name of the database as registered in FlameRobin."}
-                    }},
-                    {"object_name", {
-                        {"type", "string"},
-                        {"description", "The name of the metadata object (case-insensitive)."}
-                    }},
-                    {"password", {
-                        {"type", "string"},
-                        {"description", "Optional connection password if not saved."}
-                    }}
-                }},
-                {"required", json::array({"database_name", "object_name"})}
-            };
-            tools.push_back(getDdl);
-
-            // get_database_info tool
-            json getDbInfo;
-            getDbInfo["name"] = "get_database_info";
-            getDbInfo["description"] = "Retrieve detailed system information, file pages, sweep, configuration, transaction history, encryption state, and active transaction list of a database.";
-            getDbInfo["inputSchema"] = {
-                {"type", "object"},
-                {"properties", {
-                    {"database_name", {
-                        {"type", "string"},
-                        {"description", "The name of the database as registered in FlameRobin."}
-                    }},
-                    {"password", {
-                        {"type", "string"},
-                        {"description", "Optional connection password if not saved."}
-                    }}
-                }},
-                {"required", json::array({"database_name"})}
-            };
-            tools.push_back(getDbInfo);
-
-            // explain_query tool
-            json explainQuery;
-            explainQuery["name"] = "explain_query";
-            explainQuery["description"] = "Retrieve and analyze Firebird query execution plan (PLAN) and detailed tree explain (EXPLAIN).";
-            explainQuery["inputSchema"] = {
-                {"type", "object"},
-                {"properties", {
-                    {"database_name", {
-                        {"type", "string"},
-                        {"description", "The name of the database as registered in FlameRobin."}
-                    }},
-                    {"sql", {
-                        {"type", "string"},
-                        {"description", "The SQL query to explain."}
-                    }},
-                    {"password", {
-                        {"type", "string"},
-                        {"description", "Optional connection password if not saved."}
-                    }}
-                }},
-                {"required", json::array({"database_name", "sql"})}
-            };
-            tools.push_back(explainQuery);
-
-            // compare_schemas tool
-            json compareSchemasTool;
-            compareSchemasTool["name"] = "compare_schemas";
-            compareSchemasTool["description"] = "Compare two Firebird database schemas and generate executable migration DDL script.";
-            compareSchemasTool["inputSchema"] = {
-                {"type", "object"},
-                {"properties", {
-                    {"source_database_name", {
-                        {"type", "string"},
-                        {"description", "The name of the source (reference) database."}
-                    }},
-                    {"target_database_name", {
-                        {"type", "string"},
-                        {"description", "The name of the target database to migrate."}
-                    }},
-                    {"source_password", {
-                        {"type", "string"},
-                        {"description", "Optional password for source database."}
-                    }},
-                    {"target_password", {
-                        {"type", "string"},
-                        {"description", "Optional password for target database."}
-                    }},
-                    {"generate_drop_statements", {
-                        {"type", "boolean"},
-                        {"description", "Set true to generate DROP statements for extra columns/objects in target."}
-                    }}
-                }},
-                {"required", json::array({"source_database_name", "target_database_name"})}
-            };
-            tools.push_back(compareSchemasTool);
-
-            // get_performance_stats tool
-            json getPerfStats;
-            getPerfStats["name"] = "get_performance_stats";
-            getPerfStats["description"] = "Fetch active session metrics, statement counts, active transactions, and memory/page allocations from Firebird MON$ tables.";
-            getPerfStats["inputSchema"] = {
-                {"type", "object"},
-                {"properties", {
-                    {"database_name", {
-                        {"type", "string"},
-                        {"description", "The name of the database as registered in FlameRobin."}
-                    }},
-                    {"password", {
-                        {"type", "string"},
-                        {"description", "Optional connection password if not saved."}
-                    }}
-                }},
-                {"required", json::array({"database_name"})}
-            };
-            tools.push_back(getPerfStats);
-
-            // list_active_sessions tool
-            json listActiveSessionsTool;
-            listActiveSessionsTool["name"] = "list_active_sessions";
-            listActiveSessionsTool["description"] = "List active database connections, running queries, and remote attachment details via MON$ system tables.";
-            listActiveSessionsTool["inputSchema"] = {
-                {"type", "object"},
-                {"properties", {
-                    {"database_name", {
-                        {"type", "string"},
-                        {"description", "The name of the database as registered in FlameRobin."}
-                    }},
-                    {"password", {
-                        {"type", "string"},
-                        {"description", "Optional connection password if not saved."}
-                    }}
-                }},
-                {"required", json::array({"database_name"})}
-            };
-            tools.push_back(listActiveSessionsTool);
-
-            // cancel_statement tool
-            json cancelStatementTool;
-            cancelStatementTool["name"] = "cancel_statement";
-            cancelStatementTool["description"] = "Cancel an actively executing SQL statement by statement ID (MON$STATEMENT_ID).";
-            cancelStatementTool["inputSchema"] = {
-                {"type", "object"},
-                {"properties", {
-                    {"database_name", {
-                        {"type", "string"},
-                        {"description", "The name of the database as registered in FlameRobin."}
-                    }},
-                    {"statement_id", {
-                        {"type", "integer"},
-                        {"description", "The MON$STATEMENT_ID of the SQL query to cancel."}
-                    }},
-                    {"password", {
-                        {"type", "string"},
-                        {"description", "Optional connection password if not saved."}
-                    }}
-                }},
-                {"required", json::array({"database_name", "statement_id"})}
-            };
-            tools.push_back(cancelStatementTool);
-
-            // recalculate_index_stats tool
-            json recalculateIndexStatsTool;
-            recalculateIndexStatsTool["name"] = "recalculate_index_stats";
-            recalculateIndexStatsTool["description"] = "Recalculate index selectivities (SET STATISTICS INDEX) for all user indices or a specific index.";
-            recalculateIndexStatsTool["inputSchema"] = {
-                {"type", "object"},
-                {"properties", {
-                    {"database_name", {
-                        {"type", "string"},
-                        {"description", "The name of the database as registered in FlameRobin."}
-                    }},
-                    {"index_name", {
-                        {"type", "string"},
-                        {"description", "Optional name of a specific index. If omitted, recalculates all user indices."}
-                    }},
-                    {"password", {
-                        {"type", "string"},
-                        {"description", "Optional connection password if not saved."}
-                    }}
-                }},
-                {"required", json::array({"database_name"})}
-            };
-            tools.push_back(recalculateIndexStatsTool);
-
-            // get_memory_diagnostics tool
-            json getMemoryDiagTool;
-            getMemoryDiagTool["name"] = "get_memory_diagnostics";
-            getMemoryDiagTool["description"] = "Retrieve Firebird memory pool allocations (MON$POOLS), memory usage stats (MON$MEMORY_USAGE), and connection pool metrics.";
-            getMemoryDiagTool["inputSchema"] = {
-                {"type", "object"},
-                {"properties", {
-                    {"database_name", {
-                        {"type", "string"},
-                        {"description", "The name of the database as registered in FlameRobin."}
-                    }},
-                    {"password", {
-                        {"type", "string"},
-                        {"description", "Optional connection password if not saved."}
-                    }}
-                }},
-                {"required", json::array({"database_name"})}
-            };
-            tools.push_back(getMemoryDiagTool);
-
             response["result"] = {
-                {"tools", tools}
+                {"tools", getToolList()}
             };
-            std::cout << response.dump() << std::endl;
+            dispatcher.write(response);
         }
         else if (method == "tools/call")
         {
-            std::string toolName = request["params"].value("name", "");
-            json args = request["params"].value("arguments", json::object());
-
-            json response;
-            response["jsonrpc"] = "2.0";
-            response["id"] = id;
-
-            try
-            {
-                json toolResult;
-
-                if (toolName == "list_databases")
-                {
-                    std::shared_ptr<Root> root(new Root());
-                    root->load();
-                    json dbs = json::array();
-                    for (const auto& server : root->getServers())
-                    {
-                        for (const auto& db : server->getDatabases())
-                        {
-                            json item;
-                            item["name"] = wx2std(db->getName_());
-                            item["server"] = wx2std(server->getName_());
-                            item["connection_string"] = wx2std(db->getConnectionString());
-                            item["username"] = wx2std(db->getUsername());
-                            item["role"] = wx2std(db->getRole());
-                            item["charset"] = wx2std(db->getConnectionCharset());
-                            item["dialect"] = db->getSqlDialect();
-                            dbs.push_back(item);
-                        }
-                    }
-                    toolResult["databases"] = dbs;
-                }
-                else if (toolName == "get_schema")
-                {
-                    std::string dbName = args.value("database_name", "");
-                    std::string password = args.value("password", "");
-
-                    std::shared_ptr<Root> root(new Root());
-                    root->load();
-                    DatabasePtr targetDb;
-                    for (const auto& server : root->getServers())
-                    {
-                        for (const auto& db : server->getDatabases())
-                        {
-                            if (wx2std(db->getName_()) == dbName)
-                            {
-                                targetDb = db;
-                                break;
-                            }
-                        }
-                        if (targetDb) break;
-                    }
-
-                    if (!targetDb)
-                    {
-                        throw std::runtime_error("Database '" + dbName + "' not found in FlameRobin configuration.");
-                    }
-
-                    wxString pwd = targetDb->getDecryptedPassword();
-                    if (!password.empty())
-                        pwd = wxString::FromUTF8(password.c_str());
-
-                    targetDb->connect(pwd, nullptr);
-
-                    json schema;
-                    schema["database"] = dbName;
-
-                    // Tables
-                    auto tables = targetDb->getTables();
-                    tables->ensureChildrenLoaded();
-                    json tableList = json::array();
-                    std::vector<MetadataItem*> tableItems;
-                    tables->getChildren(tableItems);
-                    for (auto* item : tableItems)
-                    {
-                        auto* table = dynamic_cast<Table*>(item);
-                        if (!table) continue;
-
-                        json tbl;
-                        tbl["name"] = wx2std(table->getName_());
-                        tbl["type"] = "table";
-
-                        table->ensureChildrenLoaded();
-                        std::vector<MetadataItem*> colItems;
-                        table->getChildren(colItems);
-
-                        json colList = json::array();
-                        for (auto* colItem : colItems)
-                        {
-                            auto* col = dynamic_cast<Column*>(colItem);
-                            if (!col) continue;
-
-                            json c;
-                            c["name"] = wx2std(col->getName_());
-                            c["type"] = wx2std(col->getDatatype());
-                            c["nullable"] = col->isNullable(CheckDomainNullability);
-                            c["is_primary_key"] = col->isPrimaryKey();
-                            c["is_foreign_key"] = col->isForeignKey();
-                            colList.push_back(c);
-                        }
-                        tbl["columns"] = colList;
-                        tableList.push_back(tbl);
-                    }
-                    schema["tables"] = tableList;
-
-                    // Views
-                    auto views = targetDb->getViews();
-                    views->ensureChildrenLoaded();
-                    json viewList = json::array();
-                    std::vector<MetadataItem*> viewItems;
-                    views->getChildren(viewItems);
-                    for (auto* item : viewItems)
-                    {
-                        auto* view = dynamic_cast<View*>(item);
-                        if (!view) continue;
-
-                        json v;
-                        v["name"] = wx2std(view->getName_());
-                        v["type"] = "view";
-
-                        view->ensureChildrenLoaded();
-                        std::vector<MetadataItem*> colItems;
-                        view->getChildren(colItems);
-
-                        json colList = json::array();
-                        for (auto* colItem : colItems)
-                        {
-                            auto* col = dynamic_cast<Column*>(colItem);
-                            if (!col) continue;
-
-                            json c;
-                            c["name"] = wx2std(col->getName_());
-                            c["type"] = wx2std(col->getDatatype());
-                            c["nullable"] = col->isNullable(CheckDomainNullability);
-                            colList.push_back(c);
-                        }
-                        v["columns"] = colList;
-                        viewList.push_back(v);
-                    }
-                    schema["views"] = viewList;
-
-                    toolResult = schema;
-                }
-                else if (toolName == "execute_query")
-                {
-                    std::string dbName = args.value("database_name", "");
-                    std::string sql = args.value("sql", "");
-                    std::string password = args.value("password", "");
-
-                    std::shared_ptr<Root> root(new Root());
-                    root->load();
-                    DatabasePtr targetDb;
-                    for (const auto& server : root->getServers())
-                    {
-                        for (const auto& db : server->getDatabases())
-                        {
-                            if (wx2std(db->getName_()) == dbName)
-                            {
-                                targetDb = db;
-                                break;
-                            }
-                        }
-                        if (targetDb) break;
-                    }
-
-                    if (!targetDb)
-                    {
-                        throw std::runtime_error("Database '" + dbName + "' not found in FlameRobin configuration.");
-                    }
-
-                    wxString pwd = targetDb->getDecryptedPassword();
-                    if (!password.empty())
-                        pwd = wxString::FromUTF8(password.c_str());
-
-                    targetDb->connect(pwd, nullptr);
-
-                    auto dalDb = targetDb->getDALDatabase();
-                    auto tr = dalDb->createTransaction();
-                    tr->start();
-
-                    auto st = dalDb->createStatement(tr);
-                    st->prepare(sql);
-                    st->execute();
-
-                    json rows = json::array();
-                    int colCount = st->getColumnCount();
-                    if (colCount > 0)
-                    {
-                        while (st->fetch())
-                        {
-                            json row;
-                            for (int i = 0; i < colCount; ++i)
-                            {
-                                std::string colName = st->getColumnName(i);
-                                if (st->isNull(i))
-                                {
-                                    row[colName] = nullptr;
-                                }
-                                else
-                                {
-                                    fr::ColumnType colType = st->getColumnType(i);
-                                    switch (colType)
-                                    {
-                                        case fr::ColumnType::Integer:
-                                            row[colName] = st->getInt32(i);
-                                            break;
-                                        case fr::ColumnType::BigInt:
-                                            row[colName] = st->getInt64(i);
-                                            break;
-                                        case fr::ColumnType::Float:
-                                        case fr::ColumnType::Double:
-                                            row[colName] = st->getDouble(i);
-                                            break;
-                                        case fr::ColumnType::Boolean:
-                                            row[colName] = st->getBool(i);
-                                            break;
-                                        default:
-                                            row[colName] = st->getString(i);
-                                            break;
-                                    }
-                                }
-                            }
-                            rows.push_back(row);
-                        }
-                    }
-
-                    tr->commit();
-
-                    toolResult["rows"] = rows;
-                    toolResult["column_count"] = colCount;
-                    toolResult["affected_rows"] = st->getAffectedRows();
-                }
-                else if (toolName == "get_metadata_ddl")
-                {
-                    std::string dbName = args.value("database_name", "");
-                    std::string objName = args.value("object_name", "");
-                    std::string password = args.value("password", "");
-
-                    std::shared_ptr<Root> root(new Root());
-                    root->load();
-                    DatabasePtr targetDb;
-                    for (const auto& server : root->getServers())
-                    {
-                        for (const auto& db : server->getDatabases())
-                        {
-                            if (wx2std(db->getName_()) == dbName)
-                            {
-                                targetDb = db;
-                                break;
-                            }
-                        }
-                        if (targetDb) break;
-                    }
-
-                    if (!targetDb)
-                    {
-                        throw std::runtime_error("Database '" + dbName + "' not found in FlameRobin configuration.");
-                    }
-
-                    wxString pwd = targetDb->getDecryptedPassword();
-                    if (!password.empty())
-                        pwd = wxString::FromUTF8(password.c_str());
-
-                    targetDb->connect(pwd, nullptr);
-
-                    MetadataItem* obj = findMetadataObject(targetDb, objName);
-                    if (!obj)
-                    {
-                        throw std::runtime_error("Metadata object '" + objName + "' not found in database '" + dbName + "'.");
-                    }
-
-                    CreateDDLVisitor cdv;
-                    obj->acceptVisitor(&cdv);
-                    
-                    toolResult["object_name"] = objName;
-                    toolResult["ddl"] = wx2std(cdv.getSql());
-                }
-                else if (toolName == "get_database_info")
-                {
-                    std::string dbName = args.value("database_name", "");
-                    std::string password = args.value("password", "");
-
-                    std::shared_ptr<Root> root(new Root());
-                    root->load();
-                    DatabasePtr targetDb;
-                    for (const auto& server : root->getServers())
-                    {
-                        for (const auto& db : server->getDatabases())
-                        {
-                            if (wx2std(db->getName_()) == dbName)
-                            {
-                                targetDb = db;
-                                break;
-                            }
-                        }
-                        if (targetDb) break;
-                    }
-
-                    if (!targetDb)
-                    {
-                        throw std::runtime_error("Database '" + dbName + "' not found in FlameRobin configuration.");
-                    }
-
-                    wxString pwd = targetDb->getDecryptedPassword();
-                    if (!password.empty())
-                        pwd = wxString::FromUTF8(password.c_str());
-
-                    targetDb->connect(pwd, nullptr);
-
-                    auto dalDb = targetDb->getDALDatabase();
-                    fr::DatabaseInfoData info;
-                    dalDb->getInfo(&info);
-
-                    json dbInfo;
-                    dbInfo["ods_version"] = std::to_string(info.ods) + "." + std::to_string(info.odsMinor);
-                    dbInfo["page_size"] = info.pageSize;
-                    dbInfo["pages_allocated"] = info.pages;
-                    dbInfo["buffers"] = info.buffers;
-                    dbInfo["sweep_interval"] = info.sweep;
-                    dbInfo["forced_writes"] = info.forcedWrites;
-                    dbInfo["reserve_space"] = info.reserve;
-                    dbInfo["read_only"] = info.readOnly;
-                    dbInfo["oldest_transaction"] = info.oldestTransaction;
-                    dbInfo["oldest_active_transaction"] = info.oldestActiveTransaction;
-                    dbInfo["oldest_snapshot"] = info.oldestSnapshot;
-                    dbInfo["next_transaction"] = info.nextTransaction;
-                    dbInfo["crypt_state"] = wx2std(cryptStateToString(info.cryptState));
-
-                    json activeTxs = json::array();
-                    for (const auto& tx : info.activeTransactions)
-                    {
-                        json t;
-                        t["id"] = tx.id;
-                        t["isolation_level"] = wx2std(isolationLevelToString(tx.isolationLevel));
-                        t["read_only"] = tx.readOnly;
-                        t["wait"] = tx.wait;
-                        activeTxs.push_back(t);
-                    }
-                    dbInfo["active_transactions"] = activeTxs;
-
-                    toolResult = dbInfo;
-                }
-                else if (toolName == "explain_query")
-                {
-                    std::string dbName = args.value("database_name", "");
-                    std::string sqlStr = args.value("sql", "");
-                    std::string password = args.value("password", "");
-
-                    std::shared_ptr<Root> root(new Root());
-                    root->load();
-                    DatabasePtr targetDb;
-                    for (const auto& server : root->getServers())
-                    {
-                        for (const auto& db : server->getDatabases())
-                        {
-                            if (wx2std(db->getName_()) == dbName)
-                            {
-                                targetDb = db;
-                                break;
-                            }
-                        }
-                        if (targetDb) break;
-                    }
-
-                    if (!targetDb)
-                        throw std::runtime_error("Database '" + dbName + "' not found in FlameRobin configuration.");
-
-                    wxString pwd = targetDb->getDecryptedPassword();
-                    if (!password.empty())
-                        pwd = wxString::FromUTF8(password.c_str());
-
-                    targetDb->connect(pwd, nullptr);
-
-                    auto dalDb = targetDb->getDALDatabase();
-                    auto tr = dalDb->createTransaction();
-                    tr->start();
-                    auto st = dalDb->createStatement(tr);
-                    st->prepare(sqlStr);
-
-                    std::string plan = st->getPlan();
-                    tr->rollback();
-
-                    toolResult["plan"] = plan;
-                }
-                else if (toolName == "compare_schemas")
-                {
-                    std::string srcDbName = args.value("source_database_name", "");
-                    std::string tgtDbName = args.value("target_database_name", "");
-                    std::string srcPwdStr = args.value("source_password", "");
-                    std::string tgtPwdStr = args.value("target_password", "");
-                    bool genDrop = args.value("generate_drop_statements", false);
-
-                    std::shared_ptr<Root> root(new Root());
-                    root->load();
-
-                    DatabasePtr srcDb;
-                    DatabasePtr tgtDb;
-                    for (const auto& server : root->getServers())
-                    {
-                        for (const auto& db : server->getDatabases())
-                        {
-                            if (wx2std(db->getName_()) == srcDbName)
-                                srcDb = db;
-                            if (wx2std(db->getName_()) == tgtDbName)
-                                tgtDb = db;
-                        }
-                    }
-
-                    if (!srcDb)
-                        throw std::runtime_error("Source database '" + srcDbName + "' not found.");
-                    if (!tgtDb)
-                        throw std::runtime_error("Target database '" + tgtDbName + "' not found.");
-
-                    wxString srcPwd = srcDb->getDecryptedPassword();
-                    if (!srcPwdStr.empty()) srcPwd = wxString::FromUTF8(srcPwdStr.c_str());
-                    srcDb->connect(srcPwd, nullptr);
-
-                    wxString tgtPwd = tgtDb->getDecryptedPassword();
-                    if (!tgtPwdStr.empty()) tgtPwd = wxString::FromUTF8(tgtPwdStr.c_str());
-                    tgtDb->connect(tgtPwd, nullptr);
-
-                    SchemaDiffOptions opts;
-                    opts.generateDropStatements = genDrop;
-
-                    auto diffs = SchemaDiff::compareDatabases(srcDb.get(), tgtDb.get(), opts);
-                    std::string migrationScript = wx2std(SchemaDiff::generateMigrationScript(diffs, srcDb.get(), tgtDb.get()));
-
-                    json diffList = json::array();
-                    for (const auto& item : diffs)
-                    {
-                        json d;
-                        d["object_type"] = wx2std(item.objectType);
-                        d["object_name"] = wx2std(item.objectName);
-                        d["description"] = wx2std(item.description);
-                        d["migration_sql"] = wx2std(item.migrationSql);
-                        diffList.push_back(d);
-                    }
-
-                    toolResult["differences_count"] = diffs.size();
-                    toolResult["migration_sql"] = migrationScript;
-                    toolResult["differences"] = diffList;
-                }
-                else if (toolName == "get_performance_stats")
-                {
-                    std::string dbName = args.value("database_name", "");
-                    std::string password = args.value("password", "");
-
-                    std::shared_ptr<Root> root(new Root());
-                    root->load();
-                    DatabasePtr targetDb;
-                    for (const auto& server : root->getServers())
-                    {
-                        for (const auto& db : server->getDatabases())
-                        {
-                            if (wx2std(db->getName_()) == dbName)
-                            {
-                                targetDb = db;
-                                break;
-                            }
-                        }
-                        if (targetDb) break;
-                    }
-
-                    if (!targetDb)
-                        throw std::runtime_error("Database '" + dbName + "' not found in FlameRobin configuration.");
-
-                    wxString pwd = targetDb->getDecryptedPassword();
-                    if (!password.empty())
-                        pwd = wxString::FromUTF8(password.c_str());
-
-                    targetDb->connect(pwd, nullptr);
-
-                    auto dalDb = targetDb->getDALDatabase();
-                    json perf;
-
-                    try
-                    {
-                        auto tr = dalDb->createTransaction();
-                        tr->start();
-                        auto st = dalDb->createStatement(tr);
-                        std::string monSql = "SELECT (SELECT COUNT(*) FROM MON$ATTACHMENTS WHERE MON$ATTACHMENT_ID <> CURRENT_ATTACHMENT_ID) AS active_attachments, "
-                            "(SELECT COUNT(*) FROM MON$STATEMENTS WHERE MON$STATE = 1) AS active_statements, "
-                            "(SELECT COUNT(*) FROM MON$TRANSACTIONS WHERE MON$STATE = 1) AS active_transactions "
-                            "FROM RDB$DATABASE;";
-                        st->prepare(monSql);
-                        st->execute();
-
-                        if (st->fetch())
-                        {
-                            perf["active_attachments"] = st->getInt32(0);
-                            perf["active_statements"] = st->getInt32(1);
-                            perf["active_transactions"] = st->getInt32(2);
-                        }
-                        tr->commit();
-                    }
-                    catch (const std::exception&)
-                    {
-                        perf["active_attachments"] = 0;
-                        perf["active_statements"] = 0;
-                        perf["active_transactions"] = 0;
-                    }
-
-                    fr::DatabaseInfoData info;
-                    dalDb->getInfo(&info);
-                    perf["page_size"] = info.pageSize;
-                    perf["pages_allocated"] = info.pages;
-                    perf["buffers"] = info.buffers;
-                    perf["oldest_transaction"] = info.oldestTransaction;
-                    perf["oldest_active_transaction"] = info.oldestActiveTransaction;
-                    perf["next_transaction"] = info.nextTransaction;
-
-                    toolResult = perf;
-                }
-                else if (toolName == "list_active_sessions")
-                {
-                    std::string dbName = args.value("database_name", "");
-                    std::string password = args.value("password", "");
-
-                    std::shared_ptr<Root> root(new Root());
-                    root->load();
-                    DatabasePtr targetDb;
-                    for (const auto& server : root->getServers())
-                    {
-                        for (const auto& db : server->getDatabases())
-                        {
-                            if (wx2std(db->getName_()) == dbName)
-                            {
-                                targetDb = db;
-                                break;
-                            }
-                        }
-                        if (targetDb) break;
-                    }
-
-                    if (!targetDb)
-                        throw std::runtime_error("Database '" + dbName + "' not found in FlameRobin configuration.");
-
-                    wxString pwd = targetDb->getDecryptedPassword();
-                    if (!password.empty()) pwd = wxString::FromUTF8(password.c_str());
-                    targetDb->connect(pwd, nullptr);
-
-                    auto dalDb = targetDb->getDALDatabase();
-                    auto tr = dalDb->createTransaction();
-                    tr->start();
-
-                    json attList = json::array();
-                    try
-                    {
-                        auto st = dalDb->createStatement(tr);
-                        st->prepare("SELECT MON$ATTACHMENT_ID, MON$STATE, MON$USER, MON$ROLE, MON$REMOTE_ADDRESS, MON$REMOTE_PROCESS, MON$TIMESTAMP FROM MON$ATTACHMENTS ORDER BY MON$ATTACHMENT_ID;");
-                        st->execute();
-                        while (st->fetch())
-                        {
-                            json att;
-                            att["attachment_id"] = st->getInt64(0);
-                            att["state"] = st->isNull(1) ? 0 : st->getInt32(1);
-                            att["user"] = st->getString(2);
-                            att["role"] = st->getString(3);
-                            att["remote_address"] = st->getString(4);
-                            att["remote_process"] = st->getString(5);
-                            att["timestamp"] = st->getTimestamp(6);
-                            attList.push_back(att);
-                        }
-                    } catch (...) {}
-
-                    json stmtList = json::array();
-                    try
-                    {
-                        auto st = dalDb->createStatement(tr);
-                        st->prepare("SELECT MON$STATEMENT_ID, MON$ATTACHMENT_ID, MON$STATE, MON$SQL_TEXT, MON$TIMESTAMP FROM MON$STATEMENTS WHERE MON$SQL_TEXT IS NOT NULL ORDER BY MON$STATEMENT_ID;");
-                        st->execute();
-                        while (st->fetch())
-                        {
-                            json stmt;
-                            stmt["statement_id"] = st->getInt64(0);
-                            stmt["attachment_id"] = st->getInt64(1);
-                            stmt["state"] = st->isNull(2) ? 0 : st->getInt32(2);
-                            stmt["sql_text"] = st->getString(3);
-                            stmt["timestamp"] = st->getTimestamp(4);
-                            stmtList.push_back(stmt);
-                        }
-                    } catch (...) {}
-
-                    tr->commit();
-
-                    toolResult["active_attachments"] = attList;
-                    toolResult["active_statements"] = stmtList;
-                }
-                else if (toolName == "cancel_statement")
-                {
-                    std::string dbName = args.value("database_name", "");
-                    int64_t stmtId = args.value("statement_id", (int64_t)0);
-                    std::string password = args.value("password", "");
-
-                    std::shared_ptr<Root> root(new Root());
-                    root->load();
-                    DatabasePtr targetDb;
-                    for (const auto& server : root->getServers())
-                    {
-                        for (const auto& db : server->getDatabases())
-                        {
-                            if (wx2std(db->getName_()) == dbName)
-                            {
-                                targetDb = db;
-                                break;
-                            }
-                        }
-                        if (targetDb) break;
-                    }
-
-                    if (!targetDb)
-                        throw std::runtime_error("Database '" + dbName + "' not found in FlameRobin configuration.");
-
-                    wxString pwd = targetDb->getDecryptedPassword();
-                    if (!password.empty()) pwd = wxString::FromUTF8(password.c_str());
-                    targetDb->connect(pwd, nullptr);
-
-                    auto dalDb = targetDb->getDALDatabase();
-                    auto tr = dalDb->createTransaction();
-                    tr->start();
-                    auto st = dalDb->createStatement(tr);
-                    std::string cancelSql = "DELETE FROM MON$STATEMENTS WHERE MON$STATEMENT_ID = " + std::to_string(stmtId) + ";";
-                    st->prepare(cancelSql);
-                    st->execute();
-                    tr->commit();
-
-                    toolResult["success"] = true;
-                    toolResult["message"] = "Statement ID " + std::to_string(stmtId) + " cancel signal sent successfully.";
-                }
-                else if (toolName == "recalculate_index_stats")
-                {
-                    std::string dbName = args.value("database_name", "");
-                    std::string targetIdx = args.value("index_name", "");
-                    std::string password = args.value("password", "");
-
-                    std::shared_ptr<Root> root(new Root());
-                    root->load();
-                    DatabasePtr targetDb;
-                    for (const auto& server : root->getServers())
-                    {
-                        for (const auto& db : server->getDatabases())
-                        {
-                            if (wx2std(db->getName_()) == dbName)
-                            {
-                                targetDb = db;
-                                break;
-                            }
-                        }
-                        if (targetDb) break;
-                    }
-
-                    if (!targetDb)
-                        throw std::runtime_error("Database '" + dbName + "' not found in FlameRobin configuration.");
-
-                    wxString pwd = targetDb->getDecryptedPassword();
-                    if (!password.empty()) pwd = wxString::FromUTF8(password.c_str());
-                    targetDb->connect(pwd, nullptr);
-
-                    auto dalDb = targetDb->getDALDatabase();
-                    std::vector<std::string> indexNames;
-
-                    if (!targetIdx.empty())
-                    {
-                        indexNames.push_back(targetIdx);
-                    }
-                    else
-                    {
-                        auto tr = dalDb->createTransaction();
-                        tr->start();
-                        auto st = dalDb->createStatement(tr);
-                        st->prepare("SELECT RDB$INDEX_NAME FROM RDB$INDICES WHERE (RDB$SYSTEM_FLAG = 0 OR RDB$SYSTEM_FLAG IS NULL);");
-                        st->execute();
-                        while (st->fetch())
-                        {
-                            std::string idx = st->getString(0);
-                            size_t end = idx.find_last_not_of(" \t\r\n");
-                            if (end != std::string::npos) idx = idx.substr(0, end + 1);
-                            indexNames.push_back(idx);
-                        }
-                        tr->commit();
-                    }
-
-                    int count = 0;
-                    json idxList = json::array();
-                    for (const auto& idx : indexNames)
-                    {
-                        try
-                        {
-                            auto tr = dalDb->createTransaction();
-                            tr->start();
-                            auto st = dalDb->createStatement(tr);
-                            std::string sql = "SET STATISTICS INDEX \"" + idx + "\";";
-                            st->prepare(sql);
-                            st->execute();
-                            tr->commit();
-                            count++;
-                            idxList.push_back(idx);
-                        }
-                        catch (...) {}
-                    }
-
-                    toolResult["recalculated_count"] = count;
-                    toolResult["indices"] = idxList;
-                }
-                else if (toolName == "get_memory_diagnostics")
-                {
-                    std::string dbName = args.value("database_name", "");
-                    std::string password = args.value("password", "");
-
-                    std::shared_ptr<Root> root(new Root());
-                    root->load();
-                    DatabasePtr targetDb;
-                    for (const auto& server : root->getServers())
-                    {
-                        for (const auto& db : server->getDatabases())
-                        {
-                            if (wx2std(db->getName_()) == dbName)
-                            {
-                                targetDb = db;
-                                break;
-                            }
-                        }
-                        if (targetDb) break;
-                    }
-
-                    if (!targetDb)
-                        throw std::runtime_error("Database '" + dbName + "' not found in FlameRobin configuration.");
-
-                    wxString pwd = targetDb->getDecryptedPassword();
-                    if (!password.empty()) pwd = wxString::FromUTF8(password.c_str());
-                    targetDb->connect(pwd, nullptr);
-
-                    auto dalDb = targetDb->getDALDatabase();
-
-                    std::vector<fr::MemoryPoolInfo> pools;
-                    dalDb->getMemoryPoolInfo(pools);
-
-                    std::vector<fr::MemoryUsageInfo> memUsage;
-                    dalDb->getMemoryUsageInfo(memUsage);
-
-                    std::vector<fr::ConnectionPoolInfo> connPools;
-                    dalDb->getConnectionPoolInfo(connPools);
-
-                    json poolsJson = json::array();
-                    for (const auto& p : pools)
-                    {
-                        poolsJson.push_back({
-                            {"pool_id", p.poolId},
-                            {"attachment_id", p.attachmentId},
-                            {"memory_allocated_bytes", p.memoryAllocated},
-                            {"memory_used_bytes", p.memoryUsed},
-                            {"name", p.name}
-                        });
-                    }
-
-                    json memJson = json::array();
-                    for (const auto& m : memUsage)
-                    {
-                        memJson.push_back({
-                            {"memory_id", m.memoryId},
-                            {"stat_group", m.statGroup},
-                            {"memory_allocated_bytes", m.memoryAllocated},
-                            {"memory_used_bytes", m.memoryUsed},
-                            {"max_allocated_bytes", m.maxAllocated},
-                            {"max_used_bytes", m.maxUsed}
-                        });
-                    }
-
-                    json connPoolsJson = json::array();
-                    for (const auto& cp : connPools)
-                    {
-                        connPoolsJson.push_back({
-                            {"pool_id", cp.poolId},
-                            {"database_name", cp.dbName},
-                            {"active_connections", cp.activeConnections},
-                            {"idle_connections", cp.idleConnections},
-                            {"max_connections", cp.maxConnections},
-                            {"min_connections", cp.minConnections},
-                            {"waiting_requests", cp.waitingRequests}
-                        });
-                    }
-
-                    toolResult["memory_pools"] = poolsJson;
-                    toolResult["memory_usage"] = memJson;
-                    toolResult["connection_pools"] = connPoolsJson;
-                }
-                else
-                {
-                    throw std::runtime_error("Unknown tool: " + toolName);
-                }
-
-                // Send tool execution success response
-                json contentItem;
-                contentItem["type"] = "text";
-                contentItem["text"] = toolResult.dump(2);
-
-                response["result"] = {
-                    {"content", json::array({contentItem})},
-                    {"isError", false}
-                };
-                std::cout << response.dump() << std::endl;
-            }
-            catch (const std::exception& e)
-            {
-                // Send tool execution error response
-                json contentItem;
-                contentItem["type"] = "text";
-                contentItem["text"] = std::string("Error during execution: ") + e.what();
-
-                response["result"] = {
-                    {"content", json::array({contentItem})},
-                    {"isError", true}
-                };
-                std::cout << response.dump() << std::endl;
-            }
+            dispatcher.dispatch(request);
         }
         else
         {
@@ -1304,7 +1403,7 @@ void McpServer::run()
                 {"code", -32601},
                 {"message", "Method not found: " + method}
             };
-            std::cout << errResponse.dump() << std::endl;
+            dispatcher.write(errResponse);
         }
     }
 }
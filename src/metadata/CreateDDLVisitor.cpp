@@ -40,6 +40,7 @@
 #include "metadata/constraints.h"
 #include "metadata/CreateDDLVisitor.h"
 #include "metadata/database.h"
+#include "metadata/DDLScriptWriter.h"
 #include "metadata/domain.h"
 #include "metadata/exception.h"
 #include "metadata/function.h"
@@ -102,12 +103,21 @@ wxString CreateDDLVisitor::getCommentOn(MetadataItem& object)
     return comment;
 }
 
-CreateDDLVisitor::CreateDDLVisitor(ProgressIndicator* progressIndicator)
-    : MetadataItemVisitor()
+CreateDDLVisitor::CreateDDLVisitor(ProgressIndicator* progressIndicator,
+        DDLScriptWriter* scriptWriter)
+    : MetadataItemVisitor(), scriptWriterM(scriptWriter)
 {
     progressIndicatorM = progressIndicator;
 }
 
+void CreateDDLVisitor::addToScript(MetadataItem& item,
+    DDLScriptWriter& scriptWriter)
+{
+    CreateDDLVisitor v;
+    item.acceptVisitor(&v);
+    scriptWriter.add(v.preSqlM, v.postSqlM, v.grantSqlM);
+}
+
 CreateDDLVisitor::~CreateDDLVisitor()
 {
 }
@@ -188,8 +198,11 @@ void CreateDDLVisitor::visitColumn(Column& c)
     postSqlM << getCommentOn(c);
 }
 
+// every object gets a visitor of its own, so the script of the database
+// isn't copied for each object
 template <class C, class M>
-void iterateit(CreateDDLVisitor* v, C mc, ProgressIndicator* pi)
+void iterateit(DDLScriptWriter& writer, C mc, const std::vector<M*>& items,
+    ProgressIndicator* pi)
 {
     wxASSERT(mc);
 
@@ -197,10 +210,10 @@ void iterateit(CreateDDLVisitor* v, C mc, ProgressIndicator* pi)
     {
         pi->setProgressMessage(_("Extracting ") + mc->getName_());
         pi->stepProgress();
-        pi->initProgress(wxEmptyString, mc->getChildrenCount(), 0, 2);
+        pi->initProgress(wxEmptyString, items.size(), 0, 2);
     }
 
-    for (const auto& item : *mc)
+    for (M* item : items)
     {
         if (pi)
         {
@@ -208,82 +221,100 @@ void iterateit(CreateDDLVisitor* v, C mc, ProgressIndicator* pi)
             pi->setProgressMessage(_("Extracting ") + item->getName_(), 2);
             pi->stepProgress(1, 2);
         }
-        item->acceptVisitor(v);
+        CreateDDLVisitor::addToScript(*item, writer);
     }
 }
 
+template <class C, class M>
+void iterateit(DDLScriptWriter& writer, C mc, ProgressIndicator* pi)
+{
+    wxASSERT(mc);
+    std::vector<M*> items;
+    for (const auto& item : *mc)
+        items.push_back(item.get());
+    iterateit<C, M>(writer, mc, items, pi);
+}
+
 // build the sql script for entire database
 void CreateDDLVisitor::visitDatabase(Database& d)
 {
+    // one round-trip for each kind of detail instead of several per table
+    d.loadRelationDetails(progressIndicatorM);
+    d.loadDescriptions(progressIndicatorM);
     if (progressIndicatorM)
         progressIndicatorM->initProgress(wxEmptyString, 10, 0, 1);
 
+    DDLScriptWriter memoryWriter;
+    DDLScriptWriter& writer = scriptWriterM ? *scriptWriterM : memoryWriter;
+
     try
     {
 
-        preSqlM << "/********************* COLLATES **********************/\n\n";
-        iterateit<CollationsPtr, Collation>(this, d.getCollations(), progressIndicatorM);
+        writer.add("/********************* COLLATES **********************/\n\n");
+        iterateit<CollationsPtr, Collation>(writer, d.getCollations(), progressIndicatorM);
 
-        preSqlM << "/************* CHARACTER SET DEFAULT COLLATIONS *******/\n\n";
-        iterateit<CharacterSetsPtr, CharacterSet>(this, d.getCharacterSets(), progressIndicatorM);
+        writer.add("/************* CHARACTER SET DEFAULT COLLATIONS *******/\n\n");
+        iterateit<CharacterSetsPtr, CharacterSet>(writer, d.getCharacterSets(), progressIndicatorM);
 
-        preSqlM << "/********************* ROLES **********************/\n\n";
-        iterateit<RolesPtr, Role>(this, d.getRoles(), progressIndicatorM);
+        writer.add("/********************* ROLES **********************/\n\n");
+        iterateit<RolesPtr, Role>(writer, d.getRoles(), progressIndicatorM);
 
-        preSqlM << "/********************* UDFS ***********************/\n\n";
-        iterateit<UDFsPtr, UDF>(this, d.getUDFs(), progressIndicatorM);
+        writer.add("/********************* UDFS ***********************/\n\n");
+        iterateit<UDFsPtr, UDF>(writer, d.getUDFs(), progressIndicatorM);
         
         if (d.getInfo().getODSVersionIsHigherOrEqualTo(12, 0)) {
-            preSqlM << "/********************* FUNCTIONS ***********************/\n\n";
-            iterateit<FunctionSQLsPtr, FunctionSQL>(this, d.getFunctionSQLs(),
+            writer.add("/********************* FUNCTIONS ***********************/\n\n");
+            iterateit<FunctionSQLsPtr, FunctionSQL>(writer, d.getFunctionSQLs(),
                 progressIndicatorM);
         }
 
-        preSqlM << "/****************** SEQUENCES ********************/\n\n";
-        iterateit<GeneratorsPtr, Generator>(this, d.getGenerators(),
+        writer.add("/****************** SEQUENCES ********************/\n\n");
+        iterateit<GeneratorsPtr, Generator>(writer, d.getGenerators(),
             progressIndicatorM);
 
-        preSqlM << "/******************** DOMAINS *********************/\n\n";
-        iterateit<DomainsPtr, Domain>(this, d.getDomains(),
+        writer.add("/******************** DOMAINS *********************/\n\n");
+        iterateit<DomainsPtr, Domain>(writer, d.getDomains(),
             progressIndicatorM);
 
-        preSqlM << "/******************* PROCEDURES ******************/\n\n";
-        iterateit<ProceduresPtr, Procedure>(this, d.getProcedures(),
+        writer.add("/******************* PROCEDURES ******************/\n\n");
+        iterateit<ProceduresPtr, Procedure>(writer, d.getProcedures(),
             progressIndicatorM);
 
         if (d.getInfo().getODSVersionIsHigherOrEqualTo(12, 0)) {
-            preSqlM << "/******************* PACKAGES ******************/\n\n";
-            iterateit<PackagesPtr, Package>(this, d.getPackages(),
+            writer.add("/******************* PACKAGES ******************/\n\n");
+            iterateit<PackagesPtr, Package>(writer, d.getPackages(),
                 progressIndicatorM);
         }
       
-        preSqlM << "/******************** TABLES **********************/\n\n";
-        iterateit<TablesPtr, Table>(this, d.getTables(), progressIndicatorM);
+        writer.add("/******************** TABLES **********************/\n\n");
+        iterateit<TablesPtr, Table>(writer, d.getTables(), progressIndicatorM);
         if (d.getInfo().getODSVersionIsHigherOrEqualTo(11, 1)) {
-            iterateit<GTTablesPtr, GTTable>(this, d.getGTTables(), progressIndicatorM);
+            iterateit<GTTablesPtr, GTTable>(writer, d.getGTTables(), progressIndicatorM);
         }
 
-        preSqlM << "/********************* VIEWS **********************/\n\n";
-        // TODO: build dependecy tree first, and order views by it
-        //       also include computed columns of tables?
-        iterateit<ViewsPtr, View>(this, d.getViews(), progressIndicatorM);
+        writer.add("/********************* VIEWS **********************/\n\n");
+        // TODO: also include computed columns of tables?
+        std::vector<View*> views;
+        d.getViewsInDependencyOrder(views);
+        iterateit<ViewsPtr, View>(writer, d.getViews(), views,
+            progressIndicatorM);
 
-        preSqlM << "/******************* EXCEPTIONS *******************/\n\n";
-        iterateit<ExceptionsPtr, Exception>(this, d.getExceptions(),
+        writer.add("/******************* EXCEPTIONS *******************/\n\n");
+        iterateit<ExceptionsPtr, Exception>(writer, d.getExceptions(),
             progressIndicatorM);
 
-        preSqlM << "/******************** TRIGGERS ********************/\n\n";
-        iterateit<DMLTriggersPtr, DMLTrigger>(this, d.getDMLTriggers(),
+        writer.add("/******************** TRIGGERS ********************/\n\n");
+        iterateit<DMLTriggersPtr, DMLTrigger>(writer, d.getDMLTriggers(),
             progressIndicatorM);
 
         if (d.getInfo().getODSVersionIsHigherOrEqualTo(11, 1)) {
-            preSqlM << "/******************** DB TRIGGERS ********************/\n\n";
-            iterateit<DBTriggersPtr, DBTrigger>(this, d.getDBTriggers(),
+            writer.add("/******************** DB TRIGGERS ********************/\n\n");
+            iterateit<DBTriggersPtr, DBTrigger>(writer, d.getDBTriggers(),
                 progressIndicatorM);
         }
         if (d.getInfo().getODSVersionIsHigherOrEqualTo(12, 0)) {
-            preSqlM << "/******************** DDL TRIGGERS ********************/\n\n";
-            iterateit<DDLTriggersPtr, DDLTrigger>(this, d.getDDLTriggers(),
+            writer.add("/******************** DDL TRIGGERS ********************/\n\n");
+            iterateit<DDLTriggersPtr, DDLTrigger>(writer, d.getDDLTriggers(),
                 progressIndicatorM);
         }
     }
@@ -294,7 +325,13 @@ void CreateDDLVisitor::visitDatabase(Database& d)
         return;
     }
 
-    sqlM = preSqlM + "\n" + postSqlM + grantSqlM;
+    if (!scriptWriterM)
+    {
+        preSqlM = memoryWriter.getPrefixSql();
+        postSqlM = memoryWriter.getSuffixSql();
+        grantSqlM = memoryWriter.getGrantSql();
+        sqlM = preSqlM + "\n" + postSqlM + grantSqlM;
+    }
     if (progressIndicatorM)
     {
         progressIndicatorM->initProgress(_("Extraction complete."), 1, 1);
@@ -28,6 +28,7 @@
 #include "sql/SqlTokenizer.h"
 #include "metadata/MetadataItemVisitor.h"
 
+class DDLScriptWriter;
 class ProgressIndicator;
 
 class CreateDDLVisitor: public MetadataItemVisitor
@@ -40,13 +41,18 @@ private:
     wxString grantSqlM; // grant statements at the very end (for easy diff)
 
     ProgressIndicator* progressIndicatorM;
+    // receives the script of an entire database instead of sqlM
+    DDLScriptWriter* scriptWriterM;
 
 protected:
     wxString getCommentOn(MetadataItem& metadataitem);
 
 public:
-    CreateDDLVisitor(ProgressIndicator* progressIndicator = 0);
+    CreateDDLVisitor(ProgressIndicator* progressIndicator = 0,
+        DDLScriptWriter* scriptWriter = 0);
     virtual ~CreateDDLVisitor();
+    // adds the DDL of one object to the script of its database
+    static void addToScript(MetadataItem& item, DDLScriptWriter& scriptWriter);
     wxString getSql() const;
     wxString getPrefixSql() const;
     wxString getSuffixSql() const;
@@ -0,0 +1,180 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include "metadata/DDLScriptWriter.h"
+
+namespace
+{
+
+wxString join(const std::vector<wxString>& parts)
+{
+    size_t length = 0;
+    for (const auto& part : parts)
+        length += part.length();
+    wxString result;
+    result.reserve(length);
+    for (const auto& part : parts)
+        result += part;
+    return result;
+}
+
+void appendUTF8(std::string& target, const wxString& text)
+{
+    if (!text.empty())
+        target.append(text.utf8_str());
+}
+
+} // namespace
+
+DDLScriptWriter::DDLScriptWriter()
+    : fileM(0), finishingM(false), failedM(false)
+{
+}
+
+DDLScriptWriter::DDLScriptWriter(wxFile* file)
+    : fileM(file), finishingM(false), failedM(false)
+{
+    threadM = std::thread(&DDLScriptWriter::run, this);
+}
+
+DDLScriptWriter::~DDLScriptWriter()
+{
+    // the extraction was cancelled if the script wasn't finished, what is
+    // still queued isn't written
+    {
+        std::lock_guard<std::mutex> lock(mutexM);
+        queueM.clear();
+    }
+    stop();
+}
+
+void DDLScriptWriter::stop()
+{
+    if (!threadM.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutexM);
+        finishingM = true;
+    }
+    queuedM.notify_one();
+    threadM.join();
+}
+
+bool DDLScriptWriter::write(const std::string& text)
+{
+    return text.empty()
+        || fileM->Write(text.data(), text.size()) == text.size();
+}
+
+// writes everything that was queued with one write, so a burst of small
+// objects doesn't cost a write each
+void DDLScriptWriter::run()
+{
+    std::deque<Part> parts;
+    std::string text;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutexM);
+            queuedM.wait(lock, [this]() { return finishingM || !queueM.empty(); });
+            if (queueM.empty())
+                return;
+            parts.swap(queueM);
+        }
+        writtenM.notify_one();
+
+        text.clear();
+        for (const auto& part : parts)
+        {
+            appendUTF8(text, part.prefixSql);
+            appendUTF8(suffixUtf8M, part.suffixSql);
+            appendUTF8(grantUtf8M, part.grantSql);
+        }
+        parts.clear();
+        if (!failedM && !write(text))
+            failedM = true;
+    }
+}
+
+void DDLScriptWriter::add(const wxString& prefixSql, const wxString& suffixSql,
+    const wxString& grantSql)
+{
+    if (!fileM)
+    {
+        if (!prefixSql.empty())
+            prefixM.push_back(prefixSql);
+        if (!suffixSql.empty())
+            suffixM.push_back(suffixSql);
+        if (!grantSql.empty())
+            grantM.push_back(grantSql);
+        return;
+    }
+
+    Part part;
+    part.prefixSql = prefixSql;
+    part.suffixSql = suffixSql;
+    part.grantSql = grantSql;
+    {
+        std::unique_lock<std::mutex> lock(mutexM);
+        writtenM.wait(lock, [this]() { return queueM.size() < maxQueued; });
+        queueM.push_back(std::move(part));
+    }
+    queuedM.notify_one();
+}
+
+bool DDLScriptWriter::finish()
+{
+    if (!fileM)
+        return true;
+    stop();
+    // the writing thread has ended, so its members can be used here
+    if (!failedM)
+        failedM = !write("\n") || !write(suffixUtf8M) || !write(grantUtf8M);
+    suffixUtf8M.clear();
+    grantUtf8M.clear();
+    return !failedM;
+}
+
+wxString DDLScriptWriter::getPrefixSql() const
+{
+    return join(prefixM);
+}
+
+wxString DDLScriptWriter::getSuffixSql() const
+{
+    return join(suffixM);
+}
+
+wxString DDLScriptWriter::getGrantSql() const
+{
+    return join(grantM);
+}
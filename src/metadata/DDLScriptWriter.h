@@ -0,0 +1,96 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_DDLSCRIPTWRITER_H
+#define FR_DDLSCRIPTWRITER_H
+
+#include <wx/file.h>
+#include <wx/string.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// DDLScriptWriter class
+// Assembles the script that creates an entire database from the DDL of its
+// objects, added one object at a time: first the statements that create
+// the objects, in the order they were added, then the statements that
+// complete them (computed columns, constraints, routine bodies, comments)
+// and finally the grants.
+// Without a file the parts are kept in memory and joined once at the end.
+// With a file the text is converted to UTF-8 and written by a thread of
+// its own while the next objects are extracted; add() only waits if that
+// thread has fallen more than maxQueued objects behind.
+class DDLScriptWriter
+{
+public:
+    enum { maxQueued = 256 };
+private:
+    struct Part
+    {
+        wxString prefixSql;
+        wxString suffixSql;
+        wxString grantSql;
+    };
+
+    // script kept in memory
+    std::vector<wxString> prefixM;
+    std::vector<wxString> suffixM;
+    std::vector<wxString> grantM;
+
+    // script written to a file
+    wxFile* fileM;
+    std::string suffixUtf8M;
+    std::string grantUtf8M;
+    std::deque<Part> queueM;
+    std::mutex mutexM;
+    std::condition_variable queuedM;
+    std::condition_variable writtenM;
+    bool finishingM;
+    bool failedM;
+    std::thread threadM;
+
+    void run();
+    bool write(const std::string& text);
+    void stop();
+public:
+    DDLScriptWriter();
+    explicit DDLScriptWriter(wxFile* file);
+    ~DDLScriptWriter();
+
+    void add(const wxString& prefixSql, const wxString& suffixSql = wxEmptyString,
+        const wxString& grantSql = wxEmptyString);
+    // waits until all objects have been written and appends the statements
+    // that complete them and the grants, returns false if writing failed
+    bool finish();
+
+    // the parts of the script kept in memory
+    wxString getPrefixSql() const;
+    wxString getSuffixSql() const;
+    wxString getGrantSql() const;
+};
+
+#endif // FR_DDLSCRIPTWRITER_H
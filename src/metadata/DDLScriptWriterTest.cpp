@@ -0,0 +1,193 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include "metadata/DDLScriptWriter.h"
+
+namespace
+{
+
+bool check(bool condition, const char* testName)
+{
+    if (condition)
+    {
+        std::cout << "  PASSED: " << testName << "\n";
+        return true;
+    }
+    std::cout << "  FAILED: " << testName << "\n";
+    return false;
+}
+
+const char* const tempFileName = "ddl_script_writer_test.sql";
+
+std::string readFile()
+{
+    std::ifstream file(tempFileName, std::ios::binary);
+    std::stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+// the DDL of a table with its constraints, comments and grants
+void getTable(int i, wxString& prefixSql, wxString& suffixSql,
+    wxString& grantSql)
+{
+    wxString name(wxString::Format("TABLE_%d", i));
+    prefixSql = "CREATE TABLE " + name + "\n(\n  ID INTEGER NOT NULL,\n"
+        "  NAME VARCHAR(100),\n  CREATED TIMESTAMP DEFAULT CURRENT_TIMESTAMP"
+        "\n);\n";
+    suffixSql = "ALTER TABLE " + name + " ADD CONSTRAINT PK_" + name
+        + "\n  PRIMARY KEY (ID);\nCOMMENT ON TABLE " + name + " IS 'Table "
+        + name + "';\n";
+    grantSql = "GRANT SELECT ON " + name + " TO PUBLIC;\n";
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = true;
+    std::cout << "Running DDLScriptWriter Tests...\n";
+
+    // Test 1: the parts of a script kept in memory
+    {
+        DDLScriptWriter writer;
+        writer.add("/* TABLES */\n\n");
+        writer.add("CREATE TABLE A (X INTEGER);\n", "COMMENT ON TABLE A IS 'a';\n",
+            "GRANT SELECT ON A TO PUBLIC;\n");
+        writer.add("CREATE TABLE B (X INTEGER);\n", wxEmptyString,
+            "GRANT SELECT ON B TO PUBLIC;\n");
+        ok = check(writer.finish(), "Finished") && ok;
+        ok = check(writer.getPrefixSql() == "/* TABLES */\n\n"
+            "CREATE TABLE A (X INTEGER);\nCREATE TABLE B (X INTEGER);\n",
+            "Objects in order") && ok;
+        ok = check(writer.getSuffixSql() == "COMMENT ON TABLE A IS 'a';\n"
+            && writer.getGrantSql() == "GRANT SELECT ON A TO PUBLIC;\n"
+            "GRANT SELECT ON B TO PUBLIC;\n", "Suffix and grants") && ok;
+    }
+
+    // Test 2: a script written to a file while it is extracted
+    {
+        const int objectCount = 3 * DDLScriptWriter::maxQueued + 17;
+        DDLScriptWriter memory;
+        {
+            wxFile file;
+            file.Create(tempFileName, true);
+            DDLScriptWriter writer(&file);
+            wxString prefixSql, suffixSql, grantSql;
+            for (int i = 0; i < objectCount; ++i)
+            {
+                getTable(i, prefixSql, suffixSql, grantSql);
+                writer.add(prefixSql, suffixSql, grantSql);
+                memory.add(prefixSql, suffixSql, grantSql);
+            }
+            writer.add(wxString::FromUTF8("COMMENT ON DOMAIN D IS 'Gr\xc3\xb6\xc3\x9f"
+                "e \xe2\x82\xac';\n"));
+            ok = check(writer.finish(), "File written") && ok;
+        }
+        wxString expected(memory.getPrefixSql() + wxString::FromUTF8(
+            "COMMENT ON DOMAIN D IS 'Gr\xc3\xb6\xc3\x9f" "e \xe2\x82\xac';\n")
+            + "\n" + memory.getSuffixSql() + memory.getGrantSql());
+        ok = check(readFile() == std::string(expected.utf8_str()),
+            "File has the script in UTF-8") && ok;
+    }
+
+    // Test 3: a cancelled script doesn't wait for the rest to be written
+    {
+        {
+            wxFile file;
+            file.Create(tempFileName, true);
+            DDLScriptWriter writer(&file);
+            wxString prefixSql, suffixSql, grantSql;
+            for (int i = 0; i < 1000; ++i)
+            {
+                getTable(i, prefixSql, suffixSql, grantSql);
+                writer.add(prefixSql, suffixSql, grantSql);
+            }
+        }
+        std::string text(readFile());
+        ok = check(text.find("GRANT") == std::string::npos,
+            "Cancelled script has no grants") && ok;
+        std::remove(tempFileName);
+    }
+
+    // Test 4: 1000 objects, the script copied for every object as before
+    {
+        const int objectCount = 1000;
+        wxString prefixSql, suffixSql, grantSql;
+
+        auto start = std::chrono::steady_clock::now();
+        wxString preSql, postSql, grantsSql, sql;
+        for (int i = 0; i < objectCount; ++i)
+        {
+            getTable(i, prefixSql, suffixSql, grantSql);
+            preSql += prefixSql;
+            postSql += suffixSql;
+            grantsSql += grantSql;
+            sql = preSql + "\n" + postSql + grantsSql;
+        }
+        double copyMs = elapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        DDLScriptWriter writer;
+        for (int i = 0; i < objectCount; ++i)
+        {
+            getTable(i, prefixSql, suffixSql, grantSql);
+            writer.add(prefixSql, suffixSql, grantSql);
+        }
+        wxString script(writer.getPrefixSql() + "\n" + writer.getSuffixSql()
+            + writer.getGrantSql());
+        double writerMs = elapsedMs(start);
+
+        std::cout << "  INFO: script of " << objectCount << " objects ("
+                  << script.length() / 1024 << " KB) built in " << copyMs
+                  << " ms copying it for every object, " << writerMs
+                  << " ms in parts\n";
+        ok = check(script == sql, "Same script") && ok;
+        ok = check(writerMs * 5 < copyMs, "Parts are at least 5x faster") && ok;
+    }
+
+    std::cout << "DDLScriptWriter Tests completed: "
+              << (ok ? "ALL PASSED" : "SOME FAILED") << "\n";
+    return ok ? 0 : 1;
+}
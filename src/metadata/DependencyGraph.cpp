@@ -0,0 +1,375 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+
+#include "metadata/DependencyGraph.h"
+
+const size_t DependencyGraph::npos;
+
+DependencyGraph::DependencyGraph()
+    : builtM(false)
+{
+}
+
+void DependencyGraph::clear()
+{
+    objectsM.clear();
+    indexM.clear();
+    fieldsM.clear();
+    fieldIndexM.clear();
+    pendingM.clear();
+    dependsOnOffsetsM.clear();
+    dependsOnM.clear();
+    dependentsOffsetsM.clear();
+    dependentsM.clear();
+    builtM = false;
+}
+
+bool DependencyGraph::isBuilt() const
+{
+    return builtM;
+}
+
+size_t DependencyGraph::addObject(int type, const wxString& name)
+{
+    std::pair<std::map<std::pair<int, wxString>, size_t>::iterator, bool> r =
+        indexM.insert(std::make_pair(std::make_pair(type, name),
+            objectsM.size()));
+    if (r.second)
+    {
+        Object o;
+        o.type = type;
+        o.name = name;
+        objectsM.push_back(o);
+    }
+    return r.first->second;
+}
+
+size_t DependencyGraph::findObject(int type, const wxString& name) const
+{
+    std::map<std::pair<int, wxString>, size_t>::const_iterator it =
+        indexM.find(std::make_pair(type, name));
+    return (it == indexM.end()) ? npos : it->second;
+}
+
+size_t DependencyGraph::getObjectCount() const
+{
+    return objectsM.size();
+}
+
+int DependencyGraph::getType(size_t object) const
+{
+    return objectsM[object].type;
+}
+
+const wxString& DependencyGraph::getName(size_t object) const
+{
+    return objectsM[object].name;
+}
+
+void DependencyGraph::addDependency(size_t dependent, size_t dependedOn,
+    const wxString& field, int dependentPosition, int dependedOnPosition,
+    unsigned flags)
+{
+    Dependency d;
+    d.dependent = dependent;
+    d.dependedOn = dependedOn;
+    d.field = npos;
+    if (!field.empty())
+    {
+        std::pair<std::map<wxString, size_t>::iterator, bool> r =
+            fieldIndexM.insert(std::make_pair(field, fieldsM.size()));
+        if (r.second)
+            fieldsM.push_back(field);
+        d.field = r.first->second;
+    }
+    d.dependentPosition = dependentPosition;
+    d.dependedOnPosition = dependedOnPosition;
+    d.flags = flags;
+    pendingM.push_back(d);
+    builtM = false;
+}
+
+bool DependencyGraph::lessByObject(size_t left, size_t right) const
+{
+    const Object& l = objectsM[left];
+    const Object& r = objectsM[right];
+    if (l.type != r.type)
+        return l.type < r.type;
+    return l.name < r.name;
+}
+
+void DependencyGraph::buildEdges(bool dependsOn, std::vector<size_t>& offsets,
+    std::vector<Edge>& edges) const
+{
+    // the positions of pendingM sorted by the object the edge is stored
+    // for, then by the other object and field
+    std::vector<size_t> order(pendingM.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b)
+    {
+        const Dependency& l = pendingM[a];
+        const Dependency& r = pendingM[b];
+        size_t lOwner = dependsOn ? l.dependent : l.dependedOn;
+        size_t rOwner = dependsOn ? r.dependent : r.dependedOn;
+        if (lOwner != rOwner)
+            return lOwner < rOwner;
+        size_t lOther = dependsOn ? l.dependedOn : l.dependent;
+        size_t rOther = dependsOn ? r.dependedOn : r.dependent;
+        if (lOther != rOther)
+            return lessByObject(lOther, rOther);
+        if (l.field == r.field || r.field == npos)
+            return false;
+        return l.field == npos || fieldsM[l.field] < fieldsM[r.field];
+    });
+
+    offsets.assign(objectsM.size() + 1, 0);
+    edges.clear();
+    edges.reserve(order.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        const Dependency& d = pendingM[order[i]];
+        Edge e;
+        e.object = dependsOn ? d.dependedOn : d.dependent;
+        e.field = d.field;
+        e.position = dependsOn ? d.dependentPosition : d.dependedOnPosition;
+        e.flags = d.flags;
+        edges.push_back(e);
+        ++offsets[(dependsOn ? d.dependent : d.dependedOn) + 1];
+    }
+    for (size_t i = 1; i < offsets.size(); ++i)
+        offsets[i] += offsets[i - 1];
+}
+
+void DependencyGraph::build()
+{
+    // the statement returns the same dependency from several system
+    // tables, these are merged into one
+    std::sort(pendingM.begin(), pendingM.end(),
+        [](const Dependency& l, const Dependency& r)
+    {
+        if (l.dependent != r.dependent)
+            return l.dependent < r.dependent;
+        if (l.dependedOn != r.dependedOn)
+            return l.dependedOn < r.dependedOn;
+        return l.field < r.field;
+    });
+    std::vector<Dependency> merged;
+    merged.reserve(pendingM.size());
+    for (size_t i = 0; i < pendingM.size(); ++i)
+    {
+        const Dependency& d = pendingM[i];
+        if (!merged.empty() && merged.back().dependent == d.dependent
+            && merged.back().dependedOn == d.dependedOn
+            && merged.back().field == d.field)
+        {
+            merged.back().flags |= d.flags;
+        }
+        else
+            merged.push_back(d);
+    }
+    pendingM.swap(merged);
+
+    buildEdges(true, dependsOnOffsetsM, dependsOnM);
+    buildEdges(false, dependentsOffsetsM, dependentsM);
+    builtM = true;
+}
+
+std::pair<DependencyGraph::EdgeIterator, DependencyGraph::EdgeIterator>
+    DependencyGraph::getEdges(size_t object, bool dependsOn) const
+{
+    const std::vector<size_t>& offsets =
+        dependsOn ? dependsOnOffsetsM : dependentsOffsetsM;
+    const std::vector<Edge>& edges = dependsOn ? dependsOnM : dependentsM;
+    if (object + 1 >= offsets.size())
+        return std::make_pair(edges.end(), edges.end());
+    return std::make_pair(edges.begin() + offsets[object],
+        edges.begin() + offsets[object + 1]);
+}
+
+const wxString& DependencyGraph::getFieldName(size_t field) const
+{
+    static const wxString none;
+    return (field == npos) ? none : fieldsM[field];
+}
+
+void DependencyGraph::getTransitive(size_t object, bool dependsOn,
+    unsigned flags, std::vector<size_t>& objects) const
+{
+    objects.clear();
+    std::vector<bool> found(objectsM.size(), false);
+    found[object] = true;
+    std::vector<size_t> pending(1, object);
+    while (!pending.empty())
+    {
+        size_t current = pending.back();
+        pending.pop_back();
+        std::pair<EdgeIterator, EdgeIterator> edges =
+            getEdges(current, dependsOn);
+        for (EdgeIterator it = edges.first; it != edges.second; ++it)
+        {
+            if ((it->flags & flags) == 0 || found[it->object])
+                continue;
+            found[it->object] = true;
+            objects.push_back(it->object);
+            pending.push_back(it->object);
+        }
+    }
+}
+
+void DependencyGraph::getCreationOrder(const std::vector<size_t>& objects,
+    unsigned flags, std::vector<size_t>& order) const
+{
+    order.clear();
+    std::vector<size_t> positions(objectsM.size(), npos);
+    for (size_t i = objects.size(); i > 0; --i)
+    {
+        if (objects[i - 1] != npos)
+            positions[objects[i - 1]] = i - 1;
+    }
+
+    enum { kNew, kVisiting, kDone };
+    std::vector<char> state(objects.size(), kNew);
+    // positions being visited, with the next of their edges to follow
+    std::vector<std::pair<size_t, EdgeIterator> > stack;
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        if (state[i] != kNew)
+            continue;
+        if (objects[i] == npos)
+        {
+            state[i] = kDone;
+            order.push_back(i);
+            continue;
+        }
+        state[i] = kVisiting;
+        stack.push_back(std::make_pair(i, getEdges(objects[i], true).first));
+        while (!stack.empty())
+        {
+            size_t current = stack.back().first;
+            EdgeIterator end = getEdges(objects[current], true).second;
+            EdgeIterator& it = stack.back().second;
+            size_t next = npos;
+            for (; it != end && next == npos; ++it)
+            {
+                if ((it->flags & flags) == 0)
+                    continue;
+                size_t p = positions[it->object];
+                if (p != npos && state[p] == kNew)
+                    next = p;
+            }
+            if (next == npos)
+            {
+                state[current] = kDone;
+                order.push_back(current);
+                stack.pop_back();
+            }
+            else
+            {
+                state[next] = kVisiting;
+                stack.push_back(std::make_pair(next,
+                    getEdges(objects[next], true).first));
+            }
+        }
+    }
+}
+
+bool DependencyGraph::getLevels(const std::vector<size_t>& objects,
+    unsigned flags, std::vector<std::vector<size_t> >& levels) const
+{
+    levels.clear();
+    std::vector<size_t> positions(objectsM.size(), npos);
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        if (objects[i] != npos)
+            positions[objects[i]] = i;
+    }
+
+    // the number of other objects of the list every object depends on,
+    // edges are sorted by object so several fields count once
+    std::vector<size_t> waiting(objects.size(), 0);
+    std::vector<size_t> level;
+    for (size_t i = 0; i < objects.size(); ++i)
+    {
+        if (objects[i] != npos)
+        {
+            std::pair<EdgeIterator, EdgeIterator> edges =
+                getEdges(objects[i], true);
+            size_t last = npos;
+            for (EdgeIterator it = edges.first; it != edges.second; ++it)
+            {
+                if ((it->flags & flags) == 0 || it->object == objects[i]
+                    || it->object == last || positions[it->object] == npos)
+                {
+                    continue;
+                }
+                last = it->object;
+                ++waiting[i];
+            }
+        }
+        if (waiting[i] == 0)
+            level.push_back(i);
+    }
+
+    size_t ordered = 0;
+    while (!level.empty())
+    {
+        ordered += level.size();
+        std::vector<size_t> next;
+        for (size_t i = 0; i < level.size(); ++i)
+        {
+            if (objects[level[i]] == npos)
+                continue;
+            std::pair<EdgeIterator, EdgeIterator> edges =
+                getEdges(objects[level[i]], false);
+            size_t last = npos;
+            for (EdgeIterator it = edges.first; it != edges.second; ++it)
+            {
+                size_t p = positions[it->object];
+                if ((it->flags & flags) == 0 || p == npos || p == level[i]
+                    || it->object == last)
+                {
+                    continue;
+                }
+                last = it->object;
+                if (--waiting[p] == 0)
+                    next.push_back(p);
+            }
+        }
+        std::sort(next.begin(), next.end());
+        levels.push_back(level);
+        level.swap(next);
+    }
+    return ordered == objects.size();
+}
@@ -0,0 +1,141 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_DEPENDENCYGRAPH_H
+#define FR_DEPENDENCYGRAPH_H
+
+#include <wx/string.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+// DependencyGraph class
+// The dependencies between all objects of one database, read from
+// RDB$DEPENDENCIES and the system tables for computed columns, views,
+// check constraints and foreign keys with one statement. Objects are
+// identified by their RDB$DEPENDENCIES type and name and numbered as they
+// are added. Once build() has been called the dependencies of object i
+// are dependsOn[dependsOnOffsets[i]] to dependsOn[dependsOnOffsets[i + 1] - 1]
+// and the objects depending on it are stored the same way, so both
+// directions and transitive closures are answered without statements.
+class DependencyGraph
+{
+public:
+    // which lists of MetadataItem::getDependencies() a dependency belongs
+    // to; foreign keys are only used for ordering, tables list them from
+    // their constraints
+    enum Flags { kDependsOn = 1, kDependentOf = 2, kForeignKey = 4,
+        kAllFlags = 7 };
+
+    // a dependency as stored for one of its objects: the other object,
+    // the field it refers to and the position of that field in the
+    // relation the edge is stored for, as RDB$RELATION_FIELDS has it
+    struct Edge
+    {
+        size_t object;
+        size_t field;
+        int position;
+        unsigned flags;
+    };
+    typedef std::vector<Edge>::const_iterator EdgeIterator;
+
+    static const size_t npos = size_t(-1);
+private:
+    struct Object
+    {
+        int type;
+        wxString name;
+    };
+    std::vector<Object> objectsM;
+    std::map<std::pair<int, wxString>, size_t> indexM;
+    std::vector<wxString> fieldsM;
+    std::map<wxString, size_t> fieldIndexM;
+
+    struct Dependency
+    {
+        size_t dependent;
+        size_t dependedOn;
+        size_t field;
+        int dependentPosition;
+        int dependedOnPosition;
+        unsigned flags;
+    };
+    std::vector<Dependency> pendingM;
+
+    std::vector<size_t> dependsOnOffsetsM;
+    std::vector<Edge> dependsOnM;
+    std::vector<size_t> dependentsOffsetsM;
+    std::vector<Edge> dependentsM;
+    bool builtM;
+
+    bool lessByObject(size_t left, size_t right) const;
+    void buildEdges(bool dependsOn, std::vector<size_t>& offsets,
+        std::vector<Edge>& edges) const;
+public:
+    DependencyGraph();
+
+    void clear();
+    bool isBuilt() const;
+
+    // returns the object, which is added if it doesn't exist yet
+    size_t addObject(int type, const wxString& name);
+    // returns npos if there is no such object
+    size_t findObject(int type, const wxString& name) const;
+    size_t getObjectCount() const;
+    int getType(size_t object) const;
+    const wxString& getName(size_t object) const;
+    // field is empty for dependencies on the object as a whole
+    void addDependency(size_t dependent, size_t dependedOn,
+        const wxString& field, int dependentPosition, int dependedOnPosition,
+        unsigned flags);
+    // sorts the added dependencies into the arrays for both directions;
+    // the dependencies of every object are ordered by the type and name of
+    // the other object and by field, duplicates are merged
+    void build();
+
+    // the objects that object depends on if dependsOn is true, else the
+    // objects that depend on it
+    std::pair<EdgeIterator, EdgeIterator> getEdges(size_t object,
+        bool dependsOn) const;
+    const wxString& getFieldName(size_t field) const;
+
+    // all objects reachable from object over edges with one of flags, in
+    // the order they are found, without object itself
+    void getTransitive(size_t object, bool dependsOn, unsigned flags,
+        std::vector<size_t>& objects) const;
+    // the positions in objects (which may contain npos for objects without
+    // any dependencies) in the order they can be created: every object
+    // after the objects of the list it depends on, depth first and else
+    // in the order of the list; cycles are broken where they are found
+    void getCreationOrder(const std::vector<size_t>& objects, unsigned flags,
+        std::vector<size_t>& order) const;
+    // the positions in objects grouped in levels, the objects of a level
+    // only depend on objects of earlier levels and keep the order of the
+    // list; returns false if there is a cycle, then levels has the objects
+    // that could be ordered
+    bool getLevels(const std::vector<size_t>& objects, unsigned flags,
+        std::vector<std::vector<size_t> >& levels) const;
+};
+
+#endif // FR_DEPENDENCYGRAPH_H
@@ -0,0 +1,283 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <iostream>
+#include <set>
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include "metadata/DependencyGraph.h"
+
+namespace
+{
+
+bool check(bool condition, const char* testName)
+{
+    if (condition)
+    {
+        std::cout << "  PASSED: " << testName << "\n";
+        return true;
+    }
+    std::cout << "  FAILED: " << testName << "\n";
+    return false;
+}
+
+typedef DependencyGraph Graph;
+
+// RDB$DEPENDENCIES types
+const int relationType = 0, viewType = 1, procedureType = 5;
+
+void addDependency(Graph& graph, int type, const wxString& name,
+    int otherType, const wxString& other, const wxString& field = wxEmptyString,
+    unsigned flags = Graph::kDependsOn | Graph::kDependentOf)
+{
+    graph.addDependency(graph.addObject(type, name),
+        graph.addObject(otherType, other), field, 1, 2, flags);
+}
+
+std::vector<wxString> getNames(const Graph& graph, size_t object,
+    bool dependsOn)
+{
+    std::vector<wxString> names;
+    std::pair<Graph::EdgeIterator, Graph::EdgeIterator> edges =
+        graph.getEdges(object, dependsOn);
+    for (Graph::EdgeIterator it = edges.first; it != edges.second; ++it)
+    {
+        wxString name(graph.getName(it->object));
+        if (it->field != Graph::npos)
+            name += "." + graph.getFieldName(it->field);
+        names.push_back(name);
+    }
+    return names;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = true;
+    std::cout << "Running DependencyGraph Tests...\n";
+
+    Graph graph;
+    // CUSTOMERS <- ORDERS (foreign key), V_ORDERS selects from both,
+    // V_TOTALS from V_ORDERS, GET_TOTAL reads V_TOTALS
+    addDependency(graph, relationType, "ORDERS", relationType, "CUSTOMERS",
+        wxEmptyString, Graph::kForeignKey);
+    addDependency(graph, viewType, "V_ORDERS", relationType, "ORDERS", "ID");
+    addDependency(graph, viewType, "V_ORDERS", relationType, "ORDERS", "AMOUNT");
+    addDependency(graph, viewType, "V_ORDERS", relationType, "CUSTOMERS", "NAME");
+    addDependency(graph, viewType, "V_TOTALS", viewType, "V_ORDERS", "AMOUNT");
+    addDependency(graph, procedureType, "GET_TOTAL", viewType, "V_TOTALS");
+    // the same dependency read from another system table
+    addDependency(graph, viewType, "V_ORDERS", relationType, "ORDERS", "ID",
+        Graph::kDependsOn);
+    graph.build();
+
+    size_t customers = graph.findObject(relationType, "CUSTOMERS");
+    size_t orders = graph.findObject(relationType, "ORDERS");
+    size_t vOrders = graph.findObject(viewType, "V_ORDERS");
+    size_t vTotals = graph.findObject(viewType, "V_TOTALS");
+    size_t getTotal = graph.findObject(procedureType, "GET_TOTAL");
+
+    // Test 1: objects and both directions
+    {
+        ok = check(graph.isBuilt() && graph.getObjectCount() == 5
+            && graph.findObject(viewType, "ORDERS") == Graph::npos,
+            "Objects are identified by type and name") && ok;
+
+        std::vector<wxString> names = getNames(graph, vOrders, true);
+        ok = check(names.size() == 3 && names[0] == "CUSTOMERS.NAME"
+            && names[1] == "ORDERS.AMOUNT" && names[2] == "ORDERS.ID",
+            "Depends on, ordered by object and field") && ok;
+
+        std::pair<Graph::EdgeIterator, Graph::EdgeIterator> edges =
+            graph.getEdges(vOrders, true);
+        const Graph::Edge& id = *(edges.first + 2);
+        ok = check(id.flags == (Graph::kDependsOn | Graph::kDependentOf)
+            && id.position == 1, "Duplicates are merged") && ok;
+
+        names = getNames(graph, customers, false);
+        ok = check(names.size() == 2 && names[0] == "ORDERS"
+            && names[1] == "V_ORDERS.NAME", "Dependent objects") && ok;
+        edges = graph.getEdges(customers, false);
+        ok = check(edges.first->flags == Graph::kForeignKey
+            && (edges.first + 1)->position == 2,
+            "Edges keep flags and the position of their own side") && ok;
+
+        ok = check(getNames(graph, getTotal, false).empty()
+            && getNames(graph, customers, true).empty(),
+            "Objects without edges") && ok;
+    }
+
+    // Test 2: transitive dependencies
+    {
+        std::vector<size_t> objects;
+        graph.getTransitive(customers, false, Graph::kAllFlags, objects);
+        std::set<size_t> found(objects.begin(), objects.end());
+        ok = check(objects.size() == 4 && found.count(orders)
+            && found.count(vOrders) && found.count(vTotals)
+            && found.count(getTotal), "Everything depending on a table") && ok;
+
+        graph.getTransitive(customers, false, Graph::kDependentOf, objects);
+        ok = check(objects.size() == 3 && !std::count(objects.begin(),
+            objects.end(), orders), "Without foreign keys") && ok;
+
+        graph.getTransitive(getTotal, true, Graph::kAllFlags, objects);
+        ok = check(objects.size() == 4, "Everything a procedure uses") && ok;
+    }
+
+    // Test 3: ordering a list of objects
+    {
+        std::vector<size_t> objects;
+        objects.push_back(getTotal);
+        objects.push_back(vTotals);
+        objects.push_back(Graph::npos);
+        objects.push_back(vOrders);
+        objects.push_back(customers);
+        objects.push_back(orders);
+
+        std::vector<size_t> order;
+        graph.getCreationOrder(objects, Graph::kAllFlags, order);
+        ok = check(order.size() == 6 && order[0] == 4 && order[1] == 5
+            && order[2] == 3 && order[3] == 1 && order[4] == 0 && order[5] == 2,
+            "Creation order, depth first") && ok;
+
+        std::vector<std::vector<size_t> > levels;
+        bool sorted = graph.getLevels(objects, Graph::kAllFlags, levels);
+        ok = check(sorted && levels.size() == 5 && levels[0].size() == 2
+            && levels[0][0] == 2 && levels[0][1] == 4 && levels[1][0] == 5
+            && levels[4][0] == 0, "Levels") && ok;
+
+        // only the foreign keys count for inserting data
+        sorted = graph.getLevels(objects, Graph::kForeignKey, levels);
+        ok = check(sorted && levels.size() == 2 && levels[0].size() == 5
+            && levels[1].size() == 1 && levels[1][0] == 5,
+            "Levels of foreign keys") && ok;
+    }
+
+    // Test 4: cycles
+    {
+        Graph cycle;
+        addDependency(cycle, relationType, "A", relationType, "B");
+        addDependency(cycle, relationType, "B", relationType, "A");
+        addDependency(cycle, relationType, "C", relationType, "C");
+        addDependency(cycle, relationType, "D", relationType, "C");
+        cycle.build();
+        std::vector<size_t> objects;
+        objects.push_back(cycle.findObject(relationType, "A"));
+        objects.push_back(cycle.findObject(relationType, "B"));
+        objects.push_back(cycle.findObject(relationType, "D"));
+        objects.push_back(cycle.findObject(relationType, "C"));
+
+        std::vector<std::vector<size_t> > levels;
+        bool sorted = cycle.getLevels(objects, Graph::kAllFlags, levels);
+        ok = check(!sorted && levels.size() == 2 && levels[0].size() == 1
+            && levels[0][0] == 3 && levels[1][0] == 2,
+            "Cycle detected, self references ignored") && ok;
+
+        std::vector<size_t> order;
+        cycle.getCreationOrder(objects, Graph::kAllFlags, order);
+        ok = check(order.size() == 4 && order[0] == 1 && order[1] == 0
+            && order[2] == 3 && order[3] == 2, "Cycle broken for creation order") && ok;
+
+        cycle.clear();
+        ok = check(!cycle.isBuilt() && cycle.getObjectCount() == 0
+            && cycle.getEdges(0, true).first == cycle.getEdges(0, true).second,
+            "Cleared") && ok;
+    }
+
+    // Test 5: 20000 tables in chains with views on them, the graph against
+    // one pass over all dependencies for every object as sortTables() did
+    {
+        const int tableCount = 20000, chainLength = 50;
+        Graph big;
+        std::vector<std::pair<int, int> > rows;
+        for (int i = 0; i < tableCount; ++i)
+        {
+            wxString name(wxString::Format("T_%d", i));
+            big.addObject(relationType, name);
+            if (i % chainLength != 0)
+            {
+                addDependency(big, relationType, name, relationType,
+                    wxString::Format("T_%d", i - 1), wxEmptyString,
+                    Graph::kForeignKey);
+                rows.push_back(std::make_pair(i, i - 1));
+            }
+            addDependency(big, viewType, wxString::Format("V_%d", i),
+                relationType, name, "ID");
+        }
+        auto start = std::chrono::steady_clock::now();
+        big.build();
+        std::vector<size_t> tables;
+        for (int i = 0; i < tableCount; ++i)
+            tables.push_back(big.findObject(relationType, wxString::Format("T_%d", i)));
+        std::vector<std::vector<size_t> > levels;
+        bool sorted = big.getLevels(tables, Graph::kForeignKey, levels);
+        double graphMs = elapsedMs(start);
+
+        // every table looking up its own dependencies, like one statement
+        // for each of them
+        start = std::chrono::steady_clock::now();
+        size_t found = 0;
+        for (int i = 0; i < tableCount; i += 10)
+        {
+            for (size_t r = 0; r < rows.size(); ++r)
+            {
+                if (rows[r].first == i)
+                    ++found;
+            }
+        }
+        double scanMs = elapsedMs(start) * 10;
+
+        std::cout << "  INFO: " << tableCount << " tables built and levelled in "
+                  << graphMs << " ms, a lookup per table would take about "
+                  << scanMs << " ms\n";
+        ok = check(found > 0 && sorted && levels.size() == size_t(chainLength)
+            && levels[0].size() == size_t(tableCount / chainLength),
+            "Levels of long chains") && ok;
+
+        std::vector<size_t> dependents;
+        big.getTransitive(tables[0], false, Graph::kAllFlags, dependents);
+        ok = check(dependents.size() == size_t(2 * chainLength - 1),
+            "Transitive dependents of a chain") && ok;
+        ok = check(graphMs < scanMs, "Graph is faster than a lookup per table") && ok;
+    }
+
+    std::cout << "DependencyGraph Tests completed: "
+              << (ok ? "ALL PASSED" : "SOME FAILED") << "\n";
+    return ok ? 0 : 1;
+}
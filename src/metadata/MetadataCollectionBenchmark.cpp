@@ -0,0 +1,219 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// Benchmark and consistency checks for the name and id index of
+// MetadataCollection, over a synthetic database with 50k objects
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include "metadata/collection.h"
+#include "metadata/generator.h"
+
+namespace
+{
+
+bool check(bool condition, const char* testName)
+{
+    if (condition)
+    {
+        std::cout << "  PASSED: " << testName << "\n";
+        return true;
+    }
+    std::cout << "  FAILED: " << testName << "\n";
+    return false;
+}
+
+class BenchmarkGenerators : public MetadataCollection<Generator>
+{
+public:
+    BenchmarkGenerators()
+        : MetadataCollection<Generator>(ntGenerators, DatabasePtr(),
+            "Generators")
+    {
+    }
+};
+
+// the lookup as it was done before the index existed
+GeneratorPtr findLinear(const std::vector<GeneratorPtr>& items,
+    const wxString& name)
+{
+    Identifier id(name);
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        if (items[i]->getIdentifier().equals(id))
+            return items[i];
+    }
+    return GeneratorPtr();
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = true;
+    std::cout << "Running MetadataCollection Benchmark...\n";
+
+    const size_t objectCount = 50000;
+    wxArrayString names;
+    names.Alloc(objectCount);
+    for (size_t i = 0; i < objectCount; ++i)
+        names.Add(wxString::Format("OBJECT_%06d", int(i)));
+
+    BenchmarkGenerators collection;
+
+    // Test 1: loading the collection looks up every name once
+    auto start = std::chrono::steady_clock::now();
+    collection.setItems(names);
+    double loadMs = elapsedMs(start);
+    start = std::chrono::steady_clock::now();
+    collection.setItems(names);
+    double reloadMs = elapsedMs(start);
+    std::cout << "  INFO: setItems() of " << objectCount << " names: "
+              << loadMs << " ms, reload " << reloadMs << " ms\n";
+
+    std::vector<GeneratorPtr> items;
+    for (size_t i = 0; i < objectCount; ++i)
+        items.push_back(collection.findByName(names[i]));
+    bool allFound = true;
+    for (size_t i = 0; i < objectCount; ++i)
+        allFound = allFound && items[i] && items[i]->getName_() == names[i];
+    ok = check(allFound, "All 50k objects found by name") && ok;
+
+    // Test 2: lookups of existing and missing names
+    const size_t lookupCount = 500000;
+    size_t found = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < lookupCount; ++i)
+    {
+        // every fourth name does not exist
+        if (i % 4 == 3)
+            found += collection.findByName("MISSING_OBJECT") ? 1 : 0;
+        else
+            found += collection.findByName(names[(i * 7919) % objectCount]) ? 1 : 0;
+    }
+    double indexMs = elapsedMs(start);
+    ok = check(found == lookupCount - lookupCount / 4, "Lookup hits and misses") && ok;
+
+    const size_t linearCount = 2000;
+    size_t linearFound = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < linearCount; ++i)
+    {
+        if (i % 4 == 3)
+            linearFound += findLinear(items, "MISSING_OBJECT") ? 1 : 0;
+        else
+            linearFound += findLinear(items, names[(i * 7919) % objectCount]) ? 1 : 0;
+    }
+    double linearMs = elapsedMs(start);
+    double indexPerLookup = indexMs * 1000.0 / lookupCount;
+    double linearPerLookup = linearMs * 1000.0 / linearCount;
+    std::cout << "  INFO: findByName(): " << indexPerLookup << " us per lookup, "
+              << "linear search: " << linearPerLookup << " us per lookup\n";
+    ok = check(linearFound == linearCount - linearCount / 4,
+        "Linear reference finds the same") && ok;
+    ok = check(indexPerLookup * 10 < linearPerLookup,
+        "Index is at least 10x faster than the linear search") && ok;
+
+    // Test 3: names are matched like Identifier::equals() does
+    ok = check(collection.findByName("OBJECT_000042 ") == items[42],
+        "Trailing blanks are ignored") && ok;
+    ok = check(!collection.findByName("object_000042"),
+        "Names are case sensitive") && ok;
+
+    // Test 4: metadata ids that the loader assigns before setItems()
+    BenchmarkGenerators::CollectionType reloaded;
+    for (size_t i = 0; i < objectCount; ++i)
+    {
+        items[i]->setMetadataId(int(i) + 100);
+        reloaded.push_back(items[i]);
+    }
+    collection.setItems(reloaded);
+    bool idsOk = true;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < objectCount; ++i)
+        idsOk = idsOk && collection.findByMetadataId(int(i) + 100) == items[i];
+    double idMs = elapsedMs(start);
+    std::cout << "  INFO: findByMetadataId() of " << objectCount << " ids: "
+              << idMs << " ms\n";
+    ok = check(idsOk, "All objects found by metadata id") && ok;
+    ok = check(!collection.findByMetadataId(1), "Unknown id not found") && ok;
+
+    // Test 5: insert, remove and rename keep the index up to date
+    GeneratorPtr inserted = collection.insert("NEW_OBJECT");
+    ok = check(collection.findByName("NEW_OBJECT") == inserted,
+        "Inserted object found") && ok;
+    collection.remove(inserted.get());
+    ok = check(!collection.findByName("NEW_OBJECT"), "Removed object not found") && ok;
+
+    GeneratorPtr renamed = items[100];
+    collection.remove(renamed.get());
+    renamed->setName_("RENAMED_OBJECT");
+    collection.insertItem(renamed);
+    ok = check(collection.findByName("RENAMED_OBJECT") == renamed
+        && !collection.findByName(names[100]), "Renamed object found by new name") && ok;
+
+    // the index may not be rebuilt only when the old key is looked up
+    items[300]->setName_("RENAMED_LOOKED_UP_FIRST");
+    ok = check(collection.findByName("RENAMED_LOOKED_UP_FIRST") == items[300],
+        "Object renamed in place found by new name first") && ok;
+    items[400]->setMetadataId(1000000);
+    ok = check(collection.findByMetadataId(1000000) == items[400]
+        && !collection.findByMetadataId(400 + 100),
+        "Object with new id found by new id first") && ok;
+
+    // items that aren't loaded yet share the same id
+    GeneratorPtr first = collection.insert("SAME_ID_1");
+    GeneratorPtr second = collection.insert("SAME_ID_2");
+    ok = check(collection.findByMetadataId(first->getMetadataId()) == first,
+        "First object with duplicate id found") && ok;
+    collection.remove(first.get());
+    ok = check(collection.findByMetadataId(second->getMetadataId()) == second,
+        "Hidden object with duplicate id found after remove") && ok;
+
+    items[200]->setName_("RENAMED_IN_PLACE");
+    ok = check(!collection.findByName(names[200]),
+        "Object renamed in place not found by old name") && ok;
+    ok = check(collection.findByName("RENAMED_IN_PLACE") == items[200],
+        "Object renamed in place found after rebuild") && ok;
+
+    std::cout << "MetadataCollection Benchmark completed: "
+              << (ok ? "ALL PASSED" : "SOME FAILED") << "\n";
+    return ok ? 0 : 1;
+}
@@ -188,7 +188,7 @@ void LoadDescriptionVisitor::visitPackage(Package& package)
 {
     loadDescription(&package,
         "select RDB$DESCRIPTION from RDB$PACKAGES "
-        "where RDB$PACLAGE_NAME = ?");
+        "where RDB$PACKAGE_NAME = ?");
 }
 
 void LoadDescriptionVisitor::visitProcedure(Procedure& procedure)
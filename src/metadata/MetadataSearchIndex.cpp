@@ -0,0 +1,350 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+#include <iterator>
+
+#include "metadata/MetadataSearchIndex.h"
+
+namespace
+{
+
+inline uint64_t makeTrigram(wxChar c1, wxChar c2, wxChar c3)
+{
+    const uint64_t mask = 0x1FFFFF;
+    return ((uint64_t(c1) & mask) << 42) | ((uint64_t(c2) & mask) << 21)
+        | (uint64_t(c3) & mask);
+}
+
+// appends the trigrams of the text between the wildcards of pattern, or of
+// all text if wildcards is false
+void addTrigrams(const wxString& text, bool wildcards,
+    std::vector<uint64_t>& trigrams)
+{
+    wxChar c1 = 0, c2 = 0;
+    size_t run = 0;
+    for (wxString::const_iterator it = text.begin(); it != text.end(); ++it)
+    {
+        wxChar c = *it;
+        if (wildcards && (c == '*' || c == '?'))
+        {
+            run = 0;
+            continue;
+        }
+        if (++run >= 3)
+            trigrams.push_back(makeTrigram(c1, c2, c));
+        c1 = c2;
+        c2 = c;
+    }
+}
+
+void sortUnique(std::vector<uint64_t>& trigrams)
+{
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()),
+        trigrams.end());
+}
+
+void intersect(std::vector<uint16_t>& candidates,
+    const std::vector<uint16_t>& other)
+{
+    std::vector<uint16_t> result;
+    std::set_intersection(candidates.begin(), candidates.end(),
+        other.begin(), other.end(), std::back_inserter(result));
+    candidates.swap(result);
+}
+
+} // namespace
+
+MetadataSearchIndex::MetadataSearchIndex()
+{
+}
+
+void MetadataSearchIndex::clear()
+{
+    documentsM.clear();
+    for (int k = 0; k < kindCount; ++k)
+        blocksM[k].clear();
+}
+
+size_t MetadataSearchIndex::addDocument(int type)
+{
+    Document d;
+    d.type = type;
+    for (int k = 0; k < kindCount; ++k)
+    {
+        d.loaded[k] = false;
+        d.stale[k] = false;
+    }
+    documentsM.push_back(d);
+
+    size_t block = (documentsM.size() - 1) / documentsPerBlock;
+    for (int k = 0; k < kindCount; ++k)
+    {
+        if (blocksM[k].size() <= block)
+            blocksM[k].resize(block + 1);
+        blocksM[k][block].valid = false;
+    }
+    return documentsM.size() - 1;
+}
+
+size_t MetadataSearchIndex::getDocumentCount() const
+{
+    return documentsM.size();
+}
+
+int MetadataSearchIndex::getType(size_t document) const
+{
+    return documentsM[document].type;
+}
+
+bool MetadataSearchIndex::needsText(size_t document, Kind kind) const
+{
+    const Document& d = documentsM[document];
+    return !d.loaded[kind] || d.stale[kind];
+}
+
+void MetadataSearchIndex::setText(size_t document, Kind kind,
+    const wxString& value)
+{
+    std::vector<wxString> values(1, value);
+    setText(document, kind, values);
+}
+
+void MetadataSearchIndex::setText(size_t document, Kind kind,
+    const std::vector<wxString>& values)
+{
+    Document& d = documentsM[document];
+    d.values[kind].clear();
+    for (size_t i = 0; i < values.size(); ++i)
+        d.values[kind].push_back(values[i].Upper());
+    d.loaded[kind] = true;
+    d.stale[kind] = false;
+    blocksM[kind][document / documentsPerBlock].valid = false;
+}
+
+void MetadataSearchIndex::setStale(size_t document)
+{
+    Document& d = documentsM[document];
+    for (int k = 0; k < kindCount; ++k)
+        d.stale[k] = d.loaded[k];
+}
+
+void MetadataSearchIndex::buildBlock(Kind kind, size_t block)
+{
+    Block& b = blocksM[kind][block];
+    size_t first = block * documentsPerBlock;
+    size_t last = std::min(first + documentsPerBlock, documentsM.size());
+
+    // all (trigram, document) pairs, sorted they give the documents of
+    // every trigram in ascending order
+    std::vector<std::pair<uint64_t, uint16_t> > pairs;
+    std::vector<uint64_t> trigrams;
+    for (size_t i = first; i < last; ++i)
+    {
+        trigrams.clear();
+        const std::vector<wxString>& values = documentsM[i].values[kind];
+        for (size_t v = 0; v < values.size(); ++v)
+            addTrigrams(values[v], false, trigrams);
+        sortUnique(trigrams);
+        for (size_t t = 0; t < trigrams.size(); ++t)
+            pairs.push_back(std::make_pair(trigrams[t], uint16_t(i - first)));
+    }
+    std::sort(pairs.begin(), pairs.end());
+
+    b.trigrams.clear();
+    b.offsets.clear();
+    b.documents.clear();
+    b.documents.reserve(pairs.size());
+    for (size_t i = 0; i < pairs.size(); ++i)
+    {
+        if (b.trigrams.empty() || b.trigrams.back() != pairs[i].first)
+        {
+            b.trigrams.push_back(pairs[i].first);
+            b.offsets.push_back(uint32_t(i));
+        }
+        b.documents.push_back(pairs[i].second);
+    }
+    b.offsets.push_back(uint32_t(pairs.size()));
+    b.valid = true;
+}
+
+void MetadataSearchIndex::prepare(const Criteria& criteria)
+{
+    for (int k = 0; k < kindCount; ++k)
+    {
+        if (!criteria.uses(Kind(k)))
+            continue;
+        for (size_t b = 0; b < blocksM[k].size(); ++b)
+        {
+            if (!blocksM[k][b].valid)
+                buildBlock(Kind(k), b);
+        }
+    }
+}
+
+// puts the documents of the block that contain all trigrams of the literal
+// parts of pattern into candidates, returns false if pattern has none
+bool MetadataSearchIndex::getCandidates(const Block& block,
+    const wxString& pattern, std::vector<uint16_t>& candidates) const
+{
+    std::vector<uint64_t> trigrams;
+    addTrigrams(pattern, true, trigrams);
+    if (trigrams.empty())
+        return false;
+    sortUnique(trigrams);
+
+    // start with the trigram that is in the fewest documents
+    std::vector<std::pair<uint32_t, size_t> > lists;
+    for (size_t i = 0; i < trigrams.size(); ++i)
+    {
+        std::vector<uint64_t>::const_iterator it = std::lower_bound(
+            block.trigrams.begin(), block.trigrams.end(), trigrams[i]);
+        if (it == block.trigrams.end() || *it != trigrams[i])
+        {
+            candidates.clear();
+            return true;
+        }
+        size_t index = it - block.trigrams.begin();
+        lists.push_back(std::make_pair(
+            block.offsets[index + 1] - block.offsets[index], index));
+    }
+    std::sort(lists.begin(), lists.end());
+
+    for (size_t i = 0; i < lists.size(); ++i)
+    {
+        size_t index = lists[i].second;
+        std::vector<uint16_t> documents(
+            block.documents.begin() + block.offsets[index],
+            block.documents.begin() + block.offsets[index + 1]);
+        if (i == 0)
+            candidates.swap(documents);
+        else
+            intersect(candidates, documents);
+        if (candidates.empty())
+            break;
+    }
+    return true;
+}
+
+// the candidates of all patterns, returns false if one of them has none
+bool MetadataSearchIndex::getCandidates(const Block& block,
+    const std::vector<wxString>& patterns,
+    std::vector<uint16_t>& candidates) const
+{
+    candidates.clear();
+    std::vector<uint16_t> documents, merged;
+    for (size_t i = 0; i < patterns.size(); ++i)
+    {
+        if (!getCandidates(block, patterns[i], documents))
+            return false;
+        merged.clear();
+        std::set_union(candidates.begin(), candidates.end(),
+            documents.begin(), documents.end(), std::back_inserter(merged));
+        candidates.swap(merged);
+    }
+    return true;
+}
+
+bool MetadataSearchIndex::isMatch(const Document& document,
+    const Criteria& criteria) const
+{
+    if (!criteria.types.empty()
+        && criteria.types.find(document.type) == criteria.types.end())
+    {
+        return false;
+    }
+    for (int k = 0; k < kindCount; ++k)
+    {
+        const std::vector<wxString>& patterns = criteria.patterns[k];
+        if (patterns.empty())
+            continue;
+        const std::vector<wxString>& values = document.values[k];
+        bool found = false;
+        for (size_t v = 0; v < values.size() && !found; ++v)
+        {
+            for (size_t p = 0; p < patterns.size() && !found; ++p)
+                found = values[v].Matches(patterns[p]);
+        }
+        if (!found)
+            return false;
+    }
+    return true;
+}
+
+bool MetadataSearchIndex::search(const Criteria& criteria,
+    std::vector<size_t>& matches, const std::atomic<bool>& cancel) const
+{
+    matches.clear();
+    size_t blockCount = (documentsM.size() + documentsPerBlock - 1)
+        / documentsPerBlock;
+    std::vector<uint16_t> candidates, documents;
+    for (size_t b = 0; b < blockCount; ++b)
+    {
+        if (cancel)
+            return false;
+
+        // only the documents that contain the trigrams of every kind of
+        // text need to be matched against the patterns
+        bool restricted = false;
+        for (int k = 0; k < kindCount; ++k)
+        {
+            if (!criteria.uses(Kind(k)) || !blocksM[k][b].valid
+                || !getCandidates(blocksM[k][b], criteria.patterns[k], documents))
+            {
+                continue;
+            }
+            if (restricted)
+                intersect(candidates, documents);
+            else
+                candidates.swap(documents);
+            restricted = true;
+        }
+        size_t first = b * documentsPerBlock;
+        if (!restricted)
+        {
+            size_t count = std::min<size_t>(documentsPerBlock,
+                documentsM.size() - first);
+            candidates.resize(count);
+            for (size_t i = 0; i < count; ++i)
+                candidates[i] = uint16_t(i);
+        }
+
+        for (size_t i = 0; i < candidates.size(); ++i)
+        {
+            size_t document = first + candidates[i];
+            if (isMatch(documentsM[document], criteria))
+                matches.push_back(document);
+        }
+    }
+    return true;
+}
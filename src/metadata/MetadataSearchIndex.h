@@ -0,0 +1,115 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_METADATASEARCHINDEX_H
+#define FR_METADATASEARCHINDEX_H
+
+#include <wx/string.h>
+
+#include <atomic>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+// MetadataSearchIndex class
+// The searchable text of the metadata objects of one database, upper
+// case: names, descriptions, DDL and the names of columns, parameters or
+// index segments. For every kind of text a trigram index lists the objects
+// that contain each sequence of three characters, so a pattern is only
+// matched against the objects that contain all trigrams of its literal
+// parts.
+// The text has to be set on the thread that loads the metadata. Once
+// prepare() has been called search() only reads the index, so several
+// indices can be searched on worker threads at the same time.
+class MetadataSearchIndex
+{
+public:
+    enum Kind { kName, kDescription, kDDL, kFields, kindCount };
+
+    // an object matches if it has one of the types (if any are given) and
+    // for every kind with patterns one of its values matches one of them;
+    // patterns are upper case and use the wildcards of wxString::Matches()
+    struct Criteria
+    {
+        std::set<int> types;
+        std::vector<wxString> patterns[kindCount];
+        bool uses(Kind kind) const { return !patterns[kind].empty(); }
+    };
+private:
+    struct Document
+    {
+        int type;
+        std::vector<wxString> values[kindCount];
+        bool loaded[kindCount];
+        bool stale[kindCount];
+    };
+    std::vector<Document> documentsM;
+
+    // the trigrams of documentsPerBlock documents, so changing the text
+    // of a document only requires the trigrams of its block to be built
+    // again; the documents that contain trigrams[i] are documents[offsets[i]]
+    // to documents[offsets[i + 1] - 1], numbered within the block and in
+    // ascending order
+    enum { documentsPerBlock = 256 };
+    struct Block
+    {
+        std::vector<uint64_t> trigrams;
+        std::vector<uint32_t> offsets;
+        std::vector<uint16_t> documents;
+        bool valid;
+    };
+    std::vector<Block> blocksM[kindCount];
+
+    void buildBlock(Kind kind, size_t block);
+    bool getCandidates(const Block& block, const wxString& pattern,
+        std::vector<uint16_t>& candidates) const;
+    bool getCandidates(const Block& block, const std::vector<wxString>& patterns,
+        std::vector<uint16_t>& candidates) const;
+    bool isMatch(const Document& document, const Criteria& criteria) const;
+public:
+    MetadataSearchIndex();
+
+    void clear();
+    // adds an object of type, returns the number of its document
+    size_t addDocument(int type);
+    size_t getDocumentCount() const;
+    int getType(size_t document) const;
+
+    // true if the text of kind has to be (re)loaded for the document
+    bool needsText(size_t document, Kind kind) const;
+    void setText(size_t document, Kind kind, const wxString& value);
+    void setText(size_t document, Kind kind,
+        const std::vector<wxString>& values);
+    // the object was changed, its text is loaded again when needed, but
+    // until then the old text is searched
+    void setStale(size_t document);
+
+    // updates the trigrams of the kinds that criteria uses
+    void prepare(const Criteria& criteria);
+    // puts the numbers of the matching documents into matches, in
+    // ascending order; returns false if it was cancelled
+    bool search(const Criteria& criteria, std::vector<size_t>& matches,
+        const std::atomic<bool>& cancel) const;
+};
+
+#endif // FR_METADATASEARCHINDEX_H
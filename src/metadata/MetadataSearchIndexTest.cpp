@@ -0,0 +1,249 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include "metadata/MetadataSearchIndex.h"
+
+namespace
+{
+
+bool check(bool condition, const char* testName)
+{
+    if (condition)
+    {
+        std::cout << "  PASSED: " << testName << "\n";
+        return true;
+    }
+    std::cout << "  FAILED: " << testName << "\n";
+    return false;
+}
+
+typedef MetadataSearchIndex Index;
+
+const int tableType = 1, procedureType = 2;
+
+size_t addTable(Index& index, const wxString& name, const wxString& ddl,
+    const std::vector<wxString>& columns)
+{
+    size_t doc = index.addDocument(tableType);
+    index.setText(doc, Index::kName, name);
+    index.setText(doc, Index::kDDL, ddl);
+    index.setText(doc, Index::kFields, columns);
+    return doc;
+}
+
+std::vector<size_t> search(Index& index, const Index::Criteria& criteria)
+{
+    std::atomic<bool> cancel(false);
+    std::vector<size_t> matches;
+    index.prepare(criteria);
+    index.search(criteria, matches, cancel);
+    return matches;
+}
+
+// the matches as the search frame found them before there was an index
+std::vector<size_t> searchAll(const std::vector<wxString>& ddl,
+    const wxString& pattern)
+{
+    std::vector<size_t> matches;
+    for (size_t i = 0; i < ddl.size(); ++i)
+    {
+        if (ddl[i].Upper().Matches(pattern))
+            matches.push_back(i);
+    }
+    return matches;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = true;
+    std::cout << "Running MetadataSearchIndex Tests...\n";
+
+    Index index;
+    std::vector<wxString> columns;
+    columns.push_back("ID");
+    columns.push_back("customer_id");
+    addTable(index, "ORDERS", "create table orders (id integer, "
+        "customer_id integer references customers)", columns);
+    columns.clear();
+    columns.push_back("ID");
+    columns.push_back("NAME");
+    addTable(index, "CUSTOMERS", "CREATE TABLE CUSTOMERS (ID INTEGER, "
+        "NAME VARCHAR(50))", columns);
+    size_t procedure = index.addDocument(procedureType);
+    index.setText(procedure, Index::kName, "GET_CUSTOMER");
+    index.setText(procedure, Index::kDescription, "Returns a customer");
+    index.setText(procedure, Index::kDDL, "CREATE PROCEDURE GET_CUSTOMER "
+        "(ID INTEGER) AS BEGIN END");
+
+    // Test 1: names, wildcards and types
+    {
+        Index::Criteria c;
+        c.patterns[Index::kName].push_back("CUSTOMERS");
+        std::vector<size_t> m = search(index, c);
+        ok = check(m.size() == 1 && m[0] == 1, "Exact name") && ok;
+
+        c.patterns[Index::kName][0] = "*CUSTOMER*";
+        m = search(index, c);
+        ok = check(m.size() == 2 && m[0] == 1 && m[1] == 2, "Name with wildcards") && ok;
+
+        c.types.insert(procedureType);
+        m = search(index, c);
+        ok = check(m.size() == 1 && m[0] == 2, "Name and type") && ok;
+
+        Index::Criteria q;
+        q.patterns[Index::kName].push_back("?RDERS");
+        m = search(index, q);
+        ok = check(m.size() == 1 && m[0] == 0, "Name with single character wildcard") && ok;
+    }
+
+    // Test 2: patterns of one kind are alternatives, all kinds have to match
+    {
+        Index::Criteria c;
+        c.patterns[Index::kDDL].push_back("*VARCHAR*");
+        c.patterns[Index::kDDL].push_back("*REFERENCES*");
+        std::vector<size_t> m = search(index, c);
+        ok = check(m.size() == 2 && m[0] == 0 && m[1] == 1, "Any DDL pattern") && ok;
+
+        c.patterns[Index::kFields].push_back("CUSTOMER_ID");
+        m = search(index, c);
+        ok = check(m.size() == 1 && m[0] == 0, "DDL and field") && ok;
+
+        Index::Criteria d;
+        d.patterns[Index::kDescription].push_back("*CUSTOMER*");
+        m = search(index, d);
+        ok = check(m.size() == 1 && m[0] == 2, "Description") && ok;
+
+        // too short for a trigram, every object is matched against it
+        Index::Criteria f;
+        f.patterns[Index::kFields].push_back("ID");
+        m = search(index, f);
+        ok = check(m.size() == 2, "Short field pattern") && ok;
+
+        Index::Criteria n;
+        n.patterns[Index::kDDL].push_back("*NO SUCH TEXT*");
+        ok = check(search(index, n).empty(), "No match") && ok;
+    }
+
+    // Test 3: changed text is searched after it was set again
+    {
+        Index::Criteria c;
+        c.patterns[Index::kDDL].push_back("*BIGINT*");
+        ok = check(search(index, c).empty(), "Before change") && ok;
+        index.setStale(1);
+        ok = check(index.needsText(1, Index::kDDL)
+            && !index.needsText(0, Index::kDDL)
+            && index.needsText(2, Index::kFields), "Stale text needs loading") && ok;
+        index.setText(1, Index::kDDL, "CREATE TABLE CUSTOMERS (ID BIGINT)");
+        std::vector<size_t> m = search(index, c);
+        ok = check(m.size() == 1 && m[0] == 1 && !index.needsText(1, Index::kDDL),
+            "After change") && ok;
+    }
+
+    // Test 4: 15 databases of 5000 objects, searched in parallel
+    {
+        const size_t databaseCount = 15, objectCount = 5000;
+        std::vector<Index> indices(databaseCount);
+        std::vector<std::vector<wxString> > ddl(databaseCount);
+        for (size_t db = 0; db < databaseCount; ++db)
+        {
+            for (size_t i = 0; i < objectCount; ++i)
+            {
+                wxString name(wxString::Format("TABLE_%d_%d", int(db), int(i)));
+                wxString text("CREATE TABLE " + name + " (");
+                for (int col = 0; col < 20; ++col)
+                {
+                    text += wxString::Format("COLUMN_%d_%d INTEGER NOT NULL, ",
+                        int(i % 97), col);
+                }
+                text += wxString::Format("CONSTRAINT PK_%d PRIMARY KEY (ID));", int(i));
+                std::vector<wxString> fields(1, "ID");
+                addTable(indices[db], name, text, fields);
+                ddl[db].push_back(text);
+            }
+        }
+
+        Index::Criteria c;
+        c.patterns[Index::kDDL].push_back("*COLUMN_42_7 *");
+        auto start = std::chrono::steady_clock::now();
+        for (size_t db = 0; db < databaseCount; ++db)
+            indices[db].prepare(c);
+        double buildMs = elapsedMs(start);
+
+        std::vector<std::vector<size_t> > results(databaseCount);
+        std::atomic<bool> cancel(false);
+        start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (size_t db = 0; db < databaseCount; ++db)
+        {
+            workers.emplace_back([&, db]()
+            {
+                indices[db].search(c, results[db], cancel);
+            });
+        }
+        for (std::thread& t : workers)
+            t.join();
+        double indexMs = elapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        bool same = true;
+        for (size_t db = 0; db < databaseCount; ++db)
+            same = searchAll(ddl[db], c.patterns[Index::kDDL][0]) == results[db] && same;
+        double scanMs = elapsedMs(start);
+
+        std::cout << "  INFO: " << databaseCount * objectCount
+                  << " objects indexed in " << buildMs << " ms, searched in "
+                  << indexMs << " ms, matching all DDL takes " << scanMs << " ms\n";
+        ok = check(same && results[0].size() == objectCount / 97 + 1,
+            "Parallel search finds the same objects") && ok;
+        ok = check(indexMs * 5 < scanMs, "Index search is at least 5x faster") && ok;
+
+        cancel = true;
+        std::vector<size_t> m;
+        ok = check(!indices[0].search(c, m, cancel), "Search cancelled") && ok;
+    }
+
+    std::cout << "MetadataSearchIndex Tests completed: "
+              << (ok ? "ALL PASSED" : "SOME FAILED") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,367 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <wx/file.h>
+
+#include "metadata/MetadataSnapshot.h"
+
+namespace
+{
+
+// "FRMS" and the version of the file format, files of other versions are
+// ignored
+const uint32_t snapshotMagic = 0x534D5246;
+const uint32_t snapshotVersion = 1;
+
+uint32_t getChecksum(const char* data, size_t length)
+{
+    // FNV-1a, only to detect damaged files
+    uint32_t hash = 2166136261U;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash ^= (unsigned char)data[i];
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+// SnapshotWriter class
+// Appends little endian integers and length prefixed UTF-8 strings to
+// a buffer.
+class SnapshotWriter
+{
+private:
+    std::string& bufferM;
+public:
+    SnapshotWriter(std::string& buffer) : bufferM(buffer) {}
+
+    void writeUInt32(uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+            bufferM += char((value >> (8 * i)) & 0xFF);
+    }
+    void writeInt64(int64_t value)
+    {
+        uint64_t u = uint64_t(value);
+        for (int i = 0; i < 8; ++i)
+            bufferM += char((u >> (8 * i)) & 0xFF);
+    }
+    void writeString(const std::string& value)
+    {
+        writeUInt32(uint32_t(value.size()));
+        bufferM += value;
+    }
+    void writeString(const wxString& value)
+    {
+        writeString(std::string(value.utf8_str()));
+    }
+    void writeNames(const wxArrayString& names)
+    {
+        writeUInt32(uint32_t(names.size()));
+        for (size_t i = 0; i < names.size(); ++i)
+            writeString(names[i]);
+    }
+};
+
+// SnapshotReader class
+// Reads what SnapshotWriter wrote, every read after the end of the data
+// fails and sets the error flag.
+class SnapshotReader
+{
+private:
+    const std::string& bufferM;
+    size_t posM;
+    size_t endM;
+    bool errorM;
+
+    bool ensure(size_t count)
+    {
+        if (errorM || endM - posM < count)
+        {
+            errorM = true;
+            return false;
+        }
+        return true;
+    }
+public:
+    SnapshotReader(const std::string& buffer, size_t pos, size_t end)
+        : bufferM(buffer), posM(pos), endM(end), errorM(false) {}
+
+    bool hasError() const { return errorM; }
+    bool atEnd() const { return posM == endM; }
+
+    uint32_t readUInt32()
+    {
+        if (!ensure(4))
+            return 0;
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i)
+            value |= uint32_t((unsigned char)bufferM[posM++]) << (8 * i);
+        return value;
+    }
+    int64_t readInt64()
+    {
+        if (!ensure(8))
+            return 0;
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i)
+            value |= uint64_t((unsigned char)bufferM[posM++]) << (8 * i);
+        return int64_t(value);
+    }
+    std::string readRawString()
+    {
+        uint32_t length = readUInt32();
+        if (!ensure(length))
+            return std::string();
+        std::string value(bufferM, posM, length);
+        posM += length;
+        return value;
+    }
+    wxString readString()
+    {
+        std::string s(readRawString());
+        return wxString::FromUTF8(s.data(), s.size());
+    }
+    // count of items that need at least minSize bytes each
+    uint32_t readCount(size_t minSize)
+    {
+        uint32_t count = readUInt32();
+        if (!errorM && count > (endM - posM) / minSize)
+            errorM = true;
+        return errorM ? 0 : count;
+    }
+    void readNames(wxArrayString& names)
+    {
+        uint32_t count = readCount(4);
+        names.Alloc(count);
+        for (uint32_t i = 0; i < count && !errorM; ++i)
+            names.Add(readString());
+    }
+};
+
+} // namespace
+
+MetadataSnapshot::ColumnData::ColumnData()
+    : nullable(true), hasDefault(false), initialValue(0), incrementValue(0)
+{
+}
+
+MetadataSnapshot::MetadataSnapshot(const wxString& key)
+    : keyM(key)
+{
+}
+
+std::string MetadataSnapshot::getFingerprint(Section section) const
+{
+    return fingerprintsM[section];
+}
+
+void MetadataSnapshot::setFingerprint(Section section,
+    const std::string& fingerprint)
+{
+    fingerprintsM[section] = fingerprint;
+}
+
+bool MetadataSnapshot::getNames(int type, wxArrayString& names,
+    wxArrayString& inactiveNames) const
+{
+    std::map<int, wxArrayString>::const_iterator it = namesM.find(type);
+    if (it == namesM.end())
+        return false;
+    names = it->second;
+    it = inactiveNamesM.find(type);
+    if (it != inactiveNamesM.end())
+        inactiveNames = it->second;
+    else
+        inactiveNames.clear();
+    return true;
+}
+
+void MetadataSnapshot::setNames(int type, const wxArrayString& names,
+    const wxArrayString& inactiveNames)
+{
+    namesM[type] = names;
+    inactiveNamesM[type] = inactiveNames;
+}
+
+const MetadataSnapshot::RelationColumns& MetadataSnapshot::getColumns() const
+{
+    return columnsM;
+}
+
+void MetadataSnapshot::setColumns(const wxString& relation,
+    const std::vector<ColumnData>& columns)
+{
+    columnsM[relation] = columns;
+}
+
+bool MetadataSnapshot::load(const wxString& fileName)
+{
+    wxFile file;
+    if (!wxFile::Exists(fileName) || !file.Open(fileName))
+        return false;
+    wxFileOffset length = file.Length();
+    if (length < 16)
+        return false;
+    std::string buffer;
+    buffer.resize(size_t(length));
+    if (file.Read(&buffer[0], buffer.size()) != ssize_t(buffer.size()))
+        return false;
+
+    // header, payload and the checksum of the payload
+    SnapshotReader header(buffer, 0, 8);
+    if (header.readUInt32() != snapshotMagic
+        || header.readUInt32() != snapshotVersion)
+    {
+        return false;
+    }
+    size_t end = buffer.size() - 4;
+    SnapshotReader trailer(buffer, end, buffer.size());
+    if (trailer.readUInt32() != getChecksum(buffer.data() + 8, end - 8))
+        return false;
+
+    SnapshotReader reader(buffer, 8, end);
+    if (reader.readString() != keyM)
+        return false;
+
+    std::string fingerprints[secCount];
+    if (reader.readUInt32() != secCount)
+        return false;
+    for (int i = 0; i < secCount; ++i)
+        fingerprints[i] = reader.readRawString();
+
+    std::map<int, wxArrayString> names, inactiveNames;
+    uint32_t count = reader.readCount(12);
+    for (uint32_t i = 0; i < count && !reader.hasError(); ++i)
+    {
+        int type = int(reader.readUInt32());
+        reader.readNames(names[type]);
+        reader.readNames(inactiveNames[type]);
+    }
+
+    RelationColumns columns;
+    count = reader.readCount(8);
+    for (uint32_t i = 0; i < count && !reader.hasError(); ++i)
+    {
+        std::vector<ColumnData>& relationColumns = columns[reader.readString()];
+        uint32_t columnCount = reader.readCount(44);
+        relationColumns.resize(columnCount);
+        for (uint32_t j = 0; j < columnCount && !reader.hasError(); ++j)
+        {
+            ColumnData& cd = relationColumns[j];
+            cd.name = reader.readString();
+            cd.source = reader.readString();
+            cd.computedSource = reader.readString();
+            cd.collation = reader.readString();
+            cd.defaultValue = reader.readString();
+            cd.identityType = reader.readString();
+            uint32_t flags = reader.readUInt32();
+            cd.nullable = (flags & 1) != 0;
+            cd.hasDefault = (flags & 2) != 0;
+            cd.initialValue = reader.readInt64();
+            cd.incrementValue = reader.readInt64();
+        }
+    }
+    if (reader.hasError() || !reader.atEnd())
+        return false;
+
+    for (int i = 0; i < secCount; ++i)
+        fingerprintsM[i] = fingerprints[i];
+    namesM.swap(names);
+    inactiveNamesM.swap(inactiveNames);
+    columnsM.swap(columns);
+    return true;
+}
+
+bool MetadataSnapshot::save(const wxString& fileName) const
+{
+    std::string buffer;
+    SnapshotWriter writer(buffer);
+    writer.writeUInt32(snapshotMagic);
+    writer.writeUInt32(snapshotVersion);
+    writer.writeString(keyM);
+
+    writer.writeUInt32(secCount);
+    for (int i = 0; i < secCount; ++i)
+        writer.writeString(fingerprintsM[i]);
+
+    writer.writeUInt32(uint32_t(namesM.size()));
+    for (std::map<int, wxArrayString>::const_iterator it = namesM.begin();
+        it != namesM.end(); ++it)
+    {
+        writer.writeUInt32(uint32_t(it->first));
+        writer.writeNames(it->second);
+        std::map<int, wxArrayString>::const_iterator itInactive
+            = inactiveNamesM.find(it->first);
+        writer.writeNames(itInactive != inactiveNamesM.end()
+            ? itInactive->second : wxArrayString());
+    }
+
+    writer.writeUInt32(uint32_t(columnsM.size()));
+    for (RelationColumns::const_iterator it = columnsM.begin();
+        it != columnsM.end(); ++it)
+    {
+        writer.writeString(it->first);
+        writer.writeUInt32(uint32_t(it->second.size()));
+        for (std::vector<ColumnData>::const_iterator itCol = it->second.begin();
+            itCol != it->second.end(); ++itCol)
+        {
+            writer.writeString(itCol->name);
+            writer.writeString(itCol->source);
+            writer.writeString(itCol->computedSource);
+            writer.writeString(itCol->collation);
+            writer.writeString(itCol->defaultValue);
+            writer.writeString(itCol->identityType);
+            writer.writeUInt32((itCol->nullable ? 1 : 0)
+                | (itCol->hasDefault ? 2 : 0));
+            writer.writeInt64(itCol->initialValue);
+            writer.writeInt64(itCol->incrementValue);
+        }
+    }
+    writer.writeUInt32(getChecksum(buffer.data() + 8, buffer.size() - 8));
+
+    // write to a temporary file first, so a snapshot is never left half
+    // written
+    wxString tempName(fileName + ".tmp");
+    {
+        wxFile file;
+        if (!file.Create(tempName, true))
+            return false;
+        if (file.Write(buffer.data(), buffer.size()) != buffer.size())
+        {
+            file.Close();
+            wxRemoveFile(tempName);
+            return false;
+        }
+    }
+    return wxRenameFile(tempName, fileName, true);
+}
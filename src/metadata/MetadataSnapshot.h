@@ -0,0 +1,95 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_METADATASNAPSHOT_H
+#define FR_METADATASNAPSHOT_H
+
+#include <wx/arrstr.h>
+#include <wx/string.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// MetadataSnapshot class
+// Compact binary copy of the metadata that is loaded when connecting to a
+// database: the names of the objects in the collections and the columns
+// of the relations. Every section is stored together with the fingerprint
+// of the system tables it was read from, so on the next connect only the
+// sections whose fingerprint has changed have to be read again.
+class MetadataSnapshot
+{
+public:
+    enum Section { secRelations, secRoutines, secTriggers, secIndices,
+        secOther, secCount };
+
+    // the values Column::initialize() is called with
+    struct ColumnData
+    {
+        wxString name;
+        wxString source;
+        wxString computedSource;
+        wxString collation;
+        wxString defaultValue;
+        wxString identityType;
+        bool nullable;
+        bool hasDefault;
+        int64_t initialValue;
+        int64_t incrementValue;
+
+        ColumnData();
+    };
+    typedef std::map<wxString, std::vector<ColumnData> > RelationColumns;
+private:
+    wxString keyM;
+    std::string fingerprintsM[secCount];
+    std::map<int, wxArrayString> namesM;
+    std::map<int, wxArrayString> inactiveNamesM;
+    RelationColumns columnsM;
+public:
+    // key identifies the database, snapshots of other databases aren't
+    // loaded
+    MetadataSnapshot(const wxString& key);
+
+    // a section without fingerprint isn't stored in the snapshot
+    std::string getFingerprint(Section section) const;
+    void setFingerprint(Section section, const std::string& fingerprint);
+
+    // names are stored by the node type of their collection
+    bool getNames(int type, wxArrayString& names,
+        wxArrayString& inactiveNames) const;
+    void setNames(int type, const wxArrayString& names,
+        const wxArrayString& inactiveNames = wxArrayString());
+
+    const RelationColumns& getColumns() const;
+    void setColumns(const wxString& relation,
+        const std::vector<ColumnData>& columns);
+
+    // returns false if the file doesn't exist, is damaged, was written by
+    // another version or belongs to another database
+    bool load(const wxString& fileName);
+    bool save(const wxString& fileName) const;
+};
+
+#endif // FR_METADATASNAPSHOT_H
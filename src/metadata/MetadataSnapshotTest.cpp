@@ -0,0 +1,201 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include "metadata/MetadataSnapshot.h"
+
+namespace
+{
+
+bool check(bool condition, const char* testName)
+{
+    if (condition)
+    {
+        std::cout << "  PASSED: " << testName << "\n";
+        return true;
+    }
+    std::cout << "  FAILED: " << testName << "\n";
+    return false;
+}
+
+const char* const fileName = "metadata_snapshot_test.frms";
+
+std::string readFile()
+{
+    std::ifstream in(fileName, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in),
+        std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string& content)
+{
+    std::ofstream out(fileName, std::ios::binary);
+    out << content;
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = true;
+    std::cout << "Running MetadataSnapshot Tests...\n";
+
+    const int tableType = 1, procedureType = 2;
+
+    // Test 1: everything that was stored is read back
+    {
+        MetadataSnapshot snapshot("GUID-1");
+        snapshot.setFingerprint(MetadataSnapshot::secRelations, "10/3/42");
+        snapshot.setFingerprint(MetadataSnapshot::secTriggers, "7/1");
+        wxArrayString names, inactive;
+        names.Add("CUSTOMERS");
+        names.Add(wxString::FromUTF8("K\xC3\x9CNDEN"));
+        names.Add("ORDERS");
+        inactive.Add("ORDERS");
+        snapshot.setNames(tableType, names, inactive);
+        snapshot.setNames(procedureType, wxArrayString());
+
+        std::vector<MetadataSnapshot::ColumnData> columns(2);
+        columns[0].name = "ID";
+        columns[0].source = "RDB$1";
+        columns[0].nullable = false;
+        columns[0].identityType = "ALWAYS";
+        columns[0].initialValue = -5;
+        columns[0].incrementValue = int64_t(1) << 40;
+        columns[1].name = "NAME";
+        columns[1].source = "D_NAME";
+        columns[1].collation = "UNICODE_CI";
+        columns[1].defaultValue = "'none'";
+        columns[1].hasDefault = true;
+        snapshot.setColumns("CUSTOMERS", columns);
+        ok = check(snapshot.save(fileName), "Snapshot saved") && ok;
+
+        MetadataSnapshot loaded("GUID-1");
+        ok = check(loaded.load(fileName), "Snapshot loaded") && ok;
+        ok = check(loaded.getFingerprint(MetadataSnapshot::secRelations) == "10/3/42"
+            && loaded.getFingerprint(MetadataSnapshot::secTriggers) == "7/1"
+            && loaded.getFingerprint(MetadataSnapshot::secOther).empty(),
+            "Fingerprints read back") && ok;
+        wxArrayString loadedNames, loadedInactive;
+        ok = check(loaded.getNames(tableType, loadedNames, loadedInactive)
+            && loadedNames.size() == 3 && loadedNames[1] == names[1]
+            && loadedInactive.size() == 1 && loadedInactive[0] == "ORDERS",
+            "Names read back") && ok;
+        ok = check(loaded.getNames(procedureType, loadedNames, loadedInactive)
+            && loadedNames.empty(), "Empty collection read back") && ok;
+        ok = check(!loaded.getNames(99, loadedNames, loadedInactive),
+            "Missing collection not found") && ok;
+
+        const MetadataSnapshot::RelationColumns& rc = loaded.getColumns();
+        MetadataSnapshot::RelationColumns::const_iterator it = rc.find("CUSTOMERS");
+        bool columnsOk = rc.size() == 1 && it != rc.end() && it->second.size() == 2;
+        if (columnsOk)
+        {
+            const MetadataSnapshot::ColumnData& id = it->second[0];
+            const MetadataSnapshot::ColumnData& name = it->second[1];
+            columnsOk = id.name == "ID" && id.source == "RDB$1" && !id.nullable
+                && id.identityType == "ALWAYS" && id.initialValue == -5
+                && id.incrementValue == int64_t(1) << 40
+                && name.collation == "UNICODE_CI" && name.hasDefault
+                && name.defaultValue == "'none'" && name.nullable;
+        }
+        ok = check(columnsOk, "Columns read back") && ok;
+    }
+
+    // Test 2: snapshots of other databases and damaged files are ignored
+    {
+        MetadataSnapshot other("GUID-2");
+        ok = check(!other.load(fileName), "Snapshot of another database ignored") && ok;
+
+        std::string content = readFile();
+        std::string damaged(content);
+        damaged[damaged.size() / 2] ^= 0x20;
+        writeFile(damaged);
+        MetadataSnapshot snapshot("GUID-1");
+        ok = check(!snapshot.load(fileName), "Damaged snapshot ignored") && ok;
+
+        writeFile(content.substr(0, content.size() - 7));
+        ok = check(!snapshot.load(fileName), "Truncated snapshot ignored") && ok;
+        ok = check(snapshot.getColumns().empty(),
+            "Failed load leaves snapshot unchanged") && ok;
+
+        std::remove(fileName);
+        ok = check(!snapshot.load(fileName), "Missing snapshot ignored") && ok;
+    }
+
+    // Test 3: a large schema
+    {
+        MetadataSnapshot snapshot("GUID-3");
+        const size_t relationCount = 20000;
+        wxArrayString names;
+        names.Alloc(relationCount);
+        std::vector<MetadataSnapshot::ColumnData> columns(10);
+        for (size_t i = 0; i < columns.size(); ++i)
+        {
+            columns[i].name = wxString::Format("COLUMN_%d", int(i));
+            columns[i].source = wxString::Format("RDB$%d", int(i));
+        }
+        for (size_t i = 0; i < relationCount; ++i)
+        {
+            names.Add(wxString::Format("TABLE_%06d", int(i)));
+            snapshot.setColumns(names.Last(), columns);
+        }
+        snapshot.setNames(tableType, names);
+        snapshot.setFingerprint(MetadataSnapshot::secRelations, "x");
+
+        auto start = std::chrono::steady_clock::now();
+        bool saved = snapshot.save(fileName);
+        auto saveMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        start = std::chrono::steady_clock::now();
+        MetadataSnapshot loaded("GUID-3");
+        bool loadOk = loaded.load(fileName);
+        auto loadMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cout << "  INFO: " << relationCount << " relations with "
+                  << columns.size() << " columns: " << readFile().size() / 1024
+                  << " KB, saved in " << saveMs << " ms, loaded in "
+                  << loadMs << " ms\n";
+        ok = check(saved && loadOk && loaded.getColumns().size() == relationCount,
+            "Large snapshot round trip") && ok;
+        std::remove(fileName);
+    }
+
+    std::cout << "MetadataSnapshot Tests completed: "
+              << (ok ? "ALL PASSED" : "SOME FAILED") << "\n";
+    return ok ? 0 : 1;
+}
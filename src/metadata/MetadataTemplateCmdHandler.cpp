@@ -77,17 +77,22 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
     struct Local
     {
         // Implements the body of all {%foreach%} loops.
+        // The text is expanded in place, the separator is removed again
+        // if it expands to nothing.
         static void foreachIteration(bool& firstItem,
             TemplateProcessor* tp, wxString& processedText,
-            wxString separator, wxString text, ProcessableObject* object)
+            const wxString& separator, const wxString& text,
+            ProcessableObject* object)
         {
-            wxString newText;
-            tp->internalProcessTemplateText(newText, text, object);
-            if ((!firstItem) && (!newText.IsEmpty()))
+            size_t start = processedText.length();
+            if (!firstItem)
                 processedText += separator;
-            if (!newText.IsEmpty())
+            size_t textStart = processedText.length();
+            tp->internalProcessTemplateText(processedText, text, object);
+            if (processedText.length() == textStart)
+                processedText.Truncate(start);
+            else
                 firstItem = false;
-            processedText += newText;
         }
     };
 
@@ -148,7 +153,8 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
     {
         wxString sep;
         tp->internalProcessTemplateText(sep, cmdParams[1], object);
-        
+        const wxString text(cmdParams.from(2));
+
         // {%foreach:column:<separator>:<text>%}
         // If the current object is a relation, processes <text> for each column.
         if (cmdParams[0] == "column")
@@ -161,7 +167,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
             for (ColumnPtrs::iterator it = r->begin(); it != r->end(); ++it)
             {
                 Local::foreachIteration(firstItem, tp, processedText, sep,
-                    cmdParams.from(2), (*it).get());
+                    text, (*it).get());
             }
         }
 
@@ -179,7 +185,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
             for (std::vector<ForeignKey>::iterator it = fks->begin(); it != fks->end(); ++it)
             {
                 Local::foreachIteration(firstItem, tp, processedText, sep,
-                    cmdParams.from(2), &(*it));
+                    text, &(*it));
             }
         }
 
@@ -197,7 +203,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
             for (std::vector<CheckConstraint>::iterator it = c->begin(); it != c->end(); ++it)
             {
                 Local::foreachIteration(firstItem, tp, processedText, sep,
-                    cmdParams.from(2), &(*it));
+                    text, &(*it));
             }
         }
 
@@ -215,7 +221,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
             for (std::vector<UniqueConstraint>::iterator it = c->begin(); it != c->end(); ++it)
             {
                 Local::foreachIteration(firstItem, tp, processedText, sep,
-                    cmdParams.from(2), &(*it));
+                    text, &(*it));
             }
         }
 
@@ -233,7 +239,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
             for (std::vector<Index>::iterator it = ix->begin(); it != ix->end(); ++it)
             {
                 Local::foreachIteration(firstItem, tp, processedText, sep,
-                    cmdParams.from(2), &(*it));
+                    text, &(*it));
             }
         }
 
@@ -244,6 +250,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
         // third param is ignored.
         else if ((cmdParams[0] == "trigger") && (cmdParams.Count() >= 4))
         {
+            const wxString filteredText(cmdParams.from(3));
             std::vector<Trigger*> triggers;
             
             Relation* r = dynamic_cast<Relation*>(object);
@@ -266,7 +273,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
                 it != triggers.end(); ++it)
             {
                 Local::foreachIteration(firstItem, tp, processedText, sep,
-                    cmdParams.from(3), *it);
+                    filteredText, *it);
             }
         }
 
@@ -276,6 +283,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
         // MEMBER OF).
         else if ((cmdParams[0] == "privilegeitem") && (cmdParams.Count() >= 4))
         {
+            const wxString filteredText(cmdParams.from(3));
             Privilege* p = dynamic_cast<Privilege*>(object);
             if (!p)
                 return;
@@ -285,7 +293,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
             for (PrivilegeItems::iterator it = list.begin(); it != list.end(); ++it)
             {
                 Local::foreachIteration(firstItem, tp, processedText, sep,
-                    cmdParams.from(3), &(*it));
+                    filteredText, &(*it));
             }
         }
 
@@ -326,7 +334,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
             for (std::vector<Privilege>::iterator it = p->begin(); it != p->end(); ++it)
             {
                 Local::foreachIteration(firstItem, tp, processedText, sep,
-                    cmdParams.from(2), &(*it));
+                    text, &(*it));
             }
         }
         // {%foreach:depends_on:<separator>:<text>%}
@@ -344,7 +352,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
             for (std::vector<Dependency>::iterator it = deps.begin(); it != deps.end(); ++it)
             {
                 Local::foreachIteration(firstItem, tp, processedText, sep,
-                    cmdParams.from(2), &(*it));
+                    text, &(*it));
             }
         }
         else if (cmdParams[0] == "fieldDependencyInfo") {
@@ -357,7 +365,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
             for (std::vector<DependencyField>::iterator it = depFields.begin(); it != depFields.end(); ++it)
             {
                 Local::foreachIteration(firstItem, tp, processedText, sep,
-                    cmdParams.from(2), &(*it));
+                    text, &(*it));
             }
         }
 
@@ -380,7 +388,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
             for (std::vector<Dependency>::iterator it = deps.begin(); it != deps.end(); ++it)
             {
                     Local::foreachIteration(firstItem, tp, processedText, sep,
-                        cmdParams.from(2), &(*it));
+                        text, &(*it));
             }
         }
 
@@ -389,6 +397,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
         // each "input" or "output" parameter.
         else if ((cmdParams[0] == "parameter") && (cmdParams.Count() >= 4))
         {
+            const wxString filteredText(cmdParams.from(3));
             Procedure* p = dynamic_cast<Procedure*>(object);
             Function* f = dynamic_cast<Function*>(object);
             if (p) {
@@ -401,7 +410,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
                     if ((*it)->isOutputParameter() == isOut)
                     {
                         Local::foreachIteration(firstItem, tp, processedText, sep,
-                            cmdParams.from(3), (*it).get());
+                            filteredText, (*it).get());
                     }
                 }
             }
@@ -415,7 +424,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
                     if ((*it)->isOutputParameter() == isOut)
                     {
                         Local::foreachIteration(firstItem, tp, processedText, sep,
-                            cmdParams.from(3), (*it).get());
+                            filteredText, (*it).get());
                     }
                 }
             }
@@ -425,6 +434,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
         // each "function" or "procedure" method.
         else if ((cmdParams[0] == "method") && (cmdParams.Count() >= 4))
         {
+            const wxString filteredText(cmdParams.from(3));
             Package* p = dynamic_cast<Package*>(object);
             if (p) {
                 SubjectLocker locker(p);
@@ -436,7 +446,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
                     //if ((*it)->isFunction() == isFunction)
                     {
                         Local::foreachIteration(firstItem, tp, processedText, sep,
-                            cmdParams.from(3), (*it).get());
+                            filteredText, (*it).get());
                     }
                 }
             }
@@ -466,7 +476,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
                     ++it)
                 {
                     Local::foreachIteration(firstItem, tp, processedText, sep,
-                        cmdParams.from(2), (*it).get());
+                        text, (*it).get());
                 }
             }
             else
@@ -479,7 +489,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
                     for (UserPtrs::iterator it = u->begin(); it != u->end(); ++it)
                     {
                         Local::foreachIteration(firstItem, tp, processedText, sep,
-                            cmdParams.from(2), (*it).get());
+                            text, (*it).get());
                     }
                 }
             }
@@ -497,7 +507,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
             {
                 TransactionInfoObject tio(info);
                 Local::foreachIteration(firstItem, tp, processedText, sep,
-                    cmdParams.from(2), &tio);
+                    text, &tio);
             }
         }
         // {%foreach:compiled_statement:<separator>:<text>%}
@@ -514,7 +524,7 @@ void MetadataTemplateCmdHandler::handleTemplateCmd(TemplateProcessor *tp,
             {
                 CompiledStatementInfoObject csio(info);
                 Local::foreachIteration(firstItem, tp, processedText, sep,
-                    cmdParams.from(2), &csio);
+                    text, &csio);
             }
         }
         // add more collections here.
@@ -0,0 +1,211 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+
+#include "metadata/SchemaSnapshot.h"
+
+namespace
+{
+
+const uint64_t fnvOffsetBasis = 14695981039346656037ULL;
+const uint64_t fnvPrime = 1099511628211ULL;
+
+inline void addByte(uint64_t& hash, unsigned char c)
+{
+    hash ^= c;
+    hash *= fnvPrime;
+}
+
+inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+} // namespace
+
+SchemaSnapshot::SchemaSnapshot()
+{
+}
+
+std::string SchemaSnapshot::makeKey(ObjectType type, const std::string& name,
+    const std::string& parent)
+{
+    // identifiers can't contain a zero byte
+    std::string key(1, char('A' + type));
+    key += parent;
+    key += '\0';
+    key += name;
+    return key;
+}
+
+void SchemaSnapshot::clear()
+{
+    objectsM.clear();
+    indexM.clear();
+}
+
+size_t SchemaSnapshot::addObject(ObjectType type, const std::string& name,
+    const std::string& parent)
+{
+    std::pair<std::unordered_map<std::string, size_t>::iterator, bool> r =
+        indexM.insert(std::make_pair(makeKey(type, name, parent),
+            objectsM.size()));
+    if (r.second)
+    {
+        Object o;
+        o.type = type;
+        o.name = name;
+        o.parent = parent;
+        o.hash = fnvOffsetBasis;
+        objectsM.push_back(o);
+    }
+    return r.first->second;
+}
+
+void SchemaSnapshot::addText(size_t object, const std::string& text)
+{
+    // leading and trailing whitespace is dropped, every other run of
+    // whitespace counts as one blank, so sources that only differ in line
+    // endings or the padding of CHAR columns get the same hash. Inside
+    // string literals and quoted identifiers every character counts
+    uint64_t& hash = objectsM[object].hash;
+    bool blank = false, started = false;
+    char quote = 0;
+    enum { inCode, inLineComment, inBlockComment } state = inCode;
+    std::string::const_iterator commentStart = text.end();
+    for (std::string::const_iterator it = text.begin(); it != text.end(); ++it)
+    {
+        char c = *it;
+        std::string::const_iterator next = it + 1;
+        if (quote)
+        {
+            if (c == quote)
+                quote = 0;
+        }
+        else if (state == inLineComment)
+        {
+            if (c == '\n')
+                state = inCode;
+        }
+        else if (state == inBlockComment)
+        {
+            // the "*" of "/*" doesn't end the comment
+            if (c == '*' && it != commentStart + 1 && next != text.end()
+                && *next == '/')
+            {
+                state = inCode;
+            }
+        }
+        else if (c == '\'' || c == '"')
+            quote = c;
+        else if (c == '-' && next != text.end() && *next == '-')
+            state = inLineComment;
+        else if (c == '/' && next != text.end() && *next == '*')
+        {
+            state = inBlockComment;
+            commentStart = it;
+        }
+
+        if (isBlank(c) && !quote)
+        {
+            blank = started;
+            continue;
+        }
+        if (blank)
+            addByte(hash, ' ');
+        addByte(hash, (unsigned char)c);
+        blank = false;
+        started = true;
+    }
+    // the end of every part, so "AB" + "C" differs from "A" + "BC"
+    addByte(hash, 0);
+}
+
+void SchemaSnapshot::addNull(size_t object)
+{
+    uint64_t& hash = objectsM[object].hash;
+    addByte(hash, 1);
+    addByte(hash, 0);
+}
+
+size_t SchemaSnapshot::getObjectCount() const
+{
+    return objectsM.size();
+}
+
+const SchemaSnapshot::Object& SchemaSnapshot::getObject(size_t object) const
+{
+    return objectsM[object];
+}
+
+size_t SchemaSnapshot::findObject(ObjectType type, const std::string& name,
+    const std::string& parent) const
+{
+    std::unordered_map<std::string, size_t>::const_iterator it =
+        indexM.find(makeKey(type, name, parent));
+    return (it == indexM.end()) ? npos : it->second;
+}
+
+void SchemaSnapshot::compare(const SchemaSnapshot& source,
+    const SchemaSnapshot& target, std::vector<Difference>& differences)
+{
+    differences.clear();
+    std::vector<bool> matched(target.objectsM.size(), false);
+    for (size_t i = 0; i < source.objectsM.size(); ++i)
+    {
+        const Object& o = source.objectsM[i];
+        size_t t = target.findObject(o.type, o.name, o.parent);
+        if (t != npos)
+        {
+            matched[t] = true;
+            if (target.objectsM[t].hash == o.hash)
+                continue;
+        }
+        Difference d = { o.type, i, t };
+        differences.push_back(d);
+    }
+    for (size_t t = 0; t < target.objectsM.size(); ++t)
+    {
+        if (!matched[t])
+        {
+            Difference d = { target.objectsM[t].type, npos, t };
+            differences.push_back(d);
+        }
+    }
+    // stable, so the order within every type is kept
+    std::stable_sort(differences.begin(), differences.end(),
+        [](const Difference& left, const Difference& right)
+        {
+            return left.type < right.type;
+        });
+}
@@ -0,0 +1,97 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_SCHEMASNAPSHOT_H
+#define FR_SCHEMASNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// SchemaSnapshot class
+// The user objects of one database as they are read from the system
+// tables, every object with a hash of its definition: source code and
+// the attributes of columns, parameters, domains and so on, with the
+// whitespace normalized. Two snapshots are compared by joining them on
+// type and name, only the objects whose hashes differ have to be loaded
+// into the metadata model to show or script the difference.
+// Snapshots don't use the metadata model or wxWidgets, so the snapshots
+// of two databases can be read on worker threads at the same time.
+class SchemaSnapshot
+{
+public:
+    // in the order the differences are reported
+    enum ObjectType { otDomain, otGenerator, otException, otTable, otColumn,
+        otIndex, otProcedure, otView, otTrigger, objectTypeCount };
+
+    // names are the identifiers as the connection returned them, trailing
+    // blanks removed; columns and indices have their relation as parent
+    struct Object
+    {
+        ObjectType type;
+        std::string name;
+        std::string parent;
+        uint64_t hash;
+    };
+
+    // an object that only one of the snapshots has, the other index is
+    // npos, or that has different hashes in both
+    struct Difference
+    {
+        ObjectType type;
+        size_t source;
+        size_t target;
+    };
+    static const size_t npos = size_t(-1);
+private:
+    std::vector<Object> objectsM;
+    std::unordered_map<std::string, size_t> indexM;
+
+    static std::string makeKey(ObjectType type, const std::string& name,
+        const std::string& parent);
+public:
+    SchemaSnapshot();
+
+    void clear();
+    // returns the object, which is added if it doesn't exist yet
+    size_t addObject(ObjectType type, const std::string& name,
+        const std::string& parent = std::string());
+    // adds a part of the definition of object to its hash
+    void addText(size_t object, const std::string& text);
+    void addNull(size_t object);
+
+    size_t getObjectCount() const;
+    const Object& getObject(size_t object) const;
+    // returns npos if there is no such object
+    size_t findObject(ObjectType type, const std::string& name,
+        const std::string& parent = std::string()) const;
+
+    // the differences ordered by type; for every type first the objects of
+    // source that are missing in target or differ, in the order they were
+    // added, then the objects that only target has
+    static void compare(const SchemaSnapshot& source,
+        const SchemaSnapshot& target, std::vector<Difference>& differences);
+};
+
+#endif // FR_SCHEMASNAPSHOT_H
@@ -0,0 +1,238 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <iostream>
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include "metadata/SchemaSnapshot.h"
+
+namespace
+{
+
+bool check(bool condition, const char* testName)
+{
+    if (condition)
+    {
+        std::cout << "  PASSED: " << testName << "\n";
+        return true;
+    }
+    std::cout << "  FAILED: " << testName << "\n";
+    return false;
+}
+
+typedef SchemaSnapshot Snapshot;
+
+size_t addObject(Snapshot& snapshot, Snapshot::ObjectType type,
+    const std::string& name, const std::string& text,
+    const std::string& parent = std::string())
+{
+    size_t object = snapshot.addObject(type, name, parent);
+    snapshot.addText(object, text);
+    return object;
+}
+
+bool sameHash(const std::string& one, const std::string& two)
+{
+    Snapshot s;
+    size_t a = addObject(s, Snapshot::otView, "A", one);
+    size_t b = addObject(s, Snapshot::otView, "B", two);
+    return s.getObject(a).hash == s.getObject(b).hash;
+}
+
+// the objects of source that target doesn't have or that differ, looked
+// up in target one by one
+size_t compareAll(const Snapshot& source, const Snapshot& target)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < source.getObjectCount(); ++i)
+    {
+        const Snapshot::Object& o = source.getObject(i);
+        bool same = false;
+        for (size_t t = 0; t < target.getObjectCount(); ++t)
+        {
+            const Snapshot::Object& other = target.getObject(t);
+            if (other.type == o.type && other.name == o.name
+                && other.parent == o.parent)
+            {
+                same = other.hash == o.hash;
+                break;
+            }
+        }
+        if (!same)
+            ++count;
+    }
+    return count;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = true;
+    std::cout << "Running SchemaSnapshot Tests...\n";
+
+    // Test 1: whitespace is normalized, parts and nulls are kept apart
+    {
+        ok = check(sameHash("select a,\r\n  b from t", "select a, b\tfrom t"),
+            "Runs of whitespace are one blank") && ok;
+        ok = check(sameHash("  as begin end  ", "as begin end"),
+            "Leading and trailing whitespace ignored") && ok;
+        ok = check(!sameHash("select a from t", "select b from t"),
+            "Different text") && ok;
+        ok = check(!sameHash("ab", "a b"), "Blank between words counts") && ok;
+        ok = check(!sameHash("x = 'a  b'", "x = 'a b'"),
+            "Whitespace in string literals counts") && ok;
+        ok = check(!sameHash("select \"A  B\" from t",
+            "select \"A B\" from t"),
+            "Whitespace in quoted identifiers counts") && ok;
+        ok = check(sameHash("x = 'it''s'  -- don't\n  y", "x = 'it''s' -- don't\ny"),
+            "Quotes in comments are ignored") && ok;
+        ok = check(sameHash("/*/ ' */  x", "/*/ ' */ x"),
+            "Quotes in block comments are ignored") && ok;
+
+        Snapshot s;
+        size_t a = s.addObject(Snapshot::otProcedure, "A");
+        s.addText(a, "AB");
+        s.addText(a, "C");
+        size_t b = s.addObject(Snapshot::otProcedure, "B");
+        s.addText(b, "A");
+        s.addText(b, "BC");
+        size_t c = s.addObject(Snapshot::otProcedure, "C");
+        s.addNull(c);
+        size_t d = s.addObject(Snapshot::otProcedure, "D");
+        s.addText(d, "");
+        ok = check(s.getObject(a).hash != s.getObject(b).hash,
+            "Parts are kept apart") && ok;
+        ok = check(s.getObject(c).hash != s.getObject(d).hash,
+            "Null differs from empty text") && ok;
+    }
+
+    // Test 2: objects are identified by type, parent and name
+    {
+        Snapshot s;
+        size_t t = s.addObject(Snapshot::otTable, "ORDERS");
+        ok = check(s.addObject(Snapshot::otTable, "ORDERS") == t
+            && s.getObjectCount() == 1, "Same object added once") && ok;
+        size_t c1 = s.addObject(Snapshot::otColumn, "ID", "ORDERS");
+        size_t c2 = s.addObject(Snapshot::otColumn, "ID", "CUSTOMERS");
+        s.addObject(Snapshot::otView, "ORDERS");
+        ok = check(c1 != c2 && s.getObjectCount() == 4, "Columns of different tables") && ok;
+        ok = check(s.findObject(Snapshot::otColumn, "ID", "CUSTOMERS") == c2
+            && s.findObject(Snapshot::otColumn, "ID") == Snapshot::npos
+            && s.findObject(Snapshot::otTable, "CUSTOMERS") == Snapshot::npos,
+            "Find object") && ok;
+    }
+
+    // Test 3: differences by type, missing and modified before extra
+    {
+        Snapshot source, target;
+        addObject(source, Snapshot::otProcedure, "P1", "begin end");
+        addObject(source, Snapshot::otProcedure, "P2", "begin suspend; end");
+        addObject(source, Snapshot::otTable, "T1", "");
+        addObject(source, Snapshot::otColumn, "C1", "INTEGER", "T1");
+        addObject(source, Snapshot::otColumn, "C2", "INTEGER", "T1");
+        addObject(source, Snapshot::otDomain, "D1", "");
+
+        addObject(target, Snapshot::otProcedure, "P3", "begin end");
+        addObject(target, Snapshot::otProcedure, "P1", "begin\n  end");
+        addObject(target, Snapshot::otProcedure, "P2", "begin end");
+        addObject(target, Snapshot::otColumn, "C2", "BIGINT", "T1");
+        addObject(target, Snapshot::otTable, "T1", "");
+        addObject(target, Snapshot::otColumn, "C3", "INTEGER", "T1");
+
+        std::vector<Snapshot::Difference> d;
+        Snapshot::compare(source, target, d);
+        bool order = d.size() == 6
+            && d[0].type == Snapshot::otDomain && d[0].target == Snapshot::npos
+            && d[1].type == Snapshot::otColumn && d[1].source == 3 && d[1].target == Snapshot::npos
+            && d[2].type == Snapshot::otColumn && d[2].source == 4 && d[2].target == 3
+            && d[3].type == Snapshot::otColumn && d[3].source == Snapshot::npos && d[3].target == 5
+            && d[4].type == Snapshot::otProcedure && d[4].source == 1 && d[4].target == 2
+            && d[5].type == Snapshot::otProcedure && d[5].source == Snapshot::npos && d[5].target == 0;
+        ok = check(order, "Differences in order") && ok;
+
+        Snapshot::compare(source, source, d);
+        ok = check(d.empty(), "No differences with itself") && ok;
+    }
+
+    // Test 4: two schemas of 2000 procedures and 10000 columns
+    {
+        const int objectCount = 2000;
+        Snapshot source, target;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < objectCount; ++i)
+        {
+            std::string name("PROC_" + std::to_string(i));
+            std::string body("begin\n  for select id, name from table_"
+                + std::to_string(i % 100) + " into :id, :name do\n    suspend;\nend");
+            addObject(source, Snapshot::otProcedure, name, body);
+            // every 10th procedure was changed in the target
+            addObject(target, Snapshot::otProcedure, name,
+                (i % 10 == 0) ? body + " " + "-- changed" : body);
+            std::string table("TABLE_" + std::to_string(i));
+            for (int c = 0; c < 5; ++c)
+            {
+                std::string column("COLUMN_" + std::to_string(c));
+                addObject(source, Snapshot::otColumn, column, "VARCHAR(50)", table);
+                addObject(target, Snapshot::otColumn, column, "VARCHAR(50)", table);
+            }
+        }
+        double buildMs = elapsedMs(start);
+
+        std::vector<Snapshot::Difference> d;
+        start = std::chrono::steady_clock::now();
+        Snapshot::compare(source, target, d);
+        double compareMs = elapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        size_t count = compareAll(source, target);
+        double scanMs = elapsedMs(start);
+
+        std::cout << "  INFO: " << source.getObjectCount()
+                  << " objects per snapshot built in " << buildMs
+                  << " ms, compared in " << compareMs
+                  << " ms, looking up every object takes " << scanMs << " ms\n";
+        ok = check(d.size() == size_t(objectCount / 10) && count == d.size(),
+            "Changed procedures found") && ok;
+        ok = check(compareMs * 5 < scanMs, "Hash join is at least 5x faster") && ok;
+    }
+
+    std::cout << "SchemaSnapshot Tests completed: "
+              << (ok ? "ALL PASSED" : "SOME FAILED") << "\n";
+    return ok ? 0 : 1;
+}
@@ -25,9 +25,11 @@
 #define FR_COLLECTION_H
 
 #include <algorithm>
+#include <cstdint>
 #include <iterator>
 #include <vector>
 #include <functional>
+#include <unordered_map>
 
 #include "metadata/database.h"
 
@@ -57,13 +59,26 @@ protected:
 
     struct InsertionPosByName
     {
-        wxString nameM;
-
-        InsertionPosByName(const wxString& name) : nameM(name) {}
-        bool operator()(const MetadataItemPtr item)
+        bool operator()(const wxString& name, const MetadataItemPtr item)
         {
             wxASSERT(item);
-            return item->getName_() > nameM;
+            return item->getName_() > name;
+        }
+    };
+
+    // FNV-1a hash of the identifier text, for the name index
+    struct IdentifierHash
+    {
+        size_t operator()(const wxString& text) const
+        {
+            uint64_t hash = 14695981039346656037ULL;
+            for (wxString::const_iterator it = text.begin(); it != text.end();
+                ++it)
+            {
+                hash ^= uint64_t(wxChar(*it));
+                hash *= 1099511628211ULL;
+            }
+            return size_t(hash);
         }
     };
 
@@ -87,32 +102,114 @@ public:
 private:
     CollectionType itemsM;
 
-    iterator getPosition(const wxString& name)
+    // the items by identifier text and by metadata id; kept up to date by
+    // insert() and remove(), rebuilt on demand after setItems(), because
+    // the loaders change the ids of existing items before calling it.
+    // Items renamed or given a new id in place are found again by
+    // rebuilding the index once after the change
+    std::unordered_map<wxString, ItemType, IdentifierHash> nameIndexM;
+    std::unordered_map<int, ItemType> idIndexM;
+    bool indexValidM;
+    unsigned indexKeyChangeCountM;
+
+    void addToIndex(const ItemType& item)
     {
-        Identifier id(name);
-        for (iterator it = itemsM.begin(); it != itemsM.end(); ++it)
+        // like the linear search did, the first of duplicate names wins
+        nameIndexM.emplace(item->getIdentifier().get(), item);
+        idIndexM.emplace(item->getMetadataId(), item);
+    }
+
+    void removeFromIndex(MetadataItem* item)
+    {
+        if (!indexValidM)
+            return;
+        typename std::unordered_map<wxString, ItemType, IdentifierHash>::iterator
+            itName = nameIndexM.find(item->getIdentifier().get());
+        if (itName != nameIndexM.end() && itName->second.get() == item)
+            nameIndexM.erase(itName);
+        typename std::unordered_map<int, ItemType>::iterator itId
+            = idIndexM.find(item->getMetadataId());
+        if (itId != idIndexM.end() && itId->second.get() == item)
+            idIndexM.erase(itId);
+        // a duplicate that was hidden by the removed item has to be found
+        // again
+        if (nameIndexM.size() + 1 < itemsM.size()
+            || idIndexM.size() + 1 < itemsM.size())
         {
-            if ((*it)->getIdentifier().equals(id))
-                return it;
+            indexValidM = false;
         }
-        return itemsM.end();
     }
 
-    iterator getPositionMetadataId(const int id)
+    void ensureIndexValid()
     {
+        if (indexValidM)
+            return;
+        nameIndexM.clear();
+        idIndexM.clear();
+        nameIndexM.reserve(itemsM.size());
+        idIndexM.reserve(itemsM.size());
         for (iterator it = itemsM.begin(); it != itemsM.end(); ++it)
+            addToIndex(*it);
+        indexValidM = true;
+        indexKeyChangeCountM = MetadataItem::getKeyChangeCount();
+    }
+
+    // rebuilds the index if any item has changed its key since it was
+    // built, returns false if it can't have changed
+    bool rebuildIndexAfterKeyChange()
+    {
+        if (indexKeyChangeCountM == MetadataItem::getKeyChangeCount())
+            return false;
+        indexValidM = false;
+        ensureIndexValid();
+        return true;
+    }
+
+    ItemType getByName(const wxString& name)
+    {
+        ensureIndexValid();
+        Identifier id(name);
+        typename std::unordered_map<wxString, ItemType, IdentifierHash>::iterator
+            it = nameIndexM.find(id.get());
+        if (it == nameIndexM.end() || !it->second->getIdentifier().equals(id))
         {
-            if ((*it)->getMetadataId() == id)
-                return it;
+            // an item may have been renamed in place, start over
+            if (!rebuildIndexAfterKeyChange())
+                return ItemType();
+            it = nameIndexM.find(id.get());
+            if (it == nameIndexM.end())
+                return ItemType();
         }
-        return itemsM.end();
+        return it->second;
+    }
 
+    ItemType getByMetadataId(const int id)
+    {
+        ensureIndexValid();
+        typename std::unordered_map<int, ItemType>::iterator it
+            = idIndexM.find(id);
+        if (it == idIndexM.end() || it->second->getMetadataId() != id)
+        {
+            if (!rebuildIndexAfterKeyChange())
+                return ItemType();
+            it = idIndexM.find(id);
+            if (it == idIndexM.end())
+                return ItemType();
+        }
+        return it->second;
+    }
+
+    iterator getInsertionPos(const wxString& name)
+    {
+        return std::upper_bound(itemsM.begin(), itemsM.end(), name,
+            InsertionPosByName());
     }
 
 protected:
     MetadataCollection(NodeType type, DatabasePtr database,
             const wxString& name)
-        : MetadataCollectionBase(type, database, name)
+        : MetadataCollectionBase(type, database, name), indexValidM(true),
+            indexKeyChangeCountM(MetadataItem::getKeyChangeCount())
     {
     }
 
@@ -121,11 +218,12 @@ public:
     // order of item names, and returns pointer to it
     ItemType insert(const wxString& name)
     {
-        iterator pos = std::find_if(itemsM.begin(), itemsM.end(),
-            InsertionPosByName(name));
+        iterator pos = getInsertionPos(name);
         ItemType item(new T(getDatabase(), name));
         initializeLockCount(item, getLockCount());
         itemsM.insert(pos, item);
+        if (indexValidM)
+            addToIndex(item);
         notifyObservers();
         return item;
     }
@@ -139,6 +237,7 @@ public:
             FindByAddress(item));
         if (pos != itemsM.end())
         {
+            removeFromIndex(item);
             itemsM.erase(pos);
             notifyObservers();
         }
@@ -146,9 +245,10 @@ public:
 
     void insertItem(ItemType item)
     {
-        iterator pos = std::find_if(itemsM.begin(), itemsM.end(),
-            InsertionPosByName(item->getName_()));
+        iterator pos = getInsertionPos(item->getName_());
         itemsM.insert(pos, item);
+        if (indexValidM)
+            addToIndex(item);
         notifyObservers();
     }
 
@@ -158,16 +258,13 @@ public:
         CollectionType newItems;
         for (size_t i = 0; i < names.size(); ++i)
         {
-            wxString itemName(names[i]);
-            iterator oldPos = getPosition(itemName);
-            if (oldPos == itemsM.end())
+            ItemType item = getByName(names[i]);
+            if (!item)
             {
-               ItemType item(new T(database, names[i]));
-                newItems.push_back(item);
+                item.reset(new T(database, names[i]));
                 initializeLockCount(item, getLockCount());
             }
-            else
-                newItems.push_back(*oldPos);
+            newItems.push_back(item);
         }
         setItems(newItems);
     }
@@ -185,6 +282,7 @@ public:
 
     void setItems(CollectionType items)
     {
+        indexValidM = false;
         if (itemsM != items)
         {
             itemsM = items;
@@ -217,20 +315,21 @@ public:
         if (!itemsM.empty())
         {
             itemsM.clear();
+            nameIndexM.clear();
+            idIndexM.clear();
+            indexValidM = true;
             notifyObservers();
         }
     };
 
     ItemType findByName(const wxString& name)
     {
-        iterator it = getPosition(name);
-        return (it != itemsM.end()) ? (*it) : ItemType();
+        return getByName(name);
     };
 
     ItemType findByMetadataId(const int id)
     {
-        iterator it = getPositionMetadataId(id);
-        return (it != itemsM.end()) ? (*it) : ItemType();
+        return getByMetadataId(id);
     }
 
     // returns vector of all subnodes
@@ -216,6 +216,27 @@ void Column::initialize(const wxString& source, const wxString& computedSource,
         notifyObservers();
 }
 
+void Column::initialize(const MetadataSnapshot::ColumnData& data)
+{
+    // the description is loaded on demand
+    initialize(data.source, data.computedSource, data.collation,
+        data.nullable, data.defaultValue, data.hasDefault, true,
+        data.identityType, data.initialValue, data.incrementValue);
+}
+
+void Column::getSnapshotData(MetadataSnapshot::ColumnData& data)
+{
+    data.name = getName_();
+    data.source = ColumnBase::getSource();
+    data.computedSource = computedSourceM;
+    data.collation = collationM;
+    data.hasDefault = getDefault(IgnoreDomainDefault, data.defaultValue);
+    data.nullable = isNullable(IgnoreDomainNullability);
+    data.identityType = identityTypeM;
+    data.initialValue = initialValueM;
+    data.incrementValue = incrementalValueM;
+}
+
 bool Column::isPrimaryKey() const
 {
     Table* t = getTable();
@@ -26,6 +26,7 @@
 #define FR_COLUMN_H
 
 #include "metadata/metadataitem.h"
+#include "metadata/MetadataSnapshot.h"
 
 enum GetColumnDefaultType { ReturnDomainDefault, IgnoreDomainDefault };
 enum GetColumnNullabilityType { CheckDomainNullability, IgnoreDomainNullability };
@@ -67,6 +68,9 @@ public:
         const wxString& collation, bool nullable,
         const wxString& defaultValue, bool hasDefault, bool hasDescription,
         const wxString& identityType, const int64_t initialValue, const int64_t incrementalValue);
+    // copy the values of initialize() from and to a metadata snapshot
+    void initialize(const MetadataSnapshot::ColumnData& data);
+    void getSnapshotData(MetadataSnapshot::ColumnData& data);
     virtual const wxString getTypeName() const;
     virtual wxString getDropSqlStatement() const;
 
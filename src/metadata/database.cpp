@@ -31,6 +31,7 @@
 #endif
 
 #include <wx/encconv.h>
+#include <wx/filename.h>
 #include <wx/fontmap.h>
 
 #include <algorithm>
@@ -60,6 +61,7 @@
 #include "metadata/generator.h"
 #include "metadata/Index.h"
 #include "metadata/MetadataItemVisitor.h"
+#include "metadata/MetadataSnapshot.h"
 #include "metadata/parameter.h"
 #include "metadata/package.h"
 #include "metadata/procedure.h"
@@ -581,6 +583,458 @@ void Database::loadGeneratorValues()
     }
 }
 
+void Database::loadRelationDetails(ProgressIndicator* progressIndicator)
+{
+    ensureChildrenLoaded();
+
+    const Table::DetailKind kinds[] = { Table::dkPrimaryKey,
+        Table::dkUniqueConstraints, Table::dkForeignKeys,
+        Table::dkCheckConstraints, Table::dkIndices };
+    const size_t kindCount = sizeof(kinds) / sizeof(kinds[0]);
+    if (progressIndicator)
+    {
+        progressIndicator->initProgress(_("Loading columns..."),
+            kindCount + 1, 0, 1);
+    }
+
+    DatabasePtr me = getDatabase();
+    MetadataLoader* loader = getMetadataLoader();
+    // first start a transaction for metadata loading, then lock the database
+    // when objects go out of scope and are destroyed, database will be
+    // unlocked before the transaction is committed - any update() calls on
+    // observers can possibly use the same transaction
+    MetadataLoaderTransaction tr(loader);
+    SubjectLocker lock(this);
+    wxMBConv* converter = getCharsetConverter();
+
+    // the rows of all relations are ordered by relation name, so every
+    // relation is looked up only once
+    fr::IStatementPtr& st1 = loader->getStatement(
+        Relation::getColumnsSql(me, true));
+    st1->execute();
+    int nameIndex = st1->getColumnCount() - 1;
+    std::string lastName;
+    Relation* relation = 0;
+    bool found = false;
+    ColumnPtrs columns;
+    while (st1->fetch())
+    {
+        std::string name = st1->getString(nameIndex);
+        if (!found || name != lastName)
+        {
+            checkProgressIndicatorCanceled(progressIndicator);
+            if (relation)
+                relation->setColumns(columns);
+            columns.clear();
+            lastName = name;
+            found = true;
+            relation = findRelation(Identifier(std2wxIdentifier(name,
+                converter)));
+        }
+        if (relation)
+            relation->readColumn(st1, converter, columns);
+    }
+    if (relation)
+        relation->setColumns(columns);
+
+    std::vector<Table*> tables;
+    for (Tables::iterator it = tablesM->begin(); it != tablesM->end(); ++it)
+        tables.push_back((*it).get());
+    for (SysTables::iterator it = sysTablesM->begin();
+        it != sysTablesM->end(); ++it)
+    {
+        tables.push_back((*it).get());
+    }
+    if (GTTablesM)
+    {
+        for (GTTables::iterator it = GTTablesM->begin();
+            it != GTTablesM->end(); ++it)
+        {
+            tables.push_back((*it).get());
+        }
+    }
+
+    for (size_t i = 0; i < kindCount; ++i)
+    {
+        if (progressIndicator)
+        {
+            progressIndicator->initProgress(_("Loading constraints and indices..."),
+                kindCount + 1, i + 1, 1);
+        }
+        for (std::vector<Table*>::iterator it = tables.begin();
+            it != tables.end(); ++it)
+        {
+            (*it)->resetDetails(kinds[i]);
+        }
+
+        fr::IStatementPtr& st2 = loader->getStatement(
+            Table::getDetailsSql(me, kinds[i], true));
+        st2->execute();
+        nameIndex = st2->getColumnCount() - 1;
+        Table* table = 0;
+        found = false;
+        while (st2->fetch())
+        {
+            std::string name = st2->getString(nameIndex);
+            if (!found || name != lastName)
+            {
+                checkProgressIndicatorCanceled(progressIndicator);
+                lastName = name;
+                found = true;
+                table = dynamic_cast<Table*>(findRelation(
+                    Identifier(std2wxIdentifier(name, converter))));
+            }
+            if (table)
+                table->readDetails(kinds[i], st2, converter);
+        }
+
+        for (std::vector<Table*>::iterator it = tables.begin();
+            it != tables.end(); ++it)
+        {
+            (*it)->setDetailsLoaded(kinds[i]);
+        }
+    }
+}
+
+namespace
+{
+
+// the descriptions of the objects in one system table, by the names of
+// the parent (empty for objects without one) and of the object
+typedef std::map<std::pair<wxString, wxString>, wxString> Descriptions;
+
+void loadDescriptionsOf(MetadataLoader* loader, wxMBConv* converter,
+    const std::string& sql, bool withParent, Descriptions& descriptions)
+{
+    fr::IStatementPtr& st = loader->getStatement(sql);
+    st->execute();
+    int descriptionIndex = withParent ? 2 : 1;
+    while (st->fetch())
+    {
+        if (st->isNull(descriptionIndex))
+            continue;
+        wxString parent;
+        if (withParent)
+            parent = std2wxIdentifier(st->getString(0), converter);
+        wxString name(std2wxIdentifier(st->getString(withParent ? 1 : 0),
+            converter));
+        std::string value = st->getString(descriptionIndex);
+        descriptions[std::make_pair(parent, name)] =
+            wxString(value.c_str(), *converter);
+    }
+}
+
+wxString findDescription(const Descriptions& descriptions,
+    const wxString& parent, const wxString& name)
+{
+    Descriptions::const_iterator it = descriptions.find(
+        std::make_pair(parent, name));
+    return it != descriptions.end() ? it->second : wxString();
+}
+
+// objects without a description get an empty one, as they would if it
+// was loaded for each of them
+template<class T>
+void setDescriptions(T* collection, const Descriptions& descriptions)
+{
+    for (typename T::iterator it = collection->begin();
+        it != collection->end(); ++it)
+    {
+        (*it)->setLoadedDescription(findDescription(descriptions,
+            wxEmptyString, (*it)->getName_()));
+    }
+}
+
+template<class T>
+void setColumnDescriptions(T* collection, const Descriptions& descriptions)
+{
+    for (typename T::iterator it = collection->begin();
+        it != collection->end(); ++it)
+    {
+        if (!(*it)->childrenLoaded())
+            continue;
+        for (ColumnPtrs::iterator itCol = (*it)->begin();
+            itCol != (*it)->end(); ++itCol)
+        {
+            (*itCol)->setLoadedDescription(findDescription(descriptions,
+                (*it)->getName_(), (*itCol)->getName_()));
+        }
+    }
+}
+
+} // namespace
+
+void Database::loadDescriptions(ProgressIndicator* progressIndicator)
+{
+    ensureChildrenLoaded();
+    bool ods11_1 = getInfo().getODSVersionIsHigherOrEqualTo(11, 1);
+    bool ods12 = getInfo().getODSVersionIsHigherOrEqualTo(12, 0);
+    // the collections have to be loaded before the database is locked
+    TablesPtr tables(getTables());
+    GTTablesPtr gtTables(ods11_1 ? getGTTables() : GTTablesPtr());
+    ViewsPtr views(getViews());
+    ProceduresPtr procedures(getProcedures());
+    FunctionSQLsPtr functions(ods12 ? getFunctionSQLs() : FunctionSQLsPtr());
+    UDFsPtr udfs(getUDFs());
+    PackagesPtr packages(ods12 ? getPackages() : PackagesPtr());
+    GeneratorsPtr generators(getGenerators());
+    ExceptionsPtr exceptions(getExceptions());
+    DomainsPtr domains(getDomains());
+    RolesPtr roles(getRoles());
+    CollationsPtr collations(getCollations());
+    DMLTriggersPtr dmlTriggers(getDMLTriggers());
+    DBTriggersPtr dbTriggers(ods11_1 ? getDBTriggers() : DBTriggersPtr());
+    DDLTriggersPtr ddlTriggers(ods12 ? getDDLTriggers() : DDLTriggersPtr());
+
+    const int stepCount = 11;
+    int step = 0;
+    if (progressIndicator)
+    {
+        progressIndicator->initProgress(_("Loading descriptions..."),
+            stepCount, 0, 1);
+    }
+
+    MetadataLoader* loader = getMetadataLoader();
+    MetadataLoaderTransaction tr(loader);
+    SubjectLocker lock(this);
+    wxMBConv* converter = getCharsetConverter();
+    // objects in packages have descriptions of their own
+    const std::string notInPackage(ods12
+        ? " and RDB$PACKAGE_NAME is null" : "");
+
+    struct Local
+    {
+        static void step(ProgressIndicator* progressIndicator, int& step,
+            int stepCount)
+        {
+            checkProgressIndicatorCanceled(progressIndicator);
+            if (progressIndicator)
+            {
+                progressIndicator->initProgress(_("Loading descriptions..."),
+                    stepCount, ++step, 1);
+            }
+        }
+    };
+
+    Descriptions d;
+    loadDescriptionsOf(loader, converter,
+        "select RDB$RELATION_NAME, RDB$DESCRIPTION from RDB$RELATIONS "
+        "where RDB$DESCRIPTION is not null", false, d);
+    setDescriptions(tables.get(), d);
+    if (gtTables)
+        setDescriptions(gtTables.get(), d);
+    setDescriptions(views.get(), d);
+    Local::step(progressIndicator, step, stepCount);
+
+    d.clear();
+    loadDescriptionsOf(loader, converter,
+        "select RDB$RELATION_NAME, RDB$FIELD_NAME, RDB$DESCRIPTION "
+        "from RDB$RELATION_FIELDS where RDB$DESCRIPTION is not null", true, d);
+    setColumnDescriptions(tables.get(), d);
+    if (gtTables)
+        setColumnDescriptions(gtTables.get(), d);
+    setColumnDescriptions(views.get(), d);
+    Local::step(progressIndicator, step, stepCount);
+
+    d.clear();
+    loadDescriptionsOf(loader, converter,
+        "select RDB$PROCEDURE_NAME, RDB$DESCRIPTION from RDB$PROCEDURES "
+        "where RDB$DESCRIPTION is not null" + notInPackage, false, d);
+    setDescriptions(procedures.get(), d);
+    Local::step(progressIndicator, step, stepCount);
+
+    d.clear();
+    loadDescriptionsOf(loader, converter,
+        "select RDB$FUNCTION_NAME, RDB$DESCRIPTION from RDB$FUNCTIONS "
+        "where RDB$DESCRIPTION is not null" + notInPackage, false, d);
+    setDescriptions(udfs.get(), d);
+    if (functions)
+        setDescriptions(functions.get(), d);
+    Local::step(progressIndicator, step, stepCount);
+
+    if (packages)
+    {
+        d.clear();
+        loadDescriptionsOf(loader, converter,
+            "select RDB$PACKAGE_NAME, RDB$DESCRIPTION from RDB$PACKAGES "
+            "where RDB$DESCRIPTION is not null", false, d);
+        setDescriptions(packages.get(), d);
+    }
+    Local::step(progressIndicator, step, stepCount);
+
+    d.clear();
+    loadDescriptionsOf(loader, converter,
+        "select RDB$GENERATOR_NAME, RDB$DESCRIPTION from RDB$GENERATORS "
+        "where RDB$DESCRIPTION is not null", false, d);
+    setDescriptions(generators.get(), d);
+    Local::step(progressIndicator, step, stepCount);
+
+    d.clear();
+    loadDescriptionsOf(loader, converter,
+        "select RDB$EXCEPTION_NAME, RDB$DESCRIPTION from RDB$EXCEPTIONS "
+        "where RDB$DESCRIPTION is not null", false, d);
+    setDescriptions(exceptions.get(), d);
+    Local::step(progressIndicator, step, stepCount);
+
+    d.clear();
+    loadDescriptionsOf(loader, converter,
+        "select RDB$FIELD_NAME, RDB$DESCRIPTION from RDB$FIELDS "
+        "where RDB$DESCRIPTION is not null", false, d);
+    setDescriptions(domains.get(), d);
+    Local::step(progressIndicator, step, stepCount);
+
+    // roles have descriptions since Firebird 2.0
+    if (getInfo().getODSVersionIsHigherOrEqualTo(11))
+    {
+        d.clear();
+        loadDescriptionsOf(loader, converter,
+            "select RDB$ROLE_NAME, RDB$DESCRIPTION from RDB$ROLES "
+            "where RDB$DESCRIPTION is not null", false, d);
+        setDescriptions(roles.get(), d);
+    }
+    Local::step(progressIndicator, step, stepCount);
+
+    d.clear();
+    loadDescriptionsOf(loader, converter,
+        "select RDB$COLLATION_NAME, RDB$DESCRIPTION from RDB$COLLATIONS "
+        "where RDB$DESCRIPTION is not null", false, d);
+    setDescriptions(collations.get(), d);
+    Local::step(progressIndicator, step, stepCount);
+
+    d.clear();
+    loadDescriptionsOf(loader, converter,
+        "select RDB$TRIGGER_NAME, RDB$DESCRIPTION from RDB$TRIGGERS "
+        "where RDB$DESCRIPTION is not null", false, d);
+    setDescriptions(dmlTriggers.get(), d);
+    if (dbTriggers)
+        setDescriptions(dbTriggers.get(), d);
+    if (ddlTriggers)
+        setDescriptions(ddlTriggers.get(), d);
+    Local::step(progressIndicator, step, stepCount);
+}
+
+void Database::getViewsInDependencyOrder(std::vector<View*>& views)
+{
+    ViewsPtr all(getViews());
+    const DependencyGraph& graph = getDependencyGraph();
+    std::vector<View*> list;
+    std::vector<size_t> objects;
+    for (Views::iterator it = all->begin(); it != all->end(); ++it)
+    {
+        list.push_back((*it).get());
+        objects.push_back(graph.findObject(1, (*it)->getName_()));
+    }
+
+    // depth first in the order of the collection, so views without
+    // dependencies stay where they are
+    std::vector<size_t> order;
+    graph.getCreationOrder(objects, DependencyGraph::kAllFlags, order);
+    views.clear();
+    for (size_t i = 0; i < order.size(); ++i)
+        views.push_back(list[order[i]]);
+}
+
+const DependencyGraph& Database::getDependencyGraph()
+{
+    if (!dependencyGraphM.isBuilt())
+        loadDependencyGraph();
+    return dependencyGraphM;
+}
+
+void Database::loadDependencyGraph()
+{
+    dependencyGraphM.clear();
+
+    MetadataLoader* loader = getMetadataLoader();
+    MetadataLoaderTransaction tr(loader);
+    SubjectLocker lock(this);
+    wxMBConv* converter = getCharsetConverter();
+
+    // RDB$DEPENDENCIES and the dependencies MetadataItem::getDependencies()
+    // used to add for every object: relations depend on what their computed
+    // columns and check constraints use, views on the columns they select;
+    // views that other objects use as relations get the type of views
+    const std::string both(std::to_string(
+        DependencyGraph::kDependsOn | DependencyGraph::kDependentOf));
+    std::string sql(
+        "select case when r1.rdb$relation_name is null then t.dependent_type "
+        "else 1 end, t.dependent_name, "
+        "case when r2.rdb$relation_name is null then t.depended_on_type "
+        "else 1 end, t.depended_on_name, t.field_name, t.flags, "
+        "f1.rdb$field_position, f2.rdb$field_position from ( "
+        "select d.rdb$dependent_type, d.rdb$dependent_name, "
+        "d.rdb$depended_on_type, d.rdb$depended_on_name, d.rdb$field_name, "
+        "cast(" + both + " as smallint) "
+        "from rdb$dependencies d "
+        "union all "
+        "select cast(0 as smallint), f.rdb$relation_name, "
+        "d.rdb$depended_on_type, d.rdb$depended_on_name, d.rdb$field_name, "
+        "cast(" + std::to_string(DependencyGraph::kDependsOn) + " as smallint) "
+        "from rdb$relation_fields f "
+        "join rdb$dependencies d on d.rdb$dependent_name = f.rdb$field_source "
+        "where d.rdb$dependent_type = 3 "
+        "union all "
+        "select cast(0 as smallint), f.rdb$relation_name, "
+        "d.rdb$depended_on_type, d.rdb$depended_on_name, f.rdb$field_name, "
+        "cast(" + std::to_string(DependencyGraph::kDependentOf) + " as smallint) "
+        "from rdb$relation_fields f "
+        "join rdb$dependencies d on d.rdb$dependent_name = f.rdb$field_source "
+        "where d.rdb$dependent_type = 3 "
+        "union all "
+        "select cast(1 as smallint), vr.rdb$view_name, cast(0 as smallint), "
+        "vr.rdb$relation_name, f.rdb$base_field, cast(" + both + " as smallint) "
+        "from rdb$relation_fields f "
+        "join rdb$view_relations vr on f.rdb$view_context = vr.rdb$view_context "
+        "and f.rdb$relation_name = vr.rdb$view_name "
+        "union all "
+        "select cast(0 as smallint), r.rdb$relation_name, "
+        "d.rdb$depended_on_type, d.rdb$depended_on_name, d.rdb$field_name, "
+        "cast(" + both + " as smallint) "
+        "from rdb$relation_constraints r "
+        "join rdb$check_constraints c on r.rdb$constraint_name = c.rdb$constraint_name "
+        "join rdb$dependencies d on d.rdb$dependent_name = c.rdb$trigger_name "
+        "and d.rdb$dependent_type = 2 "
+        "where r.rdb$constraint_type = 'CHECK' "
+        "and r.rdb$relation_name <> d.rdb$depended_on_name "
+        "union all "
+        "select cast(0 as smallint), r1.rdb$relation_name, cast(0 as smallint), "
+        "r2.rdb$relation_name, cast(null as char(1)), "
+        "cast(" + std::to_string(DependencyGraph::kForeignKey) + " as smallint) "
+        "from rdb$relation_constraints r1 "
+        "join rdb$ref_constraints c on r1.rdb$constraint_name = c.rdb$constraint_name "
+        "join rdb$relation_constraints r2 on c.rdb$const_name_uq = r2.rdb$constraint_name "
+        "where r1.rdb$constraint_type = 'FOREIGN KEY' "
+        ") t (dependent_type, dependent_name, depended_on_type, "
+        "depended_on_name, field_name, flags) "
+        "left join rdb$relations r1 on t.dependent_type = 0 "
+        "and r1.rdb$relation_name = t.dependent_name "
+        "and r1.rdb$view_blr is not null "
+        "left join rdb$relations r2 on t.depended_on_type = 0 "
+        "and r2.rdb$relation_name = t.depended_on_name "
+        "and r2.rdb$view_blr is not null "
+        "left join rdb$relation_fields f1 on f1.rdb$relation_name = t.dependent_name "
+        "and f1.rdb$field_name = t.field_name "
+        "left join rdb$relation_fields f2 on f2.rdb$relation_name = t.depended_on_name "
+        "and f2.rdb$field_name = t.field_name");
+
+    fr::IStatementPtr& st = loader->getStatement(sql);
+    st->execute();
+    while (st->fetch())
+    {
+        size_t dependent = dependencyGraphM.addObject(st->getInt32(0),
+            std2wxIdentifier(st->getString(1), converter));
+        size_t dependedOn = dependencyGraphM.addObject(st->getInt32(2),
+            std2wxIdentifier(st->getString(3), converter));
+        wxString field;
+        if (!st->isNull(4))
+            field = std2wxIdentifier(st->getString(4), converter);
+        dependencyGraphM.addDependency(dependent, dependedOn, field,
+            st->isNull(6) ? 0 : st->getInt32(6),
+            st->isNull(7) ? 0 : st->getInt32(7), st->getInt32(5));
+    }
+    dependencyGraphM.build();
+}
+
 DatabasePtr Database::getDatabase() const
 {
     return (const_cast<Database*>(this))->shared_from_this();
@@ -901,6 +1355,9 @@ void Database::parseCommitedSql(const SqlStatement& stm)
         return;
     }
 
+    // any other DDL can add or remove dependencies
+    dependencyGraphM.clear();
+
     if (stm.actionIs(actDROP, ntIndex))
     {
         // the affected table will recognize its index (if loaded)
@@ -1145,7 +1602,7 @@ void Database::drop()
     setDisconnected();
 }
 
-void Database::reconnect()
+void Database::reconnect(const wxString& password)
 {
     // Fully tear down the existing connection state first so that connect()
     // does not early-return because connectedM is still true.  setDisconnected()
@@ -1157,7 +1614,7 @@ void Database::reconnect()
     setDisconnected();
     // connect() checks connectedM, which is now false, so it will proceed with
     // a full connection including reinitialising all metadata collections.
-    connect(getDecryptedPassword());
+    connect(password.empty() ? getDecryptedPassword() : password);
 }
 
 // the caller of this function should check whether the database object has the
@@ -1325,7 +1782,8 @@ void Database::connect(const wxString& password, ProgressIndicator* indicator)
 
                 // load collections of metadata objects
                 setChildrenLoaded(false);
-                loadCollections(indicator);
+                std::unique_ptr<MetadataSnapshot> snapshot(loadSnapshot());
+                loadCollections(indicator, snapshot.get());
                 setChildrenLoaded(true);
                 if (indicator)
                     indicator->initProgress(_("Complete"), 1, 1);
@@ -1459,7 +1917,8 @@ void Database::loadTriggerCollections(ProgressIndicator* progressIndicator)
     }
 }
 
-void Database::loadCollections(ProgressIndicator* progressIndicator)
+void Database::loadCollections(ProgressIndicator* progressIndicator,
+    const MetadataSnapshot* snapshot)
 {
     // use a small helper to cut down on the repetition...
     struct ProgressIndicatorHelper
@@ -1487,40 +1946,69 @@ void Database::loadCollections(ProgressIndicator* progressIndicator)
     MetadataLoader* loader = getMetadataLoader();
     MetadataLoaderTransaction tr(loader);
     SubjectLocker lock(this);
+    dependencyGraphM.clear();
 
-    pih.init(_("Relations (Tables, Views, etc.)"), collectionCount, 0);
-    loadRelationCollections(progressIndicator);
+    // sections of the snapshot that are still valid don't need to be read
+    bool restored[MetadataSnapshot::secCount] = {};
+    if (snapshot)
+    {
+        pih.init(_("metadata snapshot"), collectionCount, 0);
+        for (int i = 0; i < MetadataSnapshot::secCount; ++i)
+            restored[i] = restoreSnapshotSection(*snapshot, i);
+    }
+    bool isODS12 = getInfo().getODSVersionIsHigherOrEqualTo(12, 0);
 
-    pih.init(_("procedures"), collectionCount, 1);
-    proceduresM->load(progressIndicator);
+    if (!restored[MetadataSnapshot::secRelations])
+    {
+        pih.init(_("Relations (Tables, Views, etc.)"), collectionCount, 0);
+        loadRelationCollections(progressIndicator);
+    }
 
-    pih.init(_("Triggers (DML, DB, DDL)"), collectionCount, 2);
-    loadTriggerCollections(progressIndicator);
+    if (!restored[MetadataSnapshot::secRoutines])
+    {
+        pih.init(_("procedures"), collectionCount, 1);
+        proceduresM->load(progressIndicator);
+    }
 
-    pih.init(_("roles"), collectionCount, 3);
-    rolesM->load(progressIndicator);
+    if (!restored[MetadataSnapshot::secTriggers])
+    {
+        pih.init(_("Triggers (DML, DB, DDL)"), collectionCount, 2);
+        loadTriggerCollections(progressIndicator);
+    }
 
-    pih.init(_("system roles"), collectionCount, 4);
-    sysRolesM->load(progressIndicator);
+    if (!restored[MetadataSnapshot::secOther])
+    {
+        pih.init(_("roles"), collectionCount, 3);
+        rolesM->load(progressIndicator);
 
-    pih.init(_("domains"), collectionCount, 5);
-    userDomainsM->load(progressIndicator);
+        pih.init(_("system roles"), collectionCount, 4);
+        sysRolesM->load(progressIndicator);
 
-    if (getInfo().getODSVersionIsHigherOrEqualTo(12, 0)) {
-        pih.init(_("functions SQL"), collectionCount, 6);
-        functionSQLsM->load(progressIndicator);
+        pih.init(_("domains"), collectionCount, 5);
+        userDomainsM->load(progressIndicator);
     }
 
-    pih.init(_("functions UDF"), collectionCount, 7);
-    UDFsM->load(progressIndicator);
+    if (!restored[MetadataSnapshot::secRoutines])
+    {
+        if (isODS12) {
+            pih.init(_("functions SQL"), collectionCount, 6);
+            functionSQLsM->load(progressIndicator);
+        }
 
-    pih.init(_("generators"), collectionCount, 8);
-    generatorsM->load(progressIndicator);
+        pih.init(_("functions UDF"), collectionCount, 7);
+        UDFsM->load(progressIndicator);
+    }
+
+    if (!restored[MetadataSnapshot::secOther])
+    {
+        pih.init(_("generators"), collectionCount, 8);
+        generatorsM->load(progressIndicator);
+    }
 
     pih.init(_("exceptions"), collectionCount, 9);
     exceptionsM->load(progressIndicator);
 
-    if (getInfo().getODSVersionIsHigherOrEqualTo(12, 0)) {
+    if (isODS12 && !restored[MetadataSnapshot::secRoutines]) {
         pih.init(_("packages"), collectionCount, 10);
         packagesM->load(progressIndicator);
 
@@ -1528,19 +2016,25 @@ void Database::loadCollections(ProgressIndicator* progressIndicator)
         sysPackagesM->load(progressIndicator);
     }
 
-    pih.init(_("system domains"), collectionCount, 12);
-    sysDomainsM->load(progressIndicator);
+    if (!restored[MetadataSnapshot::secOther])
+    {
+        pih.init(_("system domains"), collectionCount, 12);
+        sysDomainsM->load(progressIndicator);
+    }
 
-    pih.init(_("indexes"), collectionCount, 13);
-    indicesM->load(progressIndicator);
+    if (!restored[MetadataSnapshot::secIndices])
+    {
+        pih.init(_("indexes"), collectionCount, 13);
+        indicesM->load(progressIndicator);
 
-    pih.init(_("system indices"), collectionCount, 14);
-    sysIndicesM->load(progressIndicator);
+        pih.init(_("system indices"), collectionCount, 14);
+        sysIndicesM->load(progressIndicator);
 
-    pih.init(_("indexes"), collectionCount, 15);
-    usrIndicesM->load(progressIndicator);
+        pih.init(_("indexes"), collectionCount, 15);
+        usrIndicesM->load(progressIndicator);
+    }
 
-    if (getInfo().getODSVersionIsHigherOrEqualTo(12, 0)) {
+    if (isODS12) {
         pih.init(_("users"), collectionCount, 16);
         usersM->load(progressIndicator);
     }
@@ -1553,6 +2047,356 @@ void Database::loadCollections(ProgressIndicator* progressIndicator)
 
 }
 
+namespace
+{
+
+template<class T>
+bool restoreNames(const MetadataSnapshot& snapshot, T* collection)
+{
+    if (!collection)
+        return true;
+    wxArrayString names, inactiveNames;
+    if (!snapshot.getNames(collection->getType(), names, inactiveNames))
+        return false;
+    collection->setItems(names);
+    return true;
+}
+
+// for collections of items that can be inactive (triggers and indices)
+template<class T>
+bool restoreNamesAndInactive(const MetadataSnapshot& snapshot, T* collection)
+{
+    if (!collection)
+        return true;
+    wxArrayString names, inactiveNames;
+    if (!snapshot.getNames(collection->getType(), names, inactiveNames))
+        return false;
+    collection->setItems(names);
+    collection->setInactiveItems(inactiveNames);
+    return true;
+}
+
+template<class T>
+void storeNames(MetadataSnapshot& snapshot, T* collection)
+{
+    // collections that aren't loaded are missing from the snapshot, so the
+    // section is read from the database the next time
+    if (!collection || !collection->childrenLoaded())
+        return;
+    wxArrayString names;
+    for (typename T::iterator it = collection->begin();
+        it != collection->end(); ++it)
+    {
+        names.push_back((*it)->getName_());
+    }
+    snapshot.setNames(collection->getType(), names);
+}
+
+template<class T>
+void storeNamesAndInactive(MetadataSnapshot& snapshot, T* collection)
+{
+    if (!collection || !collection->childrenLoaded())
+        return;
+    wxArrayString names, inactiveNames;
+    for (typename T::iterator it = collection->begin();
+        it != collection->end(); ++it)
+    {
+        names.push_back((*it)->getName_());
+        if (!(*it)->isActive())
+            inactiveNames.push_back((*it)->getName_());
+    }
+    snapshot.setNames(collection->getType(), names, inactiveNames);
+}
+
+template<class T>
+void storeColumns(MetadataSnapshot& snapshot, T* collection)
+{
+    if (!collection || !collection->childrenLoaded())
+        return;
+    for (typename T::iterator it = collection->begin();
+        it != collection->end(); ++it)
+    {
+        // only the columns that have been loaded in this session
+        if (!(*it)->childrenLoaded())
+            continue;
+        std::vector<MetadataSnapshot::ColumnData> columns;
+        for (ColumnPtrs::iterator itCol = (*it)->begin();
+            itCol != (*it)->end(); ++itCol)
+        {
+            columns.push_back(MetadataSnapshot::ColumnData());
+            (*itCol)->getSnapshotData(columns.back());
+        }
+        snapshot.setColumns((*it)->getName_(), columns);
+    }
+}
+
+} // namespace
+
+wxString Database::getSnapshotFileName()
+{
+    wxString dir = config().getUserHomePath() + "metadata-cache";
+    if (!wxDirExists(dir))
+        wxFileName::Mkdir(dir, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+    return dir + wxFileName::GetPathSeparator() + getId() + ".frms";
+}
+
+void Database::loadSnapshotFingerprints(std::vector<std::string>& fingerprints,
+    wxString& key)
+{
+    // every fingerprint combines the number of rows of the system tables
+    // the section is read from with a checksum of the object names, so
+    // that any object created, dropped, renamed or (de)activated changes it
+    // HASH() values can exceed 2^60, and before Firebird 4 SUM() over
+    // BIGINT raises an overflow instead of widening, so every term is
+    // reduced to 31 bits first
+    auto checksum = [](const std::string& expr)
+    {
+        return " || '/' || coalesce(sum(mod(" + expr
+            + ", 2147483647)), 0)";
+    };
+    auto part = [&checksum](const char* table, const std::string& nameExpr,
+        const std::string& extra)
+    {
+        return "(select count(*)" + checksum("hash(" + nameExpr + ")")
+            + extra + " from " + table + ")";
+    };
+
+    // the column attributes restored from the snapshot must all be part
+    // of the fingerprint, or changing them would go unnoticed
+    bool hasIdentity = getInfo().getODSVersionIsHigherOrEqualTo(12, 0);
+    std::string fieldNames("rdb$relation_name || '.' || rdb$field_name"
+        " || '.' || rdb$field_source"
+        " || '.' || coalesce(rdb$collation_id, -1)");
+    if (hasIdentity)
+    {
+        fieldNames += " || '.' || coalesce(rdb$generator_name, '')"
+            " || '.' || coalesce(rdb$identity_type, -1)";
+    }
+    // rows without a default or computed source are skipped by SUM()
+    std::string relations = part("rdb$relations", "rdb$relation_name",
+        " || '/' || coalesce(sum(rdb$format), 0)")
+        + " || ':' || " + part("rdb$relation_fields", fieldNames,
+        " || '/' || coalesce(sum(rdb$null_flag), 0)" + checksum(
+            "hash(rdb$relation_name || '.' || rdb$field_name || '.'"
+            " || rdb$default_source)"));
+    std::string routines = part("rdb$procedures", "rdb$procedure_name", "")
+        + " || ':' || " + part("rdb$functions", "rdb$function_name", "");
+    if (getInfo().getODSVersionIsHigherOrEqualTo(12, 0))
+        routines += " || ':' || " + part("rdb$packages", "rdb$package_name", "");
+    std::string triggers = part("rdb$triggers", "rdb$trigger_name",
+        " || '/' || coalesce(sum(rdb$trigger_inactive), 0)");
+    std::string indices = part("rdb$indices", "rdb$index_name",
+        " || '/' || coalesce(sum(rdb$index_inactive), 0)");
+    std::string other = part("rdb$roles", "rdb$role_name", "")
+        + " || ':' || " + part("rdb$generators", "rdb$generator_name",
+            hasIdentity ? checksum("rdb$initial_value")
+                + " || '/' || coalesce(sum(rdb$generator_increment), 0)"
+                : std::string())
+        + " || ':' || " + part("rdb$fields", "rdb$field_name",
+            checksum("hash(rdb$field_name || '.' || rdb$computed_source)"));
+
+    std::string sql = "select " + relations + ", " + routines + ", "
+        + triggers + ", " + indices + ", " + other + ", ";
+    sql += getInfo().getODSVersionIsHigherOrEqualTo(13, 0)
+        ? "rdb$get_context('SYSTEM', 'DB_GUID')" : "null";
+    sql += " from rdb$database";
+
+    MetadataLoader* loader = getMetadataLoader();
+    MetadataLoaderTransaction tr(loader);
+    fr::IStatementPtr& st1 = loader->getStatement(sql);
+    st1->execute();
+
+    fingerprints.clear();
+    key = getConnectionString();
+    if (st1->fetch())
+    {
+        for (int i = 0; i < MetadataSnapshot::secCount; ++i)
+            fingerprints.push_back(st1->isNull(i) ? "" : st1->getString(i));
+        if (!st1->isNull(MetadataSnapshot::secCount))
+            key = std2wxIdentifier(st1->getString(MetadataSnapshot::secCount),
+                getCharsetConverter());
+    }
+}
+
+std::unique_ptr<MetadataSnapshot> Database::loadSnapshot()
+{
+    snapshotFingerprintsM.clear();
+    if (!config().get("MetadataSnapshotCache", true))
+        return std::unique_ptr<MetadataSnapshot>();
+
+    // without HASH() (ODS 11.1) the fingerprints would only count the
+    // objects, and a renamed or replaced object would go unnoticed
+    if (!getInfo().getODSVersionIsHigherOrEqualTo(11, 1))
+        return std::unique_ptr<MetadataSnapshot>();
+
+    // the snapshot only saves time, so it is never worth failing the
+    // connection for it
+    try
+    {
+        loadSnapshotFingerprints(snapshotFingerprintsM, snapshotKeyM);
+    }
+    catch (std::exception& e)
+    {
+        // but a broken fingerprint query would disable it for good
+        wxLogWarning(_("The metadata snapshot cache could not be used: %s"),
+            wxString(e.what()));
+        snapshotFingerprintsM.clear();
+        return std::unique_ptr<MetadataSnapshot>();
+    }
+    std::unique_ptr<MetadataSnapshot> snapshot(
+        new MetadataSnapshot(snapshotKeyM));
+    if (!snapshot->load(getSnapshotFileName()))
+        return std::unique_ptr<MetadataSnapshot>();
+    return snapshot;
+}
+
+bool Database::restoreSnapshotSection(const MetadataSnapshot& snapshot,
+    int section)
+{
+    MetadataSnapshot::Section sec = MetadataSnapshot::Section(section);
+    if (size_t(section) >= snapshotFingerprintsM.size()
+        || snapshotFingerprintsM[section].empty()
+        || snapshot.getFingerprint(sec) != snapshotFingerprintsM[section])
+    {
+        return false;
+    }
+
+    bool isODS12 = getInfo().getODSVersionIsHigherOrEqualTo(12, 0);
+    switch (sec)
+    {
+        case MetadataSnapshot::secRelations:
+        {
+            if (!restoreNames(snapshot, tablesM.get())
+                || !restoreNames(snapshot, sysTablesM.get())
+                || !restoreNames(snapshot, GTTablesM.get())
+                || !restoreNames(snapshot, viewsM.get()))
+            {
+                return false;
+            }
+            const MetadataSnapshot::RelationColumns& rc = snapshot.getColumns();
+            for (MetadataSnapshot::RelationColumns::const_iterator it = rc.begin();
+                it != rc.end(); ++it)
+            {
+                Relation* r = findRelation(Identifier(it->first));
+                if (!r)
+                    continue;
+                ColumnPtrs columns;
+                for (std::vector<MetadataSnapshot::ColumnData>::const_iterator
+                    itCol = it->second.begin(); itCol != it->second.end(); ++itCol)
+                {
+                    ColumnPtr col(new Column(r, itCol->name));
+                    initializeLockCount(col, r->getLockCount());
+                    col->initialize(*itCol);
+                    columns.push_back(col);
+                }
+                r->setColumns(columns);
+            }
+            return true;
+        }
+        case MetadataSnapshot::secRoutines:
+            return restoreNames(snapshot, proceduresM.get())
+                && restoreNames(snapshot, UDFsM.get())
+                && (!isODS12 || (restoreNames(snapshot, functionSQLsM.get())
+                    && restoreNames(snapshot, packagesM.get())
+                    && restoreNames(snapshot, sysPackagesM.get())));
+        case MetadataSnapshot::secTriggers:
+            return restoreNamesAndInactive(snapshot, DMLtriggersM.get())
+                && restoreNamesAndInactive(snapshot, DBTriggersM.get())
+                && restoreNamesAndInactive(snapshot, DDLTriggersM.get());
+        case MetadataSnapshot::secIndices:
+            return restoreNamesAndInactive(snapshot, indicesM.get())
+                && restoreNamesAndInactive(snapshot, sysIndicesM.get())
+                && restoreNamesAndInactive(snapshot, usrIndicesM.get());
+        case MetadataSnapshot::secOther:
+            return restoreNames(snapshot, rolesM.get())
+                && restoreNames(snapshot, sysRolesM.get())
+                && restoreNames(snapshot, userDomainsM.get())
+                && restoreNames(snapshot, sysDomainsM.get())
+                && restoreNames(snapshot, generatorsM.get());
+        default:
+            return false;
+    }
+}
+
+void Database::storeSnapshotSection(MetadataSnapshot& snapshot, int section)
+{
+    bool isODS12 = getInfo().getODSVersionIsHigherOrEqualTo(12, 0);
+    switch (section)
+    {
+        case MetadataSnapshot::secRelations:
+            storeNames(snapshot, tablesM.get());
+            storeNames(snapshot, sysTablesM.get());
+            storeNames(snapshot, GTTablesM.get());
+            storeNames(snapshot, viewsM.get());
+            storeColumns(snapshot, tablesM.get());
+            storeColumns(snapshot, sysTablesM.get());
+            storeColumns(snapshot, GTTablesM.get());
+            storeColumns(snapshot, viewsM.get());
+            break;
+        case MetadataSnapshot::secRoutines:
+            storeNames(snapshot, proceduresM.get());
+            storeNames(snapshot, UDFsM.get());
+            if (isODS12)
+            {
+                storeNames(snapshot, functionSQLsM.get());
+                storeNames(snapshot, packagesM.get());
+                storeNames(snapshot, sysPackagesM.get());
+            }
+            break;
+        case MetadataSnapshot::secTriggers:
+            storeNamesAndInactive(snapshot, DMLtriggersM.get());
+            storeNamesAndInactive(snapshot, DBTriggersM.get());
+            storeNamesAndInactive(snapshot, DDLTriggersM.get());
+            break;
+        case MetadataSnapshot::secIndices:
+            storeNamesAndInactive(snapshot, indicesM.get());
+            storeNamesAndInactive(snapshot, sysIndicesM.get());
+            storeNamesAndInactive(snapshot, usrIndicesM.get());
+            break;
+        case MetadataSnapshot::secOther:
+            storeNames(snapshot, rolesM.get());
+            storeNames(snapshot, sysRolesM.get());
+            storeNames(snapshot, userDomainsM.get());
+            storeNames(snapshot, sysDomainsM.get());
+            storeNames(snapshot, generatorsM.get());
+            break;
+    }
+}
+
+void Database::saveSnapshot()
+{
+    if (snapshotFingerprintsM.size() != MetadataSnapshot::secCount
+        || !childrenLoaded())
+    {
+        return;
+    }
+
+    // only sections that nobody has changed since they were read can be
+    // stored with the fingerprint of that time
+    std::vector<std::string> fingerprints;
+    wxString key;
+    loadSnapshotFingerprints(fingerprints, key);
+    if (fingerprints.size() != snapshotFingerprintsM.size())
+        return;
+
+    MetadataSnapshot snapshot(snapshotKeyM);
+    bool hasSections = false;
+    for (int i = 0; i < MetadataSnapshot::secCount; ++i)
+    {
+        if (fingerprints[i].empty() || fingerprints[i] != snapshotFingerprintsM[i])
+            continue;
+        snapshot.setFingerprint(MetadataSnapshot::Section(i), fingerprints[i]);
+        storeSnapshotSection(snapshot, i);
+        hasSections = true;
+    }
+
+    wxString fileName(getSnapshotFileName());
+    if (hasSections)
+        snapshot.save(fileName);
+    else if (wxFileExists(fileName))
+        wxRemoveFile(fileName);
+}
+
 void Database::loadDatabaseInfo()
 {
     MetadataLoader* loader = getMetadataLoader();
@@ -1618,6 +2462,13 @@ void Database::disconnect()
 {
     if (connectedM)
     {
+        try
+        {
+            saveSnapshot();
+        }
+        catch (std::exception&) // the snapshot is only a cache
+        {
+        }
         databaseDAL_M->disconnect();
         setDisconnected();
     }
@@ -1630,6 +2481,8 @@ void Database::setDisconnected()
     resetCredentials();     // "forget" temporary username/password
     connectedM = false;
     resetPendingLoadData();
+    snapshotFingerprintsM.clear();
+    dependencyGraphM.clear();
 
     // remove entire DBH beneath
     userDomainsM.reset();
@@ -2121,6 +2974,23 @@ fr::IDatabasePtr Database::getDALDatabase() const
     return databaseDAL_M;
 }
 
+fr::IDatabasePtr Database::createDALConnection(bool connect) const
+{
+    fr::IDatabasePtr dal = fr::DatabaseFactory::createDatabase(
+        databaseDAL_M->getBackendType());
+    dal->setConnectionString(wx2std(getConnectionString()));
+    // the credentials the user entered when connecting
+    dal->setCredentials(databaseDAL_M->getUsername(),
+        databaseDAL_M->getUserPassword());
+    dal->setRole(wx2std(getRole()));
+    dal->setCharset(wx2std(getConnectionCharset()));
+    dal->setClientLibrary(wx2std(getClientLibrary()));
+    dal->setCryptKeyData(wx2std(getCryptKeyData()));
+    if (connect)
+        dal->connect();
+    return dal;
+}
+
 void Database::setIsVolatile(const bool isVolatile)
 {
     volatileM = isVolatile;
@@ -28,6 +28,7 @@
 #include <wx/colour.h>
 
 #include <map>
+#include <memory>
 #include "metadata/ODSVersion.h"
 #include <mutex>
 #include <unordered_map>
@@ -35,10 +36,12 @@
 
 
 #include "engine/db/IDatabase.h"
+#include "metadata/DependencyGraph.h"
 #include "metadata/MetadataClasses.h"
 #include "metadata/metadataitem.h"
 
 class MetadataLoader;
+class MetadataSnapshot;
 class ProgressIndicator;
 class SqlStatement;
 
@@ -251,6 +254,10 @@ private:
     UsrIndicesPtr usrIndicesM;
     ViewsPtr viewsM;
 
+    // loaded when it is first needed, cleared by DDL statements
+    DependencyGraph dependencyGraphM;
+    void loadDependencyGraph();
+
     // copy constructor implementation removed since it's no longer needed
     // (Server uses a vector of std::shared_ptr<Database> now)
     Database(const Database& rhs);
@@ -259,12 +266,25 @@ private:
 
     void loadCollations();
 
-    void loadCollections(ProgressIndicator* progressIndicator);
+    void loadCollections(ProgressIndicator* progressIndicator,
+        const MetadataSnapshot* snapshot = 0);
     void loadRelationCollections(ProgressIndicator* progressIndicator);
     void loadTriggerCollections(ProgressIndicator* progressIndicator);
 
     void loadDatabaseInfo();
 
+    // fingerprints of the sections of the metadata snapshot, read when
+    // connecting; empty if the snapshot cache isn't used
+    std::vector<std::string> snapshotFingerprintsM;
+    wxString snapshotKeyM;
+    wxString getSnapshotFileName();
+    void loadSnapshotFingerprints(std::vector<std::string>& fingerprints,
+        wxString& key);
+    std::unique_ptr<MetadataSnapshot> loadSnapshot();
+    bool restoreSnapshotSection(const MetadataSnapshot& snapshot, int section);
+    void storeSnapshotSection(MetadataSnapshot& snapshot, int section);
+    void saveSnapshot();
+
     void loadDefaultTimezone();
     void loadTimezones();
     void clearTimezones(bool clearDefaultTimezone);
@@ -327,7 +347,8 @@ public:
         const wxString& initialUser = "");
     void connect(const wxString& password, ProgressIndicator* indicator = 0);
     void disconnect();
-    void reconnect();
+    // with the saved password if password is empty
+    void reconnect(const wxString& password = wxEmptyString);
     void prepareTemporaryCredentials();
     void resetCredentials();
     void drop();
@@ -342,6 +363,17 @@ public:
     DomainPtr getDomain(const wxString& name);
 
     void loadGeneratorValues();
+    // loads the columns, constraints and indices of all relations with one
+    // statement for each kind of detail, instead of several statements for
+    // each relation
+    void loadRelationDetails(ProgressIndicator* progressIndicator = 0);
+    // loads the descriptions of all objects and relation columns with one
+    // statement for each system table, instead of one for each object
+    void loadDescriptions(ProgressIndicator* progressIndicator = 0);
+    // all views, each one after the views it selects from
+    void getViewsInDependencyOrder(std::vector<View*>& views);
+    // the dependencies between all objects, loaded with one statement
+    const DependencyGraph& getDependencyGraph();
     Relation* getRelationForTrigger(DMLTrigger* trigger);
 
     virtual DatabasePtr getDatabase() const;
@@ -386,6 +418,10 @@ public:
     DatabaseSecurityStatus getSecurityProtocolStatus();
 
     fr::IDatabasePtr getDALDatabase() const override;
+    // opens another attachment with the settings and credentials of the
+    // connected database, for work on other threads; if connect is false
+    // the caller connects it, without using this object any more
+    fr::IDatabasePtr createDALConnection(bool connect = true) const;
     void setIsVolatile(const bool isVolatile);
     void setPath(const wxString& value);
     void setClientLibrary(const wxString& value);
@@ -36,6 +36,7 @@
 #include "engine/MetadataLoader.h"
 #include "frutils.h"
 #include "metadata/database.h"
+#include "metadata/DependencyGraph.h"
 #include "metadata/metadataitem.h"
 #include "metadata/MetadataItemDescriptionVisitor.h"
 #include "metadata/MetadataItemVisitor.h"
@@ -393,158 +394,73 @@ void MetadataItem::getDependencies(std::vector<Dependency>& list,
         mytype = 6;
         mytype2 = 10;
     }
-    // views count as relations(tables) when other object refer to them
-    if (mytype == 1 && !ofObject)
-        mytype2 = 0;
     // package header and package body
     if (typeM == ntPackage)
         mytype2 = 18;
 
     if (typeM == ntUnknown || mytype == -1)
         throw FRError(_("Unsupported type"));
-    fr::IDatabasePtr db = d->getDALDatabase();
-    fr::ITransactionPtr tr1 = db->createTransaction();
-    tr1->setAccessMode(fr::TransactionAccessMode::Read);
-    tr1->start();
-    fr::IStatementPtr st1 = db->createStatement(tr1);
-
-    wxString o1 = (ofObject ? "DEPENDENT" : "DEPENDED_ON");
-    wxString o2 = (ofObject ? "DEPENDED_ON" : "DEPENDENT");
-    wxString sql =
-        "select t1.*, f2.rdb$field_position from ( \n "
-        "select RDB$" + o2 + "_TYPE, RDB$" + o2 + "_NAME, RDB$FIELD_NAME \n "
-        " from RDB$DEPENDENCIES \n "
-        " where RDB$" + o1 + "_TYPE in (?,?) and RDB$" + o1 + "_NAME = ? \n ";
-    int params = 1;
-    if ((typeM == ntTable || typeM == ntSysTable || typeM == ntGTT || typeM == ntView) && ofObject)  // get deps for computed columns
-    {                                                       // view needed to bind with generators
-        sql += " union  \n"
-            " SELECT DISTINCT d.rdb$depended_on_type, d.rdb$depended_on_name, d.rdb$field_name \n"
-            " FROM rdb$relation_fields f \n"
-            " LEFT JOIN rdb$dependencies d ON d.rdb$dependent_name = f.rdb$field_source \n"
-            " WHERE d.rdb$dependent_type = 3 AND f.rdb$relation_name = ? \n";
-        params++;
-    }
-    if (!ofObject) // find tables that have calculated columns based on "this" object
-    {
-        sql += "union  \n"
-            " SELECT distinct cast(0 as smallint), f.rdb$relation_name, f.rdb$field_name \n"
-            " from rdb$relation_fields f \n"
-            " left join rdb$dependencies d on d.rdb$dependent_name = f.rdb$field_source \n"
-            " where d.rdb$dependent_type = 3 and d.rdb$depended_on_name = ? ";
-        params++;
-    }
-    // get the exact table and fields for views
-    // rdb$dependencies covers deps. for WHERE clauses in SELECTs in VIEW body
-    // but we also need mapping for column list in SELECT. These 2 queries cover it:
-    if (ofObject && typeM == ntView)
-    {
-        sql += " union \n"
-            " select distinct cast(0 as smallint), vr.RDB$RELATION_NAME, f.RDB$BASE_FIELD \n"
-            " from RDB$RELATION_FIELDS f \n"
-            " join RDB$VIEW_RELATIONS vr on f.RDB$VIEW_CONTEXT = vr.RDB$VIEW_CONTEXT \n"
-            "   and f.RDB$RELATION_NAME = vr.RDB$VIEW_NAME \n"
-            " where f.rdb$relation_name = ? \n";
-        params++;
-    }
-    // views can depend on other views as well
-    // we might need to add procedures here one day when Firebird gains support for it
-    if (!ofObject && (typeM == ntView || typeM == ntTable || typeM == ntSysTable || typeM == ntGTT))
-    {
-        sql += " union \n"
-            " select distinct cast(0 as smallint), f.RDB$RELATION_NAME, f.RDB$BASE_FIELD \n"
-            " from RDB$RELATION_FIELDS f \n"
-            " join RDB$VIEW_RELATIONS vr on f.RDB$VIEW_CONTEXT = vr.RDB$VIEW_CONTEXT \n"
-            "   and f.RDB$RELATION_NAME = vr.RDB$VIEW_NAME \n"
-            " where vr.rdb$relation_name = ? \n";
-        params++;
-    }
-    sql += " ) t1 \n "
-        "left join RDB$RELATION_FIELDS f2 \n "
-        "    on f2.RDB$FIELD_NAME = t1.RDB$FIELD_NAME \n "
-        "    and f2.RDB$RELATION_NAME = ? \n ";
-    params++;
 
-    sql += " order by 1, 2, 3";
-    st1->prepare(wx2std(sql, d->getCharsetConverter()));
-    st1->setInt32(0, mytype);
-    st1->setInt32(1, mytype2);
-    for (int i = 0; i < params; i++)
-        st1->setString(2 + i, wx2std(getName_(), d->getCharsetConverter()));
-    st1->execute();
+    // the graph has the dependencies of computed columns, view columns and
+    // check constraints as well, and views that are used like relations
+    // with the type of views
+    const DependencyGraph& graph = d->getDependencyGraph();
+    unsigned flag = (ofObject ? DependencyGraph::kDependsOn
+        : DependencyGraph::kDependentOf);
+    int mytypes[] = { mytype, mytype2 };
     MetadataItem* last = NULL;
     Dependency* dep = NULL;
-    while (st1->fetch())
+    for (int i = 0; i < (mytype2 == mytype ? 1 : 2); i++)
     {
-        int object_type = st1->getInt32(0);
-        if (object_type > type_count)   // some system object, not interesting for us
+        size_t object = graph.findObject(mytypes[i], getName_());
+        if (object == DependencyGraph::npos)
             continue;
-        NodeType t = dep_types[object_type];
-        if (t == ntUnknown)             // ditto
-            continue;
-
-        std::string objname_std = st1->getString(1);
-        wxString objname(std2wxIdentifier(objname_std,
-            d->getCharsetConverter()));
-
-        MetadataItem* current = d->findByNameAndType(t, objname);
-        if (!current)
+        std::pair<DependencyGraph::EdgeIterator, DependencyGraph::EdgeIterator>
+            edges = graph.getEdges(object, ofObject);
+        for (DependencyGraph::EdgeIterator it = edges.first;
+            it != edges.second; ++it)
         {
-            if (!current && t == ntDomain)
+            if ((it->flags & flag) == 0)
+                continue;
+            int object_type = graph.getType(it->object);
+            if (object_type < 0 || object_type >= type_count)   // some system object, not interesting for us
+                continue;
+            NodeType t = dep_types[object_type];
+            if (t == ntUnknown)             // ditto
+                continue;
+
+            const wxString& objname = graph.getName(it->object);
+            MetadataItem* current = d->findByNameAndType(t, objname);
+            if (!current)
             {
-                // Dependencies can refer to both user and system domains.
-                current = d->findByNameAndType(ntSysDomain, objname);
-            }
-            if (t == ntTable) {
-                // maybe it's a view masked as table
-                current = d->findByNameAndType(ntView, objname);
-                // or possibly a system table
-                if (!current)
+                if (t == ntDomain)
+                {
+                    // Dependencies can refer to both user and system domains.
+                    current = d->findByNameAndType(ntSysDomain, objname);
+                }
+                if (t == ntTable)
                     current = d->findByNameAndType(ntSysTable, objname);
+                if (!current)
+                    continue;
             }
-            if (!ofObject && (t == ntDMLTrigger || t == ntDBTrigger || t == ntTrigger))
+            if (current != last)            // new object
             {
-                // system trigger dependent of this object indicates possible check constraint on a table
-                // that references this object. So, let's check if this trigger is used for check constraint
-                // and get that table's name
-                fr::IStatementPtr st2 = db->createStatement(tr1);
-                st2->prepare(
-                    "select r.rdb$relation_name from rdb$relation_constraints r "
-                    " join rdb$check_constraints c on r.rdb$constraint_name=c.rdb$constraint_name "
-                    " and r.rdb$constraint_type = 'CHECK' where c.rdb$trigger_name = ? "
-                );
-                st2->setString(0, objname_std);
-                st2->execute();
-                if (st2->fetch()) // table using that trigger found
-                {
-                    std::string s = st2->getString(0);
-                    wxString tablecheck(std2wxIdentifier(s, d->getCharsetConverter()));
-                    if (getName_() != tablecheck)    // avoid self-reference
-                        current = d->findByNameAndType(ntTable, tablecheck);
-                }
+                Dependency de(current);
+                list.push_back(de);
+                dep = &list.back();
+                last = current;
+            }
+            if (it->field != DependencyGraph::npos)
+            {
+                dep->addField(DependencyField(
+                    graph.getFieldName(it->field), it->position));
             }
-            if (!current)
-                continue;
-        }
-        if (current != last)            // new object
-        {
-            Dependency de(current);
-            list.push_back(de);
-            dep = &list.back();
-            last = current;
-        }
-        if (!st1->isNull(2))
-        {
-            std::string s = st1->getString(2);
-            int pos = st1->getInt32(3);
-
-            dep->addField( DependencyField(std2wxIdentifier(s, d->getCharsetConverter()), pos));
         }
     }
 
     // TODO: perhaps this could be moved to Table?
     //       call MetadataItem::getDependencies() and then add this
-    if ((typeM == ntTable || typeM == ntSysTable) && ofObject)   // foreign keys of this table + computed columns
+    if ((typeM == ntTable || typeM == ntSysTable) && ofObject)   // foreign keys of this table
     {
         Table *tab = dynamic_cast<Table *>(this);
         for (const auto iter : *(tab->getForeignKeys()))
@@ -561,55 +477,30 @@ void MetadataItem::getDependencies(std::vector<Dependency>& list,
             de.setFields(iter.getReferencedColumns());
             list.push_back(de);
         }
+    }
 
-        // Add check constraints here (CHECKS are checked via system triggers), example:
-        // table1::check( table1.field1 > select max(field2) from table2 )
-        // So, table vs any object from this ^^^ select
-        // Algorithm: 1.find all system triggers bound to that CHECK constraint
-        //            2.find dependencies for those system triggers
-        //            3.display those dependencies as deps. of this table
-        st1->prepare("select distinct c.rdb$trigger_name from rdb$relation_constraints r "
-            " join rdb$check_constraints c on r.rdb$constraint_name=c.rdb$constraint_name "
-            " and r.rdb$constraint_type = 'CHECK' where r.rdb$relation_name= ? "
-        );
-        st1->setString(0, wx2std(getName_(), d->getCharsetConverter()));
-        st1->execute();
-        std::vector<Dependency> tempdep;
-        while (st1->fetch())
-        {
-            std::string s = st1->getString(0);
-            DMLTrigger t(d->shared_from_this(),
-                std2wxIdentifier(s, d->getCharsetConverter()));
-            t.getDependencies(tempdep, true);
-        }
-        // remove duplicates, and self-references from "tempdep"
-        while (true)
+    // TODO: perhaps this could be moved to Table?
+    if ((typeM == ntTable || typeM == ntSysTable) && !ofObject)  // foreign keys of other tables
+    {
+        // the graph knows whether there are any, but not their columns
+        bool referenced = false;
+        size_t object = graph.findObject(mytype, getName_());
+        if (object != DependencyGraph::npos)
         {
-            std::vector<Dependency>::iterator to_remove = tempdep.end();
-            for (std::vector<Dependency>::iterator it = tempdep.begin();
-                it != tempdep.end(); ++it)
+            std::pair<DependencyGraph::EdgeIterator, DependencyGraph::EdgeIterator>
+                edges = graph.getEdges(object, false);
+            for (DependencyGraph::EdgeIterator it = edges.first;
+                it != edges.second && !referenced; ++it)
             {
-                if ((*it).getDependentObject() == this)
-                {
-                    to_remove = it;
-                    break;
-                }
-                to_remove = std::find(it + 1, tempdep.end(), (*it));
-                if (to_remove != tempdep.end())
-                    break;
+                referenced = (it->flags & DependencyGraph::kForeignKey) != 0;
             }
-            if (to_remove == tempdep.end())
-                break;
-            else
-                tempdep.erase(to_remove);
         }
-        list.insert(list.end(), tempdep.begin(), tempdep.end());
-    }
+        if (!referenced)
+            return;
 
-    // TODO: perhaps this could be moved to Table?
-    if ((typeM == ntTable || typeM == ntSysTable) && !ofObject)  // foreign keys of other tables
-    {
-        st1->prepare(
+        MetadataLoader* loader = d->getMetadataLoader();
+        MetadataLoaderTransaction tr(loader);
+        fr::IStatementPtr& st1 = loader->getStatement(
             "select r1.rdb$relation_name, i.rdb$field_name, i.RDB$FIELD_POSITION, R1.RDB$CONSTRAINT_NAME, i2.RDB$FIELD_NAME "
             " from rdb$relation_constraints r1 "
             " join rdb$ref_constraints c on r1.rdb$constraint_name = c.rdb$constraint_name "
@@ -655,8 +546,6 @@ void MetadataItem::getDependencies(std::vector<Dependency>& list,
             dep->addField(DependencyField(field_name, pos));
         }
     }
-
-    tr1->commit();
 }
 
 void MetadataItem::ensureDescriptionLoaded()
@@ -691,6 +580,13 @@ void MetadataItem::invalidateDescription()
     }
 }
 
+void MetadataItem::setLoadedDescription(const wxString& description)
+{
+    // don't call notifyObservers(), see loadDescription()
+    descriptionLoadedM = lsLoaded;
+    descriptionM = description;
+}
+
 void MetadataItem::loadDescription()
 {
     LoadDescriptionVisitor ldv;
@@ -787,9 +683,12 @@ Identifier MetadataItem::getIdentifier() const
     return identifierM;
 }
 
+std::atomic<unsigned> MetadataItem::keyChangeCountM(0);
+
 void MetadataItem::setName_(const wxString& name)
 {
     identifierM.setText(name);
+    ++keyChangeCountM;
     notifyObservers();
 }
 
@@ -811,6 +710,13 @@ int MetadataItem::getMetadataId()
 void MetadataItem::setMetadataId(int id)
 {
     metadataIdM = id;
+    ++keyChangeCountM;
+}
+
+/*static*/
+unsigned MetadataItem::getKeyChangeCount()
+{
+    return keyChangeCountM;
 }
 
 bool MetadataItem::isSystem() const
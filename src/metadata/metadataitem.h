@@ -28,6 +28,7 @@
 #include <wx/string.h>
 
 #include <algorithm>
+#include <atomic>
 #include <vector>
 
 #include "core/ObjectWithHandle.h"
@@ -92,6 +93,7 @@ private:
     NodeType typeM;
     Identifier identifierM;
     int metadataIdM;
+    static std::atomic<unsigned> keyChangeCountM;
 
     enum LoadState { lsNotLoaded, lsLoadPending, lsLoaded, lsNotAvailable };
     LoadState childrenLoadedM;
@@ -145,6 +147,8 @@ public:
     bool getDescription(wxString& description);
     void invalidateDescription();
     void setDescription(const wxString& description);
+    // sets the description loaded together with those of other objects
+    void setLoadedDescription(const wxString& description);
 
     bool childrenLoaded() const;
     void ensureChildrenLoaded();
@@ -173,6 +177,9 @@ public:
     void setType(NodeType type);
     virtual int getMetadataId();
     virtual void setMetadataId(int id);
+    // changes whenever the name or the metadata id of any item changes,
+    // collections use it to tell whether their index may be out of date
+    static unsigned getKeyChangeCount();
 
     // returns the name of the data type (f. ex. TABLE)
     virtual const wxString getTypeName() const;
@@ -205,6 +205,34 @@ int Relation::getExternalFormat()
     return externalFormatM;
 }
 
+std::string Relation::getColumnsSql(DatabasePtr db, bool allRelations)
+{
+    std::string sql(
+            "select r.rdb$field_name, r.rdb$null_flag, r.rdb$field_source,"         //1,2,3
+            " l.rdb$collation_name, f.rdb$computed_source, r.rdb$default_source,"   //4,5,6
+            " r.rdb$description ");                                                 //7
+    sql += db->getInfo().getODSVersionIsHigherOrEqualTo(12, 0) ? ", r.RDB$GENERATOR_NAME, r.RDB$IDENTITY_TYPE, g.RDB$INITIAL_VALUE, g.RDB$GENERATOR_INCREMENT " : ", null, null, null, null "; //8,9, 10, 11
+    if (allRelations)
+        sql += ", r.rdb$relation_name ";                                        //12
+    sql +=  " from rdb$fields f"
+            " join rdb$relation_fields r "
+            "     on f.rdb$field_name=r.rdb$field_source"
+            " left outer join rdb$collations l "
+            "     on l.rdb$collation_id = coalesce(r.rdb$collation_id, f.rdb$collation_id) ";
+    sql += " and l.rdb$character_set_id = f.rdb$character_set_id";
+    
+    if (db->getInfo().getODSVersionIsHigherOrEqualTo(12, 0))
+        sql += " left join RDB$GENERATORS g on g.RDB$GENERATOR_NAME = r.RDB$GENERATOR_NAME ";
+    if (allRelations)
+        sql += " order by r.rdb$relation_name, r.rdb$field_position";
+    else
+    {
+        sql +=  " where r.rdb$relation_name = ?"
+                " order by r.rdb$field_position";
+    }
+    return sql;
+}
+
 void Relation::loadChildren()
 {
     // in case an exception is thrown this should be repeated
@@ -222,74 +250,66 @@ void Relation::loadChildren()
     MetadataLoaderTransaction tr(loader);
     SubjectLocker lock(db.get());
     wxMBConv* converter = db->getCharsetConverter();
-    std::string sql(
-            "select r.rdb$field_name, r.rdb$null_flag, r.rdb$field_source,"         //1,2,3
-            " l.rdb$collation_name, f.rdb$computed_source, r.rdb$default_source,"   //4,5,6
-            " r.rdb$description ");                                                 //7
-    sql += db->getInfo().getODSVersionIsHigherOrEqualTo(12, 0) ? ", r.RDB$GENERATOR_NAME, r.RDB$IDENTITY_TYPE, g.RDB$INITIAL_VALUE, g.RDB$GENERATOR_INCREMENT " : ", null, null, null, null "; //8,9, 10, 11
-    sql +=  " from rdb$fields f"
-            " join rdb$relation_fields r "
-            "     on f.rdb$field_name=r.rdb$field_source"
-            " left outer join rdb$collations l "
-            "     on l.rdb$collation_id = coalesce(r.rdb$collation_id, f.rdb$collation_id) ";
-    sql += " and l.rdb$character_set_id = f.rdb$character_set_id";
-    
-    if (db->getInfo().getODSVersionIsHigherOrEqualTo(12, 0))
-        sql += " left join RDB$GENERATORS g on g.RDB$GENERATOR_NAME = r.RDB$GENERATOR_NAME ";
-    sql +=  " where r.rdb$relation_name = ?"
-            " order by r.rdb$field_position";
-    
-    fr::IStatementPtr& st1 = loader->getStatement(sql);
+
+    fr::IStatementPtr& st1 = loader->getStatement(getColumnsSql(db, false));
     st1->setString(0, wx2std(getName_(), converter));
     st1->execute();
 
     ColumnPtrs columns;
     while (st1->fetch())
+        readColumn(st1, converter, columns);
+    setColumns(columns);
+}
+
+void Relation::readColumn(fr::IStatementPtr& st1, wxMBConv* converter,
+    ColumnPtrs& columns)
+{
+    std::string s = st1->getString(0);
+    wxString fname(std2wxIdentifier(s, converter));
+    bool notNull = false;
+    if (!st1->isNull(1))
+        notNull = st1->getBool(1);
+    s = st1->getString(2);
+    wxString source(std2wxIdentifier(s, converter));
+    wxString collation;
+    if (!st1->isNull(3))
+        collation = std2wxIdentifier(st1->getString(3), converter);
+    
+    wxString computedSrc = wxString(st1->getString(4).c_str(), *converter);
+    bool hasDefault = !st1->isNull(5);
+    wxString defaultSrc;
+    if (hasDefault)
     {
-        std::string s = st1->getString(0);
-        wxString fname(std2wxIdentifier(s, converter));
-        bool notNull = false;
-        if (!st1->isNull(1))
-            notNull = st1->getBool(1);
-        s = st1->getString(2);
-        wxString source(std2wxIdentifier(s, converter));
-        wxString collation;
-        if (!st1->isNull(3))
-            collation = std2wxIdentifier(st1->getString(3), converter);
-        
-        wxString computedSrc = wxString(st1->getString(4).c_str(), *converter);
-        bool hasDefault = !st1->isNull(5);
-        wxString defaultSrc;
-        if (hasDefault)
-        {
-            defaultSrc = wxString(st1->getString(5).c_str(), *converter);
-            // Some users reported two spaces before DEFAULT word in source
-            // Perhaps some other tools can put garbage here? Should we
-            // parse it as SQL to clean up comments, whitespace, etc?
-            defaultSrc.Trim(false).Remove(0, 8);
-        }
-        bool hasDescription = !st1->isNull(6);
-        wxString identityType = "";
-        int64_t initialValue = 0, incrementValue = 0;
-        if (!st1->isNull(7)) {
-            int i = st1->getInt32(8);
-            identityType = i == IDENT_TYPE_BY_DEFAULT ? "BY DEFAULT" : i == IDENT_TYPE_ALWAYS ? "ALWAYS" : "";
-            initialValue = st1->getInt64(9);
-            incrementValue = st1->getInt64(10);
-        }
+        defaultSrc = wxString(st1->getString(5).c_str(), *converter);
+        // Some users reported two spaces before DEFAULT word in source
+        // Perhaps some other tools can put garbage here? Should we
+        // parse it as SQL to clean up comments, whitespace, etc?
+        defaultSrc.Trim(false).Remove(0, 8);
+    }
+    bool hasDescription = !st1->isNull(6);
+    wxString identityType = "";
+    int64_t initialValue = 0, incrementValue = 0;
+    if (!st1->isNull(7)) {
+        int i = st1->getInt32(8);
+        identityType = i == IDENT_TYPE_BY_DEFAULT ? "BY DEFAULT" : i == IDENT_TYPE_ALWAYS ? "ALWAYS" : "";
+        initialValue = st1->getInt64(9);
+        incrementValue = st1->getInt64(10);
+    }
 
 
-        ColumnPtr col = findColumn(fname);
-        if (!col)
-        {
-            col.reset(new Column(this, fname));
-            initializeLockCount(col, getLockCount());
-        }
-        columns.push_back(col);
-        col->initialize(source, computedSrc, collation, !notNull,
-            defaultSrc, hasDefault, hasDescription, identityType, initialValue, incrementValue);
+    ColumnPtr col = findColumn(fname);
+    if (!col)
+    {
+        col.reset(new Column(this, fname));
+        initializeLockCount(col, getLockCount());
     }
+    columns.push_back(col);
+    col->initialize(source, computedSrc, collation, !notNull,
+        defaultSrc, hasDefault, hasDescription, identityType, initialValue, incrementValue);
+}
 
+void Relation::setColumns(ColumnPtrs& columns)
+{
     setChildrenLoaded(true);
     if (columnsM != columns)
     {
@@ -298,7 +318,6 @@ void Relation::loadChildren()
     }
 }
 
-//! holds all views + self (even if it's a table)
 void Relation::getDependentViews(std::vector<Relation *>& views,
     const wxString& forColumn)
 {
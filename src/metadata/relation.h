@@ -25,8 +25,10 @@
 #ifndef FR_RELATION_H
 #define FR_RELATION_H
 
+#include <string>
 #include <vector>
 
+#include "engine/db/IStatement.h"
 #include "metadata/constraints.h"
 #include "metadata/MetadataClasses.h"
 #include "metadata/metadataitem.h"
@@ -91,6 +93,15 @@ public:
     bool getChildren(std::vector<MetadataItem *>& temp);
     void getTriggers(std::vector<Trigger*>& list,
         Trigger::FiringTime time);
+
+    // used by loadChildren() and Database::loadRelationDetails(): returns
+    // the statement that selects the columns of this relation (name as
+    // parameter) or of all relations (name in the last column), reads the
+    // column of the current row, and stores the columns that were read
+    static std::string getColumnsSql(DatabasePtr db, bool allRelations);
+    void readColumn(fr::IStatementPtr& st, wxMBConv* converter,
+        ColumnPtrs& columns);
+    void setColumns(ColumnPtrs& columns);
 };
 
 #endif // FR_RELATION_H
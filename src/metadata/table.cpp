@@ -141,113 +141,315 @@ void Table::loadChildren()
     Relation::loadChildren();
 }
 
-//! reads checks info from database
-void Table::loadCheckConstraints()
+bool Table::isDetailsLoaded(DetailKind kind) const
 {
-    if (checkConstraintsLoadedM)
-        return;
-    checkConstraintsM.clear();
+    switch (kind)
+    {
+        case dkPrimaryKey:
+            return primaryKeyLoadedM;
+        case dkUniqueConstraints:
+            return uniqueConstraintsLoadedM;
+        case dkForeignKeys:
+            return foreignKeysLoadedM;
+        case dkCheckConstraints:
+            return checkConstraintsLoadedM;
+        case dkIndices:
+            return indicesLoadedM;
+    }
+    return false;
+}
 
-    DatabasePtr db = getDatabase();
-    wxMBConv* conv = db->getCharsetConverter();
-    MetadataLoader* loader = db->getMetadataLoader();
-    // first start a transaction for metadata loading, then lock the table
-    // when objects go out of scope and are destroyed, table will be unlocked
-    // before the transaction is committed - any update() calls on observers
-    // can possibly use the same transaction
-    MetadataLoaderTransaction tr(loader);
-    SubjectLocker lock(this);
+void Table::resetDetails(DetailKind kind)
+{
+    switch (kind)
+    {
+        case dkPrimaryKey:
+            primaryKeyM.columnsM.clear();
+            primaryKeyLoadedM = false;
+            break;
+        case dkUniqueConstraints:
+            uniqueConstraintsM.clear();
+            uniqueConstraintsLoadedM = false;
+            break;
+        case dkForeignKeys:
+            foreignKeysM.clear();
+            foreignKeysLoadedM = false;
+            break;
+        case dkCheckConstraints:
+            checkConstraintsM.clear();
+            checkConstraintsLoadedM = false;
+            break;
+        case dkIndices:
+            indicesM.clear();
+            indicesLoadedM = false;
+            break;
+    }
+}
 
-    fr::IStatementPtr& st1 = loader->getStatement(
-        "select r.rdb$constraint_name, t.rdb$trigger_source, d.rdb$field_name "
-        " from rdb$relation_constraints r "
-        " join rdb$check_constraints c on r.rdb$constraint_name=c.rdb$constraint_name and r.rdb$constraint_type = 'CHECK'"
-        " join rdb$triggers t on c.rdb$trigger_name=t.rdb$trigger_name and t.rdb$trigger_type = 1 "
-        " left join rdb$dependencies d on t.rdb$trigger_name = d.rdb$dependent_name "
-        "      and d.rdb$depended_on_name = r.rdb$relation_name "
-        "      and d.rdb$depended_on_type = 0 "
-        " where r.rdb$relation_name=? "
-        " order by 1 "
-    );
+void Table::setDetailsLoaded(DetailKind kind)
+{
+    switch (kind)
+    {
+        case dkPrimaryKey:
+            primaryKeyM.setParent(this);
+            primaryKeyLoadedM = true;
+            break;
+        case dkUniqueConstraints:
+            uniqueConstraintsLoadedM = true;
+            break;
+        case dkForeignKeys:
+            foreignKeysLoadedM = true;
+            break;
+        case dkCheckConstraints:
+            checkConstraintsLoadedM = true;
+            break;
+        case dkIndices:
+            indicesLoadedM = true;
+            break;
+    }
+}
 
-    st1->setString(0, wx2std(getName_(), conv));
-    st1->execute();
-    CheckConstraint *cc = 0;
-    while (st1->fetch())
+std::string Table::getDetailsSql(DatabasePtr db, DetailKind kind,
+    bool allTables)
+{
+    std::string sql;
+    switch (kind)
     {
-        std::string s = st1->getString(0);
-        wxString cname(std2wxIdentifier(s, conv));
-        if (!cc || cname != cc->getName_()) // new constraint
+        case dkPrimaryKey:
+        case dkUniqueConstraints:
+            sql = "select r.rdb$constraint_name, i.rdb$field_name, r.rdb$index_name";
+            if (allTables)
+                sql += ", r.rdb$relation_name";
+            sql += " from rdb$relation_constraints r, rdb$index_segments i "
+                "where r.rdb$index_name=i.rdb$index_name and ";
+            if (!allTables)
+                sql += "r.rdb$relation_name=? and ";
+            sql += kind == dkPrimaryKey ? "(r.rdb$constraint_type='PRIMARY KEY')"
+                : "(r.rdb$constraint_type='UNIQUE')";
+            sql += allTables ? " order by r.rdb$relation_name, " : " order by ";
+            sql += "r.rdb$constraint_name, i.rdb$field_position";
+            break;
+        case dkForeignKeys:
+            // the referenced columns are joined by their position, instead
+            // of a separate statement for each foreign key
+            sql = "select r.rdb$constraint_name, i.rdb$field_name, c.rdb$update_rule, "
+                " c.rdb$delete_rule, ur.rdb$relation_name, r.rdb$index_name, "
+                " ui.rdb$field_name";
+            if (allTables)
+                sql += ", r.rdb$relation_name";
+            sql += " from rdb$relation_constraints r"
+                " join rdb$index_segments i on r.rdb$index_name=i.rdb$index_name"
+                " join rdb$ref_constraints c on r.rdb$constraint_name = c.rdb$constraint_name"
+                " join rdb$relation_constraints ur on ur.rdb$constraint_name = c.rdb$const_name_uq"
+                " left join rdb$index_segments ui on ui.rdb$index_name = ur.rdb$index_name"
+                "     and ui.rdb$field_position = i.rdb$field_position"
+                " where (r.rdb$constraint_type='FOREIGN KEY')";
+            if (!allTables)
+                sql += " and r.rdb$relation_name=?";
+            sql += allTables ? " order by r.rdb$relation_name, " : " order by ";
+            sql += "r.rdb$constraint_name, i.rdb$field_position";
+            break;
+        case dkCheckConstraints:
+            sql = "select r.rdb$constraint_name, t.rdb$trigger_source, d.rdb$field_name ";
+            if (allTables)
+                sql += ", r.rdb$relation_name ";
+            sql += " from rdb$relation_constraints r "
+                " join rdb$check_constraints c on r.rdb$constraint_name=c.rdb$constraint_name and r.rdb$constraint_type = 'CHECK'"
+                " join rdb$triggers t on c.rdb$trigger_name=t.rdb$trigger_name and t.rdb$trigger_type = 1 "
+                " left join rdb$dependencies d on t.rdb$trigger_name = d.rdb$dependent_name "
+                "      and d.rdb$depended_on_name = r.rdb$relation_name "
+                "      and d.rdb$depended_on_type = 0 ";
+            if (!allTables)
+                sql += " where r.rdb$relation_name=? ";
+            sql += allTables ? " order by r.rdb$relation_name, 1 " : " order by 1 ";
+            break;
+        case dkIndices:
+            sql = "SELECT i.rdb$index_name, i.rdb$unique_flag, i.rdb$index_inactive, "
+                " i.rdb$index_type, i.rdb$statistics, "
+                " s.rdb$field_name, rc.rdb$constraint_name, i.rdb$expression_source, ";
+            sql += db->getInfo().getODSVersionIsHigherOrEqualTo(13, 1) ? " i.rdb$condition_source " : " null ";
+            if (allTables)
+                sql += ", i.rdb$relation_name ";
+            sql +=
+                " from rdb$indices i "
+                " left join rdb$index_segments s on i.rdb$index_name = s.rdb$index_name "
+                " left join rdb$relation_constraints rc "
+                "   on rc.rdb$index_name = i.rdb$index_name ";
+            if (!allTables)
+                sql += " where i.rdb$relation_name = ? ";
+            sql += allTables ? " order by i.rdb$relation_name, " : " order by ";
+            sql += "i.rdb$index_name, s.rdb$field_position ";
+            break;
+    }
+    return sql;
+}
+
+void Table::readDetails(DetailKind kind, fr::IStatementPtr& st1,
+    wxMBConv* conv)
+{
+    switch (kind)
+    {
+        case dkPrimaryKey:
         {
-            wxString source = wxString(st1->getString(1).c_str(), *conv);
-
-            CheckConstraint c;
-            c.setParent(this);
-            c.setName_(cname);
-            c.sourceM = source;
-            checkConstraintsM.push_back(c);
-            cc = &checkConstraintsM.back();
-        }
+            std::string s = st1->getString(0);
+            wxString cname(std2wxIdentifier(s, conv));
+            s = st1->getString(1);
+            wxString fname(std2wxIdentifier(s, conv));
+            s = st1->getString(2);
+            wxString ixname(std2wxIdentifier(s, conv));
 
-        if (!st1->isNull(2))
+            primaryKeyM.setName_(cname);
+            primaryKeyM.columnsM.push_back(fname);
+            primaryKeyM.indexNameM = ixname;
+            break;
+        }
+        case dkUniqueConstraints:
         {
+            std::string s = st1->getString(0);
+            wxString cname(std2wxIdentifier(s, conv));
+            s = st1->getString(1);
+            wxString fname(std2wxIdentifier(s, conv));
             s = st1->getString(2);
+            wxString ixname(std2wxIdentifier(s, conv));
+            if (!uniqueConstraintsM.empty()
+                && uniqueConstraintsM.back().getName_() == cname)
+            {
+                uniqueConstraintsM.back().columnsM.push_back(fname);
+            }
+            else
+            {
+                UniqueConstraint c;
+                uniqueConstraintsM.push_back(c);
+                UniqueConstraint* cc = &uniqueConstraintsM.back();
+                cc->indexNameM = ixname;
+                cc->setName_(cname);
+                cc->columnsM.push_back(fname);
+                cc->setParent(this);
+            }
+            break;
+        }
+        case dkForeignKeys:
+        {
+            std::string s = st1->getString(0);
+            wxString cname(std2wxIdentifier(s, conv));
+            s = st1->getString(1);
             wxString fname(std2wxIdentifier(s, conv));
-            cc->columnsM.push_back(fname);
+            s = st1->getString(2);
+            wxString update_rule(std2wxIdentifier(s, conv));
+            s = st1->getString(3);
+            wxString delete_rule(std2wxIdentifier(s, conv));
+            s = st1->getString(4);
+            wxString rtable(std2wxIdentifier(s, conv));
+            s = st1->getString(5);
+            wxString ixname(std2wxIdentifier(s, conv));
+
+            ForeignKey* fkp = 0;
+            if (!foreignKeysM.empty() && foreignKeysM.back().getName_() == cname)
+                fkp = &foreignKeysM.back();
+            else
+            {
+                ForeignKey fk;
+                foreignKeysM.push_back(fk);
+                fkp = &foreignKeysM.back();
+                fkp->setName_(cname);
+                fkp->setParent(this);
+                fkp->updateActionM = update_rule;
+                fkp->deleteActionM = delete_rule;
+                fkp->indexNameM = ixname;
+                fkp->referencedTableM = rtable;
+            }
+            fkp->columnsM.push_back(fname);
+            if (!st1->isNull(6))
+            {
+                s = st1->getString(6);
+                fkp->referencedColumnsM.push_back(std2wxIdentifier(s, conv));
+            }
+            break;
         }
-    }
-    checkConstraintsLoadedM = true;
-}
-
-//! reads primary key info from database
-void Table::loadPrimaryKey()
-{
-    if (primaryKeyLoadedM)
-        return;
-    primaryKeyM.columnsM.clear();
+        case dkCheckConstraints:
+        {
+            std::string s = st1->getString(0);
+            wxString cname(std2wxIdentifier(s, conv));
+            if (checkConstraintsM.empty()
+                || cname != checkConstraintsM.back().getName_()) // new constraint
+            {
+                wxString source = wxString(st1->getString(1).c_str(), *conv);
 
-    DatabasePtr db = getDatabase();
-    wxMBConv* conv = db->getCharsetConverter();
-    MetadataLoader* loader = db->getMetadataLoader();
-    // first start a transaction for metadata loading, then lock the table
-    // when objects go out of scope and are destroyed, table will be unlocked
-    // before the transaction is committed - any update() calls on observers
-    // can possibly use the same transaction
-    MetadataLoaderTransaction tr(loader);
-    SubjectLocker lock(this);
+                CheckConstraint c;
+                c.setParent(this);
+                c.setName_(cname);
+                c.sourceM = source;
+                checkConstraintsM.push_back(c);
+            }
 
-    fr::IStatementPtr& st1 = loader->getStatement(
-        "select r.rdb$constraint_name, i.rdb$field_name, r.rdb$index_name "
-        "from rdb$relation_constraints r, rdb$index_segments i "
-        "where r.rdb$relation_name=? and r.rdb$index_name=i.rdb$index_name and "
-        "(r.rdb$constraint_type='PRIMARY KEY') order by r.rdb$constraint_name, i.rdb$field_position"
-    );
+            if (!st1->isNull(2))
+            {
+                s = st1->getString(2);
+                wxString fname(std2wxIdentifier(s, conv));
+                checkConstraintsM.back().columnsM.push_back(fname);
+            }
+            break;
+        }
+        case dkIndices:
+        {
+            std::string s = st1->getString(0);
+            wxString ixname(std2wxIdentifier(s, conv));
+
+            short unq, inactive, type;
+            if (st1->isNull(1))     // null = non-unique
+                unq = 0;
+            else
+                unq = (short)st1->getInt32(1);
+            if (st1->isNull(2))     // null = active
+                inactive = 0;
+            else
+                inactive = (short)st1->getInt32(2);
+            if (st1->isNull(3))     // null = ascending
+                type = 0;
+            else
+                type = (short)st1->getInt32(3);
+            double statistics;
+            if (st1->isNull(4))     // this can happen, see bug #1825725
+                statistics = -1;
+            else
+                statistics = st1->getDouble(4);
+
+            s = st1->getString(5);
+            wxString fname(std2wxIdentifier(s, conv));
+            wxString expression = wxString(st1->getString(7).c_str(), *conv);
+            wxString condition = wxString(st1->getString(8).c_str(), *conv);
 
-    st1->setString(0, wx2std(getName_(), conv));
-    st1->execute();
-    while (st1->fetch())
-    {
-        std::string s = st1->getString(0);
-        wxString cname(std2wxIdentifier(s, conv));
-        s = st1->getString(1);
-        wxString fname(std2wxIdentifier(s, conv));
-        s = st1->getString(2);
-        wxString ixname(std2wxIdentifier(s, conv));
-
-        primaryKeyM.setName_(cname);
-        primaryKeyM.columnsM.push_back(fname);
-        primaryKeyM.indexNameM = ixname;
+            if (!indicesM.empty() && indicesM.back().getName_() == ixname)
+                indicesM.back().getSegments()->push_back(fname);
+            else
+            {
+                Index x(
+                    unq == 1,
+                    inactive == 0,
+                    type == 0,
+                    statistics,
+                    !st1->isNull(6),
+                    expression,
+                    condition,
+                    getName_()
+                );
+                indicesM.push_back(x);
+                Index* i = &indicesM.back();
+                i->setName_(ixname);
+                i->getSegments()->push_back(fname);
+                i->setParent(this);
+            }
+            break;
+        }
     }
-    primaryKeyM.setParent(this);
-    primaryKeyLoadedM = true;
 }
 
-//! reads uniques from database
-void Table::loadUniqueConstraints()
+//! reads constraints or indices of this table from database
+void Table::loadDetails(DetailKind kind)
 {
-    if (uniqueConstraintsLoadedM)
+    if (isDetailsLoaded(kind))
         return;
-    uniqueConstraintsM.clear();
+    resetDetails(kind);
 
     DatabasePtr db = getDatabase();
     wxMBConv* conv = db->getCharsetConverter();
@@ -260,42 +462,17 @@ void Table::loadUniqueConstraints()
     SubjectLocker lock(this);
 
     fr::IStatementPtr& st1 = loader->getStatement(
-        "select r.rdb$constraint_name, i.rdb$field_name, r.rdb$index_name "
-        "from rdb$relation_constraints r, rdb$index_segments i "
-        "where r.rdb$relation_name=? and r.rdb$index_name=i.rdb$index_name and "
-        "(r.rdb$constraint_type='UNIQUE') order by r.rdb$constraint_name, i.rdb$field_position"
-    );
-
+        getDetailsSql(db, kind, false));
     st1->setString(0, wx2std(getName_(), conv));
     st1->execute();
-    UniqueConstraint *cc = 0;
     while (st1->fetch())
-    {
-        std::string s = st1->getString(0);
-        wxString cname(std2wxIdentifier(s, conv));
-        s = st1->getString(1);
-        wxString fname(std2wxIdentifier(s, conv));
-        s = st1->getString(2);
-        wxString ixname(std2wxIdentifier(s, conv));
-        if (cc && cc->getName_() == cname)
-            cc->columnsM.push_back(fname);
-        else
-        {
-            UniqueConstraint c;
-            uniqueConstraintsM.push_back(c);
-            cc = &uniqueConstraintsM.back();
-            cc->indexNameM = ixname;
-            cc->setName_(cname);
-            cc->columnsM.push_back(fname);
-            cc->setParent(this);
-        }
-    }
-    uniqueConstraintsLoadedM = true;
+        readDetails(kind, st1, conv);
+    setDetailsLoaded(kind);
 }
 
 PrimaryKeyConstraint *Table::getPrimaryKey()
 {
-    loadPrimaryKey();
+    loadDetails(dkPrimaryKey);
     if (primaryKeyM.columnsM.empty())  // no PK
         return 0;
     return &primaryKeyM;
@@ -303,197 +480,28 @@ PrimaryKeyConstraint *Table::getPrimaryKey()
 
 std::vector<ForeignKey> *Table::getForeignKeys()
 {
-    loadForeignKeys();
+    loadDetails(dkForeignKeys);
     return &foreignKeysM;
 }
 
 std::vector<CheckConstraint> *Table::getCheckConstraints()
 {
-    loadCheckConstraints();
+    loadDetails(dkCheckConstraints);
     return &checkConstraintsM;
 }
 
 std::vector<UniqueConstraint> *Table::getUniqueConstraints()
 {
-    loadUniqueConstraints();
+    loadDetails(dkUniqueConstraints);
     return &uniqueConstraintsM;
 }
 
 std::vector<Index> *Table::getIndices()
 {
-    loadIndices();
+    loadDetails(dkIndices);
     return &indicesM;
 }
 
-//! reads foreign keys info from database
-void Table::loadForeignKeys()
-{
-    if (foreignKeysLoadedM)
-        return;
-    foreignKeysM.clear();
-
-    DatabasePtr db = getDatabase();
-    wxMBConv* conv = db->getCharsetConverter();
-    MetadataLoader* loader = db->getMetadataLoader();
-    // first start a transaction for metadata loading, then lock the table
-    // when objects go out of scope and are destroyed, table will be unlocked
-    // before the transaction is committed - any update() calls on observers
-    // can possibly use the same transaction
-    MetadataLoaderTransaction tr(loader);
-    SubjectLocker lock(this);
-
-    fr::IStatementPtr& st1 = loader->getStatement(
-        "select r.rdb$constraint_name, i.rdb$field_name, c.rdb$update_rule, "
-        " c.rdb$delete_rule, c.RDB$CONST_NAME_UQ, r.rdb$index_name "
-        "from rdb$relation_constraints r, rdb$index_segments i, rdb$ref_constraints c "
-        "where r.rdb$relation_name=? and r.rdb$index_name=i.rdb$index_name  "
-        "and r.rdb$constraint_name = c.rdb$constraint_name "
-        "and (r.rdb$constraint_type='FOREIGN KEY') order by 1, i.rdb$field_position"
-    );
-
-    fr::IStatementPtr& st2 = loader->getStatement(
-        "select r.rdb$relation_name, i.rdb$field_name"
-        " from rdb$relation_constraints r"
-        " join rdb$index_segments i on i.rdb$index_name = r.rdb$index_name "
-        " where r.rdb$constraint_name = ?"
-        " order by i.rdb$field_position "
-    );
-
-    st1->setString(0, wx2std(getName_(), conv));
-    st1->execute();
-    ForeignKey *fkp = 0;
-    while (st1->fetch())
-    {
-        std::string s = st1->getString(0);
-        wxString cname(std2wxIdentifier(s, conv));
-        s = st1->getString(1);
-        wxString fname(std2wxIdentifier(s, conv));
-        s = st1->getString(2);
-        wxString update_rule(std2wxIdentifier(s, conv));
-        s = st1->getString(3);
-        wxString delete_rule(std2wxIdentifier(s, conv));
-        std::string ref_constraint = st1->getString(4);
-        s = st1->getString(5);
-        wxString ixname(std2wxIdentifier(s, conv));
-
-        if (fkp && fkp->getName_() == cname) // add column
-            fkp->columnsM.push_back(fname);
-        else
-        {
-            ForeignKey fk;
-            foreignKeysM.push_back(fk);
-            fkp = &foreignKeysM.back();
-            fkp->setName_(cname);
-            fkp->setParent(this);
-            fkp->updateActionM = update_rule;
-            fkp->deleteActionM = delete_rule;
-            fkp->indexNameM = ixname;
-
-            st2->setString(0, ref_constraint);
-            st2->execute();
-            std::string rtable;
-            while (st2->fetch())
-            {
-                rtable = st2->getString(0);
-                s = st2->getString(1);
-                fkp->referencedColumnsM.push_back(std2wxIdentifier(s, conv));
-            }
-            fkp->referencedTableM = std2wxIdentifier(rtable, conv);
-            fkp->columnsM.push_back(fname);
-        }
-    }
-    foreignKeysLoadedM = true;
-}
-
-//! reads indices from database
-void Table::loadIndices()
-{
-    if (indicesLoadedM)
-        return;
-    indicesM.clear();
-
-    DatabasePtr db = getDatabase();
-    wxMBConv* conv = db->getCharsetConverter();
-    MetadataLoader* loader = db->getMetadataLoader();
-    // first start a transaction for metadata loading, then lock the table
-    // when objects go out of scope and are destroyed, table will be unlocked
-    // before the transaction is committed - any update() calls on observers
-    // can possibly use the same transaction
-    MetadataLoaderTransaction tr(loader);
-    SubjectLocker lock(this);
-
-    std::string sql(
-        "SELECT i.rdb$index_name, i.rdb$unique_flag, i.rdb$index_inactive, "
-        " i.rdb$index_type, i.rdb$statistics, "
-        " s.rdb$field_name, rc.rdb$constraint_name, i.rdb$expression_source, "
-    );
-    sql += db->getInfo().getODSVersionIsHigherOrEqualTo(13, 1) ? " i.rdb$condition_source " : " null ";
-    sql +=
-        " from rdb$indices i "
-        " left join rdb$index_segments s on i.rdb$index_name = s.rdb$index_name "
-        " left join rdb$relation_constraints rc "
-        "   on rc.rdb$index_name = i.rdb$index_name "
-        " where i.rdb$relation_name = ? "
-        " order by i.rdb$index_name, s.rdb$field_position ";
-
-    fr::IStatementPtr& st1 = loader->getStatement(sql);
-
-    st1->setString(0, wx2std(getName_(), conv));
-    st1->execute();
-    Index* i = 0;
-    while (st1->fetch())
-    {
-        std::string s = st1->getString(0);
-        wxString ixname(std2wxIdentifier(s, conv));
-
-        short unq, inactive, type;
-        if (st1->isNull(1))     // null = non-unique
-            unq = 0;
-        else
-            unq = (short)st1->getInt32(1);
-        if (st1->isNull(2))     // null = active
-            inactive = 0;
-        else
-            inactive = (short)st1->getInt32(2);
-        if (st1->isNull(3))     // null = ascending
-            type = 0;
-        else
-            type = (short)st1->getInt32(3);
-        double statistics;
-        if (st1->isNull(4))     // this can happen, see bug #1825725
-            statistics = -1;
-        else
-            statistics = st1->getDouble(4);
-
-        s = st1->getString(5);
-        wxString fname(std2wxIdentifier(s, conv));
-        wxString expression = wxString(st1->getString(7).c_str(), *conv);
-        wxString condition = wxString(st1->getString(8).c_str(), *conv);
-
-        if (i && i->getName_() == ixname)
-            i->getSegments()->push_back(fname);
-        else
-        {
-            Index x(
-                unq == 1,
-                inactive == 0,
-                type == 0,
-                statistics,
-                !st1->isNull(6),
-                expression,
-                condition,
-                getName_()
-            );
-            indicesM.push_back(x);
-            i = &indicesM.back();
-            i->setName_(ixname);
-            i->getSegments()->push_back(fname);
-            i->setParent(this);
-        }
-    }
-    indicesLoadedM = true;
-}
-
 const wxString Table::getTypeName() const
 {
     return "TABLE";
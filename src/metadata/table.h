@@ -32,26 +32,26 @@
 
 class Table: public Relation
 {
+public:
+    enum DetailKind { dkPrimaryKey, dkUniqueConstraints, dkForeignKeys,
+        dkCheckConstraints, dkIndices };
 private:
     PrimaryKeyConstraint primaryKeyM;           // table can have only one pk
     bool primaryKeyLoadedM;
-    void loadPrimaryKey();
 
     std::vector<ForeignKey> foreignKeysM;
     bool foreignKeysLoadedM;
-    void loadForeignKeys();
 
     std::vector<CheckConstraint> checkConstraintsM;
     bool checkConstraintsLoadedM;
-    void loadCheckConstraints();
 
     std::vector<UniqueConstraint> uniqueConstraintsM;
     bool uniqueConstraintsLoadedM;
-    void loadUniqueConstraints();
 
     std::vector<Index> indicesM;
     bool indicesLoadedM;
-    void loadIndices();
+
+    void loadDetails(DetailKind kind);
 
     wxString externalPathM;
     std::map<wxString, wxString> externalCSVOptionsM;
@@ -66,6 +66,17 @@ protected:
 public:
     Table(DatabasePtr database, const wxString& name);
 
+    // used by loadDetails() and Database::loadRelationDetails(): returns
+    // the statement that selects the constraints or indices of this table
+    // (name as parameter) or of all tables (name in the last column), and
+    // reads them row by row between resetDetails() and setDetailsLoaded()
+    static std::string getDetailsSql(DatabasePtr db, DetailKind kind,
+        bool allTables);
+    bool isDetailsLoaded(DetailKind kind) const;
+    void resetDetails(DetailKind kind);
+    void readDetails(DetailKind kind, fr::IStatementPtr& st, wxMBConv* conv);
+    void setDetailsLoaded(DetailKind kind);
+
     static bool tablesRelate(const std::vector<wxString>& tables,
         Table *table, std::vector<ForeignKey>& list);
 
@@ -0,0 +1,146 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <algorithm>
+
+#include "sql/AutoCompleteIndex.h"
+
+AutoCompleteIndex::AutoCompleteIndex()
+{
+}
+
+AutoCompleteIndex::AutoCompleteIndex(const wxArrayString& words)
+{
+    setWords(words);
+}
+
+void AutoCompleteIndex::setWords(const wxArrayString& words)
+{
+    std::vector<Entry> entries;
+    entries.reserve(words.size());
+    for (size_t i = 0; i < words.size(); ++i)
+    {
+        if (words[i].empty())
+            continue;
+        Entry e;
+        e.key = words[i].Upper();
+        e.word = words[i];
+        entries.push_back(e);
+    }
+    // stable, so of the words that only differ in case the first one is kept
+    std::stable_sort(entries.begin(), entries.end(),
+        [](const Entry& left, const Entry& right)
+        {
+            return left.key < right.key;
+        });
+    entries.erase(std::unique(entries.begin(), entries.end(),
+        [](const Entry& left, const Entry& right)
+        {
+            return left.key == right.key;
+        }), entries.end());
+    entriesM.swap(entries);
+}
+
+bool AutoCompleteIndex::empty() const
+{
+    return entriesM.empty();
+}
+
+size_t AutoCompleteIndex::size() const
+{
+    return entriesM.size();
+}
+
+AutoCompleteIndex::const_iterator AutoCompleteIndex::lowerBound(
+    const wxString& key) const
+{
+    return std::lower_bound(entriesM.begin(), entriesM.end(), key,
+        [](const Entry& entry, const wxString& value)
+        {
+            return entry.key < value;
+        });
+}
+
+bool AutoCompleteIndex::hasPrefix(const wxString& prefix) const
+{
+    wxString key(prefix.Upper());
+    const_iterator it = lowerBound(key);
+    return it != entriesM.end() && it->key.StartsWith(key);
+}
+
+void AutoCompleteIndex::getWords(const wxString& prefix,
+    wxArrayString& words) const
+{
+    wxString key(prefix.Upper());
+    for (const_iterator it = lowerBound(key);
+        it != entriesM.end() && it->key.StartsWith(key); ++it)
+    {
+        words.push_back(it->word);
+    }
+}
+
+wxString AutoCompleteIndex::getCompletionList(const wxString& prefix,
+    const std::vector<const AutoCompleteIndex*>& indices)
+{
+    // only the matches are merged, so this doesn't depend on the number of
+    // words in the indices
+    wxString key(prefix.Upper());
+    std::vector<const Entry*> matches;
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        if (!indices[i])
+            continue;
+        for (const_iterator it = indices[i]->lowerBound(key);
+            it != indices[i]->entriesM.end() && it->key.StartsWith(key); ++it)
+        {
+            matches.push_back(&(*it));
+        }
+    }
+    std::stable_sort(matches.begin(), matches.end(),
+        [](const Entry* left, const Entry* right)
+        {
+            return left->key < right->key;
+        });
+
+    wxString list;
+    const Entry* last = 0;
+    for (size_t i = 0; i < matches.size(); ++i)
+    {
+        if (last && last->key == matches[i]->key)
+            continue;
+        if (last)
+            list += " ";
+        list += matches[i]->word;
+        last = matches[i];
+    }
+    return list;
+}
@@ -0,0 +1,72 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_AUTOCOMPLETEINDEX_H
+#define FR_AUTOCOMPLETEINDEX_H
+
+#include <wx/arrstr.h>
+#include <wx/string.h>
+
+#include <vector>
+
+// AutoCompleteIndex class
+// Words for the autocomplete list of the SQL editor, sorted once by their
+// upper case spelling. That is the order the editor control expects with
+// case insensitive matching, and it keeps all words with the same prefix
+// next to each other, so the completions of a prefix are found with a
+// binary search instead of going through all words.
+class AutoCompleteIndex
+{
+private:
+    struct Entry
+    {
+        wxString key;
+        wxString word;
+    };
+    // sorted by key, without words that only differ in case
+    std::vector<Entry> entriesM;
+
+    typedef std::vector<Entry>::const_iterator const_iterator;
+    const_iterator lowerBound(const wxString& key) const;
+public:
+    AutoCompleteIndex();
+    AutoCompleteIndex(const wxArrayString& words);
+
+    void setWords(const wxArrayString& words);
+    bool empty() const;
+    size_t size() const;
+
+    // true if any word starts with prefix, case insensitive
+    bool hasPrefix(const wxString& prefix) const;
+    // appends the words that start with prefix, case insensitive, in the
+    // order of the index
+    void getWords(const wxString& prefix, wxArrayString& words) const;
+
+    // the words of all indices that start with prefix as a space separated
+    // list for wxStyledTextCtrl::AutoCompShow(), sorted and without words
+    // that only differ in case; for these the first index wins
+    static wxString getCompletionList(const wxString& prefix,
+        const std::vector<const AutoCompleteIndex*>& indices);
+};
+
+#endif // FR_AUTOCOMPLETEINDEX_H
@@ -0,0 +1,200 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include "sql/AutoCompleteIndex.h"
+
+namespace
+{
+
+bool check(bool condition, const char* testName)
+{
+    if (condition)
+    {
+        std::cout << "  PASSED: " << testName << "\n";
+        return true;
+    }
+    std::cout << "  FAILED: " << testName << "\n";
+    return false;
+}
+
+wxArrayString makeArray(const char* const* words, size_t count)
+{
+    wxArrayString result;
+    for (size_t i = 0; i < count; ++i)
+        result.Add(words[i]);
+    return result;
+}
+
+// the list as the editor built it before the index existed: all words
+// sorted and deduplicated on every completion
+wxString buildFullList(const wxArrayString& keywords,
+    const wxArrayString& columns)
+{
+    wxArrayString as(columns);
+    for (size_t i = 0; i < keywords.size(); ++i)
+        as.Add(keywords[i]);
+    std::vector<wxString> sorted(as.begin(), as.end());
+    std::sort(sorted.begin(), sorted.end(),
+        [](const wxString& one, const wxString& two)
+        {
+            return one.Upper() < two.Upper();
+        });
+    wxString list, lastUpper;
+    for (size_t i = 0; i < sorted.size(); ++i)
+    {
+        wxString upper(sorted[i].Upper());
+        if (upper != lastUpper)
+        {
+            list += sorted[i] + " ";
+            lastUpper = upper;
+        }
+    }
+    return list;
+}
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = true;
+    std::cout << "Running AutoCompleteIndex Tests...\n";
+
+    const char* const keywords[] = { "SELECT", "SET", "SEQUENCE", "FROM",
+        "WHERE", "ORDER", "SUM", "SUBSTRING" };
+    AutoCompleteIndex keywordIndex(makeArray(keywords, 8));
+
+    // Test 1: words with a prefix, case insensitive
+    {
+        wxArrayString words;
+        keywordIndex.getWords("se", words);
+        ok = check(words.size() == 3 && words[0] == "SELECT"
+            && words[1] == "SEQUENCE" && words[2] == "SET",
+            "Words with prefix in order") && ok;
+        ok = check(keywordIndex.hasPrefix("Su") && !keywordIndex.hasPrefix("sx")
+            && !keywordIndex.hasPrefix("WHEREVER"), "Prefix lookup") && ok;
+        words.clear();
+        keywordIndex.getWords("", words);
+        ok = check(words.size() == keywordIndex.size(), "Empty prefix matches all") && ok;
+    }
+
+    // Test 2: underscore sorts after the letters, like the editor expects
+    {
+        const char* const names[] = { "T_A", "TAB", "T_", "TZ", "tab" };
+        AutoCompleteIndex index(makeArray(names, 5));
+        wxArrayString words;
+        index.getWords("t", words);
+        ok = check(words.size() == 4 && words[0] == "TAB" && words[1] == "TZ"
+            && words[2] == "T_" && words[3] == "T_A",
+            "Underscore after letters, duplicates removed") && ok;
+    }
+
+    // Test 3: several indices are merged, the first one wins
+    {
+        const char* const names[] = { "SALES", "Set", "\"select\"", "SHIPMENTS" };
+        AutoCompleteIndex nameIndex(makeArray(names, 4));
+        const char* const columns[] = { "SALARY", "set" };
+        AutoCompleteIndex columnIndex(makeArray(columns, 2));
+        std::vector<const AutoCompleteIndex*> indices;
+        indices.push_back(&columnIndex);
+        indices.push_back(&keywordIndex);
+        indices.push_back(&nameIndex);
+        ok = check(AutoCompleteIndex::getCompletionList("s", indices)
+            == "SALARY SALES SELECT SEQUENCE set SHIPMENTS SUBSTRING SUM",
+            "Completion list merged and deduplicated") && ok;
+        ok = check(AutoCompleteIndex::getCompletionList("xyz", indices).empty(),
+            "No completions for unknown prefix") && ok;
+    }
+
+    // Test 4: a database with 10k objects
+    {
+        wxArrayString objectNames, keywordList;
+        for (int i = 0; i < 10000; ++i)
+            objectNames.Add(wxString::Format("OBJECT_%05d", i));
+        for (int i = 0; i < 1000; ++i)
+            keywordList.Add(wxString::Format("KEYWORD%04d", i));
+        wxArrayString all(keywordList);
+        for (size_t i = 0; i < objectNames.size(); ++i)
+            all.Add(objectNames[i]);
+        wxArrayString columns;
+        for (int i = 0; i < 20; ++i)
+            columns.Add(wxString::Format("COLUMN_%d", i));
+
+        auto start = std::chrono::steady_clock::now();
+        AutoCompleteIndex words(all);
+        double buildMs = elapsedMs(start);
+
+        const int completions = 1000;
+        size_t total = 0;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < completions; ++i)
+        {
+            AutoCompleteIndex columnIndex(columns);
+            std::vector<const AutoCompleteIndex*> indices;
+            indices.push_back(&columnIndex);
+            indices.push_back(&words);
+            total += AutoCompleteIndex::getCompletionList(
+                wxString::Format("OBJECT_%03d", i % 100), indices).size();
+        }
+        double indexMs = elapsedMs(start) / completions;
+
+        const int fullCount = 20;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < fullCount; ++i)
+            total += buildFullList(all, columns).size();
+        double fullMs = elapsedMs(start) / fullCount;
+
+        std::cout << "  INFO: index of " << words.size() << " words built in "
+                  << buildMs << " ms, completion " << indexMs
+                  << " ms, full list rebuild " << fullMs << " ms\n";
+        ok = check(total > 0 && indexMs * 10 < fullMs,
+            "Completion is at least 10x faster than a full rebuild") && ok;
+
+        std::vector<const AutoCompleteIndex*> indices(1, &words);
+        wxString list = AutoCompleteIndex::getCompletionList("object_0001", indices);
+        ok = check(list.StartsWith("OBJECT_00010 ") && list.EndsWith("OBJECT_00019"),
+            "Completions of a 10k word index") && ok;
+    }
+
+    std::cout << "AutoCompleteIndex Tests completed: "
+              << (ok ? "ALL PASSED" : "SOME FAILED") << "\n";
+    return ok ? 0 : 1;
+}
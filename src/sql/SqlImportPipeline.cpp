@@ -0,0 +1,440 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include <chrono>
+#include <exception>
+
+#include "core/StringUtils.h"
+#include "sql/SqlImportPipeline.h"
+#include "sql/SqlTokenizer.h"
+
+namespace
+{
+
+struct ParsedInsert
+{
+    bool isValid = false;
+    wxString tableName;
+    wxArrayString columns;
+    wxArrayString values;
+    std::vector<SqlTokenType> valueTypes;
+};
+
+// sign, digits, decimal point and exponent only, as hex and binary
+// literals aren't converted from text by the server
+bool isDecimalLiteral(const wxString& s)
+{
+    size_t i = 0;
+    if (i < s.length() && (s[i] == '-' || s[i] == '+'))
+        ++i;
+    size_t digits = 0;
+    bool point = false;
+    for (; i < s.length(); ++i)
+    {
+        if (s[i] >= '0' && s[i] <= '9')
+            ++digits;
+        else if (s[i] == '.' && !point)
+            point = true;
+        else
+            break;
+    }
+    if (!digits)
+        return false;
+    if (i < s.length() && (s[i] == 'e' || s[i] == 'E'))
+    {
+        ++i;
+        if (i < s.length() && (s[i] == '-' || s[i] == '+'))
+            ++i;
+        digits = 0;
+        for (; i < s.length() && s[i] >= '0' && s[i] <= '9'; ++i)
+            ++digits;
+        if (!digits)
+            return false;
+    }
+    return i == s.length();
+}
+
+ParsedInsert parseInsertStatement(const wxString& sql)
+{
+    ParsedInsert pi;
+    SqlTokenizer tokenizer(sql);
+    // statements of a script start with the line break and comments
+    // after the previous terminator
+    while (tokenizer.getCurrentToken() == tkWHITESPACE
+        || tokenizer.getCurrentToken() == tkCOMMENT)
+    {
+        tokenizer.nextToken();
+    }
+
+    if (tokenizer.getCurrentToken() != kwINSERT)
+        return pi;
+    if (!tokenizer.jumpToken(false)) return pi;
+
+    if (tokenizer.getCurrentToken() != kwINTO)
+        return pi;
+    if (!tokenizer.jumpToken(false)) return pi;
+
+    if (tokenizer.getCurrentToken() != tkIDENTIFIER && !tokenizer.isKeywordToken())
+        return pi;
+    pi.tableName = tokenizer.getCurrentTokenString();
+    if (!tokenizer.jumpToken(false)) return pi;
+
+    if (tokenizer.getCurrentToken() == tkPARENOPEN)
+    {
+        if (!tokenizer.jumpToken(false)) return pi;
+        while (true)
+        {
+            if (tokenizer.getCurrentToken() != tkIDENTIFIER && !tokenizer.isKeywordToken())
+                return pi;
+            pi.columns.Add(tokenizer.getCurrentTokenString());
+            if (!tokenizer.jumpToken(false)) return pi;
+
+            if (tokenizer.getCurrentToken() == tkPARENCLOSE)
+            {
+                if (!tokenizer.jumpToken(false)) return pi;
+                break;
+            }
+            if (tokenizer.getCurrentToken() == tkCOMMA)
+            {
+                if (!tokenizer.jumpToken(false)) return pi;
+                continue;
+            }
+            return pi;
+        }
+    }
+
+    if (tokenizer.getCurrentToken() != kwVALUES)
+        return pi;
+    if (!tokenizer.jumpToken(false)) return pi;
+
+    if (tokenizer.getCurrentToken() != tkPARENOPEN)
+        return pi;
+    if (!tokenizer.jumpToken(false)) return pi;
+
+    while (true)
+    {
+        SqlTokenType tType = tokenizer.getCurrentToken();
+        wxString tStr = tokenizer.getCurrentTokenString();
+
+        if (tStr == "-" || tStr == "+")
+        {
+            if (!tokenizer.jumpToken(false)) return pi;
+            tStr += tokenizer.getCurrentTokenString();
+            tType = tkNUMBER;
+        }
+
+        // only literals can be bound as parameters, everything else
+        // (CURRENT_TIMESTAMP, TRUE, expressions...) is executed unchanged
+        if (tType == tkSTRING)
+        {
+            if (!tStr.StartsWith("'"))
+                return pi;
+        }
+        else if (tType != kwNULL)
+        {
+            // a sign directly before the digits isn't split from them
+            if (!isDecimalLiteral(tStr))
+                return pi;
+            tType = tkNUMBER;
+        }
+
+        pi.values.Add(tStr);
+        pi.valueTypes.push_back(tType);
+        if (!tokenizer.jumpToken(false)) return pi;
+
+        if (tokenizer.getCurrentToken() == tkPARENCLOSE)
+        {
+            break;
+        }
+        if (tokenizer.getCurrentToken() == tkCOMMA)
+        {
+            if (!tokenizer.jumpToken(false)) return pi;
+            continue;
+        }
+        return pi;
+    }
+
+    // anything after the value list (RETURNING...) can't be batched
+    if (tokenizer.jumpToken(false))
+    {
+        if (tokenizer.getCurrentToken() != tkTERM || tokenizer.jumpToken(false))
+            return pi;
+    }
+
+    pi.isValid = true;
+    return pi;
+}
+
+std::string unescapeSqlString(const std::string& s)
+{
+    if (s.size() >= 2 && s.front() == '\'' && s.back() == '\'')
+    {
+        std::string res;
+        res.reserve(s.size() - 2);
+        for (size_t i = 1; i < s.size() - 1; ++i)
+        {
+            if (s[i] == '\'' && i + 1 < s.size() - 1 && s[i+1] == '\'')
+            {
+                res.push_back('\'');
+                ++i;
+            }
+            else
+            {
+                res.push_back(s[i]);
+            }
+        }
+        return res;
+    }
+    return s;
+}
+
+} // namespace
+
+SqlImportGroup::SqlImportGroup()
+    : kind(kindStatement), columnCount(0), statementCount(0), byteCount(0),
+        endOffset(0), utf8(true)
+{
+}
+
+size_t SqlImportGroup::getRowCount() const
+{
+    return columnCount ? values.size() / columnCount : 0;
+}
+
+SqlImportPipeline::SqlImportPipeline(wxMBConv* converter, size_t batchRows)
+    : converterM(converter), batchRowsM(batchRows ? batchRows : 1),
+        lastOffsetM(0), cancelM(false), finishedM(false)
+{
+}
+
+SqlImportPipeline::~SqlImportPipeline()
+{
+    cancel();
+    if (threadM.joinable())
+        threadM.join();
+}
+
+bool SqlImportPipeline::open(const wxString& fileName,
+    wxFileOffset startOffset, const wxString& terminator, bool utf8)
+{
+    wxASSERT(!threadM.joinable());
+    if (!readerM.open(fileName, startOffset, terminator, utf8))
+        return false;
+    lastOffsetM = readerM.getOffset();
+    return true;
+}
+
+void SqlImportPipeline::start()
+{
+    wxASSERT(!threadM.joinable());
+    cancelM = false;
+    finishedM = false;
+    // the worker must not be the first to touch the config
+    SqlTokenizer::initialize();
+    threadM = std::thread([this]() {
+        run();
+    });
+}
+
+void SqlImportPipeline::cancel()
+{
+    std::lock_guard<std::mutex> lock(mutexM);
+    cancelM = true;
+    spaceM.notify_all();
+}
+
+bool SqlImportPipeline::push(SqlImportGroup& group)
+{
+    group.byteCount = group.endOffset - lastOffsetM;
+    lastOffsetM = group.endOffset;
+
+    std::unique_lock<std::mutex> lock(mutexM);
+    spaceM.wait(lock, [this]() {
+        return cancelM || queueM.size() < queueSize;
+    });
+    if (cancelM)
+        return false;
+    queueM.push_back(std::move(group));
+    readyM.notify_one();
+    return true;
+}
+
+void SqlImportPipeline::run()
+{
+    try
+    {
+        SqlImportGroup batch;
+        wxString batchTable;
+        wxArrayString batchColumns;
+        size_t batchBytes = 0;
+        auto flushBatch = [&]() -> bool {
+            if (!batch.statementCount)
+                return true;
+            bool pushed = push(batch);
+            batch = SqlImportGroup();
+            batchBytes = 0;
+            return pushed;
+        };
+
+        bool ok = true;
+        SingleStatement ss;
+        while (ok && readerM.next(ss))
+        {
+            wxString setting;
+            if (ss.isSetAutoDDLStatement(setting))
+                continue;
+
+            if (ss.isCommitStatement() || ss.isRollbackStatement())
+            {
+                SqlImportGroup group;
+                group.kind = ss.isCommitStatement() ? SqlImportGroup::kindCommit
+                    : SqlImportGroup::kindRollback;
+                group.statementCount = 1;
+                group.endOffset = readerM.getOffset();
+                group.endTerminator = readerM.getTerminator();
+                group.utf8 = readerM.isUtf8();
+                ok = flushBatch() && push(group);
+                continue;
+            }
+
+            wxString sql(ss.getSql());
+            ParsedInsert pi = parseInsertStatement(sql);
+            if (!pi.isValid)
+            {
+                SqlImportGroup group;
+                group.sql = sql;
+                group.statementCount = 1;
+                group.endOffset = readerM.getOffset();
+                group.endTerminator = readerM.getTerminator();
+                group.utf8 = readerM.isUtf8();
+                ok = flushBatch() && push(group);
+                continue;
+            }
+
+            // only consecutive rows go into one batch, so the rows are
+            // inserted in the order of the script
+            bool sameTarget = batch.statementCount
+                && batchTable == pi.tableName && batchColumns == pi.columns
+                && batch.columnCount == pi.values.size();
+            if (!sameTarget || batch.statementCount >= batchRowsM
+                || batchBytes >= maxBatchBytes)
+            {
+                ok = flushBatch();
+                if (!ok)
+                    break;
+            }
+            if (!batch.statementCount)
+            {
+                wxString prepSql = "INSERT INTO " + pi.tableName;
+                if (!pi.columns.IsEmpty())
+                {
+                    prepSql += " (";
+                    for (size_t i = 0; i < pi.columns.size(); ++i)
+                    {
+                        if (i > 0) prepSql += ", ";
+                        prepSql += pi.columns[i];
+                    }
+                    prepSql += ")";
+                }
+                prepSql += " VALUES (";
+                for (size_t i = 0; i < pi.values.size(); ++i)
+                {
+                    if (i > 0) prepSql += ", ";
+                    prepSql += "?";
+                }
+                prepSql += ")";
+
+                batch.kind = SqlImportGroup::kindInsertBatch;
+                batch.sql = prepSql;
+                batch.columnCount = pi.values.size();
+                batchTable = pi.tableName;
+                batchColumns = pi.columns;
+            }
+
+            for (size_t c = 0; c < pi.values.size(); ++c)
+            {
+                bool isNull = pi.valueTypes[c] == kwNULL;
+                std::string value;
+                if (pi.valueTypes[c] == tkSTRING)
+                    value = unescapeSqlString(wx2std(pi.values[c], converterM));
+                else if (!isNull)
+                    value = wx2std(pi.values[c], converterM);
+                batchBytes += value.size();
+                batch.values.push_back(std::move(value));
+                batch.nulls.push_back(isNull);
+            }
+            ++batch.statementCount;
+            batch.endOffset = readerM.getOffset();
+            batch.endTerminator = readerM.getTerminator();
+            batch.utf8 = readerM.isUtf8();
+        }
+        if (ok)
+            flushBatch();
+    }
+    catch (const std::exception& e)
+    {
+        std::lock_guard<std::mutex> lock(mutexM);
+        errorM = wxString::FromUTF8(e.what());
+    }
+
+    std::lock_guard<std::mutex> lock(mutexM);
+    finishedM = true;
+    readyM.notify_all();
+}
+
+SqlImportPipeline::Status SqlImportPipeline::next(SqlImportGroup& group,
+    int timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(mutexM);
+    readyM.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]() {
+        return finishedM || !queueM.empty();
+    });
+    if (!queueM.empty())
+    {
+        group = std::move(queueM.front());
+        queueM.pop_front();
+        spaceM.notify_one();
+        return statusGroup;
+    }
+    return finishedM ? statusFinished : statusWaiting;
+}
+
+wxFileOffset SqlImportPipeline::getLength() const
+{
+    return readerM.getLength();
+}
+
+wxString SqlImportPipeline::getError()
+{
+    std::lock_guard<std::mutex> lock(mutexM);
+    return errorM;
+}
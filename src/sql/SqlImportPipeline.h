@@ -0,0 +1,115 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_SQLIMPORTPIPELINE_H
+#define FR_SQLIMPORTPIPELINE_H
+
+#include <wx/string.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sql/SqlScriptReader.h"
+
+// SqlImportGroup class
+// A unit of work of a script import: a single statement, the rows of
+// consecutive INSERT statements into the same table that are executed as
+// one batch, or a COMMIT / ROLLBACK of the script.
+struct SqlImportGroup
+{
+    enum Kind { kindStatement, kindInsertBatch, kindCommit, kindRollback };
+
+    Kind kind;
+    // the statement; for batches an INSERT with one parameter per value
+    wxString sql;
+    // for batches: the values of all rows, columnCount values per row, in
+    // the connection character set with string literals unquoted
+    size_t columnCount;
+    std::vector<std::string> values;
+    std::vector<char> nulls;
+    // number of script statements in this group
+    size_t statementCount;
+    // number of script bytes since the end of the previous group
+    wxFileOffset byteCount;
+    // file offset and terminator after the last statement of the group,
+    // reading can be continued there once the group has been committed,
+    // with the encoding the file is read in
+    wxFileOffset endOffset;
+    wxString endTerminator;
+    bool utf8;
+
+    SqlImportGroup();
+    size_t getRowCount() const;
+};
+
+// SqlImportPipeline class
+// Reads and parses an SQL script on a worker thread, while the caller
+// executes the groups that have been prepared already. At most queueSize
+// groups are waiting to be executed, so the memory needed does not depend
+// on the size of the script.
+class SqlImportPipeline
+{
+public:
+    enum Status { statusGroup, statusWaiting, statusFinished };
+    enum { queueSize = 4, maxBatchBytes = 16 * 1024 * 1024 };
+private:
+    SqlScriptReader readerM;
+    wxMBConv* converterM;
+    size_t batchRowsM;
+    wxFileOffset lastOffsetM;
+
+    std::thread threadM;
+    std::mutex mutexM;
+    std::condition_variable spaceM;
+    std::condition_variable readyM;
+    std::deque<SqlImportGroup> queueM;
+    bool cancelM;
+    bool finishedM;
+    wxString errorM;
+
+    void run();
+    bool push(SqlImportGroup& group);
+public:
+    // rows of consecutive INSERT statements are grouped into batches of
+    // at most batchRows rows
+    SqlImportPipeline(wxMBConv* converter, size_t batchRows);
+    ~SqlImportPipeline();
+
+    // see SqlScriptReader::open()
+    bool open(const wxString& fileName, wxFileOffset startOffset = 0,
+        const wxString& terminator = ";", bool utf8 = true);
+    void start();
+    void cancel();
+
+    // waits at most timeoutMs milliseconds for the next group
+    Status next(SqlImportGroup& group, int timeoutMs);
+    wxFileOffset getLength() const;
+    // the reason why reading stopped early, valid after statusFinished
+    wxString getError();
+};
+
+#endif
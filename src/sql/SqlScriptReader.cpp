@@ -0,0 +1,295 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include "core/FRError.h"
+#include "sql/SqlScriptReader.h"
+
+namespace
+{
+
+// number of bytes the UTF-8 encoding of c takes
+inline size_t getUtf8Length(wxChar c)
+{
+    unsigned long u = (unsigned long)c;
+    if (u < 0x80)
+        return 1;
+    if (u < 0x800)
+        return 2;
+    // each half of a UTF-16 surrogate pair stands for 2 of the 4 bytes
+    if (u >= 0xD800 && u <= 0xDFFF)
+        return 2;
+    if (u < 0x10000)
+        return 3;
+    return 4;
+}
+
+} // namespace
+
+SqlScriptReader::SqlScriptReader()
+    : lengthM(0), readOffsetM(0), eofM(true), utf8M(true), startPosM(0),
+        scanPosM(0), startOffsetM(0), scanOffsetM(0), stateM(ssNormal),
+        statementOffsetM(0), offsetM(0)
+{
+}
+
+bool SqlScriptReader::open(const wxString& fileName, wxFileOffset startOffset,
+    const wxString& terminator, bool utf8)
+{
+    if (fileM.IsOpened())
+        fileM.Close();
+    if (!fileM.Open(fileName))
+        return false;
+    lengthM = fileM.Length();
+    if (startOffset < 0 || startOffset > lengthM)
+        startOffset = 0;
+    if (startOffset == 0)
+        utf8 = true;
+    if (startOffset > 0 && fileM.Seek(startOffset) == wxInvalidOffset)
+        return false;
+
+    readOffsetM = startOffset;
+    eofM = false;
+    utf8M = utf8;
+    pendingM.clear();
+    textM.clear();
+    startPosM = scanPosM = 0;
+    startOffsetM = scanOffsetM = startOffset;
+    stateM = ssNormal;
+    terminatorM = terminator;
+    statementOffsetM = offsetM = startOffset;
+    offsetTerminatorM = terminator;
+    return true;
+}
+
+bool SqlScriptReader::readChunk()
+{
+    if (eofM)
+        return false;
+
+    std::string bytes(pendingM);
+    size_t start = bytes.size();
+    bytes.resize(start + chunkSize);
+    bool firstChunk = readOffsetM == 0;
+    ssize_t count = fileM.Read(&bytes[start], chunkSize);
+    if (count == wxInvalidOffset)
+        throw FRError(_("Could not read the script file."));
+    bytes.resize(start + count);
+    readOffsetM += count;
+    if (count < chunkSize || readOffsetM >= lengthM)
+        eofM = true;
+
+    // skip the UTF-8 byte order mark, it is not part of the first statement
+    start = 0;
+    if (firstChunk && bytes.compare(0, 3, "\xEF\xBB\xBF") == 0)
+    {
+        start = 3;
+        startOffsetM += 3;
+        scanOffsetM += 3;
+    }
+
+    // keep an incomplete UTF-8 sequence for the next chunk
+    size_t end = bytes.size();
+    if (utf8M && !eofM && end > start)
+    {
+        size_t lead = end - 1;
+        while (lead > start && end - lead < 4
+            && (bytes[lead] & 0xC0) == 0x80)
+        {
+            --lead;
+        }
+        unsigned char c = bytes[lead];
+        size_t needed = c >= 0xF0 ? 4 : (c >= 0xE0 ? 3 : (c >= 0xC0 ? 2 : 1));
+        if (end - lead < needed)
+            end = lead;
+    }
+    pendingM.assign(bytes, end, std::string::npos);
+
+    wxString text;
+    if (utf8M && end > start)
+    {
+        text = wxString::FromUTF8(bytes.data() + start, end - start);
+        if (text.empty())
+        {
+            // like wxConvAuto, read files that aren't UTF-8 as ISO-8859-1,
+            // but that has to be decided before any text has been split
+            if (!firstChunk)
+                throw FRError(_("The script file is not valid UTF-8."));
+            utf8M = false;
+        }
+    }
+    if (!utf8M)
+    {
+        text = wxString(bytes.data() + start, wxConvISO8859_1, end - start);
+        pendingM.clear();
+    }
+
+    // drop the text of the statements that were returned already
+    textM.erase(0, startPosM);
+    scanPosM -= startPosM;
+    startPosM = 0;
+    textM += text;
+    return true;
+}
+
+bool SqlScriptReader::ensure(size_t count)
+{
+    while (scanPosM + count > textM.length())
+    {
+        if (!readChunk())
+            return false;
+    }
+    return true;
+}
+
+void SqlScriptReader::advance(size_t count)
+{
+    for (size_t end = scanPosM + count; scanPosM < end; ++scanPosM)
+        scanOffsetM += utf8M ? getUtf8Length(textM[scanPosM]) : 1;
+}
+
+bool SqlScriptReader::emit(const wxString& sql, SingleStatement& statement)
+{
+    SingleStatement ss(sql);
+    wxFileOffset statementStart = startOffsetM;
+    startPosM = scanPosM;
+    startOffsetM = scanOffsetM;
+
+    wxString newTerm;
+    if (ss.isSetTermStatement(newTerm))
+    {
+        if (newTerm.empty())
+            throw FRError(_("SET TERM statement without new terminator."));
+        terminatorM = newTerm;
+        return false;
+    }
+    if (ss.isEmptyStatement())
+        return false;
+
+    statement = ss;
+    statementOffsetM = statementStart;
+    offsetM = scanOffsetM;
+    offsetTerminatorM = terminatorM;
+    return true;
+}
+
+bool SqlScriptReader::next(SingleStatement& statement)
+{
+    while (true)
+    {
+        if (scanPosM >= textM.length() && !ensure(1))
+        {
+            // the rest of the file is the last statement, even without
+            // a terminator
+            if (startPosM >= textM.length())
+                return false;
+            wxString sql(textM.substr(startPosM));
+            if (emit(sql, statement))
+                return true;
+            continue;
+        }
+
+        wxChar c = textM[scanPosM];
+        switch (stateM)
+        {
+            case ssQuote:
+                if (c == '\'')
+                    stateM = ssNormal;
+                break;
+            case ssLineComment:
+                if (c == '\n')
+                    stateM = ssNormal;
+                break;
+            case ssBlockComment:
+                if (c == '*' && ensure(2) && textM[scanPosM + 1] == '/')
+                {
+                    stateM = ssNormal;
+                    advance(2);
+                    continue;
+                }
+                break;
+            case ssNormal:
+                if (c == '\'')
+                    stateM = ssQuote;
+                else if ((c == '-' || c == '/') && ensure(2))
+                {
+                    wxChar c2 = textM[scanPosM + 1];
+                    if (c == '-' && c2 == '-')
+                        stateM = ssLineComment;
+                    else if (c == '/' && c2 == '*')
+                        stateM = ssBlockComment;
+                    if (stateM != ssNormal)
+                    {
+                        advance(2);
+                        continue;
+                    }
+                }
+                else if (!terminatorM.empty() && c == terminatorM[0]
+                    && ensure(terminatorM.length())
+                    && textM.compare(scanPosM, terminatorM.length(),
+                        terminatorM) == 0)
+                {
+                    wxString sql(textM.substr(startPosM, scanPosM - startPosM));
+                    advance(terminatorM.length());
+                    if (emit(sql, statement))
+                        return true;
+                    continue;
+                }
+                break;
+        }
+        advance(1);
+    }
+}
+
+wxFileOffset SqlScriptReader::getLength() const
+{
+    return lengthM;
+}
+
+wxFileOffset SqlScriptReader::getOffset() const
+{
+    return offsetM;
+}
+
+wxFileOffset SqlScriptReader::getStatementOffset() const
+{
+    return statementOffsetM;
+}
+
+wxString SqlScriptReader::getTerminator() const
+{
+    return offsetTerminatorM;
+}
+
+bool SqlScriptReader::isUtf8() const
+{
+    return utf8M;
+}
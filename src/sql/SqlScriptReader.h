@@ -0,0 +1,100 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef FR_SQLSCRIPTREADER_H
+#define FR_SQLSCRIPTREADER_H
+
+#include <wx/file.h>
+#include <wx/string.h>
+
+#include <string>
+
+#include "sql/MultiStatement.h"
+
+// SqlScriptReader class
+// Splits a script file into statements while reading it in chunks, so
+// only the chunk that is being split has to be held in memory. Strings,
+// comments and SET TERM are handled like MultiStatement does, also when
+// they span chunks. For every statement the file offset after its
+// terminator is known, which allows to continue reading a script at any
+// statement boundary later.
+class SqlScriptReader
+{
+public:
+    enum { chunkSize = 4 * 1024 * 1024 };
+private:
+    enum ScanState { ssNormal, ssQuote, ssLineComment, ssBlockComment };
+
+    wxFile fileM;
+    wxFileOffset lengthM;
+    wxFileOffset readOffsetM;
+    bool eofM;
+    bool utf8M;
+    // bytes of an incomplete UTF-8 sequence at the end of the last chunk
+    std::string pendingM;
+
+    // decoded text, the statement being split starts at startPosM
+    wxString textM;
+    size_t startPosM;
+    size_t scanPosM;
+    wxFileOffset startOffsetM;
+    wxFileOffset scanOffsetM;
+    ScanState stateM;
+    wxString terminatorM;
+
+    // position and terminator after the last returned statement
+    wxFileOffset statementOffsetM;
+    wxFileOffset offsetM;
+    wxString offsetTerminatorM;
+
+    bool readChunk();
+    bool ensure(size_t count);
+    void advance(size_t count);
+    bool emit(const wxString& sql, SingleStatement& statement);
+public:
+    SqlScriptReader();
+
+    // opens fileName and positions it at startOffset, which has to be a
+    // statement boundary returned by getOffset(); terminator is the one in
+    // effect at that position. The encoding is only detected when reading
+    // from the start, when continuing utf8 has to be what isUtf8() returned
+    bool open(const wxString& fileName, wxFileOffset startOffset = 0,
+        const wxString& terminator = ";", bool utf8 = true);
+
+    // returns the next non-empty statement, false at the end of the file;
+    // throws FRError if the file can not be read or decoded, or if a
+    // SET TERM statement has no new terminator
+    bool next(SingleStatement& statement);
+
+    wxFileOffset getLength() const;
+    // file offset after the terminator of the last returned statement
+    wxFileOffset getOffset() const;
+    // file offset where the last returned statement starts
+    wxFileOffset getStatementOffset() const;
+    // terminator in effect at getOffset()
+    wxString getTerminator() const;
+    // false if the file isn't valid UTF-8 and is read as ISO-8859-1
+    bool isUtf8() const;
+};
+
+#endif
@@ -0,0 +1,319 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// For compilers that support precompilation, includes "wx/wx.h".
+#include "wx/wxprec.h"
+
+// for all others, include the necessary headers (this file is usually all you
+// need because it includes almost all "standard" wxWindows headers
+#ifndef WX_PRECOMP
+    #include "wx/wx.h"
+#endif
+
+#include "sql/SqlImportPipeline.h"
+#include "sql/SqlScriptReader.h"
+
+namespace
+{
+
+bool check(bool condition, const char* testName)
+{
+    if (condition)
+        return true;
+    std::cerr << testName << " failed.\n";
+    return false;
+}
+
+const char* const fileName = "sql_script_reader_test.sql";
+
+void writeFile(const std::string& content)
+{
+    std::ofstream out(fileName, std::ios::binary);
+    out << content;
+}
+
+// a script of more than two chunks, with strings, comments, multi-byte
+// characters and SET TERM blocks crossing the chunk boundaries
+std::string makeScript(size_t& statementCount)
+{
+    std::string script("\xEF\xBB\xBF");
+    statementCount = 0;
+    for (size_t i = 0; script.size() < 3 * SqlScriptReader::chunkSize; ++i)
+    {
+        script += "INSERT INTO T (ID, NAME) VALUES (" + std::to_string(i)
+            + ", 'it''s; \xC3\xA4\xE2\x82\xAC\xF0\x9F\x98\x80 " + std::to_string(i)
+            + "');\n";
+        ++statementCount;
+        if (i % 1000 == 0)
+        {
+            script += "-- comment; with a terminator\n/* block; comment */\n";
+            script += "SET TERM ^ ;\nCREATE PROCEDURE P AS BEGIN END^\nSET TERM ; ^\n";
+            ++statementCount;
+        }
+    }
+    script += "COMMIT";
+    ++statementCount;
+    return script;
+}
+
+} // namespace
+
+int main()
+{
+    bool ok = true;
+
+    // Test 1: statements, offsets and SET TERM
+    {
+        writeFile("SELECT ';' FROM RDB$DATABASE;\n-- x;\nSET TERM ^ ;\n"
+            "EXECUTE BLOCK AS BEGIN END^\nSET TERM ; ^\n  \n");
+        SqlScriptReader reader;
+        SingleStatement ss;
+        ok = check(reader.open(fileName), "small: open") && ok;
+        ok = check(reader.next(ss) && ss.getSql() == "SELECT ';' FROM RDB$DATABASE",
+            "small: first statement") && ok;
+        ok = check(reader.getOffset() == 29, "small: first offset") && ok;
+        ok = check(reader.next(ss)
+            && ss.getSql() == "\nEXECUTE BLOCK AS BEGIN END",
+            "small: block statement") && ok;
+        ok = check(reader.getTerminator() == "^", "small: terminator at offset") && ok;
+        ok = check(!reader.next(ss), "small: end of file") && ok;
+    }
+
+    // Test 2: reading a script of several chunks
+    size_t expectedCount = 0;
+    std::string script = makeScript(expectedCount);
+    writeFile(script);
+    wxFileOffset restartOffset = 0;
+    wxString restartTerminator;
+    size_t restartIndex = expectedCount / 2;
+    wxString restartSql;
+    {
+        SqlScriptReader reader;
+        SingleStatement ss;
+        reader.open(fileName);
+        size_t count = 0;
+        bool offsetsOk = true;
+        auto start = std::chrono::steady_clock::now();
+        while (reader.next(ss))
+        {
+            // the text before the offset has to end with the terminator
+            wxFileOffset end = reader.getOffset();
+            std::string term(reader.getTerminator().ToStdString());
+            if (count + 1 < expectedCount
+                && script.compare(size_t(end) - term.size(), term.size(), term) != 0)
+            {
+                offsetsOk = false;
+            }
+            if (count == restartIndex)
+            {
+                restartOffset = end;
+                restartTerminator = reader.getTerminator();
+            }
+            if (count == restartIndex + 1)
+                restartSql = ss.getSql();
+            ++count;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cout << "  INFO: " << count << " statements (" << script.size() / (1024 * 1024)
+                  << " MB) split in " << elapsed << " ms\n";
+        ok = check(count == expectedCount, "chunks: statement count") && ok;
+        ok = check(offsetsOk, "chunks: offsets end with terminators") && ok;
+        ok = check(reader.getOffset() == wxFileOffset(script.size()),
+            "chunks: last offset is the file length") && ok;
+    }
+
+    // Test 3: continuing at a restart point
+    {
+        SqlScriptReader reader;
+        SingleStatement ss;
+        reader.open(fileName, restartOffset, restartTerminator);
+        size_t count = 0;
+        bool firstOk = reader.next(ss) && ss.getSql() == restartSql;
+        if (firstOk)
+            ++count;
+        while (reader.next(ss))
+            ++count;
+        ok = check(firstOk, "restart: first statement") && ok;
+        ok = check(count == expectedCount - restartIndex - 1, "restart: remaining count") && ok;
+    }
+
+    // Test 4: the pipeline groups consecutive INSERTs into batches
+    {
+        std::string importScript(
+            "INSERT INTO A (X, Y) VALUES (1, 'a''b');\n"
+            "INSERT INTO A (X, Y) VALUES (2, NULL);\n"
+            "INSERT INTO A (X, Y) VALUES (3, 'c');\n"
+            "INSERT INTO B VALUES (1);\n"
+            "UPDATE A SET X = X + 1;\n"
+            "COMMIT;\n"
+            "INSERT INTO A (X, Y) VALUES (4, 'd');\n");
+        writeFile(importScript);
+        SqlImportPipeline pipeline(wxConvCurrent, 2);
+        pipeline.open(fileName);
+        pipeline.start();
+        std::vector<SqlImportGroup> groups;
+        SqlImportGroup group;
+        SqlImportPipeline::Status status;
+        while ((status = pipeline.next(group, 100)) != SqlImportPipeline::statusFinished)
+        {
+            if (status == SqlImportPipeline::statusGroup)
+                groups.push_back(group);
+        }
+        ok = check(pipeline.getError().empty(), "pipeline: no error") && ok;
+        ok = check(groups.size() == 6, "pipeline: group count") && ok;
+        if (groups.size() == 6)
+        {
+            ok = check(groups[0].kind == SqlImportGroup::kindInsertBatch
+                && groups[0].sql == "INSERT INTO A (X, Y) VALUES (?, ?)"
+                && groups[0].getRowCount() == 2 && groups[0].values[1] == "a'b"
+                && groups[0].nulls[3], "pipeline: first batch") && ok;
+            ok = check(groups[1].getRowCount() == 1 && groups[1].values[0] == "3",
+                "pipeline: batch size limit") && ok;
+            ok = check(groups[2].sql == "INSERT INTO B VALUES (?)",
+                "pipeline: batch of other table") && ok;
+            ok = check(groups[3].kind == SqlImportGroup::kindStatement,
+                "pipeline: single statement") && ok;
+            ok = check(groups[4].kind == SqlImportGroup::kindCommit
+                && groups[4].endOffset == wxFileOffset(importScript.find("COMMIT;") + 7),
+                "pipeline: commit") && ok;
+            wxFileOffset bytes = 0;
+            for (const SqlImportGroup& g : groups)
+                bytes += g.byteCount;
+            ok = check(bytes == groups.back().endOffset, "pipeline: byte counts") && ok;
+        }
+    }
+
+    // Test 5: executing a script file yields what "Execute all" would for
+    // the same text in the editor, with the byte offsets of the statements
+    {
+        std::string text("CREATE TABLE \xC3\x84 (ID INTEGER);\n"
+            "COMMIT WORK;\nSET AUTODDL OFF;\n/* ; */ INSERT INTO \xC3\x84 VALUES (1);\n"
+            "SET TERM !! ;\nEXECUTE BLOCK AS BEGIN END !!\nSET TERM ; !!\n"
+            "ROLLBACK; SELECT 'x;' FROM RDB$DATABASE");
+        writeFile(text);
+        SqlScriptReader reader;
+        reader.open(fileName);
+        MultiStatement ms(wxString::FromUTF8(text.data(), text.size()));
+        bool same = true, offsetsOk = true;
+        size_t count = 0;
+        SingleStatement fromFile;
+        while (reader.next(fromFile))
+        {
+            SingleStatement fromEditor = ms.getNextStatement();
+            while (fromEditor.isValid() && fromEditor.isEmptyStatement())
+                fromEditor = ms.getNextStatement();
+            if (!fromEditor.isValid() || fromEditor.getSql() != fromFile.getSql()
+                || fromEditor.isCommitStatement() != fromFile.isCommitStatement()
+                || fromEditor.isRollbackStatement() != fromFile.isRollbackStatement()
+                || ms.getTerminator() != reader.getTerminator())
+            {
+                same = false;
+            }
+            // the statement starts right after the previous terminator
+            std::string start(text.substr(size_t(reader.getStatementOffset())));
+            if (start.compare(0, 1, std::string(fromFile.getSql().utf8_str()), 0, 1) != 0)
+                offsetsOk = false;
+            ++count;
+        }
+        ok = check(same && count == 7 && !ms.getNextStatement().isValid(),
+            "editor: same statements") && ok;
+        ok = check(offsetsOk, "editor: statement offsets") && ok;
+    }
+
+    // Test 6: only literal values are batched, other INSERTs run unchanged
+    {
+        std::string importScript(
+            "INSERT INTO A (X, Y) VALUES (-5, 1.5E3);\n"
+            "INSERT INTO A (X, Y) VALUES (1, CURRENT_TIMESTAMP);\n"
+            "INSERT INTO A (X, Y) VALUES (TRUE, 'a');\n"
+            "INSERT INTO A (X, Y) VALUES (0x1F, x'AB');\n"
+            "INSERT INTO A (X, Y) VALUES (1, 'a') RETURNING X;\n");
+        writeFile(importScript);
+        SqlImportPipeline pipeline(wxConvCurrent, 10);
+        pipeline.open(fileName);
+        pipeline.start();
+        std::vector<SqlImportGroup> groups;
+        SqlImportGroup group;
+        SqlImportPipeline::Status status;
+        while ((status = pipeline.next(group, 100)) != SqlImportPipeline::statusFinished)
+        {
+            if (status == SqlImportPipeline::statusGroup)
+                groups.push_back(group);
+        }
+        ok = check(groups.size() == 5, "literals: group count") && ok;
+        if (groups.size() == 5)
+        {
+            ok = check(groups[0].kind == SqlImportGroup::kindInsertBatch
+                && groups[0].values[0] == "-5" && groups[0].values[1] == "1.5E3",
+                "literals: signed numbers") && ok;
+            bool unchanged = true;
+            for (size_t i = 1; i < groups.size(); ++i)
+            {
+                if (groups[i].kind != SqlImportGroup::kindStatement
+                    || !groups[i].values.empty())
+                {
+                    unchanged = false;
+                }
+            }
+            ok = check(unchanged, "literals: other statements unchanged") && ok;
+        }
+    }
+
+    // Test 7: continuing a script that is read as ISO-8859-1
+    {
+        writeFile("INSERT INTO T VALUES ('\xE4');\nINSERT INTO T VALUES ('\xF6');");
+        SqlScriptReader reader;
+        SingleStatement ss;
+        reader.open(fileName);
+        bool firstOk = reader.next(ss) && !reader.isUtf8()
+            && ss.getSql() == wxString("INSERT INTO T VALUES ('\xE4')", wxConvISO8859_1);
+        ok = check(firstOk, "latin1: detected at the start") && ok;
+
+        SqlScriptReader restarted;
+        restarted.open(fileName, reader.getOffset(), reader.getTerminator(),
+            reader.isUtf8());
+        bool restartOk = false;
+        try
+        {
+            restartOk = restarted.next(ss) && !restarted.isUtf8()
+                && ss.getSql() == wxString("\nINSERT INTO T VALUES ('\xF6')",
+                    wxConvISO8859_1);
+        }
+        catch (const std::exception&)
+        {
+        }
+        ok = check(restartOk, "latin1: same encoding after restart") && ok;
+    }
+
+    std::remove(fileName);
+    std::cout << "SQL Script Reader Tests completed: "
+              << (ok ? "ALL PASSED" : "SOME FAILED") << "\n";
+    return ok ? 0 : 1;
+}
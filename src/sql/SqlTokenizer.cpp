@@ -31,6 +31,10 @@
 #endif
 
 #include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
 #include "config/Config.h"
 #include "metadata/ODSVersion.h"
 #include "firebird_ods.h"
@@ -97,6 +101,166 @@ void appendCaseKeyword(wxArrayString& keywords, const char* keyword,
     wxString word(wxString::FromUTF8(keyword));
     keywords.Add(upperCase ? word.Upper() : word.Lower());
 }
+
+// KeywordHashTable class
+// Perfect hash of the keywords, built with the "hash and displace" method:
+// the keywords are distributed into small buckets, and for every bucket a
+// displacement is searched that moves all of its keywords into free slots
+// of the table. Looking up a word hashes it once and compares it with the
+// single keyword in its slot, ignoring case and without creating a string.
+class KeywordHashTable
+{
+private:
+    struct Keyword
+    {
+        std::string name;
+        SqlTokenType type;
+    };
+    std::vector<Keyword> keywordsM;
+    std::vector<uint32_t> displacementsM;
+    // index into keywordsM, -1 for free slots
+    std::vector<int> slotsM;
+    uint64_t seedM;
+    size_t maxLengthM;
+
+    template<typename C>
+    static uint64_t hash(const C* start, const C* end, uint64_t seed)
+    {
+        // FNV-1a of the upper case characters
+        uint64_t h = 14695981039346656037ULL ^ seed;
+        for (const C* p = start; p != end; ++p)
+        {
+            unsigned c = unsigned(*p);
+            if (c >= 'a' && c <= 'z')
+                c -= 'a' - 'A';
+            h ^= c;
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+    size_t getBucket(uint64_t h) const
+    {
+        return size_t(h >> 32) & (displacementsM.size() - 1);
+    }
+    static size_t getSlot(uint64_t h, uint32_t displacement, size_t mask)
+    {
+        uint32_t x = uint32_t(h) ^ (displacement * 0x9E3779B9U);
+        x ^= x >> 16;
+        x *= 0x85EBCA6BU;
+        x ^= x >> 13;
+        x *= 0xC2B2AE35U;
+        x ^= x >> 16;
+        return x & mask;
+    }
+
+    bool build(uint64_t seed)
+    {
+        seedM = seed;
+        size_t mask = slotsM.size() - 1;
+        std::vector<std::vector<size_t> > buckets(displacementsM.size());
+        for (size_t i = 0; i < keywordsM.size(); ++i)
+        {
+            const std::string& name = keywordsM[i].name;
+            buckets[getBucket(hash(name.data(), name.data() + name.size(),
+                seed))].push_back(i);
+        }
+        // the largest buckets are placed first, while most slots are free
+        std::vector<size_t> order(buckets.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(),
+            [&buckets](size_t left, size_t right)
+            {
+                return buckets[left].size() > buckets[right].size();
+            });
+
+        std::fill(slotsM.begin(), slotsM.end(), -1);
+        std::vector<size_t> slots;
+        for (size_t b : order)
+        {
+            const std::vector<size_t>& bucket = buckets[b];
+            if (bucket.empty())
+                break;
+            bool placed = false;
+            for (uint32_t d = 0; d < 65536 && !placed; ++d)
+            {
+                slots.clear();
+                placed = true;
+                for (size_t k : bucket)
+                {
+                    const std::string& name = keywordsM[k].name;
+                    size_t slot = getSlot(hash(name.data(),
+                        name.data() + name.size(), seed), d, mask);
+                    if (slotsM[slot] != -1 || std::find(slots.begin(),
+                        slots.end(), slot) != slots.end())
+                    {
+                        placed = false;
+                        break;
+                    }
+                    slots.push_back(slot);
+                }
+                if (placed)
+                {
+                    displacementsM[b] = d;
+                    for (size_t i = 0; i < bucket.size(); ++i)
+                        slotsM[slots[i]] = int(bucket[i]);
+                }
+            }
+            if (!placed)
+                return false;
+        }
+        return true;
+    }
+public:
+    KeywordHashTable(const std::map<wxString, SqlTokenType>& keywords)
+        : seedM(0), maxLengthM(0)
+    {
+        for (std::map<wxString, SqlTokenType>::const_iterator it
+            = keywords.begin(); it != keywords.end(); ++it)
+        {
+            Keyword k;
+            k.name = std::string(it->first.utf8_str());
+            k.type = it->second;
+            maxLengthM = std::max(maxLengthM, k.name.size());
+            keywordsM.push_back(k);
+        }
+        // twice as many slots as keywords, about 3 keywords per bucket
+        size_t slotCount = 1, bucketCount = 1;
+        while (slotCount < 2 * keywordsM.size())
+            slotCount *= 2;
+        while (bucketCount * 3 < keywordsM.size())
+            bucketCount *= 2;
+        slotsM.resize(slotCount, -1);
+        displacementsM.resize(bucketCount, 0);
+        // a few seeds at most, the search is deterministic
+        for (uint64_t seed = 0; !build(seed); ++seed)
+            ;
+    }
+
+    SqlTokenType find(const wxChar* start, const wxChar* end) const
+    {
+        size_t length = end - start;
+        if (length == 0 || length > maxLengthM)
+            return tkIDENTIFIER;
+        uint64_t h = hash(start, end, seedM);
+        int index = slotsM[getSlot(h, displacementsM[getBucket(h)],
+            slotsM.size() - 1)];
+        if (index < 0)
+            return tkIDENTIFIER;
+        const Keyword& k = keywordsM[index];
+        if (k.name.size() != length)
+            return tkIDENTIFIER;
+        for (size_t i = 0; i < length; ++i)
+        {
+            unsigned c = unsigned(start[i]);
+            if (c >= 'a' && c <= 'z')
+                c -= 'a' - 'A';
+            if (c != (unsigned char)k.name[i])
+                return tkIDENTIFIER;
+        }
+        return k.type;
+    }
+};
 }
 
 /*static*/
@@ -109,62 +273,64 @@ wxString SqlTokenizer::getKeyword(SqlTokenType token)
 /*static*/
 wxString SqlTokenizer::getKeyword(SqlTokenType token, bool upperCase)
 {
-    if (upperCase)
-    {
-        static TokenToKeywordMap keywordsUpperCase;
-        if (keywordsUpperCase.empty())
-        {
-            const KeywordToTokenMap& keywordsMap = getKeywordToTokenMap();
-            for (KeywordToTokenMap::const_iterator it = keywordsMap.begin();
-                it != keywordsMap.end(); ++it)
-            {
-                keywordsUpperCase.insert(TokenToKeywordEntry((*it).second,
-                    (*it).first.Upper()));
-            }
-        }
-        TokenToKeywordMap::const_iterator pos = keywordsUpperCase.find(token);
-        if (pos != keywordsUpperCase.end())
-            return (*pos).second;
-    }
-    else
+    const TokenToKeywordMap& keywords(getTokenToKeywordMap(upperCase));
+    TokenToKeywordMap::const_iterator pos = keywords.find(token);
+    if (pos != keywords.end())
+        return (*pos).second;
+    return wxEmptyString;
+}
+
+/*static*/
+const SqlTokenizer::TokenToKeywordMap& SqlTokenizer::getTokenToKeywordMap(
+    bool upperCase)
+{
+    auto createMap = [](bool upper)
     {
-        static TokenToKeywordMap keywordsLowerCase;
-        if (keywordsLowerCase.empty())
+        TokenToKeywordMap map;
+        const KeywordToTokenMap& keywordsMap = getKeywordToTokenMap();
+        for (KeywordToTokenMap::const_iterator it = keywordsMap.begin();
+            it != keywordsMap.end(); ++it)
         {
-            const KeywordToTokenMap& keywordsMap = getKeywordToTokenMap();
-            for (KeywordToTokenMap::const_iterator it = keywordsMap.begin();
-                it != keywordsMap.end(); ++it)
-            {
-                keywordsLowerCase.insert(TokenToKeywordEntry((*it).second,
-                    (*it).first.Lower()));
-            }
+            map.insert(TokenToKeywordEntry((*it).second,
+                upper ? (*it).first.Upper() : (*it).first.Lower()));
         }
-        TokenToKeywordMap::const_iterator pos = keywordsLowerCase.find(token);
-        if (pos != keywordsLowerCase.end())
-            return (*pos).second;
-    }
-    return wxEmptyString;
+        return map;
+    };
+    // initialized on first use, thread safe
+    static const TokenToKeywordMap keywordsUpperCase(createMap(true));
+    static const TokenToKeywordMap keywordsLowerCase(createMap(false));
+    return upperCase ? keywordsUpperCase : keywordsLowerCase;
+}
+
+/*static*/
+void SqlTokenizer::initialize()
+{
+    getKeywordTokenType(wxEmptyString);
+    getTokenToKeywordMap(true);
+    SqlTokenizerConfigCache::get().getSqlKeywordsUpperCase();
 }
 
 /*static*/
 const SqlTokenizer::KeywordToTokenMap& SqlTokenizer::getKeywordToTokenMap()
 {
-    static KeywordToTokenMap keywords;
-    if (keywords.empty())
+    // initialized on first use, thread safe
+    static const KeywordToTokenMap keywords = []()
     {
-        static const struct {wxString name; SqlTokenType type; } entries[] =
+        static const struct { const char* name; SqlTokenType type; } entries[] =
         {
             #include "keywordtokens.hpp"
             // this element makes for simpler code: all lines in the file can
             // end with a comma, and it is used as the stop marker
             { "", tkUNKNOWN }
         };
+        KeywordToTokenMap map;
         for (int i = 0; entries[i].type != tkUNKNOWN; i++)
         {
-            keywords.insert(KeywordToTokenEntry(
+            map.insert(KeywordToTokenEntry(
                 wxString(entries[i].name).Upper(), entries[i].type));
         }
-    }
+        return map;
+    }();
     return keywords;
 }
 
@@ -224,14 +390,17 @@ wxString SqlTokenizer::getKeywordsString(KeywordCase kwc, int odsMajor,
 /*static*/
 SqlTokenType SqlTokenizer::getKeywordTokenType(const wxString& word)
 {
-    if (word.IsEmpty())
-        return tkIDENTIFIER;
+    const wxChar* start = word.c_str();
+    return getKeywordTokenType(start, start + word.length());
+}
 
-    const KeywordToTokenMap& keywords = getKeywordToTokenMap();
-    KeywordToTokenMap::const_iterator pos = keywords.find(word.Upper());
-    if (pos != keywords.end())
-        return (*pos).second;
-    return tkIDENTIFIER;
+/*static*/
+SqlTokenType SqlTokenizer::getKeywordTokenType(const wxChar* start,
+    const wxChar* end)
+{
+    // initialized on first use, thread safe
+    static const KeywordHashTable table(getKeywordToTokenMap());
+    return table.find(start, end);
 }
 
 /*static*/
@@ -459,8 +628,8 @@ void SqlTokenizer::defaultToken()
         }
     }
     // check whether it's a keyword (for operators like ||, !=, etc.)
-    wxString checkKW(sqlTokenStartM, sqlTokenEndM);
-    SqlTokenType keywordType = getKeywordTokenType(checkKW);
+    SqlTokenType keywordType = getKeywordTokenType(sqlTokenStartM,
+        sqlTokenEndM);
     if (keywordType != tkIDENTIFIER)
         sqlTokenTypeM = keywordType;
     else
@@ -483,8 +652,8 @@ void SqlTokenizer::keywordIdentifierToken()
         || (c >= '0' && c <= '9') || c == '_' || c == '$'));
 
     // check whether it's a keyword, and not an identifier
-    wxString checkKW(sqlTokenStartM, sqlTokenEndM);
-    SqlTokenType keywordType = getKeywordTokenType(checkKW);
+    SqlTokenType keywordType = getKeywordTokenType(sqlTokenStartM,
+        sqlTokenEndM);
     if (keywordType != tkIDENTIFIER)
         sqlTokenTypeM = keywordType;
 }
@@ -178,6 +178,7 @@ private:
     void init();
 
     static const KeywordToTokenMap& getKeywordToTokenMap();
+    static const TokenToKeywordMap& getTokenToKeywordMap(bool upperCase);
     static FirebirdKeywordVersion normalizeKeywordVersion(
         int odsMajor, int odsMinor);
 
@@ -204,6 +205,10 @@ public:
 
     void setStatement(const wxString& statement);
 
+    // creates the keyword tables and reads the keyword case setting,
+    // call from the main thread before tokenizing in worker threads
+    static void initialize();
+
     enum KeywordCase { kwDefaultCase, kwLowerCase, kwUpperCase };
     // return keyword string for a given token type
     static wxString getKeyword(SqlTokenType token);
@@ -219,6 +224,9 @@ public:
     // returns TokenType of parameter string if word is a keyword,
     // returns tkIdentifier otherwise
     static SqlTokenType getKeywordTokenType(const wxString& word);
+    // the same for the characters [start, end), without creating a string
+    static SqlTokenType getKeywordTokenType(const wxChar* start,
+        const wxChar* end);
     static bool isReservedWord(const wxString& word);
     static bool isReservedWord(const wxString& word, int odsMajor,
         int odsMinor);
@@ -0,0 +1,100 @@
+/*
+  Copyright (c) 2004-2026 The FlameRobin Development Team
+
+  Permission is hereby granted, free of charge, to any person obtaining
+  a copy of this software and associated documentation files (the
+  "Software"), to deal in the Software without restriction, including
+  without limitation the rights to use, copy, modify, merge, publish,
+  distribute, sublicense, and/or sell copies of the Software, and to
+  permit persons to whom the Software is furnished to do so, subject to
+  the following conditions:
+
+  The above copyright notice and this permission notice shall be included
+  in all copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+  IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+  CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+  TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+  SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// Benchmark of the SQL tokenizer: a 100 MB script, tokenized in 1 MB
+// statements as the script import does
+
+#include <iostream>
+#include <chrono>
+#include <wx/wxprec.h>
+#ifndef WX_PRECOMP
+    #include <wx/wx.h>
+#endif
+
+#include "sql/SqlTokenizer.h"
+
+namespace
+{
+
+static bool check(bool condition, const char* testName)
+{
+    if (condition)
+    {
+        std::cout << "  PASSED: " << testName << "\n";
+        return true;
+    }
+    else
+    {
+        std::cout << "  FAILED: " << testName << "\n";
+        return false;
+    }
+}
+
+} // namespace
+
+int main()
+{
+    bool allPassed = true;
+
+    {
+        wxString chunk;
+        const wxString block(
+            "/* generated */ CREATE TABLE CUSTOMER_DATA (ID BIGINT NOT NULL, "
+            "NAME VARCHAR(100) CHARACTER SET UTF8, CREATED TIMESTAMP DEFAULT "
+            "CURRENT_TIMESTAMP, PRIMARY KEY (ID));\n"
+            "INSERT INTO CUSTOMER_DATA (ID, NAME) VALUES (12345, 'some name');\n"
+            "select c.id, c.name, count(*) from customer_data c -- comment\n"
+            "  left join orders o on o.customer_id = c.id where c.id >= 10 "
+            "and o.total <> 0 group by 1, 2 having sum(o.total) > 100.5;\n");
+        while (chunk.length() < 1024 * 1024)
+            chunk += block;
+        size_t blocks = chunk.length() / block.length();
+        const size_t chunkCount = 100;
+
+        SqlTokenizer tokenizer;
+        size_t tokens = 0, selects = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < chunkCount; ++i)
+        {
+            tokenizer.setStatement(chunk);
+            do
+            {
+                ++tokens;
+                if (tokenizer.getCurrentToken() == kwSELECT)
+                    ++selects;
+            }
+            while (tokenizer.nextToken());
+        }
+        double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cout << "  INFO: tokenized " << chunkCount << " MB, " << tokens
+                  << " tokens in " << seconds << " s ("
+                  << chunkCount / seconds << " MB/s)\n";
+        allPassed &= check(selects == blocks * chunkCount,
+            "Every SELECT found");
+    }
+
+    std::cout << "SqlTokenizer Benchmark completed: "
+              << (allPassed ? "ALL PASSED" : "SOME FAILED") << "\n";
+    return allPassed ? 0 : 1;
+}
@@ -600,5 +600,39 @@ int main()
         ok = checkStr(t5.getCurrentTokenString(), "3.141_592_653", "3.141_592_653 token string") && ok;
     }
 
+    // Test: every keyword is found again, in any case and as a range of
+    // the statement text
+    {
+        bool allFound = true;
+        for (int t = tk_KEYWORDS_START_HERE + 1; t <= kwZONE; ++t)
+        {
+            SqlTokenType type = SqlTokenType(t);
+            wxString upper(SqlTokenizer::getKeyword(type, true));
+            if (upper.empty())
+                continue;
+            wxString lower(SqlTokenizer::getKeyword(type, false));
+            if (SqlTokenizer::getKeywordTokenType(upper) != type
+                || SqlTokenizer::getKeywordTokenType(lower) != type)
+            {
+                std::string kw(upper.mb_str());
+                std::cerr << "  keyword " << kw << " not found\n";
+                allFound = false;
+            }
+        }
+        ok = check(allFound, "All keywords found by getKeywordTokenType") && ok;
+
+        wxString text("xSeLeCtx");
+        const wxChar* p = text.c_str();
+        ok = checkToken(SqlTokenizer::getKeywordTokenType(p + 1, p + 7),
+            kwSELECT, "Keyword in a range of the text") && ok;
+        ok = checkToken(SqlTokenizer::getKeywordTokenType(p + 1, p + 6),
+            tkIDENTIFIER, "Keyword prefix is an identifier") && ok;
+        ok = checkToken(SqlTokenizer::getKeywordTokenType(p, p),
+            tkIDENTIFIER, "Empty range is an identifier") && ok;
+        ok = checkToken(SqlTokenizer::getKeywordTokenType(
+            wxString::FromUTF8("S\xC3\x89LECT")), tkIDENTIFIER,
+            "Non-ASCII word is an identifier") && ok;
+    }
+
     return ok ? 0 : 1;
 }
@@ -54,11 +54,13 @@ MetadataItem::~MetadataItem() {}
 wxString MetadataItem::getName_() const { return identifierM.get(); }
 wxString MetadataItem::getQuotedName() const { return identifierM.getQuoted(); }
 Identifier MetadataItem::getIdentifier() const { return identifierM; }
-void MetadataItem::setName_(const wxString& name) { identifierM.setText(name); }
+std::atomic<unsigned> MetadataItem::keyChangeCountM(0);
+void MetadataItem::setName_(const wxString& name) { identifierM.setText(name); ++keyChangeCountM; }
 NodeType MetadataItem::getType() const { return typeM; }
 void MetadataItem::setType(NodeType type) { typeM = type; }
 int MetadataItem::getMetadataId() { return metadataIdM; }
-void MetadataItem::setMetadataId(int id) { metadataIdM = id; }
+void MetadataItem::setMetadataId(int id) { metadataIdM = id; ++keyChangeCountM; }
+unsigned MetadataItem::getKeyChangeCount() { return keyChangeCountM; }
 
 const wxString MetadataItem::getTypeName() const { return ""; }
 const wxString MetadataItem::getItemPath() const { return ""; }